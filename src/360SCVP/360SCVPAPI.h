@@ -41,6 +41,7 @@ extern "C" {
 #define ID_SCVP_PARAM_SEI_VIEWPORT         1006
 #define ID_SCVP_BITSTREAMS_HEADER          1007
 #define ID_SCVP_RWPK_INFO                  1008
+#define ID_SCVP_PARAM_COPY_THREADS         1009  //uint32_t, threads copying the slice data in stream stitching, 0 by the cores, 1 in place
 
 #define DEFAULT_REGION_NUM                 1000
 
@@ -274,6 +275,17 @@ typedef struct PARAM_PICTURE
     int32_t maxCUWidth;
 }Param_PicInfo;
 
+//!
+//! \brief  This structure is for the planes of one decoded 4:2:0 picture
+//!
+typedef struct PARAM_YUVPICTURE
+{
+    uint8_t  *pPlanes[3];   //Y, U and V planes
+    uint32_t  strides[3];
+    uint32_t  width;        //luma width
+    uint32_t  height;       //luma height
+}Param_YUVPicture;
+
 //Enumeration type for indicating rotation information in input Cubemap projected picture
 typedef enum
 {
@@ -470,6 +482,45 @@ void * I360SCVP_New(void* p360SCVPHandle);
 //!
 int32_t I360SCVP_process(param_360SCVP* pParam360SCVP, void * p360SCVPHandle);
 
+//!
+//! \brief      This function parses the input frame once, and indexes the nals, parameter sets and slice headers of all the tiles
+//!             for usedType E_MERGE_AND_VIEWPORT. The frame index is not changed after parsing, so several handles can merge
+//!             their viewport streams from it at the same time by I360SCVP_processFrame, without parsing the frame again.
+//!             The input bitstreams must be kept until the frame index is released.
+//! \param      param_360SCVP*   pParam360SCVP,     input, the pInputBitstream and pInputLowBitstream of the frame
+//! \param      void *           p360SCVPHandle,    input, which is created by the I360SVCP_Init function, it keeps the
+//!                                                 parameter sets between frames, so one handle should parse all the frames
+//!
+//! \return     void *, the frame index
+//!             not null, if succeed
+//!             null, if fail
+//!
+void * I360SCVP_ParseFrame(param_360SCVP* pParam360SCVP, void * p360SCVPHandle);
+
+//!
+//! \brief      This function does the same stitch as I360SCVP_process, but takes the tiles from the frame index
+//!             instead of parsing the input bitstreams
+//! \param      param_360SCVP*   pParam360SCVP,     input/output, the output bitstream and SEI, refer to the structure param_360SCVP
+//! \param      void *           pFrameIndex,       input,        which is created by the I360SCVP_ParseFrame function
+//! \param      void *           p360SCVPHandle,    input,        which is created by the I360SVCP_Init function
+//!
+//! \return     int32_t, the status of the function.
+//!     0,      if succeed
+//!     not 0,  if fail
+//!
+int32_t I360SCVP_processFrame(param_360SCVP* pParam360SCVP, void * pFrameIndex, void * p360SCVPHandle);
+
+//!
+//! \brief      This function releases the frame index, after all the stitches of the frame are done
+//!
+//! \param      void *           pFrameIndex,       input, which is created by the I360SCVP_ParseFrame function
+//!
+//! \return     int32_t, the status of the function.
+//!     0,      if succeed
+//!     not 0,  if fail
+//!
+int32_t I360SCVP_releaseFrame(void * pFrameIndex);
+
 //!
 //! \brief      This function sets the parameter of the viewPort.
 //!
@@ -612,6 +663,23 @@ int32_t I360SCVP_GenerateProj(void* p360SCVPHandle, int32_t projType, uint8_t *p
 //!
 int32_t I360SCVP_ParseRWPK(void* p360SCVPHandle, RegionWisePacking* pRWPK, uint8_t *pRWPKBits, uint32_t RWPKBitsSize);
 
+//!
+//! \brief This function reconstructs the projected picture (ERP or cube map) from the decoded packed picture
+//!        on CPU, without any render context. The regions are sampled with the nearest filter as the player
+//!        does, the low resolution regions first and then the others on top of them. The samples which are
+//!        not covered by any region are kept unchanged.
+//!
+//! \param    RegionWisePacking* pRWPK,              input,  the region wise packing of the packed picture
+//! \param    Param_YUVPicture*  pPackedPic,         input,  the decoded 4:2:0 packed picture
+//! \param    Param_YUVPicture*  pProjPic,           output, the projected picture, projPicWidth x projPicHeight at least
+//! \param    uint32_t           threadsNum,         input,  the number of threads to use, 0 for the number of cores
+//!
+//!\return   int32_t, the status of the function.
+//!          0,     if succeed
+//!          not 0, if fail
+//!
+int32_t I360SCVP_UnpackRWPK(RegionWisePacking* pRWPK, Param_YUVPicture* pPackedPic, Param_YUVPicture* pProjPic, uint32_t threadsNum);
+
 //!
 //! \brief This function gets the content coverge for viewport.
 //!
@@ -34,6 +34,7 @@
 #include "360SCVPCommonDef.h"
 #include "360SCVPHevcEncHdr.h"
 #include "360SCVPImpl.h"
+#include "360SCVPRwpkUnpack.h"
 
 void* I360SCVP_Init(param_360SCVP* pParam360SCVP)
 {
@@ -92,6 +93,35 @@ int32_t   I360SCVP_process(param_360SCVP* pParam360SCVP, void* p360SCVPHandle)
     return ret;
 }
 
+void* I360SCVP_ParseFrame(param_360SCVP* pParam360SCVP, void* p360SCVPHandle)
+{
+    TstitchStream* pStitch = (TstitchStream*)(p360SCVPHandle);
+    if (!pStitch || !pParam360SCVP)
+        return NULL;
+    if (pParam360SCVP->usedType != E_MERGE_AND_VIEWPORT)
+        return NULL;
+
+    return (void*)pStitch->parseFrame(pParam360SCVP);
+}
+
+int32_t I360SCVP_processFrame(param_360SCVP* pParam360SCVP, void* pFrameIndex, void* p360SCVPHandle)
+{
+    TstitchStream* pStitch = (TstitchStream*)(p360SCVPHandle);
+    if (!pStitch || !pParam360SCVP || !pFrameIndex)
+        return -1;
+
+    return pStitch->processFrame(pParam360SCVP, (frame_index*)pFrameIndex);
+}
+
+int32_t I360SCVP_releaseFrame(void* pFrameIndex)
+{
+    if (!pFrameIndex)
+        return -1;
+
+    TstitchStream::releaseFrame((frame_index*)pFrameIndex);
+    return 0;
+}
+
 int32_t I360SCVP_setViewPort(void* p360SCVPHandle, float yaw, float pitch)
 {
     int32_t ret = 0;
@@ -232,6 +262,13 @@ int32_t I360SCVP_ParseRWPK(void* p360SCVPHandle, RegionWisePacking* pRWPK, uint8
     return ret;
 }
 
+int32_t I360SCVP_UnpackRWPK(RegionWisePacking* pRWPK, Param_YUVPicture* pPackedPic, Param_YUVPicture* pProjPic, uint32_t threadsNum)
+{
+    if (!pRWPK || !pPackedPic || !pProjPic)
+        return 1;
+    return rwpk_unpack_picture(pRWPK, pPackedPic, pProjPic, threadsNum);
+}
+
 // output is the centre and range of Azimuth and Elevation of 3D sphere
 int32_t I360SCVP_getContentCoverage(void* p360SCVPHandle, CCDef* pOutCC)
 {
@@ -317,6 +354,9 @@ int32_t I360SCVP_SetParameter(void* p360SCVPHandle, int32_t paramID, void* pValu
         pSeiViewport = (OMNIViewPort*)pValue;
         ret = pStitch->setViewportSEI(pSeiViewport);
         break;
+    case ID_SCVP_PARAM_COPY_THREADS:
+        ret = pStitch->setCopyThreads(*((uint32_t*)pValue));
+        break;
     default:
         break;
     }
@@ -143,6 +143,26 @@ int32_t modify_slice_header(HEVCState *hevc, hevc_mergeStream *mergeStream, uint
     return 0;
 }
 
+int32_t parse_merge_info(tile_parsed_info *pParsed, HEVCState *hevc, uint8_t *pBuffer, uint32_t bufferLen)
+{
+    if (!pParsed || !hevc)
+        return -1;
+
+    memset_s(pParsed, sizeof(tile_parsed_info), 0);
+    hevc_specialInfo specialInfo;
+    memset_s(&specialInfo, sizeof(hevc_specialInfo), 0);
+    specialInfo.ptr = pBuffer;
+    specialInfo.ptr_size = bufferLen;
+    int32_t spsCnt;
+    parse_hevc_specialinfo(&specialInfo, hevc, pParsed->nalsize, &pParsed->specialLen, &spsCnt, 0);
+
+    memcpy_s(&pParsed->sliceInfo, sizeof(HEVCSliceInfo), &hevc->s_info, sizeof(HEVCSliceInfo));
+    // keep the indices only, the merge rebases them to its own state
+    pParsed->spsIdx = (hevc->s_info.sps >= hevc->sps && hevc->s_info.sps < hevc->sps + 16) ? (int32_t)(hevc->s_info.sps - hevc->sps) : -1;
+    pParsed->ppsIdx = (hevc->s_info.pps >= hevc->pps && hevc->s_info.pps < hevc->pps + 64) ? (int32_t)(hevc->s_info.pps - hevc->pps) : -1;
+    return 0;
+}
+
 int32_t merge_header(GTS_BitStream *bs, oneStream_info* pSlice, uint8_t **pBitstream, bool isHR, hevc_mergeStream *mergeStream, HEVCState *orgHevc)
 {
     if (!bs || !pSlice || !pBitstream || !mergeStream)
@@ -158,14 +178,34 @@ int32_t merge_header(GTS_BitStream *bs, oneStream_info* pSlice, uint8_t **pBitst
 
     HEVCState *hevc = pSlice->hevcSlice;
 
-    hevc_specialInfo specialInfo;
-    memset_s(&specialInfo, sizeof(hevc_specialInfo), 0);
-    specialInfo.ptr = pBufferSliceCur;
-    specialInfo.ptr_size = lenSlice;
-    memset_s(nalsize, sizeof(nalsize), 0);
     uint64_t bs_position = bs->position;
-    int32_t spsCnt;
-    parse_hevc_specialinfo(&specialInfo, hevc, nalsize, &specialLen, &spsCnt, 0);
+    const tile_parsed_info *pParsed = pSlice->pParsedInfo;
+    if (pParsed)
+    {
+        // the frame is indexed, take the parsing result instead of parsing the shared input again
+        memcpy_s(nalsize, sizeof(nalsize), pParsed->nalsize, sizeof(nalsize));
+        specialLen = pParsed->specialLen;
+        if (pParsed->hevc)
+        {
+            memcpy_s(hevc, sizeof(HEVCState), pParsed->hevc, sizeof(HEVCState));
+        }
+        else
+        {
+            memcpy_s(&hevc->s_info, sizeof(HEVCSliceInfo), &pParsed->sliceInfo, sizeof(HEVCSliceInfo));
+            hevc->s_info.sps = (pParsed->spsIdx >= 0) ? &hevc->sps[pParsed->spsIdx] : NULL;
+            hevc->s_info.pps = (pParsed->ppsIdx >= 0) ? &hevc->pps[pParsed->ppsIdx] : NULL;
+        }
+    }
+    else
+    {
+        hevc_specialInfo specialInfo;
+        memset_s(&specialInfo, sizeof(hevc_specialInfo), 0);
+        specialInfo.ptr = pBufferSliceCur;
+        specialInfo.ptr_size = lenSlice;
+        memset_s(nalsize, sizeof(nalsize), 0);
+        int32_t spsCnt;
+        parse_hevc_specialinfo(&specialInfo, hevc, nalsize, &specialLen, &spsCnt, 0);
+    }
 
     specialLen += nalsize[SLICE_HEADER];
     framesize = specialLen + nalsize[SLICE_DATA];
@@ -478,6 +518,8 @@ int32_t tile_merge_Process(param_mergeStream *mergeStreamParams, void* handle)
     mergeStream->highRes.pHeader->inputBufferLen =  mergeStreamParams->highRes.pHeader->inputBufferLen;
     mergeStream->lowRes.pHeader->pTiledBitstreamBuffer =  mergeStreamParams->lowRes.pHeader->pTiledBitstreamBuffer;
     mergeStream->lowRes.pHeader->inputBufferLen = mergeStreamParams->lowRes.pHeader->inputBufferLen;
+    mergeStream->highRes.pHeader->pParsedInfo = mergeStreamParams->highRes.pParsedHeader;
+    mergeStream->lowRes.pHeader->pParsedInfo = mergeStreamParams->lowRes.pParsedHeader;
     mergeStream->highRes.bOrdered = mergeStreamParams->highRes.bOrdered;
     mergeStream->lowRes.bOrdered = mergeStreamParams->lowRes.bOrdered;
 
@@ -504,6 +546,7 @@ int32_t tile_merge_Process(param_mergeStream *mergeStreamParams, void* handle)
         mergeStream->highRes.pTiledBitstreams[i]->inputBufferLen = mergeStreamParams->highRes.pTiledBitstreams[inverseIdx]->inputBufferLen;
         mergeStream->inputBistreamsLen += mergeStreamParams->highRes.pTiledBitstreams[inverseIdx]->inputBufferLen;
         mergeStream->highRes.pTiledBitstreams[i]->currentTileIdx = i;
+        mergeStream->highRes.pTiledBitstreams[i]->pParsedInfo = mergeStreamParams->highRes.pParsedTiles ? mergeStreamParams->highRes.pParsedTiles[inverseIdx] : NULL;
     }
     for(int32_t i = 0 ; i < LR_ntile ; i++)
     {
@@ -511,6 +554,7 @@ int32_t tile_merge_Process(param_mergeStream *mergeStreamParams, void* handle)
         mergeStream->lowRes.pTiledBitstreams[i]->inputBufferLen = mergeStreamParams->lowRes.pTiledBitstreams[i]->inputBufferLen;
         mergeStream->inputBistreamsLen += mergeStreamParams->lowRes.pTiledBitstreams[i]->inputBufferLen;
         mergeStream->lowRes.pTiledBitstreams[i]->currentTileIdx = HR_ntile + i;
+        mergeStream->lowRes.pTiledBitstreams[i]->pParsedInfo = mergeStreamParams->lowRes.pParsedTiles ? mergeStreamParams->lowRes.pParsedTiles[i] : NULL;
     }
 
     mergeStream->pOutputBitstream = mergeStreamParams->pOutputBitstream;
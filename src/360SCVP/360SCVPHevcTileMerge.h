@@ -62,6 +62,8 @@ int32_t modify_parameter_sets(HEVCState *hevc, hevc_mergeStream *mergeStream);
 int32_t init_one_bitstream(oneStream_info **pBs);
 int32_t destory_one_bitstream(oneStream_info **pBs);
 int32_t modify_slice_header(HEVCState *hevc, hevc_mergeStream *mergeStream, uint32_t tile_index);
+// Parse the headers or one tile in the same way as merge_header, the result can be shared by all merges of the frame
+int32_t parse_merge_info(tile_parsed_info *pParsed, HEVCState *hevc, uint8_t *pBuffer, uint32_t bufferLen);
 int32_t merge_header(GTS_BitStream *bs, oneStream_info* pSlice, uint8_t **pBitstream, bool isHR, hevc_mergeStream *mergeStream, HEVCState *orgHevc);
 // Put all LR tiles at the right of HR tiles
 int32_t get_merge_solution(hevc_mergeStream *mergeStream);
@@ -42,6 +42,20 @@ typedef enum NALU_TYPE
     NALU_NUM
 }NALU_type;
 
+//!
+//! \brief  the parsing result of the stream headers or one tile, it is got once
+//!         when the frame is indexed, and shared by all the merges of the frame
+//!
+typedef struct TILE_PARSED_INFO
+{
+    uint32_t            nalsize[NALU_NUM];
+    uint32_t            specialLen;
+    const HEVCState    *hevc;        //the state after parsing the headers, NULL for the tiles
+    HEVCSliceInfo       sliceInfo;   //the slice header of the tile
+    int32_t             spsIdx;
+    int32_t             ppsIdx;
+}tile_parsed_info;
+
 typedef struct ONESTREAM_INFO
 {
     uint32_t            width;
@@ -58,6 +72,7 @@ typedef struct ONESTREAM_INFO
     int32_t             rowHeight[20];
     int32_t             address;
     int32_t             currentTileIdx;
+    const tile_parsed_info *pParsedInfo; //parsed when the frame is indexed, NULL to parse in merging
 
 }oneStream_info;
 
@@ -34,6 +34,11 @@
 #include "360SCVPHevcEncHdr.h"
 #include "360SCVPImpl.h"
 #include "360SCVPHevcTileMerge.h"
+#include <thread>
+
+// the slice data is copied by several threads only when the frame is large enough
+#define PARALLEL_COPY_MIN_SIZE  (512 * 1024)
+#define PARALLEL_COPY_MAX_THREADS 4
 
 
 TstitchStream::TstitchStream()
@@ -43,6 +48,8 @@ TstitchStream::TstitchStream()
     m_pDownRight = new point[6];
     m_pNalInfo[0] = new nal_info[1000];
     m_pNalInfo[1] = new nal_info[1000];
+    m_pParsedTiles[0] = new const tile_parsed_info*[1000];
+    m_pParsedTiles[1] = new const tile_parsed_info*[1000];
     m_hevcState = new HEVCState;
     if (m_hevcState)
     {
@@ -108,6 +115,8 @@ TstitchStream::TstitchStream(TstitchStream& other)
     memcpy_s(m_pNalInfo[0], 1000 * sizeof(nal_info), other.m_pNalInfo[0], 1000 * sizeof(nal_info));
     m_pNalInfo[1] = new nal_info[1000];
     memcpy_s(m_pNalInfo[1], 1000 * sizeof(nal_info), other.m_pNalInfo[1], 1000 * sizeof(nal_info));
+    m_pParsedTiles[0] = new const tile_parsed_info*[1000];
+    m_pParsedTiles[1] = new const tile_parsed_info*[1000];
     m_hevcState = new HEVCState;
     if (m_hevcState)
     {
@@ -168,6 +177,7 @@ TstitchStream::TstitchStream(TstitchStream& other)
     m_yTopLeftNet = other.m_yTopLeftNet;
     m_dstRwpk = RegionWisePacking();
     m_dstRwpk = other.m_dstRwpk;
+    m_copyPool.SetThreadsNum(other.m_copyPool.GetThreadsNum());
 }
 
 TstitchStream::~TstitchStream()
@@ -192,6 +202,14 @@ TstitchStream::~TstitchStream()
         delete []m_pNalInfo[1];
         m_pNalInfo[1] = nullptr;
     }
+    if (m_pParsedTiles[0]) {
+        delete []m_pParsedTiles[0];
+        m_pParsedTiles[0] = nullptr;
+    }
+    if (m_pParsedTiles[1]) {
+        delete []m_pParsedTiles[1];
+        m_pParsedTiles[1] = nullptr;
+    }
     if (m_hevcState) {
         delete m_hevcState;
         m_hevcState = nullptr;
@@ -777,6 +795,11 @@ int32_t TstitchStream::feedParamToGenStream(param_360SCVP* pParamStitchStream)
 
     tile_merge_reset(m_pMergeStream);
 
+    m_mergeStreamParam.highRes.pParsedHeader = NULL;
+    m_mergeStreamParam.highRes.pParsedTiles = NULL;
+    m_mergeStreamParam.lowRes.pParsedHeader = NULL;
+    m_mergeStreamParam.lowRes.pParsedTiles = NULL;
+
     if (m_specialDataLen[0] == 0)
     {
         m_mergeStreamParam.bWroteHeader = 0;
@@ -906,6 +929,176 @@ int32_t TstitchStream::doMerge(param_360SCVP* pParamStitchStream)
     return ret;
 }
 
+int32_t TstitchStream::indexStream(frame_index* pFrame, uint8_t* pInput, int32_t streamIdx)
+{
+    if (!pFrame || !pInput)
+        return -1;
+    int32_t tilesCount = m_tileWidthCountOri[streamIdx] * m_tileHeightCountOri[streamIdx];
+    if (tilesCount <= 0 || tilesCount > 1000)
+        return -1;
+
+    pFrame->pHeader[streamIdx] = pInput;
+    pFrame->specialDataLen[streamIdx] = m_specialDataLen[streamIdx];
+    pFrame->tilesCount[streamIdx] = tilesCount;
+    pFrame->pNalInfo[streamIdx] = new nal_info[tilesCount];
+    pFrame->pParsedTiles[streamIdx] = new tile_parsed_info[tilesCount];
+    pFrame->hevcState[streamIdx] = new HEVCState;
+    if (!pFrame->pNalInfo[streamIdx] || !pFrame->pParsedTiles[streamIdx] || !pFrame->hevcState[streamIdx])
+        return -1;
+    memcpy_s(pFrame->pNalInfo[streamIdx], tilesCount * sizeof(nal_info), m_pNalInfo[streamIdx], tilesCount * sizeof(nal_info));
+
+    //parse the headers with a new state, the same as the merging does
+    HEVCState *hevc = pFrame->hevcState[streamIdx];
+    memset_s(hevc, sizeof(HEVCState), 0);
+    hevc->sps_active_idx = -1;
+    parse_merge_info(&pFrame->parsedHeader[streamIdx], hevc, pInput, m_specialDataLen[streamIdx]);
+    pFrame->parsedHeader[streamIdx].hevc = hevc;
+
+    //each tile is parsed on the state of the headers, and the state is restored at last
+    HEVCSliceInfo headerSliceInfo;
+    memcpy_s(&headerSliceInfo, sizeof(HEVCSliceInfo), &hevc->s_info, sizeof(HEVCSliceInfo));
+    nal_info *pNalInfo = pFrame->pNalInfo[streamIdx];
+    for (int32_t idx = 0; idx < tilesCount; idx++)
+    {
+        uint32_t tileLen = (idx != 0) ? pNalInfo[idx].nalLen : pNalInfo[idx].nalLen - m_specialDataLen[streamIdx];
+        uint8_t *pTile = (idx != 0) ? pNalInfo[idx].pNalStream : pNalInfo[idx].pNalStream + m_specialDataLen[streamIdx];
+        memcpy_s(&hevc->s_info, sizeof(HEVCSliceInfo), &headerSliceInfo, sizeof(HEVCSliceInfo));
+        parse_merge_info(&pFrame->pParsedTiles[streamIdx][idx], hevc, pTile, tileLen);
+    }
+    memcpy_s(&hevc->s_info, sizeof(HEVCSliceInfo), &headerSliceInfo, sizeof(HEVCSliceInfo));
+
+    return 0;
+}
+
+frame_index* TstitchStream::parseFrame(param_360SCVP* pParamStitchStream)
+{
+    if (!pParamStitchStream || m_usedType != E_MERGE_AND_VIEWPORT)
+        return NULL;
+
+    frame_index *pFrame = new frame_index;
+    if (!pFrame)
+        return NULL;
+    memset_s(pFrame, sizeof(frame_index), 0);
+
+    for (int32_t streamIdx = 0; streamIdx < 2; streamIdx++)
+    {
+        uint8_t *pInput = (streamIdx == 0) ? pParamStitchStream->pInputBitstream : pParamStitchStream->pInputLowBitstream;
+        if (!pInput)
+            continue;
+
+        //the cached headers are put back to the input here, so the merges never change the input
+        if (parseNals(pParamStitchStream, E_MERGE_AND_VIEWPORT, NULL, streamIdx) < 0
+            || indexStream(pFrame, pInput, streamIdx) < 0)
+        {
+            LOG(ERROR) << "Failed to index the frame of stream " << streamIdx;
+            releaseFrame(pFrame);
+            return NULL;
+        }
+    }
+
+    return pFrame;
+}
+
+void TstitchStream::releaseFrame(frame_index* pFrame)
+{
+    if (!pFrame)
+        return;
+
+    for (int32_t streamIdx = 0; streamIdx < 2; streamIdx++)
+    {
+        if (pFrame->pNalInfo[streamIdx])
+            delete []pFrame->pNalInfo[streamIdx];
+        pFrame->pNalInfo[streamIdx] = NULL;
+        if (pFrame->pParsedTiles[streamIdx])
+            delete []pFrame->pParsedTiles[streamIdx];
+        pFrame->pParsedTiles[streamIdx] = NULL;
+        if (pFrame->hevcState[streamIdx])
+            delete pFrame->hevcState[streamIdx];
+        pFrame->hevcState[streamIdx] = NULL;
+    }
+    delete pFrame;
+}
+
+int32_t TstitchStream::feedFrameToMerge(frame_index* pFrame)
+{
+    if (!pFrame)
+        return -1;
+    if ((m_tileWidthCountSel[0] * m_tileHeightCountSel[0] > pFrame->tilesCount[0])
+        || (m_tileWidthCountSel[1] * m_tileHeightCountSel[1] > pFrame->tilesCount[1]))
+        return -1;
+
+    param_oneStream_info **pTmpHigh = m_mergeStreamParam.highRes.pTiledBitstreams;
+    param_oneStream_info **pTmpLow = m_mergeStreamParam.lowRes.pTiledBitstreams;
+    int32_t idx = 0;
+    TileDef *pTmpTile = m_pOutTile;
+
+    param_oneStream_info *pTmpHighHdr = m_mergeStreamParam.highRes.pHeader;
+    pTmpHighHdr->pTiledBitstreamBuffer = pFrame->pHeader[0];
+    pTmpHighHdr->inputBufferLen = pFrame->specialDataLen[0];
+    param_oneStream_info *pTmpLowHdr = m_mergeStreamParam.lowRes.pHeader;
+    pTmpLowHdr->pTiledBitstreamBuffer = pFrame->pHeader[1];
+    pTmpLowHdr->inputBufferLen = pFrame->specialDataLen[1];
+
+    tile_merge_reset(m_pMergeStream);
+
+    m_mergeStreamParam.highRes.pParsedHeader = pFrame->tilesCount[0] ? &pFrame->parsedHeader[0] : NULL;
+    m_mergeStreamParam.highRes.pParsedTiles = m_pParsedTiles[0];
+    m_mergeStreamParam.lowRes.pParsedHeader = pFrame->tilesCount[1] ? &pFrame->parsedHeader[1] : NULL;
+    m_mergeStreamParam.lowRes.pParsedTiles = m_pParsedTiles[1];
+
+    if (pFrame->specialDataLen[0] == 0)
+    {
+        m_mergeStreamParam.bWroteHeader = 0;
+    }
+
+    for (int32_t i = 0; i < m_tileHeightCountSel[0]; i++)
+    {
+        for (int32_t j = 0; j < m_tileWidthCountSel[0]; j++)
+        {
+            int32_t tileIdx = pTmpTile->idx;
+            if (tileIdx < 0 || tileIdx >= pFrame->tilesCount[0])
+                return -1;
+            nal_info *pNalInfo = &pFrame->pNalInfo[0][tileIdx];
+            pTmpHigh[idx]->tilesHeightCount = 1;
+            pTmpHigh[idx]->tilesWidthCount = 1;
+            pTmpHigh[idx]->inputBufferLen = (tileIdx != 0) ? pNalInfo->nalLen : pNalInfo->nalLen - pFrame->specialDataLen[0];
+            pTmpHigh[idx]->pTiledBitstreamBuffer = (tileIdx != 0) ? pNalInfo->pNalStream : pNalInfo->pNalStream + pFrame->specialDataLen[0];
+            m_pParsedTiles[0][idx] = &pFrame->pParsedTiles[0][tileIdx];
+            pTmpTile++;
+            idx++;
+        }
+    }
+
+    idx = 0;
+    for (int32_t i = 0; i < m_tileHeightCountSel[1]; i++)
+    {
+        for (int32_t j = 0; j < m_tileWidthCountSel[1]; j++)
+        {
+            nal_info *pNalInfo = &pFrame->pNalInfo[1][idx];
+            pTmpLow[idx]->tilesHeightCount = 1;
+            pTmpLow[idx]->tilesWidthCount = 1;
+            pTmpLow[idx]->inputBufferLen = (idx != 0) ? pNalInfo->nalLen : pNalInfo->nalLen - pFrame->specialDataLen[1];
+            pTmpLow[idx]->pTiledBitstreamBuffer = (idx != 0) ? pNalInfo->pNalStream : pNalInfo->pNalStream + pFrame->specialDataLen[1];
+            m_pParsedTiles[1][idx] = &pFrame->pParsedTiles[1][idx];
+            idx++;
+        }
+    }
+    return 0;
+}
+
+int32_t TstitchStream::processFrame(param_360SCVP* pParamStitchStream, frame_index* pFrame)
+{
+    if (!pParamStitchStream || !pFrame)
+        return -1;
+
+    if (feedFrameToMerge(pFrame) < 0)
+    {
+        LOG(ERROR) << "The selected tiles are not in the frame index";
+        return -1;
+    }
+    return doMerge(pParamStitchStream);
+}
+
 int TstitchStream::EncRWPKSEI(RegionWisePacking* pRWPK, uint8_t *pRWPKBits, uint32_t* pRWPKBitsSize)
 {
     if (!pRWPK || !pRWPKBits || !pRWPKBitsSize)
@@ -1111,7 +1304,7 @@ int32_t  TstitchStream::doStreamStitch(param_360SCVP* pParamStitchStream)
     return ret;
 }
 
-int32_t TstitchStream::merge_one_tile(uint8_t **pBitstream, oneStream_info* pSlice, GTS_BitStream *bs, bool bFirstTile)
+int32_t TstitchStream::merge_one_tile(uint8_t **pBitstream, oneStream_info* pSlice, GTS_BitStream *bs, bool bFirstTile, std::vector<slice_data_copy> *pDeferredCopies)
 {
     hevc_gen_tiledstream* pGenTilesStream = (hevc_gen_tiledstream*)m_pSteamStitch;
     if (!pGenTilesStream || !pBitstream || !pSlice || !bs)
@@ -1211,8 +1404,19 @@ int32_t TstitchStream::merge_one_tile(uint8_t **pBitstream, oneStream_info* pSli
     pBitstreamCur += bs->position - bs_position;
     bs_position = bs->position;
 
-    //copy slice data
-    memcpy_s(pBitstreamCur, nalsize[SLICE_DATA], pBufferSliceCur + specialLen, nalsize[SLICE_DATA]);
+    //copy slice data, or leave the room for it if the copy is deferred
+    if (pDeferredCopies)
+    {
+        slice_data_copy copy;
+        copy.pDst = pBitstreamCur;
+        copy.pSrc = pBufferSliceCur + specialLen;
+        copy.size = nalsize[SLICE_DATA];
+        pDeferredCopies->push_back(copy);
+    }
+    else
+    {
+        memcpy_s(pBitstreamCur, nalsize[SLICE_DATA], pBufferSliceCur + specialLen, nalsize[SLICE_DATA]);
+    }
     pBitstreamCur += nalsize[SLICE_DATA];
     bs->position += nalsize[SLICE_DATA];
     pBufferSliceCur += specialLen + nalsize[SLICE_DATA];
@@ -1223,6 +1427,123 @@ int32_t TstitchStream::merge_one_tile(uint8_t **pBitstream, oneStream_info* pSli
     return framesize;
 }
 
+static void copy_slice_data(const slice_data_copy *pCopies, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        memcpy_s(pCopies[i].pDst, pCopies[i].size, pCopies[i].pSrc, pCopies[i].size);
+    }
+}
+
+SliceCopyPool::SliceCopyPool()
+{
+    m_threadsNum = 0;
+    m_jobId = 0;
+    m_pending = 0;
+    m_stop = false;
+}
+
+SliceCopyPool::~SliceCopyPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_jobCond.notify_all();
+    for (size_t i = 0; i < m_workers.size(); i++)
+    {
+        m_workers[i].join();
+    }
+    m_workers.clear();
+}
+
+void SliceCopyPool::Run(uint32_t workerIdx)
+{
+    uint64_t doneJobId = 0;
+    for (;;)
+    {
+        const slice_data_copy *pBegin = NULL;
+        size_t count = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobCond.wait(lock, [this, doneJobId]() { return m_stop || m_jobId != doneJobId; });
+            if (m_stop)
+                return;
+            doneJobId = m_jobId;
+            pBegin = m_groupBegin[workerIdx];
+            count = m_groupCount[workerIdx];
+        }
+
+        copy_slice_data(pBegin, count);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0)
+            m_doneCond.notify_one();
+    }
+}
+
+void SliceCopyPool::Copy(const std::vector<slice_data_copy>& copies)
+{
+    uint64_t totalSize = 0;
+    for (size_t i = 0; i < copies.size(); i++)
+    {
+        totalSize += copies[i].size;
+    }
+
+    uint32_t threadsNum = m_threadsNum ? m_threadsNum : std::thread::hardware_concurrency();
+    threadsNum = (threadsNum > PARALLEL_COPY_MAX_THREADS) ? PARALLEL_COPY_MAX_THREADS : threadsNum;
+    threadsNum = (threadsNum > copies.size()) ? (uint32_t)copies.size() : threadsNum;
+    if (totalSize < PARALLEL_COPY_MIN_SIZE || threadsNum < 2)
+    {
+        copy_slice_data(copies.data(), copies.size());
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_workers.size() < threadsNum - 1)
+    {
+        m_groupBegin.resize(threadsNum - 1, NULL);
+        m_groupCount.resize(threadsNum - 1, 0);
+        for (uint32_t i = (uint32_t)m_workers.size(); i < threadsNum - 1; i++)
+        {
+            m_workers.push_back(std::thread(&SliceCopyPool::Run, this, i));
+        }
+    }
+
+    //split the tiles into contiguous groups of about the same size, the last group is copied by this thread
+    uint64_t groupSize = (totalSize + threadsNum - 1) / threadsNum;
+    size_t begin = 0;
+    size_t groupsNum = 0;
+    uint64_t curSize = 0;
+    for (size_t i = 0; i < copies.size() && groupsNum < threadsNum - 1; i++)
+    {
+        curSize += copies[i].size;
+        if (curSize >= groupSize)
+        {
+            m_groupBegin[groupsNum] = copies.data() + begin;
+            m_groupCount[groupsNum] = i + 1 - begin;
+            groupsNum++;
+            begin = i + 1;
+            curSize = 0;
+        }
+    }
+    //the other workers have nothing to copy this time
+    for (size_t i = groupsNum; i < m_workers.size(); i++)
+    {
+        m_groupBegin[i] = NULL;
+        m_groupCount[i] = 0;
+    }
+    m_pending = (uint32_t)m_workers.size();
+    m_jobId++;
+    lock.unlock();
+    m_jobCond.notify_all();
+
+    copy_slice_data(copies.data() + begin, copies.size() - begin);
+
+    lock.lock();
+    m_doneCond.wait(lock, [this]() { return m_pending == 0; });
+}
+
 int32_t TstitchStream::merge_partstream_into1bitstream(int32_t totalInputLen)
 {
     hevc_gen_tiledstream* pGenTilesStream = (hevc_gen_tiledstream*)m_pSteamStitch;
@@ -1247,6 +1568,9 @@ int32_t TstitchStream::merge_partstream_into1bitstream(int32_t totalInputLen)
 
     parse_tiles_info(pGenTilesStream);
 
+    //write all the headers first, and then copy the slice data
+    bool bDeferCopy = (m_copyPool.GetThreadsNum() != 1);
+    m_sliceDataCopies.clear();
     for (int32_t i = 0; i < pGenTilesStream->outTilesHeightCount; i++)
     {
         for (int32_t j = 0; j < pGenTilesStream->outTilesWidthCount; j++)
@@ -1270,11 +1594,12 @@ int32_t TstitchStream::merge_partstream_into1bitstream(int32_t totalInputLen)
             uint64_t bspos = 0;
             if (bs) bspos = bs->position;
             bool bFirstTile = (bool)((i == 0 && j == 0) == 1 ? 1 : 0);
-            int32_t curframesize = merge_one_tile(&pBitstreamCur, pSliceCur, bs, bFirstTile);
+            int32_t curframesize = merge_one_tile(&pBitstreamCur, pSliceCur, bs, bFirstTile, bDeferCopy ? &m_sliceDataCopies : NULL);
             pSliceCur->curBufferLen += curframesize;
             pSliceCur->outputBufferLen += (uint32_t)(bs->position - bspos);
         }
     }
+    m_copyPool.Copy(m_sliceDataCopies);
 
     if (bs) gts_bs_del(bs);
     return 0;
@@ -1387,6 +1712,12 @@ int32_t  TstitchStream::setViewportSEI(OMNIViewPort* pSeiViewport)
     return ret;
 }
 
+int32_t  TstitchStream::setCopyThreads(uint32_t threadsNum)
+{
+    m_copyPool.SetThreadsNum(threadsNum);
+    return 0;
+}
+
 int32_t  TstitchStream::getContentCoverage(CCDef* pOutCC)
 {
     int32_t ret = 0;
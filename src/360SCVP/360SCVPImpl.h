@@ -27,6 +27,81 @@
 #define _360SCVP_IMPL_H_
 #include "360SCVPHevcTilestream.h"
 #include "../utils/GlogWrapper.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//!
+//! \brief  the slice data copy of one tile in stream stitching, deferred until
+//!         all the headers are written, since only the headers depend on the bit
+//!         position of the output
+//!
+typedef struct SLICE_DATA_COPY
+{
+    uint8_t            *pDst;
+    const uint8_t      *pSrc;
+    uint32_t            size;
+}slice_data_copy;
+
+//!
+//! \brief  the workers copying the slice data of the large frames. they are
+//!         started at the first large frame and kept until the handle is
+//!         released, so no thread is created per frame
+//!
+class SliceCopyPool
+{
+public:
+    SliceCopyPool();
+    ~SliceCopyPool();
+
+    //!
+    //! \brief  set the number of threads copying, 0 to decide by the cores,
+    //!         1 to copy in place while merging
+    //!
+    void     SetThreadsNum(uint32_t threadsNum) { m_threadsNum = threadsNum; };
+    uint32_t GetThreadsNum() { return m_threadsNum; };
+
+    //!
+    //! \brief  copy the slice data of all tiles, the copies don't overlap once
+    //!         the headers are written
+    //!
+    void Copy(const std::vector<slice_data_copy>& copies);
+
+private:
+    SliceCopyPool(const SliceCopyPool&) = delete;
+    SliceCopyPool& operator=(const SliceCopyPool&) = delete;
+
+    void Run(uint32_t workerIdx);
+
+private:
+    uint32_t                  m_threadsNum;
+    std::vector<std::thread>  m_workers;
+    std::mutex                m_mutex;
+    std::condition_variable   m_jobCond;   //the job is posted or the pool is stopped
+    std::condition_variable   m_doneCond;  //all the workers finished the job
+    std::vector<const slice_data_copy*> m_groupBegin; //the group copied by each worker
+    std::vector<size_t>       m_groupCount;
+    uint64_t                  m_jobId;
+    uint32_t                  m_pending;
+    bool                      m_stop;
+};
+
+//!
+//! \brief  the index of one frame, got by parsing the frame once. It is not changed
+//!         after parsing, so the handles merging their viewport streams from this
+//!         frame can share it at the same time
+//!
+typedef struct FRAME_INDEX
+{
+    uint8_t            *pHeader[2];         //the headers at the beginning of the input bitstream
+    int32_t             specialDataLen[2];
+    int32_t             tilesCount[2];
+    nal_info           *pNalInfo[2];
+    HEVCState          *hevcState[2];       //the state after parsing the headers
+    tile_parsed_info    parsedHeader[2];
+    tile_parsed_info   *pParsedTiles[2];
+}frame_index;
 
 class TstitchStream
 {
@@ -76,6 +151,9 @@ protected:
     int32_t         m_hrTilesInRow;
     int32_t         m_hrTilesInCol;
     RegionWisePacking m_dstRwpk;
+    const tile_parsed_info **m_pParsedTiles[2]; //the selected tiles in the frame index
+    std::vector<slice_data_copy> m_sliceDataCopies;
+    SliceCopyPool   m_copyPool;
 
 public:
     uint16_t        m_nalType;
@@ -101,6 +179,9 @@ public:
     int32_t  feedParamToGenStream(param_360SCVP* pParamStitchStream);
     int32_t  setViewPort(float yaw, float pitch);
     int32_t  doMerge(param_360SCVP* pParamStitchStream);
+    frame_index* parseFrame(param_360SCVP* pParamStitchStream);
+    int32_t  processFrame(param_360SCVP* pParamStitchStream, frame_index* pFrame);
+    static void releaseFrame(frame_index* pFrame);
     int32_t  getFixedNumTiles(TileDef* pOutTile);
     int32_t  getTilesInViewport(TileDef* pOutTile);
     int32_t  parseNals(param_360SCVP* pParamStitchStream, int32_t parseType, Nalu* pNALU, int32_t streamIdx);
@@ -118,8 +199,9 @@ public:
     int32_t  setSphereRot(SphereRotation* pSphereRot);
     int32_t  setFramePacking(FramePacking* pFramePacking);
     int32_t  setViewportSEI(OMNIViewPort* pSeiViewport);
+    int32_t  setCopyThreads(uint32_t threadsNum);
     int32_t  doStreamStitch(param_360SCVP* pParamStitchStream);
-    int32_t  merge_one_tile(uint8_t **pBitstream, oneStream_info* pSlice, GTS_BitStream *bs, bool bFirstTile);
+    int32_t  merge_one_tile(uint8_t **pBitstream, oneStream_info* pSlice, GTS_BitStream *bs, bool bFirstTile, std::vector<slice_data_copy> *pDeferredCopies = NULL);
     int32_t  GenerateRwpkInfo(RegionWisePacking *dstRwpk);
     int32_t  EncRWPKSEI(RegionWisePacking* pRWPK, uint8_t *pRWPKBits, uint32_t* pRWPKBitsSize);
     int32_t  DecRWPKSEI(RegionWisePacking* pRWPK, uint8_t *pRWPKBits, uint32_t RWPKBitsSize);
@@ -130,6 +212,8 @@ protected:
     int32_t initMerge(param_360SCVP* pParamStitchStream, int32_t sliceSize);
     int32_t initViewport(Param_ViewPortInfo* pViewPortInfo, int32_t tilecolCount, int32_t tilerowCount);
     int32_t merge_partstream_into1bitstream(int32_t totalInputLen);
+    int32_t indexStream(frame_index* pFrame, uint8_t* pInput, int32_t streamIdx);
+    int32_t feedFrameToMerge(frame_index* pFrame);
 };// END CLASS DEFINITION
 
 #endif // _360SCVP_IMPL_H_
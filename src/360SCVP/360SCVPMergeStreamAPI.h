@@ -27,6 +27,7 @@
 #define _GENMERGESTREAM_API_H_
 
 #include "360SCVPTiledstreamAPI.h"
+#include "360SCVPHevcTilestream.h"
 
 //!
 //! \\brief    structure for one resolution parameters
@@ -44,6 +45,8 @@ typedef struct ONE_RES_PARAM
     int32_t                num_tile_columns;       //!< Number of tiles in column
     int32_t                num_tile_rows;          //!< Number of tiles in row
     bool                   bOrdered;               //!< flag for whether tiles are merged with order
+    const tile_parsed_info  *pParsedHeader;        //!< headers parsed when the frame is indexed, NULL to parse them in merging
+    const tile_parsed_info **pParsedTiles;         //!< tiles parsed when the frame is indexed, in the same order as pTiledBitstreams
 }one_res_param;
 
 //!
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "stdio.h"
+#include "string.h"
+#include "360SCVPRwpkUnpack.h"
+#include "360SCVPCommonDef.h"
+#include "../utils/GlogWrapper.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// each thread reconstructs one band of the projected picture, the bands are not thinner than this
+#define UNPACK_MIN_BAND_HEIGHT  64
+#define UNPACK_MAX_THREADS      16
+
+//!
+//! \brief  one region in the sample units of the plane being unpacked
+//!
+typedef struct UNPACK_REGION
+{
+    uint32_t projLeft;
+    uint32_t projTop;
+    uint32_t projWidth;
+    uint32_t projHeight;
+    uint32_t packedLeft;
+    uint32_t packedTop;
+    uint32_t packedWidth;
+    uint32_t packedHeight;
+    uint8_t  transformType;
+}unpack_region;
+
+//the sample of the source nearest to the center of the destination sample, as GL_NEAREST does
+static inline uint32_t nearest_sample(uint32_t dst, uint32_t dstSize, uint32_t srcSize)
+{
+    return (uint32_t)(((uint64_t)dst * 2 + 1) * srcSize / ((uint64_t)dstSize * 2));
+}
+
+static inline uint32_t mirror_sample(uint32_t pos, uint32_t size, bool bMirror)
+{
+    return bMirror ? (size - 1 - pos) : pos;
+}
+
+//doubles each sample of the row, which is the most used scaling of the low resolution regions
+static void upsample_row_2x(uint8_t *pDst, const uint8_t *pSrc, uint32_t srcWidth)
+{
+    uint32_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= srcWidth; i += 16)
+    {
+        __m128i samples = _mm_loadu_si128((const __m128i *)(pSrc + i));
+        _mm_storeu_si128((__m128i *)(pDst + 2 * i), _mm_unpacklo_epi8(samples, samples));
+        _mm_storeu_si128((__m128i *)(pDst + 2 * i + 16), _mm_unpackhi_epi8(samples, samples));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= srcWidth; i += 16)
+    {
+        uint8x16_t samples = vld1q_u8(pSrc + i);
+        uint8x16x2_t doubled = vzipq_u8(samples, samples);
+        vst1q_u8(pDst + 2 * i, doubled.val[0]);
+        vst1q_u8(pDst + 2 * i + 16, doubled.val[1]);
+    }
+#endif
+    for (; i < srcWidth; i++)
+    {
+        pDst[2 * i] = pSrc[i];
+        pDst[2 * i + 1] = pSrc[i];
+    }
+}
+
+//!
+//! \brief  unpack the rows [rowBegin, rowEnd) of the projected plane which are covered by the region,
+//!         the sample location conversion of each transform type follows the OMAF specification
+//!
+static void unpack_plane_region(
+    const uint8_t *pSrc,
+    uint32_t srcStride,
+    uint8_t *pDst,
+    uint32_t dstStride,
+    const unpack_region *pRegion,
+    uint32_t rowBegin,
+    uint32_t rowEnd,
+    std::vector<uint32_t> &table)
+{
+    uint32_t top = std::max(rowBegin, pRegion->projTop);
+    uint32_t bottom = std::min(rowEnd, pRegion->projTop + pRegion->projHeight);
+    if (top >= bottom)
+        return;
+
+    uint32_t width = pRegion->projWidth;
+    uint8_t type = pRegion->transformType;
+    table.resize(width);
+
+    if (type < ROTATION_90_ANTICLOCKWISE_BEFORE_MIRRORING_HOR)
+    {
+        bool bMirrorHor = (type == MIRRORING_HORIZONTALLY || type == ROTATION_180_ANTICLOCKWISE);
+        bool bMirrorVer = (type == ROTATION_180_ANTICLOCKWISE || type == ROTATION_180_ANTICLOCKWISE_AFTER_MIRRORING_HOR);
+        bool bCopy = !bMirrorHor && pRegion->packedWidth == width;
+        bool bDouble = !bMirrorHor && pRegion->packedWidth * 2 == width;
+        for (uint32_t x = 0; x < width; x++)
+        {
+            table[x] = pRegion->packedLeft + nearest_sample(mirror_sample(x, width, bMirrorHor), width, pRegion->packedWidth);
+        }
+
+        int64_t lastSrcRow = -1;
+        uint8_t *pLastDst = NULL;
+        for (uint32_t y = top; y < bottom; y++)
+        {
+            uint32_t srcRow = pRegion->packedTop +
+                nearest_sample(mirror_sample(y - pRegion->projTop, pRegion->projHeight, bMirrorVer), pRegion->projHeight, pRegion->packedHeight);
+            const uint8_t *pSrcRow = pSrc + (uint64_t)srcRow * srcStride;
+            uint8_t *pDstRow = pDst + (uint64_t)y * dstStride + pRegion->projLeft;
+
+            if (srcRow == lastSrcRow)
+            {
+                //the vertical scaling repeats the row
+                memcpy_s(pDstRow, width, pLastDst, width);
+            }
+            else if (bCopy)
+            {
+                memcpy_s(pDstRow, width, pSrcRow + pRegion->packedLeft, width);
+            }
+            else if (bDouble)
+            {
+                upsample_row_2x(pDstRow, pSrcRow + pRegion->packedLeft, pRegion->packedWidth);
+            }
+            else
+            {
+                for (uint32_t x = 0; x < width; x++)
+                {
+                    pDstRow[x] = pSrcRow[table[x]];
+                }
+            }
+            lastSrcRow = srcRow;
+            pLastDst = pDstRow;
+        }
+    }
+    else
+    {
+        //the region is rotated by 90 or 270 degrees, the projected rows are the packed columns
+        bool bMirrorCol = (type == ROTATION_90_ANTICLOCKWISE || type == ROTATION_270_ANTICLOCKWISE_BEFORE_MIRRORING_HOR);
+        bool bMirrorRow = (type == ROTATION_270_ANTICLOCKWISE_BEFORE_MIRRORING_HOR || type == ROTATION_270_ANTICLOCKWISE);
+        for (uint32_t x = 0; x < width; x++)
+        {
+            table[x] = pRegion->packedTop + nearest_sample(mirror_sample(x, width, bMirrorRow), width, pRegion->packedHeight);
+        }
+
+        for (uint32_t y = top; y < bottom; y++)
+        {
+            uint32_t srcCol = pRegion->packedLeft +
+                nearest_sample(mirror_sample(y - pRegion->projTop, pRegion->projHeight, bMirrorCol), pRegion->projHeight, pRegion->packedWidth);
+            uint8_t *pDstRow = pDst + (uint64_t)y * dstStride + pRegion->projLeft;
+            for (uint32_t x = 0; x < width; x++)
+            {
+                pDstRow[x] = pSrc[(uint64_t)table[x] * srcStride + srcCol];
+            }
+        }
+    }
+}
+
+//!
+//! \brief  unpack the luma rows [rowBegin, rowEnd) of the projected picture, all the regions are drawn
+//!         in order, so the band gets the same samples as the whole picture unpacked at once
+//!
+static void unpack_band(
+    const std::vector<unpack_region> *pRegions,
+    const Param_YUVPicture *pPackedPic,
+    Param_YUVPicture *pProjPic,
+    uint32_t rowBegin,
+    uint32_t rowEnd)
+{
+    std::vector<uint32_t> table;
+    for (uint32_t plane = 0; plane < 3; plane++)
+    {
+        uint32_t shift = plane ? 1 : 0;
+        for (size_t i = 0; i < pRegions->size(); i++)
+        {
+            const unpack_region &region = (*pRegions)[i];
+            unpack_region planeRegion;
+            planeRegion.projLeft = region.projLeft >> shift;
+            planeRegion.projTop = region.projTop >> shift;
+            planeRegion.projWidth = ((region.projLeft + region.projWidth) >> shift) - planeRegion.projLeft;
+            planeRegion.projHeight = ((region.projTop + region.projHeight) >> shift) - planeRegion.projTop;
+            planeRegion.packedLeft = region.packedLeft >> shift;
+            planeRegion.packedTop = region.packedTop >> shift;
+            planeRegion.packedWidth = ((region.packedLeft + region.packedWidth) >> shift) - planeRegion.packedLeft;
+            planeRegion.packedHeight = ((region.packedTop + region.packedHeight) >> shift) - planeRegion.packedTop;
+            planeRegion.transformType = region.transformType;
+            if (!planeRegion.projWidth || !planeRegion.projHeight || !planeRegion.packedWidth || !planeRegion.packedHeight)
+                continue;
+
+            unpack_plane_region(pPackedPic->pPlanes[plane], pPackedPic->strides[plane],
+                pProjPic->pPlanes[plane], pProjPic->strides[plane],
+                &planeRegion, rowBegin >> shift, rowEnd >> shift, table);
+        }
+    }
+}
+
+static bool check_picture(const Param_YUVPicture *pPic, uint32_t width, uint32_t height)
+{
+    if (pPic->width < width || pPic->height < height)
+        return false;
+    for (uint32_t plane = 0; plane < 3; plane++)
+    {
+        uint32_t planeWidth = plane ? (pPic->width + 1) / 2 : pPic->width;
+        if (!pPic->pPlanes[plane] || pPic->strides[plane] < planeWidth)
+            return false;
+    }
+    return true;
+}
+
+int32_t rwpk_unpack_picture(RegionWisePacking *pRWPK, Param_YUVPicture *pPackedPic, Param_YUVPicture *pProjPic, uint32_t threadsNum)
+{
+    if (!pRWPK || !pPackedPic || !pProjPic || !pRWPK->rectRegionPacking || !pRWPK->numRegions)
+        return 1;
+    if (!check_picture(pPackedPic, pRWPK->packedPicWidth, pRWPK->packedPicHeight)
+        || !check_picture(pProjPic, pRWPK->projPicWidth, pRWPK->projPicHeight))
+        return 1;
+
+    //the low resolution regions are drawn first, then the high resolution ones overwrite them
+    std::vector<unpack_region> regions;
+    for (int32_t pass = 0; pass < 2; pass++)
+    {
+        for (uint32_t i = 0; i < pRWPK->numRegions; i++)
+        {
+            RectangularRegionWisePacking *pRect = &pRWPK->rectRegionPacking[i];
+            if (pRect->transformType > ROTATION_270_ANTICLOCKWISE
+                || !pRect->projRegWidth || !pRect->projRegHeight || !pRect->packedRegWidth || !pRect->packedRegHeight
+                || (uint64_t)pRect->projRegLeft + pRect->projRegWidth > pRWPK->projPicWidth
+                || (uint64_t)pRect->projRegTop + pRect->projRegHeight > pRWPK->projPicHeight
+                || (uint32_t)pRect->packedRegLeft + pRect->packedRegWidth > pRWPK->packedPicWidth
+                || (uint32_t)pRect->packedRegTop + pRect->packedRegHeight > pRWPK->packedPicHeight)
+            {
+                LOG(ERROR) << "Invalid region " << i << " in the region wise packing!";
+                return 1;
+            }
+
+            bool bLowRes = (uint64_t)pRect->packedRegWidth * pRect->packedRegHeight < (uint64_t)pRect->projRegWidth * pRect->projRegHeight;
+            if (bLowRes != (pass == 0))
+                continue;
+
+            unpack_region region;
+            region.projLeft = pRect->projRegLeft;
+            region.projTop = pRect->projRegTop;
+            region.projWidth = pRect->projRegWidth;
+            region.projHeight = pRect->projRegHeight;
+            region.packedLeft = pRect->packedRegLeft;
+            region.packedTop = pRect->packedRegTop;
+            region.packedWidth = pRect->packedRegWidth;
+            region.packedHeight = pRect->packedRegHeight;
+            region.transformType = pRect->transformType;
+            regions.push_back(region);
+        }
+    }
+
+    if (!threadsNum)
+        threadsNum = std::thread::hardware_concurrency();
+    uint32_t maxBands = pRWPK->projPicHeight / UNPACK_MIN_BAND_HEIGHT;
+    threadsNum = std::min(std::min(threadsNum, (uint32_t)UNPACK_MAX_THREADS), maxBands);
+    if (threadsNum < 2)
+    {
+        unpack_band(&regions, pPackedPic, pProjPic, 0, pRWPK->projPicHeight);
+        return 0;
+    }
+
+    //the bands start at even rows, so each chroma row belongs to one band only
+    uint32_t bandHeight = ((pRWPK->projPicHeight + threadsNum - 1) / threadsNum + 1) & ~1u;
+    std::vector<std::thread> workers;
+    uint32_t rowBegin = 0;
+    for (; rowBegin + bandHeight < pRWPK->projPicHeight; rowBegin += bandHeight)
+    {
+        workers.push_back(std::thread(unpack_band, &regions, pPackedPic, pProjPic, rowBegin, rowBegin + bandHeight));
+    }
+    unpack_band(&regions, pPackedPic, pProjPic, rowBegin, pRWPK->projPicHeight);
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+    return 0;
+}
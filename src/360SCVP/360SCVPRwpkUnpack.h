@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2018, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _360SCVP_RWPK_UNPACK_H_
+#define _360SCVP_RWPK_UNPACK_H_
+
+#include "360SCVPAPI.h"
+
+//!
+//! \brief  reconstruct the projected picture from the packed one on CPU, it does
+//!         the same as the blits of the player render target: the regions are
+//!         sampled with the nearest filter, the low resolution ones first, then
+//!         the others on top of them
+//!
+//! \param  RegionWisePacking*   pRWPK,        input,  the region wise packing of the packed picture
+//! \param  Param_YUVPicture*    pPackedPic,   input,  the decoded 4:2:0 packed picture
+//! \param  Param_YUVPicture*    pProjPic,     output, the projected picture, projPicWidth x projPicHeight at least
+//! \param  uint32_t             threadsNum,   input,  the number of threads, 0 for the number of cores
+//!
+//! \return int32_t, 0 if succeed, not 0 if the parameters are invalid
+//!
+int32_t rwpk_unpack_picture(RegionWisePacking *pRWPK, Param_YUVPicture *pPackedPic, Param_YUVPicture *pProjPic, uint32_t threadsNum);
+
+#endif //_360SCVP_RWPK_UNPACK_H_
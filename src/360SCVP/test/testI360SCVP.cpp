@@ -27,6 +27,8 @@
 #include "gtest/gtest.h"
 #include <string>
 #include <fstream>
+#include <thread>
+#include <vector>
 #include "../360SCVPAPI.h"
 
 extern "C" {
@@ -1103,4 +1105,298 @@ TEST_F(I360SCVPTest, cubemapUsage)
     EXPECT_TRUE(ret == 0);
     EXPECT_TRUE(param.outputBitstreamLen > 0);
 }
+
+TEST_F(I360SCVPTest, parseFrameOnce_mergeMany)
+{
+    param.paramViewPort.faceWidth = 3840;
+    param.paramViewPort.faceHeight = 2048;
+    param.paramViewPort.geoTypeInput = EGeometryType(E_SVIDEO_EQUIRECT);
+    param.paramViewPort.viewportHeight = 960;
+    param.paramViewPort.viewportWidth = 960;
+    param.paramViewPort.geoTypeOutput = E_SVIDEO_VIEWPORT;
+    param.paramViewPort.viewPortPitch = 0;
+    param.paramViewPort.viewPortFOVH = 80;
+    param.paramViewPort.viewPortFOVV = 80;
+    param.usedType = E_MERGE_AND_VIEWPORT;
+    param.paramViewPort.paramVideoFP.cols = 1;
+    param.paramViewPort.paramVideoFP.rows = 1;
+    param.paramViewPort.paramVideoFP.faces[0][0].idFace = 0;
+    param.paramViewPort.paramVideoFP.faces[0][0].rotFace = NO_TRANSFORM;
+
+    const float yaws[] = { -90, 0, 45, 90, 180 };
+    const int viewers = sizeof(yaws) / sizeof(yaws[0]);
+    // the input is changed by the parsing, so each run starts from the original one
+    std::vector<unsigned char> oriInput(pInputBuffer, pInputBuffer + frameWidth * frameHeight * 3 / 2);
+    std::vector<unsigned char> oriInputLow(pInputBufferlow, pInputBufferlow + frameWidthlow * frameHeightlow * 3 / 2);
+
+    // the reference, each viewer parses and merges the frame by itself
+    std::vector<std::vector<unsigned char>> refOutput(viewers);
+    std::vector<std::vector<unsigned char>> refSEI(viewers);
+    for (int i = 0; i < viewers; i++)
+    {
+        memcpy_s(pInputBuffer, oriInput.size(), oriInput.data(), oriInput.size());
+        memcpy_s(pInputBufferlow, oriInputLow.size(), oriInputLow.data(), oriInputLow.size());
+        param_360SCVP refParam = param;
+        refParam.paramViewPort.viewPortYaw = yaws[i];
+        void* pI360SCVP = I360SCVP_Init(&refParam);
+        ASSERT_TRUE(pI360SCVP != NULL);
+        EXPECT_TRUE(I360SCVP_process(&refParam, pI360SCVP) == 0);
+        I360SCVP_unInit(pI360SCVP);
+        ASSERT_TRUE(refParam.outputBitstreamLen > 0);
+        refOutput[i].assign(pOutputBuffer, pOutputBuffer + refParam.outputBitstreamLen);
+        refSEI[i].assign(pOutputSEI, pOutputSEI + refParam.outputSEILen);
+    }
+
+    // parse the frame once, and all the viewers merge from the frame index at the same time
+    memcpy_s(pInputBuffer, oriInput.size(), oriInput.data(), oriInput.size());
+    memcpy_s(pInputBufferlow, oriInputLow.size(), oriInputLow.data(), oriInputLow.size());
+    param_360SCVP parserParam = param;
+    parserParam.paramViewPort.viewPortYaw = yaws[0];
+    void* pParser = I360SCVP_Init(&parserParam);
+    ASSERT_TRUE(pParser != NULL);
+
+    std::vector<param_360SCVP> viewerParams(viewers, param);
+    std::vector<void*> viewerHandles(viewers, NULL);
+    std::vector<std::vector<unsigned char>> outputs(viewers, std::vector<unsigned char>(bufferlen));
+    std::vector<std::vector<unsigned char>> seis(viewers, std::vector<unsigned char>(2000));
+    for (int i = 0; i < viewers; i++)
+    {
+        viewerParams[i].paramViewPort.viewPortYaw = yaws[i];
+        viewerHandles[i] = I360SCVP_Init(&viewerParams[i]);
+        ASSERT_TRUE(viewerHandles[i] != NULL);
+        viewerParams[i].pOutputBitstream = outputs[i].data();
+        viewerParams[i].pOutputSEI = seis[i].data();
+    }
+
+    void* pFrameIndex = I360SCVP_ParseFrame(&parserParam, pParser);
+    ASSERT_TRUE(pFrameIndex != NULL);
+
+    std::vector<unsigned char> indexedInput(pInputBuffer, pInputBuffer + oriInput.size());
+    std::vector<int> rets(viewers, -1);
+    std::vector<std::thread> mergeThreads;
+    for (int i = 0; i < viewers; i++)
+    {
+        mergeThreads.push_back(std::thread([&, i]() {
+            rets[i] = I360SCVP_processFrame(&viewerParams[i], pFrameIndex, viewerHandles[i]);
+        }));
+    }
+    for (auto& t : mergeThreads)
+        t.join();
+
+    for (int i = 0; i < viewers; i++)
+    {
+        EXPECT_TRUE(rets[i] == 0);
+        EXPECT_TRUE(viewerParams[i].outputBitstreamLen == refOutput[i].size());
+        EXPECT_TRUE(0 == memcmp(outputs[i].data(), refOutput[i].data(), refOutput[i].size()));
+        EXPECT_TRUE(viewerParams[i].outputSEILen == refSEI[i].size());
+        EXPECT_TRUE(0 == memcmp(seis[i].data(), refSEI[i].data(), refSEI[i].size()));
+    }
+    // the merges don't touch the shared input
+    EXPECT_TRUE(0 == memcmp(indexedInput.data(), pInputBuffer, indexedInput.size()));
+
+    EXPECT_TRUE(I360SCVP_releaseFrame(pFrameIndex) == 0);
+    for (int i = 0; i < viewers; i++)
+        I360SCVP_unInit(viewerHandles[i]);
+    I360SCVP_unInit(pParser);
+}
+
+TEST_F(I360SCVPTest, streamStitch_sliceData)
+{
+    param.usedType = E_STREAM_STITCH_ONLY;
+    param.paramPicInfo.picWidth = frameWidth;
+    param.paramPicInfo.picHeight = frameHeight;
+    param.paramPicInfo.tileWidthNum = 1;
+    param.paramPicInfo.tileHeightNum = 1;
+    param.paramPicInfo.tileIsUniform = 1;
+
+    std::vector<unsigned char> outputs[2];
+    uint32_t consumedLen = 0;
+    for (int run = 0; run < 2; run++)
+    {
+        void* pI360SCVP = I360SCVP_Init(&param);
+        ASSERT_TRUE(pI360SCVP != NULL);
+
+        param_oneStream_info tiledBitstream;
+        memset_s(&tiledBitstream, sizeof(param_oneStream_info), 0);
+        tiledBitstream.tilesWidthCount = 1;
+        tiledBitstream.tilesHeightCount = 1;
+        tiledBitstream.pTiledBitstreamBuffer = pInputBuffer;
+        tiledBitstream.inputBufferLen = bufferlen;
+        param_oneStream_info* pTiledBitstream = &tiledBitstream;
+        param.paramStitchInfo.pTiledBitstream = &pTiledBitstream;
+        param.inputBitstreamLen = bufferlen;
+
+        int ret = I360SCVP_process(&param, pI360SCVP);
+        I360SCVP_unInit(pI360SCVP);
+        EXPECT_TRUE(ret == 0);
+        ASSERT_TRUE(param.outputBitstreamLen > 0);
+        outputs[run].assign(pOutputBuffer, pOutputBuffer + param.outputBitstreamLen);
+        consumedLen = tiledBitstream.curBufferLen;
+    }
+
+    // the stitching is stable, and the slice data of the last tile ends the frame
+    EXPECT_TRUE(outputs[0] == outputs[1]);
+    const uint32_t tailLen = 256;
+    ASSERT_TRUE(consumedLen > tailLen && outputs[0].size() > tailLen);
+    EXPECT_TRUE(0 == memcmp(outputs[0].data() + outputs[0].size() - tailLen, pInputBuffer + consumedLen - tailLen, tailLen));
+}
+
+TEST_F(I360SCVPTest, streamStitch_parallelCopy)
+{
+    // 2x2 tiles of the same frame, large enough for the slice data to be copied in parallel
+    const int32_t tilesNum = 4;
+    param.usedType = E_STREAM_STITCH_ONLY;
+    param.paramPicInfo.picWidth = frameWidth * 2;
+    param.paramPicInfo.picHeight = frameHeight * 2;
+    param.paramPicInfo.tileWidthNum = 2;
+    param.paramPicInfo.tileHeightNum = 2;
+    param.paramPicInfo.tileIsUniform = 1;
+
+    // 1 copies in place while merging, 4 uses the copy workers, twice on the same handle
+    uint32_t copyThreads[2] = { 1, 4 };
+    std::vector<unsigned char> outputs[3];
+    for (int run = 0; run < 2; run++)
+    {
+        void* pI360SCVP = I360SCVP_Init(&param);
+        ASSERT_TRUE(pI360SCVP != NULL);
+        EXPECT_TRUE(0 == I360SCVP_SetParameter(pI360SCVP, ID_SCVP_PARAM_COPY_THREADS, &copyThreads[run]));
+
+        for (int frame = 0; frame < run + 1; frame++)
+        {
+            param_oneStream_info tiledBitstream[tilesNum];
+            param_oneStream_info* pTiledBitstream[tilesNum];
+            for (int32_t i = 0; i < tilesNum; i++)
+            {
+                memset_s(&tiledBitstream[i], sizeof(param_oneStream_info), 0);
+                tiledBitstream[i].tilesWidthCount = 1;
+                tiledBitstream[i].tilesHeightCount = 1;
+                tiledBitstream[i].pTiledBitstreamBuffer = pInputBuffer;
+                tiledBitstream[i].inputBufferLen = bufferlen;
+                pTiledBitstream[i] = &tiledBitstream[i];
+            }
+            param.paramStitchInfo.pTiledBitstream = pTiledBitstream;
+            param.inputBitstreamLen = bufferlen * tilesNum;
+
+            int ret = I360SCVP_process(&param, pI360SCVP);
+            EXPECT_TRUE(ret == 0);
+            ASSERT_TRUE(param.outputBitstreamLen > 512 * 1024);
+            outputs[run + frame].assign(pOutputBuffer, pOutputBuffer + param.outputBitstreamLen);
+            memset_s(pOutputBuffer, param.outputBitstreamLen, 0);
+        }
+        I360SCVP_unInit(pI360SCVP);
+    }
+
+    EXPECT_TRUE(outputs[0] == outputs[1]);
+    EXPECT_TRUE(outputs[0] == outputs[2]);
+}
+
+TEST_F(I360SCVPTest, unpackRWPK)
+{
+    //packed picture: 4 high resolution 128x128 tiles in the top row, the half size low resolution picture
+    //below them, and a 64x128 region rotated by 90 degrees beside it
+    const uint32_t packedWidth = 512;
+    const uint32_t packedHeight = 256;
+    const uint32_t projWidth = 512;
+    const uint32_t projHeight = 256;
+    std::vector<uint8_t> packed(packedWidth * packedHeight * 3 / 2);
+    for (uint32_t i = 0; i < packed.size(); i++)
+    {
+        packed[i] = (uint8_t)((i % packedWidth) * 7 + (i / packedWidth) * 13);
+    }
+
+    Param_YUVPicture packedPic;
+    packedPic.pPlanes[0] = packed.data();
+    packedPic.pPlanes[1] = packed.data() + packedWidth * packedHeight;
+    packedPic.pPlanes[2] = packedPic.pPlanes[1] + packedWidth * packedHeight / 4;
+    packedPic.strides[0] = packedWidth;
+    packedPic.strides[1] = packedWidth / 2;
+    packedPic.strides[2] = packedWidth / 2;
+    packedPic.width = packedWidth;
+    packedPic.height = packedHeight;
+
+    RectangularRegionWisePacking rects[6];
+    memset_s(rects, sizeof(rects), 0);
+    const uint32_t tilesLeft[4] = { 0, 128, 256, 384 };
+    for (int i = 0; i < 4; i++)
+    {
+        rects[i].projRegLeft = tilesLeft[i];
+        rects[i].projRegTop = 128;
+        rects[i].projRegWidth = 128;
+        rects[i].projRegHeight = 128;
+        rects[i].packedRegLeft = i * 128;
+        rects[i].packedRegTop = 0;
+        rects[i].packedRegWidth = 128;
+        rects[i].packedRegHeight = 128;
+    }
+    rects[4].projRegWidth = projWidth;
+    rects[4].projRegHeight = projHeight;
+    rects[4].packedRegTop = 128;
+    rects[4].packedRegWidth = 256;
+    rects[4].packedRegHeight = 128;
+    rects[5].transformType = ROTATION_90_ANTICLOCKWISE;
+    rects[5].projRegLeft = 256;
+    rects[5].projRegTop = 0;
+    rects[5].projRegWidth = 128;
+    rects[5].projRegHeight = 64;
+    rects[5].packedRegLeft = 256;
+    rects[5].packedRegTop = 128;
+    rects[5].packedRegWidth = 64;
+    rects[5].packedRegHeight = 128;
+
+    RegionWisePacking RWPK;
+    memset_s(&RWPK, sizeof(RWPK), 0);
+    RWPK.numRegions = 6;
+    RWPK.projPicWidth = projWidth;
+    RWPK.projPicHeight = projHeight;
+    RWPK.packedPicWidth = packedWidth;
+    RWPK.packedPicHeight = packedHeight;
+    RWPK.rectRegionPacking = rects;
+
+    std::vector<uint8_t> projs[2];
+    for (int run = 0; run < 2; run++)
+    {
+        projs[run].assign(projWidth * projHeight * 3 / 2, 0);
+        Param_YUVPicture projPic;
+        projPic.pPlanes[0] = projs[run].data();
+        projPic.pPlanes[1] = projs[run].data() + projWidth * projHeight;
+        projPic.pPlanes[2] = projPic.pPlanes[1] + projWidth * projHeight / 4;
+        projPic.strides[0] = projWidth;
+        projPic.strides[1] = projWidth / 2;
+        projPic.strides[2] = projWidth / 2;
+        projPic.width = projWidth;
+        projPic.height = projHeight;
+        EXPECT_TRUE(0 == I360SCVP_UnpackRWPK(&RWPK, &packedPic, &projPic, run ? 4 : 1));
+    }
+    //the bands of the threads give the same picture
+    EXPECT_TRUE(projs[0] == projs[1]);
+
+    const uint8_t *pY = projs[1].data();
+    const uint8_t *pU = pY + projWidth * projHeight;
+    bool bHighRes = true;
+    bool bLowRes = true;
+    bool bRotated = true;
+    for (uint32_t y = 0; y < projHeight; y++)
+    {
+        for (uint32_t x = 0; x < projWidth; x++)
+        {
+            uint8_t sample = pY[y * projWidth + x];
+            if (y >= 128)
+                bHighRes = bHighRes && (sample == packed[(y - 128) * packedWidth + x]);
+            else if (x >= 256 && x < 384 && y < 64)
+                bRotated = bRotated && (sample == packed[(128 + x - 256) * packedWidth + 256 + 63 - y]);
+            else
+                bLowRes = bLowRes && (sample == packed[(128 + y / 2) * packedWidth + x / 2]);
+        }
+    }
+    EXPECT_TRUE(bHighRes);
+    EXPECT_TRUE(bLowRes);
+    EXPECT_TRUE(bRotated);
+    //the chroma of the high resolution tiles is copied at half size
+    EXPECT_TRUE(0 == memcmp(pU + 64 * projWidth / 2, packedPic.pPlanes[1], projWidth / 2));
+
+    //the regions out of the packed picture are refused
+    rects[5].packedRegTop = 200;
+    Param_YUVPicture projPic = packedPic;
+    EXPECT_TRUE(0 != I360SCVP_UnpackRWPK(&RWPK, &packedPic, &projPic, 1));
+}
 }
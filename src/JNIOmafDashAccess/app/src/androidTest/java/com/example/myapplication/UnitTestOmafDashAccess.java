@@ -100,6 +100,22 @@ public class UnitTestOmafDashAccess {
         predictor_params.libpath = "";
         predictor_params.name = "";
         predictor_params.enable = 0;
+        //abr params
+        JnaOmafAccess._omafAbrParams.ByValue abr_params = new JnaOmafAccess._omafAbrParams.ByValue();
+        abr_params.target_buffer_ms = 3000;
+        abr_params.min_viewport_hq_tiles = 1;
+        abr_params.enable = 1;
+        //cache params
+        JnaOmafAccess._omafCacheParams.ByValue cache_params = new JnaOmafAccess._omafCacheParams.ByValue();
+        cache_params.memory_budget = 64 * 1024 * 1024;
+        cache_params.spill_budget = 0;
+        cache_params.enable_spill = 0;
+        cache_params.enable = 1;
+        //sub segment params
+        JnaOmafAccess._omafSubSegmentParams.ByValue sub_segment_params = new JnaOmafAccess._omafSubSegmentParams.ByValue();
+        sub_segment_params.index_probe_size = 4096;
+        sub_segment_params.check_interval_ms = 200;
+        sub_segment_params.enable = 1;
         JnaOmafAccess._omafDashParams.ByValue omaf_params = new JnaOmafAccess._omafDashParams.ByValue();
         omaf_params.proxy = proxy;
         omaf_params.http_params = http_params;
@@ -108,6 +124,9 @@ public class UnitTestOmafDashAccess {
         omaf_params.predictor_params = predictor_params;
         omaf_params.max_parallel_transfers = max_parallel_transfers;
         omaf_params.segment_open_timeout_ms = segment_open_timeout_ms;
+        omaf_params.abr_params = abr_params;
+        omaf_params.cache_params = cache_params;
+        omaf_params.sub_segment_params = sub_segment_params;
         OmafAccess omafAccess = new OmafAccess(url_static, cache_path, source_type, enable_extractor, omaf_params);
         //2. initialize
         int ret = 0;
@@ -165,6 +184,12 @@ public class UnitTestOmafDashAccess {
                     byteBuffer2.get(bytes2, 0, bytes2.length);
                     outStream2.write(bytes2);
                 }
+                // the rwpk is shared, release it instead of freeing
+                for (int i = 0; ret == 0 && i < size.getValue(); i++) {
+                    if (dashPackets[i] != null) {
+                        omafAccess.ReleaseRwpk(dashPackets[i]);
+                    }
+                }
             }
             outStream1.close();
             outStream2.close();
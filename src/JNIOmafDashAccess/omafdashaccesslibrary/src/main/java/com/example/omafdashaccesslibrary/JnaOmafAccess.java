@@ -370,6 +370,11 @@ public interface JnaOmafAccess extends Library {
         public int retry_times;
         public int ssl_verify_peer;
         public int ssl_verify_host;
+        public int http_version;
+        public int disable_multiplex;
+        public long max_host_connections;
+        public long max_concurrent_streams;
+        public int warmup_connections;
         public _omafHttpParams() {
             super();
             this.conn_timeout = 0;
@@ -377,9 +382,14 @@ public interface JnaOmafAccess extends Library {
             this.retry_times = 0;
             this.ssl_verify_peer = 0;
             this.ssl_verify_host = 0;
+            this.http_version = 0;
+            this.disable_multiplex = 0;
+            this.max_host_connections = 0;
+            this.max_concurrent_streams = 0;
+            this.warmup_connections = 0;
         }
         protected List getFieldOrder() {
-            return Arrays.asList("conn_timeout", "total_timeout", "retry_times", "ssl_verify_peer", "ssl_verify_host");
+            return Arrays.asList("conn_timeout", "total_timeout", "retry_times", "ssl_verify_peer", "ssl_verify_host", "http_version", "disable_multiplex", "max_host_connections", "max_concurrent_streams", "warmup_connections");
         }
         public _omafHttpParams(long conn_timeout, long total_timeout, int retry_times, int ssl_verify_peer, int ssl_verify_host) {
             super();
@@ -449,20 +459,30 @@ public interface JnaOmafAccess extends Library {
         public String name;
         public String libpath;
         public int enable;
+        public float min_view_probability;
         public _omafPredictorParams() {
             super();
             this.name = "";
             this.libpath = "";
             this.enable = 0;
+            this.min_view_probability = 0;
         }
         protected List getFieldOrder() {
-            return Arrays.asList("name", "libpath", "enable");
+            return Arrays.asList("name", "libpath", "enable", "min_view_probability");
         }
         public _omafPredictorParams(String name, String libpath, int enable) {
             super();
             this.name = name;
             this.libpath = libpath;
             this.enable = enable;
+            this.min_view_probability = 0;
+        }
+        public _omafPredictorParams(String name, String libpath, int enable, float min_view_probability) {
+            super();
+            this.name = name;
+            this.libpath = libpath;
+            this.enable = enable;
+            this.min_view_probability = min_view_probability;
         }
         protected ByReference newByReference() { return new ByReference(); }
         protected ByValue newByValue() { return new ByValue(); }
@@ -472,6 +492,93 @@ public interface JnaOmafAccess extends Library {
         public static class ByValue extends _omafPredictorParams implements Structure.ByValue {  };
     };
 
+    public static class _omafAbrParams extends Structure {
+        public int target_buffer_ms;
+        public int min_viewport_hq_tiles;
+        public int enable;
+        public _omafAbrParams() {
+            super();
+            this.target_buffer_ms = 0;
+            this.min_viewport_hq_tiles = -1;
+            this.enable = 0;
+        }
+        protected List getFieldOrder() {
+            return Arrays.asList("target_buffer_ms", "min_viewport_hq_tiles", "enable");
+        }
+        public _omafAbrParams(int target_buffer_ms, int min_viewport_hq_tiles, int enable) {
+            super();
+            this.target_buffer_ms = target_buffer_ms;
+            this.min_viewport_hq_tiles = min_viewport_hq_tiles;
+            this.enable = enable;
+        }
+        protected ByReference newByReference() { return new ByReference(); }
+        protected ByValue newByValue() { return new ByValue(); }
+        protected _omafAbrParams newInstance() { return new _omafAbrParams(); }
+
+        public static class ByReference extends _omafAbrParams implements Structure.ByReference {  };
+        public static class ByValue extends _omafAbrParams implements Structure.ByValue {  };
+    };
+
+    public static class _omafCacheParams extends Structure {
+        public long memory_budget;
+        public long spill_budget;
+        public int enable_spill;
+        public int enable;
+        public int enable_init_cache;
+        public _omafCacheParams() {
+            super();
+            this.memory_budget = 0;
+            this.spill_budget = 0;
+            this.enable_spill = 0;
+            this.enable = 0;
+            this.enable_init_cache = 0;
+        }
+        protected List getFieldOrder() {
+            return Arrays.asList("memory_budget", "spill_budget", "enable_spill", "enable", "enable_init_cache");
+        }
+        public _omafCacheParams(long memory_budget, long spill_budget, int enable_spill, int enable, int enable_init_cache) {
+            super();
+            this.memory_budget = memory_budget;
+            this.spill_budget = spill_budget;
+            this.enable_spill = enable_spill;
+            this.enable = enable;
+            this.enable_init_cache = enable_init_cache;
+        }
+        protected ByReference newByReference() { return new ByReference(); }
+        protected ByValue newByValue() { return new ByValue(); }
+        protected _omafCacheParams newInstance() { return new _omafCacheParams(); }
+
+        public static class ByReference extends _omafCacheParams implements Structure.ByReference {  };
+        public static class ByValue extends _omafCacheParams implements Structure.ByValue {  };
+    };
+
+    public static class _omafSubSegmentParams extends Structure {
+        public long index_probe_size;
+        public int check_interval_ms;
+        public int enable;
+        public _omafSubSegmentParams() {
+            super();
+            this.index_probe_size = 0;
+            this.check_interval_ms = 0;
+            this.enable = 0;
+        }
+        protected List getFieldOrder() {
+            return Arrays.asList("index_probe_size", "check_interval_ms", "enable");
+        }
+        public _omafSubSegmentParams(long index_probe_size, int check_interval_ms, int enable) {
+            super();
+            this.index_probe_size = index_probe_size;
+            this.check_interval_ms = check_interval_ms;
+            this.enable = enable;
+        }
+        protected ByReference newByReference() { return new ByReference(); }
+        protected ByValue newByValue() { return new ByValue(); }
+        protected _omafSubSegmentParams newInstance() { return new _omafSubSegmentParams(); }
+
+        public static class ByReference extends _omafSubSegmentParams implements Structure.ByReference {  };
+        public static class ByValue extends _omafSubSegmentParams implements Structure.ByValue {  };
+    };
+
     public static class _omafDashParams extends Structure {
         public JnaOmafAccess._omafHttpProxy.ByValue proxy;
         public JnaOmafAccess._omafHttpParams.ByValue http_params;
@@ -480,6 +587,9 @@ public interface JnaOmafAccess extends Library {
         public JnaOmafAccess._omafPredictorParams.ByValue predictor_params;
         public long max_parallel_transfers;
         public int segment_open_timeout_ms;
+        public JnaOmafAccess._omafAbrParams.ByValue abr_params;
+        public JnaOmafAccess._omafCacheParams.ByValue cache_params;
+        public JnaOmafAccess._omafSubSegmentParams.ByValue sub_segment_params;
         public _omafDashParams() {
             super();
             this.proxy = null;
@@ -489,12 +599,17 @@ public interface JnaOmafAccess extends Library {
             this.predictor_params = null;
             this.max_parallel_transfers = 0;
             this.segment_open_timeout_ms = 0;
+            this.abr_params = null;
+            this.cache_params = null;
+            this.sub_segment_params = null;
         }
         protected List getFieldOrder() {
-            return Arrays.asList("proxy", "http_params", "statistic_params", "synchronizer_params", "predictor_params", "max_parallel_transfers", "segment_open_timeout_ms");
+            return Arrays.asList("proxy", "http_params", "statistic_params", "synchronizer_params", "predictor_params", "max_parallel_transfers", "segment_open_timeout_ms", "abr_params", "cache_params", "sub_segment_params");
         }
         public _omafDashParams(JnaOmafAccess._omafHttpProxy.ByValue proxy, JnaOmafAccess._omafHttpParams.ByValue http_params, JnaOmafAccess._omafStatisticsParams.ByValue statistic_params,
-                               JnaOmafAccess._omafSynchronizerParams.ByValue synchronizer_params, JnaOmafAccess._omafPredictorParams.ByValue predictor_params, long max_parallel_transfers, int segment_open_timeout_ms) {
+                               JnaOmafAccess._omafSynchronizerParams.ByValue synchronizer_params, JnaOmafAccess._omafPredictorParams.ByValue predictor_params, long max_parallel_transfers, int segment_open_timeout_ms,
+                               JnaOmafAccess._omafAbrParams.ByValue abr_params, JnaOmafAccess._omafCacheParams.ByValue cache_params,
+                               JnaOmafAccess._omafSubSegmentParams.ByValue sub_segment_params) {
             super();
             this.proxy = proxy;
             this.http_params = http_params;
@@ -503,6 +618,9 @@ public interface JnaOmafAccess extends Library {
             this.predictor_params = predictor_params;
             this.max_parallel_transfers = max_parallel_transfers;
             this.segment_open_timeout_ms = segment_open_timeout_ms;
+            this.abr_params = abr_params;
+            this.cache_params = cache_params;
+            this.sub_segment_params = sub_segment_params;
         }
         protected ByReference newByReference() { return new ByReference(); }
         protected ByValue newByValue() { return new ByValue(); }
@@ -600,11 +718,14 @@ public interface JnaOmafAccess extends Library {
         public int tileRowNum;
         public int tileColNum;
         public boolean bEOS;
+        /** C type : void*, shared reference of rwpk, released by OmafAccess_ReleaseRwpk */
+        public Pointer rwpkRef;
+        public long rwpkVersion;
         public DASHPACKET() {
             super();
         }
         protected List getFieldOrder() {
-            return Arrays.asList("videoID", "video_codec", "pts", "size", "buf", "rwpk", "segID", "height", "width", "numQuality", "qtyResolution", "tileRowNum", "tileColNum", "bEOS");
+            return Arrays.asList("videoID", "video_codec", "pts", "size", "buf", "rwpk", "segID", "height", "width", "numQuality", "qtyResolution", "tileRowNum", "tileColNum", "bEOS", "rwpkRef", "rwpkVersion");
         }
         /**
          * @param buf C type : char*<br>
@@ -767,6 +888,13 @@ public interface JnaOmafAccess extends Library {
      * <i>native declaration : line 232</i>
      */
     int OmafAccess_GetPacket(Pointer hdl, int stream_id, JnaOmafAccess.DASHPACKET[] packet, IntByReference size, LongByReference pts, byte needParams, byte clearBuf);
+    /**
+     * description: API to release the shared rwpk of a packet gotten with OmafAccess_GetPacket<br>
+     * params: packet - [in/out] the packet, its rwpk and rwpkRef are reset<br>
+     * return: the error return from the API<br>
+     * Original signature : <code>int OmafAccess_ReleaseRwpk(DashPacket*)</code><br>
+     */
+    int OmafAccess_ReleaseRwpk(JnaOmafAccess.DASHPACKET packet);
     /**
      * description: API to set InitViewport before downloading segment.<br>
      * params: hdl - [in]handler created with DashStreaming_Init<br>
@@ -112,6 +112,14 @@ public class OmafAccess {
         return JnaOmafAccess.INSTANCE.OmafAccess_GetPacket(this.mHandle, stream_id, packet, size, pts, needParams, clearBuf);
     }
 
+    public int ReleaseRwpk(JnaOmafAccess.DASHPACKET packet){
+        if(packet == null){
+            Log.e(TAG, "Packet is NULL; cannot release its rwpk !!!");
+            return -1;
+        }
+        return JnaOmafAccess.INSTANCE.OmafAccess_ReleaseRwpk(packet);
+    }
+
     public int SetupHeadSetInfo( JnaOmafAccess.HEADSETINFO clientInfo){
         if(mHandle == null){
             Log.e(TAG, "Omaf Access Handle is NULL; cannot continue !!!");
@@ -38,9 +38,9 @@
 #define _DOWNLOADMANAGER_H
 
 #include "general.h"
+#include "OmafAbrController.h"
 #include <mutex>
-
-typedef bool (*enum_dir_item)(void *cbck, std::string item_name, std::string item_path);
+#include <vector>
 
 VCD_OMAF_BEGIN
 
@@ -56,44 +56,27 @@ public:
     int DeleteCacheFile(std::string url);
 
     //!
-    //! \brief  Delete a all cached files from cache.
-    //!
-    void CleanCache();
-
-    //!
-    //! \brief  Delete a all cached files from cache with condition that
-    //!         the file time is less than ...
-    //!
-    void DeleteCacheByTime( uint64_t interval );
-
-    //!
-    //! \brief  Delete a all cached files from cache with condition that
-    //!         the total cache size is large thanm MaxCacheSize
-    //!
-    void DeleteCacheBySize( );
-
+    //! \brief  Get a downloading bit rate, the throughput measured on the latest
+    //!         transfers of all the sources with abr enabled, in bps
     //!
-    //! \brief  Get a Cache file name
-    //!
-    std::string AssignCacheFileName();
+    int GetImmediateBitrate();
 
     //!
-    //! \brief  Get a downloading bit rate
+    //! \brief  Get an average downloading bit rate, the long term throughput
+    //!         measured of all the sources with abr enabled, in bps
     //!
-    int GetImmediateBitrate();
+    int GetAverageBitrate();
 
     //!
-    //! \brief  Get an average downloading bit rate
+    //! \brief  Add/Remove the abr controller of a source, whose measured
+    //!         throughput is summed into the bit rates
     //!
-    int GetAverageBitrate();
+    void AddAbrController(OmafAbrController::Ptr abr);
+    void RemoveAbrController(OmafAbrController::Ptr abr);
 
     //!
     //! \brief  Get/Set methods for properties
     //!
-    void        SetMaxCacheSize(uint64_t size)          { mMaxCacheSize = size;        };
-    uint64_t    GetMaxCacheSize()                       { return mMaxCacheSize;        };
-    void        SetStartTime(uint64_t size)             { mStartTime = size;           };
-    uint64_t    GetStartTime()                          { return mStartTime;           };
     uint64_t    GetDownloadBytes()                      { return mDownloadedBytes;     };
     std::string GetCacheFolder()                        { return mCacheDir;            };
     int         SetCacheFolder( std::string cache_dir );
@@ -102,57 +85,14 @@ public:
     bool        UseCache()                              { return mUseCache;            };
     void        SetUseCache(bool bCache)                { mUseCache = bCache;          };
 
-private:
-
-    //!
-    //! \brief  the implementation to delete all files
-    //!
-    void delete_all_cached_files( std::string directory );
-
-    //!
-    //! \brief  the implementation to get cache size
-    //!
-    uint64_t CacheGetSize( std::string directory );
-
-    //!
-    //! \brief callback to delete file
-    //!
-    //static bool delete_cache_files( void *cbck,
-    //                         std::string item_name,
-    //                         std::string item_path );
-
-    //!
-    //! \brief  callback to get size of each file
-    //!
-    //static bool GatherCacheSize( void *cbck,
-    //                      std::string item_name,
-     //                     std::string item_path );
-
-    //!
-    //! \brief  enumerate all files in a directory
-    //!
-    int enum_directory( const char *dir,
-                        bool enum_directory,
-                        enum_dir_item enum_dir_fct,
-                        void *cbck,
-                        const char *filter = NULL);
-
-    //!
-    //! \brief  generate a random string for assigning cache file name
-    //!
-    std::string GetRandomString(int size);
-
 private:
     int                            mDownloadedBytes;    //<! the total downloaded bytes
     int                            mDownloadedFiles;    //<! the total downloaded files
     std::string                    mCacheDir;           //<! the directory of the cache file
     std::string                    mFilePrefix;         //<! the prefix for each cached file
     std::mutex                     mMutex;              //<! for synchronization
-    uint64_t                       mStartTime;          //<! the start time to caching in this process
-    uint64_t                       mMaxCacheSize;       //<! the threshold of total cache file size
-    bool                           mUseCache;           //<! the flag to indicate whether using file caching
-    int32_t                        m_count;             //<! count for random file name
-    std::mutex                     mCacheMtx;                //<! mutex for cache clear
+    bool                           mUseCache;           //<! the flag to indicate whether using segment caching
+    std::vector<OmafAbrController::Ptr> mAbrControllers; //<! the throughput measurement of each source
 };
 
 typedef VCD::VRVideo::Singleton<DownloadManager> DOWNLOADMANAGER;    //<! singleton of DownloadManager
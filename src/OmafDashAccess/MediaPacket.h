@@ -38,6 +38,7 @@
 #define MEDIAPACKET_H_
 
 #include "../utils/ns_def.h"
+#include "../utils/RwpkCache.h"
 #include "common.h"
 #include "general.h"
 #include "iso_structure.h"
@@ -81,7 +82,7 @@ class MediaPacket : public VCD::NonCopyable {
       m_nRealSize = 0;
       m_segID = 0;
     }
-    if (m_rwpk) deleteRwpk();
+    m_rwpk.reset();
   };
 
   MediaPacket* InsertParams(std::vector<uint8_t> params) {
@@ -204,30 +205,12 @@ class MediaPacket : public VCD::NonCopyable {
 
   void SetRealSize(uint64_t realSize) { m_nRealSize = realSize; };
   uint64_t GetRealSize() { return m_nRealSize; };
-  // FIXME, refine and optimize
-  void SetRwpk(std::unique_ptr<RegionWisePacking> rwpk) { m_rwpk = std::move(rwpk); };
-  // RegionWisePacking* GetRwpk() { return m_rwpk.get(); };
-  const RegionWisePacking& GetRwpk() const { return *m_rwpk.get(); };
-  void copyRwpk(RegionWisePacking* to) {
-    if (to && m_rwpk.get()) {
-      if (to->rectRegionPacking) {
-        delete[] to->rectRegionPacking;
-      }
-      *to = *m_rwpk.get();
-      to->rectRegionPacking = new RectangularRegionWisePacking[m_rwpk->numRegions];
-      memcpy_s(to->rectRegionPacking, m_rwpk->numRegions * sizeof(RectangularRegionWisePacking),
-               m_rwpk->rectRegionPacking, m_rwpk->numRegions * sizeof(RectangularRegionWisePacking));
-    }
-  }
-  void moveRwpk(RegionWisePacking* to) {
-    if (to && m_rwpk.get()) {
-      if (to->rectRegionPacking) {
-        delete[] to->rectRegionPacking;
-      }
-      *to = *m_rwpk.get();
-      m_rwpk->rectRegionPacking = nullptr;
-    }
-  }
+  //!
+  //! \brief  the rwpk is immutable and shared by the packets with the same packing
+  //!
+  void SetRwpk(VCD::VRVideo::SharedRwpk::Ptr rwpk) { m_rwpk = std::move(rwpk); };
+  const RegionWisePacking& GetRwpk() const { return *m_rwpk->Get(); };
+  VCD::VRVideo::SharedRwpk::Ptr GetSharedRwpk() const { return m_rwpk; };
   int GetSegID() { return m_segID; };
   void SetSegID(int id) { m_segID = id; };
 
@@ -333,8 +316,7 @@ private:
   int m_type = -1;             //!< the type of the payload
   uint64_t mPts = 0;
   int m_segID = 0;
-  // RegionWisePacking* m_rwpk;
-  std::unique_ptr<RegionWisePacking> m_rwpk;
+  VCD::VRVideo::SharedRwpk::Ptr m_rwpk;
   QualityRank m_qualityRanking = HIGHEST_QUALITY_RANKING;
   SRDInfo m_srd;
 
@@ -354,16 +336,6 @@ private:
   uint32_t m_VPSLen = 0;
   uint32_t m_SPSLen = 0;
   uint32_t m_PPSLen = 0;
-
-  void deleteRwpk() {
-    if (m_rwpk) {
-      if (m_rwpk->rectRegionPacking != nullptr) {
-        delete[] m_rwpk->rectRegionPacking;
-        m_rwpk->rectRegionPacking = nullptr;
-      }
-      m_rwpk.reset();
-    }
-  }
 };
 }  // namespace OMAF
 }  // namespace VCD
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+//!
+//! \file:   OmafAbrController.cpp
+//! \brief:  throughput based adaptive bitrate controller
+//!
+
+#include "OmafAbrController.h"
+#include "../utils/GlogWrapper.h"
+
+#include <algorithm>
+
+namespace VCD {
+namespace OMAF {
+
+// no transfer finished in this gap, the pending sample is complete
+const std::chrono::milliseconds SAMPLE_IDLE_GAP(100);
+
+void OmafAbrController::AddTransfer(size_t transfer_bytes, long download_time_us,
+                                    std::chrono::steady_clock::time_point end_time) noexcept {
+  try {
+    if (transfer_bytes == 0 || download_time_us <= 0) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto start_time = end_time - std::chrono::microseconds(download_time_us);
+
+    // the transfer starts after the pending ones are done, so the link was idle between them
+    if (sample_bytes_ > 0 && start_time > sample_end_) {
+      commitSample();
+    }
+
+    if (sample_bytes_ == 0) {
+      sample_start_ = start_time;
+      sample_end_ = end_time;
+    } else {
+      sample_start_ = std::min(sample_start_, start_time);
+      sample_end_ = std::max(sample_end_, end_time);
+    }
+    sample_bytes_ += transfer_bytes;
+
+    // busy link, don't hold the sample for ever
+    if (sample_end_ - sample_start_ >= std::chrono::milliseconds(params_.max_sample_span_ms_)) {
+      commitSample();
+    }
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when add transfer to abr controller, ex: " << ex.what() << std::endl;
+  }
+}
+
+void OmafAbrController::SetBufferLevel(int64_t buffer_ms) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffer_ms_ = buffer_ms;
+}
+
+double OmafAbrController::GetEstimatedBandwidth() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  flushIdleSample(std::chrono::steady_clock::now());
+  return estimate();
+}
+
+double OmafAbrController::GetFastBandwidth() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  flushIdleSample(std::chrono::steady_clock::now());
+  return fast_ewma_bps_;
+}
+
+double OmafAbrController::GetSlowBandwidth() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  flushIdleSample(std::chrono::steady_clock::now());
+  return slow_ewma_bps_;
+}
+
+double OmafAbrController::GetHarmonicBandwidth() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  flushIdleSample(std::chrono::steady_clock::now());
+  double inverse_sum = 0.0;
+  for (auto bps : harmonic_samples_) {
+    inverse_sum += 1.0 / bps;
+  }
+  return inverse_sum > 0.0 ? harmonic_samples_.size() / inverse_sum : 0.0;
+}
+
+int32_t OmafAbrController::SelectViewportTiles(const std::vector<uint64_t> &tile_bitrates,
+                                               uint64_t background_bitrate) noexcept {
+  try {
+    int32_t candidates = static_cast<int32_t>(tile_bitrates.size());
+    if (candidates == 0) {
+      return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushIdleSample(std::chrono::steady_clock::now());
+
+    double bandwidth = estimate();
+    if (bandwidth <= 0.0) {
+      // nothing measured yet, start from the full viewport
+      last_selected_tiles_ = candidates;
+      return candidates;
+    }
+
+    double budget = bandwidth * params_.safety_factor_ * bufferFactor() - static_cast<double>(background_bitrate);
+    int32_t selected = 0;
+    double required = 0.0;
+    for (auto bitrate : tile_bitrates) {
+      required += static_cast<double>(bitrate);
+      // adding tiles needs some headroom, so the selection won't flap around the estimation
+      double margin = (last_selected_tiles_ >= 0 && selected >= last_selected_tiles_) ? params_.switch_up_margin_ : 0.0;
+      if (required * (1.0 + margin) > budget) {
+        break;
+      }
+      selected++;
+    }
+
+    int32_t min_tiles = std::min(std::max(params_.min_viewport_hq_tiles_, 0), candidates);
+    selected = std::max(selected, min_tiles);
+
+    if (selected != last_selected_tiles_) {
+      LOG(INFO) << "ABR selects " << selected << "/" << candidates << " high quality tiles in viewport, bandwidth "
+                << bandwidth / 1000.0 << " kbps, buffer " << buffer_ms_ << " ms" << std::endl;
+    }
+    last_selected_tiles_ = selected;
+    return selected;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when select viewport tiles in abr controller, ex: " << ex.what() << std::endl;
+    return static_cast<int32_t>(tile_bitrates.size());
+  }
+}
+
+void OmafAbrController::Reset() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sample_bytes_ = 0;
+  sample_count_ = 0;
+  fast_ewma_bps_ = 0.0;
+  slow_ewma_bps_ = 0.0;
+  harmonic_samples_.clear();
+  buffer_ms_ = -1;
+  last_selected_tiles_ = -1;
+}
+
+void OmafAbrController::flushIdleSample(std::chrono::steady_clock::time_point now) noexcept {
+  if (sample_bytes_ > 0 && now - sample_end_ > SAMPLE_IDLE_GAP) {
+    commitSample();
+  }
+}
+
+void OmafAbrController::commitSample(void) noexcept {
+  auto span = std::chrono::duration_cast<std::chrono::microseconds>(sample_end_ - sample_start_);
+  if (span.count() <= 0) {
+    span = std::chrono::microseconds(1);
+  }
+  double bps = static_cast<double>(sample_bytes_) * 8 * 1000000 / span.count();
+  sample_bytes_ = 0;
+
+  if (sample_count_ == 0) {
+    fast_ewma_bps_ = bps;
+    slow_ewma_bps_ = bps;
+  } else {
+    fast_ewma_bps_ = params_.fast_ewma_alpha_ * bps + (1.0 - params_.fast_ewma_alpha_) * fast_ewma_bps_;
+    slow_ewma_bps_ = params_.slow_ewma_alpha_ * bps + (1.0 - params_.slow_ewma_alpha_) * slow_ewma_bps_;
+  }
+  sample_count_++;
+
+  harmonic_samples_.push_back(bps);
+  while (harmonic_samples_.size() > static_cast<size_t>(std::max(params_.harmonic_window_size_, 1))) {
+    harmonic_samples_.pop_front();
+  }
+}
+
+double OmafAbrController::estimate(void) noexcept {
+  if (sample_count_ == 0) {
+    return 0.0;
+  }
+
+  double inverse_sum = 0.0;
+  for (auto bps : harmonic_samples_) {
+    inverse_sum += 1.0 / bps;
+  }
+  double harmonic = harmonic_samples_.size() / inverse_sum;
+
+  // drops are followed at once by the fast one, rises are trusted only when all agree
+  return std::min(std::min(fast_ewma_bps_, slow_ewma_bps_), harmonic);
+}
+
+double OmafAbrController::bufferFactor(void) noexcept {
+  if (buffer_ms_ < 0 || buffer_ms_ >= params_.target_buffer_ms_) {
+    return 1.0;
+  }
+  if (buffer_ms_ <= params_.min_buffer_ms_ || params_.target_buffer_ms_ <= params_.min_buffer_ms_) {
+    return 0.5;
+  }
+  return 0.5 + 0.5 * static_cast<double>(buffer_ms_ - params_.min_buffer_ms_) /
+                   (params_.target_buffer_ms_ - params_.min_buffer_ms_);
+}
+
+}  // namespace OMAF
+}  // namespace VCD
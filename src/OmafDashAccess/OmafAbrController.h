@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+//!
+//! \file:   OmafAbrController.h
+//! \brief:  throughput based adaptive bitrate controller
+//! \detail: estimate the network throughput from the finished segment transfers,
+//!          and decide how many tiles in viewport can be fetched in high quality
+//!          on top of the low resolution background
+//!
+
+#ifndef OMAFABRCONTROLLER_H
+#define OMAFABRCONTROLLER_H
+
+#include "OmafTypes.h"
+#include "common.h"
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace VCD {
+namespace OMAF {
+
+class OmafAbrController : public VCD::NonCopyable {
+ public:
+  using Ptr = std::shared_ptr<OmafAbrController>;
+
+ public:
+  OmafAbrController(OmafDashAbrParams params = OmafDashAbrParams()) : params_(params){};
+  virtual ~OmafAbrController(){};
+
+ public:
+  //!
+  //! \brief  add a finished transfer. transfers running at the same time share the
+  //!         link, so the overlapped ones are merged into one throughput sample
+  //!
+  //! \param  [in] transfer_bytes
+  //!         the payload size of the transfer
+  //! \param  [in] download_time_us
+  //!         the time spent on the transfer, in microsecond
+  //! \param  [in] end_time
+  //!         the time when the transfer finished
+  //!
+  void AddTransfer(size_t transfer_bytes, long download_time_us,
+                   std::chrono::steady_clock::time_point end_time = std::chrono::steady_clock::now()) noexcept;
+
+  //!
+  //! \brief  update the buffer level, the media duration downloaded and not played yet
+  //!
+  void SetBufferLevel(int64_t buffer_ms) noexcept;
+
+  //!
+  //! \brief  the conservative throughput estimation in bps, the minimum of the fast,
+  //!         slow EWMA and the harmonic mean. 0 means no sample yet
+  //!
+  double GetEstimatedBandwidth() noexcept;
+  double GetFastBandwidth() noexcept;
+  double GetSlowBandwidth() noexcept;
+  double GetHarmonicBandwidth() noexcept;
+
+  //!
+  //! \brief  decide the count of high quality tiles in viewport
+  //!
+  //! \param  [in] tile_bitrates
+  //!         bitrates of the candidate high quality tiles, most important first
+  //! \param  [in] background_bitrate
+  //!         the bitrate of low resolution background, it is always fetched
+  //!
+  //! \return int32_t
+  //!         count of the leading candidates to be fetched in high quality
+  //!
+  int32_t SelectViewportTiles(const std::vector<uint64_t> &tile_bitrates, uint64_t background_bitrate) noexcept;
+
+  void Reset() noexcept;
+
+ private:
+  void flushIdleSample(std::chrono::steady_clock::time_point now) noexcept;
+  void commitSample(void) noexcept;
+  double estimate(void) noexcept;
+  double bufferFactor(void) noexcept;
+
+ private:
+  OmafDashAbrParams params_;
+  std::mutex mutex_;
+
+  //<! pending sample merged from the overlapped transfers
+  size_t sample_bytes_ = 0;
+  std::chrono::steady_clock::time_point sample_start_;
+  std::chrono::steady_clock::time_point sample_end_;
+
+  size_t sample_count_ = 0;
+  double fast_ewma_bps_ = 0.0;
+  double slow_ewma_bps_ = 0.0;
+  std::list<double> harmonic_samples_;
+
+  int64_t buffer_ms_ = -1;
+  int32_t last_selected_tiles_ = -1;
+};
+
+}  // namespace OMAF
+}  // namespace VCD
+
+#endif  // OMAFABRCONTROLLER_H
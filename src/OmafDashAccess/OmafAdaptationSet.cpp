@@ -56,7 +56,9 @@ OmafAdaptationSet::OmafAdaptationSet() {
   m_bMain = false;
   mActiveSegNum = 1;
   mSegNum = 1;
+  mLastRequestedSegNum = 0;
   mReEnable = false;
+  mDownloadPriority = TaskPriority::NORMAL;
   mPF = PF_UNKNOWN;
   mSegmentDuration = 0;
   mTrackNumber = 0;
@@ -352,7 +354,7 @@ int OmafAdaptationSet::DownloadInitializeSegment() {
 
   DashSegmentSourceParams params;
   params.dash_url_ = seg->GenerateCompleteURL(mBaseURL, repID, 0);
-  params.priority_ = TaskPriority::NORMAL;
+  params.priority_ = TaskPriority::FALLBACK;  // all tracks wait for the init segments
   params.timeline_point_ = static_cast<int64_t>(mSegNum);
 
   mInitSegment = std::make_shared<OmafSegment>(params, mSegNum, true);
@@ -391,39 +393,91 @@ int OmafAdaptationSet::DownloadSegment() {
     return ERROR_NULL_PTR;
   }
 
-  SegmentElement* seg = mRepresentation->GetSegment();
+  OmafSegment::Ptr pSegment = CreateSegment(mActiveSegNum, mSegNum, mDownloadPriority);
+
+  // reset the re-enable flag, since it will be updated with different viewport
+  if (mReEnable) mReEnable = false;
+
+  if (pSegment.get() != nullptr) {
+    mLastRequestedSegNum = mSegNum;
+
+    ret = omaf_reader_mgr_->OpenSegment(std::move(pSegment), IsExtractor());
+
+    if (ERROR_NONE != ret) {
+      LOG(ERROR) << "Fail to Download OmafSegment for AdaptationSet:" << this->mID << endl;
+    }
+
+    //  pthread_mutex_lock(&mMutex);
+    // NOTE: won't record segments in adaption set since GetNextSegment() not be
+    // called
+    //       , and this will lead to memory growth.
+    // mSegments.push_back(pSegment);
+    // pthread_mutex_unlock(&mMutex);
+
+    mActiveSegNum++;
+    mSegNum++;
+
+    return ret;
+  } else {
+    LOG(ERROR) << "Create OmafSegment for AdaptationSet: " << this->mID << " Number: " << mActiveSegNum << " failed"
+               << endl;
 
-  if (nullptr == seg) {
-    LOG(ERROR) << "Create Initial SegmentElement for AdaptationSet:" << this->mID << " failed" << endl;
     return ERROR_NULL_PTR;
   }
+}
 
-  auto repID = mRepresentation->GetId();
-#if 0
-  ret = seg->InitDownload(mBaseURL, repID, mActiveSegNum);
+int OmafAdaptationSet::DownloadSubSegment(int64_t start_ms, int64_t index_probe_size) {
+  // only the high quality tile turned into viewport after the latest segment was requested
+  if (!mEnable || IsExtractor() || mDownloadPriority != TaskPriority::HIGH) {
+    return ERROR_NONE;
+  }
+  if (mSegNum <= 1 || mLastRequestedSegNum >= mSegNum - 1) {
+    return ERROR_NONE;
+  }
 
+  if (omaf_reader_mgr_ == nullptr) {
+    LOG(ERROR) << "The omaf reader manager is empty!" << std::endl;
+    return ERROR_NULL_PTR;
+  }
+
+  // the latest segment on the timeline, from the subsegment of the current time
+  OmafSegment::Ptr pSegment = CreateSegment(mActiveSegNum - 1, mSegNum - 1, TaskPriority::HIGH);
+  if (pSegment.get() == nullptr) {
+    LOG(ERROR) << "Create OmafSegment for AdaptationSet: " << this->mID << " Number: " << mActiveSegNum - 1
+               << " failed" << endl;
+    return ERROR_NULL_PTR;
+  }
+  pSegment->SetSubSegmentStart(start_ms, index_probe_size);
+  mLastRequestedSegNum = mSegNum - 1;
+
+  VLOG(VLOG_TRACE) << "Download sub segments from " << start_ms << " ms for AdaptationSet: " << this->mID << endl;
+  int ret = omaf_reader_mgr_->OpenSegment(std::move(pSegment), false);
   if (ERROR_NONE != ret) {
-    SAFE_DELETE(seg);
-    LOG(ERROR) << "Fail to Init OmafSegment Download for AdaptationSet:"
-               << this->mID << endl;
+    LOG(ERROR) << "Fail to Download sub segments for AdaptationSet:" << this->mID << endl;
   }
+  return ret;
+}
 
-  OmafSegment* pSegment = new OmafSegment(seg, mSegNum, false, mReEnable);
-#else
-  DashSegmentSourceParams params;
+OmafSegment::Ptr OmafAdaptationSet::CreateSegment(int activeSegNum, int segNum, TaskPriority priority) {
+  SegmentElement* seg = mRepresentation->GetSegment();
 
-  params.dash_url_ = seg->GenerateCompleteURL(mBaseURL, repID, mActiveSegNum);
-  params.priority_ = TaskPriority::NORMAL;
-  params.timeline_point_ = static_cast<int64_t>(mSegNum);
+  if (nullptr == seg) {
+    LOG(ERROR) << "Create Initial SegmentElement for AdaptationSet:" << this->mID << " failed" << endl;
+    return nullptr;
+  }
 
-  OmafSegment::Ptr pSegment = std::make_shared<OmafSegment>(params, mSegNum, false);
+  if (this->mInitSegment.get() == nullptr) return nullptr;
 
-#endif
-  // reset the re-enable flag, since it will be updated with different viewport
-  if (mReEnable) mReEnable = false;
+  auto repID = mRepresentation->GetId();
+  DashSegmentSourceParams params;
+
+  params.dash_url_ = seg->GenerateCompleteURL(mBaseURL, repID, activeSegNum);
+  params.priority_ = priority;
+  params.timeline_point_ = static_cast<int64_t>(segNum);
+
+  OmafSegment::Ptr pSegment = std::make_shared<OmafSegment>(params, segNum, false);
+  if (pSegment.get() == nullptr) return nullptr;
 
-  if (pSegment.get() != nullptr) {
-  if (this->mInitSegment.get() == nullptr) return ERROR_NULL_PTR;
   pSegment->SetInitSegID(this->mInitSegment->GetInitSegID());
   if (typeid(*this) != typeid(OmafExtractor)) {
     auto qualityRanking = GetRepresentationQualityRanking();
@@ -435,32 +489,30 @@ int OmafAdaptationSet::DownloadSegment() {
     srdInfo.height = mSRD->get_H();
     pSegment->SetSRDInfo(srdInfo);
   }
-  pSegment->SetSegID(mSegNum);
+  pSegment->SetSegID(segNum);
   pSegment->SetTrackId(this->mInitSegment->GetTrackId());
-  ret = omaf_reader_mgr_->OpenSegment(std::move(pSegment), IsExtractor());
 
-  if (ERROR_NONE != ret) {
-    LOG(ERROR) << "Fail to Download OmafSegment for AdaptationSet:" << this->mID << endl;
-  }
-
-  //  pthread_mutex_lock(&mMutex);
-  // NOTE: won't record segments in adaption set since GetNextSegment() not be
-  // called
-  //       , and this will lead to memory growth.
-  // mSegments.push_back(pSegment);
-  // pthread_mutex_unlock(&mMutex);
-
-  mActiveSegNum++;
-  mSegNum++;
+  // only keep the segments still in downloading
+  mOpeningSegments.remove_if([](const std::weak_ptr<OmafSegment>& s) {
+    auto segment = s.lock();
+    return segment.get() == nullptr || segment->GetState() != OmafSegment::State::CREATE;
+  });
+  mOpeningSegments.push_back(pSegment);
 
-  return ret;
-  }
-  else {
-    LOG(ERROR) << "Create OmafSegment for AdaptationSet: " << this->mID << " Number: " << mActiveSegNum << " failed"
-               << endl;
+  return pSegment;
+}
 
-    return ERROR_NULL_PTR;
+void OmafAdaptationSet::CancelOpeningSegments() {
+  for (auto& s : mOpeningSegments) {
+    auto segment = s.lock();
+    if (segment.get() != nullptr && segment->GetState() == OmafSegment::State::CREATE &&
+        segment->GetPriority() != TaskPriority::FALLBACK) {
+      if (ERROR_NONE == segment->Cancel()) {
+        VLOG(VLOG_TRACE) << "Cancel the stale segment " << segment->to_string() << endl;
+      }
+    }
   }
+  mOpeningSegments.clear();
 }
 
 std::string OmafAdaptationSet::GetUrl(const SegmentSyncNode& node) const {
@@ -101,6 +101,14 @@ class OmafAdaptationSet {
   //!
   int DownloadSegment();
 
+  //!
+  //! \brief  Download the latest requested segment from the subsegment at the time,
+  //!         for the tile which turns into viewport after the segment was requested.
+  //! \param  start_ms : media time in the segment to start from
+  //! \param  index_probe_size : size of the segment head holding the segment index
+  //!
+  int DownloadSubSegment(int64_t start_ms, int64_t index_probe_size);
+
   //!
   //! \brief  Select representation from
   //!
@@ -195,6 +203,19 @@ class OmafAdaptationSet {
   };
   bool IsEnabled() { return mEnable; };
 
+  //!
+  //! \brief  Set the download priority of segments, it follows the viewport
+  //!         so that in-view high quality tiles are fetched first
+  //!
+  void SetDownloadPriority(TaskPriority priority) { mDownloadPriority = priority; };
+  TaskPriority GetDownloadPriority() { return mDownloadPriority; };
+
+  //!
+  //! \brief  Cancel the opened segments whose download is not started, it is called
+  //!         when the adaptation set moves out of the viewport
+  //!
+  void CancelOpeningSegments();
+
   virtual OmafAdaptationSet* GetClassType() { return this; };
   TileDef*                   GetTileInfo()                               { return mTileInfo;            };
   virtual bool IsExtractor() { return false; }
@@ -208,6 +229,12 @@ class OmafAdaptationSet {
 
   void ClearSegList();
 
+  //!
+  //! \brief  Create the segment of the selected representation and track it
+  //!         in the opening segments
+  //!
+  OmafSegment::Ptr CreateSegment(int activeSegNum, int segNum, TaskPriority priority);
+
   friend class RepresentationSelector;
 
  protected:
@@ -234,6 +261,7 @@ class OmafAdaptationSet {
                                      //<! mpd which is used to get first segment for downloading
   int mActiveSegNum;                 //<! the segment are being processed
   int mSegNum;                       //<! the segment count
+  int mLastRequestedSegNum;          //<! the latest segment count requested for download
   bool m_bMain;                      //<! whether this AdaptationSet is Main or not. each stream
                                      //<! has one main AdaptationSet
 
@@ -250,6 +278,8 @@ class OmafAdaptationSet {
   bool mEnable;                     //<! is Adaptation Set enabled
   bool mReEnable;                   //<! flag for Adaption Set is re-enabled
   std::list<bool> mEnableRecord;    //<! record the last 3 enable changes
+  TaskPriority mDownloadPriority;   //<! priority for segment download
+  std::list<std::weak_ptr<OmafSegment>> mOpeningSegments;  //<! segments opened but not downloaded
 
   std::shared_ptr<OmafReaderManager> omaf_reader_mgr_;
 };
@@ -60,6 +60,11 @@ typedef struct _omafHttpParams {
   int32_t retry_times;
   int ssl_verify_peer;
   int ssl_verify_host;
+  int http_version;             // 0: default, 1: HTTP/1.1, 2: HTTP/2 over TLS, 3: HTTP/2 with prior knowledge
+  int disable_multiplex;        // segment transfers to one origin are multiplexed over HTTP/2 unless set
+  long max_host_connections;    // <= 0 for not set
+  long max_concurrent_streams;  // <= 0 for not set
+  int32_t warmup_connections;   // connections opened to the origin during OpenMedia, 0 for disable
 } OmafHttpParams;
 
 typedef struct _omafStatisticsParams {
@@ -76,8 +81,29 @@ typedef struct _omafPredictorParams {
   char* name;
   char* libpath;
   int enable;
+  float min_view_probability;  // predicted tiles less likely to be viewed are not fetched, <= 0 for default
 } OmafPredictorParams;
 
+typedef struct _omafAbrParams {
+  int32_t target_buffer_ms;       // buffer level to spend the whole bandwidth estimation, <= 0 for default
+  int32_t min_viewport_hq_tiles;  // high quality tiles always kept in viewport, < 0 for default
+  int enable;
+} OmafAbrParams;
+
+typedef struct _omafCacheParams {
+  int64_t memory_budget;  // bytes of segments kept in memory, <= 0 for default
+  int64_t spill_budget;   // bytes of the spill file in cache path, <= 0 for default
+  int enable_spill;       // evicted segments go to a single file in cache path
+  int enable;
+  int enable_init_cache;  // init segments are kept in cache path between sessions, revalidated by etag
+} OmafCacheParams;
+
+typedef struct _omafSubSegmentParams {
+  int64_t index_probe_size;   // bytes of the segment head holding the sidx, <= 0 for default
+  int32_t check_interval_ms;  // viewport check interval between segment requests, <= 0 for default
+  int enable;                 // tiles turned into viewport start from the next subsegment
+} OmafSubSegmentParams;
+
 typedef struct _omafDashParams {
   OmafHttpProxy proxy;
   OmafHttpParams http_params;
@@ -86,6 +112,9 @@ typedef struct _omafDashParams {
   OmafPredictorParams predictor_params;
   long max_parallel_transfers;
   int segment_open_timeout_ms;
+  OmafAbrParams abr_params;
+  OmafCacheParams cache_params;
+  OmafSubSegmentParams sub_segment_params;
 } OmafParams;
 
 /*
@@ -130,6 +159,26 @@ Handler OmafAccess_Init(DashStreamingClient* pCtx);
 int OmafAccess_OpenMedia(Handler hdl, DashStreamingClient* pCtx, bool enablePredictor, char* predictPluginName,
                          char* libPath);
 
+/*
+ * description: API to switch the opened dash stream to another one in the same session, the http
+ *              connections, download workers, caches and compatible tiles stitching handles are kept,
+ *              and the low resolution tracks of the new stream are requested first
+ *              it can be called from another thread than the player one. it waits for the running
+ *              OmafAccess_GetPacket, OmafAccess_ChangeViewport, OmafAccess_GetMediaInfo and the
+ *              predict plugin calls, and the ones made until it returns are rejected, GetPacket
+ *              with ERROR_NULL_PACKET and the others with ERROR_INVALID. the packets gotten before
+ *              stay valid. the other calls on the handle must not be made during the switch
+ * params: hdl - [in] handler created with DashStreaming_Init
+ *         pCtx - [in] the structure with the media url of the new stream, the omaf params
+ *                of the session are kept
+ *         enablePredictor - [in] flag for use predictor or not
+ *         predictPluginName - [in] name of predict plugin
+ *         libPath - [in] plugin library path
+ * return: the error return from the API
+ */
+int OmafAccess_SwitchMedia(Handler hdl, DashStreamingClient* pCtx, bool enablePredictor, char* predictPluginName,
+                           char* libPath);
+
 /*
  * description: API to seek a stream. only work with static mode. not implement yet.
  * params: hdl - [in] handler created with DashStreaming_Init
@@ -164,12 +213,22 @@ int OmafAccess_GetMediaInfo(Handler hdl, DashMediaInfo* info);
  *         pts  - [out] the timestamp of the packet
  *         needParams - [bool] flag to include VPS/SPS/PPS in packet
  *         clearBuf - [bool] flag to clear output packet buffer
+ *         the rwpk of the packet is shared and read only, the caller releases it through
+ *         rwpkRef with SharedRwpk::ReleaseHandle, or OmafAccess_ReleaseRwpk from C, instead
+ *         of freeing rwpk
  * return: the error return from the API, ERROR_EOS means reach end of
  *         stream for static source
  */
 int OmafAccess_GetPacket(Handler hdl, int stream_id, DashPacket* packet, int* size, uint64_t* pts, bool needParams,
                          bool clearBuf);
 
+/*
+ * description: API to release the shared rwpk of a packet gotten with OmafAccess_GetPacket
+ * params: packet - [in/out] the packet, its rwpk and rwpkRef are reset
+ * return: the error return from the API
+ */
+int OmafAccess_ReleaseRwpk(DashPacket* packet);
+
 /*
  * description: API to set InitViewport before downloading segment.
  * params: hdl - [in]handler created with DashStreaming_Init
@@ -194,6 +253,52 @@ int OmafAccess_ChangeViewport(Handler hdl, HeadPose* pose);
  */
 int OmafAccess_Statistic(Handler hdl, DashStatisticInfo* info);
 
+/*
+ * description: API to swap the viewport prediction plugin without reopening the media,
+ *              the new plugin takes effect from the next segment
+ * params: hdl - [in] handler created with DashStreaming_Init
+ *         predictPluginName - [in] name of the new predict plugin
+ *         libPath - [in] the new plugin library path
+ * return: the error return from the API
+ */
+int OmafAccess_SwapPredictPlugin(Handler hdl, char* predictPluginName, char* libPath);
+
+/*
+ * description: API to get the timing counters of the viewport prediction plugin in use
+ * params: hdl - [in] handler created with DashStreaming_Init
+ *         stats - [out] the timing counters
+ * return: the error return from the API
+ */
+int OmafAccess_GetPredictPluginStats(Handler hdl, PluginTimingStats* stats);
+
+/*
+ * description: API to get the timing counters of the download, parse, select and stitch stages
+ * params: hdl - [in] handler created with DashStreaming_Init
+ *         timings - [out] the timing counters of each stage
+ * return: the error return from the API
+ */
+int OmafAccess_GetStageTimings(Handler hdl, DashStageTimings* timings);
+
+/*
+ * description: API to get the snapshot of the metrics, e.g. latency histograms of each
+ * stage, counters of bytes and packets, and gauges of queue depths
+ * params: hdl - [in] handler created with DashStreaming_Init
+ *         values - [out] the metrics, NULL to query the count of metrics
+ *         count - [in/out] capacity of values as input, count of metrics as output
+ * return: the error return from the API
+ */
+int OmafAccess_GetMetrics(Handler hdl, MetricValue* values, int32_t* count);
+
+/*
+ * description: API to dump the metrics in Prometheus text format, names are prefixed
+ * with omaf_access_
+ * params: hdl - [in] handler created with DashStreaming_Init
+ *         buf - [out] the text with the terminating '\0', NULL to query the size
+ *         size - [in/out] size of buf as input, size needed as output
+ * return: the error return from the API, ERROR_INVALID when buf is too small
+ */
+int OmafAccess_DumpMetrics(Handler hdl, char* buf, uint32_t* size);
+
 /*
  * description: API to Close the Handle and release relative resources after dealing with
  * the media
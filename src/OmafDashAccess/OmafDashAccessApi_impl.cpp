@@ -84,6 +84,24 @@ Handler OmafAccess_Init(DashStreamingClient *pCtx) {
 
   omaf_dash_params.http_params_.bssl_verify_host_ = omaf_params.http_params.ssl_verify_host == 0 ? false : true;
 
+  if (omaf_params.http_params.http_version > 0 &&
+      omaf_params.http_params.http_version <= static_cast<int>(VCD::OMAF::HttpVersion::HTTP2_PRIOR)) {
+    omaf_dash_params.http_params_.http_version_ =
+        static_cast<VCD::OMAF::HttpVersion>(omaf_params.http_params.http_version);
+  }
+
+  omaf_dash_params.http_params_.bmultiplex_ = omaf_params.http_params.disable_multiplex == 0 ? true : false;
+
+  if (omaf_params.http_params.max_host_connections > 0) {
+    omaf_dash_params.http_params_.max_host_connections_ = omaf_params.http_params.max_host_connections;
+  }
+  if (omaf_params.http_params.max_concurrent_streams > 0) {
+    omaf_dash_params.http_params_.max_concurrent_streams_ = omaf_params.http_params.max_concurrent_streams;
+  }
+  if (omaf_params.http_params.warmup_connections > 0) {
+    omaf_dash_params.http_params_.warmup_connections_ = omaf_params.http_params.warmup_connections;
+  }
+
   omaf_dash_params.prediector_params_.enable_ = omaf_params.predictor_params.enable == 0 ? false : true;
 
   if (omaf_params.predictor_params.name) {
@@ -92,6 +110,9 @@ Handler OmafAccess_Init(DashStreamingClient *pCtx) {
   if (omaf_params.predictor_params.libpath) {
     omaf_dash_params.prediector_params_.libpath_ = std::string(omaf_params.predictor_params.libpath);
   }
+  if (omaf_params.predictor_params.min_view_probability > 0) {
+    omaf_dash_params.prediector_params_.min_view_probability_ = omaf_params.predictor_params.min_view_probability;
+  }
 
   omaf_dash_params.stats_params_.enable_ = omaf_params.statistic_params.enable == 0 ? false : true;
   if (omaf_dash_params.stats_params_.enable_) {
@@ -111,6 +132,31 @@ Handler OmafAccess_Init(DashStreamingClient *pCtx) {
     omaf_dash_params.segment_open_timeout_ms_ = omaf_params.segment_open_timeout_ms;
   }
 
+  omaf_dash_params.abr_params_.enable_ = omaf_params.abr_params.enable == 0 ? false : true;
+  if (omaf_params.abr_params.target_buffer_ms > 0) {
+    omaf_dash_params.abr_params_.target_buffer_ms_ = omaf_params.abr_params.target_buffer_ms;
+  }
+  if (omaf_params.abr_params.min_viewport_hq_tiles >= 0) {
+    omaf_dash_params.abr_params_.min_viewport_hq_tiles_ = omaf_params.abr_params.min_viewport_hq_tiles;
+  }
+
+  omaf_dash_params.cache_params_.enable_ = omaf_params.cache_params.enable == 0 ? false : true;
+  omaf_dash_params.cache_params_.enable_spill_ = omaf_params.cache_params.enable_spill == 0 ? false : true;
+  if (omaf_params.cache_params.memory_budget > 0) {
+    omaf_dash_params.cache_params_.memory_budget_ = omaf_params.cache_params.memory_budget;
+  }
+  if (omaf_params.cache_params.spill_budget > 0) {
+    omaf_dash_params.cache_params_.spill_budget_ = omaf_params.cache_params.spill_budget;
+  }
+  omaf_dash_params.cache_params_.enable_init_cache_ = omaf_params.cache_params.enable_init_cache == 0 ? false : true;
+  omaf_dash_params.sub_segment_params_.enable_ = omaf_params.sub_segment_params.enable == 0 ? false : true;
+  if (omaf_params.sub_segment_params.index_probe_size > 0) {
+    omaf_dash_params.sub_segment_params_.index_probe_size_ = omaf_params.sub_segment_params.index_probe_size;
+  }
+  if (omaf_params.sub_segment_params.check_interval_ms > 0) {
+    omaf_dash_params.sub_segment_params_.check_interval_ms_ = omaf_params.sub_segment_params.check_interval_ms;
+  }
+
   LOG(INFO) << omaf_dash_params.to_string() << std::endl;
   pSource->SetOmafDashParams(omaf_dash_params);
 
@@ -129,6 +175,17 @@ int OmafAccess_OpenMedia(Handler hdl, DashStreamingClient *pCtx, bool enablePred
                             predictPluginName, libPath);
 }
 
+int OmafAccess_SwitchMedia(Handler hdl, DashStreamingClient *pCtx, bool enablePredictor, char *predictPluginName,
+                           char *libPath) {
+  if (hdl == nullptr || pCtx == nullptr) {
+    return ERROR_INVALID;
+  }
+  OmafMediaSource *pSource = (OmafMediaSource *)hdl;
+
+  return pSource->SwitchMedia(pCtx->media_url, pCtx->cache_path, pCtx->enable_extractor, enablePredictor,
+                              predictPluginName, libPath);
+}
+
 int OmafAccess_CloseMedia(Handler hdl) {
   OmafMediaSource *pSource = (OmafMediaSource *)hdl;
 
@@ -143,8 +200,7 @@ int OmafAccess_SeekMedia(Handler hdl, uint64_t time) {
 
 int OmafAccess_GetMediaInfo(Handler hdl, DashMediaInfo *info) {
   OmafMediaSource *pSource = (OmafMediaSource *)hdl;
-  pSource->GetMediaInfo(info);
-  return ERROR_NONE;
+  return pSource->GetMediaInfo(info);
 }
 
 int OmafAccess_GetPacket(Handler hdl, int stream_id, DashPacket *packet, int *size, uint64_t *pts, bool needParams,
@@ -170,16 +226,14 @@ int OmafAccess_GetPacket(Handler hdl, int stream_id, DashPacket *packet, int *si
       // int outSize = pPkt->Size();
       // char *buf = (char *)malloc(outSize * sizeof(char));
       // memcpy_s(buf, pPkt->Payload(), outSize);
-      RegionWisePacking *newRwpk = new RegionWisePacking;
-      const RegionWisePacking &pRwpk = pPkt->GetRwpk();
-      *newRwpk = pRwpk;
-      newRwpk->rectRegionPacking = new RectangularRegionWisePacking[newRwpk->numRegions];
-      memcpy_s(newRwpk->rectRegionPacking, pRwpk.numRegions * sizeof(RectangularRegionWisePacking),
-               pRwpk.rectRegionPacking, pRwpk.numRegions * sizeof(RectangularRegionWisePacking));
+      // the rwpk is shared with the caller, not copied
+      VCD::VRVideo::SharedRwpk::Ptr sharedRwpk = pPkt->GetSharedRwpk();
       SourceResolution *srcRes = new SourceResolution[pPkt->GetQualityNum()];
       memcpy_s(srcRes, pPkt->GetQualityNum() * sizeof(SourceResolution), pPkt->GetSourceResolutions(),
                pPkt->GetQualityNum() * sizeof(SourceResolution));
-      packet[i].rwpk = newRwpk;
+      packet[i].rwpk = sharedRwpk ? const_cast<RegionWisePacking *>(sharedRwpk->Get()) : nullptr;
+      packet[i].rwpkRef = sharedRwpk ? VCD::VRVideo::SharedRwpk::ToHandle(sharedRwpk) : nullptr;
+      packet[i].rwpkVersion = sharedRwpk ? sharedRwpk->Version() : 0;
       packet[i].buf = pPkt->MovePayload();
       packet[i].size = pPkt->Size();
       packet[i].segID = pPkt->GetSegID();
@@ -195,6 +249,9 @@ int OmafAccess_GetPacket(Handler hdl, int stream_id, DashPacket *packet, int *si
       packet[i].bEOS = pPkt->GetEOS();
     } else {
       packet[i].bEOS = true;
+      packet[i].rwpk = nullptr;
+      packet[i].rwpkRef = nullptr;
+      packet[i].rwpkVersion = 0;
     }
 
     i++;
@@ -206,6 +263,16 @@ int OmafAccess_GetPacket(Handler hdl, int stream_id, DashPacket *packet, int *si
   return ERROR_NONE;
 }
 
+int OmafAccess_ReleaseRwpk(DashPacket *packet) {
+  if (NULL == packet) return ERROR_NULL_PTR;
+
+  VCD::VRVideo::SharedRwpk::ReleaseHandle(packet->rwpkRef);
+  packet->rwpkRef = NULL;
+  packet->rwpk = NULL;
+  packet->rwpkVersion = 0;
+  return ERROR_NONE;
+}
+
 int OmafAccess_SetupHeadSetInfo(Handler hdl, HeadSetInfo *clientInfo) {
   OmafMediaSource *pSource = (OmafMediaSource *)hdl;
 
@@ -224,6 +291,63 @@ int OmafAccess_Statistic(Handler hdl, DashStatisticInfo *info) {
   return pSource->GetStatistic(info);
 }
 
+int OmafAccess_SwapPredictPlugin(Handler hdl, char *predictPluginName, char *libPath) {
+  if (hdl == nullptr || predictPluginName == nullptr || libPath == nullptr) {
+    return ERROR_INVALID;
+  }
+  OmafMediaSource *pSource = (OmafMediaSource *)hdl;
+
+  return pSource->SwapPredictPlugin(predictPluginName, libPath);
+}
+
+int OmafAccess_GetPredictPluginStats(Handler hdl, PluginTimingStats *stats) {
+  if (hdl == nullptr || stats == nullptr) {
+    return ERROR_INVALID;
+  }
+  OmafMediaSource *pSource = (OmafMediaSource *)hdl;
+
+  return pSource->GetPredictPluginStats(stats);
+}
+
+int OmafAccess_GetStageTimings(Handler hdl, DashStageTimings *timings) {
+  if (hdl == nullptr || timings == nullptr) {
+    return ERROR_INVALID;
+  }
+  OmafMediaSource *pSource = (OmafMediaSource *)hdl;
+
+  return pSource->GetStageTimings(timings);
+}
+
+int OmafAccess_GetMetrics(Handler hdl, MetricValue *values, int32_t *count) {
+  if (hdl == nullptr || count == nullptr) {
+    return ERROR_INVALID;
+  }
+  OmafMediaSource *pSource = (OmafMediaSource *)hdl;
+
+  return pSource->GetMetrics(values, count);
+}
+
+int OmafAccess_DumpMetrics(Handler hdl, char *buf, uint32_t *size) {
+  if (hdl == nullptr || size == nullptr) {
+    return ERROR_INVALID;
+  }
+  OmafMediaSource *pSource = (OmafMediaSource *)hdl;
+
+  std::string text = pSource->DumpMetrics("omaf_access_");
+  uint32_t needed = static_cast<uint32_t>(text.size() + 1);
+  if (buf == nullptr) {
+    *size = needed;
+    return ERROR_NONE;
+  }
+  if (*size < needed) {
+    *size = needed;
+    return ERROR_INVALID;
+  }
+  memcpy_s(buf, *size, text.c_str(), needed);
+  *size = needed;
+  return ERROR_NONE;
+}
+
 int OmafAccess_Close(Handler hdl) {
   OmafMediaSource *pSource = (OmafMediaSource *)hdl;
   delete pSource;
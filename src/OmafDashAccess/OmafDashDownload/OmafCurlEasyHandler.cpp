@@ -31,6 +31,7 @@
 //!
 #include "OmafCurlEasyHandler.h"
 
+#include <strings.h>  // strncasecmp
 #include <sstream>
 
 #include "../../utils/GlogWrapper.h"  // GLOG
@@ -102,6 +103,34 @@ OMAF_STATUS OmafCurlEasyHelper::setParams(CURL *easy_curl, CurlParams params) no
       curl_easy_setopt(easy_curl, CURLOPT_TIMEOUT_MS, params.http_params_.total_timeout_);
     }
 
+    switch (params.http_params_.http_version_) {
+      case HttpVersion::HTTP1_1:
+        curl_easy_setopt(easy_curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+        break;
+#if LIBCURL_VERSION_NUM >= 0x072F00
+      case HttpVersion::HTTP2_TLS:
+        curl_easy_setopt(easy_curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        break;
+#endif
+#if LIBCURL_VERSION_NUM >= 0x073100
+      case HttpVersion::HTTP2_PRIOR:
+        curl_easy_setopt(easy_curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE);
+        break;
+#endif
+      default:
+        break;
+    }
+
+#if LIBCURL_VERSION_NUM >= 0x072B00
+    // wait for a connection that can be multiplexed instead of opening a new one
+    if (params.http_params_.bmultiplex_) {
+      curl_easy_setopt(easy_curl, CURLOPT_PIPEWAIT, 1L);
+    }
+#endif
+    if (params.http_params_.btcp_keepalive_) {
+      curl_easy_setopt(easy_curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    }
+
     if (!params.http_proxy_.http_proxy_.empty()) {
       curl_easy_setopt(easy_curl, CURLOPT_PROXY, params.http_proxy_.http_proxy_.c_str());
       curl_easy_setopt(easy_curl, CURLOPT_PROXYTYPE, CURLPROXY_HTTP);
@@ -126,6 +155,21 @@ OMAF_STATUS OmafCurlEasyHelper::setParams(CURL *easy_curl, CurlParams params) no
   }
 }
 
+long OmafCurlEasyHelper::streamWeight(TaskPriority priority) noexcept {
+  // HTTP/2 stream weight is in range [1, 256], and libcurl uses 16 by default
+  switch (priority) {
+    case TaskPriority::FALLBACK:
+      return 256;
+    case TaskPriority::HIGH:
+      return 128;
+    case TaskPriority::NORMAL:
+      return 64;
+    case TaskPriority::LOW:
+    default:
+      return 16;
+  }
+}
+
 inline long OmafCurlEasyHelper::namelookupTime(CURL *easy_curl) noexcept {
   curl_off_t timev = 0;
   curl_easy_getinfo(easy_curl, CURLINFO_NAMELOOKUP_TIME_T, &timev);
@@ -211,6 +255,11 @@ OMAF_STATUS OmafCurlEasyDownloader::open(const std::string &url) noexcept {
     }
 
     curl_easy_reset(easy_curl_);
+    if (request_headers_) {
+      curl_slist_free_all(request_headers_);
+      request_headers_ = nullptr;
+    }
+    etag_.clear();
     OMAF_STATUS ret = OmafCurlEasyHelper::setParams(easy_curl_, curl_params_);
     if (ERROR_NONE != ret) {
       LOG(ERROR) << "Failed to set params for easy curl handler!" << std::endl;
@@ -221,6 +270,8 @@ OMAF_STATUS OmafCurlEasyDownloader::open(const std::string &url) noexcept {
     curl_easy_setopt(easy_curl_, CURLOPT_PRIVATE, url.c_str());
     curl_easy_setopt(easy_curl_, CURLOPT_WRITEFUNCTION, curlBodyCallback);
     curl_easy_setopt(easy_curl_, CURLOPT_WRITEDATA, (void *)this);
+    curl_easy_setopt(easy_curl_, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
+    curl_easy_setopt(easy_curl_, CURLOPT_HEADERDATA, (void *)this);
 
     return ERROR_NONE;
   } catch (const std::exception &ex) {
@@ -229,17 +280,72 @@ OMAF_STATUS OmafCurlEasyDownloader::open(const std::string &url) noexcept {
   }
 }
 
+OMAF_STATUS OmafCurlEasyDownloader::priority(TaskPriority priority) noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(easy_curl_mutex_);
+    if (easy_curl_ == nullptr) {
+      LOG(ERROR) << "curl easy handler is invalid!" << std::endl;
+      return ERROR_NULL_PTR;
+    }
+#if LIBCURL_VERSION_NUM >= 0x072E00
+    curl_easy_setopt(easy_curl_, CURLOPT_STREAM_WEIGHT, OmafCurlEasyHelper::streamWeight(priority));
+#else
+    UNUSED(priority);
+#endif
+    return ERROR_NONE;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when set priority for curl easy hanlder, ex: " << ex.what() << std::endl;
+    return ERROR_INVALID;
+  }
+}
+
+OMAF_STATUS OmafCurlEasyDownloader::nobody() noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(easy_curl_mutex_);
+    if (easy_curl_ == nullptr) {
+      LOG(ERROR) << "curl easy handler is invalid!" << std::endl;
+      return ERROR_NULL_PTR;
+    }
+    curl_easy_setopt(easy_curl_, CURLOPT_NOBODY, 1L);
+    return ERROR_NONE;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when set nobody for curl easy hanlder, ex: " << ex.what() << std::endl;
+    return ERROR_INVALID;
+  }
+}
+
+OMAF_STATUS OmafCurlEasyDownloader::ifNoneMatch(const std::string &etag) noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(easy_curl_mutex_);
+    if (easy_curl_ == nullptr) {
+      LOG(ERROR) << "curl easy handler is invalid!" << std::endl;
+      return ERROR_NULL_PTR;
+    }
+    std::string line = "If-None-Match: " + etag;
+    struct curl_slist *headers = curl_slist_append(request_headers_, line.c_str());
+    if (headers == nullptr) {
+      LOG(ERROR) << "Failed to append the request header!" << std::endl;
+      return ERROR_INVALID;
+    }
+    request_headers_ = headers;
+    curl_easy_setopt(easy_curl_, CURLOPT_HTTPHEADER, request_headers_);
+    return ERROR_NONE;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when set if-none-match for curl easy hanlder, ex: " << ex.what() << std::endl;
+    return ERROR_INVALID;
+  }
+}
+
 OMAF_STATUS OmafCurlEasyDownloader::start(int64_t offset, int64_t size, onData dcb, onState scb) noexcept {
   try {
     std::lock_guard<std::mutex> lock(easy_curl_mutex_);
     if (offset > 0 || size > 0) {
+      // the range is [first-last], both inclusive, an empty last means to the end
       std::stringstream ss;
-      if (offset > 0) {
-        ss << offset;
-      }
-      ss << "-";
+      int64_t first = offset > 0 ? offset : 0;
+      ss << first << "-";
       if (size > 0) {
-        ss << size;
+        ss << first + size - 1;
       }
       LOG(INFO) << "To download the range: " << ss.str() << std::endl;
       curl_easy_setopt(easy_curl_, CURLOPT_RANGE, ss.str().c_str());
@@ -292,6 +398,10 @@ OMAF_STATUS OmafCurlEasyDownloader::close() noexcept {
       curl_easy_cleanup(easy_curl_);
       easy_curl_ = nullptr;
     }
+    if (request_headers_) {
+      curl_slist_free_all(request_headers_);
+      request_headers_ = nullptr;
+    }
     return ERROR_NONE;
   } catch (const std::exception &ex) {
     LOG(ERROR) << "Exception when close curl easy hanlder, ex: " << ex.what() << std::endl;
@@ -302,7 +412,9 @@ OMAF_STATUS OmafCurlEasyDownloader::close() noexcept {
 HttpHeader OmafCurlEasyDownloader::header() noexcept {
   try {
     std::lock_guard<std::mutex> lock(easy_curl_mutex_);
-    return OmafCurlEasyHelper::header(this->easy_curl_);
+    HttpHeader header = OmafCurlEasyHelper::header(this->easy_curl_);
+    header.etag_ = etag_;
+    return header;
   } catch (const std::exception &ex) {
     LOG(ERROR) << "Exception when read header, ex: " << ex.what() << std::endl;
     return HttpHeader();
@@ -363,6 +475,32 @@ size_t OmafCurlEasyDownloader::curlBodyCallback(char *ptr, size_t size, size_t n
     return bsize;
   }
 }
+
+size_t OmafCurlEasyDownloader::curlHeaderCallback(char *ptr, size_t size, size_t nitems, void *userdata) noexcept {
+  size_t bsize = size * nitems;
+
+  try {
+    OmafCurlEasyDownloader *phandler = reinterpret_cast<OmafCurlEasyDownloader *>(userdata);
+    if (ptr == nullptr || phandler == nullptr) {
+      return bsize;
+    }
+    // each call is one whole header line, the name is case-insensitive
+    const std::string name = "etag:";
+    if (bsize <= name.size() || strncasecmp(ptr, name.c_str(), name.size()) != 0) {
+      return bsize;
+    }
+    size_t begin = name.size();
+    size_t end = bsize;
+    while (begin < end && (ptr[begin] == ' ' || ptr[begin] == '\t')) begin++;
+    while (end > begin && (ptr[end - 1] == '\r' || ptr[end - 1] == '\n' || ptr[end - 1] == ' ')) end--;
+    phandler->etag_.assign(ptr + begin, end - begin);
+    return bsize;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when receive header from curl easy hanlder, ex: " << ex.what() << std::endl;
+    return bsize;
+  }
+}
+
 OmafCurlEasyDownloaderPool::~OmafCurlEasyDownloaderPool() {
   try {
     std::lock_guard<std::mutex> lock(easy_downloader_pool_mutex_);
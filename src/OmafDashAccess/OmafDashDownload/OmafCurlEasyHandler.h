@@ -67,6 +67,7 @@ using CurlParams = struct _curlParams;
 struct _httpHeader {
   long http_status_code_ = -1;
   int64_t content_length_ = -1;
+  std::string etag_;
 };
 
 using HttpHeader = struct _httpHeader;
@@ -95,9 +96,11 @@ class OmafCurlEasyHelper : public NonCopyable {
   static HttpHeader header(CURL *easy_curl) noexcept;
   static double speed(CURL *easy_curl) noexcept;
   static OMAF_STATUS setParams(CURL *easy_curl, CurlParams parmas) noexcept;
+  static long streamWeight(TaskPriority priority) noexcept;
   static bool success(const long http_status_code_) noexcept {
     return http_status_code_ >= 200 && http_status_code_ < 300;
   }
+  static bool notModified(const long http_status_code_) noexcept { return http_status_code_ == 304; }
   static long namelookupTime(CURL *easy_curl) noexcept;
   static long connectTime(CURL *easy_curl) noexcept;
   static long appConnectTime(CURL *easy_curl) noexcept;
@@ -143,6 +146,13 @@ class OmafCurlEasyDownloader : public VCD::NonCopyable {
  public:
   OMAF_STATUS init(const CurlParams &params) noexcept;
   OMAF_STATUS open(const std::string &url) noexcept;
+  OMAF_STATUS priority(TaskPriority priority) noexcept;
+  OMAF_STATUS nobody() noexcept;
+  //!
+  //! \brief  make the request conditional, the origin answers 304 without body
+  //!         when the resource still has the etag
+  //!
+  OMAF_STATUS ifNoneMatch(const std::string &etag) noexcept;
   OMAF_STATUS start(int64_t offset, int64_t size, onData scb, onState fcb) noexcept;
   OMAF_STATUS stop() noexcept;
   OMAF_STATUS close() noexcept;
@@ -151,6 +161,7 @@ class OmafCurlEasyDownloader : public VCD::NonCopyable {
 
  public:
   static size_t curlBodyCallback(char *ptr, size_t size, size_t nmemb, void *userdata) noexcept;
+  static size_t curlHeaderCallback(char *ptr, size_t size, size_t nitems, void *userdata) noexcept;
 
  public:
   inline CURL *handler() noexcept {
@@ -180,6 +191,9 @@ class OmafCurlEasyDownloader : public VCD::NonCopyable {
   CurlParams curl_params_;
   std::mutex easy_curl_mutex_;
   CURL *easy_curl_ = nullptr;
+  struct curl_slist *request_headers_ = nullptr;
+  //<! etag of the response, it is written by the header callback in the transfer thread
+  std::string etag_;
   std::string url_;
   std::mutex cb_mutex_;
   onData dcb_ = nullptr;
@@ -32,6 +32,8 @@
 
 #include "OmafCurlMultiHandler.h"
 
+#include <algorithm>
+
 namespace VCD {
 namespace OMAF {
 
@@ -53,6 +55,24 @@ OMAF_STATUS OmafCurlMultiDownloader::init(const CurlParams& p, OmafDownloadTask:
     LOG(INFO) << "Set max transfer to " << max_parallel_ << std::endl;
     curl_multi_setopt(curl_multi_, CURLMOPT_MAXCONNECTS, max_parallel_ << 1);
 
+    // tile segments are small requests to one origin, so reuse the connection
+    // and multiplex the transfers over it when the server speaks HTTP/2
+    const OmafDashHttpParams& http_params = curl_params_.http_params_;
+    curl_multi_setopt(curl_multi_, CURLMOPT_PIPELINING,
+                      http_params.bmultiplex_ ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+    if (http_params.max_host_connections_ > 0) {
+      curl_multi_setopt(curl_multi_, CURLMOPT_MAX_HOST_CONNECTIONS, http_params.max_host_connections_);
+    }
+#if LIBCURL_VERSION_NUM >= 0x074300
+    if (http_params.max_concurrent_streams_ > 0) {
+      curl_multi_setopt(curl_multi_, CURLMOPT_MAX_CONCURRENT_STREAMS, http_params.max_concurrent_streams_);
+    }
+#else
+    if (http_params.max_concurrent_streams_ > 0) {
+      LOG(WARNING) << "Max concurrent streams is not supported by this libcurl version!" << std::endl;
+    }
+#endif
+
     // 3. create the easy downloader pool
     downloader_pool_ = std::move(make_unique_vcd<OmafCurlEasyDownloaderPool>(max_parallel_ << 1));
     if (downloader_pool_ == NULL) {
@@ -121,7 +141,8 @@ OMAF_STATUS OmafCurlMultiDownloader::removeTask(OmafDownloadTask::Ptr task) noex
       return ERROR_INVALID;
     }
 
-    // FIXME, the task state may change when processing, skip this issue now
+    // the worker doesn't move the task between the lists meanwhile
+    std::lock_guard<std::recursive_mutex> lock(worker_mutex_);
     if (task->state() == OmafDownloadTask::State::READY) {
       removeReadyTask(task);
     }
@@ -137,6 +158,34 @@ OMAF_STATUS OmafCurlMultiDownloader::removeTask(OmafDownloadTask::Ptr task) noex
   }
 }
 
+OMAF_STATUS OmafCurlMultiDownloader::cancelTask(OmafDownloadTask::Ptr task) noexcept {
+  try {
+    if (task.get() == nullptr) {
+      LOG(ERROR) << "Try to cancel empty task!" << std::endl;
+      return ERROR_INVALID;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(ready_task_list_mutex_);
+      auto it = std::find(ready_task_list_.begin(), ready_task_list_.end(), task);
+      if (it == ready_task_list_.end()) {
+        return ERROR_NOT_FOUND;
+      }
+      ready_task_list_.erase(it);
+      task->state(OmafDownloadTask::State::STOPPED);
+    }
+    task_size_.fetch_sub(1);
+    return ERROR_NONE;
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Exception when cancel task, ex: " << ex.what() << std::endl;
+    return ERROR_INVALID;
+  }
+}
+
+void OmafCurlMultiDownloader::quiesce() noexcept {
+  std::lock_guard<std::recursive_mutex> lock(worker_mutex_);
+}
+
 OMAF_STATUS OmafCurlMultiDownloader::createTransfer(OmafDownloadTask::Ptr task) noexcept {
   try {
     if (task.get() == nullptr || downloader_pool_.get() == nullptr) {
@@ -157,6 +206,15 @@ OMAF_STATUS OmafCurlMultiDownloader::createTransfer(OmafDownloadTask::Ptr task)
       return ret;
     }
 
+    // stream weight takes effect only when the transfer is multiplexed over HTTP/2
+    downloader->priority(task->priority());
+    if (task->warmup()) {
+      downloader->nobody();
+    }
+    if (task->ifNoneMatch().size()) {
+      downloader->ifNoneMatch(task->ifNoneMatch());
+    }
+
     task->easy_downloader_ = std::move(downloader);
     return ERROR_NONE;
   } catch (const std::exception& ex) {
@@ -179,14 +237,19 @@ OMAF_STATUS OmafCurlMultiDownloader::startTransfer(OmafDownloadTask::Ptr task) n
     }
 
     OMAF_STATUS ret = ERROR_NONE;
-    auto offset = task->streamSize();
+    // resume from the received data of the range when retried
+    int64_t offset = (task->rangeOffset() > 0 ? task->rangeOffset() : 0) + task->streamSize();
+    int64_t size = task->rangeSize() > 0 ? task->rangeSize() - task->streamSize() : -1;
     // multi hanlder will manager the life cycle of curl easy hanlder,
     // so, we won't send the state callback to downloader.
     ret = downloader->start(
-        offset, -1,
+        offset, size,
         [task](std::unique_ptr<StreamBlock> sb) {
           if (task->dcb_) {
             task->stream_size_ += sb->size();
+            if (task->body_) {
+              sb = task->body_->share(std::move(sb));
+            }
             task->dcb_(std::move(sb));
           }
         },
@@ -243,7 +306,7 @@ OMAF_STATUS OmafCurlMultiDownloader::removeReadyTask(OmafDownloadTask::Ptr task)
     std::lock_guard<std::mutex> lock(ready_task_list_mutex_);
     std::list<OmafDownloadTask::Ptr>::iterator it = ready_task_list_.begin();
     for (; it != ready_task_list_.end(); ++it) {
-      if ((*it)->url() == task->url()) {
+      if ((*it)->key() == task->key()) {
         break;
       }
     }
@@ -353,7 +416,10 @@ OMAF_STATUS OmafCurlMultiDownloader::moveTaskFromRun(OmafDownloadTask::Ptr task,
 void OmafCurlMultiDownloader::threadRunner(void) noexcept {
   try {
     while (bworking_) {
-      startTaskDownload();
+      {
+        std::lock_guard<std::recursive_mutex> lock(worker_mutex_);
+        startTaskDownload();
+      }
 
       int still_alive = 0;
       curl_multi_perform(curl_multi_, &still_alive);
@@ -364,7 +430,10 @@ void OmafCurlMultiDownloader::threadRunner(void) noexcept {
         curl_multi_wait(curl_multi_, nullptr, 0, 100, &numfds);
       }
 
-      retriveDoneTask();
+      {
+        std::lock_guard<std::recursive_mutex> lock(worker_mutex_);
+        retriveDoneTask();
+      }
     }
   } catch (const std::exception& ex) {
     LOG(ERROR) << "Exception in the multi thread worker "
@@ -378,10 +447,21 @@ OMAF_STATUS OmafCurlMultiDownloader::startTaskDownload(void) noexcept {
     if ((run_task_map_.size() < static_cast<size_t>(max_parallel_transfers_)) && (ready_task_list_.size() > 0)) {
       OmafDownloadTask::Ptr task = NULL;
       {
+        // start the task with highest priority first, then the earliest deadline
         std::lock_guard<std::mutex> lock(ready_task_list_mutex_);
-        task = std::move(ready_task_list_.front());
+        if (ready_task_list_.empty()) {
+          return ERROR_NONE;
+        }
+        auto selected = ready_task_list_.begin();
+        for (auto it = ready_task_list_.begin(); it != ready_task_list_.end(); ++it) {
+          if ((*it)->priority() < (*selected)->priority() ||
+              ((*it)->priority() == (*selected)->priority() && (*it)->deadline() < (*selected)->deadline())) {
+            selected = it;
+          }
+        }
+        task = std::move(*selected);
         VLOG(VLOG_TRACE) << "1-task id" << task->id() << ", task count=" << task.use_count() << std::endl;
-        ready_task_list_.pop_front();
+        ready_task_list_.erase(selected);
       }
       OMAF_STATUS ret = ERROR_NONE;
       if (task != NULL) {
@@ -436,7 +516,19 @@ size_t OmafCurlMultiDownloader::retriveDoneTask(int msgNum) noexcept {
           removeTransfer(task);
           auto header = task->easy_downloader_->header();
           VLOG(VLOG_TRACE) << "Header content length=" << header.content_length_ << std::endl;
-          if (OmafCurlEasyHelper::success(header.http_status_code_) && (header.content_length_ == task->streamSize())) {
+          if (task->warmup()) {
+            // the connection is kept in the pool whatever the response is
+            VLOG(VLOG_TRACE) << "Warmup done, url=" << task->url() << ", status=" << header.http_status_code_
+                             << std::endl;
+            markTaskFinish(std::move(task));
+          } else if (OmafCurlEasyHelper::success(header.http_status_code_) &&
+                     (header.content_length_ == task->streamSize())) {
+            task->etag(header.etag_);
+            markTaskFinish(std::move(task));
+          } else if (OmafCurlEasyHelper::notModified(header.http_status_code_) && task->ifNoneMatch().size() &&
+                     task->streamSize() == 0 && task->serveRevalidatedData()) {
+            VLOG(VLOG_TRACE) << "Not modified, serve the local copy, url=" << task->url() << std::endl;
+            task->etag(header.etag_.size() ? header.etag_ : task->ifNoneMatch());
             markTaskFinish(std::move(task));
           } else {
             // FIXME how to check timeout
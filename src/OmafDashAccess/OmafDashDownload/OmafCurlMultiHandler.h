@@ -36,6 +36,7 @@
 #include "../common.h"  // VCD::NonCopyable
 #include "OmafCurlEasyHandler.h"
 #include "OmafDownloader.h"
+#include "OmafSegmentCache.h"
 #include "performance.h"
 
 #include <list>
@@ -45,6 +46,7 @@
 #include <string>
 #include <atomic>
 #include <queue>
+#include <vector>
 
 namespace VCD {
 namespace OMAF {
@@ -101,8 +103,9 @@ class OmafDownloadTask : public VCD::NonCopyable {
   using TaskDoneCB = std::function<void(OmafDownloadTask::Ptr)>;
 
  public:
-  OmafDownloadTask(const std::string &url, OmafDashSegmentClient::OnData dcb, OmafDashSegmentClient::OnState scb)
-      : url_(url), dcb_(dcb), scb_(scb) {
+  OmafDownloadTask(const std::string &url, OmafDashSegmentClient::OnData dcb, OmafDashSegmentClient::OnState scb,
+                   TaskPriority priority = TaskPriority::NORMAL)
+      : url_(url), dcb_(dcb), scb_(scb), priority_(priority) {
     id_ = TASK_ID.fetch_add(1);
   };
 
@@ -114,19 +117,64 @@ class OmafDownloadTask : public VCD::NonCopyable {
   }
 
  public:
-  static Ptr createTask(const std::string &url, OmafDashSegmentClient::OnData dcb, OmafDashSegmentClient::OnState scb) {
-    Ptr task = std::make_shared<OmafDownloadTask>(url, dcb, scb);
+  static Ptr createTask(const std::string &url, OmafDashSegmentClient::OnData dcb, OmafDashSegmentClient::OnState scb,
+                        TaskPriority priority = TaskPriority::NORMAL) {
+    Ptr task = std::make_shared<OmafDownloadTask>(url, dcb, scb, priority);
+    return task;
+  }
+
+  // a warmup task only sends a HEAD request to open the connection to the origin
+  static Ptr createWarmupTask(const std::string &url) {
+    Ptr task = std::make_shared<OmafDownloadTask>(url, nullptr, nullptr, TaskPriority::HIGH);
+    task->bwarmup_ = true;
     return task;
   }
 
  public:
   inline const std::string &url() const noexcept { return url_; }
+  // the byte range of the task, -1 for the whole resource
+  inline void range(int64_t offset, int64_t size) noexcept {
+    range_offset_ = offset;
+    range_size_ = size;
+  }
+  inline int64_t rangeOffset() const noexcept { return range_offset_; }
+  inline int64_t rangeSize() const noexcept { return range_size_; }
+  // unique for the url and byte range, several ranges of one url may be in flight
+  inline std::string key() const noexcept { return OmafSegmentCache::key(url_, range_offset_, range_size_); }
   inline int64_t streamSize(void) const noexcept { return stream_size_; }
   inline size_t id() const noexcept { return id_; }
+  inline TaskPriority priority() const noexcept { return priority_; }
+  inline bool warmup() const noexcept { return bwarmup_; }
+  // the task is served from the segment cache, no transfer is needed
+  inline void cachedData(OmafSegmentCache::Buffer data) noexcept { cached_data_ = std::move(data); }
+  inline bool cached() const noexcept { return cached_data_.get() != nullptr; }
+  // the request carries the etag of the local copy, which is served when the origin answers 304
+  inline void revalidate(const std::string &etag, OmafSegmentCache::Buffer data) noexcept {
+    if_none_match_ = etag;
+    revalidate_data_ = std::move(data);
+  }
+  inline const std::string &ifNoneMatch() const noexcept { return if_none_match_; }
+  inline bool notModified() const noexcept { return bnot_modified_; }
+  // etag of the response
+  inline void etag(const std::string &etag) noexcept { etag_ = etag; }
+  inline const std::string &etag() const noexcept { return etag_; }
+  // keep the received blocks, so the body can be cached once the task finishes
+  inline void keepBody() noexcept { body_ = std::make_shared<SharedStreamBlocks>(); }
+  inline std::shared_ptr<const SharedStreamBlocks> body() const noexcept { return body_; }
+  inline void deadline(std::chrono::steady_clock::time_point d) noexcept { deadline_ = d; }
+  inline std::chrono::steady_clock::time_point deadline() const noexcept { return deadline_; }
+  // the fallback task is kept even it misses the deadline
+  inline bool expired(std::chrono::steady_clock::time_point now) const noexcept {
+    return priority_ != TaskPriority::FALLBACK && deadline_ < now;
+  }
   std::string to_string() const noexcept {
     std::stringstream ss;
     ss << "task, id=" << id_;
     ss << ", url=" << url_;
+    if (range_offset_ >= 0 || range_size_ > 0) {
+      ss << ", range=" << range_offset_ << "/" << range_size_;
+    }
+    ss << ", priority=" << VCD::OMAF::priority(priority_);
     ss << ", stream_size=" << stream_size_;
     ss << ", state=" << static_cast<int>(state_);
     return ss.str();
@@ -144,7 +192,8 @@ class OmafDownloadTask : public VCD::NonCopyable {
       case State::STOPPED:
       case State::TIMEOUT:
       case State::FINISH:
-        if (perf_counter_) {
+        // the task may be stopped before its transfer is created
+        if (perf_counter_ && easy_downloader_) {
           perf_counter_->downloadTime(easy_downloader_->downloadTime());
           perf_counter_->downloadSpeed(easy_downloader_->speed());
         }
@@ -172,6 +221,26 @@ class OmafDownloadTask : public VCD::NonCopyable {
       }
     }
   }
+  // deliver the cached segment as one block, then finish the task
+  void serveCachedData() noexcept {
+    if (cached_data_.get() == nullptr) {
+      return;
+    }
+    if (!deliverData(cached_data_)) {
+      taskDoneCallback(State::STOPPED);
+      return;
+    }
+    state_ = State::FINISH;
+    taskDoneCallback(State::FINISH);
+  }
+  // the origin answers 304, the local copy stands for the body
+  bool serveRevalidatedData() noexcept {
+    if (revalidate_data_.get() == nullptr || !deliverData(revalidate_data_)) {
+      return false;
+    }
+    bnot_modified_ = true;
+    return true;
+  }
   std::chrono::milliseconds transferDuration() const {
     if (perf_counter_) return perf_counter_->transferDuration();
     return std::chrono::milliseconds(0);
@@ -193,16 +262,40 @@ class OmafDownloadTask : public VCD::NonCopyable {
   void perfCounter(OmafDownloadTaskPerfCounter::Ptr s) { perf_counter_ = s; }
   OmafDownloadTaskPerfCounter::Ptr perfCounter() { return perf_counter_; };
 
+ private:
+  bool deliverData(const OmafSegmentCache::Buffer &data) noexcept {
+    if (dcb_) {
+      // the views of the cached blocks, the data is not copied
+      for (auto &block : data->blocks()) {
+        std::unique_ptr<StreamBlock> sb = make_unique_vcd<StreamBlock>(block);
+        stream_size_ += sb->size();
+        dcb_(std::move(sb));
+      }
+    }
+    return true;
+  }
+
  private:
   std::string url_;
+  int64_t range_offset_ = -1;
+  int64_t range_size_ = -1;
   OmafDashSegmentClient::OnData dcb_;
   OmafDashSegmentClient::OnState scb_;
+  TaskPriority priority_ = TaskPriority::NORMAL;
+  std::chrono::steady_clock::time_point deadline_ = std::chrono::steady_clock::time_point::max();
+  bool bwarmup_ = false;
   State state_ = State::CREATE;
   OmafCurlEasyDownloader::Ptr easy_downloader_;
   int transfer_times_ = 0;
   size_t id_ = 0;
   size_t stream_size_ = 0;
   OmafDownloadTaskPerfCounter::Ptr perf_counter_;
+  OmafSegmentCache::Buffer cached_data_;
+  std::string if_none_match_;
+  OmafSegmentCache::Buffer revalidate_data_;
+  bool bnot_modified_ = false;
+  std::string etag_;
+  std::shared_ptr<SharedStreamBlocks> body_;
 
  private:
   static std::atomic_size_t TASK_ID;
@@ -229,6 +322,11 @@ class OmafCurlMultiDownloader : public VCD::NonCopyable {
  public:
   OMAF_STATUS addTask(OmafDownloadTask::Ptr task) noexcept;
   OMAF_STATUS removeTask(OmafDownloadTask::Ptr task) noexcept;
+  // remove the task only when its transfer is not started, return ERROR_NOT_FOUND otherwise
+  OMAF_STATUS cancelTask(OmafDownloadTask::Ptr task) noexcept;
+  // wait for the worker to finish the transfers it is starting and the done tasks it is delivering,
+  // no callback of a removed task comes after it returns
+  void quiesce() noexcept;
 
   inline size_t size() const noexcept {  // return ready_task_list_.size() + run_task_map_.size();
     int size = task_size_.load();
@@ -264,6 +362,9 @@ class OmafCurlMultiDownloader : public VCD::NonCopyable {
   std::list<OmafDownloadTask::Ptr> ready_task_list_;
   std::mutex run_task_map_mutex_;
   std::map<void *, OmafDownloadTask::Ptr> run_task_map_;
+  // held by the worker while it starts the transfers and delivers the done tasks,
+  // recursive for the task done callback removing the tasks
+  std::recursive_mutex worker_mutex_;
   std::thread worker_;
   std::atomic_int32_t task_size_{0};
   long max_parallel_ = DEFAULT_MAX_PARALLER_TRANSFERS;
@@ -34,6 +34,7 @@
 #include "OmafCurlMultiHandler.h"
 #include "performance.h"
 
+#include <atomic>
 #include <chrono>
 #include <list>
 #include <map>
@@ -79,9 +80,12 @@ class OmafDashSegmentHttpClientImpl : public OmafDashSegmentHttpClient {
  public:
   OMAF_STATUS open(const SourceParams &ds_params, OnData dcb, OnState scb) noexcept override;
   OMAF_STATUS remove(const SourceParams &ds_params) noexcept override;
+  OMAF_STATUS cancel(const SourceParams &ds_params) noexcept override;
   OMAF_STATUS check(const SourceParams &ds_params) noexcept override;
+  OMAF_STATUS removeAll() noexcept override;
   inline void setStatisticsWindows(int32_t time_window) noexcept override;
   inline std::unique_ptr<PerfStatistics> statistics(void) noexcept override;
+  void setTransferObserver(OnTransfer tcb) noexcept override;
 
  public:
   // set policy based on the priority
@@ -97,11 +101,23 @@ class OmafDashSegmentHttpClientImpl : public OmafDashSegmentHttpClient {
       segment_downloader_->setParams(curl_params_);
     }
   };
+  OMAF_STATUS warmup(const std::string &url, int32_t connections) noexcept override;
+  void setSegmentCache(OmafSegmentCache::Ptr cache) noexcept override { segment_cache_ = std::move(cache); };
+  void setInitSegmentCache(OmafInitSegmentCache::Ptr cache) noexcept override {
+    init_segment_cache_ = std::move(cache);
+  };
 
  private:
   void threadRunner(void) noexcept;
-  OmafDownloadTask::Ptr fetchReadyTask(void) noexcept;
+  OmafDownloadTask::Ptr fetchReadyTask(std::list<OmafDownloadTask::Ptr> &expired_tasks, uint64_t &generation) noexcept;
+  void dropExpiredTask(std::list<OmafDownloadTask::Ptr> &expired_tasks) noexcept;
+  OmafDownloadTask::Ptr popEarliestTask(std::list<OmafDownloadTask::Ptr> &tasks) noexcept;
+  OmafDownloadTask::Ptr removeQueuedTask(const SourceParams &ds_params) noexcept;
   void processDoneTask(OmafDownloadTask::Ptr task) noexcept;
+  // tasks are identified by the url and byte range
+  static inline std::string taskKey(const SourceParams &ds_params) noexcept {
+    return OmafSegmentCache::key(ds_params.dash_url_, ds_params.range_offset_, ds_params.range_size_);
+  }
 
  private:
   const long max_parallel_transfers_;
@@ -111,6 +127,10 @@ class OmafDashSegmentHttpClientImpl : public OmafDashSegmentHttpClient {
   std::mutex task_queue_mutex_;
   std::condition_variable task_queue_cv_;
   std::list<TaskList::Ptr> task_queue_;
+  // bumped by removeAll, the tasks fetched before it are dropped
+  std::atomic<uint64_t> queue_generation_{0};
+  // held by the worker while it hands out the fetched tasks
+  std::mutex dispatch_mutex_;
   std::mutex downloading_task_mutex_;
   std::map<std::string, OmafDownloadTask::Ptr> downloading_tasks_;
   std::thread download_worker_;
@@ -118,6 +138,8 @@ class OmafDashSegmentHttpClientImpl : public OmafDashSegmentHttpClient {
 
   std::unique_ptr<OmafDashSegmentHttpClientPerf> perf_stats_;
   OmafCurlMultiDownloader *tmpMultiDownloader_;
+  OmafSegmentCache::Ptr segment_cache_;
+  OmafInitSegmentCache::Ptr init_segment_cache_;
 };
 
 class OmafDashSegmentHttpClientPerf : public VCD::NonCopyable {
@@ -128,6 +150,7 @@ class OmafDashSegmentHttpClientPerf : public VCD::NonCopyable {
  public:
   void setStatisticsWindows(int32_t time_window) noexcept;
   std::unique_ptr<OmafDashSegmentClient::PerfStatistics> statistics(void) noexcept;
+  void setTransferObserver(OmafDashSegmentClient::OnTransfer tcb) noexcept { transfer_observer_ = tcb; }
 
   void addTime(OmafDownloadTask::State, const std::chrono::milliseconds &) noexcept;
   void addTransfer(OmafDownloadTask::State, size_t) noexcept;
@@ -150,6 +173,7 @@ class OmafDashSegmentHttpClientPerf : public VCD::NonCopyable {
   WindowCounter<long> timeout_task_download_counter_;
   WindowCounter<long> failure_task_download_counter_;
   WindowCounter<double> network_speed_counter_;
+  OmafDashSegmentClient::OnTransfer transfer_observer_;
 };
 
 /******************************************************************************
@@ -172,7 +196,7 @@ OMAF_STATUS OmafDashSegmentHttpClientImpl::start() noexcept {
     curl_global_init(CURL_GLOBAL_ALL);
 
     // 1. create the multi downloader
-    tmpMultiDownloader_ = new OmafCurlMultiDownloader;
+    tmpMultiDownloader_ = new OmafCurlMultiDownloader(max_parallel_transfers_);
     if (tmpMultiDownloader_ == NULL) return ERROR_INVALID;
     segment_downloader_.reset(tmpMultiDownloader_);
     if (segment_downloader_.get() == nullptr) {
@@ -248,15 +272,60 @@ OMAF_STATUS OmafDashSegmentHttpClientImpl::stop() noexcept {
 
 OMAF_STATUS OmafDashSegmentHttpClientImpl::open(const SourceParams &ds_params, OnData dcb, OnState scb) noexcept {
   try {
-    OmafDownloadTask::Ptr task = OmafDownloadTask::createTask(ds_params.dash_url_, dcb, scb);
+    OmafSegmentCache::Buffer cached_data;
+    if (segment_cache_.get() != nullptr) {
+      std::string cache_key = OmafSegmentCache::key(ds_params.dash_url_, ds_params.range_offset_, ds_params.range_size_);
+      cached_data = segment_cache_->get(cache_key);
+      if (cached_data.get() == nullptr) {
+        // share the received blocks with the reader, and add them to the cache once the transfer succeeds
+        std::shared_ptr<SharedStreamBlocks> received = std::make_shared<SharedStreamBlocks>();
+        OmafSegmentCache::Ptr cache = segment_cache_;
+        OnData user_dcb = std::move(dcb);
+        OnState user_scb = std::move(scb);
+        dcb = [received, user_dcb](std::unique_ptr<StreamBlock> sb) {
+          if (sb.get() != nullptr && sb->size() > 0) {
+            sb = received->share(std::move(sb));
+          }
+          if (user_dcb) {
+            user_dcb(std::move(sb));
+          }
+        };
+        scb = [received, cache, cache_key, user_scb](State state) {
+          if (state == State::SUCCESS && !received->empty()) {
+            cache->put(cache_key, received);
+          }
+          if (user_scb) {
+            user_scb(state);
+          }
+        };
+      }
+    }
+
+    OmafDownloadTask::Ptr task = OmafDownloadTask::createTask(ds_params.dash_url_, dcb, scb, ds_params.priority_);
     if (task.get() == nullptr) {
       LOG(ERROR) << "Failed to create the task" << std::endl;
       return ERROR_INVALID;
     }
-    if (perf_stats_.get() != nullptr) {
+    task->deadline(ds_params.deadline_);
+    task->range(ds_params.range_offset_, ds_params.range_size_);
+    if (cached_data.get() != nullptr) {
+      VLOG(VLOG_TRACE) << "Segment cache hit, url=" << ds_params.dash_url_ << std::endl;
+      task->cachedData(std::move(cached_data));
+    } else if (perf_stats_.get() != nullptr) {
       OmafDownloadTaskPerfCounter::Ptr t_perf = std::make_shared<OmafDownloadTaskPerfCounter>();
       task->perfCounter(std::move(t_perf));
     }
+    if (init_segment_cache_.get() != nullptr && ds_params.init_segment_ && !task->cached() &&
+        ds_params.range_offset_ < 0 && ds_params.range_size_ < 0) {
+      std::string etag;
+      OmafSegmentCache::Buffer local_data;
+      if (init_segment_cache_->get(ds_params.dash_url_, etag, local_data)) {
+        VLOG(VLOG_TRACE) << "Revalidate the init segment, url=" << ds_params.dash_url_ << ", etag=" << etag
+                         << std::endl;
+        task->revalidate(etag, std::move(local_data));
+      }
+      task->keepBody();
+    }
 
     VLOG(VLOG_TRACE) << "Open the task count=" << task.use_count() << ". " << task->to_string() << std::endl;
     bool new_timeline = true;
@@ -265,8 +334,12 @@ OMAF_STATUS OmafDashSegmentHttpClientImpl::open(const SourceParams &ds_params, O
     for (auto &tl : task_queue_) {
       if (ds_params.timeline_point_ == tl->timeline_point_) {
         new_timeline = false;
-        auto &tasks = tl->tasks_[static_cast<int>(ds_params.priority_)];
-        tasks.push_back(task);
+        int priority = static_cast<int>(ds_params.priority_);
+        if (priority >= PRIORITYTASKSIZE) {
+          LOG(ERROR) << "Priority " << priority << " is invalid, the max task size is " << PRIORITYTASKSIZE << std::endl;
+          return ERROR_INVALID;
+        }
+        tl->tasks_[priority].push_back(task);
         break;
       }
     }
@@ -288,15 +361,21 @@ OMAF_STATUS OmafDashSegmentHttpClientImpl::open(const SourceParams &ds_params, O
         return ERROR_INVALID;
       }
 
-      if (!task_queue_.empty()) {
-        auto &tail_tasks = task_queue_.back();
-        if (tail_tasks->timeline_point_ >= ds_params.timeline_point_) {
-          LOG(FATAL) << "Invalid timeline point happen! <" << tail_tasks->timeline_point_ << ", "
+      if (!task_queue_.empty() && task_queue_.back()->timeline_point_ >= ds_params.timeline_point_) {
+        // a follow-up range of an older segment, e.g. the subsegments after the segment index,
+        // keep the queue ordered by timeline
+        if (ds_params.range_offset_ < 0) {
+          LOG(FATAL) << "Invalid timeline point happen! <" << task_queue_.back()->timeline_point_ << ", "
                      << ds_params.timeline_point_ << ">" << std::endl;
         }
+        auto it = task_queue_.begin();
+        while (it != task_queue_.end() && (*it)->timeline_point_ < ds_params.timeline_point_) {
+          ++it;
+        }
+        task_queue_.insert(it, tl);
+      } else {
+        task_queue_.push_back(tl);
       }
-
-      task_queue_.push_back(tl);
     }
     task_queue_cv_.notify_all();
     return ERROR_NONE;
@@ -307,37 +386,14 @@ OMAF_STATUS OmafDashSegmentHttpClientImpl::open(const SourceParams &ds_params, O
 }
 OMAF_STATUS OmafDashSegmentHttpClientImpl::remove(const SourceParams &ds_params) noexcept {
   try {
-    OmafDownloadTask::Ptr to_remove_task;
-
     // 1. find it from create state list
-    {
-      std::lock_guard<std::mutex> lock(task_queue_mutex_);
-      for (auto &tl : task_queue_) {
-        if (tl->timeline_point_ == ds_params.timeline_point_) {
-          int priority = static_cast<int>(ds_params.priority_);
-          auto &tasks = tl->tasks_[priority];
-
-          std::list<OmafDownloadTask::Ptr>::iterator it = tasks.begin();
-          while (it != tasks.end()) {
-            auto &task = *it;
-            if (task->url() == ds_params.dash_url_) {
-              if (task->state() == OmafDownloadTask::State::CREATE) {
-                to_remove_task = *it;
-                tasks.erase(it);
-                break;
-              }
-            }
-          }
-          break;
-        }
-      }
-    }
+    OmafDownloadTask::Ptr to_remove_task = removeQueuedTask(ds_params);
 
     // 2. remove it from downloading task list
     if (to_remove_task.get() == nullptr) {
       {
         std::lock_guard<std::mutex> lock(downloading_task_mutex_);
-        auto it = downloading_tasks_.find(ds_params.dash_url_);
+        auto it = downloading_tasks_.find(taskKey(ds_params));
         if (it != downloading_tasks_.end()) {
           to_remove_task = std::move(it->second);
           downloading_tasks_.erase(it);
@@ -359,6 +415,105 @@ OMAF_STATUS OmafDashSegmentHttpClientImpl::remove(const SourceParams &ds_params)
     return ERROR_INVALID;
   }
 }
+
+OMAF_STATUS OmafDashSegmentHttpClientImpl::cancel(const SourceParams &ds_params) noexcept {
+  try {
+    if (ds_params.priority_ == TaskPriority::FALLBACK) {
+      return ERROR_INVALID;
+    }
+
+    // 1. not scheduled yet
+    OmafDownloadTask::Ptr task = removeQueuedTask(ds_params);
+    if (task.get() != nullptr) {
+      VLOG(VLOG_TRACE) << "Cancel the queued task, " << ds_params.to_string() << std::endl;
+      task->state(OmafDownloadTask::State::STOPPED);
+      task->taskDoneCallback(OmafDownloadTask::State::STOPPED);
+      return ERROR_NONE;
+    }
+
+    // 2. scheduled to the multi downloader but not transferring
+    {
+      std::lock_guard<std::mutex> lock(downloading_task_mutex_);
+      auto it = downloading_tasks_.find(taskKey(ds_params));
+      if (it != downloading_tasks_.end()) {
+        task = it->second;
+      }
+    }
+    if (task.get() != nullptr && segment_downloader_->cancelTask(task) == ERROR_NONE) {
+      {
+        std::lock_guard<std::mutex> lock(downloading_task_mutex_);
+        downloading_tasks_.erase(taskKey(ds_params));
+      }
+      VLOG(VLOG_TRACE) << "Cancel the ready task, " << ds_params.to_string() << std::endl;
+      task->taskDoneCallback(OmafDownloadTask::State::STOPPED);
+      return ERROR_NONE;
+    }
+    return ERROR_NOT_FOUND;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when cancel the dash source, ex: " << ex.what() << std::endl;
+    return ERROR_INVALID;
+  }
+}
+
+OMAF_STATUS OmafDashSegmentHttpClientImpl::removeAll() noexcept {
+  try {
+    {
+      std::lock_guard<std::mutex> lock(task_queue_mutex_);
+      task_queue_.clear();
+      queue_generation_++;
+    }
+
+    // the worker has handed out the tasks fetched before the clear, or drops them
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+    std::map<std::string, OmafDownloadTask::Ptr> to_remove_tasks;
+    {
+      std::lock_guard<std::mutex> lock(downloading_task_mutex_);
+      to_remove_tasks.swap(downloading_tasks_);
+    }
+    for (auto &it : to_remove_tasks) {
+      if (segment_downloader_.get() != nullptr) {
+        segment_downloader_->removeTask(it.second);
+      }
+    }
+    // the caller releases what the callbacks refer to, so wait for the ones being delivered
+    if (segment_downloader_.get() != nullptr) {
+      segment_downloader_->quiesce();
+    }
+    LOG(INFO) << "Removed " << to_remove_tasks.size() << " downloading tasks!" << std::endl;
+    return ERROR_NONE;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when remove all the tasks, ex: " << ex.what() << std::endl;
+    return ERROR_INVALID;
+  }
+}
+
+OmafDownloadTask::Ptr OmafDashSegmentHttpClientImpl::removeQueuedTask(const SourceParams &ds_params) noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(task_queue_mutex_);
+    for (auto &tl : task_queue_) {
+      if (tl->timeline_point_ != ds_params.timeline_point_) {
+        continue;
+      }
+      // the priority may be updated since opened, so check all of them
+      for (int i = 0; i < PRIORITYTASKSIZE; i++) {
+        auto &tasks = tl->tasks_[i];
+        for (auto it = tasks.begin(); it != tasks.end(); ++it) {
+          if ((*it)->key() == taskKey(ds_params) && (*it)->state() == OmafDownloadTask::State::CREATE) {
+            OmafDownloadTask::Ptr task = std::move(*it);
+            tasks.erase(it);
+            return task;
+          }
+        }
+      }
+      break;
+    }
+    return nullptr;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when remove the queued task, ex: " << ex.what() << std::endl;
+    return nullptr;
+  }
+}
+
 OMAF_STATUS OmafDashSegmentHttpClientImpl::check(const SourceParams &ds_params) noexcept {
   try {
     return url_checker_->check(ds_params.dash_url_);
@@ -368,6 +523,32 @@ OMAF_STATUS OmafDashSegmentHttpClientImpl::check(const SourceParams &ds_params)
   }
 }
 
+OMAF_STATUS OmafDashSegmentHttpClientImpl::warmup(const std::string &url, int32_t connections) noexcept {
+  try {
+    if (segment_downloader_.get() == nullptr) {
+      LOG(ERROR) << "The client is not started for warmup!" << std::endl;
+      return ERROR_INVALID;
+    }
+    LOG(INFO) << "Warmup " << connections << " connections for url: " << url << std::endl;
+    // warmup task skips the timeline queue, the multi downloader keeps the connections alive for reusing
+    for (int32_t i = 0; i < connections; i++) {
+      OmafDownloadTask::Ptr task = OmafDownloadTask::createWarmupTask(url);
+      if (task.get() == nullptr) {
+        LOG(ERROR) << "Failed to create the warmup task" << std::endl;
+        return ERROR_NULL_PTR;
+      }
+      OMAF_STATUS ret = segment_downloader_->addTask(task);
+      if (ERROR_NONE != ret) {
+        return ret;
+      }
+    }
+    return ERROR_NONE;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when warmup the connections, ex: " << ex.what() << std::endl;
+    return ERROR_INVALID;
+  }
+}
+
 inline void OmafDashSegmentHttpClientImpl::setStatisticsWindows(int32_t time_window) noexcept {
   if (perf_stats_ == nullptr) {
     perf_stats_.reset(new OmafDashSegmentHttpClientPerf());
@@ -381,6 +562,14 @@ inline std::unique_ptr<OmafDashSegmentClient::PerfStatistics> OmafDashSegmentHtt
   return nullptr;
 };
 
+void OmafDashSegmentHttpClientImpl::setTransferObserver(OnTransfer tcb) noexcept {
+  // the transfer time is measured by the task perf counter, which comes with the statistics
+  if (perf_stats_ == nullptr) {
+    perf_stats_.reset(new OmafDashSegmentHttpClientPerf());
+  }
+  perf_stats_->setTransferObserver(tcb);
+}
+
 void OmafDashSegmentHttpClientImpl::threadRunner(void) noexcept {
   try {
     const size_t max_queue_size = static_cast<size_t>(max_parallel_transfers_ << 1);
@@ -393,8 +582,23 @@ void OmafDashSegmentHttpClientImpl::threadRunner(void) noexcept {
         continue;
       }
       // 2. fetch ready task
-
-      OmafDownloadTask::Ptr task = fetchReadyTask();
+      std::list<OmafDownloadTask::Ptr> expired_tasks;
+      uint64_t generation = 0;
+      OmafDownloadTask::Ptr task = fetchReadyTask(expired_tasks, generation);
+      std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+      if (generation != queue_generation_.load()) {
+        // removed by removeAll when fetched
+        continue;
+      }
+      // 2.0 the tasks missing their deadline are done with timeout, out of the queue lock
+      for (auto &expired : expired_tasks) {
+        expired->taskDoneCallback(OmafDownloadTask::State::TIMEOUT);
+      }
+      if (task.get() != nullptr && task->cached()) {
+        // 2.0 cached segment, no transfer and no statistics for it
+        task->serveCachedData();
+        continue;
+      }
       if (task.get() != nullptr) {
         // 2.1 add to downloader
         VLOG(VLOG_TRACE) << "downloader-0-task id" << task->id() << ", task count=" << task.use_count() << std::endl;
@@ -403,7 +607,7 @@ void OmafDashSegmentHttpClientImpl::threadRunner(void) noexcept {
           // 2.1.2 cache in the downloading list to support remove
 
           std::lock_guard<std::mutex> lock(downloading_task_mutex_);
-          downloading_tasks_[task->url()] = task;
+          downloading_tasks_[task->key()] = task;
         }
         LOG(INFO) << "Start download for task count=" << task.use_count() << ". " << task->to_string() << std::endl;
       }
@@ -413,22 +617,43 @@ void OmafDashSegmentHttpClientImpl::threadRunner(void) noexcept {
   }
 }
 
-OmafDownloadTask::Ptr OmafDashSegmentHttpClientImpl::fetchReadyTask(void) noexcept {
+OmafDownloadTask::Ptr OmafDashSegmentHttpClientImpl::fetchReadyTask(
+    std::list<OmafDownloadTask::Ptr> &expired_tasks, uint64_t &generation) noexcept {
   try {
     std::unique_lock<std::mutex> lock(task_queue_mutex_);
+    generation = queue_generation_.load();
 
     while (task_queue_.size()) {
+      dropExpiredTask(expired_tasks);
+
+      // 1. the fallback track is protected, serve it for all queued timelines first,
+      //    so the user always has the full low resolution picture to show
+      const int fallback = static_cast<int>(TaskPriority::FALLBACK);
+      for (auto &tl : task_queue_) {
+        if (tl->tasks_[fallback].size()) {
+          return popEarliestTask(tl->tasks_[fallback]);
+        }
+      }
+
+      // 2. the oldest timeline by priority class, the earliest deadline in the same class
       auto &tl = task_queue_.front();
-      for (int i = 0; i < PRIORITYTASKSIZE; i++) {
+      for (int i = fallback + 1; i < PRIORITYTASKSIZE; i++) {
         if (tl->tasks_[i].size()) {
-          auto task = std::move(tl->tasks_[i].front());
-          tl->tasks_[i].pop_front();
-          return std::move(task);
+          return popEarliestTask(tl->tasks_[i]);
         }
       }
-      // no new task list with new timeline ready, then wait
+      // no new task list with new timeline ready, then wait,
+      // unless the dropped tasks are to be reported
       if (task_queue_.size() <= 1) {
+        if (expired_tasks.size()) {
+          return nullptr;
+        }
         task_queue_cv_.wait(lock);
+        if (generation != queue_generation_.load()) {
+          // removeAll came meanwhile, the dropped tasks are gone with it
+          expired_tasks.clear();
+          generation = queue_generation_.load();
+        }
       } else {
         // drop the oldest task list of queue and move next
         task_queue_.pop_front();
@@ -442,25 +667,70 @@ OmafDownloadTask::Ptr OmafDashSegmentHttpClientImpl::fetchReadyTask(void) noexce
   }
 }
 
+// call with task_queue_mutex_ locked
+void OmafDashSegmentHttpClientImpl::dropExpiredTask(std::list<OmafDownloadTask::Ptr> &expired_tasks) noexcept {
+  auto now = std::chrono::steady_clock::now();
+  for (auto &tl : task_queue_) {
+    for (int i = 0; i < PRIORITYTASKSIZE; i++) {
+      auto &tasks = tl->tasks_[i];
+      auto it = tasks.begin();
+      while (it != tasks.end()) {
+        if ((*it)->expired(now)) {
+          // the reader manager skips the segment after the deadline, so don't spend bandwidth on it
+          VLOG(VLOG_TRACE) << "Drop the task missing its deadline, " << (*it)->to_string() << std::endl;
+          (*it)->state(OmafDownloadTask::State::TIMEOUT);
+          expired_tasks.push_back(std::move(*it));
+          it = tasks.erase(it);
+        } else {
+          it++;
+        }
+      }
+    }
+  }
+}
+
+// call with task_queue_mutex_ locked
+OmafDownloadTask::Ptr OmafDashSegmentHttpClientImpl::popEarliestTask(std::list<OmafDownloadTask::Ptr> &tasks) noexcept {
+  auto selected = tasks.begin();
+  for (auto it = tasks.begin(); it != tasks.end(); ++it) {
+    if ((*it)->deadline() < (*selected)->deadline()) {
+      selected = it;
+    }
+  }
+  OmafDownloadTask::Ptr task = std::move(*selected);
+  tasks.erase(selected);
+  return task;
+}
+
 void OmafDashSegmentHttpClientImpl::processDoneTask(OmafDownloadTask::Ptr task) noexcept {
   try {
     if (task.get() == nullptr) {
       return;
     }
+    // warmup task is not a segment, keep it out of the statistics
+    if (task->warmup()) {
+      return;
+    }
     OmafDownloadTask::State state = task->state();
     task->taskDoneCallback(state);
 
+    if (init_segment_cache_.get() != nullptr && state == OmafDownloadTask::State::FINISH && !task->notModified() &&
+        task->body().get() != nullptr && task->etag().size()) {
+      init_segment_cache_->put(task->url(), task->etag(), *task->body());
+    }
+
     // remove from downloading list
     {
       std::lock_guard<std::mutex> lock(downloading_task_mutex_);
-      auto it = downloading_tasks_.find(task->url());
+      auto it = downloading_tasks_.find(task->key());
       if (it != downloading_tasks_.end()) {
         downloading_tasks_.erase(it);
         VLOG(VLOG_TRACE) << "Done the task count=" << task.use_count() << ". " << task->to_string() << std::endl;
       }
     }
 
-    if (perf_stats_) {
+    // the body of a 304 is the local copy, it says nothing about the throughput
+    if (perf_stats_ && !task->notModified()) {
       auto duration = task->transferDuration();
       auto transfer_size = task->streamSize();
       auto download_time = task->downloadTime();
@@ -541,6 +811,9 @@ void OmafDashSegmentHttpClientPerf::add(OmafDownloadTask::State state, const std
       success_task_time_counter_.add(duration.count());
       success_task_transfer_counter_.add(transfer_size);
       success_task_download_counter_.add(download_time);
+      if (transfer_observer_) {
+        transfer_observer_(transfer_size, download_time);
+      }
       break;
     default:
       break;
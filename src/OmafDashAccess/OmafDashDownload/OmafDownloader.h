@@ -35,6 +35,8 @@
 
 #include "../OmafDashParser/Common.h"
 #include "../OmafTypes.h"
+#include "OmafInitSegmentCache.h"
+#include "OmafSegmentCache.h"
 #include "Stream.h"
 
 #include <string>
@@ -110,6 +112,7 @@ class OmafDashSegmentClient : public VCD::NonCopyable {
   using PerfStatistics = struct _perfStatistics;
   using OnData = std::function<void(std::unique_ptr<VCD::OMAF::StreamBlock>)>;
   using OnState = std::function<void(State)>;
+  using OnTransfer = std::function<void(size_t transfer_bytes, long download_time_us)>;
 
  protected:
   OmafDashSegmentClient() = default;
@@ -124,9 +127,27 @@ class OmafDashSegmentClient : public VCD::NonCopyable {
  public:
   virtual OMAF_STATUS open(const SourceParams &dash_source, OnData scb, OnState fcb) noexcept = 0;
   virtual OMAF_STATUS remove(const SourceParams &dash_source) noexcept = 0;
+  //!
+  //! \brief  cancel the download if its transfer is not started, the running one is kept.
+  //!         it is used to drop stale requests when viewport changes, the canceled one
+  //!         is done with the STOPPED state. fallback download won't be canceled
+  //!
+  virtual OMAF_STATUS cancel(const SourceParams &dash_source) noexcept = 0;
   virtual OMAF_STATUS check(const SourceParams &dash_source) noexcept = 0;
+  //!
+  //! \brief  remove all the queued and downloading tasks, no state callback will be sent
+  //!         for them. the worker and the connections are kept, it is used to switch
+  //!         the media in the same session
+  //!
+  virtual OMAF_STATUS removeAll() noexcept = 0;
   virtual void setStatisticsWindows(int32_t time_window) noexcept = 0;
   virtual std::unique_ptr<PerfStatistics> statistics(void) noexcept = 0;
+  //!
+  //! \brief  observe each successful transfer along with the statistics, it feeds
+  //!         the throughput estimation of abr. the observer is called in the
+  //!         download thread
+  //!
+  virtual void setTransferObserver(OnTransfer tcb) noexcept = 0;
 };
 
 class OmafDashSegmentHttpClient : public OmafDashSegmentClient {
@@ -143,6 +164,25 @@ class OmafDashSegmentHttpClient : public OmafDashSegmentClient {
   virtual void setProxy(OmafDashHttpProxy proxy) noexcept = 0;
   virtual void setParams(OmafDashHttpParams params) noexcept = 0;
 
+  //!
+  //! \brief  open connections to the origin of the url ahead of segment requests,
+  //!         so the first segments won't pay for the connection and handshake
+  //!
+  virtual OMAF_STATUS warmup(const std::string &url, int32_t connections) noexcept = 0;
+
+  //!
+  //! \brief  serve the segments from the in-memory cache when they are there, and
+  //!         add the downloaded ones to it. the cached ones are not counted in the
+  //!         transfer statistics
+  //!
+  virtual void setSegmentCache(OmafSegmentCache::Ptr cache) noexcept = 0;
+
+  //!
+  //! \brief  keep the init segments on disk with their etags, the later requests for
+  //!         them are revalidated and the local copy is served on 304 Not Modified
+  //!
+  virtual void setInitSegmentCache(OmafInitSegmentCache::Ptr cache) noexcept = 0;
+
  public:
   static OmafDashSegmentHttpClient::Ptr create(long max_parallel_transfers) noexcept;
 };
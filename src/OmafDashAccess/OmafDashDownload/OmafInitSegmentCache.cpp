@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ */
+
+//!
+//! \file:   OmafInitSegmentCache.cpp
+//! \brief:  on-disk cache of init segments revalidated by etag
+//!
+
+#include "OmafInitSegmentCache.h"
+#include "../../utils/GlogWrapper.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace VCD {
+namespace OMAF {
+
+OmafInitSegmentCache::OmafInitSegmentCache(const std::string &cache_dir) : cache_dir_(cache_dir) {
+  if (cache_dir_.size() && cache_dir_[cache_dir_.size() - 1] == '/') {
+    cache_dir_ = cache_dir_.substr(0, cache_dir_.size() - 1);
+  }
+  if (::mkdir(cache_dir_.c_str(), 0755) != 0 && errno != EEXIST) {
+    LOG(WARNING) << "Failed to create the init segment cache folder: " << cache_dir_ << std::endl;
+  }
+  LOG(INFO) << "Create the init segment cache in " << cache_dir_ << std::endl;
+}
+
+bool OmafInitSegmentCache::get(const std::string &url, std::string &etag, OmafSegmentCache::Buffer &data) noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ifstream meta(metaFile(url));
+    if (!meta.is_open()) {
+      return false;
+    }
+    std::string cached_url;
+    std::string cached_etag;
+    if (!std::getline(meta, cached_url) || !std::getline(meta, cached_etag) || cached_url != url ||
+        cached_etag.empty()) {
+      return false;
+    }
+
+    int fd = ::open(dataFile(url).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+      ::close(fd);
+      return false;
+    }
+    std::unique_ptr<StreamBlock> sb = make_unique_vcd<StreamBlock>();
+    ssize_t read_size = -1;
+    if (sb->resize(st.st_size)) {
+      read_size = ::pread(fd, sb->buf(), static_cast<size_t>(st.st_size), 0);
+    }
+    ::close(fd);
+    if (read_size != static_cast<ssize_t>(st.st_size) || !sb->size(st.st_size)) {
+      LOG(WARNING) << "Failed to read the cached init segment, url=" << url << std::endl;
+      return false;
+    }
+
+    std::shared_ptr<SharedStreamBlocks> buffer = std::make_shared<SharedStreamBlocks>();
+    buffer->push_back(std::move(sb));
+    etag = cached_etag;
+    data = std::move(buffer);
+    return true;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when read the init segment cache, ex: " << ex.what() << std::endl;
+    return false;
+  }
+}
+
+OMAF_STATUS OmafInitSegmentCache::put(const std::string &url, const std::string &etag,
+                                      const SharedStreamBlocks &data) noexcept {
+  try {
+    if (etag.empty() || data.empty() || etag.find('\n') != std::string::npos) {
+      return ERROR_INVALID;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    // the data goes first, a stale etag along with the new data only costs a full fetch
+    if (!writeFile(dataFile(url), data)) {
+      LOG(WARNING) << "Failed to write the init segment cache, url=" << url << std::endl;
+      return ERROR_INVALID;
+    }
+    std::string meta = url + "\n" + etag + "\n";
+    if (!writeFile(metaFile(url), meta.data(), meta.size())) {
+      LOG(WARNING) << "Failed to write the init segment cache meta, url=" << url << std::endl;
+      ::unlink(dataFile(url).c_str());
+      return ERROR_INVALID;
+    }
+    VLOG(VLOG_TRACE) << "Cache the init segment, url=" << url << ", etag=" << etag << std::endl;
+    return ERROR_NONE;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when write the init segment cache, ex: " << ex.what() << std::endl;
+    return ERROR_INVALID;
+  }
+}
+
+void OmafInitSegmentCache::remove(const std::string &url) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ::unlink(metaFile(url).c_str());
+  ::unlink(dataFile(url).c_str());
+}
+
+std::string OmafInitSegmentCache::dataFile(const std::string &url) const noexcept {
+  // FNV-1a, it is stable between runs unlike std::hash
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : url) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  std::stringstream ss;
+  ss << cache_dir_ << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".init.mp4";
+  return ss.str();
+}
+
+std::string OmafInitSegmentCache::metaFile(const std::string &url) const noexcept { return dataFile(url) + ".etag"; }
+
+bool OmafInitSegmentCache::writeFile(const std::string &file, const char *data, size_t size) noexcept {
+  SharedStreamBlocks blocks;
+  blocks.push_back(std::make_shared<StreamBlock>(const_cast<char *>(data), static_cast<int64_t>(size)));
+  return writeFile(file, blocks);
+}
+
+bool OmafInitSegmentCache::writeFile(const std::string &file, const SharedStreamBlocks &data) noexcept {
+  // write to a temp file then rename, other sessions sharing the folder see the whole file or none
+  std::string tmp_file = file + ".tmp." + std::to_string(::getpid());
+  int fd = ::open(tmp_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  int64_t written = 0;
+  for (auto &block : data.blocks()) {
+    int64_t block_written = 0;
+    while (block_written < block->size()) {
+      ssize_t n = ::write(fd, block->cbuf() + block_written, static_cast<size_t>(block->size() - block_written));
+      if (n <= 0) {
+        break;
+      }
+      block_written += n;
+    }
+    written += block_written;
+    if (block_written != block->size()) {
+      break;
+    }
+  }
+  ::close(fd);
+  if (written != data.size() || ::rename(tmp_file.c_str(), file.c_str()) != 0) {
+    ::unlink(tmp_file.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace OMAF
+}  // namespace VCD
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ */
+
+//!
+//! \file:   OmafInitSegmentCache.h
+//! \brief:  on-disk cache of init segments revalidated by etag
+//! \detail: init segments of all tracks are fetched before the playback starts, and
+//!          they rarely change between sessions. they are kept in a folder keyed by
+//!          url along with the etag of the response, then the next join sends the
+//!          etag in If-None-Match and takes the local copy on 304 Not Modified
+//!
+
+#ifndef OMAFINITSEGMENTCACHE_H
+#define OMAFINITSEGMENTCACHE_H
+
+#include "../../utils/error.h"
+#include "../common.h"  // VCD::NonCopyable
+#include "OmafSegmentCache.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace VCD {
+namespace OMAF {
+
+class OmafInitSegmentCache : public VCD::NonCopyable {
+ public:
+  using Ptr = std::shared_ptr<OmafInitSegmentCache>;
+
+ public:
+  OmafInitSegmentCache(const std::string &cache_dir);
+  virtual ~OmafInitSegmentCache() {}
+
+ public:
+  //!
+  //! \brief  look up the init segment of the url
+  //!
+  //! \param  [in] url
+  //! \param  [out] etag
+  //!         etag of the response the data came with
+  //! \param  [out] data
+  //!         the cached init segment
+  //!
+  //! \return bool
+  //!         true if it is cached along with an etag, else false
+  //!
+  bool get(const std::string &url, std::string &etag, OmafSegmentCache::Buffer &data) noexcept;
+
+  //!
+  //! \brief  keep the init segment of the url, the response without etag is
+  //!         not kept since it can't be revalidated
+  //!
+  OMAF_STATUS put(const std::string &url, const std::string &etag, const SharedStreamBlocks &data) noexcept;
+
+  void remove(const std::string &url) noexcept;
+
+ private:
+  // the files for the url, named by its hash, the url is kept in the meta to rule out collisions
+  std::string dataFile(const std::string &url) const noexcept;
+  std::string metaFile(const std::string &url) const noexcept;
+  static bool writeFile(const std::string &file, const char *data, size_t size) noexcept;
+  static bool writeFile(const std::string &file, const SharedStreamBlocks &data) noexcept;
+
+ private:
+  std::string cache_dir_;
+  std::mutex mutex_;
+};
+
+}  // namespace OMAF
+}  // namespace VCD
+
+#endif  // OMAFINITSEGMENTCACHE_H
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ */
+
+//!
+//! \file:   OmafSegmentCache.cpp
+//! \brief:  in-memory segment cache with LRU eviction
+//!
+
+#include "OmafSegmentCache.h"
+#include "../../utils/GlogWrapper.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace VCD {
+namespace OMAF {
+
+OmafSegmentCache::OmafSegmentCache(const OmafDashCacheParams &params) : params_(params) {
+  if (params_.enable_spill_ && params_.spill_file_.size() && params_.spill_budget_ > 0) {
+    spill_fd_ = ::open(params_.spill_file_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (spill_fd_ < 0) {
+      LOG(WARNING) << "Failed to open the segment spill file: " << params_.spill_file_
+                   << ", evicted segments will be dropped!" << std::endl;
+    }
+  }
+  LOG(INFO) << "Create the segment cache, " << params_.to_string() << std::endl;
+}
+
+OmafSegmentCache::~OmafSegmentCache() {
+  if (spill_fd_ >= 0) {
+    ::close(spill_fd_);
+    spill_fd_ = -1;
+    ::unlink(params_.spill_file_.c_str());
+  }
+}
+
+std::string OmafSegmentCache::key(const std::string &url, int64_t offset, int64_t size) noexcept {
+  if (offset < 0 && size < 0) {
+    return url;
+  }
+  std::stringstream ss;
+  ss << url << "#" << offset << "-" << size;
+  return ss.str();
+}
+
+OmafSegmentCache::Buffer OmafSegmentCache::get(const std::string &key) noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second.lru_it_);
+      stats_.memory_hits_++;
+      return it->second.data_;
+    }
+
+    Buffer data = readSpill(key);
+    if (data.get() == nullptr) {
+      stats_.misses_++;
+      return nullptr;
+    }
+    stats_.spill_hits_++;
+    // it is wanted again, so bring it back into memory
+    insert(key, data);
+    return data;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when get the segment from cache, ex: " << ex.what() << std::endl;
+    return nullptr;
+  }
+}
+
+OMAF_STATUS OmafSegmentCache::put(const std::string &key, Buffer data) noexcept {
+  try {
+    if (data.get() == nullptr || data->empty()) {
+      return ERROR_INVALID;
+    }
+    if (data->size() > params_.memory_budget_) {
+      VLOG(VLOG_TRACE) << "The segment is larger than the cache budget, skip it. key=" << key << std::endl;
+      return ERROR_INVALID;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert(key, std::move(data));
+    return ERROR_NONE;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when put the segment to cache, ex: " << ex.what() << std::endl;
+    return ERROR_INVALID;
+  }
+}
+
+bool OmafSegmentCache::contains(const std::string &key) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.find(key) != entries_.end() || spill_index_.find(key) != spill_index_.end();
+}
+
+void OmafSegmentCache::clear() noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    lru_.clear();
+    memory_bytes_ = 0;
+    resetSpill();
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when clear the segment cache, ex: " << ex.what() << std::endl;
+  }
+}
+
+OmafSegmentCache::CacheStatistics OmafSegmentCache::statistics(void) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CacheStatistics stats = stats_;
+  stats.entries_ = entries_.size();
+  stats.memory_bytes_ = memory_bytes_;
+  stats.spill_bytes_ = spill_end_;
+  return stats;
+}
+
+void OmafSegmentCache::insert(const std::string &key, Buffer data) noexcept {
+  int64_t size = data->size();
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    memory_bytes_ -= it->second.data_->size();
+    lru_.erase(it->second.lru_it_);
+    entries_.erase(it);
+  }
+
+  evict(size);
+
+  lru_.push_front(key);
+  struct _cacheEntry entry;
+  entry.data_ = std::move(data);
+  entry.lru_it_ = lru_.begin();
+  entries_[key] = std::move(entry);
+  memory_bytes_ += size;
+}
+
+void OmafSegmentCache::evict(int64_t required) noexcept {
+  while (lru_.size() && memory_bytes_ + required > params_.memory_budget_) {
+    auto it = entries_.find(lru_.back());
+    if (it != entries_.end()) {
+      memory_bytes_ -= it->second.data_->size();
+      spill(it->first, it->second.data_);
+      entries_.erase(it);
+    }
+    lru_.pop_back();
+    stats_.evictions_++;
+  }
+}
+
+void OmafSegmentCache::spill(const std::string &key, const Buffer &data) noexcept {
+  if (spill_fd_ < 0 || spill_index_.find(key) != spill_index_.end()) {
+    return;
+  }
+  int64_t size = data->size();
+  if (size > params_.spill_budget_) {
+    return;
+  }
+  // no compaction for the append-only file, restart it when full
+  if (spill_end_ + size > params_.spill_budget_) {
+    resetSpill();
+  }
+
+  int64_t offset = spill_end_;
+  for (auto &block : data->blocks()) {
+    ssize_t written = ::pwrite(spill_fd_, block->cbuf(), static_cast<size_t>(block->size()), offset);
+    if (written != static_cast<ssize_t>(block->size())) {
+      LOG(WARNING) << "Failed to spill the segment to file, key=" << key << std::endl;
+      return;
+    }
+    offset += block->size();
+  }
+  struct _spillEntry entry;
+  entry.offset_ = spill_end_;
+  entry.size_ = size;
+  spill_index_[key] = entry;
+  spill_end_ += size;
+}
+
+OmafSegmentCache::Buffer OmafSegmentCache::readSpill(const std::string &key) noexcept {
+  if (spill_fd_ < 0) {
+    return nullptr;
+  }
+  auto it = spill_index_.find(key);
+  if (it == spill_index_.end()) {
+    return nullptr;
+  }
+
+  std::unique_ptr<StreamBlock> sb = make_unique_vcd<StreamBlock>();
+  ssize_t read_size = -1;
+  if (sb->resize(it->second.size_)) {
+    read_size = ::pread(spill_fd_, sb->buf(), static_cast<size_t>(it->second.size_), it->second.offset_);
+  }
+  if (read_size != static_cast<ssize_t>(it->second.size_) || !sb->size(it->second.size_)) {
+    LOG(WARNING) << "Failed to read the segment from spill file, key=" << key << std::endl;
+    spill_index_.erase(it);
+    return nullptr;
+  }
+  std::shared_ptr<SharedStreamBlocks> data = std::make_shared<SharedStreamBlocks>();
+  data->push_back(std::move(sb));
+  // the bytes stay in the file until it restarts, the index entry is kept so it won't be written twice
+  return data;
+}
+
+void OmafSegmentCache::resetSpill(void) noexcept {
+  spill_index_.clear();
+  spill_end_ = 0;
+  if (spill_fd_ >= 0 && ::ftruncate(spill_fd_, 0) != 0) {
+    LOG(WARNING) << "Failed to truncate the segment spill file: " << params_.spill_file_ << std::endl;
+  }
+}
+
+}  // namespace OMAF
+}  // namespace VCD
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ */
+
+//!
+//! \file:   OmafSegmentCache.h
+//! \brief:  in-memory segment cache with LRU eviction
+//! \detail: downloaded segments are kept in memory keyed by url and byte range,
+//!          so seeking back or viewport reversal won't fetch them again. the least
+//!          recently used ones are evicted when the byte budget is exceeded, and they
+//!          can optionally spill to a single append-only file
+//!
+#ifndef OMAFSEGMENTCACHE_H
+#define OMAFSEGMENTCACHE_H
+
+#include "../../utils/error.h"
+#include "../common.h"  // VCD::NonCopyable
+#include "../OmafTypes.h"
+#include "Stream.h"  // VCD::OMAF::SharedStreamBlocks
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace VCD {
+namespace OMAF {
+
+class OmafSegmentCache : public VCD::NonCopyable {
+ public:
+  using Ptr = std::shared_ptr<OmafSegmentCache>;
+  // the blocks are shared with the segments reading them
+  using Buffer = std::shared_ptr<const SharedStreamBlocks>;
+
+  struct _cacheStatistics {
+    size_t memory_hits_ = 0;
+    size_t spill_hits_ = 0;
+    size_t misses_ = 0;
+    size_t evictions_ = 0;
+    size_t entries_ = 0;
+    int64_t memory_bytes_ = 0;
+    int64_t spill_bytes_ = 0;
+    std::string to_string() {
+      std::stringstream ss;
+      ss << "segment cache: { hits: memory=" << memory_hits_ << ", spill=" << spill_hits_;
+      ss << ", misses=" << misses_ << ", evictions=" << evictions_;
+      ss << ", entries=" << entries_ << ", memory=" << memory_bytes_ << " bytes";
+      ss << ", spill=" << spill_bytes_ << " bytes}";
+      return ss.str();
+    }
+  };
+  using CacheStatistics = struct _cacheStatistics;
+
+ public:
+  OmafSegmentCache(const OmafDashCacheParams &params);
+  virtual ~OmafSegmentCache();
+
+ public:
+  //!
+  //! \brief  the cache key of the segment, the byte range is part of it when
+  //!         only a range of the url is fetched
+  //!
+  static std::string key(const std::string &url, int64_t offset = -1, int64_t size = -1) noexcept;
+
+  //!
+  //! \brief  look up the segment, the hit one becomes the most recently used.
+  //!         the one in spill file is read back into memory
+  //!
+  //! \return Buffer
+  //!         the segment data, nullptr when missed
+  //!
+  Buffer get(const std::string &key) noexcept;
+
+  //!
+  //! \brief  add the segment, the least recently used ones are evicted until
+  //!         it fits in the memory budget
+  //!
+  OMAF_STATUS put(const std::string &key, Buffer data) noexcept;
+
+  bool contains(const std::string &key) noexcept;
+  void clear() noexcept;
+  CacheStatistics statistics(void) noexcept;
+
+ private:
+  struct _cacheEntry {
+    Buffer data_;
+    std::list<std::string>::iterator lru_it_;
+  };
+  struct _spillEntry {
+    int64_t offset_ = 0;
+    int64_t size_ = 0;
+  };
+
+  // call with mutex_ locked
+  void insert(const std::string &key, Buffer data) noexcept;
+  void evict(int64_t required) noexcept;
+  void spill(const std::string &key, const Buffer &data) noexcept;
+  Buffer readSpill(const std::string &key) noexcept;
+  void resetSpill(void) noexcept;
+
+ private:
+  OmafDashCacheParams params_;
+  std::mutex mutex_;
+
+  //<! front is the most recently used
+  std::list<std::string> lru_;
+  std::unordered_map<std::string, struct _cacheEntry> entries_;
+  int64_t memory_bytes_ = 0;
+
+  //<! evicted segments are appended to the file, it restarts when the budget is used up
+  int spill_fd_ = -1;
+  int64_t spill_end_ = 0;
+  std::unordered_map<std::string, struct _spillEntry> spill_index_;
+
+  CacheStatistics stats_;
+};
+
+}  // namespace OMAF
+}  // namespace VCD
+
+#endif  // OMAFSEGMENTCACHE_H
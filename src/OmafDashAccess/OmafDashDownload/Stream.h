@@ -33,8 +33,16 @@
 #ifndef STREAM_H
 #define STREAM_H
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <fstream>
+#include <memory>
 #include <mutex>  //std::mutex, std::unique_lock
+#include <string>
+#include <vector>
 
 #include "../OmafDashParser/Common.h"
 #include "../common.h"
@@ -59,6 +67,15 @@ class StreamBlock : public VCD::NonCopyable {
 
   StreamBlock(char *data, int64_t size) : data_(data), size_(size), capacity_(size), bOwner_(false) {}
   //!
+  //! \brief Constructor of a read-only view of the shared block, which is kept alive along with the view
+  //!
+  StreamBlock(std::shared_ptr<const StreamBlock> shared)
+      : data_(const_cast<char *>(shared->cbuf())),
+        size_(shared->size()),
+        capacity_(shared->size()),
+        bOwner_(false),
+        shared_(std::move(shared)) {}
+  //!
   //! \brief Destructor
   //!
   ~StreamBlock() {
@@ -105,6 +122,42 @@ private:
   int64_t size_ = 0;
   int64_t capacity_ = 0;
   const bool bOwner_ = true;
+  // the block viewed by this one
+  std::shared_ptr<const StreamBlock> shared_;
+};
+
+//!
+//! \class  SharedStreamBlocks
+//! \brief  the received blocks of one segment, shared by the segment cache and the
+//!         segments reading them, so the data is copied neither for caching nor for a hit
+//!
+class SharedStreamBlocks : public VCD::NonCopyable {
+ public:
+  using Block = std::shared_ptr<const StreamBlock>;
+
+  SharedStreamBlocks() = default;
+  ~SharedStreamBlocks() {}
+
+ public:
+  void push_back(Block block) noexcept {
+    size_ += block->size();
+    blocks_.push_back(std::move(block));
+  }
+  //!
+  //! \brief  keep the received block, the view of it goes on to the reader
+  //!
+  std::unique_ptr<StreamBlock> share(std::unique_ptr<StreamBlock> sb) noexcept {
+    Block block(std::move(sb));
+    push_back(block);
+    return make_unique_vcd<StreamBlock>(std::move(block));
+  }
+  const std::vector<Block> &blocks() const noexcept { return blocks_; }
+  int64_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+ private:
+  std::vector<Block> blocks_;
+  int64_t size_ = 0;
 };
 
 class StreamBlocks : public VCD::NonCopyable, public VCD::MP4::StreamIO {
@@ -170,31 +223,114 @@ class StreamBlocks : public VCD::NonCopyable, public VCD::MP4::StreamIO {
     stream_blocks_.push_back(std::move(sb));
   }
 
-  bool cacheToFile(std::string &filename) noexcept {
-    std::ofstream of;  //<! file handle for writing
-    try {
-      of.open(filename, ios::out | ios::binary);
+ private:
+  std::list<std::unique_ptr<StreamBlock>> stream_blocks_;
 
-      for (auto &sb : stream_blocks_) {
-        of.write(sb->cbuf(), sb->size());
-      }
+  std::mutex stream_mutex_;
+  offset_t stream_size_ = 0;
+  offset_t offset_ = 0;
+};
+
+//!
+//! \class  MappedFileStream
+//! \brief  read-only stream over a local file mapped into memory, samples are
+//!         read from the page cache without the file being copied into heap
+//!
+class MappedFileStream : public VCD::NonCopyable, public VCD::MP4::StreamIO {
+ public:
+  MappedFileStream() = default;
+  ~MappedFileStream() { close(); }
 
-      of.close();
+ public:
+  //!
+  //! \brief  map the whole file, the kernel is told to read it ahead
+  //!         sequentially since the segment is parsed from begin to end
+  //!
+  //! \return bool
+  //!         true if the file is mapped, else false
+  //!
+  bool open(const std::string &file_name) noexcept {
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    if (data_ != nullptr) {
       return true;
-    } catch (const std::exception &ex) {
-      LOG(ERROR) << "Exception when cache the file: " << filename << ", ex: " << ex.what() << std::endl;
-      if (of.is_open()) {
-        of.close();
-      }
+    }
+
+    int fd = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+      ::close(fd);
       return false;
     }
+
+    opened_ = true;
+    offset_ = 0;
+    size_ = static_cast<offset_t>(st.st_size);
+    if (size_ > 0) {
+      void *addr = ::mmap(nullptr, static_cast<size_t>(size_), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        opened_ = false;
+        size_ = 0;
+        return false;
+      }
+      data_ = static_cast<const char *>(addr);
+      ::madvise(addr, static_cast<size_t>(size_), MADV_SEQUENTIAL);
+      ::madvise(addr, static_cast<size_t>(size_), MADV_WILLNEED);
+    }
+    // the mapping holds its own reference to the file
+    ::close(fd);
+    return true;
   }
 
- private:
-  std::list<std::unique_ptr<StreamBlock>> stream_blocks_;
+  void close() noexcept {
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char *>(data_), static_cast<size_t>(size_));
+      data_ = nullptr;
+    }
+    opened_ = false;
+    size_ = 0;
+    offset_ = 0;
+  }
+
+  bool is_open() const noexcept { return opened_; }
+
+  //<! the mapped file content, valid until close
+  const char *data() const noexcept { return data_; }
+
+ public:
+  offset_t ReadStream(char *buffer, offset_t size) {
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    if (buffer == nullptr || size <= 0 || offset_ >= size_) {
+      return 0;
+    }
+    offset_t readSize = std::min(size, size_ - offset_);
+    memcpy_s(buffer, readSize, data_ + offset_, readSize);
+    offset_ += readSize;
+    return readSize;
+  };
+
+  bool SeekAbsoluteOffset(offset_t offset) {
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    if (offset < 0 || offset > size_) {
+      return false;
+    }
+    offset_ = offset;
+    return true;
+  };
 
+  offset_t TellOffset() { return offset_; };
+
+  offset_t GetStreamSize() { return size_; };
+
+ private:
   std::mutex stream_mutex_;
-  offset_t stream_size_ = 0;
+  const char *data_ = nullptr;
+  bool opened_ = false;
+  offset_t size_ = 0;
   offset_t offset_ = 0;
 };
 }  // namespace OMAF
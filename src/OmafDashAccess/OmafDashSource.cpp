@@ -30,6 +30,8 @@
 #include <dirent.h>
 #include <math.h>
 #include <string.h>
+#include <algorithm>
+#include <chrono>
 #include "OmafExtractorTracksSelector.h"
 #include "OmafReaderManager.h"
 #include "OmafTileTracksSelector.h"
@@ -43,7 +45,8 @@
 
 VCD_OMAF_BEGIN
 
-#define MAX_CACHE_SIZE 100 * 1024 * 1024
+// the init segments of all tracks should be parsed in it before the playback starts
+const int32_t INIT_SEGMENT_WAIT_TIME = 3000;  // ms
 
 OmafDashSource::OmafDashSource() {
   mMPDParser = nullptr;
@@ -59,9 +62,21 @@ OmafDashSource::OmafDashSource() {
   dcount = 1;
   mPreExtractorID = 0;
   m_stitch = nullptr;
+
+  std::shared_ptr<VCD::VRVideo::MetricsRegistry> metrics = stage_timings_->Metrics();
+  metric_get_packet_ = metrics->Histogram("get_packet_microseconds", "time spent in feeding packets to decoder");
+  metric_packets_ = metrics->Counter("packets_total", "packets fed to decoder");
+  metric_buffered_segments_ = metrics->Gauge("buffered_segments", "segments downloaded and not parsed yet");
+  metric_bandwidth_ = metrics->Gauge("estimated_bandwidth_bps", "throughput estimated by the abr controller");
 }
 
 OmafDashSource::~OmafDashSource() {
+  if (abr_controller_) {
+    DOWNLOADMANAGER::GetInstance()->RemoveAbrController(abr_controller_);
+  }
+  if (segment_cache_) {
+    LOG(INFO) << segment_cache_->statistics().to_string() << std::endl;
+  }
   SAFE_DELETE(mMPDParser);
   // SAFE_DELETE(mSelector);
   SAFE_DELETE(m_selector);
@@ -69,6 +84,10 @@ OmafDashSource::~OmafDashSource() {
   mViewPorts.clear();
   ClearStreams();
   SAFE_DELETE(m_stitch);
+  for (auto stitch : warm_stitches_) {
+    SAFE_DELETE(stitch);
+  }
+  warm_stitches_.clear();
 }
 
 int OmafDashSource::SyncTime(std::string url) {
@@ -98,6 +117,74 @@ int OmafDashSource::SyncTime(std::string url) {
   return ret;
 }
 
+int OmafDashSource::CreateDashClient(std::string url, std::string cacheDir) {
+  int ret = ERROR_NONE;
+
+  OmafDashSegmentHttpClient::Ptr http_source =
+      OmafDashSegmentHttpClient::create(omaf_dash_params_.max_parallel_transfers_);
+  if (http_source) {
+    http_source->setProxy(omaf_dash_params_.http_proxy_);
+    http_source->setParams(omaf_dash_params_.http_params_);
+    if (omaf_dash_params_.stats_params_.enable_) {
+      http_source->setStatisticsWindows(omaf_dash_params_.stats_params_.window_size_ms_);
+    }
+    OmafAbrController::Ptr abr;
+    if (omaf_dash_params_.abr_params_.enable_) {
+      abr = std::make_shared<OmafAbrController>(omaf_dash_params_.abr_params_);
+      abr_controller_ = abr;
+      DOWNLOADMANAGER::GetInstance()->AddAbrController(abr);
+    }
+    OmafStageTimings::Ptr timings = stage_timings_;
+    VCD::VRVideo::MetricCounter* download_bytes =
+        timings->Metrics()->Counter("download_bytes_total", "bytes of the segment transfers");
+    http_source->setTransferObserver([abr, timings, download_bytes](size_t transfer_bytes, long download_time_us) {
+      timings->Add(OmafStageTimings::Stage::DOWNLOAD, static_cast<uint64_t>(std::max(download_time_us, 0L)));
+      if (download_bytes) download_bytes->Add(transfer_bytes);
+      if (abr) abr->AddTransfer(transfer_bytes, download_time_us);
+    });
+    if (omaf_dash_params_.cache_params_.enable_) {
+      OmafDashCacheParams cache_params = omaf_dash_params_.cache_params_;
+      if (cache_params.enable_spill_ && cache_params.spill_file_.empty() && cacheDir.size()) {
+        cache_params.spill_file_ = cacheDir + "/segments.spill";
+      }
+      OmafSegmentCache::Ptr cache = std::make_shared<OmafSegmentCache>(cache_params);
+      http_source->setSegmentCache(cache);
+      segment_cache_ = std::move(cache);
+    }
+    if (omaf_dash_params_.cache_params_.enable_init_cache_) {
+      std::string init_cache_dir = omaf_dash_params_.cache_params_.init_cache_dir_;
+      if (init_cache_dir.empty() && cacheDir.size()) {
+        init_cache_dir = cacheDir + "/init";
+      }
+      if (init_cache_dir.size()) {
+        http_source->setInitSegmentCache(std::make_shared<OmafInitSegmentCache>(init_cache_dir));
+      }
+    }
+  }
+  else
+  {
+    LOG(ERROR) << "http source failed to create!" << std::endl;
+    return ERROR_NULL_PTR;
+  }
+  ret = http_source->start();
+  if (ERROR_NONE != ret) {
+    LOG(ERROR) << "Failed to start the client for omaf dash segment http source, err=" << ret << std::endl;
+    return ret;
+  }
+
+  // open the connections to the origin while parsing the mpd
+  if (omaf_dash_params_.http_params_.warmup_connections_ > 0) {
+    ret = http_source->warmup(url, omaf_dash_params_.http_params_.warmup_connections_);
+    if (ERROR_NONE != ret) {
+      LOG(WARNING) << "Failed to warmup the connections for url: " << url << ", err=" << ret << std::endl;
+    }
+  }
+
+  dash_client_ = std::move(http_source);
+
+  return ERROR_NONE;
+}
+
 int OmafDashSource::OpenMedia(std::string url, std::string cacheDir, bool enableExtractor, bool enablePredictor,
                               std::string predictPluginName, std::string libPath) {
   DIR* dir = opendir(cacheDir.c_str());
@@ -133,35 +220,19 @@ int OmafDashSource::OpenMedia(std::string url, std::string cacheDir, bool enable
   DownloadManager* pDM = DOWNLOADMANAGER::GetInstance();
 
   if (!isLocalMedia) {
-    pDM->SetMaxCacheSize(MAX_CACHE_SIZE);
-
     pDM->SetCacheFolder(cacheDir);
 
-    OmafDashSegmentHttpClient::Ptr http_source =
-        OmafDashSegmentHttpClient::create(omaf_dash_params_.max_parallel_transfers_);
-    if (http_source) {
-      http_source->setProxy(omaf_dash_params_.http_proxy_);
-      http_source->setParams(omaf_dash_params_.http_params_);
-      if (omaf_dash_params_.stats_params_.enable_) {
-        http_source->setStatisticsWindows(omaf_dash_params_.stats_params_.window_size_ms_);
-      }
-    }
-    else
-    {
-      LOG(ERROR) << "http source failed to create!" << std::endl;
-      return ERROR_NULL_PTR;
-    }
-    ret = http_source->start();
-    if (ERROR_NONE != ret) {
-      LOG(ERROR) << "Failed to start the client for omaf dash segment http source, err=" << ret << std::endl;
-      return ret;
+    // the client is kept when switching the media, along with its connections
+    if (dash_client_ == nullptr) {
+      ret = CreateDashClient(url, cacheDir);
+      if (ERROR_NONE != ret) return ret;
     }
-
-    dash_client_ = std::move(http_source);
   }
 
   mMPDParser = new OmafMPDParser();
   if (nullptr == mMPDParser) return ERROR_NULL_PTR;
+  mMPDParser->SetTilesStitches(std::move(warm_stitches_));
+  warm_stitches_.clear();
   mMPDParser->SetOmafDashParams(omaf_dash_params_);
   mMPDParser->SetExtractorEnabled(enableExtractor);
 
@@ -232,6 +303,7 @@ int OmafDashSource::OpenMedia(std::string url, std::string cacheDir, bool enable
     LOG(INFO) << "media stream extractor=" << enableExtractor << std::endl;
 
     OmafReaderManager::Ptr omaf_reader_mgr = std::make_shared<OmafReaderManager>(dash_client_, params);
+    omaf_reader_mgr->SetStageTimings(stage_timings_);
     ret = omaf_reader_mgr->Initialize(this);
     if (ERROR_NONE != ret) {
       LOG(ERROR) << "Failed to start the omaf reader manager, err=" << ret << std::endl;
@@ -264,6 +336,8 @@ int OmafDashSource::OpenMedia(std::string url, std::string cacheDir, bool enable
   }
 
   m_selector->SetProjectionFmt(projFmt);
+  m_selector->SetAbrController(abr_controller_);
+  m_selector->SetMinViewProbability(omaf_dash_params_.prediector_params_.min_view_probability_);
   if (enablePredictor) m_selector->EnablePosePrediction(predictPluginName, libPath);
   // Setup initial Viewport and select Adaption Set
   auto it = mMapStream.begin();
@@ -319,7 +393,108 @@ int OmafDashSource::CloseMedia() {
   return ERROR_NONE;
 }
 
+bool OmafDashSource::EnterCall() {
+  std::lock_guard<std::mutex> lock(switch_mutex_);
+  if (switching_) return false;
+  active_calls_++;
+  return true;
+}
+
+void OmafDashSource::LeaveCall() {
+  std::lock_guard<std::mutex> lock(switch_mutex_);
+  if (--active_calls_ == 0) switch_cv_.notify_all();
+}
+
+int OmafDashSource::SwitchMedia(std::string url, std::string cacheDir, bool enableExtractor, bool enablePredictor,
+                                std::string predictPluginName, std::string libPath) {
+  {
+    // the new calls are rejected and the running ones are waited for, they use the objects to be released
+    std::unique_lock<std::mutex> lock(switch_mutex_);
+    if (switching_) {
+      LOG(ERROR) << "The media is being switched already!" << std::endl;
+      return ERROR_INVALID;
+    }
+    switching_ = true;
+    switch_cv_.wait(lock, [this] { return active_calls_ == 0; });
+  }
+
+  int ret = switchMedia(url, cacheDir, enableExtractor, enablePredictor, predictPluginName, libPath);
+
+  std::lock_guard<std::mutex> lock(switch_mutex_);
+  switching_ = false;
+  return ret;
+}
+
+int OmafDashSource::switchMedia(std::string url, std::string cacheDir, bool enableExtractor, bool enablePredictor,
+                                std::string predictPluginName, std::string libPath) {
+  auto switch_start = std::chrono::steady_clock::now();
+  LOG(INFO) << "Switch the media to " << url << std::endl;
+
+  if (STATUS_STOPPED != this->GetStatus()) this->StopThread();
+
+  // the callbacks of the tasks refer to the segments of the previous media, so they go first.
+  // the client is kept with its connections, workers and caches
+  if (dash_client_ != nullptr) {
+    dash_client_->removeAll();
+  }
+
+  if (omaf_reader_mgr_ != nullptr) {
+    omaf_reader_mgr_->Close();
+    omaf_reader_mgr_.reset();
+  }
+
+  // keep the tiles stitches, their 360SCVP library handles are reused by the new streams
+  for (auto stitch : warm_stitches_) {
+    SAFE_DELETE(stitch);
+  }
+  warm_stitches_.clear();
+  for (auto it : mMapStream) {
+    OmafMediaStream* stream = it.second;
+    stream->Close();
+    OmafTilesStitch* stitch = stream->DetachTilesStitch();
+    if (stitch) {
+      stitch->Reset();
+      warm_stitches_.push_back(stitch);
+    }
+  }
+  ClearStreams();
+
+  SAFE_DELETE(m_selector);
+  SAFE_DELETE(mMPDinfo);
+  mEOS = false;
+  mPreExtractorID = 0;
+  this->SetStatus(STATUS_CREATED);
+
+  int ret = OpenMedia(url, cacheDir, enableExtractor, enablePredictor, predictPluginName, libPath);
+  if (ERROR_NONE != ret) {
+    LOG(ERROR) << "Failed to switch the media to " << url << ", err=" << ret << std::endl;
+    return ret;
+  }
+
+  LOG(INFO) << "Switched the media in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - switch_start)
+                   .count()
+            << " ms" << std::endl;
+  return ERROR_NONE;
+}
+
 int OmafDashSource::GetPacket(int streamID, std::list<MediaPacket*>* pkts, bool needParams, bool clearBuf) {
+  // no packet while switching, the decoder polls again as when nothing is ready
+  if (!EnterCall()) return ERROR_NULL_PACKET;
+  VCD::VRVideo::MetricTimer feed_timer(metric_get_packet_);
+  size_t pktsCount = pkts->size();
+  int ret = getPacket(streamID, pkts, needParams, clearBuf);
+  LeaveCall();
+  if (pkts->size() == pktsCount) {
+    // nothing is ready, the decoder will poll again
+    feed_timer.Cancel();
+  } else if (metric_packets_) {
+    metric_packets_->Add(pkts->size() - pktsCount);
+  }
+  return ret;
+}
+
+int OmafDashSource::getPacket(int streamID, std::list<MediaPacket*>* pkts, bool needParams, bool clearBuf) {
   OmafMediaStream* pStream = this->GetStream(streamID);
 
   MediaPacket* pkt = nullptr;
@@ -369,7 +544,11 @@ int OmafDashSource::GetPacket(int streamID, std::list<MediaPacket*>* pkts, bool
     } else {
       std::list<MediaPacket*> mergedPackets;
       pStream->SetNeedVideoParams(needParams);
-      mergedPackets = pStream->GetOutTilesMergedPackets();
+      {
+        OmafStageTimer timer(stage_timings_.get(), OmafStageTimings::Stage::STITCH);
+        mergedPackets = pStream->GetOutTilesMergedPackets();
+        if (mergedPackets.empty()) timer.Cancel();
+      }
 
       std::list<MediaPacket*>::iterator itPacket;
       for (itPacket = mergedPackets.begin(); itPacket != mergedPackets.end(); itPacket++) {
@@ -394,24 +573,71 @@ int OmafDashSource::GetStatistic(DashStatisticInfo* dsInfo) {
     if (perf_stats) {
       dsInfo->avg_bandwidth = static_cast<int32_t>(perf_stats->download_speed_bps_);
     }
+    if (abr_controller_) {
+      // the measured throughput, the conservative estimation is for the tile selection only
+      dsInfo->immediate_bandwidth = static_cast<int32_t>(abr_controller_->GetFastBandwidth());
+    }
   }
 
 #endif
   return ERROR_NONE;
 }
 
+int OmafDashSource::SwapPredictPlugin(std::string predictPluginName, std::string libPath) {
+  if (!EnterCall()) return ERROR_INVALID;
+  int ret = ERROR_INVALID;
+  if (!m_selector) {
+    LOG(ERROR) << "Media isn't opened, no predict plugin to swap!" << std::endl;
+  } else {
+    ret = m_selector->SwapPredictPlugin(predictPluginName, libPath);
+  }
+  LeaveCall();
+  return ret;
+}
+
+int OmafDashSource::GetPredictPluginStats(PluginTimingStats* stats) {
+  if (!EnterCall()) return ERROR_INVALID;
+  int ret = m_selector ? m_selector->GetPredictPluginStats(stats) : ERROR_INVALID;
+  LeaveCall();
+  return ret;
+}
+
+int OmafDashSource::GetStageTimings(DashStageTimings* timings) {
+  if (!timings) return ERROR_NULL_PTR;
+  stage_timings_->Get(timings);
+  return ERROR_NONE;
+}
+
+int OmafDashSource::GetMetrics(MetricValue* values, int32_t* count) {
+  return stage_timings_->Metrics()->Snapshot(values, count);
+}
+
+std::string OmafDashSource::DumpMetrics(std::string prefix) {
+  return stage_timings_->Metrics()->DumpPrometheus(prefix);
+}
+
 int OmafDashSource::SetupHeadSetInfo(HeadSetInfo* clientInfo) {
   memcpy_s(&mHeadSetInfo, sizeof(HeadSetInfo), clientInfo, sizeof(HeadSetInfo));
   return ERROR_NONE;
 }
 
 int OmafDashSource::ChangeViewport(HeadPose* pose) {
-  int ret = m_selector->UpdateViewport(pose);
+  // the pose during switching is dropped, the new media starts from the headset info
+  if (!EnterCall()) return ERROR_INVALID;
+  int ret = m_selector ? m_selector->UpdateViewport(pose) : ERROR_INVALID;
+  LeaveCall();
 
   return ret;
 }
 
 int OmafDashSource::GetMediaInfo(DashMediaInfo* media_info) {
+  if (!EnterCall()) return ERROR_INVALID;
+  int ret = getMediaInfo(media_info);
+  LeaveCall();
+  return ret;
+}
+
+int OmafDashSource::getMediaInfo(DashMediaInfo* media_info) {
   MPDInfo* mInfo = this->GetMPDInfo();
   if (!mInfo) return ERROR_NULL_PTR;
 
@@ -492,6 +718,31 @@ int OmafDashSource::TimedDownloadSegment(bool bFirst) {
   return ERROR_NONE;
 }
 
+void OmafDashSource::TimedWaitSegment(uint32_t segment_request_time, uint32_t wait_time) {
+  const OmafDashSubSegmentParams& params = omaf_dash_params_.sub_segment_params_;
+  if (!params.enable_ || params.check_interval_ms_ <= 0) {
+    ::usleep(wait_time * 1000);
+    return;
+  }
+
+  uint32_t end_time = sys_clock() + wait_time;
+  while (STATUS_EXITING != GetStatus()) {
+    uint32_t now = sys_clock();
+    if (now >= end_time) break;
+
+    uint32_t slice = std::min(end_time - now, static_cast<uint32_t>(params.check_interval_ms_));
+    ::usleep(slice * 1000);
+
+    if (ERROR_NONE != TimedSelectSegements()) continue;
+
+    // the latest segment is expected to play from its request, so the elapsed time is the play position
+    int64_t start_ms = static_cast<int64_t>(sys_clock() - segment_request_time);
+    for (auto it = mMapStream.begin(); it != mMapStream.end(); it++) {
+      it->second->DownloadSubSegments(start_ms, params.index_probe_size_);
+    }
+  }
+}
+
 int OmafDashSource::StartReadThread() {
   int ret = TimedSelectSegements();
   if (ERROR_NONE != ret) return ret;
@@ -533,15 +784,31 @@ int OmafDashSource::TimedSelectSegements() {
   int ret = ERROR_NONE;
   if (nullptr == m_selector) return ERROR_NULL_PTR;
 
+  if (omaf_reader_mgr_ && metric_buffered_segments_) {
+    metric_buffered_segments_->Set(static_cast<int64_t>(omaf_reader_mgr_->GetBufferedSegmentCount()));
+  }
+  UpdateAbrBufferLevel();
+
   std::map<int, OmafMediaStream*>::iterator it;
   for (it = this->mMapStream.begin(); it != this->mMapStream.end(); it++) {
     OmafMediaStream* pStream = it->second;
+    OmafStageTimer timer(stage_timings_.get(), OmafStageTimings::Stage::SELECT);
     ret = m_selector->SelectTracks(pStream);
+    timer.SetFailed(ERROR_NONE != ret);
     if (ERROR_NONE != ret) break;
   }
   return ret;
 }
 
+void OmafDashSource::UpdateAbrBufferLevel() {
+  if (!abr_controller_ || !omaf_reader_mgr_ || mMapStream.empty()) return;
+
+  // segment duration is in second
+  int64_t buffer_ms = static_cast<int64_t>(omaf_reader_mgr_->GetBufferedSegmentCount() * GetSegmentDuration(0) * 1000);
+  abr_controller_->SetBufferLevel(buffer_ms);
+  if (metric_bandwidth_) metric_bandwidth_->Set(static_cast<int64_t>(abr_controller_->GetEstimatedBandwidth()));
+}
+
 void OmafDashSource::ClearStreams() {
   std::map<int, OmafMediaStream*>::iterator it;
   for (it = this->mMapStream.begin(); it != this->mMapStream.end(); it++) {
@@ -619,19 +886,10 @@ void OmafDashSource::thread_dynamic() {
     SetStatus(STATUS_STOPPED);
     return;
   }
-  uint32_t wait_time = 3000;
-  uint32_t current_wait_time = 0;
-  bool isInitSegParsed = omaf_reader_mgr_->IsInitSegmentsParsed();
-  while (!isInitSegParsed) {
-    ::usleep(1000);
-    current_wait_time++;
-    if (current_wait_time > wait_time)
-    {
-      SetStatus(STATUS_STOPPED);
-      LOG(ERROR) << " Time out for waiting init segment parse! " << endl;
-      return;
-    }
-    isInitSegParsed = omaf_reader_mgr_->IsInitSegmentsParsed();
+  if (ERROR_NONE != omaf_reader_mgr_->WaitInitSegmentsParsed(INIT_SEGMENT_WAIT_TIME)) {
+    SetStatus(STATUS_STOPPED);
+    LOG(ERROR) << " Failed to wait for the init segments parsed! " << endl;
+    return;
   }
 
   while ((ERROR_NONE != StartReadThread())) {
@@ -674,7 +932,7 @@ void OmafDashSource::thread_dynamic() {
     // uint32_t wait_time = (info.max_segment_duration * 3) / 4 - interval;
     uint32_t wait_time = mMPDinfo->max_segment_duration > interval ? mMPDinfo->max_segment_duration - interval : 0;
 
-    ::usleep(wait_time * 1000);
+    TimedWaitSegment(uLastSegTime, wait_time);
 
     uLastSegTime = sys_clock();
   }
@@ -699,19 +957,10 @@ void OmafDashSource::thread_static() {
     SetStatus(STATUS_STOPPED);
     return;
   }
-  uint32_t wait_time = 3000;
-  uint32_t current_wait_time = 0;
-  bool isInitSegParsed = omaf_reader_mgr_->IsInitSegmentsParsed();
-  while (!isInitSegParsed) {
-    ::usleep(1000);
-    current_wait_time++;
-    if (current_wait_time > wait_time)
-    {
-      SetStatus(STATUS_STOPPED);
-      LOG(ERROR) << " Time out for waiting init segment parse! " << endl;
-      return;
-    }
-    isInitSegParsed = omaf_reader_mgr_->IsInitSegmentsParsed();
+  if (ERROR_NONE != omaf_reader_mgr_->WaitInitSegmentsParsed(INIT_SEGMENT_WAIT_TIME)) {
+    SetStatus(STATUS_STOPPED);
+    LOG(ERROR) << " Failed to wait for the init segments parsed! " << endl;
+    return;
   }
 
   while ((ERROR_NONE != StartReadThread())) {
@@ -758,7 +1007,7 @@ void OmafDashSource::thread_static() {
     // interval) : 0;
     uint32_t wait_time = mMPDinfo->max_segment_duration > interval ? mMPDinfo->max_segment_duration - interval : 0;
 
-    ::usleep(wait_time * 1000);
+    TimedWaitSegment(uLastSegTime, wait_time);
 
     uLastSegTime = sys_clock();
 
@@ -44,6 +44,9 @@
 #include "DownloadManager.h"
 #include "OmafTracksSelector.h"
 #include "OmafTilesStitch.h"
+#include "OmafStageTimings.h"
+#include <condition_variable>
+#include <list>
 #include <mutex>
 
 using namespace VCD::OMAF;
@@ -71,8 +74,15 @@ class OmafDashSource : public OmafMediaSource, Threadable {
   virtual int OpenMedia(std::string url, std::string cacheDir, bool enableExtractor = true,
                         bool enablePredictor = false, std::string predictPluginName = "", std::string libPath = "");
   virtual int CloseMedia();
+  virtual int SwitchMedia(std::string url, std::string cacheDir, bool enableExtractor = true,
+                          bool enablePredictor = false, std::string predictPluginName = "", std::string libPath = "");
   virtual int GetPacket(int streamID, std::list<MediaPacket*>* pkts, bool needParams, bool clearBuf);
   virtual int GetStatistic(DashStatisticInfo* dsInfo);
+  virtual int SwapPredictPlugin(std::string predictPluginName, std::string libPath);
+  virtual int GetPredictPluginStats(PluginTimingStats* stats);
+  virtual int GetStageTimings(DashStageTimings* timings);
+  virtual int GetMetrics(MetricValue* values, int32_t* count);
+  virtual std::string DumpMetrics(std::string prefix);
   virtual int SetupHeadSetInfo(HeadSetInfo* clientInfo);
   virtual int ChangeViewport(HeadPose* pose);
   virtual int GetMediaInfo(DashMediaInfo* media_info);
@@ -89,6 +99,29 @@ class OmafDashSource : public OmafMediaSource, Threadable {
   //!
   int TimedSelectSegements();
 
+  //!
+  //! \brief get packets of the stream, GetPacket times it for the decode feed
+  //!
+  int getPacket(int streamID, std::list<MediaPacket*>* pkts, bool needParams, bool clearBuf);
+
+  //!
+  //! \brief get the information of the opened media, GetMediaInfo runs it out of switching
+  //!
+  int getMediaInfo(DashMediaInfo* media_info);
+
+  //!
+  //! \brief replace the media objects by the new media, SwitchMedia runs it with the calls drained
+  //!
+  int switchMedia(std::string url, std::string cacheDir, bool enableExtractor, bool enablePredictor,
+                  std::string predictPluginName, std::string libPath);
+
+  //!
+  //! \brief the calls using the media objects enter the source before and leave after them,
+  //!        EnterCall rejects them while switching the media
+  //!
+  bool EnterCall();
+  void LeaveCall();
+
   //!
   //! \brief
   //!
@@ -104,6 +137,13 @@ class OmafDashSource : public OmafMediaSource, Threadable {
   //!
   int TimedDownloadSegment(bool bFirst);
 
+  //!
+  //! \brief wait for the next segment request, the viewport is checked in the
+  //!        wait when sub-segment fetching is enabled, so the tiles turned into
+  //!        viewport are fetched from the next subsegment
+  //!
+  void TimedWaitSegment(uint32_t segment_request_time, uint32_t wait_time);
+
   //!
   //! \brief run thread for dynamic mpd processing
   //!
@@ -159,8 +199,18 @@ class OmafDashSource : public OmafMediaSource, Threadable {
 
   int SyncTime(std::string url);
 
+  //!
+  //! \brief create and start the http client of the session, along with abr and caches
+  //!
+  int CreateDashClient(std::string url, std::string cacheDir);
+
   int StartReadThread();
 
+  //!
+  //! \brief feed the buffer level, in media duration of parsed segments, to abr
+  //!
+  void UpdateAbrBufferLevel();
+
 private:
     OmafDashSource& operator=(const OmafDashSource& other) { return *this; };
     OmafDashSource(const OmafDashSource& other) { /* do not create copies */ };
@@ -174,8 +224,21 @@ private:
   int dcount;
   int mPreExtractorID;
   OmafTilesStitch* m_stitch = nullptr;
+  std::list<OmafTilesStitch*> warm_stitches_;  //<! tiles stitches kept from the previous media when switching
   std::shared_ptr<OmafDashSegmentClient> dash_client_;
   std::shared_ptr<OmafReaderManager> omaf_reader_mgr_;
+  std::shared_ptr<OmafAbrController> abr_controller_;
+  std::shared_ptr<OmafSegmentCache> segment_cache_;
+  std::shared_ptr<OmafStageTimings> stage_timings_ = std::make_shared<OmafStageTimings>();
+  //<! metrics in the registry of stage_timings_
+  VCD::VRVideo::MetricHistogram* metric_get_packet_ = nullptr;
+  VCD::VRVideo::MetricCounter* metric_packets_ = nullptr;
+  VCD::VRVideo::MetricGauge* metric_buffered_segments_ = nullptr;
+  VCD::VRVideo::MetricGauge* metric_bandwidth_ = nullptr;
+  std::mutex switch_mutex_;            //<! guards switching_ and active_calls_
+  std::condition_variable switch_cv_;  //<! notified when the last running call leaves
+  bool switching_ = false;             //<! the media objects are being replaced by SwitchMedia
+  int32_t active_calls_ = 0;           //<! the calls running on the media objects
 };
 
 VCD_OMAF_END;
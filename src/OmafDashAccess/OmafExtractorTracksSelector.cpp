@@ -206,28 +206,18 @@ ListExtractor OmafExtractorTracksSelector::GetExtractorByPosePrediction(OmafMedi
       return extractors;
     }
   }
-  if (mPredictPluginMap.size() == 0) {
+  ViewportPredictPlugin* plugin = GetPredictPlugin();
+  if (!plugin) {
     LOG(ERROR) << "predict plugin map is empty!" << endl;
     return extractors;
   }
-  ViewportPredictPlugin* plugin = mPredictPluginMap.at(mPredictPluginName);
   uint32_t pose_interval = POSE_INTERVAL;
   uint32_t pre_pose_count = PREDICTION_POSE_COUNT;
   uint32_t predict_interval = PREDICTION_INTERVAL;
   plugin->Intialize(pose_interval, pre_pose_count, predict_interval);
-  std::list<ViewportAngle> pose_history;
-  {
-    std::lock_guard<std::mutex> lock(mMutex);
-    for (auto it = mPoseHistory.begin(); it != mPoseHistory.end(); it++) {
-      ViewportAngle angle;
-      angle.yaw = it->pose->yaw;
-      angle.pitch = it->pose->pitch;
-      angle.roll = 0;
-      pose_history.push_front(angle);
-    }
-  }
-  ViewportAngle* predict_angle = plugin->Predict(pose_history);
-  if (predict_angle == NULL) {
+  PredictedViewport predicted;
+  size_t poseCount = 0;
+  if (PredictPose(plugin, &predicted, &poseCount) != ERROR_NONE) {
     LOG(ERROR) << "predictPose_func return an invalid value!" << endl;
     return extractors;
   }
@@ -241,7 +231,7 @@ ListExtractor OmafExtractorTracksSelector::GetExtractorByPosePrediction(OmafMedi
     }
   }
   // won't get viewport if pose hasn't changed
-  if (previousPose && mPose && !IsDifferentPose(previousPose, mPose) && pose_history.size() > 1) {
+  if (previousPose && mPose && !IsDifferentPose(previousPose, mPose) && poseCount > 1) {
     LOG(INFO) << "pose hasn't changed!" << endl;
 #ifndef _ANDROID_NDK_OPTION_
 #ifdef _USE_TRACE_
@@ -250,13 +240,12 @@ ListExtractor OmafExtractorTracksSelector::GetExtractorByPosePrediction(OmafMedi
 #endif
 #endif
     SAFE_DELETE(previousPose);
-    SAFE_DELETE(predict_angle);
     return extractors;
   }
   // to select extractor;
   HeadPose* predictPose = new HeadPose;
-  predictPose->yaw = predict_angle->yaw;
-  predictPose->pitch = predict_angle->pitch;
+  predictPose->yaw = predicted.angle.yaw;
+  predictPose->pitch = predicted.angle.pitch;
   OmafExtractor* selectedExtractor = SelectExtractor(pStream, predictPose);
   if (selectedExtractor && previousPose) {
     extractors.push_back(selectedExtractor);
@@ -271,7 +260,6 @@ ListExtractor OmafExtractorTracksSelector::GetExtractorByPosePrediction(OmafMedi
   }
   SAFE_DELETE(previousPose);
   SAFE_DELETE(predictPose);
-  SAFE_DELETE(predict_angle);
   return extractors;
 }
 
@@ -379,6 +379,19 @@ int32_t OmafMP4VRReader::getTrackSampleOffset(uint32_t trackId, uint32_t sampleI
   return pReader->GetSampOffset(trackId, sampleId, sampleOffset, sampleLength);
 }
 
+int32_t OmafMP4VRReader::getSegmentSampleDescriptors(uint32_t trackId, uint32_t segmentId,
+                                                     std::vector<VCD::OMAF::SampleDescriptor>& sampleDescs) {
+  if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
+  VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+
+  VCD::MP4::VarLenArray<VCD::MP4::SampDescriptor> descs;
+  int32_t ret = pReader->GetSegSampDescs(trackId, segmentId, descs);
+  if (ret != ERROR_NONE) return ret;
+
+  sampleDescs.assign(descs.GetBegin(), descs.GetEnd());
+  return ERROR_NONE;
+}
+
 int32_t OmafMP4VRReader::getDecoderConfiguration(uint32_t trackId, uint32_t sampleId,
                                                  std::vector<VCD::OMAF::DecoderSpecificInfo>& decoderInfos) const {
   if (nullptr == mMP4ReaderImpl) return ERROR_NULL_PTR;
@@ -685,4 +698,19 @@ int32_t OmafMP4VRReader::invalidateSegment(uint32_t initSegmentId, uint32_t segm
   return pReader->DisableSeg(initSegmentId, segmentId);
 }
 
+int32_t OmafMP4VRReader::parseSegmentIndex(VCD::MP4::StreamIO* streamInterface,
+                                           std::vector<VCD::OMAF::SegmentInformation>& segIndex) {
+  if (nullptr == mMP4ReaderImpl || nullptr == streamInterface) return ERROR_NULL_PTR;
+  VCD::MP4::Mp4Reader* pReader = (VCD::MP4::Mp4Reader*)mMP4ReaderImpl;
+
+  VCD::MP4::VarLenArray<VCD::MP4::SegInfo> infos;
+  int32_t ret = pReader->ParseSegIndex(streamInterface, infos);
+  if (ret != ERROR_NONE) return ret;
+
+  for (uint32_t idx = 0; idx < infos.size; idx++) {
+    segIndex.push_back(infos[idx]);
+  }
+  return ERROR_NONE;
+}
+
 VCD_OMAF_END
@@ -102,6 +102,8 @@ public:
 
     virtual int32_t getTrackSampleOffset(uint32_t trackId, uint32_t sampleId, uint64_t& sampleOffset, uint32_t& sampleLength)  ;
 
+    virtual int32_t getSegmentSampleDescriptors(uint32_t trackId, uint32_t segmentId, std::vector<VCD::OMAF::SampleDescriptor>& sampleDescs);
+
     virtual int32_t getDecoderConfiguration(uint32_t trackId, uint32_t sampleId, std::vector<VCD::OMAF::DecoderSpecificInfo>& decoderInfos) const  ;
 
     virtual int32_t getTrackTimestamps(uint32_t trackId, std::vector<VCD::OMAF::TimestampIDPair>& timestamps) const  ;
@@ -151,6 +153,9 @@ public:  // MP4VR segment parsing methods (DASH/Streaming)
 
     virtual int32_t invalidateSegment(uint32_t initSegmentId, uint32_t segmentId) ;
 
+    virtual int32_t parseSegmentIndex(VCD::MP4::StreamIO* streamInterface,
+                                      std::vector<VCD::OMAF::SegmentInformation>& segIndex);
+
 private:
     void*  mMP4ReaderImpl;
     void SelectedTrackInfos(std::vector<VCD::OMAF::TrackInformation*>& trackInfos, std::vector<VCD::OMAF::TrackInformation*> middleTrackInfos) const;
@@ -46,6 +46,10 @@ OmafMPDParser::OmafMPDParser() {
 
 OmafMPDParser::~OmafMPDParser() {
   SAFE_DELETE(mParser);
+  for (auto stitch : mTilesStitches) {
+    SAFE_DELETE(stitch);
+  }
+  mTilesStitches.clear();
   // SAFE_DELETE(mMpd);
   // SAFE_DELETE(mLock);
 }
@@ -240,6 +244,10 @@ int OmafMPDParser::BuildStreams(TYPE_OMAFADAPTATIONSETS mapAdaptationSets, OMAFS
     std::string type = itStream->first;
     OmafMediaStream* stream = itStream->second;
     stream->SetEnabledExtractor(mExtractorEnabled);
+    if (!mExtractorEnabled && type == "video" && mTilesStitches.size()) {
+      stream->SetTilesStitch(mTilesStitches.front());
+      mTilesStitches.pop_front();
+    }
     stream->InitStream(type);
     listStream.push_back(stream);
   }
@@ -39,6 +39,7 @@
 #include "OmafMediaStream.h"
 #include "general.h"
 
+#include <list>
 #include <mutex>
 
 using namespace VCD::OMAF;
@@ -100,6 +101,13 @@ class OmafMPDParser {
   void SetOmafDashParams(const OmafDashParams& params) { omaf_dash_params_ = params; }
   ProjectionFormat GetProjectionFmt() { return mPF; };
 
+  //!
+  //! \brief  Set the tiles stitches kept from the previous media, they are
+  //!         handed to the late binding streams. the parser owns them and
+  //!         deletes the ones not used
+  //!
+  void SetTilesStitches(std::list<OmafTilesStitch*> stitches) { mTilesStitches = std::move(stitches); };
+
  private:
   //!
   //! \brief construct media streams.
@@ -151,6 +159,7 @@ private:
   OmafDashParams omaf_dash_params_;
   OmafAdaptationSet *mTmpAS;
   OmafMediaStream* mTmpStream;
+  std::list<OmafTilesStitch*> mTilesStitches;  //!< tiles stitches kept from the previous media
 };
 
 VCD_OMAF_END;
@@ -93,6 +93,20 @@ class OmafMediaSource {
   //!
   virtual int CloseMedia() = 0;
 
+  //!
+  //! \brief  Switch to the media of another url in the same session. it's pure interface
+  //!
+  //! \param  [in] url
+  //!         the location of the mpd to be switched to
+  //! \param  [in] cacheDir
+  //!         path to cache files it can be "" for no cache needed
+  //!
+  //! \return
+  //!         ERROR_NONE if success, else fail reason
+  //!
+  virtual int SwitchMedia(std::string url, std::string cacheDir, bool enableExtractor, bool enablePredictor = false,
+                          std::string predictPluginName = "", std::string dllPath = "") = 0;
+
   //!
   //! \brief  Open Media from special url. it's pure interface
   //!
@@ -175,6 +189,62 @@ class OmafMediaSource {
   //!
   virtual int GetStatistic(DashStatisticInfo* dsInfo) = 0;
 
+  //!
+  //! \brief  Swap the viewport prediction plugin at next segment boundary
+  //!
+  //! \param  [in] predictPluginName
+  //!         the name of the new plugin library
+  //! \param  [in] libPath
+  //!         the path of the new plugin library
+  //!
+  //! \return
+  //!         ERROR_NONE if success, else fail reason
+  //!
+  virtual int SwapPredictPlugin(std::string predictPluginName, std::string libPath) = 0;
+
+  //!
+  //! \brief  Get the timing counters of the viewport prediction plugin in use
+  //!
+  //! \param  [out] stats
+  //!         the timing counters
+  //!
+  //! \return
+  //!         ERROR_NONE if success, else fail reason
+  //!
+  virtual int GetPredictPluginStats(PluginTimingStats* stats) = 0;
+
+  //!
+  //! \brief  Get the timing counters of the download, parse, select and stitch stages
+  //!
+  //! \param  [out] timings
+  //!         the timing counters of each stage
+  //!
+  //! \return
+  //!         ERROR_NONE if success, else fail reason
+  //!
+  virtual int GetStageTimings(DashStageTimings* timings) = 0;
+
+  //!
+  //! \brief  Get the snapshot of the metrics registry
+  //!
+  //! \param  [out] values
+  //!         the metrics, NULL to query the count only
+  //! \param  [in/out] count
+  //!         capacity of values as input, count of metrics as output
+  //!
+  //! \return
+  //!         ERROR_NONE if success, else fail reason
+  //!
+  virtual int GetMetrics(MetricValue* values, int32_t* count) = 0;
+
+  //!
+  //! \brief  Dump the metrics registry in Prometheus text format
+  //!
+  //! \param  [in] prefix
+  //!         prefix of all metric names
+  //!
+  virtual std::string DumpMetrics(std::string prefix) = 0;
+
   //!
   //! \brief  seek to special position of the media in VOD mode
   //!
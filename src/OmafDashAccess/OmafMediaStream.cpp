@@ -432,8 +432,18 @@ int OmafMediaStream::UpdateStartNumber(uint64_t nAvailableStartTime) {
 
 int OmafMediaStream::DownloadInitSegment() {
   std::lock_guard<std::mutex> lock(mMutex);
+  // the low resolution video tracks are requested first, they are enough for the first frame
+  std::list<OmafAdaptationSet*> deferredAS;
   for (auto it = mMediaAdaptationSet.begin(); it != mMediaAdaptationSet.end(); it++) {
     OmafAdaptationSet* pAS = (OmafAdaptationSet*)(it->second);
+    if (pAS->GetMediaType() == MediaType_Video && !pAS->IsMain() &&
+        pAS->GetRepresentationQualityRanking() != HIGHEST_QUALITY_RANKING) {
+      pAS->DownloadInitializeSegment();
+    } else {
+      deferredAS.push_back(pAS);
+    }
+  }
+  for (auto pAS : deferredAS) {
     pAS->DownloadInitializeSegment();
   }
 
@@ -466,6 +476,18 @@ int OmafMediaStream::DownloadSegments() {
   return ret;
 }
 
+int OmafMediaStream::DownloadSubSegments(int64_t start_ms, int64_t index_probe_size) {
+  // tiles in extractor track are bound together, only the late binding tiles are fetched alone
+  if (IsExtractorEnabled()) return ERROR_NONE;
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  for (auto it = mMediaAdaptationSet.begin(); it != mMediaAdaptationSet.end(); it++) {
+    OmafAdaptationSet* pAS = (OmafAdaptationSet*)(it->second);
+    pAS->DownloadSubSegment(start_ms, index_probe_size);
+  }
+  return ERROR_NONE;
+}
+
 int OmafMediaStream::SeekTo(int seg_num) {
   int ret = ERROR_NONE;
   std::lock_guard<std::mutex> lock(mMutex);
@@ -503,20 +525,27 @@ int OmafMediaStream::UpdateEnabledExtractors(std::list<OmafExtractor*> extractor
       for (auto it = extractors.begin(); it != extractors.end(); it++) {
         OmafExtractor* tmp = (OmafExtractor*)(*it);
         tmp->Enable(true);
+        tmp->SetDownloadPriority(TaskPriority::HIGH);
         mCurrentExtractors.push_back(tmp);
         std::map<int, OmafAdaptationSet*> AS = tmp->GetDependAdaptationSets();
         for (auto as_it = AS.begin(); as_it != AS.end(); as_it++) {
           OmafAdaptationSet* pAS = (OmafAdaptationSet*)(as_it->second);
           pAS->Enable(true);
+          pAS->SetDownloadPriority(pAS->GetRepresentationQualityRanking() == HIGHEST_QUALITY_RANKING
+                                       ? TaskPriority::HIGH
+                                       : TaskPriority::FALLBACK);
         }
       }
     }
+
+    CancelDisabledSegments();
   }
 
   return ret;
 }
 
-int OmafMediaStream::UpdateEnabledTileTracks(std::map<int, OmafAdaptationSet*> selectedTiles) {
+int OmafMediaStream::UpdateEnabledTileTracks(std::map<int, OmafAdaptationSet*> selectedTiles,
+                                             std::set<int> predictedTiles) {
   if (selectedTiles.empty()) return ERROR_INVALID;
 
   int ret = ERROR_NONE;
@@ -538,16 +567,42 @@ int OmafMediaStream::UpdateEnabledTileTracks(std::map<int, OmafAdaptationSet*> s
       for (auto itAS = selectedTiles.begin(); itAS != selectedTiles.end(); itAS++) {
         OmafAdaptationSet* adaptationSet = itAS->second;
         adaptationSet->Enable(true);
+        // the low quality background is the fallback, then in-view high quality tiles,
+        // the tiles only in predicted viewport are speculative
+        if (adaptationSet->GetRepresentationQualityRanking() != HIGHEST_QUALITY_RANKING) {
+          adaptationSet->SetDownloadPriority(TaskPriority::FALLBACK);
+        } else if (predictedTiles.find(itAS->first) != predictedTiles.end()) {
+          adaptationSet->SetDownloadPriority(TaskPriority::LOW);
+        } else {
+          adaptationSet->SetDownloadPriority(TaskPriority::HIGH);
+        }
         m_selectedTileTracks.insert(make_pair(itAS->first, itAS->second));
       }
 
       m_hasTileTracksSelected = true;
     }
+
+    CancelDisabledSegments();
   }
 
   return ret;
 }
 
+void OmafMediaStream::CancelDisabledSegments() {
+  for (auto as_it = mMediaAdaptationSet.begin(); as_it != mMediaAdaptationSet.end(); as_it++) {
+    OmafAdaptationSet* pAS = (OmafAdaptationSet*)(as_it->second);
+    if (!pAS->IsEnabled()) {
+      pAS->CancelOpeningSegments();
+    }
+  }
+  for (auto extrator_it = mExtractors.begin(); extrator_it != mExtractors.end(); extrator_it++) {
+    OmafExtractor* extractor = (OmafExtractor*)(extrator_it->second);
+    if (!extractor->IsEnabled()) {
+      extractor->CancelOpeningSegments();
+    }
+  }
+}
+
 int OmafMediaStream::GetTrackCount() {
   int tracksCnt = 0;
   if (m_enabledExtractor) {
@@ -45,6 +45,7 @@
 #include "OmafReader.h"
 #include "OmafTilesStitch.h"
 #include <mutex>
+#include <set>
 
 VCD_OMAF_BEGIN
 
@@ -83,6 +84,12 @@ class OmafMediaStream {
   //!
   int DownloadSegments();
 
+  //!
+  //! \brief  download the latest segment from the subsegment at the time for
+  //!         the tiles turned into viewport after the segment was requested.
+  //!
+  int DownloadSubSegments(int64_t start_ms, int64_t index_probe_size);
+
   //!
   //! \brief  Add extractor Adaptation Set
   //!
@@ -138,8 +145,11 @@ class OmafMediaStream {
 
   //!
   //! \brief  Update selected tile tracks after viewport changed
+  //! \param  selectedTiles : all selected tile tracks
+  //!         predictedTiles : ids of the tile tracks selected only by the predicted viewport
   //!
-  int UpdateEnabledTileTracks(std::map<int, OmafAdaptationSet*> selectedTiles);
+  int UpdateEnabledTileTracks(std::map<int, OmafAdaptationSet*> selectedTiles,
+                              std::set<int> predictedTiles = std::set<int>());
 
   //!
   //! \brief  Get count of tracks
@@ -224,6 +234,19 @@ class OmafMediaStream {
 
   std::list<MediaPacket*> GetOutTilesMergedPackets();
 
+  //!
+  //! \brief  Hand over the tiles stitch to the stream of the next media, it
+  //!         should be called after the stream is closed, and set before
+  //!         InitStream, so its 360SCVP library handle is reused
+  //!
+  OmafTilesStitch* DetachTilesStitch() {
+    OmafTilesStitch* stitch = m_stitch;
+    m_stitch = NULL;
+    return stitch;
+  };
+
+  void SetTilesStitch(OmafTilesStitch* stitch) { m_stitch = stitch; };
+
   void Close();
 
  private:
@@ -237,6 +260,11 @@ class OmafMediaStream {
   //!
   void SetupExtratorDependency();
 
+  //!
+  //! \brief  Cancel the stale segment downloads of the adaptation sets out of the viewport
+  //!
+  void CancelDisabledSegments();
+
   int32_t StartTilesStitching();
 
   static void* TilesStitchingThread(void* pThis);
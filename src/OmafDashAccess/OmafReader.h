@@ -350,6 +350,25 @@ public:
     //!
     virtual int32_t getTrackSampleOffset(uint32_t trackId, uint32_t sampleId, uint64_t& sampleOffset, uint32_t& sampleLength) = 0;
 
+    //!
+    //! \brief  Get descriptors of all samples in the specified
+    //!         segment of specified track in one call
+    //!
+    //! \param  [in]  trackId
+    //!         index of specific track
+    //! \param  [in]  segmentId
+    //!         index of specified segment
+    //! \param  [out] sampleDescs
+    //!         output sample offset, length, presentation time,
+    //!         sync flag and description index in decoding order
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    virtual int32_t getSegmentSampleDescriptors(uint32_t trackId,
+                                                uint32_t segmentId,
+                                                std::vector<VCD::OMAF::SampleDescriptor>& sampleDescs) = 0;
+
     //!
     //! \brief  Get media codec related specific information,
     //!         like SPS, PPS and so on, for specified sample in
@@ -700,6 +719,22 @@ public:
     //!
     virtual int32_t invalidateSegment(uint32_t initSegmentId, uint32_t segmentId)  = 0;
 
+    //!
+    //! \brief  Parse the segment index box in the head of a segment,
+    //!         the stream only needs to hold the boxes up to the sidx
+    //!
+    //! \param  [in]  streamInterface
+    //!         pointer to the stream holding the segment head
+    //! \param  [out] segIndex
+    //!         the subsegments of the segment, the data offset of
+    //!         each one is relative to the start of the segment
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    virtual int32_t parseSegmentIndex(VCD::MP4::StreamIO* streamInterface,
+                                      std::vector<VCD::OMAF::SegmentInformation>& segIndex) = 0;
+
     //!
     //! \brief  Set the <initSegmentId, trackId> map to
     //!         input map
@@ -197,8 +197,6 @@ class OmafSegmentNode : public VCD::NonCopyable {
   int parseSegmentStream(std::shared_ptr<OmafReader> reader) noexcept;
   int removeSegmentStream(std::shared_ptr<OmafReader> reader) noexcept;
   int cachePackets(std::shared_ptr<OmafReader> reader) noexcept;
-  std::shared_ptr<TrackInformation> findTrackInformation(std::shared_ptr<OmafReader> reader) noexcept;
-  bool findSampleIndexRange(std::shared_ptr<TrackInformation>, size_t &begin, size_t &end) noexcept;
   OmafPacketParams::Ptr getPacketParams() {
     auto reader_mgr = omaf_reader_mgr_.lock();
     if (reader_mgr) {
@@ -261,6 +259,7 @@ OMAF_STATUS OmafReaderManager::Initialize(OmafMediaSource *pSource) noexcept {
     }
     breader_working_ = true;
     segment_reader_worker_ = std::thread(&OmafReaderManager::threadRunner, this);
+    initSeg_parse_worker_ = std::thread(&OmafReaderManager::initSegmentParseRunner, this);
 
     return ERROR_NONE;
 
@@ -296,6 +295,19 @@ OMAF_STATUS OmafReaderManager::Close() noexcept {
       segment_reader_worker_.join();
     }
 
+    {
+      std::lock_guard<std::mutex> lock(initSeg_parse_mutex_);
+      initSeg_parse_queue_.clear();
+      initSeg_parse_cv_.notify_all();
+    }
+    if (initSeg_parse_worker_.joinable()) {
+      initSeg_parse_worker_.join();
+    }
+    {
+      std::lock_guard<std::mutex> lock(initSeg_mutex_);
+      initSeg_ready_cv_.notify_all();
+    }
+
     return ERROR_NONE;
   } catch (const std::exception &ex) {
     LOG(ERROR) << "Failed to close the client reader, ex: " << ex.what() << std::endl;
@@ -353,6 +365,8 @@ OMAF_STATUS OmafReaderManager::OpenSegment(std::shared_ptr<OmafSegment> pSeg, bo
     pSeg->RegisterStateChange([this](std::shared_ptr<OmafSegment> segment, OmafSegment::State state) {
       this->normalSegmentStateChange(std::move(segment), state);
     });
+    // the segment will be skipped by reader after timeout, so it is the deadline for download
+    pSeg->SetDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(work_params_.segment_timeout_ms_));
 
     OmafSegmentNode::Ptr new_node = std::make_shared<OmafSegmentNode>(shared_from_this(), work_params_.mode_, reader_,
                                                                       std::move(pSeg), depends_size, isExtracotr);
@@ -595,6 +609,23 @@ OMAF_STATUS OmafReaderManager::GetPacketQueueSize(uint32_t trackID, size_t &size
     return ERROR_INVALID;
   }
 }
+
+size_t OmafReaderManager::GetBufferedSegmentCount() noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(segment_parsed_mutex_);
+    size_t count = 0;
+    for (auto &nodeset : segment_parsed_list_) {
+      if (!nodeset.segment_nodes_.empty()) {
+        count++;
+      }
+    }
+    return count;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Failed to count the buffered segments, ex: " << ex.what() << std::endl;
+    return 0;
+  }
+}
+
 uint64_t OmafReaderManager::GetOldestPacketPTSForTrack(int trackId) {
   try {
     std::unique_lock<std::mutex> lock(segment_parsed_mutex_);
@@ -632,24 +663,73 @@ void OmafReaderManager::initSegmentStateChange(std::shared_ptr<OmafSegment> pIni
   try {
     if (state != OmafSegment::State::OPEN_SUCCES) {
       LOG(ERROR) << "Failed to open the init segment, state= " << static_cast<int>(state) << std::endl;
+      std::lock_guard<std::mutex> lock(initSeg_mutex_);
+      initSeg_failed_count_++;
+      initSeg_ready_cv_.notify_all();
       return;
     }
 
-    // 1. parse the segment
-    OMAF_STATUS ret = reader_->parseInitializationSegment(pInitSeg.get(), pInitSeg->GetInitSegID());
-    if (ret != ERROR_NONE) {
-      LOG(ERROR) << "parse initialization segment failed! code= " << ret << std::endl;
-      return;
-    }
+    std::lock_guard<std::mutex> lock(initSeg_parse_mutex_);
+    initSeg_parse_queue_.push_back(std::move(pInitSeg));
+    initSeg_parse_cv_.notify_all();
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Failed to queue the init segment, ex: " << ex.what() << std::endl;
+  }
+}
 
-    initSeg_ready_count_++;
+void OmafReaderManager::initSegmentParseRunner() noexcept {
+  try {
+    while (breader_working_) {
+      std::shared_ptr<OmafSegment> pInitSeg;
+      {
+        std::unique_lock<std::mutex> lock(initSeg_parse_mutex_);
+        initSeg_parse_cv_.wait(lock, [this]() { return !breader_working_ || !initSeg_parse_queue_.empty(); });
+        if (!breader_working_) {
+          break;
+        }
+        pInitSeg = std::move(initSeg_parse_queue_.front());
+        initSeg_parse_queue_.pop_front();
+      }
+
+      // 1. parse the segment, the mp4 reader is not thread safe so they are parsed one by one
+      OMAF_STATUS ret = reader_->parseInitializationSegment(pInitSeg.get(), pInitSeg->GetInitSegID());
+      if (ret != ERROR_NONE) {
+        LOG(ERROR) << "parse initialization segment failed! code= " << ret << std::endl;
+        std::lock_guard<std::mutex> lock(initSeg_mutex_);
+        initSeg_failed_count_++;
+        initSeg_ready_cv_.notify_all();
+        continue;
+      }
+
+      initSeg_ready_count_++;
 
-    // 2 get the track information when all init segment parsed
-    if (initSegParsedCount() == media_source_->GetTrackCount() && !IsInitSegmentsParsed()) {
-      buildInitSegmentInfo();
+      // 2 get the track information when all init segment parsed
+      if (initSegParsedCount() == media_source_->GetTrackCount() && !IsInitSegmentsParsed()) {
+        buildInitSegmentInfo();
+      }
     }
   } catch (const std::exception &ex) {
-    LOG(ERROR) << "Failed to parse the init segment, ex: " << ex.what() << std::endl;
+    LOG(ERROR) << "Exception in the init segment parse runner, ex: " << ex.what() << std::endl;
+  }
+}
+
+OMAF_STATUS OmafReaderManager::WaitInitSegmentsParsed(int32_t timeout_ms) noexcept {
+  try {
+    std::unique_lock<std::mutex> lock(initSeg_mutex_);
+    initSeg_ready_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]() {
+      return bInitSeg_all_ready_.load() || initSeg_failed_count_ > 0 || !breader_working_;
+    });
+    if (bInitSeg_all_ready_.load()) {
+      return ERROR_NONE;
+    }
+    if (initSeg_failed_count_ > 0) {
+      LOG(ERROR) << initSeg_failed_count_ << " init segments failed to open or parse!" << std::endl;
+      return ERROR_PARSE;
+    }
+    return ERROR_SEG_NOT_READY;
+  } catch (const std::exception &ex) {
+    LOG(ERROR) << "Exception when wait for the init segments, ex: " << ex.what() << std::endl;
+    return ERROR_INVALID;
   }
 }
 
@@ -711,6 +791,7 @@ void OmafReaderManager::buildInitSegmentInfo(void) noexcept {
       }    // end stream loop
     }      // end for track loop
     bInitSeg_all_ready_ = true;
+    initSeg_ready_cv_.notify_all();
 
     // 2.2 setup the id map
     setupTrackIdMap();
@@ -921,7 +1002,12 @@ void OmafReaderManager::threadRunner() noexcept {
       // 2. parse the ready segment/dash_node
       const int64_t timeline_point = ready_dash_node->getTimelinePoint();
       LOG(INFO) << "Get ready segment! timeline=" << timeline_point << std::endl;
-      OMAF_STATUS ret = ready_dash_node->parse();
+      OMAF_STATUS ret = ERROR_NONE;
+      {
+        OmafStageTimer timer(stage_timings_.get(), OmafStageTimings::Stage::PARSE);
+        ret = ready_dash_node->parse();
+        timer.SetFailed(ret != ERROR_NONE);
+      }
 
       // 3. move the parsed segment/dash_node to parsed list
       if (ret == ERROR_NONE) {
@@ -1179,7 +1265,7 @@ int OmafSegmentNode::start(void) noexcept {
     }
 
     start_time_ = std::chrono::steady_clock::now();
-    ret = segment_->Open(reader_mgr->dash_client_);
+    ret = segment_->Open(reader_mgr->dash_client_, reader_.lock());
     if (ret != ERROR_NONE) {
       LOG(ERROR) << "Failed to open the segment!" << std::endl;
       return ret;
@@ -1265,28 +1351,24 @@ int OmafSegmentNode::getPacket(MediaPacket *&pPacket, bool requireParams) noexce
 int OmafSegmentNode::cachePackets(std::shared_ptr<OmafReader> reader) noexcept {
   try {
     OMAF_STATUS ret = ERROR_NONE;
-    std::shared_ptr<TrackInformation> track_info = findTrackInformation(reader);
-    if (track_info.get() == nullptr) {
-      LOG(FATAL) << "Failed to find the sepcial track information." << this->to_string() << std::endl;
-      return ERROR_INVALID;
-    }
+    uint32_t reader_track_id = buildReaderTrackId(segment_->GetTrackId(), segment_->GetInitSegID());
 
-    size_t sample_begin = 0;
-    size_t sample_end = 0;
-    if (!findSampleIndexRange(track_info, sample_begin, sample_end)) {
-      LOG(ERROR) << "Failed to find the sample range for segment. " << this->to_string() << std::endl;
-      return ERROR_INVALID;
-    }
-#if 0
-    if (sample_begin < 1) {
-      LOG(FATAL) << "The begin sample id is less than 1, whose value =" << sample_begin << "." << this->to_string()
+    // all samples of the segment are resolved in one call
+    std::vector<SampleDescriptor> samples;
+    ret = reader->getSegmentSampleDescriptors(reader_track_id, segment_->GetSegID(), samples);
+    if (ret != ERROR_NONE || samples.empty()) {
+      LOG(ERROR) << "Failed to find the samples for segment. " << this->to_string() << ". Error code=" << ret
                  << std::endl;
       return ERROR_INVALID;
     }
-#endif
+
     auto packet_params = getPacketParams();
-    for (size_t sample = sample_begin; sample < sample_end; sample++) {
-      uint32_t reader_track_id = buildReaderTrackId(segment_->GetTrackId(), segment_->GetInitSegID());
+    const uint32_t sample_begin = samples.front().sampleId;
+    // the rwpk comes from the sample entry, it is read again only when the sample entry changes
+    VCD::VRVideo::SharedRwpk::Ptr rwpk;
+    uint32_t rwpk_desc_index = 0;
+    for (auto &sample_desc : samples) {
+      uint32_t sample = sample_desc.sampleId;
 
       if (packet_params.get() == nullptr) {
         packet_params = std::make_shared<OmafPacketParams>();
@@ -1323,16 +1405,32 @@ int OmafSegmentNode::cachePackets(std::shared_ptr<OmafReader> reader) noexcept {
         return ret;
       }
 
-      std::unique_ptr<RegionWisePacking> pRwpk = make_unique_vcd<RegionWisePacking>();
-      ret = reader->getPropertyRegionWisePacking(reader_track_id, sample, pRwpk.get());
-      if (ret != ERROR_NONE) {
-        LOG(ERROR) << "Failed to read region wise packing data from reader, code= " << ret << std::endl;
-        SAFE_DELETE(packet);
-        return ret;
+      if (rwpk.get() == nullptr || rwpk_desc_index != sample_desc.sampleDescriptionIndex) {
+        RegionWisePacking pRwpk;
+        memset(&pRwpk, 0, sizeof(RegionWisePacking));
+        ret = reader->getPropertyRegionWisePacking(reader_track_id, sample, &pRwpk);
+        if (ret == ERROR_NONE) {
+          rwpk = VCD::VRVideo::RWPKCACHE::GetInstance()->Share(pRwpk);
+        }
+        if (pRwpk.rectRegionPacking) {
+          delete[] pRwpk.rectRegionPacking;
+          pRwpk.rectRegionPacking = nullptr;
+        }
+        if (ret != ERROR_NONE || rwpk.get() == nullptr) {
+          LOG(ERROR) << "Failed to read region wise packing data from reader, code= " << ret << std::endl;
+          SAFE_DELETE(packet);
+          return ret != ERROR_NONE ? ret : ERROR_INVALID;
+        }
+        rwpk_desc_index = sample_desc.sampleDescriptionIndex;
       }
-      packet->SetRwpk(std::move(pRwpk));
+      packet->SetRwpk(rwpk);
       //packet->SetPTS(this->getTimelinePoint());  // FIXME, to compute pts
-      packet->SetPTS(track_info->sampleProperties.size * (segment_->GetSegID() - 1) + sample_begin + sample);
+      // the segment is removed from the reader once cached, so it is the only
+      // segment of its track here, the samples of the track are the samples
+      // of the segment and their ids start from 0. the pts is the same as the
+      // one counted from the whole track information, and still counts from
+      // the segment if an older segment of the track is left in the reader
+      packet->SetPTS(samples.size() * (segment_->GetSegID() - 1) + sample - sample_begin);
 
       // for later binding
       packet->SetQualityRanking(segment_->GetQualityRanking());
@@ -1371,8 +1469,7 @@ int OmafSegmentNode::cachePackets(std::shared_ptr<OmafReader> reader) noexcept {
 
       packet->SetRealSize(packet_size);
       VLOG(VLOG_TRACE) << "Sample id=" << sample << std::endl;
-      // packet->SetSegID(track_info->sampleProperties[sample - 1].segmentId);
-      packet->SetSegID(track_info->sampleProperties[sample].segmentId);
+      packet->SetSegID(sample_desc.segmentId);
       // media_packets_.push_back(std::move(packet));
       media_packets_.push(packet);
     }
@@ -1383,61 +1480,6 @@ int OmafSegmentNode::cachePackets(std::shared_ptr<OmafReader> reader) noexcept {
   }
 }
 
-std::shared_ptr<TrackInformation> OmafSegmentNode::findTrackInformation(std::shared_ptr<OmafReader> reader) noexcept {
-  try {
-    std::vector<TrackInformation *> track_infos;
-
-    OMAF_STATUS ret = reader->getTrackInformations(track_infos);
-    if (ERROR_NONE != ret) {
-      LOG(ERROR) << "Failed to get the trackinformation list from reader, code=" << ret << std::endl;
-      return nullptr;
-    }
-
-    // get the required track information and release the old data
-    std::shared_ptr<TrackInformation> track_info;
-    for (auto &track : track_infos) {
-      if (track != nullptr) {
-        if (buildDashTrackId(track->trackId) == segment_->GetTrackId()) {
-          track_info = std::make_shared<TrackInformation>();
-          *(track_info.get()) = *track;
-        }
-        delete track;
-      }
-
-      track = nullptr;
-    }
-    track_infos.clear();
-
-    return std::move(track_info);
-  } catch (const std::exception &ex) {
-    LOG(ERROR) << "Exception when find the track information! ex: " << ex.what() << std::endl;
-    return nullptr;
-  }
-}
-
-bool OmafSegmentNode::findSampleIndexRange(std::shared_ptr<TrackInformation> track_info, size_t &begin,
-                                           size_t &end) noexcept {
-  try {
-    if (track_info.get() == nullptr) {
-      return false;
-    }
-    bool found = false;
-    for (size_t index = 0; index < track_info->sampleProperties.size; index++) {
-      if (segment_->GetSegID() == track_info->sampleProperties[index].segmentId) {
-        end++;
-        if (!found) {
-          found = true;
-          begin = track_info->sampleProperties[index].sampleId;
-        }
-      }
-    }
-    return found;
-  } catch (const std::exception &ex) {
-    LOG(ERROR) << "Exception when find the start index! ex: " << ex.what() << std::endl;
-    return false;
-  }
-}
-
 bool OmafSegmentNode::isReady() const noexcept {
   try {
     if (segment_.get() == nullptr) {
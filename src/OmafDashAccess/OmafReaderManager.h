@@ -41,6 +41,7 @@
 
 #include "OmafMediaSource.h"
 #include "OmafReader.h"
+#include "OmafStageTimings.h"
 
 #include <atomic>
 #include <chrono>
@@ -115,15 +116,39 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
   //!
   OMAF_STATUS GetPacketQueueSize(uint32_t trackID, size_t &size) noexcept;
 
+  //!
+  //! \brief  count of the parsed segments whose packets are not all read, as the buffer level
+  //!
+  size_t GetBufferedSegmentCount() noexcept;
+
   //!  \brief Get initial segments parse status.
   //!
   inline bool IsInitSegmentsParsed() { return bInitSeg_all_ready_.load(); };
 
+  //!
+  //! \brief  wait until all the init segments are parsed, it returns early when
+  //!         one of them fails to open or parse
+  //!
+  //! \param  [in] timeout_ms
+  //!         max time to wait
+  //!
+  //! \return OMAF_STATUS
+  //!         ERROR_NONE if all parsed, ERROR_PARSE if one failed,
+  //!         ERROR_SEG_NOT_READY if timeout
+  //!
+  OMAF_STATUS WaitInitSegmentsParsed(int32_t timeout_ms) noexcept;
+
+  //!
+  //! \brief  time the segment parsing into the stage timings
+  //!
+  void SetStageTimings(OmafStageTimings::Ptr timings) noexcept { stage_timings_ = std::move(timings); }
+
   uint64_t GetOldestPacketPTSForTrack(int trackId);
   void RemoveOutdatedPacketForTrack(int trackId, uint64_t currPTS);
 
  private:
   void threadRunner() noexcept;
+  void initSegmentParseRunner() noexcept;
   std::shared_ptr<OmafSegmentNode> findReadySegmentNode() noexcept;
   void clearOlderSegmentSet(int64_t timeline_point) noexcept;
   bool checkEOS(int64_t segment_num) noexcept;
@@ -156,6 +181,8 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
 
   std::shared_ptr<OmafReader> reader_;
 
+  OmafStageTimings::Ptr stage_timings_;
+
   std::mutex segment_opening_mutex_;
   std::list<OmafSegmentNodeTimedSet> segment_opening_list_;
   std::mutex segment_opened_mutex_;
@@ -179,6 +206,17 @@ class OmafReaderManager : public VCD::NonCopyable, public enable_shared_from_thi
 
   std::atomic_int initSeg_ready_count_{0};
   std::atomic_bool bInitSeg_all_ready_{false};
+  //<! count of the init segments failed to open or parse, guarded by initSeg_mutex_
+  int initSeg_failed_count_ = 0;
+  //<! signalled with initSeg_mutex_ when all init segments are parsed or one fails
+  std::condition_variable initSeg_ready_cv_;
+
+  //<! the opened init segments are parsed in the worker, out of the download thread,
+  // so the transfers of the others go on meanwhile
+  std::thread initSeg_parse_worker_;
+  std::mutex initSeg_parse_mutex_;
+  std::condition_variable initSeg_parse_cv_;
+  std::list<std::shared_ptr<OmafSegment>> initSeg_parse_queue_;
 };
 // using READERMANAGER = Singleton<OmafReaderManager>;
 VCD_OMAF_END
@@ -35,6 +35,7 @@
 
 #include "DownloadManager.h"
 #include "OmafSegment.h"
+#include "OmafReader.h"
 
 #include <fstream>
 #include <sstream>
@@ -48,6 +49,7 @@ OmafSegment::OmafSegment(DashSegmentSourceParams ds_params, int segCnt, bool bIn
   if (bInit_segment_) {
     initSeg_id_ = INITSEG_ID.fetch_add(1);
     seg_id_ = initSeg_id_;
+    ds_params_.init_segment_ = true;
   }
   mQualityRanking = INVALID_QUALITY_RANKING;
 }
@@ -58,7 +60,7 @@ OmafSegment::~OmafSegment() {
   }
 }
 
-int OmafSegment::Open(std::shared_ptr<OmafDashSegmentClient> dash_client) noexcept {
+int OmafSegment::Open(std::shared_ptr<OmafDashSegmentClient> dash_client, std::shared_ptr<OmafReader> reader) noexcept {
   try {
     if (dash_client.get() == nullptr) {
       return ERROR_NULL_PTR;
@@ -69,30 +71,30 @@ int OmafSegment::Open(std::shared_ptr<OmafDashSegmentClient> dash_client) noexce
     state_ = State::CREATE;
 
     // mSegElement->StartDownloadSegment((OmafDownloaderObserver *)this);
-    dash_client_->open(
-        ds_params_, [this](std::unique_ptr<VCD::OMAF::StreamBlock> sb) { this->dash_stream_.push_back(std::move(sb)); },
-        [this](OmafDashSegmentClient::State s) {
-          switch (s) {
-            case OmafDashSegmentClient::State::SUCCESS:
-              this->state_ = State::OPEN_SUCCES;
-              break;
-            case OmafDashSegmentClient::State::STOPPED:
-              this->state_ = State::OPEN_STOPPED;
-              break;
-            case OmafDashSegmentClient::State::TIMEOUT:
-              this->state_ = State::OPEN_TIMEOUT;
-              break;
-            case OmafDashSegmentClient::State::FAILURE:
-              this->state_ = State::OPEN_FAILED;
-              break;
-            default:
-              break;
-          }
-          if (this->state_change_cb_) {
-            this->state_change_cb_(this->shared_from_this(), this->state_);
+    OmafDashSegmentClient::OnData dcb = [this](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {
+      this->dash_stream_.push_back(std::move(sb));
+    };
+    OmafDashSegmentClient::OnState scb = [this](OmafDashSegmentClient::State s) { this->OnOpenState(s); };
+
+    if (sub_segment_start_ms_ < 0 || reader.get() == nullptr || index_probe_size_ <= 0) {
+      return OpenRange(ds_params_, dcb, scb);
+    }
+
+    // fetch the segment head for the segment index first
+    DashSegmentSourceParams head_params = ds_params_;
+    head_params.range_offset_ = 0;
+    head_params.range_size_ = index_probe_size_;
+    std::shared_ptr<StreamBlocks> head = std::make_shared<StreamBlocks>();
+    std::weak_ptr<OmafReader> weak_reader = reader;
+    return OpenRange(
+        head_params, [head](std::unique_ptr<VCD::OMAF::StreamBlock> sb) { head->push_back(std::move(sb)); },
+        [this, head, weak_reader](OmafDashSegmentClient::State s) {
+          if (s == OmafDashSegmentClient::State::SUCCESS) {
+            this->OnSegmentIndex(head, weak_reader.lock());
+          } else {
+            this->OnOpenState(s);
           }
         });
-    return ERROR_NONE;
   } catch (const std::exception& ex) {
     LOG(ERROR) << "Exception when start downloading the file: " << ds_params_.dash_url_ << ", ex: " << ex.what()
                << std::endl;
@@ -100,12 +102,128 @@ int OmafSegment::Open(std::shared_ptr<OmafDashSegmentClient> dash_client) noexce
   }
 }
 
+int OmafSegment::OpenRange(const DashSegmentSourceParams& params, OmafDashSegmentClient::OnData dcb,
+                           OmafDashSegmentClient::OnState scb) noexcept {
+  {
+    std::lock_guard<std::mutex> lock(request_mutex_);
+    request_params_ = params;
+  }
+  return dash_client_->open(params, std::move(dcb), std::move(scb));
+}
+
+void OmafSegment::OnSegmentIndex(std::shared_ptr<StreamBlocks> head, std::shared_ptr<OmafReader> reader) noexcept {
+  try {
+    const int64_t head_size = head->GetStreamSize();
+    std::vector<SegmentInformation> seg_index;
+    if (head_size > index_probe_size_ || reader.get() == nullptr ||
+        reader->parseSegmentIndex(head.get(), seg_index) != ERROR_NONE || seg_index.empty() ||
+        static_cast<int64_t>(seg_index[0].startDataOffset) > head_size) {
+      // the range is ignored by the server, or no segment index, so take the head as the whole segment
+      // if it is complete, else download the whole segment
+      if (head_size > index_probe_size_) {
+        head->SeekAbsoluteOffset(0);
+        std::unique_ptr<StreamBlock> sb = make_unique_vcd<StreamBlock>();
+        if (sb->resize(head_size) && head->ReadStream(sb->buf(), head_size) == head_size && sb->size(head_size)) {
+          dash_stream_.push_back(std::move(sb));
+          OnOpenState(OmafDashSegmentClient::State::SUCCESS);
+          return;
+        }
+      }
+      LOG(WARNING) << "No segment index in the head, fetch the whole segment, url=" << ds_params_.dash_url_
+                   << std::endl;
+      // the range from 0 is the whole segment, it marks a follow-up request of the timeline
+      DashSegmentSourceParams full_params = ds_params_;
+      full_params.range_offset_ = 0;
+      OpenRange(
+          full_params,
+          [this](std::unique_ptr<VCD::OMAF::StreamBlock> sb) { this->dash_stream_.push_back(std::move(sb)); },
+          [this](OmafDashSegmentClient::State s) { this->OnOpenState(s); });
+      return;
+    }
+
+    // the first subsegment starting with a random access point at or after the start time
+    const SegmentInformation& first_info = seg_index[0];
+    size_t start_index = seg_index.size();
+    for (size_t i = 0; i < seg_index.size(); i++) {
+      const SegmentInformation& info = seg_index[i];
+      if (info.timescale == 0 || !info.startsWithSAP) {
+        continue;
+      }
+      int64_t offset_ms = static_cast<int64_t>((info.earliestPTSinTS - first_info.earliestPTSinTS) * 1000 / info.timescale);
+      if (offset_ms >= sub_segment_start_ms_) {
+        start_index = i;
+        break;
+      }
+    }
+    if (start_index == seg_index.size()) {
+      VLOG(VLOG_TRACE) << "No subsegment left after " << sub_segment_start_ms_ << " ms, url=" << ds_params_.dash_url_
+                       << std::endl;
+      OnOpenState(OmafDashSegmentClient::State::STOPPED);
+      return;
+    }
+
+    // keep the boxes ahead of the subsegments, the styp and sidx
+    const int64_t head_len = static_cast<int64_t>(first_info.startDataOffset);
+    std::unique_ptr<StreamBlock> sb = make_unique_vcd<StreamBlock>();
+    head->SeekAbsoluteOffset(0);
+    if (!sb->resize(head_len) || head->ReadStream(sb->buf(), head_len) != head_len || !sb->size(head_len)) {
+      LOG(ERROR) << "Failed to keep the segment head, url=" << ds_params_.dash_url_ << std::endl;
+      OnOpenState(OmafDashSegmentClient::State::FAILURE);
+      return;
+    }
+    dash_stream_.push_back(std::move(sb));
+
+    const SegmentInformation& last_info = seg_index.back();
+    DashSegmentSourceParams data_params = ds_params_;
+    data_params.range_offset_ = static_cast<int64_t>(seg_index[start_index].startDataOffset);
+    data_params.range_size_ =
+        static_cast<int64_t>(last_info.startDataOffset + last_info.dataSize) - data_params.range_offset_;
+    VLOG(VLOG_TRACE) << "Fetch from subsegment " << start_index << "/" << seg_index.size() << ", " << data_params.to_string()
+              << std::endl;
+    OpenRange(
+        data_params,
+        [this](std::unique_ptr<VCD::OMAF::StreamBlock> sb) { this->dash_stream_.push_back(std::move(sb)); },
+        [this](OmafDashSegmentClient::State s) { this->OnOpenState(s); });
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Exception when fetch the subsegments of the file: " << ds_params_.dash_url_ << ", ex: " << ex.what()
+               << std::endl;
+    OnOpenState(OmafDashSegmentClient::State::FAILURE);
+  }
+}
+
+void OmafSegment::OnOpenState(OmafDashSegmentClient::State s) noexcept {
+  switch (s) {
+    case OmafDashSegmentClient::State::SUCCESS:
+      this->state_ = State::OPEN_SUCCES;
+      break;
+    case OmafDashSegmentClient::State::STOPPED:
+      this->state_ = State::OPEN_STOPPED;
+      break;
+    case OmafDashSegmentClient::State::TIMEOUT:
+      this->state_ = State::OPEN_TIMEOUT;
+      break;
+    case OmafDashSegmentClient::State::FAILURE:
+      this->state_ = State::OPEN_FAILED;
+      break;
+    default:
+      break;
+  }
+  if (this->state_change_cb_) {
+    this->state_change_cb_(this->shared_from_this(), this->state_);
+  }
+}
+
+DashSegmentSourceParams OmafSegment::RequestParams() noexcept {
+  std::lock_guard<std::mutex> lock(request_mutex_);
+  return request_params_;
+}
+
 int OmafSegment::Stop() noexcept {
   try {
     if (dash_client_.get() == nullptr) {
       return ERROR_NULL_PTR;
     }
-    dash_client_->remove(ds_params_);
+    dash_client_->remove(RequestParams());
     return ERROR_NONE;
   } catch (const std::exception& ex) {
     LOG(ERROR) << "Exception when start downloading the file: " << ds_params_.dash_url_ << ", ex: " << ex.what()
@@ -114,6 +232,30 @@ int OmafSegment::Stop() noexcept {
   }
 }
 
+int OmafSegment::Cancel() noexcept {
+  try {
+    if (dash_client_.get() == nullptr) {
+      return ERROR_NULL_PTR;
+    }
+    return dash_client_->cancel(RequestParams());
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Exception when cancel downloading the file: " << ds_params_.dash_url_ << ", ex: " << ex.what()
+               << std::endl;
+    return ERROR_INVALID;
+  }
+}
+
+bool OmafSegment::OpenStoredFile() noexcept {
+  if (mapped_file_.is_open()) {
+    return true;
+  }
+  if (!mapped_file_.open(cache_file_)) {
+    LOG(ERROR) << "Failed to map the segment file: " << cache_file_ << std::endl;
+    return false;
+  }
+  return true;
+}
+
 #if 0
 int OmafSegment::Read(uint8_t *data, size_t len) {
   // if (NULL == mSegElement) return ERROR_NULL_PTR;
@@ -151,27 +293,6 @@ int OmafSegment::Close() {
   return ERROR_NONE;
 }
 #endif
-int OmafSegment::CacheToFile() noexcept {
-  try {
-    std::string fileName =
-        ds_params_.dash_url_.substr(ds_params_.dash_url_.find_last_of('/') + 1,
-                                    ds_params_.dash_url_.length() - ds_params_.dash_url_.find_last_of('/') - 1);
-    cache_file_ = DOWNLOADMANAGER::GetInstance()->GetCacheFolder() + "/" +
-                  DOWNLOADMANAGER::GetInstance()->AssignCacheFileName() + fileName;
-    if (!dash_stream_.cacheToFile(cache_file_)) {
-      LOG(ERROR) << "Failed to cache the dash to file: " << cache_file_ << std::endl;
-      return OMAF_ERROR_FILE_WRITE;
-    }
-
-    VLOG(VLOG_TRACE) << "Success to cache dash to file: " << cache_file_ << ". url=" << ds_params_.dash_url_
-                     << "file size=" << dash_stream_.GetStreamSize() << std::endl;
-    return ERROR_NONE;
-  } catch (const std::exception& ex) {
-    LOG(ERROR) << "Exception when cache dash to file: " << cache_file_ << std::endl;
-    return ERROR_INVALID;
-  }
-}
-
 std::string OmafSegment::to_string() const noexcept {
   std::stringstream ss;
   ss << "segment initsegId=" << initSeg_id_;
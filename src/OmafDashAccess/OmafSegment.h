@@ -46,9 +46,12 @@
 #include <memory>
 #include <atomic>
 #include <fstream>
+#include <mutex>
 
 VCD_OMAF_BEGIN
 
+class OmafReader;
+
 class OmafSegment : public VCD::NonCopyable, public VCD::MP4::StreamIO, public enable_shared_from_this<OmafSegment> {
  public:
   using Ptr = std::shared_ptr<OmafSegment>;
@@ -93,12 +96,8 @@ class OmafSegment : public VCD::NonCopyable, public VCD::MP4::StreamIO, public e
     if (!buse_stored_file_) {
       return dash_stream_.ReadStream(buffer, size);
     } else {
-      if (!mFileStream.is_open()) {
-        mFileStream.open(this->GetSegmentCacheFile().c_str(), ios_base::binary | ios_base::in);
-      }
-      mFileStream.read(buffer, size);
-      std::streamsize readCnt = mFileStream.gcount();
-      return (offset_t)readCnt;
+      if (!OpenStoredFile()) return 0;
+      return mapped_file_.ReadStream(buffer, size);
     }
   };
 
@@ -106,16 +105,8 @@ class OmafSegment : public VCD::NonCopyable, public VCD::MP4::StreamIO, public e
     if (!buse_stored_file_) {
       return dash_stream_.SeekAbsoluteOffset(offset);
     } else {
-      if (!mFileStream.is_open()) {
-        mFileStream.open(this->GetSegmentCacheFile().c_str(), ios_base::binary | ios_base::in);
-      }
-      if (mFileStream.tellg() == -1) {
-        mFileStream.clear();
-        mFileStream.seekg(0, ios_base::beg);
-      }
-
-      mFileStream.seekg(offset);
-      return true;
+      if (!OpenStoredFile()) return false;
+      return mapped_file_.SeekAbsoluteOffset(offset);
     }
   }
 
@@ -123,10 +114,8 @@ class OmafSegment : public VCD::NonCopyable, public VCD::MP4::StreamIO, public e
     if (!buse_stored_file_) {
       return dash_stream_.TellOffset();
     } else {
-      if (!mFileStream.is_open()) {
-        mFileStream.open(this->GetSegmentCacheFile().c_str(), ios_base::binary | ios_base::in);
-      }
-      return mFileStream.tellg();
+      if (!OpenStoredFile()) return 0;
+      return mapped_file_.TellOffset();
     }
   };
 
@@ -134,13 +123,8 @@ class OmafSegment : public VCD::NonCopyable, public VCD::MP4::StreamIO, public e
     if (!buse_stored_file_) {
       return dash_stream_.GetStreamSize();
     } else {
-      if (!mFileStream.is_open()) {
-        mFileStream.open(this->GetSegmentCacheFile().c_str(), ios_base::binary | ios_base::in);
-      }
-      mFileStream.seekg(0, ios_base::end);
-      int64_t size = mFileStream.tellg();
-      mFileStream.seekg(0, ios_base::beg);
-      return size;
+      if (!OpenStoredFile()) return 0;
+      return mapped_file_.GetStreamSize();
     }
   };
 
@@ -206,10 +190,19 @@ class OmafSegment : public VCD::NonCopyable, public VCD::MP4::StreamIO, public e
   // @param[in] cb
   // @brief dash open state change callback
   //
+  // @param[in] reader
+  // @brief reader to parse the segment index, only needed by the sub-segment fetching
+  //
   // @return int
   // @brief calling success or not
-  int Open(std::shared_ptr<OmafDashSegmentClient> dash_client) noexcept;
+  int Open(std::shared_ptr<OmafDashSegmentClient> dash_client, std::shared_ptr<OmafReader> reader = nullptr) noexcept;
   int Stop() noexcept;
+  //
+  // @brief cancel the download if it is not transferring yet
+  //
+  // @return int
+  // @brief ERROR_NONE when the download is canceled
+  int Cancel() noexcept;
   // int Read(uint8_t* data, size_t len);
   // int Peek(uint8_t* data, size_t len);
   // int Peek(uint8_t* data, size_t len, size_t offset);
@@ -227,7 +220,27 @@ class OmafSegment : public VCD::NonCopyable, public VCD::MP4::StreamIO, public e
   void SetSegSize(uint64_t segSize) noexcept { seg_size_ = segSize; };
   uint64_t GetSegSize() const noexcept { return seg_size_; };
 
+  //
+  // @brief fetch the segment from the first subsegment at or after the media time,
+  //        the segment head is fetched first to get the segment index
+  //
+  // @param[in] start_ms
+  // @brief media time in the segment, in millisecond
+  //
+  // @param[in] index_probe_size
+  // @brief size of the head range, it should cover the styp and sidx
+  //
+  // @return void
+  // @brief
+  void SetSubSegmentStart(int64_t start_ms, int64_t index_probe_size) noexcept {
+    sub_segment_start_ms_ = start_ms;
+    index_probe_size_ = index_probe_size;
+  }
+  int64_t GetSubSegmentStart() const noexcept { return sub_segment_start_ms_; }
+
   int64_t GetTimelinePoint(void) { return ds_params_.timeline_point_; }
+  TaskPriority GetPriority(void) const noexcept { return ds_params_.priority_; }
+  void SetDeadline(std::chrono::steady_clock::time_point deadline) noexcept { ds_params_.deadline_ = deadline; }
   void SetQualityRanking(QualityRank qualityRanking) { mQualityRanking = qualityRanking; };
   QualityRank GetQualityRanking() { return mQualityRanking; };
 
@@ -238,15 +251,25 @@ class OmafSegment : public VCD::NonCopyable, public VCD::MP4::StreamIO, public e
   std::string to_string() const noexcept;
 
  private:
-  //!
-  //!  \brief save the memory data to file.
-  //!
-  int CacheToFile() noexcept;
+  int OpenRange(const DashSegmentSourceParams& params, OmafDashSegmentClient::OnData dcb,
+                OmafDashSegmentClient::OnState scb) noexcept;
+  void OnSegmentIndex(std::shared_ptr<StreamBlocks> head, std::shared_ptr<OmafReader> reader) noexcept;
+  void OnOpenState(OmafDashSegmentClient::State s) noexcept;
+  DashSegmentSourceParams RequestParams() noexcept;
+  bool OpenStoredFile() noexcept;
 
  private:
   std::shared_ptr<OmafDashSegmentClient> dash_client_;
   DashSegmentSourceParams ds_params_;
 
+  //<! the request in flight, it is a byte range of ds_params_ in sub-segment fetching
+  std::mutex request_mutex_;
+  DashSegmentSourceParams request_params_;
+
+  //<! media time to start the fetching from, -1 for the whole segment
+  int64_t sub_segment_start_ms_ = -1;
+  int64_t index_probe_size_ = 0;
+
   StreamBlocks dash_stream_;
 
   // SegmentElement* mSegElement;  //<! SegmentElement
@@ -276,7 +299,8 @@ class OmafSegment : public VCD::NonCopyable, public VCD::MP4::StreamIO, public e
   QualityRank mQualityRanking;  //<! quality ranking of the segment
   SRDInfo mSRDInfo;             //<! top/left/width/height info for the tile track segment
 
-  std::ifstream mFileStream;
+  //<! the stored segment file mapped into memory, opened on first read
+  MappedFileStream mapped_file_;
 
  private:
   static std::atomic_uint32_t INITSEG_ID;
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+//!
+//! \file:   OmafStageTimings.cpp
+//! \brief:  per stage timing of the dash access
+//!
+
+#include "OmafStageTimings.h"
+
+#include <string>
+
+namespace VCD {
+namespace OMAF {
+
+static const char *STAGE_NAMES[] = {"download", "parse", "select", "stitch"};
+
+OmafStageTimings::OmafStageTimings(std::shared_ptr<VCD::VRVideo::MetricsRegistry> metrics)
+    : metrics_(std::move(metrics)) {
+  for (int i = 0; i < static_cast<int>(Stage::COUNT); i++) {
+    std::string name = STAGE_NAMES[i];
+    histograms_[i] = metrics_->Histogram(name + "_microseconds", "time spent in one " + name + " run");
+    failures_[i] = metrics_->Counter(name + "_failures_total", "failed " + name + " runs");
+  }
+}
+
+void OmafStageTimings::Add(Stage stage, uint64_t spent_us, bool failed) noexcept {
+  if (stage >= Stage::COUNT) {
+    return;
+  }
+
+  int index = static_cast<int>(stage);
+  if (histograms_[index]) {
+    histograms_[index]->Record(spent_us);
+  }
+  if (failed && failures_[index]) {
+    failures_[index]->Add();
+  }
+}
+
+void OmafStageTimings::Get(DashStageTimings *timings) noexcept {
+  if (!timings) {
+    return;
+  }
+
+  PluginTimingStats stats[static_cast<int>(Stage::COUNT)];
+  for (int i = 0; i < static_cast<int>(Stage::COUNT); i++) {
+    stats[i].calls = histograms_[i] ? histograms_[i]->Count() : 0;
+    stats[i].failures = failures_[i] ? failures_[i]->Value() : 0;
+    stats[i].total_us = histograms_[i] ? histograms_[i]->Sum() : 0;
+    stats[i].max_us = histograms_[i] ? histograms_[i]->Max() : 0;
+  }
+  timings->download = stats[static_cast<int>(Stage::DOWNLOAD)];
+  timings->parse = stats[static_cast<int>(Stage::PARSE)];
+  timings->select = stats[static_cast<int>(Stage::SELECT)];
+  timings->stitch = stats[static_cast<int>(Stage::STITCH)];
+}
+
+void OmafStageTimings::Reset() noexcept {
+  for (int i = 0; i < static_cast<int>(Stage::COUNT); i++) {
+    if (histograms_[i]) histograms_[i]->Reset();
+    if (failures_[i]) failures_[i]->Reset();
+  }
+}
+
+}  // namespace OMAF
+}  // namespace VCD
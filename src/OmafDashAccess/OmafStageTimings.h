@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+//!
+//! \file:   OmafStageTimings.h
+//! \brief:  per stage timing of the dash access
+//! \detail: download, parse, select and stitch are timed where they run, so
+//!          the load generator and the player can tell which stage is costly.
+//!          the timings are histograms in the metrics registry of the source
+//!
+
+#ifndef OMAFSTAGETIMINGS_H
+#define OMAFSTAGETIMINGS_H
+
+#include "common.h"
+#include "../utils/data_type.h"
+#include "../utils/MetricsRegistry.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace VCD {
+namespace OMAF {
+
+class OmafStageTimings : public VCD::NonCopyable {
+ public:
+  using Ptr = std::shared_ptr<OmafStageTimings>;
+
+  enum class Stage {
+    DOWNLOAD = 0,
+    PARSE,
+    SELECT,
+    STITCH,
+    COUNT,
+  };
+
+ public:
+  OmafStageTimings(std::shared_ptr<VCD::VRVideo::MetricsRegistry> metrics =
+                       std::make_shared<VCD::VRVideo::MetricsRegistry>());
+  virtual ~OmafStageTimings(){};
+
+ public:
+  //!
+  //! \brief  add one run of the stage
+  //!
+  //! \param  [in] stage
+  //!         the stage which runs
+  //! \param  [in] spent_us
+  //!         the time spent in the run, in microsecond
+  //! \param  [in] failed
+  //!         whether the run fails
+  //!
+  void Add(Stage stage, uint64_t spent_us, bool failed = false) noexcept;
+
+  //!
+  //! \brief  copy out the timings of all stages
+  //!
+  void Get(DashStageTimings *timings) noexcept;
+
+  void Reset() noexcept;
+
+  //!
+  //! \brief  the registry holding the stage histograms, other metrics of the source go there too
+  //!
+  std::shared_ptr<VCD::VRVideo::MetricsRegistry> Metrics() noexcept { return metrics_; }
+
+ private:
+  std::shared_ptr<VCD::VRVideo::MetricsRegistry> metrics_;
+  VCD::VRVideo::MetricHistogram *histograms_[static_cast<int>(Stage::COUNT)] = {nullptr};
+  VCD::VRVideo::MetricCounter *failures_[static_cast<int>(Stage::COUNT)] = {nullptr};
+};
+
+//!
+//! \brief  time the scope and add it to the stage when leaving, nothing is done without timings
+//!
+class OmafStageTimer {
+ public:
+  OmafStageTimer(OmafStageTimings *timings, OmafStageTimings::Stage stage)
+      : timings_(timings), stage_(stage), start_(std::chrono::steady_clock::now()) {}
+  ~OmafStageTimer() {
+    if (timings_ && !cancelled_) {
+      auto spent = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_);
+      timings_->Add(stage_, static_cast<uint64_t>(spent.count()), failed_);
+    }
+  }
+
+  void SetFailed(bool failed) { failed_ = failed; }
+  //<! the run does nothing worth timing, e.g. no packet comes out
+  void Cancel() { cancelled_ = true; }
+
+ private:
+  OmafStageTimings *timings_;
+  OmafStageTimings::Stage stage_;
+  std::chrono::steady_clock::time_point start_;
+  bool failed_ = false;
+  bool cancelled_ = false;
+};
+
+}  // namespace OMAF
+}  // namespace VCD
+
+#endif  // OMAFSTAGETIMINGS_H
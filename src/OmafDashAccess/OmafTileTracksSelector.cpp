@@ -39,6 +39,7 @@
 #include <math.h>
 #include <chrono>
 #include <cstdint>
+#include <algorithm>
 #include "general.h"
 #ifndef _ANDROID_NDK_OPTION_
 #ifdef _USE_TRACE_
@@ -50,6 +51,12 @@ VCD_OMAF_BEGIN
 
 OmafTileTracksSelector::~OmafTileTracksSelector()
 {
+    if (m360SamplingHandle)
+    {
+        I360SCVP_unInit(m360SamplingHandle);
+        m360SamplingHandle = nullptr;
+    }
+
     if (m_currentTracks.size())
         m_currentTracks.clear();
 
@@ -108,6 +115,7 @@ bool IsSelectionChanged(TracksMap selection1, TracksMap selection2)
 int OmafTileTracksSelector::SelectTracks(OmafMediaStream* pStream)
 {
     TracksMap selectedTracks;
+    std::set<int> predictedOnlyTracks;
     if (mUsePrediction)
     {
         std::map<int, TracksMap> predictedTracks = GetTileTracksByPosePrediction(pStream);
@@ -123,6 +131,20 @@ int OmafTileTracksSelector::SelectTracks(OmafMediaStream* pStream)
             std::map<int, TracksMap>::iterator it;
             it = predictedTracks.begin();
             selectedTracks = it->second;
+
+            // tiles out of the current viewport are speculative, they are downloaded with low priority
+            // and will be canceled once the prediction turns out wrong
+            if (mPose)
+            {
+                TracksMap inViewTracks = SelectTileTracks(pStream, mPose);
+                for (auto &track : selectedTracks)
+                {
+                    if (inViewTracks.find(track.first) == inViewTracks.end())
+                    {
+                        predictedOnlyTracks.insert(track.first);
+                    }
+                }
+            }
         }
 
         if (predictedTracks.size())
@@ -144,6 +166,12 @@ int OmafTileTracksSelector::SelectTracks(OmafMediaStream* pStream)
         selectedTracks = GetTileTracksByPose(pStream);
     }
 
+    // viewport is kept, but the abr decision may change with the bandwidth
+    if (selectedTracks.empty() && mAbrController && mPose && m_currentTracks.size())
+    {
+        selectedTracks = SelectTileTracks(pStream, mPose);
+    }
+
     if (selectedTracks.empty() && m_currentTracks.empty())
         return ERROR_INVALID;
 
@@ -157,6 +185,7 @@ int OmafTileTracksSelector::SelectTracks(OmafMediaStream* pStream)
         }
         //LOG(INFO)<<"************Will update tile tracks selection *****"<<endl;
         m_currentTracks = selectedTracks;
+        m_predictedOnlyTracks = predictedOnlyTracks;
     }
     selectedTracks.clear();
 
@@ -166,7 +195,7 @@ int OmafTileTracksSelector::SelectTracks(OmafMediaStream* pStream)
 
     //if (isPoseChanged || enabledTracks.size() > 1)
 
-    int ret = pStream->UpdateEnabledTileTracks(m_currentTracks);
+    int ret = pStream->UpdateEnabledTileTracks(m_currentTracks, m_predictedOnlyTracks);
     return ret;
 }
 
@@ -239,18 +268,23 @@ TracksMap OmafTileTracksSelector::GetTileTracksByPose(OmafMediaStream* pStream)
     return selectedTracks;
 }
 
-TracksMap OmafTileTracksSelector::SelectTileTracks(
+TracksMap OmafTileTracksSelector::GetViewportTileTracks(
     OmafMediaStream* pStream,
-    HeadPose* pose)
+    HeadPose* pose,
+    int32_t* tilesNum,
+    void* handle)
 {
     TracksMap selectedTracks;
+    *tilesNum = 0;
+    if (!handle)
+        handle = m360ViewPortHandle;
 
     // to select tile tracks
-    int ret = I360SCVP_setViewPort(m360ViewPortHandle, pose->yaw, pose->pitch);
+    int ret = I360SCVP_setViewPort(handle, pose->yaw, pose->pitch);
     if (ret)
         return selectedTracks;
 
-    ret = I360SCVP_process(mParamViewport, m360ViewPortHandle);
+    ret = I360SCVP_process(mParamViewport, handle);
     if (ret)
         return selectedTracks;
     TileDef *tilesInViewport = new TileDef[1024];
@@ -259,7 +293,7 @@ TracksMap OmafTileTracksSelector::SelectTileTracks(
 
     Param_ViewportOutput paramViewportOutput;
     int32_t selectedTilesNum = I360SCVP_getTilesInViewport(
-            tilesInViewport, &paramViewportOutput, m360ViewPortHandle);
+            tilesInViewport, &paramViewportOutput, handle);
     if (selectedTilesNum <= 0 || selectedTilesNum > 1024)
     {
         LOG(ERROR) << "Failed to get tiles information in viewport !" << endl;
@@ -271,14 +305,6 @@ TracksMap OmafTileTracksSelector::SelectTileTracks(
     std::map<int, OmafAdaptationSet*>::iterator itAS;
 
     // insert all tile tracks in viewport into selected tile tracks map
-    uint32_t sqrtedSize = (uint32_t)sqrt(selectedTilesNum);
-    while(sqrtedSize && selectedTilesNum%sqrtedSize) { sqrtedSize--; }
-    bool needAddtionalTile = false;
-    if (sqrtedSize == 1) // selectedTilesNum is prime number
-    {
-        LOG(INFO) <<"need additional tile is true! original selected tile num of high quality is " << selectedTilesNum << endl;
-        needAddtionalTile = true;
-    }
     if (mProjFmt == ProjectionFormat::PF_ERP)
     {
         for (int32_t index = 0; index < selectedTilesNum; index++)
@@ -325,6 +351,7 @@ TracksMap OmafTileTracksSelector::SelectTileTracks(
                     {
                         LOG(ERROR) << "NULL tile information for Cubemap !" << std::endl;
                         DELETE_ARRAY(tilesInViewport);
+                        selectedTracks.clear();
                         return selectedTracks;
                     }
                     int32_t tileLeft = tileInfo->x;
@@ -340,6 +367,54 @@ TracksMap OmafTileTracksSelector::SelectTileTracks(
             }
         }
     }
+
+    DELETE_ARRAY(tilesInViewport);
+    *tilesNum = selectedTilesNum;
+    return selectedTracks;
+}
+
+static bool NeedAdditionalTile(int32_t tilesNum)
+{
+    uint32_t sqrtedSize = (uint32_t)sqrt(tilesNum);
+    while(sqrtedSize && tilesNum%sqrtedSize) { sqrtedSize--; }
+    return (sqrtedSize == 1);
+}
+
+TracksMap OmafTileTracksSelector::SelectTileTracks(
+    OmafMediaStream* pStream,
+    HeadPose* pose)
+{
+    int32_t selectedTilesNum = 0;
+    TracksMap selectedTracks = GetViewportTileTracks(pStream, pose, &selectedTilesNum);
+    if (selectedTilesNum <= 0)
+        return selectedTracks;
+
+    bool needAddtionalTile = false;
+    if (NeedAdditionalTile(selectedTilesNum)) // selectedTilesNum is prime number
+    {
+        LOG(INFO) <<"need additional tile is true! original selected tile num of high quality is " << selectedTilesNum << endl;
+        needAddtionalTile = true;
+    }
+    if (mAbrController && selectedTracks.size())
+    {
+        LimitViewportTilesByAbr(pStream, pose, selectedTracks);
+        int32_t limitedTilesNum = (int32_t)selectedTracks.size();
+        if (limitedTilesNum < selectedTilesNum)
+        {
+            needAddtionalTile = NeedAdditionalTile(limitedTilesNum);
+        }
+    }
+    CompleteTileTracks(pStream, needAddtionalTile, selectedTracks);
+    return selectedTracks;
+}
+
+void OmafTileTracksSelector::CompleteTileTracks(
+    OmafMediaStream* pStream,
+    bool needAddtionalTile,
+    TracksMap& selectedTracks)
+{
+    std::map<int, OmafAdaptationSet*> asMap = pStream->GetMediaAdaptationSet();
+    std::map<int, OmafAdaptationSet*>::iterator itAS;
     if (needAddtionalTile)
     {
         for (itAS = asMap.begin(); itAS != asMap.end(); itAS++)
@@ -365,12 +440,216 @@ TracksMap OmafTileTracksSelector::SelectTileTracks(
             selectedTracks.insert(make_pair(trackID, adaptationSet));
         }
     }
+}
 
-    DELETE_ARRAY(tilesInViewport);
+std::vector<std::pair<HeadPose, double>> OmafTileTracksSelector::SamplePoseDistribution(
+    const PredictedViewport& predicted)
+{
+    // sample the predicted pose distribution on the center and two rings,
+    // at one and two standard deviations, each sample weighted by the density
+    float yawSpread = std::min(predicted.yawStdDev, (float)MAX_PREFETCH_SPREAD);
+    float pitchSpread = std::min(predicted.pitchStdDev, (float)MAX_PREFETCH_SPREAD);
+    std::vector<std::pair<HeadPose, double>> samples;
+    HeadPose center;
+    center.yaw = predicted.angle.yaw;
+    center.pitch = predicted.angle.pitch;
+    samples.push_back(std::make_pair(center, 1.0));
+    if (yawSpread >= MIN_PREFETCH_SPREAD || pitchSpread >= MIN_PREFETCH_SPREAD)
+    {
+        for (int32_t ring = 1; ring <= 2; ring++)
+        {
+            for (int32_t dir = 0; dir < 8; dir++)
+            {
+                double angle = dir * M_PI / 4;
+                HeadPose sample;
+                sample.yaw = center.yaw + ring * yawSpread * (float)cos(angle);
+                if (sample.yaw >= 180.0f)
+                    sample.yaw -= 360.0f;
+                if (sample.yaw < -180.0f)
+                    sample.yaw += 360.0f;
+                sample.pitch = std::max(-90.0f, std::min(90.0f, center.pitch + ring * pitchSpread * (float)sin(angle)));
+                samples.push_back(std::make_pair(sample, exp(-ring * ring / 2.0)));
+            }
+        }
+    }
+    double totalWeight = 0.0;
+    for (auto& sample : samples)
+    {
+        totalWeight += sample.second;
+    }
+    for (auto& sample : samples)
+    {
+        sample.second /= totalWeight;
+    }
+    return samples;
+}
+
+TracksMap OmafTileTracksSelector::SelectTileTracksByDistribution(
+    OmafMediaStream* pStream,
+    PredictedViewport* predicted)
+{
+    TracksMap selectedTracks;
+
+    // the samples are projected on a handle of their own, so the viewport
+    // handle keeps the pose of the current selection
+    if (!m360SamplingHandle)
+    {
+        m360SamplingHandle = I360SCVP_Init(mParamViewport);
+        if (!m360SamplingHandle)
+        {
+            LOG(ERROR) << "Failed to create 360SCVP handle for pose distribution sampling !" << endl;
+            return selectedTracks;
+        }
+    }
+    std::vector<std::pair<HeadPose, double>> samples = SamplePoseDistribution(*predicted);
 
+    // the probability of a tile being viewed is the weight of the samples covering it
+    std::vector<std::pair<double, OmafAdaptationSet*>> ranking;
+    std::map<int, size_t> rankIndex;
+    int32_t centerTilesNum = 0;
+    for (size_t index = 0; index < samples.size(); index++)
+    {
+        int32_t tilesNum = 0;
+        TracksMap tracks = GetViewportTileTracks(pStream, &(samples[index].first), &tilesNum, m360SamplingHandle);
+        if (index == 0)
+        {
+            if (tilesNum <= 0)
+                return selectedTracks;
+            centerTilesNum = (int32_t)tracks.size();
+        }
+        for (auto& track : tracks)
+        {
+            auto it = rankIndex.find(track.first);
+            if (it == rankIndex.end())
+            {
+                rankIndex[track.first] = ranking.size();
+                ranking.push_back(std::make_pair(0.0, track.second));
+                it = rankIndex.find(track.first);
+            }
+            ranking[it->second].first += samples[index].second;
+        }
+    }
+    std::stable_sort(ranking.begin(), ranking.end(),
+        [](const std::pair<double, OmafAdaptationSet*>& a, const std::pair<double, OmafAdaptationSet*>& b) {
+            return a.first > b.first;
+        });
+
+    // unlikely tiles are not worth the bandwidth, but the center viewport is always kept
+    size_t candidatesNum = 0;
+    while (candidatesNum < ranking.size() &&
+           (candidatesNum < (size_t)centerTilesNum || ranking[candidatesNum].first >= mMinViewProbability))
+    {
+        candidatesNum++;
+    }
+
+    // fetch down the ranking within the bandwidth budget
+    size_t keptTiles = candidatesNum;
+    if (mAbrController)
+    {
+        std::vector<uint64_t> tileBitrates;
+        for (size_t index = 0; index < candidatesNum; index++)
+        {
+            tileBitrates.push_back(ranking[index].second->GetVideoInfo().bit_rate);
+        }
+        int32_t abrTiles = mAbrController->SelectViewportTiles(tileBitrates, GetBackgroundBitrate(pStream));
+        keptTiles = abrTiles > 0 ? std::min((size_t)abrTiles, candidatesNum) : 0;
+    }
+
+    double coveredProbability = 0.0;
+    for (size_t index = 0; index < keptTiles; index++)
+    {
+        selectedTracks.insert(make_pair(ranking[index].second->GetID(), ranking[index].second));
+        coveredProbability += ranking[index].first;
+    }
+    bool needAddtionalTile = NeedAdditionalTile((int32_t)keptTiles);
+    // the next likely tile makes up the layout if there is one
+    if (needAddtionalTile && keptTiles < ranking.size())
+    {
+        selectedTracks.insert(make_pair(ranking[keptTiles].second->GetID(), ranking[keptTiles].second));
+        needAddtionalTile = false;
+    }
+    VLOG(VLOG_TRACE) << "Prefetch " << selectedTracks.size() << " of " << ranking.size() << " high quality tiles around ("
+                     << predicted->angle.yaw << "," << predicted->angle.pitch << "), spread (" << predicted->yawStdDev << ","
+                     << predicted->pitchStdDev << "), " << coveredProbability << " of tile view probability covered" << endl;
+
+    CompleteTileTracks(pStream, needAddtionalTile, selectedTracks);
     return selectedTracks;
 }
 
+uint64_t OmafTileTracksSelector::GetBackgroundBitrate(OmafMediaStream* pStream)
+{
+    std::map<int, OmafAdaptationSet*> asMap = pStream->GetMediaAdaptationSet();
+
+    // the low quality tracks are always fetched as background
+    uint64_t backgroundBitrate = 0;
+    for (auto& as : asMap)
+    {
+        OmafAdaptationSet *adaptationSet = as.second;
+        if (adaptationSet->GetRepresentationQualityRanking() > HIGHEST_QUALITY_RANKING)
+        {
+            backgroundBitrate += adaptationSet->GetVideoInfo().bit_rate;
+        }
+    }
+    return backgroundBitrate;
+}
+
+void OmafTileTracksSelector::LimitViewportTilesByAbr(
+    OmafMediaStream* pStream,
+    HeadPose* pose,
+    TracksMap& viewportTracks)
+{
+    std::map<int, OmafAdaptationSet*> asMap = pStream->GetMediaAdaptationSet();
+
+    uint64_t backgroundBitrate = GetBackgroundBitrate(pStream);
+    int32_t frameWidth = 0;
+    int32_t frameHeight = 0;
+    for (auto& as : asMap)
+    {
+        OmafAdaptationSet *adaptationSet = as.second;
+        if (adaptationSet->GetRepresentationQualityRanking() <= HIGHEST_QUALITY_RANKING && adaptationSet->GetSRD())
+        {
+            OmafSrd *srd = adaptationSet->GetSRD();
+            frameWidth = std::max(frameWidth, srd->get_X() + srd->get_W());
+            frameHeight = std::max(frameHeight, srd->get_Y() + srd->get_H());
+        }
+    }
+
+    // order the tiles by the distance to the viewport center on ERP frame,
+    // other projection keeps the order from viewport calculation
+    std::vector<std::pair<double, OmafAdaptationSet*>> candidates;
+    for (auto& track : viewportTracks)
+    {
+        double distance = (double)candidates.size();
+        OmafSrd *srd = track.second->GetSRD();
+        if (mProjFmt == ProjectionFormat::PF_ERP && srd && frameWidth > 0 && frameHeight > 0)
+        {
+            double centerX = (pose->yaw + 180.0) / 360.0 * frameWidth;
+            double centerY = (90.0 - pose->pitch) / 180.0 * frameHeight;
+            double dx = fabs(srd->get_X() + srd->get_W() / 2.0 - centerX);
+            double dy = fabs(srd->get_Y() + srd->get_H() / 2.0 - centerY);
+            dx = std::min(dx, frameWidth - dx);
+            distance = dx * dx + dy * dy;
+        }
+        candidates.push_back(std::make_pair(distance, track.second));
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](const std::pair<double, OmafAdaptationSet*>& a, const std::pair<double, OmafAdaptationSet*>& b) {
+            return a.first < b.first;
+        });
+
+    std::vector<uint64_t> tileBitrates;
+    for (auto& candidate : candidates)
+    {
+        tileBitrates.push_back(candidate.second->GetVideoInfo().bit_rate);
+    }
+
+    int32_t keptTiles = mAbrController->SelectViewportTiles(tileBitrates, backgroundBitrate);
+    for (size_t index = keptTiles > 0 ? keptTiles : 0; index < candidates.size(); index++)
+    {
+        viewportTracks.erase(candidates[index].second->GetID());
+    }
+}
+
 std::map<int, TracksMap> OmafTileTracksSelector::GetTileTracksByPosePrediction(
     OmafMediaStream *pStream)
 {
@@ -382,31 +661,20 @@ std::map<int, TracksMap> OmafTileTracksSelector::GetTileTracksByPosePrediction(
             return predictedTracks;
         }
     }
-    if (mPredictPluginMap.size() == 0)
+    ViewportPredictPlugin *plugin = GetPredictPlugin();
+    if (!plugin)
     {
         LOG(ERROR)<<"predict plugin map is empty!"<<endl;
         return predictedTracks;
     }
 
-    ViewportPredictPlugin *plugin = mPredictPluginMap.at(mPredictPluginName);
     uint32_t pose_interval = POSE_INTERVAL;
     uint32_t pre_pose_count = PREDICTION_POSE_COUNT;
     uint32_t predict_interval = PREDICTION_INTERVAL;
     plugin->Intialize(pose_interval, pre_pose_count, predict_interval);
-    std::list<ViewportAngle> pose_history;
-    {
-        std::lock_guard<std::mutex> lock(mMutex);
-        for (auto it=mPoseHistory.begin(); it!=mPoseHistory.end(); it++)
-        {
-            ViewportAngle angle;
-            angle.yaw = it->pose->yaw;
-            angle.pitch = it->pose->pitch;
-            angle.roll = 0;
-            pose_history.push_front(angle);
-        }
-    }
-    ViewportAngle* predict_angle = plugin->Predict(pose_history);
-    if (predict_angle == NULL)
+    PredictedViewport predicted;
+    size_t poseCount = 0;
+    if (PredictPose(plugin, &predicted, &poseCount) != ERROR_NONE)
     {
         LOG(ERROR)<<"predictPose_func return an invalid value!"<<endl;
         return predictedTracks;
@@ -423,7 +691,7 @@ std::map<int, TracksMap> OmafTileTracksSelector::GetTileTracksByPosePrediction(
         }
     }
     // won't get viewport if pose hasn't changed
-    if( previousPose && mPose && !IsPoseChanged( previousPose, mPose ) && pose_history.size() > 1)
+    if( previousPose && mPose && !IsPoseChanged( previousPose, mPose ) && poseCount > 1)
     {
         LOG(INFO)<<"pose hasn't changed!"<<endl;
 #ifndef _ANDROID_NDK_OPTION_
@@ -433,7 +701,6 @@ std::map<int, TracksMap> OmafTileTracksSelector::GetTileTracksByPosePrediction(
 #endif
 #endif
         SAFE_DELETE(previousPose);
-        SAFE_DELETE(predict_angle);
         return predictedTracks;
     }
 
@@ -442,9 +709,11 @@ std::map<int, TracksMap> OmafTileTracksSelector::GetTileTracksByPosePrediction(
     if (!predictPose)
         return predictedTracks;
 
-    predictPose->yaw = predict_angle->yaw;
-    predictPose->pitch = predict_angle->pitch;
-    TracksMap selectedTracks = SelectTileTracks(pStream, predictPose);
+    predictPose->yaw = predicted.angle.yaw;
+    predictPose->pitch = predicted.angle.pitch;
+    // plugins reporting the uncertainty get the footprint over the pose distribution
+    TracksMap selectedTracks = predicted.confidence < 0 ? SelectTileTracks(pStream, predictPose)
+                                                        : SelectTileTracksByDistribution(pStream, &predicted);
     if (selectedTracks.size() && previousPose)
     {
         predictedTracks.insert(make_pair(1, selectedTracks));
@@ -459,7 +728,6 @@ std::map<int, TracksMap> OmafTileTracksSelector::GetTileTracksByPosePrediction(
     }
     SAFE_DELETE(previousPose);
     SAFE_DELETE(predictPose);
-    SAFE_DELETE(predict_angle);
     return predictedTracks;
 }
 
@@ -46,6 +46,9 @@ VCD_OMAF_BEGIN
 
 typedef std::map<int, OmafAdaptationSet*> TracksMap;
 
+#define MIN_PREFETCH_SPREAD 1.0   //<! under this standard deviation in degree, only the predicted pose is used
+#define MAX_PREFETCH_SPREAD 45.0  //<! the sampled distribution is limited to this standard deviation in degree
+
 class OmafTileTracksSelector : public OmafTracksSelector
 {
 public:
@@ -54,6 +57,7 @@ public:
     //!
     OmafTileTracksSelector(int size = POSE_SIZE) : OmafTracksSelector(size)
     {
+        m360SamplingHandle = nullptr;
     };
 
     //!
@@ -95,6 +99,15 @@ public:
     //!
     //virtual int GetSegmentPriority(OmafSegment *segment);
 
+    //!
+    //! \brief  Sample the predicted pose distribution on the center and two
+    //!         rings, at one and two standard deviations
+    //!
+    //! \return the sampled poses, each weighted by the density and the
+    //!         weights summed to 1
+    //!
+    static std::vector<std::pair<HeadPose, double>> SamplePoseDistribution(const PredictedViewport& predicted);
+
 private:
 
     TracksMap GetTileTracksByPose(OmafMediaStream* pStream);
@@ -105,9 +118,44 @@ private:
 
     TracksMap SelectTileTracks(OmafMediaStream* pStream, HeadPose* pose);
 
+    //!
+    //! \brief  Get the high quality tile tracks in the viewport of the pose
+    //!
+    //! \param  [out] tilesNum
+    //!         count of tiles in viewport calculated, <= 0 if failed
+    //! \param  [in] handle
+    //!         the 360SCVP handle the pose is projected on, the viewport
+    //!         handle if it is NULL
+    //!
+    TracksMap GetViewportTileTracks(OmafMediaStream* pStream, HeadPose* pose, int32_t* tilesNum, void* handle = NULL);
+
+    //!
+    //! \brief  Select tile tracks over the predicted pose distribution. tiles are
+    //!         ranked by the probability of being viewed, the ones under the
+    //!         minimum probability are dropped, and the rest are fetched down
+    //!         the ranking within the abr budget
+    //!
+    TracksMap SelectTileTracksByDistribution(OmafMediaStream* pStream, PredictedViewport* predicted);
+
+    //!
+    //! \brief  Add the additional high quality tile the layout needs, and all
+    //!         the low quality tracks
+    //!
+    void CompleteTileTracks(OmafMediaStream* pStream, bool needAddtionalTile, TracksMap& selectedTracks);
+
+    uint64_t GetBackgroundBitrate(OmafMediaStream* pStream);
+
+    //!
+    //! \brief  Keep the high quality tiles in viewport which fit the abr budget,
+    //!         the ones nearest to the viewport center are kept first
+    //!
+    void LimitViewportTilesByAbr(OmafMediaStream* pStream, HeadPose* pose, TracksMap& viewportTracks);
+
 private:
     TracksMap                 m_currentTracks;
+    std::set<int>             m_predictedOnlyTracks;  //<! tracks in m_currentTracks selected only by prediction
     std::map<int, TracksMap>  m_predictedTracks;
+    void*                     m360SamplingHandle;     //<! 360SCVP handle the pose distribution is sampled on
 };
 
 VCD_OMAF_END;
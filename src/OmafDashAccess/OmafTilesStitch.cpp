@@ -52,6 +52,17 @@ OmafTilesStitch::OmafTilesStitch() {
 }
 
 OmafTilesStitch::~OmafTilesStitch() {
+  ReleaseMergeStates();
+
+  SAFE_DELETE(m_360scvpParam);
+
+  if (m_360scvpHandle) {
+    I360SCVP_unInit(m_360scvpHandle);
+    m_360scvpHandle = nullptr;
+  }
+}
+
+void OmafTilesStitch::ReleaseMergeStates() {
   if (m_selectedTiles.size()) {
     std::map<QualityRank, std::map<uint32_t, MediaPacket *>>::iterator it;
     for (it = m_selectedTiles.begin(); it != m_selectedTiles.end();) {
@@ -120,13 +131,6 @@ OmafTilesStitch::~OmafTilesStitch() {
     m_updatedTilesMergeArr.clear();
   }
 
-  SAFE_DELETE(m_360scvpParam);
-
-  if (m_360scvpHandle) {
-    I360SCVP_unInit(m_360scvpHandle);
-    m_360scvpHandle = nullptr;
-  }
-
   m_allQualities.clear();
   if (m_fullResVideoHeader) {
     delete[] m_fullResVideoHeader;
@@ -154,6 +158,27 @@ OmafTilesStitch::~OmafTilesStitch() {
   m_tmpRegionrwpk = nullptr;
 }
 
+void OmafTilesStitch::Reset() {
+  ReleaseMergeStates();
+
+  if (m_360scvpParam) {
+    m_360scvpParam->pInputBitstream = nullptr;
+    m_360scvpParam->inputBitstreamLen = 0;
+  }
+  m_fullResVPSSize = 0;
+  m_fullResSPSSize = 0;
+  m_fullResPPSSize = 0;
+  m_fullWidth = 0;
+  m_fullHeight = 0;
+  m_mainMergedWidth = 0;
+  m_mainMergedHeight = 0;
+  m_mainMergedTileRows = 0;
+  m_mainMergedTileCols = 0;
+  m_needHeaders = false;
+  m_isInitialized = false;
+  m_projFmt = PF_UNKNOWN;
+}
+
 int32_t OmafTilesStitch::Initialize(std::map<uint32_t, MediaPacket *> &firstFramePackets, bool needParams,
                                     VCD::OMAF::ProjectionFormat projFmt) {
   if (0 == firstFramePackets.size()) {
@@ -247,8 +272,8 @@ int32_t OmafTilesStitch::Initialize(std::map<uint32_t, MediaPacket *> &firstFram
 int32_t OmafTilesStitch::ParseVideoHeader(MediaPacket *tilePacket) {
   if (!tilePacket) return OMAF_ERROR_NULL_PTR;
 
-  if (m_360scvpParam || m_360scvpHandle) {
-    LOG(ERROR) << "There should be no 360SCVP library usage before parsing video headers ! " << std::endl;
+  if (m_fullResVideoHeader) {
+    LOG(ERROR) << "There should be no video headers parsed before ! " << std::endl;
     return OMAF_ERROR_INVALID_DATA;
   }
   bool hasHeader = tilePacket->GetHasVideoHeader();
@@ -265,20 +290,33 @@ int32_t OmafTilesStitch::ParseVideoHeader(MediaPacket *tilePacket) {
   m_fullResVideoHeader = new uint8_t[fullResHeaderSize];
   memset(m_fullResVideoHeader, 0, fullResHeaderSize);
   memcpy_s(m_fullResVideoHeader, fullResHeaderSize, (uint8_t *)(tilePacket->Payload()), fullResHeaderSize);
-  m_360scvpParam = new param_360SCVP;
-  if (!m_360scvpParam) return OMAF_ERROR_NULL_PTR;
 
-  memset(m_360scvpParam, 0, sizeof(param_360SCVP));
-  m_360scvpParam->usedType = E_PARSER_ONENAL;
+  if (!m_360scvpParam) {
+    m_360scvpParam = new param_360SCVP;
+    if (!m_360scvpParam) return OMAF_ERROR_NULL_PTR;
+
+    memset(m_360scvpParam, 0, sizeof(param_360SCVP));
+    m_360scvpParam->usedType = E_PARSER_ONENAL;
+  }
   m_360scvpParam->pInputBitstream = m_fullResVideoHeader;
   m_360scvpParam->inputBitstreamLen = fullResHeaderSize;
 
+  // the parser handle keeps the parameter sets and slice states of the former media,
+  // so a new one is created for the headers of each media
+  if (m_360scvpHandle) {
+    I360SCVP_unInit(m_360scvpHandle);
+    m_360scvpHandle = nullptr;
+  }
   m_360scvpHandle = I360SCVP_Init(m_360scvpParam);
   if (!m_360scvpHandle) {
     LOG(ERROR) << "Failed to initialize 360SCVP library handle !" << std::endl;
     return OMAF_ERROR_NULL_PTR;
   }
 
+  return ParseParameterSets(fullResHeaderSize);
+}
+
+int32_t OmafTilesStitch::ParseParameterSets(uint32_t fullResHeaderSize) {
   Nalu *oneNalu = new Nalu;
   if (!oneNalu) return OMAF_ERROR_NULL_PTR;
 
@@ -441,7 +479,7 @@ int32_t OmafTilesStitch::UpdateSelectedTiles(std::map<uint32_t, MediaPacket *> &
     middlePackets.clear();
     tracksID.clear();
 
-    LOG(INFO) << "In Update, For quality ranking  " << static_cast<int>(oneQuality) << " , there are total  "
+    LOG_TRACE << "In Update, For quality ranking  " << static_cast<int>(oneQuality) << " , there are total  "
               << packets.size() << "  tiles needed to be merged !" << std::endl;
 
     m_selectedTiles.insert(std::make_pair(oneQuality, packets));
@@ -490,7 +528,7 @@ std::map<QualityRank, TilesMergeArrangement *> OmafTilesStitch::CalculateTilesMe
       sqrtedSize--;
     }
     uint32_t divdedSize = packetsSize / sqrtedSize;
-    LOG(INFO) << "sqrtedSize  " << sqrtedSize << "  and divdedSize  " << divdedSize << endl;
+    LOG_TRACE << "sqrtedSize  " << sqrtedSize << "  and divdedSize  " << divdedSize << endl;
     if (divdedSize > sqrtedSize) {
       tileColsNum = divdedSize;
       tileRowsNum = sqrtedSize;
@@ -583,7 +621,7 @@ std::unique_ptr<RegionWisePacking> OmafTilesStitch::CalculateMergedRwpkForERP(Qu
     LOG(ERROR) << "There is no tiles merge layout before calculating rwpk !" << std::endl;
     return nullptr;
   }
-  LOG(INFO) << "hasPacketLost:" << hasPacketLost << " hasLayoutChanged:" << hasLayoutChanged << endl;
+  LOG_TRACE << "hasPacketLost:" << hasPacketLost << " hasLayoutChanged:" << hasLayoutChanged << endl;
   if (!hasPacketLost && !hasLayoutChanged) {
     if (0 == m_updatedTilesMergeArr.size()) {
       itArr = m_initTilesMergeArr.find(qualityRanking);
@@ -732,7 +770,7 @@ std::unique_ptr<RegionWisePacking> OmafTilesStitch::CalculateMergedRwpkForCubeMa
     LOG(ERROR) << "There is no tiles merge layout before calculating rwpk !" << std::endl;
     return NULL;
   }
-  LOG(INFO) << "hasPacketLost:" << hasPacketLost << " hasLayoutChanged:" << hasLayoutChanged << endl;
+  LOG_TRACE << "hasPacketLost:" << hasPacketLost << " hasLayoutChanged:" << hasLayoutChanged << endl;
   if (!hasPacketLost && !hasLayoutChanged) {
     if (0 == m_updatedTilesMergeArr.size()) {
       itArr = m_initTilesMergeArr.find(qualityRanking);
@@ -865,7 +903,7 @@ int32_t OmafTilesStitch::GenerateTilesMergeArrangement() {
   } else {
     if (m_updatedTilesMergeArr.size()) {
       if (m_initTilesMergeArr.size() != m_updatedTilesMergeArr.size())
-        LOG(INFO)
+        LOG_EVERY_MS(INFO, LOG_INTERVAL_MS)
             << "The number of tiles merged video streams has been changed compared with the number at the beginning !"
             << std::endl;
 
@@ -956,29 +994,29 @@ int32_t OmafTilesStitch::GenerateOutputMergedPackets() {
     }
 
     if ((width == initWidth) && (height < initHeight)) {
-      LOG(INFO) << "Packet not lost but tiles merge layout has been changed !" << std::endl;
+      LOG_EVERY_MS(INFO, LOG_INTERVAL_MS) << "Packet not lost but tiles merge layout has been changed !" << std::endl;
       arrangeChanged = true;
       isArrChanged = true;
     }
 
     if ((height == initHeight) && (width < initWidth)) {
-      LOG(INFO) << "Packet not lost but tiles merge layout has been changed !" << std::endl;
+      LOG_EVERY_MS(INFO, LOG_INTERVAL_MS) << "Packet not lost but tiles merge layout has been changed !" << std::endl;
       arrangeChanged = true;
       isArrChanged = true;
     }
 
     if ((width < initWidth) && (height < initHeight)) {
-      LOG(INFO) << "Packet not lost but tiles merge layout has been changed !" << std::endl;
+      LOG_EVERY_MS(INFO, LOG_INTERVAL_MS) << "Packet not lost but tiles merge layout has been changed !" << std::endl;
       arrangeChanged = true;
       isArrChanged = true;
     }
 
     if ((width > initWidth) || (height > initHeight)) {
-      LOG(INFO) << "Packet not lost but tiles merge layout has been changed !" << std::endl;
+      LOG_EVERY_MS(INFO, LOG_INTERVAL_MS) << "Packet not lost but tiles merge layout has been changed !" << std::endl;
       arrangeChanged = true;
       isArrChanged = true;
     }
-    LOG(INFO) << "arrangeChanged  " << arrangeChanged << "isArrChanged " << isArrChanged << std::endl;
+    LOG_TRACE << "arrangeChanged  " << arrangeChanged << "isArrChanged " << isArrChanged << std::endl;
     if (arrangeChanged && m_mergedVideoHeaders[qualityRanking].size()) {
       std::map<uint32_t, uint8_t *> oneVideoHeader = m_mergedVideoHeaders[qualityRanking];
       std::map<uint32_t, uint8_t *>::iterator itHdr = oneVideoHeader.begin();
@@ -1057,6 +1095,12 @@ int32_t OmafTilesStitch::GenerateOutputMergedPackets() {
       rwpk = CalculateMergedRwpkForCubeMap(qualityRanking, packetLost, arrangeChanged);
     }
     if (rwpk.get() == nullptr) return OMAF_ERROR_GENERATE_RWPK;
+    // the merged rwpk is the same while the arrangement is kept, share it among the merged packets
+    VCD::VRVideo::SharedRwpk::Ptr sharedRwpk = VCD::VRVideo::RWPKCACHE::GetInstance()->Share(*rwpk);
+    delete[] rwpk->rectRegionPacking;
+    rwpk->rectRegionPacking = nullptr;
+    m_tmpRegionrwpk = nullptr;
+    if (sharedRwpk.get() == nullptr) return OMAF_ERROR_GENERATE_RWPK;
 
     std::map<uint32_t, MediaPacket *> packets = m_selectedTiles[qualityRanking];
     std::map<uint32_t, MediaPacket *>::iterator itPacket;
@@ -1064,7 +1108,7 @@ int32_t OmafTilesStitch::GenerateOutputMergedPackets() {
     MediaPacket *mergedPacket = new MediaPacket();
     uint32_t packetSize = ((width * height * 3) / 2) / 2;
     mergedPacket->ReAllocatePacket(packetSize);
-    mergedPacket->SetRwpk(std::move(rwpk));
+    mergedPacket->SetRwpk(sharedRwpk);
     char *mergedData = mergedPacket->Payload();
     uint64_t realSize = 0;
     if (m_needHeaders) {
@@ -130,6 +130,12 @@ class OmafTilesStitch {
   //!
   bool IsInitialized() { return m_isInitialized; };
 
+  //!
+  //! \brief  Release the states of the merged media and turn back to uninitialized,
+  //!         the 360SCVP library handle is recreated for the headers of the next media
+  //!
+  void Reset();
+
  private:
   //!
   //! \brief  Parse the VPS/SPS/PPS information
@@ -143,6 +149,23 @@ class OmafTilesStitch {
   //!
   int32_t ParseVideoHeader(MediaPacket *tilePacket);
 
+  //!
+  //! \brief  Parse the VPS/SPS/PPS of the full resolution video header
+  //!         with the 360SCVP library handle
+  //!
+  //! \param  [in] fullResHeaderSize
+  //!         the size of the full resolution video header
+  //!
+  //! \return int32_t
+  //!         ERROR_NONE if success, else failed reason
+  //!
+  int32_t ParseParameterSets(uint32_t fullResHeaderSize);
+
+  //!
+  //! \brief  Release the selected tiles, merge arrangements and headers
+  //!
+  void ReleaseMergeStates();
+
   //!
   //! \brief  Calculate tiles merge layout for selected tiles
   //!
@@ -46,6 +46,8 @@ OmafTracksSelector::OmafTracksSelector(int size) {
   mPredictPluginName = "";
   mLibPath = "";
   mProjFmt = ProjectionFormat::PF_ERP;
+  mPendingPredictPlugin = nullptr;
+  mMinViewProbability = DEFAULT_MIN_VIEW_PROBABILITY;
 }
 
 OmafTracksSelector::~OmafTracksSelector() {
@@ -71,6 +73,7 @@ OmafTracksSelector::~OmafTracksSelector() {
 
     mPredictPluginMap.clear();
   }
+  SAFE_DELETE(mPendingPredictPlugin);
 
   mUsePrediction = false;
 
@@ -183,17 +186,109 @@ int OmafTracksSelector::InitializePredictPlugins() {
     LOG(ERROR) << "Viewport predict plugin path OR name is invalid!" << endl;
     return ERROR_INVALID;
   }
+  ViewportPredictPlugin *plugin = CreatePredictPlugin(mPredictPluginName, mLibPath);
+  if (!plugin) return ERROR_INVALID;
+
+  std::lock_guard<std::mutex> lock(mPluginMutex);
+  mPredictPluginMap.insert(std::pair<std::string, ViewportPredictPlugin *>(mPredictPluginName, plugin));
+  return ERROR_NONE;
+}
+
+ViewportPredictPlugin *OmafTracksSelector::CreatePredictPlugin(std::string predictPluginName, std::string libPath) {
   ViewportPredictPlugin *plugin = new ViewportPredictPlugin();
-  if (!plugin) return ERROR_NULL_PTR;
+  if (!plugin) return nullptr;
 
-  std::string pluginPath = mLibPath + mPredictPluginName;
+  std::string pluginPath = libPath + predictPluginName;
   int ret = plugin->LoadPlugin(pluginPath.c_str());
   if (ret != ERROR_NONE) {
     LOG(ERROR) << "Load plugin failed!" << endl;
     SAFE_DELETE(plugin);
-    return ret;
+    return nullptr;
   }
-  mPredictPluginMap.insert(std::pair<std::string, ViewportPredictPlugin *>(mPredictPluginName, plugin));
+  ret = plugin->Intialize(POSE_INTERVAL, PREDICTION_POSE_COUNT, PREDICTION_INTERVAL);
+  if (ret != ERROR_NONE) {
+    LOG(ERROR) << "Initialize plugin failed!" << endl;
+    SAFE_DELETE(plugin);
+    return nullptr;
+  }
+  return plugin;
+}
+
+int OmafTracksSelector::SwapPredictPlugin(std::string predictPluginName, std::string libPath) {
+  if (libPath.empty() || predictPluginName.empty()) {
+    LOG(ERROR) << "Viewport predict plugin path OR name is invalid!" << endl;
+    return ERROR_INVALID;
+  }
+  if (!mUsePrediction) {
+    LOG(ERROR) << "Viewport prediction is not enabled, no plugin to swap!" << endl;
+    return ERROR_INVALID;
+  }
+
+  // load outside of the lock, selection goes on with the old plugin meanwhile
+  ViewportPredictPlugin *plugin = CreatePredictPlugin(predictPluginName, libPath);
+  if (!plugin) return ERROR_INVALID;
+
+  std::lock_guard<std::mutex> lock(mPluginMutex);
+  SAFE_DELETE(mPendingPredictPlugin);
+  mPendingPredictPlugin = plugin;
+  mPendingPredictPluginName = predictPluginName;
+  LOG(INFO) << "Viewport predict plugin " << predictPluginName << " will be swapped in at next segment!" << endl;
+  return ERROR_NONE;
+}
+
+ViewportPredictPlugin *OmafTracksSelector::GetPredictPlugin() {
+  std::lock_guard<std::mutex> lock(mPluginMutex);
+  // the old plugin is only used by the selection thread, which is here now
+  if (mPendingPredictPlugin) {
+    for (auto &p : mPredictPluginMap) {
+      SAFE_DELETE(p.second);
+    }
+    mPredictPluginMap.clear();
+    mPredictPluginName = mPendingPredictPluginName;
+    mPredictPluginMap.insert(std::pair<std::string, ViewportPredictPlugin *>(mPredictPluginName, mPendingPredictPlugin));
+    mPendingPredictPlugin = nullptr;
+    LOG(INFO) << "Swapped in viewport predict plugin " << mPredictPluginName << endl;
+  }
+
+  auto it = mPredictPluginMap.find(mPredictPluginName);
+  if (it == mPredictPluginMap.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+int OmafTracksSelector::PredictPose(ViewportPredictPlugin *plugin, PredictedViewport *predicted, size_t *poseCount) {
+  if (!plugin || !predicted || !poseCount) return ERROR_NULL_PTR;
+
+  std::list<ViewportPose> pose_history;
+  uint64_t predict_pts = 0;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mPoseHistory.empty()) return ERROR_INVALID;
+    // the latest pose is at the front, the plugin wants the oldest first
+    for (auto it = mPoseHistory.begin(); it != mPoseHistory.end(); it++) {
+      ViewportPose pose;
+      pose.angle.yaw = it->pose->yaw;
+      pose.angle.pitch = it->pose->pitch;
+      pose.angle.roll = 0;
+      pose.pts = it->time;
+      pose_history.push_front(pose);
+    }
+    predict_pts = mPoseHistory.front().time + PREDICTION_INTERVAL;
+  }
+  *poseCount = pose_history.size();
+  return plugin->PredictTimed(pose_history, predict_pts, predicted);
+}
+
+int OmafTracksSelector::GetPredictPluginStats(PluginTimingStats *stats) {
+  if (!stats) return ERROR_NULL_PTR;
+
+  std::lock_guard<std::mutex> lock(mPluginMutex);
+  auto it = mPredictPluginMap.find(mPredictPluginName);
+  if (it == mPredictPluginMap.end() || !(it->second)) {
+    return ERROR_NOT_FOUND;
+  }
+  it->second->GetTimingStats(stats);
   return ERROR_NONE;
 }
 
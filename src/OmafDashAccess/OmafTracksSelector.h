@@ -36,6 +36,7 @@
 #define OMAFTRACKSSELECTOR_H
 
 #include "360SCVPViewportAPI.h"
+#include "OmafAbrController.h"
 #include "OmafMediaStream.h"
 #include "OmafViewportPredict/ViewportPredictPlugin.h"
 #include "general.h"
@@ -88,6 +89,18 @@ class OmafTracksSelector {
   //!
   int EnablePosePrediction(std::string predictPluginName, std::string libPath);
 
+  //!
+  //! \brief  Swap the viewport prediction plugin. the new plugin is loaded and
+  //!         initialized at once, and replaces the one in use when the tracks
+  //!         for next segment are selected, the old one is kept if it fails
+  //!
+  int SwapPredictPlugin(std::string predictPluginName, std::string libPath);
+
+  //!
+  //! \brief  Get the timing counters of the viewport prediction plugin in use
+  //!
+  int GetPredictPluginStats(PluginTimingStats *stats);
+
   //!
   //! \brief  Get the priority of the segment
   //!
@@ -95,6 +108,16 @@ class OmafTracksSelector {
 
   void SetProjectionFmt(ProjectionFormat projFmt) { mProjFmt = projFmt; };
 
+  //!
+  //! \brief  Set the abr controller which limits the high quality tiles in viewport
+  //!
+  void SetAbrController(std::shared_ptr<OmafAbrController> abr) { mAbrController = abr; };
+
+  //!
+  //! \brief  Set the minimum probability of being viewed for a predicted tile to be fetched
+  //!
+  void SetMinViewProbability(double probability) { mMinViewProbability = probability; };
+
 private:
     OmafTracksSelector& operator=(const OmafTracksSelector& other) { return *this; };
     OmafTracksSelector(const OmafTracksSelector& other) { /* do not create copies */ };
@@ -105,6 +128,27 @@ private:
   //!
   int InitializePredictPlugins();
 
+  //!
+  //! \brief  Load and initialize one viewport prediction plugin
+  //!
+  ViewportPredictPlugin *CreatePredictPlugin(std::string predictPluginName, std::string libPath);
+
+ protected:
+  //!
+  //! \brief  Get the viewport prediction plugin in use, the swapped plugin
+  //!         takes effect here, at the segment boundary
+  //!
+  ViewportPredictPlugin *GetPredictPlugin();
+
+  //!
+  //! \brief  Predict the pose after PREDICTION_INTERVAL from the latest one,
+  //!         the timestamps in mPoseHistory are passed to the plugin
+  //!
+  //! \param  [out] poseCount
+  //!         the number of poses the prediction is made from
+  //!
+  int PredictPose(ViewportPredictPlugin *plugin, PredictedViewport *predicted, size_t *poseCount);
+
  protected:
   std::list<PoseInfo> mPoseHistory;
   int mSize;
@@ -116,7 +160,12 @@ private:
   std::string mPredictPluginName;
   std::string mLibPath;
   std::map<std::string, ViewportPredictPlugin *> mPredictPluginMap;
+  std::mutex mPluginMutex;                        //<! protect the plugin in use against the swap
+  ViewportPredictPlugin *mPendingPredictPlugin;   //<! plugin to be swapped in at next segment
+  std::string mPendingPredictPluginName;
   ProjectionFormat mProjFmt;
+  std::shared_ptr<OmafAbrController> mAbrController;
+  double mMinViewProbability;
 };
 
 VCD_OMAF_END;
@@ -35,6 +35,7 @@
 #ifndef OMAF_TYPES_H
 #define OMAF_TYPES_H
 
+#include <chrono>
 #include <sstream>
 #include <string>
 extern "C" {
@@ -46,6 +47,14 @@ namespace OMAF {
 
 const long DEFAULT_MAX_PARALLEL_TRANSFERS = 20;
 const int32_t DEFAULT_SEGMENT_OPEN_TIMEOUT = 3000;
+const double DEFAULT_MIN_VIEW_PROBABILITY = 0.05;
+
+enum class HttpVersion {
+  DEFAULT = 0,     // let libcurl decide
+  HTTP1_1 = 1,     // force HTTP/1.1
+  HTTP2_TLS = 2,   // HTTP/2 negotiated with ALPN on https, HTTP/1.1 on http
+  HTTP2_PRIOR = 3, // HTTP/2 without upgrade, h2c stand-in or known h2 origin
+};
 
 class OmafDashHttpProxy {
  public:
@@ -74,6 +83,14 @@ class OmafDashHttpParams {
   int32_t retry_times_ = -1;
   bool bssl_verify_peer_ = false;
   bool bssl_verify_host_ = false;
+
+  HttpVersion http_version_ = HttpVersion::DEFAULT;
+  // multiplex transfers to one origin over a single connection when the server speaks HTTP/2
+  bool bmultiplex_ = true;
+  bool btcp_keepalive_ = true;
+  long max_host_connections_ = -1;    // not set when <= 0
+  long max_concurrent_streams_ = -1;  // not set when <= 0, needs libcurl 7.67.0+
+  int32_t warmup_connections_ = 0;    // connections to open ahead of the first segment request
   std::string to_string() {
     std::stringstream ss;
     ss << "http params: {" << std::endl;
@@ -82,6 +99,12 @@ class OmafDashHttpParams {
     ss << "\tretry times: " << retry_times_ << "" << std::endl;
     ss << "\tssl verify peer state: " << bssl_verify_peer_ << "" << std::endl;
     ss << "\tssl verify host state: " << bssl_verify_host_ << "" << std::endl;
+    ss << "\thttp version: " << static_cast<int>(http_version_) << ", " << std::endl;
+    ss << "\tmultiplex state: " << bmultiplex_ << ", " << std::endl;
+    ss << "\ttcp keepalive state: " << btcp_keepalive_ << ", " << std::endl;
+    ss << "\tmax host connections: " << max_host_connections_ << ", " << std::endl;
+    ss << "\tmax concurrent streams: " << max_concurrent_streams_ << ", " << std::endl;
+    ss << "\twarmup connections: " << warmup_connections_ << "" << std::endl;
     ss << "}";
     return ss.str();
   }
@@ -119,18 +142,86 @@ struct _omafDashPredictorParams {
   std::string name_;
   std::string libpath_;
   bool enable_ = false;
+  double min_view_probability_ = DEFAULT_MIN_VIEW_PROBABILITY;  // predicted tiles less likely to be viewed are not fetched
   std::string to_string() {
     std::stringstream ss;
     ss << "dash statistics params: {" << std::endl;
     ss << "\tstate: " << enable_ << std::endl;
     ss << "\tname: " << name_ << std::endl;
     ss << "\tlib path: " << libpath_ << std::endl;
+    ss << "\tmin view probability: " << min_view_probability_ << std::endl;
     ss << "}" << std::endl;
     return ss.str();
   }
 };
 using OmafDashPredictorParams = struct _omafDashPredictorParams;
 
+struct _omafDashAbrParams {
+  bool enable_ = false;
+  double fast_ewma_alpha_ = 0.5;      // weight of the latest sample for the fast estimator
+  double slow_ewma_alpha_ = 0.125;    // weight of the latest sample for the slow estimator
+  int32_t harmonic_window_size_ = 5;  // samples for the harmonic mean
+  int32_t max_sample_span_ms_ = 1000; // overlapped transfers are merged into one sample up to this span
+  double safety_factor_ = 0.9;        // part of the estimated throughput which can be spent
+  double switch_up_margin_ = 0.1;     // extra headroom required before adding high quality tiles
+  int32_t min_buffer_ms_ = 1000;      // under this level, only half of the budget is spent
+  int32_t target_buffer_ms_ = 3000;   // from this level, the whole budget is spent
+  int32_t min_viewport_hq_tiles_ = 1; // high quality tiles always kept in viewport
+  std::string to_string() {
+    std::stringstream ss;
+    ss << "dash abr params: {" << std::endl;
+    ss << "\tstate: " << enable_ << std::endl;
+    ss << "\tewma alpha: fast=" << fast_ewma_alpha_ << ", slow=" << slow_ewma_alpha_ << std::endl;
+    ss << "\tharmonic window size: " << harmonic_window_size_ << std::endl;
+    ss << "\tmax sample span: " << max_sample_span_ms_ << " ms" << std::endl;
+    ss << "\tsafety factor: " << safety_factor_ << std::endl;
+    ss << "\tswitch up margin: " << switch_up_margin_ << std::endl;
+    ss << "\tbuffer: min=" << min_buffer_ms_ << " ms, target=" << target_buffer_ms_ << " ms" << std::endl;
+    ss << "\tmin viewport high quality tiles: " << min_viewport_hq_tiles_ << std::endl;
+    ss << "}" << std::endl;
+    return ss.str();
+  }
+};
+using OmafDashAbrParams = struct _omafDashAbrParams;
+
+struct _omafDashCacheParams {
+  bool enable_ = false;
+  int64_t memory_budget_ = 64 * 1024 * 1024;  // bytes of segments kept in memory
+  bool enable_spill_ = false;                  // evicted segments go to the spill file instead of dropped
+  std::string spill_file_;                     // single append-only file, removed when the cache is released
+  int64_t spill_budget_ = 256 * 1024 * 1024;   // bytes of the spill file, it restarts from empty when full
+  bool enable_init_cache_ = false;             // init segments are kept on disk and revalidated by etag
+  std::string init_cache_dir_;                 // folder of the init segments, kept between sessions
+  std::string to_string() {
+    std::stringstream ss;
+    ss << "dash segment cache params: {" << std::endl;
+    ss << "\tstate: " << enable_ << std::endl;
+    ss << "\tmemory budget: " << memory_budget_ << " bytes" << std::endl;
+    ss << "\tspill: state=" << enable_spill_ << ", file=" << spill_file_ << ", budget=" << spill_budget_ << " bytes"
+       << std::endl;
+    ss << "\tinit cache: state=" << enable_init_cache_ << ", folder=" << init_cache_dir_ << std::endl;
+    ss << "}" << std::endl;
+    return ss.str();
+  }
+};
+using OmafDashCacheParams = struct _omafDashCacheParams;
+
+struct _omafDashSubSegmentParams {
+  bool enable_ = false;
+  int64_t index_probe_size_ = 4096;  // bytes of the segment head fetched for the sidx
+  int32_t check_interval_ms_ = 200;  // viewport check interval between the segment requests
+  std::string to_string() {
+    std::stringstream ss;
+    ss << "dash sub segment params: {" << std::endl;
+    ss << "\tstate: " << enable_ << std::endl;
+    ss << "\tindex probe size: " << index_probe_size_ << " bytes" << std::endl;
+    ss << "\tcheck interval: " << check_interval_ms_ << " ms" << std::endl;
+    ss << "}" << std::endl;
+    return ss.str();
+  }
+};
+using OmafDashSubSegmentParams = struct _omafDashSubSegmentParams;
+
 class OmafDashParams {
  public:
  public:
@@ -139,6 +230,9 @@ class OmafDashParams {
   OmafDashStatisticsParams stats_params_;
   OmafDashSynchronizerParams syncer_params_;
   OmafDashPredictorParams prediector_params_;
+  OmafDashAbrParams abr_params_;
+  OmafDashCacheParams cache_params_;
+  OmafDashSubSegmentParams sub_segment_params_;
   long max_parallel_transfers_ = DEFAULT_MAX_PARALLEL_TRANSFERS;
   int32_t segment_open_timeout_ms_ = DEFAULT_SEGMENT_OPEN_TIMEOUT;
   std::string to_string() {
@@ -149,19 +243,26 @@ class OmafDashParams {
     ss << stats_params_.to_string();
     ss << syncer_params_.to_string();
     ss << prediector_params_.to_string();
+    ss << abr_params_.to_string();
+    ss << cache_params_.to_string();
+    ss << sub_segment_params_.to_string();
     return ss.str();
   }
 };
 
+// priority class of a download, smaller value is served first
 enum class TaskPriority {
-  HIGH = 0,
-  NORMAL = 1,
-  LOW = 2,
-  END = 3,
+  FALLBACK = 0,  // low resolution fallback track and init segments, never dropped or cancelled
+  HIGH = 1,      // high quality tiles in the current viewport
+  NORMAL = 2,
+  LOW = 3,       // speculative tiles, such as the ones only in the predicted viewport
+  END = 4,
 };
 
 inline std::string priority(TaskPriority p) {
   switch (p) {
+    case TaskPriority::FALLBACK:
+      return "FALLBACK";
     case TaskPriority::HIGH:
       return "HIGH";
     case TaskPriority::NORMAL:
@@ -178,11 +279,26 @@ class DashSegmentSourceParams {
   int64_t timeline_point_ = -1;
   std::string dash_url_;  // unique in the system
   TaskPriority priority_ = TaskPriority::LOW;
+  // playout deadline, the queued download is done with timeout after it, max for no deadline
+  std::chrono::steady_clock::time_point deadline_ = std::chrono::steady_clock::time_point::max();
+  // byte range of the request, -1 for the whole resource or to the end of it
+  int64_t range_offset_ = -1;
+  int64_t range_size_ = -1;
+  // init segment of the track, it may be served from the init segment cache
+  bool init_segment_ = false;
   std::string to_string() const noexcept {
     std::stringstream ss;
     ss << "url=" << dash_url_;
+    if (range_offset_ >= 0 || range_size_ > 0) {
+      ss << ", range=" << range_offset_ << "/" << range_size_;
+    }
     ss << ", priority=" << priority(priority_);
     ss << ", timeline_point=" << timeline_point_;
+    if (deadline_ != std::chrono::steady_clock::time_point::max()) {
+      ss << ", deadline in="
+         << std::chrono::duration_cast<std::chrono::milliseconds>(deadline_ - std::chrono::steady_clock::now()).count()
+         << " ms";
+    }
     return ss.str();
   }
 };
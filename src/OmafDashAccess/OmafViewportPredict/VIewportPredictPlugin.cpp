@@ -36,19 +36,44 @@
 
 #include "ViewportPredictPlugin.h"
 #include <dlfcn.h>
+#include <chrono>
+#include <vector>
 
 VCD_OMAF_BEGIN
 
+// clear the stale error before looking up, and take a symbol resolved to NULL as missing
+static void* LoadSymbol(void* libHandler, const char* name)
+{
+    dlerror();
+    void* symbol = dlsym(libHandler, name);
+    if (dlerror() != NULL)
+    {
+        return NULL;
+    }
+    return symbol;
+}
+
 ViewportPredictPlugin::ViewportPredictPlugin()
 {
     m_libHandler      = NULL;
     m_predictHandler  = NULL;
     m_predictFunc     = NULL;
+    m_predictTimedFunc = NULL;
     m_initFunc        = NULL;
+    m_destroyFunc     = NULL;
+    m_apiVersion      = 0;
+    m_capabilities    = 0;
+    memset(&m_timingStats, 0, sizeof(PluginTimingStats));
 }
 
 ViewportPredictPlugin::~ViewportPredictPlugin()
 {
+    if (m_predictHandler && m_destroyFunc)
+    {
+        m_destroyFunc(m_predictHandler);
+    }
+    m_predictHandler = NULL;
+
     if (m_libHandler)
     {
         dlclose(m_libHandler);
@@ -68,25 +93,77 @@ int ViewportPredictPlugin::LoadPlugin(const char* lib_path)
         LOG(ERROR)<<"failed to open predict library path!"<<endl;
         return ERROR_NULL_PTR;
     }
-    m_initFunc = (INIT_FUNC)dlsym(m_libHandler, "ViewportPredict_Init");
-    if (dlerror() != NULL)
+    m_initFunc = (INIT_FUNC)LoadSymbol(m_libHandler, "ViewportPredict_Init");
+    if (!m_initFunc)
     {
         LOG(ERROR)<<"failed to load ViewportPredict_Init func!"<<endl;
         dlclose(m_libHandler);
+        m_libHandler = NULL;
         return ERROR_INVALID;
     }
-    m_predictFunc = (PREDICTPOSE_FUNC)dlsym(m_libHandler, "ViewportPredict_PredictPose");
-    if (dlerror() != NULL)
+    m_predictFunc = (PREDICTPOSE_FUNC)LoadSymbol(m_libHandler, "ViewportPredict_PredictPose");
+    if (!m_predictFunc)
     {
         LOG(ERROR)<<"failed to load ViewportPredict_PredictPose func!"<<endl;
         dlclose(m_libHandler);
+        m_libHandler = NULL;
+        return ERROR_INVALID;
+    }
+
+    // plugins built before the versioned API don't export the version
+    m_apiVersion = (VIEWPORT_PREDICT_API_VERSION_MAJOR << 16);
+    m_capabilities = 0;
+    GETAPIVERSION_FUNC getVersionFunc = (GETAPIVERSION_FUNC)LoadSymbol(m_libHandler, "ViewportPredict_GetAPIVersion");
+    if (getVersionFunc)
+    {
+        m_apiVersion = getVersionFunc();
+    }
+    if ((m_apiVersion >> 16) != VIEWPORT_PREDICT_API_VERSION_MAJOR)
+    {
+        LOG(ERROR)<<"predict plugin API version "<<(m_apiVersion >> 16)<<"."<<(m_apiVersion & 0xFFFF)
+                  <<" is not compatible with "<<VIEWPORT_PREDICT_API_VERSION_MAJOR<<"."<<VIEWPORT_PREDICT_API_VERSION_MINOR<<"!"<<endl;
+        dlclose(m_libHandler);
+        m_libHandler = NULL;
         return ERROR_INVALID;
     }
+
+    GETCAPABILITIES_FUNC getCapsFunc = (GETCAPABILITIES_FUNC)LoadSymbol(m_libHandler, "ViewportPredict_GetCapabilities");
+    if (getCapsFunc)
+    {
+        m_capabilities = getCapsFunc() & VIEWPORT_PREDICT_HOST_CAPABILITIES;
+    }
+    if (m_capabilities & VIEWPORT_PREDICT_CAP_DESTROY)
+    {
+        m_destroyFunc = (DESTROY_FUNC)LoadSymbol(m_libHandler, "ViewportPredict_Destroy");
+        if (!m_destroyFunc)
+        {
+            m_capabilities &= ~VIEWPORT_PREDICT_CAP_DESTROY;
+        }
+    }
+    if (m_capabilities & VIEWPORT_PREDICT_CAP_TIMED)
+    {
+        m_predictTimedFunc = (PREDICTPOSETIMED_FUNC)LoadSymbol(m_libHandler, "ViewportPredict_PredictPoseTimed");
+        if (!m_predictTimedFunc)
+        {
+            m_capabilities &= ~VIEWPORT_PREDICT_CAP_TIMED;
+        }
+    }
+    LOG(INFO)<<"predict plugin API version "<<(m_apiVersion >> 16)<<"."<<(m_apiVersion & 0xFFFF)
+             <<", capabilities 0x"<<std::hex<<m_capabilities<<std::dec<<endl;
     return ERROR_NONE;
 }
 
 int ViewportPredictPlugin::Intialize(uint32_t pose_interval, uint32_t pre_pose_count, uint32_t predict_interval)
 {
+    // the handler keeps the pose parameters, no need to create it again
+    if (m_predictHandler)
+    {
+        return ERROR_NONE;
+    }
+    if (NULL == m_initFunc)
+    {
+        return ERROR_NULL_PTR;
+    }
     Handler predict_handler = m_initFunc(pose_interval, pre_pose_count, predict_interval);
     if (NULL == predict_handler)
     {
@@ -104,7 +181,10 @@ ViewportAngle* ViewportPredictPlugin::Predict(std::list<ViewportAngle> pose_hist
         LOG(ERROR)<<"pose history is empty now!"<<endl;
         return NULL;
     }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     ViewportAngle* predict_angle = m_predictFunc(m_predictHandler, pose_history);
+    uint64_t spent_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    UpdateTimingStats(spent_us, predict_angle == NULL);
     if (predict_angle == NULL)
     {
         LOG(ERROR)<<"predictPose_func return an invalid value!"<<endl;
@@ -113,4 +193,73 @@ ViewportAngle* ViewportPredictPlugin::Predict(std::list<ViewportAngle> pose_hist
     return predict_angle;
 }
 
+int ViewportPredictPlugin::PredictTimed(std::list<ViewportPose> pose_history, uint64_t predict_pts, PredictedViewport *predicted)
+{
+    if (NULL == predicted)
+    {
+        return ERROR_NULL_PTR;
+    }
+    if (pose_history.size() == 0)
+    {
+        LOG(ERROR)<<"pose history is empty now!"<<endl;
+        return ERROR_INVALID;
+    }
+    if (NULL == m_predictTimedFunc)
+    {
+        std::list<ViewportAngle> angles;
+        for (auto it = pose_history.begin(); it != pose_history.end(); it++)
+        {
+            angles.push_back(it->angle);
+        }
+        ViewportAngle* predict_angle = Predict(angles);
+        if (predict_angle == NULL)
+        {
+            return ERROR_INVALID;
+        }
+        memset(predicted, 0, sizeof(PredictedViewport));
+        predicted->angle = *predict_angle;
+        predicted->confidence = -1.0f;
+        SAFE_DELETE(predict_angle);
+        return ERROR_NONE;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    // the plugin takes a plain array, no C++ container crosses the library boundary
+    std::vector<ViewportPose> poses(pose_history.begin(), pose_history.end());
+    int32_t ret = m_predictTimedFunc(m_predictHandler, poses.data(), (uint32_t)poses.size(), predict_pts, predicted);
+    uint64_t spent_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    UpdateTimingStats(spent_us, ret != 0);
+    if (ret != 0)
+    {
+        LOG(ERROR)<<"predictPoseTimed_func failed with "<<ret<<"!"<<endl;
+        return ERROR_INVALID;
+    }
+    return ERROR_NONE;
+}
+
+void ViewportPredictPlugin::UpdateTimingStats(uint64_t spent_us, bool failed)
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_timingStats.calls++;
+    m_timingStats.total_us += spent_us;
+    if (spent_us > m_timingStats.max_us)
+    {
+        m_timingStats.max_us = spent_us;
+    }
+    if (failed)
+    {
+        m_timingStats.failures++;
+    }
+}
+
+void ViewportPredictPlugin::GetTimingStats(PluginTimingStats *stats)
+{
+    if (NULL == stats)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    *stats = m_timingStats;
+}
+
 VCD_OMAF_END
@@ -38,7 +38,9 @@
 #define VIEWPORTPREDICTPLUGIN_H
 
 #include "../general.h"
+#include "../../utils/ViewportPredict_API.h"
 #include <stdlib.h>
+#include <mutex>
 
 VCD_OMAF_BEGIN
 
@@ -49,6 +51,15 @@ VCD_OMAF_BEGIN
 typedef void* Handler;
 typedef Handler (*INIT_FUNC)(uint32_t,uint32_t,uint32_t);
 typedef ViewportAngle* (*PREDICTPOSE_FUNC)(Handler, std::list<ViewportAngle>);
+typedef int32_t (*PREDICTPOSETIMED_FUNC)(Handler, const ViewportPose*, uint32_t, uint64_t, PredictedViewport*);
+typedef uint32_t (*GETAPIVERSION_FUNC)();
+typedef uint32_t (*GETCAPABILITIES_FUNC)();
+typedef int32_t (*DESTROY_FUNC)(Handler);
+
+//!
+//! \brief  the capabilities the library can make use of
+//!
+#define VIEWPORT_PREDICT_HOST_CAPABILITIES (VIEWPORT_PREDICT_CAP_DESTROY | VIEWPORT_PREDICT_CAP_TIMED)
 
 class ViewportPredictPlugin
 {
@@ -90,11 +101,45 @@ public:
     //!              return predicted viewport pose
     //!
     ViewportAngle* Predict(std::list<ViewportAngle> pose_history);
+    //! \brief viewport prediction process with the pose timestamps,
+    //!        plugins without VIEWPORT_PREDICT_CAP_TIMED are called
+    //!        by Predict and the confidence is not reported
+    //!
+    //! \param  [in] std::list<ViewportPose>
+    //!              pose history, the oldest first
+    //!         [in] uint64_t
+    //!              the time to predict the pose for, in millisecond
+    //!         [out] PredictedViewport*
+    //!              the predicted pose and its uncertainty
+    //! \return int
+    //!         ERROR code
+    //!
+    int PredictTimed(std::list<ViewportPose> pose_history, uint64_t predict_pts, PredictedViewport *predicted);
+    //! \brief get the API version reported by the plugin
+    //!
+    uint32_t GetAPIVersion() { return m_apiVersion; };
+    //! \brief get the capabilities both the plugin and the library support
+    //!
+    uint32_t GetCapabilities() { return m_capabilities; };
+    //! \brief get the timing counters of the prediction process
+    //!
+    //! \param  [out] PluginTimingStats*
+    //!              the timing counters
+    //!
+    void GetTimingStats(PluginTimingStats *stats);
 private:
+    void UpdateTimingStats(uint64_t spent_us, bool failed);
+
     Handler          m_libHandler;
     Handler          m_predictHandler;
     INIT_FUNC        m_initFunc;
     PREDICTPOSE_FUNC m_predictFunc;
+    PREDICTPOSETIMED_FUNC m_predictTimedFunc;
+    DESTROY_FUNC     m_destroyFunc;
+    uint32_t         m_apiVersion;
+    uint32_t         m_capabilities;
+    std::mutex       m_statsMutex;
+    PluginTimingStats m_timingStats;
 };
 
 VCD_OMAF_END;
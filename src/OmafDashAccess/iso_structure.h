@@ -96,6 +96,8 @@ using SampleType = VCD::MP4::FrameCodecType;
 
 using SampleInformation = VCD::MP4::TrackSampInfo;
 
+using SampleDescriptor = VCD::MP4::SampDescriptor;
+
 using TrackInformation = VCD::MP4::TrackInformation;
 
 using SchemeTypesProperty = VCD::MP4::SchemeTypesProperty;
@@ -106,6 +108,8 @@ using PodvStereoVideoConfiguration = VCD::MP4::VideoFramePackingType;
 
 using Rotation = VCD::MP4::Rotation;
 
+using SegmentInformation = VCD::MP4::SegInfo;
+
 VCD_OMAF_END;
 
 #endif /* ISO_STRUCTURE_H */
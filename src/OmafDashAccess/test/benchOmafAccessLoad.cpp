@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   benchOmafAccessLoad.cpp
+ * Author: media
+ *
+ * headless load generator: N simulated viewers open the same media with the
+ * OmafAccess_* API, follow a head trace and pull packets without decoding.
+ *
+ * usage:
+ *   ./benchOmafAccessLoad --content <dir> [--mpd Test.mpd] [--viewers 8] [--duration 30]
+ *                         [--trace trace.csv] [--extractor] [--abr]
+ *                         [--max-packet-p95-ms N] [--max-motion-to-hq-p95-ms N] [--max-cpu-per-viewer N]
+ *                         [--switch-to Test2.mpd --switch-interval 5] [--max-switch-p95-ms N]
+ *   ./benchOmafAccessLoad --url http://host/path/Test.mpd ...
+ *
+ *   --content serves the output folder of the packing sample from a local http server,
+ *   --url benchmarks against a running server instead. the trace is a csv of
+ *   "pts_ms,yaw,pitch" lines, same as OMAF_HEAD_TRACE of testViewportPredictBenchmark,
+ *   scripted fixations and turns are used without it. the thresholds fail the run with
+ *   exit code 1, so it can gate the CI.
+ *
+ *   --switch-to switches the viewers between the two media with OmafAccess_SwitchMedia every
+ *   --switch-interval seconds, it is a mpd in the content folder or a url along with --url.
+ *   the switch latency is from the call to the first packet of the new media, it is reported
+ *   along with the one of the first open.
+ *
+ *   the viewers share the process, so the cpu is the process usage divided by the viewers,
+ *   including the local server. ABR and segment cache hook into the download manager
+ *   singleton, they are off unless --abr is set.
+ */
+
+#include <sys/resource.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../OmafDashAccessApi.h"
+#include "../../utils/RwpkCache.h"
+#include "benchUtils.h"
+
+namespace {
+
+struct BenchOptions {
+  std::string content;
+  std::string mpd = "Test.mpd";
+  std::string url;
+  std::string trace;
+  int viewers = 8;
+  int duration_s = 30;
+  bool extractor = false;
+  bool abr = false;
+  double max_packet_p95_ms = -1.0;
+  double max_motion_to_hq_p95_ms = -1.0;
+  double max_cpu_per_viewer = -1.0;
+  std::string switch_to;
+  int switch_interval_s = 0;
+  double max_switch_p95_ms = -1.0;
+};
+
+struct ViewerResult {
+  std::vector<double> packet_ms;
+  std::vector<double> motion_to_hq_ms;
+  uint64_t packets = 0;
+  uint64_t bytes = 0;
+  uint64_t failures = 0;
+  int32_t open_error = 0;
+  double open_ms = -1.0;  // from the open to the first packet
+  std::vector<double> switch_ms;
+  uint64_t switch_failures = 0;
+  DashStageTimings timings;
+};
+
+// the viewport centre is covered by a region packed in its projected size, that is the high quality one
+bool centreInHighQuality(const DashPacket &pkt, float yaw, float pitch) {
+  const RegionWisePacking *rwpk = pkt.rwpk;
+  if (!rwpk || !rwpk->rectRegionPacking || rwpk->projPicWidth == 0 || rwpk->projPicHeight == 0) return false;
+  uint32_t x = static_cast<uint32_t>((yaw + 180.0f) / 360.0f * rwpk->projPicWidth) % rwpk->projPicWidth;
+  uint32_t y = std::min(static_cast<uint32_t>((90.0f - pitch) / 180.0f * rwpk->projPicHeight), rwpk->projPicHeight - 1);
+  for (int i = 0; i < rwpk->numRegions; i++) {
+    const RectangularRegionWisePacking &region = rwpk->rectRegionPacking[i];
+    if (region.packedRegWidth != region.projRegWidth || region.packedRegHeight != region.projRegHeight) continue;
+    if (x >= region.projRegLeft && x < region.projRegLeft + region.projRegWidth && y >= region.projRegTop &&
+        y < region.projRegTop + region.projRegHeight) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void setupClient(const BenchOptions &opts, const std::string &url, const std::string &cache,
+                 DashStreamingClient &client) {
+  memset(&client, 0, sizeof(client));
+  client.media_url = url.c_str();
+  client.cache_path = cache.c_str();
+  client.source_type = MultiResSource;
+  client.enable_extractor = opts.extractor;
+
+  client.omaf_params.http_params.conn_timeout = -1;  // not set
+  client.omaf_params.http_params.total_timeout = -1;  // not set
+  client.omaf_params.http_params.retry_times = 3;
+  client.omaf_params.http_params.http_version = 1;  // the local server is HTTP/1.1
+  client.omaf_params.max_parallel_transfers = 256;
+  client.omaf_params.segment_open_timeout_ms = 3000;  // ms
+  client.omaf_params.abr_params.enable = opts.abr ? 1 : 0;
+  client.omaf_params.abr_params.min_viewport_hq_tiles = -1;  // default
+}
+
+void runViewer(const BenchOptions &opts, const std::string &url, const std::string &switch_url, int index,
+               const std::vector<TraceSample> &trace, std::chrono::steady_clock::time_point deadline,
+               ViewerResult &result) {
+  memset(&result.timings, 0, sizeof(result.timings));
+  std::string cache = "./cache_viewer" + std::to_string(index);
+  DashStreamingClient client;
+  setupClient(opts, url, cache, client);
+
+  Handler handler = OmafAccess_Init(&client);
+  if (!handler) {
+    result.open_error = ERROR_NULL_PTR;
+    return;
+  }
+
+  // the viewers look around with an offset, so they don't fetch the same tiles
+  float yaw_offset = static_cast<float>((index * 67) % 360);
+  uint64_t time_offset = static_cast<uint64_t>(index) * 700;
+  auto start = std::chrono::steady_clock::now();
+  auto elapsed_ms = [&start]() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+  };
+  auto viewerPose = [&](uint64_t pts) {
+    TraceSample s = poseAt(trace, pts + time_offset);
+    s.yaw += yaw_offset;
+    if (s.yaw > 180.0f) s.yaw -= 360.0f;
+    return s;
+  };
+
+  TraceSample pose = viewerPose(0);
+  HeadSetInfo headset;
+  headset.pose = (HeadPose *)malloc(sizeof(HeadPose));
+  headset.pose->yaw = pose.yaw;
+  headset.pose->pitch = pose.pitch;
+  headset.viewPort_hFOV = 80;
+  headset.viewPort_vFOV = 80;
+  headset.viewPort_Width = 960;
+  headset.viewPort_Height = 960;
+  OmafAccess_SetupHeadSetInfo(handler, &headset);
+
+  auto first_packet_from = std::chrono::steady_clock::now();
+  result.open_error = OmafAccess_OpenMedia(handler, &client, false, (char *)"", (char *)"");
+  if (result.open_error != ERROR_NONE) {
+    free(headset.pose);
+    OmafAccess_Close(handler);
+    return;
+  }
+  DashMediaInfo info;
+  OmafAccess_GetMediaInfo(handler, &info);
+
+  TraceSample motion_from = pose;
+  bool motion_pending = false;
+  std::chrono::steady_clock::time_point motion_start;
+  bool need_params = true;
+  bool first_packet_pending = true;
+  bool switched = false;
+  bool on_switch_url = false;
+  auto next_switch = opts.switch_interval_s > 0 && switch_url.size()
+                         ? std::chrono::steady_clock::now() + std::chrono::seconds(opts.switch_interval_s)
+                         : std::chrono::steady_clock::time_point::max();
+
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (std::chrono::steady_clock::now() >= next_switch) {
+      on_switch_url = !on_switch_url;
+      client.media_url = on_switch_url ? switch_url.c_str() : url.c_str();
+      first_packet_from = std::chrono::steady_clock::now();
+      if (OmafAccess_SwitchMedia(handler, &client, false, (char *)"", (char *)"") != ERROR_NONE) {
+        result.switch_failures++;
+        break;
+      }
+      OmafAccess_GetMediaInfo(handler, &info);
+      first_packet_pending = true;
+      switched = true;
+      motion_pending = false;
+      next_switch = std::chrono::steady_clock::now() + std::chrono::seconds(opts.switch_interval_s);
+    }
+
+    TraceSample now_pose = viewerPose(elapsed_ms());
+    if (now_pose.yaw != pose.yaw || now_pose.pitch != pose.pitch) {
+      pose = now_pose;
+      HeadPose head;
+      head.yaw = pose.yaw;
+      head.pitch = pose.pitch;
+      OmafAccess_ChangeViewport(handler, &head);
+      if (angleDistance(pose.yaw, pose.pitch, motion_from.yaw, motion_from.pitch) > MOTION_THRESHOLD) {
+        motion_from = pose;
+        motion_pending = true;
+        motion_start = std::chrono::steady_clock::now();
+      }
+    }
+
+    DashPacket pkts[MAX_PACKETS];
+    memset(pkts, 0, sizeof(pkts));
+    int count = 0;
+    uint64_t pts = 0;
+    auto call = std::chrono::steady_clock::now();
+    int ret = OmafAccess_GetPacket(handler, 0, pkts, &count, &pts, need_params, false);
+    auto spent = std::chrono::steady_clock::now() - call;
+    if (ret != ERROR_NONE || count <= 0) {
+      if (ret == ERROR_EOS || (count > 0 && pkts[0].bEOS)) break;
+      result.failures++;
+      freePackets(pkts, count);
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      continue;
+    }
+    result.packet_ms.push_back(std::chrono::duration<double, std::milli>(spent).count());
+    result.packets++;
+    if (first_packet_pending) {
+      double first_ms =
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - first_packet_from).count();
+      if (switched) {
+        result.switch_ms.push_back(first_ms);
+      } else {
+        result.open_ms = first_ms;
+      }
+      first_packet_pending = false;
+    }
+    for (int i = 0; i < count; i++) result.bytes += pkts[i].size;
+
+    if (motion_pending && centreInHighQuality(pkts[0], pose.yaw, pose.pitch)) {
+      result.motion_to_hq_ms.push_back(
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - motion_start).count());
+      motion_pending = false;
+    }
+    bool eos = pkts[0].bEOS;
+    freePackets(pkts, count);
+    if (eos) break;
+  }
+
+  OmafAccess_GetStageTimings(handler, &result.timings);
+  OmafAccess_CloseMedia(handler);
+  OmafAccess_Close(handler);
+  free(headset.pose);
+}
+
+void mergeStats(PluginTimingStats &to, const PluginTimingStats &from) {
+  to.calls += from.calls;
+  to.failures += from.failures;
+  to.total_us += from.total_us;
+  to.max_us = std::max(to.max_us, from.max_us);
+}
+
+void printStage(const char *name, const PluginTimingStats &stats) {
+  double avg_ms = stats.calls ? stats.total_us / 1000.0 / stats.calls : 0.0;
+  printf("  %-9s calls %8llu  failures %6llu  avg %8.3f ms  max %8.3f ms\n", name, (unsigned long long)stats.calls,
+         (unsigned long long)stats.failures, avg_ms, stats.max_us / 1000.0);
+}
+
+// VmRSS and VmHWM in kB
+void readMemory(long &rss_kb, long &hwm_kb) {
+  rss_kb = 0;
+  hwm_kb = 0;
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  long value = 0;
+  std::string line;
+  while (std::getline(status, line)) {
+    std::istringstream iss(line);
+    if (!(iss >> key >> value)) continue;
+    if (key == "VmRSS:") rss_kb = value;
+    if (key == "VmHWM:") hwm_kb = value;
+  }
+}
+
+double cpuSeconds(void) {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+bool parseOptions(int argc, char **argv, BenchOptions &opts) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--extractor") {
+      opts.extractor = true;
+    } else if (arg == "--abr") {
+      opts.abr = true;
+    } else if (!has_value) {
+      return false;
+    } else if (arg == "--content") {
+      opts.content = argv[++i];
+    } else if (arg == "--mpd") {
+      opts.mpd = argv[++i];
+    } else if (arg == "--url") {
+      opts.url = argv[++i];
+    } else if (arg == "--trace") {
+      opts.trace = argv[++i];
+    } else if (arg == "--viewers") {
+      opts.viewers = atoi(argv[++i]);
+    } else if (arg == "--duration") {
+      opts.duration_s = atoi(argv[++i]);
+    } else if (arg == "--max-packet-p95-ms") {
+      opts.max_packet_p95_ms = atof(argv[++i]);
+    } else if (arg == "--max-motion-to-hq-p95-ms") {
+      opts.max_motion_to_hq_p95_ms = atof(argv[++i]);
+    } else if (arg == "--max-cpu-per-viewer") {
+      opts.max_cpu_per_viewer = atof(argv[++i]);
+    } else if (arg == "--switch-to") {
+      opts.switch_to = argv[++i];
+    } else if (arg == "--switch-interval") {
+      opts.switch_interval_s = atoi(argv[++i]);
+    } else if (arg == "--max-switch-p95-ms") {
+      opts.max_switch_p95_ms = atof(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  return (opts.content.size() || opts.url.size()) && opts.viewers > 0 && opts.duration_s > 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  BenchOptions opts;
+  if (!parseOptions(argc, argv, opts)) {
+    fprintf(stderr,
+            "usage: %s (--content <dir> [--mpd Test.mpd] | --url <mpd url>) [--viewers N] [--duration S]\n"
+            "          [--trace csv] [--extractor] [--abr] [--max-packet-p95-ms N]\n"
+            "          [--max-motion-to-hq-p95-ms N] [--max-cpu-per-viewer N]\n"
+            "          [--switch-to <mpd> --switch-interval S] [--max-switch-p95-ms N]\n",
+            argv[0]);
+    return 2;
+  }
+
+  std::vector<TraceSample> trace;
+  if (opts.trace.size()) {
+    if (!loadTrace(opts.trace, trace)) {
+      fprintf(stderr, "failed to load the head trace %s\n", opts.trace.c_str());
+      return 2;
+    }
+  } else {
+    trace = scriptedTrace(opts.duration_s);
+  }
+
+  std::unique_ptr<TestHttpServer> server;
+  std::string url = opts.url;
+  if (url.empty()) {
+    server.reset(new TestHttpServer(HTTP_WORKERS));
+    server->root(opts.content);
+    if (!server->start()) {
+      fprintf(stderr, "failed to start the local http server\n");
+      return 2;
+    }
+    url = server->url(opts.mpd);
+  }
+  std::string switch_url = opts.switch_to;
+  if (server && switch_url.size()) {
+    switch_url = server->url(opts.switch_to);
+  }
+  if (opts.switch_interval_s > 0 && switch_url.empty()) {
+    switch_url = url;
+  }
+  printf("%d viewers on %s for %d s\n", opts.viewers, url.c_str(), opts.duration_s);
+
+  std::vector<ViewerResult> results(opts.viewers);
+  std::vector<std::thread> viewers;
+  double cpu_start = cpuSeconds();
+  auto wall_start = std::chrono::steady_clock::now();
+  auto deadline = wall_start + std::chrono::seconds(opts.duration_s);
+  for (int i = 0; i < opts.viewers; i++) {
+    viewers.emplace_back(runViewer, std::cref(opts), std::cref(url), std::cref(switch_url), i, std::cref(trace),
+                         deadline, std::ref(results[i]));
+  }
+  for (auto &viewer : viewers) viewer.join();
+  double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+  double cpu_s = cpuSeconds() - cpu_start;
+  if (server) server->stop();
+
+  std::vector<double> packet_ms;
+  std::vector<double> motion_ms;
+  std::vector<double> open_ms;
+  std::vector<double> switch_ms;
+  uint64_t switch_failures = 0;
+  DashStageTimings stages;
+  memset(&stages, 0, sizeof(stages));
+  uint64_t packets = 0, bytes = 0, failures = 0;
+  int opened = 0;
+  for (auto &r : results) {
+    if (r.open_error != ERROR_NONE) {
+      fprintf(stderr, "viewer failed to open the media, err=%d\n", r.open_error);
+      continue;
+    }
+    opened++;
+    packet_ms.insert(packet_ms.end(), r.packet_ms.begin(), r.packet_ms.end());
+    motion_ms.insert(motion_ms.end(), r.motion_to_hq_ms.begin(), r.motion_to_hq_ms.end());
+    if (r.open_ms >= 0) open_ms.push_back(r.open_ms);
+    switch_ms.insert(switch_ms.end(), r.switch_ms.begin(), r.switch_ms.end());
+    switch_failures += r.switch_failures;
+    packets += r.packets;
+    bytes += r.bytes;
+    failures += r.failures;
+    mergeStats(stages.download, r.timings.download);
+    mergeStats(stages.parse, r.timings.parse);
+    mergeStats(stages.select, r.timings.select);
+    mergeStats(stages.stitch, r.timings.stitch);
+  }
+
+  long rss_kb = 0, hwm_kb = 0;
+  readMemory(rss_kb, hwm_kb);
+  double packet_p95 = percentile(packet_ms, 0.95);
+  double motion_p95 = percentile(motion_ms, 0.95);
+  double switch_p95 = percentile(switch_ms, 0.95);
+  double cpu_per_viewer = wall_s > 0 ? cpu_s / wall_s * 100.0 / opts.viewers : 0.0;
+
+  printf("viewers opened     %d/%d\n", opened, opts.viewers);
+  printf("packets            %llu, %.2f fps per viewer, %.2f Mbps in total, %llu empty gets\n",
+         (unsigned long long)packets, opened ? packets / wall_s / opened : 0.0, bytes * 8 / wall_s / 1e6,
+         (unsigned long long)failures);
+  printf("get packet         p50 %.3f ms  p95 %.3f ms  max %.3f ms\n", percentile(packet_ms, 0.5), packet_p95,
+         percentile(packet_ms, 1.0));
+  printf("motion to hq       %zu motions  p50 %.1f ms  p95 %.1f ms\n", motion_ms.size(), percentile(motion_ms, 0.5),
+         motion_p95);
+  printf("open to 1st packet p50 %.1f ms  p95 %.1f ms\n", percentile(open_ms, 0.5), percentile(open_ms, 0.95));
+  if (opts.switch_interval_s > 0) {
+    printf("switch to 1st pkt  %zu switches  p50 %.1f ms  p95 %.1f ms  %llu failures\n", switch_ms.size(),
+           percentile(switch_ms, 0.5), switch_p95, (unsigned long long)switch_failures);
+  }
+  printf("stages\n");
+  printStage("download", stages.download);
+  printStage("parse", stages.parse);
+  printStage("select", stages.select);
+  printStage("stitch", stages.stitch);
+  printf("cpu                %.1f%% per viewer\n", cpu_per_viewer);
+  printf("memory             rss %ld kB  peak %ld kB  %.1f kB per viewer\n", rss_kb, hwm_kb,
+         static_cast<double>(hwm_kb) / opts.viewers);
+
+  bool passed = opened == opts.viewers;
+  if (opts.max_packet_p95_ms > 0 && packet_p95 > opts.max_packet_p95_ms) {
+    printf("FAIL: get packet p95 %.3f ms over %.3f ms\n", packet_p95, opts.max_packet_p95_ms);
+    passed = false;
+  }
+  if (opts.max_motion_to_hq_p95_ms > 0 && (motion_ms.empty() || motion_p95 > opts.max_motion_to_hq_p95_ms)) {
+    printf("FAIL: motion to hq p95 %.1f ms over %.1f ms\n", motion_p95, opts.max_motion_to_hq_p95_ms);
+    passed = false;
+  }
+  if (opts.max_switch_p95_ms > 0 && (switch_ms.empty() || switch_failures || switch_p95 > opts.max_switch_p95_ms)) {
+    printf("FAIL: switch p95 %.1f ms over %.1f ms, %llu failures\n", switch_p95, opts.max_switch_p95_ms,
+           (unsigned long long)switch_failures);
+    passed = false;
+  }
+  if (opts.max_cpu_per_viewer > 0 && cpu_per_viewer > opts.max_cpu_per_viewer) {
+    printf("FAIL: cpu %.1f%% per viewer over %.1f%%\n", cpu_per_viewer, opts.max_cpu_per_viewer);
+    passed = false;
+  }
+  return passed ? 0 : 1;
+}
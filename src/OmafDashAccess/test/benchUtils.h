@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   benchUtils.h
+ * Author: media
+ *
+ * helpers shared by the headless tools, the head traces and the packet release,
+ * the packed content is served by the shared test http server. each tool is one translation
+ * unit, so they are kept in an anonymous namespace.
+ */
+
+#ifndef _BENCH_UTILS_H_
+#define _BENCH_UTILS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../OmafDashAccessApi.h"
+#include "../../utils/RwpkCache.h"
+#include "testHttpServer.h"
+
+namespace {
+
+const int MAX_PACKETS = 16;
+// the viewport moves farther than it since the last motion, a new motion to high quality starts
+const float MOTION_THRESHOLD = 20.0f;
+const int HTTP_WORKERS = 32;
+
+// head trace sample, the angle is in degree and the pts in ms
+struct TraceSample {
+  uint64_t pts;
+  float yaw;
+  float pitch;
+};
+
+// fixations of 3s with 90 degree turns in 300ms, looping over the directions
+std::vector<TraceSample> scriptedTrace(int duration_s) {
+  const float yaws[] = {0.0f, 90.0f, 180.0f, -90.0f, 45.0f, -135.0f};
+  const float pitches[] = {0.0f, 20.0f, -20.0f, 0.0f, 40.0f, -30.0f};
+  const uint64_t fixation = 3000;
+  const uint64_t turn = 300;
+  std::vector<TraceSample> trace;
+  size_t from = 0;
+  for (uint64_t pts = 0; pts <= static_cast<uint64_t>(duration_s) * 1000; pts += 20) {
+    uint64_t phase = pts % (fixation + turn);
+    size_t to = (from + 1) % 6;
+    float t = phase < fixation ? 0.0f : static_cast<float>(phase - fixation) / turn;
+    float dyaw = yaws[to] - yaws[from];
+    if (dyaw > 180.0f) dyaw -= 360.0f;
+    if (dyaw < -180.0f) dyaw += 360.0f;
+    TraceSample s;
+    s.pts = pts;
+    s.yaw = yaws[from] + dyaw * t;
+    if (s.yaw > 180.0f) s.yaw -= 360.0f;
+    if (s.yaw < -180.0f) s.yaw += 360.0f;
+    s.pitch = pitches[from] + (pitches[to] - pitches[from]) * t;
+    trace.push_back(s);
+    if (phase + 20 >= fixation + turn) from = to;
+  }
+  return trace;
+}
+
+bool loadTrace(const std::string &path, std::vector<TraceSample> &trace) {
+  std::ifstream file(path);
+  if (!file.is_open()) return false;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream iss(line);
+    TraceSample s;
+    if (iss >> s.pts >> s.yaw >> s.pitch) trace.push_back(s);
+  }
+  return trace.size() > 0;
+}
+
+TraceSample poseAt(const std::vector<TraceSample> &trace, uint64_t pts) {
+  uint64_t span = trace.back().pts - trace.front().pts + 1;
+  pts = trace.front().pts + pts % span;
+  auto it = std::lower_bound(trace.begin(), trace.end(), pts,
+                             [](const TraceSample &s, uint64_t value) { return s.pts < value; });
+  if (it == trace.end()) return trace.back();
+  return *it;
+}
+
+float angleDistance(float yaw1, float pitch1, float yaw2, float pitch2) {
+  float dyaw = std::fabs(yaw1 - yaw2);
+  if (dyaw > 180.0f) dyaw = 360.0f - dyaw;
+  return std::sqrt(dyaw * dyaw + (pitch1 - pitch2) * (pitch1 - pitch2));
+}
+
+void freePackets(DashPacket *pkts, int count) {
+  for (int i = 0; i < count; i++) {
+    free(pkts[i].buf);
+    pkts[i].buf = nullptr;
+    // the rwpk is shared, only the reference is released
+    VCD::VRVideo::SharedRwpk::ReleaseHandle(pkts[i].rwpkRef);
+    pkts[i].rwpkRef = nullptr;
+    pkts[i].rwpk = nullptr;
+    delete[] pkts[i].qtyResolution;
+    pkts[i].qtyResolution = nullptr;
+  }
+}
+
+double percentile(std::vector<double> values, double p) {
+  if (values.empty()) return 0.0;
+  std::sort(values.begin(), values.end());
+  size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+  return values[std::min(index, values.size() - 1)];
+}
+
+}  // namespace
+
+#endif /* _BENCH_UTILS_H_ */
@@ -8,15 +8,42 @@ g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testOmafReade
 g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testOmafReaderManager.cpp -D_GLIBCXX_USE_CXX11_ABI=0
 g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testDownloader.cpp -D_GLIBCXX_USE_CXX11_ABI=0
 g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testDownloaderPerf.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testAbrController.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testSegmentCache.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testSubSegment.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testViewportPredictPlugin.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testViewportPredictBenchmark.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testGlogAsyncLogger.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testMetricsRegistry.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testRwpkCache.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testMappedFileStream.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testExtractorPlan.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c testTileTracksSelector.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c benchOmafAccessLoad.cpp -D_GLIBCXX_USE_CXX11_ABI=0
+g++ -I../../isolib -I../../google_test -std=c++11 -I../util/ -g -c evalViewportQuality.cpp -D_GLIBCXX_USE_CXX11_ABI=0
 
 LD_FLAGS="-I/usr/local/include/ -lcurl -lstdc++ -lOmafDashAccess -lsafestring_shared -llttng-ust -ldl -lpthread -lglog -l360SCVP -lm -L/usr/local/lib"
-g++ -L/usr/local/lib testDownloaderPerf.o testDownloader.o testMediaSource.o testMPDParser.o testOmafReader.o testOmafReaderManager.o libgtest.a -o testLib ${LD_FLAGS}
+g++ -L/usr/local/lib testTileTracksSelector.o testExtractorPlan.o testMappedFileStream.o testRwpkCache.o testMetricsRegistry.o testGlogAsyncLogger.o testViewportPredictBenchmark.o testViewportPredictPlugin.o testSubSegment.o testSegmentCache.o testAbrController.o testDownloaderPerf.o testDownloader.o testMediaSource.o testMPDParser.o testOmafReader.o testOmafReaderManager.o libgtest.a -o testLib ${LD_FLAGS}
 g++ -L/usr/local/lib testMediaSource.o libgtest.a -o testMediaSource ${LD_FLAGS}
 g++ -L/usr/local/lib testMPDParser.o libgtest.a -o testMPDParser ${LD_FLAGS}
 g++ -L/usr/local/lib testOmafReader.o libgtest.a -o testOmafReader ${LD_FLAGS}
 g++ -L/usr/local/lib testOmafReaderManager.o libgtest.a -o testOmafReaderManager ${LD_FLAGS}
 g++ -L/usr/local/lib testDownloader.o libgtest.a -o testDownloader ${LD_FLAGS}
 g++ -L/usr/local/lib testDownloaderPerf.o libgtest.a -o testDownloaderPerf ${LD_FLAGS}
+g++ -L/usr/local/lib testAbrController.o libgtest.a -o testAbrController ${LD_FLAGS}
+g++ -L/usr/local/lib testSegmentCache.o libgtest.a -o testSegmentCache ${LD_FLAGS}
+g++ -L/usr/local/lib testSubSegment.o libgtest.a -o testSubSegment ${LD_FLAGS}
+g++ -L/usr/local/lib testViewportPredictPlugin.o libgtest.a -o testViewportPredictPlugin ${LD_FLAGS}
+g++ -L/usr/local/lib testViewportPredictBenchmark.o libgtest.a -o testViewportPredictBenchmark ${LD_FLAGS}
+g++ -L/usr/local/lib testGlogAsyncLogger.o libgtest.a -o testGlogAsyncLogger ${LD_FLAGS}
+g++ -L/usr/local/lib testMetricsRegistry.o libgtest.a -o testMetricsRegistry ${LD_FLAGS}
+g++ -L/usr/local/lib testRwpkCache.o libgtest.a -o testRwpkCache ${LD_FLAGS}
+g++ -L/usr/local/lib testMappedFileStream.o libgtest.a -o testMappedFileStream ${LD_FLAGS}
+g++ -L/usr/local/lib testExtractorPlan.o libgtest.a -o testExtractorPlan ${LD_FLAGS}
+g++ -L/usr/local/lib testTileTracksSelector.o libgtest.a -o testTileTracksSelector ${LD_FLAGS}
+# load generator and viewport quality evaluation, they need the packed content so they are not in run.sh
+g++ -L/usr/local/lib benchOmafAccessLoad.o -o benchOmafAccessLoad ${LD_FLAGS}
+g++ -L/usr/local/lib evalViewportQuality.o -o evalViewportQuality ${LD_FLAGS} -lavcodec -lavutil
 
 ./run.sh
 if [ $? -ne 0 ]; then exit 1; fi
@@ -0,0 +1,668 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   evalViewportQuality.cpp
+ * Author: media
+ *
+ * offline viewport quality evaluation: one viewer replays a head trace through the
+ * tile tracks selector and the stitcher of OmafDashAccess against the packed content,
+ * decodes the packets with FFmpeg in software and renders the viewport on CPU.
+ *
+ * usage:
+ *   ./evalViewportQuality --content <dir> [--mpd Test.mpd] [--duration 30] [--trace trace.csv]
+ *                         [--fov 80] [--viewport-size 480] [--hq-target 0.95] [--csv frames.csv]
+ *                         [--dump viewport.yuv] [--no-decode] [--extractor] [--abr]
+ *                         [--min-hq-mean N] [--max-motion-to-hq-p95-ms N]
+ *   ./evalViewportQuality --url http://host/path/Test.mpd ...
+ *
+ *   the content, url and trace are the same as benchOmafAccessLoad. for each frame it
+ *   reports the fraction of the viewport pixels rendered from the high quality regions,
+ *   which are the regions of the source with the highest quality ranking, as the render
+ *   targets of the player take them. the motion to high quality latency is the time from
+ *   a head motion to the first frame with --hq-target of the viewport in high quality.
+ *   the bandwidth is the bytes downloaded by the session and the bytes of the packets.
+ *
+ *   --dump writes the rendered viewports as I420, --no-decode measures the selection
+ *   only. ERP content is supported. the thresholds fail the run with exit code 1, so
+ *   every selection and prefetch change can be benchmarked in the CI.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/frame.h>
+}
+
+#include "../OmafDashAccessApi.h"
+#include "../../360SCVP/360SCVPAPI.h"
+#include "../../utils/OmafStructure.h"
+#include "../../utils/RwpkCache.h"
+#include "benchUtils.h"
+
+using VCD::VRVideo::SharedRwpk;
+using VCD::VRVideo::RWPKCACHE;
+
+namespace {
+
+const double DEFAULT_FRAME_RATE = 30.0;
+// the quality level of the projected samples
+const uint8_t SAMPLE_NOT_COVERED = 0;
+const uint8_t SAMPLE_LOW_QUALITY = 1;
+const uint8_t SAMPLE_HIGH_QUALITY = 2;
+
+struct EvalOptions {
+  std::string content;
+  std::string mpd = "Test.mpd";
+  std::string url;
+  std::string trace;
+  std::string csv;
+  std::string dump;
+  int duration_s = 30;
+  bool decode = true;
+  bool extractor = false;
+  bool abr = false;
+  float fov = 80.0f;
+  int viewport_size = 480;
+  double hq_target = 0.95;
+  double min_hq_mean = -1.0;
+  double max_motion_to_hq_p95_ms = -1.0;
+};
+
+struct FrameResult {
+  uint64_t time_ms;
+  float yaw;
+  float pitch;
+  double hq_fraction;
+  uint64_t bytes;
+};
+
+// one 4:2:0 picture in a contiguous buffer
+class Picture {
+ public:
+  Picture() { memset(&planes_, 0, sizeof(planes_)); }
+
+  void resize(uint32_t width, uint32_t height) {
+    if (planes_.width == width && planes_.height == height) return;
+    uint32_t luma = width * height;
+    uint32_t chroma = ((width + 1) / 2) * ((height + 1) / 2);
+    data_.assign(luma + 2 * chroma, 0);
+    planes_.pPlanes[0] = data_.data();
+    planes_.pPlanes[1] = data_.data() + luma;
+    planes_.pPlanes[2] = data_.data() + luma + chroma;
+    planes_.strides[0] = width;
+    planes_.strides[1] = (width + 1) / 2;
+    planes_.strides[2] = (width + 1) / 2;
+    planes_.width = width;
+    planes_.height = height;
+  }
+
+  void fill(uint8_t luma, uint8_t chroma) {
+    uint32_t size = planes_.width * planes_.height;
+    memset(data_.data(), luma, size);
+    memset(data_.data() + size, chroma, data_.size() - size);
+  }
+
+  Param_YUVPicture *planes() { return &planes_; }
+  uint8_t *luma() { return planes_.pPlanes[0]; }
+
+ private:
+  std::vector<uint8_t> data_;
+  Param_YUVPicture planes_;
+};
+
+// the quality levels of the projected picture of one packing, made by unpacking the
+// levels of the packed regions, so the overlapped regions are resolved as the pixels
+struct QualityMask {
+  uint64_t version = 0;
+  Picture projected;
+};
+
+// the packet waiting for its decoded frame
+struct PendingFrame {
+  SharedRwpk::Ptr rwpk;
+};
+
+// software decoder of one video, the same calls as VideoDecoder of the player
+class SoftwareDecoder {
+ public:
+  ~SoftwareDecoder() {
+    if (frame_) av_frame_free(&frame_);
+    if (packet_) av_packet_free(&packet_);
+    if (ctx_) avcodec_free_context(&ctx_);
+  }
+
+  bool open(Codec_Type codec) {
+    AVCodecID id = codec == VideoCodec_AVC ? AV_CODEC_ID_H264 : codec == VideoCodec_AV1 ? AV_CODEC_ID_AV1 : AV_CODEC_ID_HEVC;
+    const AVCodec *decoder = avcodec_find_decoder(id);
+    if (!decoder) return false;
+    ctx_ = avcodec_alloc_context3(decoder);
+    if (!ctx_) return false;
+    // no frame threads, the frames come out without delay
+    ctx_->thread_count = 0;
+    ctx_->thread_type = FF_THREAD_SLICE;
+    ctx_->flags |= AV_CODEC_FLAG_LOW_DELAY;
+    if (avcodec_open2(ctx_, decoder, NULL) < 0) return false;
+    frame_ = av_frame_alloc();
+    packet_ = av_packet_alloc();
+    return frame_ && packet_;
+  }
+
+  // sends the packet, the decoded frames are passed to the callback with the packing of their packets
+  template <typename Callback>
+  bool decode(const DashPacket &pkt, SharedRwpk::Ptr rwpk, Callback onFrame) {
+    if (av_new_packet(packet_, static_cast<int>(pkt.size)) < 0) return false;
+    memcpy(packet_->data, pkt.buf, pkt.size);
+    pending_.push_back({rwpk});
+    int ret = avcodec_send_packet(ctx_, packet_);
+    av_packet_unref(packet_);
+    if (ret < 0) {
+      pending_.pop_back();
+      return false;
+    }
+    while (avcodec_receive_frame(ctx_, frame_) == 0) {
+      PendingFrame pending = pending_.front();
+      pending_.pop_front();
+      if (frame_->format == AV_PIX_FMT_YUV420P || frame_->format == AV_PIX_FMT_YUVJ420P) {
+        onFrame(frame_, pending.rwpk);
+      }
+      av_frame_unref(frame_);
+    }
+    return true;
+  }
+
+ private:
+  AVCodecContext *ctx_ = nullptr;
+  AVFrame *frame_ = nullptr;
+  AVPacket *packet_ = nullptr;
+  std::deque<PendingFrame> pending_;
+};
+
+// the quality ranking of the source which the region is packed from, as the render targets find it
+int32_t regionQuality(const DashPacket &pkt, const RectangularRegionWisePacking &region) {
+  for (int32_t i = 0; i < pkt.numQuality; i++) {
+    const SourceResolution &source = pkt.qtyResolution[i];
+    if (region.packedRegLeft >= source.left && region.packedRegLeft < source.left + source.width &&
+        region.packedRegTop >= source.top && region.packedRegTop < source.top + source.height) {
+      return source.qualityRanking;
+    }
+  }
+  return INVALID_QUALITY_RANKING;
+}
+
+bool isHighQuality(const DashPacket &pkt, const RectangularRegionWisePacking &region) {
+  if (pkt.numQuality <= 0 || !pkt.qtyResolution) {
+    // no sources, the region packed in its projected size is the high quality one
+    return region.packedRegWidth == region.projRegWidth && region.packedRegHeight == region.projRegHeight;
+  }
+  int32_t highest = INVALID_QUALITY_RANKING;
+  for (int32_t i = 0; i < pkt.numQuality; i++) {
+    highest = std::min(highest, static_cast<int32_t>(pkt.qtyResolution[i].qualityRanking));
+  }
+  return regionQuality(pkt, region) == highest;
+}
+
+// unpacks the quality levels of the packed regions, only when the packing changes
+bool updateQualityMask(const DashPacket &pkt, const RegionWisePacking *rwpk, QualityMask &mask) {
+  if (mask.version && mask.version == pkt.rwpkVersion) return true;
+  Picture packed;
+  packed.resize(rwpk->packedPicWidth, rwpk->packedPicHeight);
+  for (int i = 0; i < rwpk->numRegions; i++) {
+    const RectangularRegionWisePacking &region = rwpk->rectRegionPacking[i];
+    uint8_t level = isHighQuality(pkt, region) ? SAMPLE_HIGH_QUALITY : SAMPLE_LOW_QUALITY;
+    for (uint32_t y = region.packedRegTop; y < static_cast<uint32_t>(region.packedRegTop + region.packedRegHeight); y++) {
+      memset(packed.luma() + y * rwpk->packedPicWidth + region.packedRegLeft, level, region.packedRegWidth);
+    }
+  }
+  mask.projected.resize(rwpk->projPicWidth, rwpk->projPicHeight);
+  mask.projected.fill(SAMPLE_NOT_COVERED, SAMPLE_NOT_COVERED);
+  if (I360SCVP_UnpackRWPK(const_cast<RegionWisePacking *>(rwpk), packed.planes(), mask.projected.planes(), 0) != 0) {
+    mask.version = 0;
+    return false;
+  }
+  mask.version = pkt.rwpkVersion;
+  return true;
+}
+
+// the ERP sample nearest to the centre of each pixel of the rectilinear viewport
+void viewportSamples(float yaw, float pitch, float fov, int size, uint32_t width, uint32_t height,
+                     std::vector<uint32_t> &samples) {
+  samples.resize(static_cast<size_t>(size) * size);
+  double range = tan(fov / 2.0 * M_PI / 180.0);
+  double yaw_r = yaw * M_PI / 180.0, pitch_r = pitch * M_PI / 180.0;
+  double cos_y = cos(yaw_r), sin_y = sin(yaw_r), cos_p = cos(pitch_r), sin_p = sin(pitch_r);
+  for (int j = 0; j < size; j++) {
+    double cy = (1.0 - 2.0 * (j + 0.5) / size) * range;
+    for (int i = 0; i < size; i++) {
+      double cx = (2.0 * (i + 0.5) / size - 1.0) * range;
+      // looking at +z with y up, pitched around x and then turned around y
+      double y = cy * cos_p + sin_p;
+      double z = -cy * sin_p + cos_p;
+      double x = cx * cos_y + z * sin_y;
+      z = -cx * sin_y + z * cos_y;
+      double lon = atan2(x, z);
+      double lat = atan2(y, sqrt(x * x + z * z));
+      uint32_t u = static_cast<uint32_t>((lon / (2 * M_PI) + 0.5) * width) % width;
+      uint32_t v = std::min(static_cast<uint32_t>(std::max(0.0, (0.5 - lat / M_PI) * height)), height - 1);
+      samples[static_cast<size_t>(j) * size + i] = v * width + u;
+    }
+  }
+}
+
+// the viewport in I420, sampled from the projected picture
+void renderViewport(Picture &projected, const std::vector<uint32_t> &samples, int size, FILE *out) {
+  Param_YUVPicture *proj = projected.planes();
+  std::vector<uint8_t> viewport(static_cast<size_t>(size) * size * 3 / 2);
+  uint8_t *dst = viewport.data();
+  for (size_t i = 0; i < samples.size(); i++) {
+    dst[i] = proj->pPlanes[0][samples[i]];
+  }
+  for (int plane = 1; plane < 3; plane++) {
+    dst += plane == 1 ? static_cast<size_t>(size) * size : static_cast<size_t>(size) * size / 4;
+    for (int j = 0; j < size / 2; j++) {
+      for (int i = 0; i < size / 2; i++) {
+        uint32_t sample = samples[static_cast<size_t>(2 * j) * size + 2 * i];
+        uint32_t x = (sample % proj->width) / 2, y = (sample / proj->width) / 2;
+        dst[j * (size / 2) + i] = proj->pPlanes[plane][y * proj->strides[plane] + x];
+      }
+    }
+  }
+  fwrite(viewport.data(), 1, viewport.size(), out);
+}
+
+// copies the decoded frame into the packed picture, the frame has the padding of the decoder
+void copyFrame(const AVFrame *frame, Picture &packed) {
+  packed.resize(frame->width, frame->height);
+  Param_YUVPicture *planes = packed.planes();
+  for (int plane = 0; plane < 3; plane++) {
+    uint32_t width = plane ? (frame->width + 1) / 2 : frame->width;
+    uint32_t height = plane ? (frame->height + 1) / 2 : frame->height;
+    for (uint32_t y = 0; y < height; y++) {
+      memcpy(planes->pPlanes[plane] + y * planes->strides[plane], frame->data[plane] + y * frame->linesize[plane],
+             width);
+    }
+  }
+}
+
+int64_t downloadBytes(Handler handler) {
+  int32_t count = 0;
+  if (OmafAccess_GetMetrics(handler, NULL, &count) != ERROR_NONE || count <= 0) return 0;
+  std::vector<MetricValue> values(count);
+  if (OmafAccess_GetMetrics(handler, values.data(), &count) != ERROR_NONE) return 0;
+  for (int32_t i = 0; i < count; i++) {
+    if (strcmp(values[i].name, "download_bytes_total") == 0) return values[i].value;
+  }
+  return 0;
+}
+
+bool parseOptions(int argc, char **argv, EvalOptions &opts) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--extractor") {
+      opts.extractor = true;
+    } else if (arg == "--abr") {
+      opts.abr = true;
+    } else if (arg == "--no-decode") {
+      opts.decode = false;
+    } else if (!has_value) {
+      return false;
+    } else if (arg == "--content") {
+      opts.content = argv[++i];
+    } else if (arg == "--mpd") {
+      opts.mpd = argv[++i];
+    } else if (arg == "--url") {
+      opts.url = argv[++i];
+    } else if (arg == "--trace") {
+      opts.trace = argv[++i];
+    } else if (arg == "--csv") {
+      opts.csv = argv[++i];
+    } else if (arg == "--dump") {
+      opts.dump = argv[++i];
+    } else if (arg == "--duration") {
+      opts.duration_s = atoi(argv[++i]);
+    } else if (arg == "--fov") {
+      opts.fov = static_cast<float>(atof(argv[++i]));
+    } else if (arg == "--viewport-size") {
+      // even, so the chroma of the dumped viewport has whole samples
+      opts.viewport_size = atoi(argv[++i]) & ~1;
+    } else if (arg == "--hq-target") {
+      opts.hq_target = atof(argv[++i]);
+    } else if (arg == "--min-hq-mean") {
+      opts.min_hq_mean = atof(argv[++i]);
+    } else if (arg == "--max-motion-to-hq-p95-ms") {
+      opts.max_motion_to_hq_p95_ms = atof(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  return (opts.content.size() || opts.url.size()) && opts.duration_s > 0 && opts.viewport_size > 0 &&
+         opts.fov > 0.0f && opts.fov < 180.0f;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  EvalOptions opts;
+  if (!parseOptions(argc, argv, opts)) {
+    fprintf(stderr,
+            "usage: %s (--content <dir> [--mpd Test.mpd] | --url <mpd url>) [--duration S] [--trace csv]\n"
+            "          [--fov 80] [--viewport-size 480] [--hq-target 0.95] [--csv frames.csv] [--dump viewport.yuv]\n"
+            "          [--no-decode] [--extractor] [--abr] [--min-hq-mean N] [--max-motion-to-hq-p95-ms N]\n",
+            argv[0]);
+    return 2;
+  }
+
+  std::vector<TraceSample> trace;
+  if (opts.trace.size()) {
+    if (!loadTrace(opts.trace, trace)) {
+      fprintf(stderr, "failed to load the head trace %s\n", opts.trace.c_str());
+      return 2;
+    }
+  } else {
+    trace = scriptedTrace(opts.duration_s);
+  }
+
+  std::unique_ptr<TestHttpServer> server;
+  std::string url = opts.url;
+  if (url.empty()) {
+    server.reset(new TestHttpServer(HTTP_WORKERS));
+    server->root(opts.content);
+    if (!server->start()) {
+      fprintf(stderr, "failed to start the local http server\n");
+      return 2;
+    }
+    url = server->url(opts.mpd);
+  }
+
+  std::string cache = "./cache_eval";
+  DashStreamingClient client;
+  memset(&client, 0, sizeof(client));
+  client.media_url = url.c_str();
+  client.cache_path = cache.c_str();
+  client.source_type = MultiResSource;
+  client.enable_extractor = opts.extractor;
+  client.omaf_params.http_params.conn_timeout = -1;  // not set
+  client.omaf_params.http_params.total_timeout = -1;  // not set
+  client.omaf_params.http_params.retry_times = 3;
+  client.omaf_params.http_params.http_version = 1;  // the local server is HTTP/1.1
+  client.omaf_params.max_parallel_transfers = 256;
+  client.omaf_params.segment_open_timeout_ms = 3000;  // ms
+  client.omaf_params.abr_params.enable = opts.abr ? 1 : 0;
+  client.omaf_params.abr_params.min_viewport_hq_tiles = -1;  // default
+
+  Handler handler = OmafAccess_Init(&client);
+  if (!handler) {
+    fprintf(stderr, "failed to create the omaf access handler\n");
+    return 2;
+  }
+
+  TraceSample pose = poseAt(trace, 0);
+  HeadSetInfo headset;
+  headset.pose = (HeadPose *)malloc(sizeof(HeadPose));
+  headset.pose->yaw = pose.yaw;
+  headset.pose->pitch = pose.pitch;
+  headset.viewPort_hFOV = opts.fov;
+  headset.viewPort_vFOV = opts.fov;
+  headset.viewPort_Width = opts.viewport_size;
+  headset.viewPort_Height = opts.viewport_size;
+  OmafAccess_SetupHeadSetInfo(handler, &headset);
+
+  int32_t ret = OmafAccess_OpenMedia(handler, &client, false, (char *)"", (char *)"");
+  if (ret != ERROR_NONE) {
+    fprintf(stderr, "failed to open the media %s, err=%d\n", url.c_str(), ret);
+    free(headset.pose);
+    OmafAccess_Close(handler);
+    return 2;
+  }
+  DashMediaInfo info;
+  memset(&info, 0, sizeof(info));
+  OmafAccess_GetMediaInfo(handler, &info);
+  if (info.stream_count > 0 && info.stream_info[0].mProjFormat != VCD::OMAF::PF_ERP) {
+    fprintf(stderr, "only ERP content is supported\n");
+    OmafAccess_CloseMedia(handler);
+    OmafAccess_Close(handler);
+    free(headset.pose);
+    return 2;
+  }
+  double frame_rate = DEFAULT_FRAME_RATE;
+  if (info.stream_count > 0 && info.stream_info[0].framerate_num > 0 && info.stream_info[0].framerate_den > 0) {
+    frame_rate = static_cast<double>(info.stream_info[0].framerate_num) / info.stream_info[0].framerate_den;
+  }
+
+  FILE *csv = opts.csv.size() ? fopen(opts.csv.c_str(), "w") : NULL;
+  if (csv) fprintf(csv, "frame,time_ms,yaw,pitch,hq_fraction,packet_bytes\n");
+  FILE *dump = opts.dump.size() ? fopen(opts.dump.c_str(), "wb") : NULL;
+
+  std::map<uint32_t, std::unique_ptr<SoftwareDecoder>> decoders;
+  std::map<uint32_t, QualityMask> masks;
+  Picture packed;
+  Picture projected;
+  std::vector<uint32_t> samples;
+  std::vector<FrameResult> frames;
+  std::vector<double> motion_to_hq_ms;
+  std::vector<double> render_ms;
+  uint64_t decode_failures = 0;
+  uint64_t unreached_motions = 0;
+
+  TraceSample motion_from = pose;
+  bool motion_pending = false;
+  std::chrono::steady_clock::time_point motion_start;
+  bool need_params = true;
+
+  auto start = std::chrono::steady_clock::now();
+  auto deadline = start + std::chrono::seconds(opts.duration_s);
+  auto frame_interval = std::chrono::duration<double>(1.0 / frame_rate);
+  while (std::chrono::steady_clock::now() < deadline) {
+    auto now = std::chrono::steady_clock::now();
+    uint64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+    TraceSample now_pose = poseAt(trace, elapsed_ms);
+    if (now_pose.yaw != pose.yaw || now_pose.pitch != pose.pitch) {
+      pose = now_pose;
+      HeadPose head;
+      head.yaw = pose.yaw;
+      head.pitch = pose.pitch;
+      OmafAccess_ChangeViewport(handler, &head);
+      if (angleDistance(pose.yaw, pose.pitch, motion_from.yaw, motion_from.pitch) > MOTION_THRESHOLD) {
+        if (motion_pending) unreached_motions++;
+        motion_from = pose;
+        motion_pending = true;
+        motion_start = now;
+      }
+    }
+
+    DashPacket pkts[MAX_PACKETS];
+    memset(pkts, 0, sizeof(pkts));
+    int count = 0;
+    uint64_t pts = 0;
+    ret = OmafAccess_GetPacket(handler, 0, pkts, &count, &pts, need_params, false);
+    if (ret != ERROR_NONE || count <= 0) {
+      if (ret == ERROR_EOS || (count > 0 && pkts[0].bEOS)) break;
+      freePackets(pkts, count);
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      continue;
+    }
+    need_params = false;
+
+    // the quality of the viewport comes from the packings of the packets, drawn in order as the render targets do
+    std::vector<QualityMask *> frame_masks;
+    std::vector<SharedRwpk::Ptr> rwpks(count);
+    FrameResult result;
+    result.time_ms = elapsed_ms;
+    result.yaw = pose.yaw;
+    result.pitch = pose.pitch;
+    result.bytes = 0;
+    for (int i = 0; i < count; i++) {
+      result.bytes += pkts[i].size;
+      rwpks[i] = pkts[i].rwpkRef ? SharedRwpk::FromHandle(pkts[i].rwpkRef)
+                                 : pkts[i].rwpk ? RWPKCACHE::GetInstance()->Share(*pkts[i].rwpk) : SharedRwpk::Ptr();
+      if (!rwpks[i]) continue;
+      const RegionWisePacking *rwpk = rwpks[i]->Get();
+      QualityMask &mask = masks[pkts[i].videoID];
+      if (!rwpk->rectRegionPacking || !updateQualityMask(pkts[i], rwpk, mask)) continue;
+      // the low quality packets first, the high quality ones are drawn on top
+      bool high = false;
+      for (int r = 0; r < rwpk->numRegions && !high; r++) high = isHighQuality(pkts[i], rwpk->rectRegionPacking[r]);
+      frame_masks.insert(high ? frame_masks.end() : frame_masks.begin(), &mask);
+    }
+
+    uint64_t hq = 0;
+    if (frame_masks.size()) {
+      Param_YUVPicture *first = frame_masks.back()->projected.planes();
+      viewportSamples(pose.yaw, pose.pitch, opts.fov, opts.viewport_size, first->width, first->height, samples);
+      for (size_t s = 0; s < samples.size(); s++) {
+        uint8_t level = SAMPLE_NOT_COVERED;
+        for (size_t m = 0; m < frame_masks.size(); m++) {
+          Param_YUVPicture *proj = frame_masks[m]->projected.planes();
+          if (proj->width != first->width || proj->height != first->height) continue;
+          uint8_t sample = proj->pPlanes[0][samples[s]];
+          if (sample != SAMPLE_NOT_COVERED) level = sample;
+        }
+        if (level == SAMPLE_HIGH_QUALITY) hq++;
+      }
+    }
+    result.hq_fraction = samples.size() ? static_cast<double>(hq) / samples.size() : 0.0;
+    frames.push_back(result);
+    if (csv) {
+      fprintf(csv, "%zu,%llu,%.2f,%.2f,%.4f,%llu\n", frames.size() - 1, (unsigned long long)result.time_ms, result.yaw,
+              result.pitch, result.hq_fraction, (unsigned long long)result.bytes);
+    }
+    if (motion_pending && result.hq_fraction >= opts.hq_target) {
+      motion_to_hq_ms.push_back(
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - motion_start).count());
+      motion_pending = false;
+    }
+
+    // decode and render the viewport of the frame on CPU
+    if (opts.decode) {
+      auto render_start = std::chrono::steady_clock::now();
+      bool rendered = false;
+      for (int i = 0; i < count; i++) {
+        std::unique_ptr<SoftwareDecoder> &decoder = decoders[pkts[i].videoID];
+        if (!decoder) {
+          decoder.reset(new SoftwareDecoder());
+          if (!decoder->open(pkts[i].video_codec)) {
+            fprintf(stderr, "failed to open the decoder of video %u\n", pkts[i].videoID);
+            decoder.reset();
+            decode_failures++;
+            continue;
+          }
+        }
+        if (!pkts[i].buf || !pkts[i].size) continue;
+        bool decoded = decoder->decode(pkts[i], rwpks[i], [&](const AVFrame *frame, SharedRwpk::Ptr rwpk) {
+          if (!rwpk) return;
+          const RegionWisePacking *packing = rwpk->Get();
+          copyFrame(frame, packed);
+          if (!rendered) {
+            projected.resize(packing->projPicWidth, packing->projPicHeight);
+            projected.fill(0, 128);
+            rendered = true;
+          }
+          if (I360SCVP_UnpackRWPK(const_cast<RegionWisePacking *>(packing), packed.planes(), projected.planes(), 0)) {
+            decode_failures++;
+          }
+        });
+        if (!decoded) decode_failures++;
+      }
+      if (rendered && dump) {
+        Param_YUVPicture *proj = projected.planes();
+        viewportSamples(pose.yaw, pose.pitch, opts.fov, opts.viewport_size, proj->width, proj->height, samples);
+        renderViewport(projected, samples, opts.viewport_size, dump);
+      }
+      render_ms.push_back(
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - render_start).count());
+    }
+
+    bool eos = pkts[0].bEOS;
+    freePackets(pkts, count);
+    rwpks.clear();
+    if (eos) break;
+
+    // paced at the frame rate, the head trace goes on with the wall clock when the evaluation is slower
+    auto next = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(frame_interval * frames.size());
+    if (next > std::chrono::steady_clock::now()) std::this_thread::sleep_until(next);
+  }
+  if (motion_pending) unreached_motions++;
+
+  double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  int64_t downloaded = downloadBytes(handler);
+  OmafAccess_CloseMedia(handler);
+  OmafAccess_Close(handler);
+  free(headset.pose);
+  decoders.clear();
+  if (server) server->stop();
+  if (csv) fclose(csv);
+  if (dump) fclose(dump);
+
+  std::vector<double> hq_fractions;
+  uint64_t packet_bytes = 0;
+  double hq_sum = 0.0;
+  for (auto &frame : frames) {
+    hq_fractions.push_back(frame.hq_fraction);
+    hq_sum += frame.hq_fraction;
+    packet_bytes += frame.bytes;
+  }
+  double hq_mean = frames.size() ? hq_sum / frames.size() : 0.0;
+  double motion_p95 = percentile(motion_to_hq_ms, 0.95);
+
+  printf("frames             %zu, %.2f fps, %.1f s, %.0f fps media\n", frames.size(), frames.size() / wall_s, wall_s,
+         frame_rate);
+  printf("hq in viewport     mean %.3f  p5 %.3f  p50 %.3f  min %.3f\n", hq_mean, percentile(hq_fractions, 0.05),
+         percentile(hq_fractions, 0.5), percentile(hq_fractions, 0.0));
+  printf("motion to hq       %zu motions  p50 %.1f ms  p95 %.1f ms  %llu not reached\n", motion_to_hq_ms.size(),
+         percentile(motion_to_hq_ms, 0.5), motion_p95, (unsigned long long)unreached_motions);
+  printf("bandwidth          download %.2f Mbps  packets %.2f Mbps\n", downloaded * 8 / wall_s / 1e6,
+         packet_bytes * 8 / wall_s / 1e6);
+  if (opts.decode) {
+    printf("decode and render  p50 %.3f ms  p95 %.3f ms  %llu failures\n", percentile(render_ms, 0.5),
+           percentile(render_ms, 0.95), (unsigned long long)decode_failures);
+  }
+
+  bool passed = frames.size() > 0;
+  if (opts.min_hq_mean > 0 && hq_mean < opts.min_hq_mean) {
+    printf("FAIL: hq in viewport mean %.3f under %.3f\n", hq_mean, opts.min_hq_mean);
+    passed = false;
+  }
+  if (opts.max_motion_to_hq_p95_ms > 0 && (motion_to_hq_ms.empty() || motion_p95 > opts.max_motion_to_hq_p95_ms)) {
+    printf("FAIL: motion to hq p95 %.1f ms over %.1f ms\n", motion_p95, opts.max_motion_to_hq_p95_ms);
+    passed = false;
+  }
+  return passed ? 0 : 1;
+}
@@ -16,6 +16,39 @@ if [ $? -ne 0 ]; then exit 1; fi
 ./testDownloader
 if [ $? -ne 0 ]; then exit 1; fi
 
+./testAbrController
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testSegmentCache
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testSubSegment
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testViewportPredictPlugin
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testViewportPredictBenchmark
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testGlogAsyncLogger
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testMetricsRegistry
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testRwpkCache
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testMappedFileStream
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testExtractorPlan
+if [ $? -ne 0 ]; then exit 1; fi
+
+./testTileTracksSelector
+if [ $? -ne 0 ]; then exit 1; fi
+
 ./testMediaSource --gtest_filter=*_static
 if [ $? -ne 0 ]; then exit 1; fi
 ./testMediaSource --gtest_filter=*_live
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testAbrController.cpp
+ * Author: media
+ *
+ */
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../OmafAbrController.h"
+#include "../OmafDashDownload/OmafDownloader.h"
+#include "testHttpServer.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+const size_t SEGMENT_SIZE = 256 * 1024;
+
+class AbrControllerTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    params.enable_ = true;
+    start = std::chrono::steady_clock::now() - std::chrono::hours(1);
+  }
+
+  virtual void TearDown() {}
+
+  // one transfer of the bytes at the bps, finished at the offset of the trace
+  void addTransfer(OmafAbrController &abr, size_t bytes, double bps, long offset_ms) {
+    long time_us = static_cast<long>(bytes * 8 * 1000000.0 / bps);
+    abr.AddTransfer(bytes, time_us, start + std::chrono::milliseconds(offset_ms));
+  }
+
+  OmafDashAbrParams params;
+  std::chrono::steady_clock::time_point start;
+};
+
+TEST_F(AbrControllerTest, bandwidth_trace) {
+  OmafAbrController abr(params);
+  EXPECT_EQ(abr.GetEstimatedBandwidth(), 0.0);
+
+  // 20Mbps for 10 segments, then drops to 5Mbps
+  long offset = 0;
+  for (int i = 0; i < 10; i++) {
+    offset += 1000;
+    addTransfer(abr, SEGMENT_SIZE, 20000000.0, offset);
+  }
+  EXPECT_NEAR(abr.GetEstimatedBandwidth(), 20000000.0, 200000.0);
+
+  offset += 1000;
+  addTransfer(abr, SEGMENT_SIZE, 5000000.0, offset);
+  offset += 1000;
+  addTransfer(abr, SEGMENT_SIZE, 5000000.0, offset);
+  // the drop is followed in two samples
+  EXPECT_LT(abr.GetEstimatedBandwidth(), 10000000.0);
+  EXPECT_GT(abr.GetSlowBandwidth(), abr.GetFastBandwidth());
+
+  // the recovery is trusted only when the slow estimator follows
+  offset += 1000;
+  addTransfer(abr, SEGMENT_SIZE, 20000000.0, offset);
+  offset += 1000;
+  addTransfer(abr, SEGMENT_SIZE, 20000000.0, offset);
+  EXPECT_LT(abr.GetEstimatedBandwidth(), 15000000.0);
+  EXPECT_GT(abr.GetFastBandwidth(), 15000000.0);
+}
+
+TEST_F(AbrControllerTest, overlapped_transfers) {
+  OmafAbrController abr(params);
+
+  // 4 tiles downloaded at the same time share 16Mbps, each one sees 4Mbps
+  for (int i = 0; i < 4; i++) {
+    addTransfer(abr, SEGMENT_SIZE, 4000000.0, 1000);
+  }
+  EXPECT_NEAR(abr.GetEstimatedBandwidth(), 16000000.0, 160000.0);
+}
+
+TEST_F(AbrControllerTest, viewport_tiles) {
+  OmafAbrController abr(params);
+  std::vector<uint64_t> tiles(8, 1000000);
+
+  // nothing measured, full viewport
+  EXPECT_EQ(abr.SelectViewportTiles(tiles, 2000000), 8);
+
+  // budget 10Mbps * 0.9 - 2Mbps background
+  addTransfer(abr, SEGMENT_SIZE, 10000000.0, 1000);
+  EXPECT_EQ(abr.SelectViewportTiles(tiles, 2000000), 7);
+
+  // low buffer halves the budget
+  abr.SetBufferLevel(500);
+  EXPECT_EQ(abr.SelectViewportTiles(tiles, 2000000), 2);
+  // adding tiles needs 10% headroom
+  abr.SetBufferLevel(2000);
+  EXPECT_EQ(abr.SelectViewportTiles(tiles, 2000000), 4);
+  abr.SetBufferLevel(3000);
+  EXPECT_EQ(abr.SelectViewportTiles(tiles, 2000000), 6);
+
+  // background eats all, at least the minimum is kept
+  EXPECT_EQ(abr.SelectViewportTiles(tiles, 20000000), params.min_viewport_hq_tiles_);
+}
+
+TEST_F(AbrControllerTest, local_http_trace) {
+  std::vector<double> trace;
+  for (int i = 0; i < 6; i++) trace.push_back(16000000.0);
+  for (int i = 0; i < 6; i++) trace.push_back(4000000.0);
+
+  // each response is paced by the bandwidth trace
+  TestHttpServer server;
+  server.body(SEGMENT_SIZE, 'a');
+  server.trace(trace);
+  ASSERT_TRUE(server.start());
+
+  OmafAbrController::Ptr abr = std::make_shared<OmafAbrController>(params);
+  OmafDashSegmentHttpClient::Ptr dash_client = OmafDashSegmentHttpClient::create(10);
+  ASSERT_TRUE(dash_client != nullptr);
+  dash_client->setTransferObserver(
+      [abr](size_t transfer_bytes, long download_time_us) { abr->AddTransfer(transfer_bytes, download_time_us); });
+  EXPECT_TRUE(dash_client->start() == ERROR_NONE);
+
+  double high_bps = 0.0;
+  for (size_t i = 0; i < trace.size(); i++) {
+    DashSegmentSourceParams ds;
+    ds.dash_url_ = server.url(i);
+    ds.timeline_point_ = i;
+
+    std::atomic_bool isState{false};
+    dash_client->open(
+        ds, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) { EXPECT_TRUE(sb != nullptr); },
+        [&isState](OmafDashSegmentClient::State state) {
+          EXPECT_TRUE(state == OmafDashSegmentClient::State::SUCCESS);
+          isState = true;
+        });
+    while (!isState) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // sequential segments, let the sample close
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    if (i == 5) high_bps = abr->GetEstimatedBandwidth();
+  }
+  double low_bps = abr->GetEstimatedBandwidth();
+  LOG(INFO) << "Estimated bandwidth high=" << high_bps << ", low=" << low_bps << std::endl;
+
+  EXPECT_GT(high_bps, 10000000.0);
+  EXPECT_LT(high_bps, 20000000.0);
+  EXPECT_LT(low_bps, 6000000.0);
+  EXPECT_GT(low_bps, 2000000.0);
+
+  EXPECT_TRUE(dash_client->stop() == ERROR_NONE);
+  server.stop();
+}
+
+}  // namespace
@@ -28,9 +28,11 @@
 #include <string>
 #include <thread>
 #include <memory>
+#include <atomic>
 #include <pwd.h>
 
 #include "../OmafDashDownload/OmafDownloader.h"
+#include "testHttpServer.h"
 
 using namespace VCD::OMAF;
 
@@ -218,4 +220,338 @@ TEST_F(DownloaderTest, no_proxy_success) {
   }
 }
 
+TEST_F(DownloaderTest, remove_all) {
+  TestHttpServer server;
+  server.body(1024, 'h');
+  ASSERT_TRUE(server.start());
+  server.hold(true);
+
+  OMAF_STATUS ret = dash_client_->start();
+  EXPECT_TRUE(ret == ERROR_NONE);
+
+  // more than the parallel transfers, some of them are still queued
+  std::atomic_int states{0};
+  for (int i = 0; i < 16; i++) {
+    DashSegmentSourceParams ds;
+    ds.dash_url_ = server.url(i);
+    ds.timeline_point_ = i + 1;
+    dash_client_->open(
+        ds, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {},
+        [&states](OmafDashSegmentClient::State state) { states++; });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  EXPECT_TRUE(dash_client_->removeAll() == ERROR_NONE);
+  server.hold(false);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  EXPECT_EQ(states.load(), 0);
+
+  // the timeline of the next media starts over
+  DashSegmentSourceParams ds;
+  ds.dash_url_ = server.url(100);
+  ds.timeline_point_ = 1;
+  std::atomic_bool isState{false};
+  dash_client_->open(
+      ds, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) { EXPECT_TRUE(sb != nullptr); },
+      [&isState](OmafDashSegmentClient::State state) {
+        EXPECT_TRUE(state == OmafDashSegmentClient::State::SUCCESS);
+        isState = true;
+      });
+  while (!isState) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(states.load(), 0);
+
+  EXPECT_TRUE(dash_client_->stop() == ERROR_NONE);
+  server.stop();
+}
+
+TEST_F(DownloaderTest, switch_while_completing) {
+  TestHttpServer server(4);
+  server.body(4096, 's');
+  ASSERT_TRUE(server.start());
+
+  OMAF_STATUS ret = dash_client_->start();
+  EXPECT_TRUE(ret == ERROR_NONE);
+
+  // stands for the reader manager released by the switch after removeAll
+  struct Reader {
+    std::atomic_bool alive{true};
+    std::atomic_int done{0};
+    std::atomic_int late{0};
+  };
+  int late = 0;
+  for (int round = 0; round < 20; round++) {
+    auto reader = std::make_shared<Reader>();
+    for (int i = 0; i < 32; i++) {
+      DashSegmentSourceParams ds;
+      ds.dash_url_ = server.url(round * 32 + i);
+      ds.timeline_point_ = i / 4 + 1;
+      dash_client_->open(
+          ds, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {},
+          [reader](OmafDashSegmentClient::State state) {
+            if (!reader->alive) reader->late++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (!reader->alive) reader->late++;
+            reader->done++;
+          });
+    }
+    // switch when the transfers are completing
+    auto start = std::chrono::steady_clock::now();
+    while (reader->done.load() < 2 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    EXPECT_TRUE(dash_client_->removeAll() == ERROR_NONE);
+    reader->alive = false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    late += reader->late.load();
+  }
+  EXPECT_EQ(late, 0);
+
+  // the client keeps serving the next media
+  DashSegmentSourceParams ds;
+  ds.dash_url_ = server.url(1000);
+  ds.timeline_point_ = 1;
+  std::atomic_bool isState{false};
+  dash_client_->open(
+      ds, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) { EXPECT_TRUE(sb != nullptr); },
+      [&isState](OmafDashSegmentClient::State state) {
+        EXPECT_TRUE(state == OmafDashSegmentClient::State::SUCCESS);
+        isState = true;
+      });
+  while (!isState) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  EXPECT_TRUE(dash_client_->stop() == ERROR_NONE);
+  server.stop();
+}
+
+TEST_F(DownloaderTest, warmup) {
+  TestHttpServer server;
+  server.body(1024, 'w');
+  ASSERT_TRUE(server.start());
+
+  dash_client_->setStatisticsWindows(10000);
+  EXPECT_TRUE(dash_client_->start() == ERROR_NONE);
+  EXPECT_TRUE(dash_client_->warmup(server.url(0), 3) == ERROR_NONE);
+  for (int i = 0; i < 5000 && server.requests() < 3; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(server.requests(), 3u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // warmup is not a segment, it is kept out of the statistics
+  std::unique_ptr<OmafDashSegmentClient::PerfStatistics> stats = dash_client_->statistics();
+  ASSERT_TRUE(stats != nullptr);
+  EXPECT_EQ(stats->success_.count_total_, 0u);
+
+  DashSegmentSourceParams ds;
+  ds.dash_url_ = server.url(1);
+  ds.timeline_point_ = 1;
+  std::atomic_bool isState{false};
+  dash_client_->open(
+      ds, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) { EXPECT_TRUE(sb != nullptr); },
+      [&isState](OmafDashSegmentClient::State state) {
+        EXPECT_TRUE(state == OmafDashSegmentClient::State::SUCCESS);
+        isState = true;
+      });
+  while (!isState) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  stats = dash_client_->statistics();
+  ASSERT_TRUE(stats != nullptr);
+  EXPECT_EQ(stats->success_.count_total_, 1u);
+  EXPECT_EQ(server.requests(), 4u);
+
+  EXPECT_TRUE(dash_client_->stop() == ERROR_NONE);
+  server.stop();
+}
+
+TEST_F(DownloaderTest, priority_order) {
+  TestHttpServer server;
+  server.body(1024, 'p');
+  ASSERT_TRUE(server.start());
+
+  // one transfer at a time, so the server sees the scheduled order
+  OmafDashSegmentHttpClient::Ptr dash_client = OmafDashSegmentHttpClient::create(1);
+  ASSERT_TRUE(dash_client != nullptr);
+  dash_client->setParams(client_params);
+
+  struct {
+    int index;
+    int64_t timeline;
+    TaskPriority priority;
+    int deadline_s;
+  } segments[] = {
+      {1, 1, TaskPriority::LOW, 30},      {2, 1, TaskPriority::HIGH, 20},  {3, 1, TaskPriority::HIGH, 10},
+      {4, 1, TaskPriority::FALLBACK, 30}, {5, 2, TaskPriority::LOW, 40}, {6, 2, TaskPriority::FALLBACK, 30},
+  };
+  // queued before the worker starts, so all of them are ranked together
+  std::atomic_int states{0};
+  for (auto &seg : segments) {
+    DashSegmentSourceParams ds;
+    ds.dash_url_ = server.url(seg.index);
+    ds.timeline_point_ = seg.timeline;
+    ds.priority_ = seg.priority;
+    ds.deadline_ = std::chrono::steady_clock::now() + std::chrono::seconds(seg.deadline_s);
+    EXPECT_TRUE(dash_client->open(
+                    ds, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {},
+                    [&states](OmafDashSegmentClient::State state) {
+                      EXPECT_TRUE(state == OmafDashSegmentClient::State::SUCCESS);
+                      states++;
+                    }) == ERROR_NONE);
+  }
+  EXPECT_TRUE(dash_client->start() == ERROR_NONE);
+  for (int i = 0; i < 5000 && states < 6; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(states.load(), 6);
+
+  // the fallback of all timelines first, then the oldest timeline by priority and deadline,
+  // the ready tasks in the multi downloader are ranked again by priority and deadline
+  std::vector<std::string> expected = {"/seg4", "/seg6", "/seg3", "/seg2", "/seg1", "/seg5"};
+  EXPECT_EQ(server.paths(), expected);
+
+  EXPECT_TRUE(dash_client->stop() == ERROR_NONE);
+  server.stop();
+}
+
+TEST_F(DownloaderTest, deadline_drop) {
+  TestHttpServer server;
+  server.body(1024, 'd');
+  ASSERT_TRUE(server.start());
+
+  std::atomic_int timeout{0};
+  std::atomic_int success{0};
+  auto onState = [&timeout, &success](OmafDashSegmentClient::State state) {
+    if (state == OmafDashSegmentClient::State::TIMEOUT) timeout++;
+    if (state == OmafDashSegmentClient::State::SUCCESS) success++;
+  };
+  // queued before the worker starts, the missed one is never transferred
+  DashSegmentSourceParams missed;
+  missed.dash_url_ = server.url(1);
+  missed.timeline_point_ = 1;
+  missed.priority_ = TaskPriority::HIGH;
+  missed.deadline_ = std::chrono::steady_clock::now() - std::chrono::milliseconds(1);
+  EXPECT_TRUE(dash_client_->open(missed, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {}, onState) == ERROR_NONE);
+  DashSegmentSourceParams ds;
+  ds.dash_url_ = server.url(2);
+  ds.timeline_point_ = 1;
+  ds.priority_ = TaskPriority::LOW;
+  EXPECT_TRUE(dash_client_->open(ds, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {}, onState) == ERROR_NONE);
+
+  EXPECT_TRUE(dash_client_->start() == ERROR_NONE);
+  for (int i = 0; i < 5000 && timeout + success < 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(timeout.load(), 1);
+  EXPECT_EQ(success.load(), 1);
+  std::vector<std::string> expected = {"/seg2"};
+  EXPECT_EQ(server.paths(), expected);
+
+  EXPECT_TRUE(dash_client_->stop() == ERROR_NONE);
+  server.stop();
+}
+
+TEST_F(DownloaderTest, cancel) {
+  TestHttpServer server;
+  server.body(1024, 'c');
+  ASSERT_TRUE(server.start());
+  server.hold(true);
+
+  // one transfer at a time, the others wait in the queue
+  OmafDashSegmentHttpClient::Ptr dash_client = OmafDashSegmentHttpClient::create(1);
+  ASSERT_TRUE(dash_client != nullptr);
+  dash_client->setParams(client_params);
+  EXPECT_TRUE(dash_client->start() == ERROR_NONE);
+
+  std::vector<DashSegmentSourceParams> segments;
+  std::vector<OmafDashSegmentClient::State> states(5, OmafDashSegmentClient::State::FAILURE);
+  std::atomic_int done{0};
+  for (int i = 0; i < 5; i++) {
+    DashSegmentSourceParams ds;
+    ds.dash_url_ = server.url(i);
+    ds.timeline_point_ = i + 1;
+    ds.priority_ = i ? TaskPriority::LOW : TaskPriority::FALLBACK;
+    segments.push_back(ds);
+    EXPECT_TRUE(dash_client->open(
+                    ds, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {},
+                    [&states, &done, i](OmafDashSegmentClient::State state) {
+                      states[i] = state;
+                      done++;
+                    }) == ERROR_NONE);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  // the running fallback is kept, the waiting ones are done with stopped
+  EXPECT_TRUE(dash_client->cancel(segments[0]) != ERROR_NONE);
+  for (int i = 1; i < 5; i++) {
+    EXPECT_TRUE(dash_client->cancel(segments[i]) == ERROR_NONE);
+    EXPECT_TRUE(states[i] == OmafDashSegmentClient::State::STOPPED);
+  }
+  EXPECT_EQ(done.load(), 4);
+
+  server.hold(false);
+  for (int i = 0; i < 5000 && done < 5; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(states[0] == OmafDashSegmentClient::State::SUCCESS);
+  std::vector<std::string> expected = {"/seg0"};
+  EXPECT_EQ(server.paths(), expected);
+
+  EXPECT_TRUE(dash_client->stop() == ERROR_NONE);
+  server.stop();
+}
+
+// the transfers are held by the server, returns the most connections opened meanwhile
+size_t heldConnections(OmafDashSegmentHttpClient::Ptr dash_client, OmafDashHttpParams params) {
+  TestHttpServer server(4);
+  server.body(1024, 'm');
+  EXPECT_TRUE(server.start());
+  server.hold(true);
+
+  dash_client->setParams(params);
+  EXPECT_TRUE(dash_client->start() == ERROR_NONE);
+  std::atomic_int states{0};
+  for (int i = 0; i < 8; i++) {
+    DashSegmentSourceParams ds;
+    ds.dash_url_ = server.url(i);
+    ds.timeline_point_ = i + 1;
+    dash_client->open(
+        ds, [](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {},
+        [&states](OmafDashSegmentClient::State state) {
+          EXPECT_TRUE(state == OmafDashSegmentClient::State::SUCCESS);
+          states++;
+        });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  size_t connections = server.concurrency();
+
+  server.hold(false);
+  for (int i = 0; i < 5000 && states < 8; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(states.load(), 8);
+  EXPECT_TRUE(dash_client->stop() == ERROR_NONE);
+  server.stop();
+  return connections;
+}
+
+TEST_F(DownloaderTest, multiplex) {
+  // the transfers wait for the connection to be multiplexed instead of opening new ones
+  client_params.bmultiplex_ = true;
+  EXPECT_EQ(heldConnections(dash_client_, client_params), 1u);
+}
+
+TEST_F(DownloaderTest, host_connections) {
+  client_params.bmultiplex_ = false;
+  client_params.max_host_connections_ = 2;
+  EXPECT_EQ(heldConnections(dash_client_, client_params), 2u);
+
+  OmafDashSegmentHttpClient::Ptr dash_client = OmafDashSegmentHttpClient::create(10);
+  client_params.max_host_connections_ = 0;
+  EXPECT_EQ(heldConnections(dash_client, client_params), 4u);
+}
+
 }  // namespace
\ No newline at end of file
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testExtractorPlan.cpp
+ * Author: media
+ *
+ */
+
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <vector>
+
+#include "../../isolib/dash_parser/Mp4ReaderImpl.h"
+
+using namespace VCD::MP4;
+
+namespace {
+
+const uint8_t LEN_SIZE_MINUS1 = 3;
+
+class ExtractorPlanTest : public testing::Test {
+ public:
+  // appends one NAL unit with a 4 bytes length and the 2 bytes header of the type
+  void addNal(uint8_t type, const std::vector<char> &payload) {
+    put32(static_cast<uint32_t>(payload.size() + 2));
+    sample.push_back(static_cast<char>(type << 1));
+    sample.push_back(1);
+    sample.insert(sample.end(), payload.begin(), payload.end());
+  }
+
+  static void put32(std::vector<char> &data, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) data.push_back(static_cast<char>((value >> shift) & 0xff));
+  }
+  void put32(uint32_t value) { put32(sample, value); }
+
+  // sample constructor of track_ref_index, offset and length
+  static std::vector<char> sampleConst(uint8_t trackRef, uint32_t offset, uint32_t length) {
+    std::vector<char> data = {0, static_cast<char>(trackRef), 0};
+    put32(data, offset);
+    put32(data, length);
+    return data;
+  }
+
+  // inline constructor of the rewritten NAL length and header
+  static std::vector<char> inlineConst(uint32_t nalLength) {
+    std::vector<char> data = {2, 6};
+    put32(data, nalLength);
+    data.push_back(0x02);
+    data.push_back(0x01);
+    return data;
+  }
+
+  int32_t parse() {
+    return Mp4Reader::GenExtractorPlan(sample.data(), static_cast<uint32_t>(sample.size()), LEN_SIZE_MINUS1, plan,
+                                       extSize);
+  }
+
+  std::vector<char> sample;
+  std::vector<ExtConstruct> plan;
+  uint64_t extSize = 0;
+};
+
+std::vector<char> operator+(std::vector<char> a, const std::vector<char> &b) {
+  a.insert(a.end(), b.begin(), b.end());
+  return a;
+}
+
+TEST_F(ExtractorPlanTest, constructors_in_stream_order) {
+  addNal(39, {1, 2, 3});  // prefix sei is skipped
+  addNal(49, inlineConst(100) + sampleConst(1, 8, 90) + sampleConst(2, 0, 0));
+  addNal(49, inlineConst(50) + sampleConst(3, 8, 40));
+
+  EXPECT_EQ(parse(), ERROR_NONE);
+  ASSERT_EQ(plan.size(), 5u);
+
+  EXPECT_TRUE(plan[0].isInline);
+  EXPECT_EQ(plan[0].dataLength, 6u);
+  EXPECT_EQ(plan[0].inlineData[3], 100);
+
+  EXPECT_FALSE(plan[1].isInline);
+  EXPECT_EQ(plan[1].trackRefIndex, 0);
+  EXPECT_EQ(plan[1].dataOffset, 8u);
+  EXPECT_EQ(plan[1].dataLength, 90u);
+
+  EXPECT_EQ(plan[2].trackRefIndex, 1);
+  EXPECT_EQ(plan[2].dataLength, 0u);
+
+  EXPECT_TRUE(plan[3].isInline);
+  EXPECT_EQ(plan[4].trackRefIndex, 2);
+
+  // the sample and inline data sizes
+  EXPECT_EQ(extSize, 90u + 40u + 6u + 6u);
+}
+
+TEST_F(ExtractorPlanTest, no_extractor) {
+  addNal(1, {1, 2, 3});
+  EXPECT_EQ(parse(), OMAF_UNSUPPORTED_DASH_CODECS_TYPE);
+
+  sample.clear();
+  EXPECT_EQ(parse(), OMAF_UNSUPPORTED_DASH_CODECS_TYPE);
+}
+
+TEST_F(ExtractorPlanTest, bad_length_size) {
+  addNal(49, sampleConst(1, 0, 0));
+  EXPECT_EQ(Mp4Reader::GenExtractorPlan(sample.data(), static_cast<uint32_t>(sample.size()), 2, plan, extSize),
+            OMAF_INVALID_SEGMENT);
+}
+
+TEST_F(ExtractorPlanTest, truncated_length) {
+  addNal(49, sampleConst(1, 0, 0));
+  sample.push_back(0);
+  sample.push_back(0);
+  EXPECT_EQ(parse(), OMAF_INVALID_SEGMENT);
+}
+
+TEST_F(ExtractorPlanTest, nal_beyond_sample) {
+  addNal(49, sampleConst(1, 0, 0));
+  sample.pop_back();
+  EXPECT_EQ(parse(), OMAF_INVALID_SEGMENT);
+}
+
+TEST_F(ExtractorPlanTest, nal_without_header) {
+  put32(1);
+  sample.push_back(0);
+  EXPECT_EQ(parse(), OMAF_INVALID_SEGMENT);
+}
+
+TEST_F(ExtractorPlanTest, truncated_sample_constructor) {
+  std::vector<char> constructor = sampleConst(1, 0, 0);
+  constructor.resize(constructor.size() - 3);
+  addNal(49, constructor);
+  EXPECT_EQ(parse(), OMAF_INVALID_SEGMENT);
+}
+
+TEST_F(ExtractorPlanTest, inline_beyond_nal) {
+  std::vector<char> constructor = inlineConst(10);
+  constructor[1] = 20;
+  addNal(49, constructor);
+  EXPECT_EQ(parse(), OMAF_INVALID_SEGMENT);
+}
+
+TEST_F(ExtractorPlanTest, inline_shorter_than_length) {
+  addNal(49, {2, 2, 0, 0});
+  EXPECT_EQ(parse(), OMAF_INVALID_SEGMENT);
+}
+
+TEST_F(ExtractorPlanTest, unknown_constructor) {
+  addNal(49, std::vector<char>{1, 0, 0} + sampleConst(1, 0, 0));
+  EXPECT_EQ(parse(), OMAF_INVALID_SEGMENT);
+}
+
+}  // namespace
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testGlogAsyncLogger.cpp
+ * Author: media
+ *
+ */
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../utils/GlogWrapper.h"
+
+namespace {
+
+// stand-in of the glog file logger, keeps what is written
+class MemoryLogger : public google::base::Logger {
+ public:
+  virtual void Write(bool force_flush, time_t timestamp, const char *message, int message_len) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lines_.emplace_back(message, message_len);
+  }
+  virtual void Flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushes_++;
+  }
+  virtual uint32_t LogSize() { return 0; }
+
+  std::vector<std::string> lines() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lines_;
+  }
+  int flushes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flushes_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::string> lines_;
+  int flushes_ = 0;
+};
+
+class GlogAsyncLoggerTest : public testing::Test {
+ public:
+  virtual void SetUp() {}
+  virtual void TearDown() {}
+
+  void write(google::base::Logger &logger, const std::string &message) {
+    logger.Write(false, time(nullptr), message.c_str(), static_cast<int>(message.size()));
+  }
+};
+
+TEST_F(GlogAsyncLoggerTest, keep_order) {
+  MemoryLogger file;
+  {
+    GlogAsyncLogger async(&file);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([this, &async, t]() {
+        for (int i = 0; i < 400; i++) {
+          write(async, std::to_string(t) + " " + std::to_string(i) + "\n");
+        }
+      });
+    }
+    for (auto &thread : threads) thread.join();
+    // longer than a slot, written at once after the queued ones
+    write(async, std::string(ASYNC_LOG_MESSAGE_SIZE * 2, 'x') + "\n");
+    EXPECT_EQ(async.Dropped(), 0);
+  }
+
+  std::vector<std::string> lines = file.lines();
+  ASSERT_EQ(lines.size(), 4 * 400 + 1);
+  int last[4] = {-1, -1, -1, -1};
+  for (size_t i = 0; i + 1 < lines.size(); i++) {
+    int t = 0, n = 0;
+    ASSERT_EQ(sscanf(lines[i].c_str(), "%d %d", &t, &n), 2);
+    EXPECT_EQ(n, last[t] + 1);
+    last[t] = n;
+  }
+  EXPECT_EQ(lines.back().size(), ASYNC_LOG_MESSAGE_SIZE * 2 + 1);
+}
+
+TEST_F(GlogAsyncLoggerTest, drop_when_full) {
+  MemoryLogger file;
+  uint64_t dropped = 0;
+  {
+    GlogAsyncLogger async(&file, 4);
+    for (int i = 0; i < 10000; i++) {
+      write(async, "message\n");
+    }
+    async.Flush();
+    dropped = async.Dropped();
+  }
+
+  // the dropped ones are reported in the log
+  std::vector<std::string> lines = file.lines();
+  size_t messages = 0;
+  uint64_t reported = 0;
+  for (auto &line : lines) {
+    unsigned long long count = 0;
+    if (line == "message\n") {
+      messages++;
+    } else if (sscanf(line.c_str(), "Async logger dropped %llu", &count) == 1) {
+      reported += count;
+    }
+  }
+  EXPECT_EQ(messages + dropped, 10000);
+  EXPECT_EQ(reported, dropped);
+}
+
+TEST_F(GlogAsyncLoggerTest, fatal_written_at_once) {
+  MemoryLogger file;
+  GlogAsyncLogger async(&file);
+  for (int i = 0; i < 100; i++) {
+    write(async, "I " + std::to_string(i) + "\n");
+  }
+  // glog aborts right after a fatal one, so it is on disk with the queued ones when Write returns
+  write(async, "F fatal\n");
+
+  std::vector<std::string> lines = file.lines();
+  ASSERT_EQ(lines.size(), 101u);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(lines[i], "I " + std::to_string(i) + "\n");
+  }
+  EXPECT_EQ(lines.back(), "F fatal\n");
+  EXPECT_GE(file.flushes(), 1);
+}
+
+TEST_F(GlogAsyncLoggerTest, rate_limit) {
+  GlogRateLimit site;
+  uint64_t suppressed = 0;
+  EXPECT_TRUE(site.Allow(50, &suppressed));
+  EXPECT_EQ(suppressed, 0);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_FALSE(site.Allow(50, &suppressed));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  EXPECT_TRUE(site.Allow(50, &suppressed));
+  EXPECT_EQ(suppressed, 10);
+
+  // one log in the interval from each site, the message is not evaluated when skipped
+  int evaluated = 0;
+  for (int i = 0; i < 1000; i++) {
+    LOG_EVERY_MS(INFO, 60000) << "rate limited " << ++evaluated << std::endl;
+  }
+  EXPECT_EQ(evaluated, 1);
+
+#ifndef _ENABLE_TRACE_LOG_
+  LOG_TRACE << "stripped " << ++evaluated << std::endl;
+  EXPECT_EQ(evaluated, 1);
+#endif
+}
+
+}  // namespace
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testHttpServer.h
+ * Author: media
+ *
+ * local http/1.1 stand-in shared by the download tests and the headless tools.
+ * one request per connection, it serves one body for every path or the files
+ * under a root, and has hooks to hold the responses, count them, answer the
+ * conditional requests, serve byte ranges and pace the bodies by a bandwidth
+ * trace. each user is one translation unit, so it is kept in an anonymous
+ * namespace.
+ */
+
+#ifndef _TEST_HTTP_SERVER_H_
+#define _TEST_HTTP_SERVER_H_
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class TestHttpServer {
+ public:
+  TestHttpServer(int workers = 1) : worker_count_(workers) {}
+  ~TestHttpServer() { stop(); }
+
+  // the hooks below are set before start
+
+  // the same body for every path
+  void body(const std::vector<char> &body) { body_ = body; }
+  void body(size_t size, char fill) { body_.assign(size, fill); }
+  // serve the files under the root instead of the body
+  void root(const std::string &root) { root_ = root; }
+  // without it the range requests are answered with the whole body
+  void rangeSupport(bool support) { range_support_ = support; }
+  // the n-th response is paced at the n-th rate in bps, the last rate is kept
+  void trace(const std::vector<double> &trace_bps) { trace_bps_ = trace_bps; }
+
+  // the hooks below can be changed while serving
+
+  // the responses are held until it is released
+  void hold(bool hold) { hold_ = hold; }
+  // with an etag set, the matched conditional request is answered with 304
+  void etag(const std::string &etag) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    etag_ = etag;
+  }
+
+  bool start() {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) return false;
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (bind(listen_fd_, (struct sockaddr *)&addr, sizeof(addr)) != 0) return false;
+    socklen_t len = sizeof(addr);
+    if (getsockname(listen_fd_, (struct sockaddr *)&addr, &len) != 0) return false;
+    port_ = ntohs(addr.sin_port);
+    if (listen(listen_fd_, 256) != 0) return false;
+
+    running_ = true;
+    for (int i = 0; i < worker_count_; i++) {
+      workers_.emplace_back([this]() { this->serve(); });
+    }
+    return true;
+  }
+
+  void stop() {
+    if (!running_) return;
+    running_ = false;
+    shutdown(listen_fd_, SHUT_RDWR);
+    close(listen_fd_);
+    for (auto &worker : workers_) {
+      if (worker.joinable()) worker.join();
+    }
+    workers_.clear();
+  }
+
+  std::string url(int index) { return url("seg" + std::to_string(index)); }
+  std::string url(const std::string &path) { return "http://127.0.0.1:" + std::to_string(port_) + "/" + path; }
+
+  size_t requests() { return requests_.load(); }
+  size_t notModified() { return not_modified_.load(); }
+  // the most connections served at once
+  size_t concurrency() { return concurrency_.load(); }
+  // the requested ranges in arrival order, empty for the whole body
+  std::vector<std::string> ranges() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ranges_;
+  }
+  // the requested paths in arrival order
+  std::vector<std::string> paths() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return paths_;
+  }
+
+ private:
+  void serve() {
+    while (running_) {
+      int fd = accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0) break;
+      size_t inflight = ++inflight_;
+      size_t peak = concurrency_.load();
+      while (inflight > peak && !concurrency_.compare_exchange_weak(peak, inflight)) {
+      }
+      respond(fd);
+      close(fd);
+      inflight_--;
+    }
+  }
+
+  void respond(int fd) {
+    char buf[4096];
+    std::string header;
+    while (header.find("\r\n\r\n") == std::string::npos) {
+      ssize_t n = recv(fd, buf, sizeof(buf), 0);
+      if (n <= 0) return;
+      header.append(buf, n);
+    }
+
+    std::istringstream request(header);
+    std::string method, path;
+    request >> method >> path;
+    size_t query = path.find('?');
+    if (query != std::string::npos) path = path.substr(0, query);
+
+    std::string range;
+    size_t range_pos = header.find("Range: bytes=");
+    if (range_pos != std::string::npos) {
+      range = header.substr(range_pos + 13, header.find("\r\n", range_pos) - range_pos - 13);
+    }
+    std::string etag;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      etag = etag_;
+      paths_.push_back(path);
+      ranges_.push_back(range);
+    }
+    size_t index = requests_++;
+
+    while (hold_ && running_) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    if ((method != "GET" && method != "HEAD") || path.find("..") != std::string::npos) {
+      reply(fd, "400 Bad Request", 0);
+      return;
+    }
+    if (etag.size() && header.find("If-None-Match: " + etag + "\r\n") != std::string::npos) {
+      not_modified_++;
+      std::string resp = "HTTP/1.1 304 Not Modified\r\nETag: " + etag + "\r\nConnection: close\r\n\r\n";
+      sendAll(fd, resp.data(), resp.size());
+      return;
+    }
+
+    std::ifstream file;
+    uint64_t size = body_.size();
+    if (root_.size()) {
+      struct stat st;
+      file.open(root_ + path, std::ios::binary);
+      if (!file.is_open() || stat((root_ + path).c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        reply(fd, "404 Not Found", 0);
+        return;
+      }
+      size = static_cast<uint64_t>(st.st_size);
+    }
+
+    uint64_t first = 0;
+    uint64_t last = size ? size - 1 : 0;
+    bool ranged = false;
+    if (range.size() && range_support_) {
+      unsigned long long from = 0, to = 0;
+      int fields = sscanf(range.c_str(), "%llu-%llu", &from, &to);
+      if (fields >= 1 && from < size) {
+        first = from;
+        if (fields == 2 && to < size) last = to;
+        ranged = true;
+      }
+    }
+    uint64_t length = size ? last - first + 1 : 0;
+    std::string extra;
+    if (range_support_) extra += "Accept-Ranges: bytes\r\n";
+    if (ranged) {
+      extra += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" +
+               std::to_string(size) + "\r\n";
+    }
+    if (etag.size()) extra += "ETag: " + etag + "\r\n";
+    reply(fd, ranged ? "206 Partial Content" : "200 OK", length, extra);
+    if (method == "HEAD") return;
+
+    double bps = trace_bps_.size() ? trace_bps_[std::min(index, trace_bps_.size() - 1)] : 0.0;
+    if (root_.size()) file.seekg(first);
+    std::vector<char> chunk(bps > 0.0 ? 16 * 1024 : 64 * 1024);
+    while (length > 0) {
+      size_t want = static_cast<size_t>(std::min<uint64_t>(length, chunk.size()));
+      const char *data = body_.data() + first;
+      if (root_.size()) {
+        file.read(chunk.data(), want);
+        want = static_cast<size_t>(file.gcount());
+        data = chunk.data();
+      }
+      if (want == 0 || !sendAll(fd, data, want)) break;
+      first += want;
+      length -= want;
+      if (bps > 0.0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long>(want * 8 * 1000000.0 / bps)));
+      }
+    }
+  }
+
+  void reply(int fd, const std::string &status, uint64_t length, const std::string &extra = "") {
+    std::string resp = "HTTP/1.1 " + status + "\r\nContent-Length: " + std::to_string(length) + "\r\n" + extra +
+                       "Connection: close\r\n\r\n";
+    sendAll(fd, resp.data(), resp.size());
+  }
+
+  // the client may have closed the removed transfers
+  bool sendAll(int fd, const char *data, size_t size) {
+    while (size > 0) {
+      ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+      if (n <= 0) return false;
+      data += n;
+      size -= n;
+    }
+    return true;
+  }
+
+ private:
+  int worker_count_ = 1;
+  std::vector<char> body_;
+  std::string root_;
+  bool range_support_ = true;
+  std::vector<double> trace_bps_;
+  std::atomic_bool hold_{false};
+  std::mutex mutex_;
+  std::string etag_;
+  std::vector<std::string> ranges_;
+  std::vector<std::string> paths_;
+  std::atomic_size_t requests_{0};
+  std::atomic_size_t not_modified_{0};
+  std::atomic_size_t inflight_{0};
+  std::atomic_size_t concurrency_{0};
+  int listen_fd_ = -1;
+  int port_ = 0;
+  std::atomic_bool running_{false};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace
+
+#endif /* _TEST_HTTP_SERVER_H_ */
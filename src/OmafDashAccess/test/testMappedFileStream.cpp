@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testMappedFileStream.cpp
+ * Author: media
+ *
+ */
+
+#include "gtest/gtest.h"
+#include <unistd.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../OmafDashDownload/Stream.h"
+#include "../OmafSegment.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+const size_t FILE_SIZE = 300 * 1024 + 17;
+
+class MappedFileStreamTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    char name[] = "/tmp/mapped_stream_XXXXXX";
+    int fd = mkstemp(name);
+    ASSERT_TRUE(fd >= 0);
+    file_name = name;
+
+    content.resize(FILE_SIZE);
+    for (size_t i = 0; i < FILE_SIZE; i++) {
+      content[i] = static_cast<char>((i * 31 + 7) & 0xff);
+    }
+    ASSERT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    close(fd);
+  }
+
+  virtual void TearDown() { unlink(file_name.c_str()); }
+
+  std::string file_name;
+  std::vector<char> content;
+};
+
+TEST_F(MappedFileStreamTest, read_seek) {
+  MappedFileStream stream;
+  EXPECT_FALSE(stream.is_open());
+  EXPECT_FALSE(stream.open(file_name + ".none"));
+  ASSERT_TRUE(stream.open(file_name));
+  EXPECT_TRUE(stream.is_open());
+  EXPECT_EQ(stream.GetStreamSize(), static_cast<int64_t>(FILE_SIZE));
+  EXPECT_TRUE(stream.data() != nullptr);
+  EXPECT_EQ(memcmp(stream.data(), content.data(), FILE_SIZE), 0);
+
+  // read in chunks across the whole file
+  std::vector<char> buf(FILE_SIZE);
+  int64_t total = 0;
+  while (total < static_cast<int64_t>(FILE_SIZE)) {
+    int64_t n = stream.ReadStream(buf.data() + total, 4096);
+    ASSERT_GT(n, 0);
+    total += n;
+    EXPECT_EQ(stream.TellOffset(), total);
+  }
+  EXPECT_EQ(buf, content);
+  EXPECT_EQ(stream.ReadStream(buf.data(), 16), 0);
+
+  // the size query does not move the read position
+  EXPECT_TRUE(stream.SeekAbsoluteOffset(1000));
+  EXPECT_EQ(stream.GetStreamSize(), static_cast<int64_t>(FILE_SIZE));
+  EXPECT_EQ(stream.TellOffset(), 1000);
+  char bytes[8];
+  EXPECT_EQ(stream.ReadStream(bytes, 8), 8);
+  EXPECT_EQ(memcmp(bytes, content.data() + 1000, 8), 0);
+
+  // the tail is cut at the end of file
+  EXPECT_TRUE(stream.SeekAbsoluteOffset(FILE_SIZE - 3));
+  EXPECT_EQ(stream.ReadStream(bytes, 8), 3);
+  EXPECT_FALSE(stream.SeekAbsoluteOffset(FILE_SIZE + 1));
+  EXPECT_FALSE(stream.SeekAbsoluteOffset(-1));
+
+  stream.close();
+  EXPECT_FALSE(stream.is_open());
+  EXPECT_EQ(stream.GetStreamSize(), 0);
+}
+
+TEST_F(MappedFileStreamTest, empty_file) {
+  std::string empty_name = file_name + ".empty";
+  FILE *fp = fopen(empty_name.c_str(), "wb");
+  ASSERT_TRUE(fp != nullptr);
+  fclose(fp);
+
+  MappedFileStream stream;
+  EXPECT_TRUE(stream.open(empty_name));
+  EXPECT_EQ(stream.GetStreamSize(), 0);
+  char byte;
+  EXPECT_EQ(stream.ReadStream(&byte, 1), 0);
+  unlink(empty_name.c_str());
+}
+
+TEST_F(MappedFileStreamTest, stored_segment) {
+  DashSegmentSourceParams ds;
+  std::shared_ptr<OmafSegment> segment = std::make_shared<OmafSegment>(ds, 1, false);
+  segment->SetSegmentCacheFile(file_name);
+  segment->SetSegStored();
+
+  EXPECT_EQ(segment->GetStreamSize(), static_cast<int64_t>(FILE_SIZE));
+  EXPECT_TRUE(segment->SeekAbsoluteOffset(FILE_SIZE / 2));
+  std::vector<char> buf(FILE_SIZE);
+  EXPECT_EQ(segment->ReadStream(buf.data(), FILE_SIZE), static_cast<int64_t>(FILE_SIZE - FILE_SIZE / 2));
+  EXPECT_EQ(memcmp(buf.data(), content.data() + FILE_SIZE / 2, FILE_SIZE - FILE_SIZE / 2), 0);
+  EXPECT_EQ(segment->TellOffset(), static_cast<int64_t>(FILE_SIZE));
+}
+
+}  // namespace
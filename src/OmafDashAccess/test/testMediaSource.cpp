@@ -235,6 +235,40 @@ TEST_F(MediaSourceTest, OpenMedia_static_changeViewport) {
   delete dashSource;
 }
 
+TEST_F(MediaSourceTest, SwitchMedia_static) {
+  string command = "rm -rf " + cache + "/*";
+  system(command.c_str());
+
+  OmafMediaSource* dashSource = new OmafDashSource();
+  EXPECT_TRUE(dashSource != NULL);
+
+  int ret = dashSource->SetupHeadSetInfo(clientInfo);
+  EXPECT_TRUE(ret == ERROR_NONE);
+
+  ret = dashSource->OpenMedia(url_static, cache, false, false, "", "");
+  EXPECT_TRUE(ret == ERROR_NONE);
+  sleep(2);
+
+  // switch back and forth in the same session, the stream is readable after each one
+  for (int i = 0; i < 3; i++) {
+    ret = dashSource->SwitchMedia(url_static, cache, false, false, "", "");
+    EXPECT_TRUE(ret == ERROR_NONE);
+
+    DashMediaInfo info;
+    ret = dashSource->GetMediaInfo(&info);
+    EXPECT_TRUE(ret == ERROR_NONE);
+    EXPECT_TRUE(info.stream_count > 0);
+    sleep(2);
+  }
+
+  dashSource->CloseMedia();
+
+  int32_t cnt = GetFileCntUnderCache();
+  EXPECT_TRUE(cnt > 1);
+
+  delete dashSource;
+}
+
 TEST_F(MediaSourceTest, OpenMedia_live_changeViewport) {
   const string command = "rm -rf " + cache + "/*";
   system(command.c_str());
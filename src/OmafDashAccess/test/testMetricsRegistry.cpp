@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testMetricsRegistry.cpp
+ * Author: media
+ *
+ */
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../utils/MetricsRegistry.h"
+#include "../../utils/error.h"
+
+using namespace VCD::VRVideo;
+
+namespace {
+
+class MetricsRegistryTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    registry.Counter("bytes_total", "bytes")->Add(100);
+    registry.Gauge("queue_depth", "depth", "stream=\"0\"")->Set(3);
+    registry.Gauge("queue_depth", "depth", "stream=\"1\"")->Set(-1);
+    registry.Histogram("wait_microseconds", "wait")->Record(20);
+  }
+
+  virtual void TearDown() {}
+
+  MetricsRegistry registry;
+};
+
+TEST_F(MetricsRegistryTest, histogram_buckets) {
+  // small values are exact
+  for (uint64_t v = 0; v < METRIC_SUB_BUCKETS; v++) {
+    EXPECT_EQ(MetricHistogram::BucketIndex(v), v);
+    EXPECT_EQ(MetricHistogram::BucketUpper(MetricHistogram::BucketIndex(v)), v);
+  }
+
+  // every value falls into a bucket whose upper bound is within 1/8 above it
+  uint64_t values[] = {8, 9, 15, 16, 17, 100, 1000, 12345, 1000000, 0xFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull};
+  for (uint64_t v : values) {
+    uint32_t index = MetricHistogram::BucketIndex(v);
+    ASSERT_LT(index, static_cast<uint32_t>(METRIC_HISTOGRAM_BUCKETS));
+    uint64_t upper = MetricHistogram::BucketUpper(index);
+    EXPECT_GE(upper, v);
+    EXPECT_LE(upper - v, v / METRIC_SUB_BUCKETS);
+    if (index > 0) EXPECT_LT(MetricHistogram::BucketUpper(index - 1), v);
+  }
+}
+
+TEST_F(MetricsRegistryTest, histogram_percentile) {
+  MetricHistogram histogram;
+  EXPECT_EQ(histogram.Percentile(0.5), 0u);
+
+  for (uint64_t v = 1; v <= 1000; v++) histogram.Record(v);
+  EXPECT_EQ(histogram.Count(), 1000u);
+  EXPECT_EQ(histogram.Sum(), 500500u);
+  EXPECT_EQ(histogram.Max(), 1000u);
+
+  uint64_t p50 = histogram.Percentile(0.5);
+  uint64_t p99 = histogram.Percentile(0.99);
+  EXPECT_GE(p50, 500u);
+  EXPECT_LE(p50, 500u + 500u / METRIC_SUB_BUCKETS);
+  EXPECT_GE(p99, 990u);
+  EXPECT_LE(p99, 1000u);
+  EXPECT_EQ(histogram.Percentile(1.0), 1000u);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Count(), 0u);
+  EXPECT_EQ(histogram.Max(), 0u);
+}
+
+TEST_F(MetricsRegistryTest, concurrent_updates) {
+  MetricCounter *counter = registry.Counter("events_total", "events");
+  MetricHistogram *histogram = registry.Histogram("latency_microseconds", "latency");
+  ASSERT_TRUE(counter != nullptr);
+  ASSERT_TRUE(histogram != nullptr);
+
+  const int threads_num = 8;
+  const int loops = 100000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < threads_num; i++) {
+    threads.emplace_back([counter, histogram, i]() {
+      for (int j = 0; j < loops; j++) {
+        counter->Add();
+        histogram->Record(static_cast<uint64_t>(i * loops + j));
+      }
+    });
+  }
+  for (auto &t : threads) t.join();
+
+  EXPECT_EQ(counter->Value(), static_cast<uint64_t>(threads_num * loops));
+  EXPECT_EQ(histogram->Count(), static_cast<uint64_t>(threads_num * loops));
+  EXPECT_EQ(histogram->Max(), static_cast<uint64_t>(threads_num * loops - 1));
+}
+
+TEST_F(MetricsRegistryTest, snapshot) {
+  EXPECT_EQ(registry.Counter("bytes_total", "bytes"), registry.Counter("bytes_total", "bytes"));
+  // one name has one type
+  EXPECT_TRUE(registry.Gauge("bytes_total", "bytes") == nullptr);
+
+  int32_t count = 0;
+  EXPECT_EQ(registry.Snapshot(nullptr, &count), ERROR_NONE);
+  EXPECT_EQ(count, 4);
+
+  std::vector<MetricValue> values(count);
+  EXPECT_EQ(registry.Snapshot(values.data(), &count), ERROR_NONE);
+  ASSERT_EQ(count, 4);
+  EXPECT_STREQ(values[0].name, "bytes_total");
+  EXPECT_EQ(values[0].type, METRIC_COUNTER);
+  EXPECT_EQ(values[0].value, 100);
+  EXPECT_STREQ(values[1].name, "queue_depth{stream=\"0\"}");
+  EXPECT_EQ(values[1].value, 3);
+  EXPECT_EQ(values[2].value, -1);
+  EXPECT_EQ(values[3].type, METRIC_HISTOGRAM);
+  EXPECT_EQ(values[3].value, 1);
+  EXPECT_EQ(values[3].sum, 20u);
+  EXPECT_EQ(values[3].p50, 20u);
+
+  // the capacity limits the output
+  count = 2;
+  EXPECT_EQ(registry.Snapshot(values.data(), &count), ERROR_NONE);
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(registry.Snapshot(values.data(), nullptr), ERROR_NULL_PTR);
+}
+
+TEST_F(MetricsRegistryTest, prometheus_text) {
+  std::string text = registry.DumpPrometheus("test_");
+  EXPECT_NE(text.find("# HELP test_bytes_total bytes\n# TYPE test_bytes_total counter\ntest_bytes_total 100\n"),
+            std::string::npos);
+  // the family is described once for all labels
+  EXPECT_EQ(text.find("# TYPE test_queue_depth gauge"), text.rfind("# TYPE test_queue_depth gauge"));
+  EXPECT_NE(text.find("test_queue_depth{stream=\"0\"} 3\n"), std::string::npos);
+  EXPECT_NE(text.find("test_queue_depth{stream=\"1\"} -1\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_wait_microseconds summary\n"), std::string::npos);
+  EXPECT_NE(text.find("test_wait_microseconds{quantile=\"0.99\"} 20\n"), std::string::npos);
+  EXPECT_NE(text.find("test_wait_microseconds_sum 20\n"), std::string::npos);
+  EXPECT_NE(text.find("test_wait_microseconds_count 1\n"), std::string::npos);
+}
+
+}  // namespace
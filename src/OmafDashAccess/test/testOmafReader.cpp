@@ -443,6 +443,37 @@ TEST_F(OmafReaderTest, ParseInitialSegment) {
         LOG(INFO) << "The begin index=" << begin << ", end=" << end << std::endl;
       }
 
+      // the flat sample table of the segment agrees with the per sample lookup
+      std::vector<SampleDescriptor> sampleDescs;
+      ret = m_reader->getSegmentSampleDescriptors(trackIdx, segId, sampleDescs);
+      EXPECT_TRUE(ret == ERROR_NONE);
+      EXPECT_FALSE(sampleDescs.empty());
+      if (!sampleDescs.empty()) {
+        EXPECT_TRUE(sampleDescs.front().isSyncSample);
+      }
+      for (auto &desc : sampleDescs) {
+        uint64_t sampleOffset = 0;
+        uint32_t sampleLength = 0;
+        ret = m_reader->getTrackSampleOffset(trackIdx, desc.sampleId, sampleOffset, sampleLength);
+        EXPECT_TRUE(ret == ERROR_NONE);
+        EXPECT_EQ(desc.dataOffset, sampleOffset);
+        EXPECT_EQ(desc.dataLength, sampleLength);
+        EXPECT_EQ(desc.segmentId, static_cast<uint32_t>(segId));
+      }
+
+      // the pts of the cached packets counted from the segment samples is the
+      // one counted from the track information, the segment is the only one
+      // of the track in the reader
+      EXPECT_EQ(begin, 0u);
+      EXPECT_EQ(end, sampleDescs.size());
+      if (trackInf.get() != nullptr) {
+        for (size_t index = 0; index < sampleDescs.size(); index++) {
+          uint64_t pts = sampleDescs.size() * (segId - 1) + sampleDescs[index].sampleId - sampleDescs.front().sampleId;
+          uint64_t track_pts = trackInf->sampleProperties.size * (segId - 1) + begin + (begin + index);
+          EXPECT_EQ(pts, track_pts);
+        }
+      }
+
       uint32_t sampleIdx = begin;
       for (; sampleIdx < end; sampleIdx++) {
         uint32_t packetSize = ((7680 * 3840 * 3) / 2) / 2;
@@ -461,6 +492,21 @@ TEST_F(OmafReaderTest, ParseInitialSegment) {
         LOG(INFO) << "Extractor track sample data, ret=" << ret << std::endl;
         EXPECT_TRUE(ret == ERROR_NONE);
 
+        // the extractors of the real sample are all resolved, only the referenced
+        // slices are left, each after a start code
+        if (ret == ERROR_NONE) {
+          const uint8_t *data = reinterpret_cast<const uint8_t *>(packet->Payload());
+          uint32_t nals = 0;
+          for (uint32_t pos = 0; pos + 4 < packetSize; pos++) {
+            if (data[pos] == 0 && data[pos + 1] == 0 && data[pos + 2] == 0 && data[pos + 3] == 1) {
+              EXPECT_NE((data[pos + 4] >> 1) & 0x3f, 49);
+              nals++;
+              pos += 3;
+            }
+          }
+          EXPECT_GT(nals, 0u);
+        }
+
         if (sampleIdx == 0) {
           std::vector<VCD::OMAF::DecoderSpecificInfo> parameterSets;
           ret = m_reader->getDecoderConfiguration(trackIdx, sampleIdx, parameterSets);
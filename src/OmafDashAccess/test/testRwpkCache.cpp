@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testRwpkCache.cpp
+ * Author: media
+ *
+ */
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <memory>
+
+#include "../../utils/RwpkCache.h"
+
+using namespace VCD::VRVideo;
+
+namespace {
+
+class RwpkCacheTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    memset(&rwpk, 0, sizeof(RegionWisePacking));
+    rwpk.projPicWidth = 3840;
+    rwpk.projPicHeight = 1920;
+    rwpk.packedPicWidth = 2560;
+    rwpk.packedPicHeight = 1280;
+    rwpk.numRegions = 4;
+    rwpk.rectRegionPacking = regions;
+    memset(regions, 0, sizeof(regions));
+    for (uint8_t i = 0; i < rwpk.numRegions; i++) {
+      regions[i].projRegWidth = 960;
+      regions[i].projRegHeight = 960;
+      regions[i].projRegLeft = 960 * (i % 2);
+      regions[i].projRegTop = 960 * (i / 2);
+      regions[i].packedRegWidth = 640;
+      regions[i].packedRegHeight = 640;
+      regions[i].packedRegLeft = 640 * (i % 2);
+      regions[i].packedRegTop = 640 * (i / 2);
+    }
+    memset(sei, 0, sizeof(sei));
+    sei[0] = 0x4e;
+    sei[1] = 0x01;
+  }
+
+  virtual void TearDown() {}
+
+  RegionWisePacking rwpk;
+  RectangularRegionWisePacking regions[4];
+  uint8_t sei[16];
+};
+
+TEST_F(RwpkCacheTest, share_same_packing) {
+  RwpkCache cache;
+  SharedRwpk::Ptr first = cache.Share(rwpk);
+  ASSERT_TRUE(first != nullptr);
+  EXPECT_NE(first->Version(), 0u);
+  // deep copied, the caller keeps its own regions
+  EXPECT_NE(first->Get()->rectRegionPacking, regions);
+  EXPECT_TRUE(SharedRwpk::Equal(*first->Get(), rwpk));
+
+  // the time stamp is not part of the packing
+  rwpk.timeStamp = 40;
+  SharedRwpk::Ptr second = cache.Share(rwpk);
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(first->Version(), second->Version());
+
+  regions[3].packedRegLeft = 0;
+  SharedRwpk::Ptr changed = cache.Share(rwpk);
+  EXPECT_NE(first.get(), changed.get());
+  EXPECT_NE(first->Version(), changed->Version());
+  EXPECT_EQ(changed->Get()->rectRegionPacking[3].packedRegLeft, 0);
+}
+
+TEST_F(RwpkCacheTest, clone) {
+  RwpkCache cache;
+  SharedRwpk::Ptr shared = cache.Share(rwpk);
+  ASSERT_TRUE(shared != nullptr);
+
+  RegionWisePacking *copied = shared->Clone();
+  ASSERT_TRUE(copied != nullptr);
+  EXPECT_TRUE(SharedRwpk::Equal(*copied, rwpk));
+  EXPECT_NE(copied->rectRegionPacking, shared->Get()->rectRegionPacking);
+  delete[] copied->rectRegionPacking;
+  delete copied;
+}
+
+TEST_F(RwpkCacheTest, parse_sei_shared) {
+  RwpkCache cache;
+  int32_t parsed = 0;
+  RegionWisePacking &source = rwpk;
+  auto parser = [&parsed, &source](RegionWisePacking *out) {
+    parsed++;
+    RectangularRegionWisePacking *buffer = out->rectRegionPacking;
+    *out = source;
+    out->rectRegionPacking = buffer;
+    memcpy(out->rectRegionPacking, source.rectRegionPacking, source.numRegions * sizeof(RectangularRegionWisePacking));
+    return 0;
+  };
+
+  SharedRwpk::Ptr first = cache.ParseSEI(sei, sizeof(sei), parser);
+  SharedRwpk::Ptr second = cache.ParseSEI(sei, sizeof(sei), parser);
+  ASSERT_TRUE(first != nullptr);
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(parsed, 2);
+  EXPECT_EQ(cache.Hits(), 1u);
+  EXPECT_EQ(cache.Misses(), 1u);
+
+  // another time stamp in the SEI, still the same packing
+  sei[15] = 0x28;
+  rwpk.timeStamp = 40;
+  SharedRwpk::Ptr third = cache.ParseSEI(sei, sizeof(sei), parser);
+  EXPECT_EQ(parsed, 3);
+  EXPECT_EQ(first.get(), third.get());
+  EXPECT_EQ(cache.Hits(), 2u);
+  EXPECT_EQ(cache.Misses(), 1u);
+
+  auto failed = [](RegionWisePacking *out) { return -1; };
+  sei[15] = 0x50;
+  EXPECT_TRUE(cache.ParseSEI(sei, sizeof(sei), failed) == nullptr);
+}
+
+TEST_F(RwpkCacheTest, handle_reference) {
+  RwpkCache cache;
+  SharedRwpk::Ptr shared = cache.Share(rwpk);
+  ASSERT_TRUE(shared != nullptr);
+  long count = shared.use_count();
+
+  void *handle = SharedRwpk::ToHandle(shared);
+  EXPECT_EQ(shared.use_count(), count + 1);
+  SharedRwpk::Ptr back = SharedRwpk::FromHandle(handle);
+  EXPECT_EQ(back.get(), shared.get());
+  back.reset();
+
+  SharedRwpk::ReleaseHandle(handle);
+  EXPECT_EQ(shared.use_count(), count);
+  // released handles are null
+  EXPECT_TRUE(SharedRwpk::FromHandle(nullptr) == nullptr);
+  SharedRwpk::ReleaseHandle(nullptr);
+}
+
+}  // namespace
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testSegmentCache.cpp
+ * Author: media
+ *
+ */
+
+
+#include "gtest/gtest.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../OmafDashDownload/OmafDownloader.h"
+#include "../OmafDashDownload/OmafInitSegmentCache.h"
+#include "../OmafDashDownload/OmafSegmentCache.h"
+#include "testHttpServer.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+const size_t SEGMENT_SIZE = 64 * 1024;
+
+class SegmentCacheTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    params.enable_ = true;
+    params.memory_budget_ = 4 * 1024;
+  }
+
+  virtual void TearDown() {}
+
+  OmafSegmentCache::Buffer segment(size_t size, char c) {
+    std::unique_ptr<StreamBlock> sb = make_unique_vcd<StreamBlock>();
+    sb->resize(size);
+    memset(sb->buf(), c, size);
+    sb->size(size);
+    std::shared_ptr<SharedStreamBlocks> data = std::make_shared<SharedStreamBlocks>();
+    data->push_back(std::move(sb));
+    return data;
+  }
+
+  static std::vector<char> bytes(const OmafSegmentCache::Buffer &data) {
+    std::vector<char> out;
+    for (auto &block : data->blocks()) {
+      out.insert(out.end(), block->cbuf(), block->cbuf() + block->size());
+    }
+    return out;
+  }
+
+  OmafDashCacheParams params;
+};
+
+TEST_F(SegmentCacheTest, key) {
+  EXPECT_EQ(OmafSegmentCache::key("http://host/seg1.mp4"), "http://host/seg1.mp4");
+  EXPECT_NE(OmafSegmentCache::key("http://host/seg1.mp4", 0, 100), OmafSegmentCache::key("http://host/seg1.mp4", 100, 100));
+}
+
+TEST_F(SegmentCacheTest, lru_eviction) {
+  OmafSegmentCache cache(params);
+
+  EXPECT_TRUE(cache.put("a", segment(1024, 'a')) == ERROR_NONE);
+  EXPECT_TRUE(cache.put("b", segment(1024, 'b')) == ERROR_NONE);
+  EXPECT_TRUE(cache.put("c", segment(1024, 'c')) == ERROR_NONE);
+  EXPECT_TRUE(cache.put("d", segment(1024, 'd')) == ERROR_NONE);
+
+  // a becomes the most recently used one, so b is the first to go
+  OmafSegmentCache::Buffer a = cache.get("a");
+  ASSERT_TRUE(a != nullptr);
+  EXPECT_EQ(bytes(a)[0], 'a');
+
+  EXPECT_TRUE(cache.put("e", segment(1024, 'e')) == ERROR_NONE);
+  EXPECT_TRUE(cache.get("b") == nullptr);
+  EXPECT_TRUE(cache.get("a") != nullptr);
+  EXPECT_TRUE(cache.get("c") != nullptr);
+  EXPECT_TRUE(cache.get("e") != nullptr);
+
+  OmafSegmentCache::CacheStatistics stats = cache.statistics();
+  EXPECT_EQ(stats.evictions_, 1u);
+  EXPECT_EQ(stats.misses_, 1u);
+  EXPECT_EQ(stats.memory_hits_, 4u);
+  EXPECT_EQ(stats.entries_, 4u);
+}
+
+TEST_F(SegmentCacheTest, byte_budget) {
+  OmafSegmentCache cache(params);
+
+  EXPECT_TRUE(cache.put("a", segment(1000, 'a')) == ERROR_NONE);
+  EXPECT_TRUE(cache.put("b", segment(3000, 'b')) == ERROR_NONE);
+  EXPECT_EQ(cache.statistics().memory_bytes_, 4000);
+
+  // replacing one only accounts the new size
+  EXPECT_TRUE(cache.put("a", segment(500, 'a')) == ERROR_NONE);
+  EXPECT_EQ(cache.statistics().memory_bytes_, 3500);
+
+  // large one evicts as many as needed
+  EXPECT_TRUE(cache.put("c", segment(4000, 'c')) == ERROR_NONE);
+  EXPECT_EQ(cache.statistics().memory_bytes_, 4000);
+  EXPECT_FALSE(cache.contains("a"));
+  EXPECT_FALSE(cache.contains("b"));
+
+  // larger than the budget, never cached
+  EXPECT_TRUE(cache.put("d", segment(5000, 'd')) != ERROR_NONE);
+  EXPECT_TRUE(cache.contains("c"));
+
+  cache.clear();
+  EXPECT_EQ(cache.statistics().memory_bytes_, 0);
+  EXPECT_FALSE(cache.contains("c"));
+}
+
+TEST_F(SegmentCacheTest, spill_roundtrip) {
+  std::string spill_file = "./segment_cache_test.spill";
+  params.enable_spill_ = true;
+  params.spill_file_ = spill_file;
+  params.spill_budget_ = 3 * 1024;
+
+  {
+    OmafSegmentCache cache(params);
+    for (int i = 0; i < 6; i++) {
+      EXPECT_TRUE(cache.put(std::to_string(i), segment(1024, '0' + i)) == ERROR_NONE);
+    }
+    // 0 and 1 are evicted to the spill file
+    OmafSegmentCache::CacheStatistics stats = cache.statistics();
+    EXPECT_EQ(stats.entries_, 4u);
+    EXPECT_EQ(stats.spill_bytes_, 2048);
+
+    // read back, and 0 is in memory again
+    OmafSegmentCache::Buffer data = cache.get("0");
+    ASSERT_TRUE(data != nullptr);
+    EXPECT_EQ(data->size(), 1024);
+    EXPECT_EQ(bytes(data), std::vector<char>(1024, '0'));
+    EXPECT_EQ(cache.statistics().spill_hits_, 1u);
+    EXPECT_TRUE(cache.get("0") != nullptr);
+    EXPECT_EQ(cache.statistics().memory_hits_, 1u);
+
+    // the spill file restarts when it is full
+    for (int i = 6; i < 10; i++) {
+      EXPECT_TRUE(cache.put(std::to_string(i), segment(1024, '0' + i)) == ERROR_NONE);
+    }
+    EXPECT_LE(cache.statistics().spill_bytes_, params.spill_budget_);
+    EXPECT_TRUE(cache.get("1") == nullptr);
+
+    struct stat st;
+    EXPECT_EQ(stat(spill_file.c_str(), &st), 0);
+  }
+
+  // removed with the cache
+  struct stat st;
+  EXPECT_NE(stat(spill_file.c_str(), &st), 0);
+}
+
+TEST_F(SegmentCacheTest, client_cache_hit) {
+  TestHttpServer server;
+  server.body(SEGMENT_SIZE, 's');
+  ASSERT_TRUE(server.start());
+
+  params.memory_budget_ = 16 * SEGMENT_SIZE;
+  OmafSegmentCache::Ptr cache = std::make_shared<OmafSegmentCache>(params);
+  OmafDashSegmentHttpClient::Ptr dash_client = OmafDashSegmentHttpClient::create(10);
+  ASSERT_TRUE(dash_client != nullptr);
+  dash_client->setSegmentCache(cache);
+  EXPECT_TRUE(dash_client->start() == ERROR_NONE);
+
+  // play 4 segments, then seek back and play them again
+  const int segments = 4;
+  std::vector<std::vector<const char *>> delivered(segments);
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < segments; i++) {
+      DashSegmentSourceParams ds;
+      ds.dash_url_ = server.url(i);
+      ds.timeline_point_ = round * segments + i;
+
+      std::atomic_bool isState{false};
+      std::atomic_size_t received{0};
+      std::vector<const char *> &blocks = delivered[i];
+      dash_client->open(
+          ds,
+          [&received, &blocks, round](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {
+            EXPECT_TRUE(sb != nullptr);
+            received += sb->size();
+            // the hit delivers the blocks received at first, not copies of them
+            if (round == 0) {
+              blocks.push_back(sb->cbuf());
+            } else {
+              EXPECT_TRUE(std::find(blocks.begin(), blocks.end(), sb->cbuf()) != blocks.end());
+            }
+          },
+          [&isState](OmafDashSegmentClient::State state) {
+            EXPECT_TRUE(state == OmafDashSegmentClient::State::SUCCESS);
+            isState = true;
+          });
+      while (!isState) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      EXPECT_EQ(received.load(), SEGMENT_SIZE);
+    }
+  }
+
+  EXPECT_EQ(server.requests(), static_cast<size_t>(segments));
+  OmafSegmentCache::CacheStatistics stats = cache->statistics();
+  LOG(INFO) << stats.to_string() << std::endl;
+  EXPECT_EQ(stats.memory_hits_, static_cast<size_t>(segments));
+  EXPECT_EQ(stats.misses_, static_cast<size_t>(segments));
+
+  EXPECT_TRUE(dash_client->stop() == ERROR_NONE);
+  server.stop();
+}
+
+TEST_F(SegmentCacheTest, init_cache) {
+  char dir[] = "./init_cache_test_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir) != nullptr);
+  OmafInitSegmentCache cache(dir);
+
+  std::string etag;
+  OmafSegmentCache::Buffer data;
+  EXPECT_FALSE(cache.get("http://host/track1.init.mp4", etag, data));
+
+  // the response without etag can't be revalidated
+  OmafSegmentCache::Buffer init = segment(1000, 'i');
+  EXPECT_TRUE(cache.put("http://host/track1.init.mp4", "", *init) != ERROR_NONE);
+  EXPECT_TRUE(cache.put("http://host/track1.init.mp4", "\"v1\"", *init) == ERROR_NONE);
+
+  // kept in the folder, another session reads it back
+  {
+    OmafInitSegmentCache other(dir);
+    ASSERT_TRUE(other.get("http://host/track1.init.mp4", etag, data));
+    EXPECT_EQ(etag, "\"v1\"");
+    ASSERT_TRUE(data != nullptr);
+    EXPECT_EQ(bytes(data), bytes(init));
+    EXPECT_FALSE(other.get("http://host/track2.init.mp4", etag, data));
+  }
+
+  cache.remove("http://host/track1.init.mp4");
+  EXPECT_FALSE(cache.get("http://host/track1.init.mp4", etag, data));
+  EXPECT_EQ(rmdir(dir), 0);
+}
+
+TEST_F(SegmentCacheTest, client_init_revalidate) {
+  TestHttpServer server;
+  server.body(SEGMENT_SIZE, 's');
+  ASSERT_TRUE(server.start());
+  server.etag("\"v1\"");
+
+  char dir[] = "./init_cache_test_XXXXXX";
+  ASSERT_TRUE(mkdtemp(dir) != nullptr);
+  OmafInitSegmentCache::Ptr cache = std::make_shared<OmafInitSegmentCache>(dir);
+
+  const int tracks = 4;
+  auto join = [&](int64_t timeline_point) {
+    OmafDashSegmentHttpClient::Ptr dash_client = OmafDashSegmentHttpClient::create(10);
+    ASSERT_TRUE(dash_client != nullptr);
+    dash_client->setInitSegmentCache(cache);
+    EXPECT_TRUE(dash_client->start() == ERROR_NONE);
+
+    std::atomic_int done{0};
+    std::atomic_size_t received[tracks];
+    for (int i = 0; i < tracks; i++) {
+      received[i] = 0;
+      DashSegmentSourceParams ds;
+      ds.dash_url_ = server.url(i);
+      ds.timeline_point_ = timeline_point;
+      ds.init_segment_ = true;
+      std::atomic_size_t *bytes = &received[i];
+      dash_client->open(
+          ds,
+          [bytes](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {
+            EXPECT_TRUE(sb != nullptr);
+            EXPECT_EQ(sb->cbuf()[0], 's');
+            *bytes += sb->size();
+          },
+          [&done](OmafDashSegmentClient::State state) {
+            EXPECT_TRUE(state == OmafDashSegmentClient::State::SUCCESS);
+            done++;
+          });
+    }
+    while (done < tracks) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (int i = 0; i < tracks; i++) {
+      EXPECT_EQ(received[i].load(), SEGMENT_SIZE);
+    }
+    EXPECT_TRUE(dash_client->stop() == ERROR_NONE);
+  };
+
+  // first join fetches all, the rejoin is answered by 304 and served from the folder
+  join(0);
+  EXPECT_EQ(server.notModified(), 0u);
+  join(0);
+  EXPECT_EQ(server.notModified(), static_cast<size_t>(tracks));
+
+  // the content changes, the new one replaces the local copy
+  server.etag("\"v2\"");
+  join(0);
+  EXPECT_EQ(server.notModified(), static_cast<size_t>(tracks));
+  std::string etag;
+  OmafSegmentCache::Buffer data;
+  ASSERT_TRUE(cache->get(server.url(0), etag, data));
+  EXPECT_EQ(etag, "\"v2\"");
+  EXPECT_EQ(server.requests(), static_cast<size_t>(3 * tracks));
+
+  for (int i = 0; i < tracks; i++) {
+    cache->remove(server.url(i));
+  }
+  EXPECT_EQ(rmdir(dir), 0);
+  server.stop();
+}
+
+}  // namespace
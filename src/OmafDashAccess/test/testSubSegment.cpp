@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+
+/*
+ * File:   testSubSegment.cpp
+ * Author: media
+ *
+ */
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../OmafDashDownload/OmafDownloader.h"
+#include "../OmafMP4VRReader.h"
+#include "../OmafSegment.h"
+#include "testHttpServer.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+const uint32_t SUBSEGMENT_COUNT = 4;
+const uint32_t SUBSEGMENT_SIZE = 1000;
+const uint32_t SUBSEGMENT_DURATION = 500;  // timescale is 1000
+const int64_t INDEX_PROBE_SIZE = 4096;
+
+void put32(std::vector<char> &buf, uint32_t v) {
+  for (int i = 3; i >= 0; i--) buf.push_back(static_cast<char>((v >> (i * 8)) & 0xff));
+}
+
+void put64(std::vector<char> &buf, uint64_t v) {
+  put32(buf, static_cast<uint32_t>(v >> 32));
+  put32(buf, static_cast<uint32_t>(v & 0xffffffff));
+}
+
+void putType(std::vector<char> &buf, const char *type) { buf.insert(buf.end(), type, type + 4); }
+
+// styp + sidx + subsegments, the payload of subsegment i is filled with 'a' + i
+std::vector<char> makeSegment(size_t &head_size) {
+  std::vector<char> seg;
+  put32(seg, 20);
+  putType(seg, "styp");
+  putType(seg, "msdh");
+  put32(seg, 0);
+  putType(seg, "msdh");
+
+  put32(seg, 40 + 12 * SUBSEGMENT_COUNT);
+  putType(seg, "sidx");
+  put32(seg, 0x01000000);  // version 1
+  put32(seg, 1);           // reference id
+  put32(seg, 1000);        // timescale
+  put64(seg, 90000);       // earliest presentation time
+  put64(seg, 0);           // first offset
+  put32(seg, SUBSEGMENT_COUNT);
+  for (uint32_t i = 0; i < SUBSEGMENT_COUNT; i++) {
+    put32(seg, SUBSEGMENT_SIZE);
+    put32(seg, SUBSEGMENT_DURATION);
+    put32(seg, 0x90000000);  // starts with SAP, type 1
+  }
+  head_size = seg.size();
+
+  for (uint32_t i = 0; i < SUBSEGMENT_COUNT; i++) {
+    seg.insert(seg.end(), SUBSEGMENT_SIZE, static_cast<char>('a' + i));
+  }
+  return seg;
+}
+
+class SubSegmentTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    segment = makeSegment(head_size);
+    dash_client = OmafDashSegmentHttpClient::create(10);
+    ASSERT_TRUE(dash_client != nullptr);
+    EXPECT_TRUE(dash_client->start() == ERROR_NONE);
+  }
+
+  virtual void TearDown() { EXPECT_TRUE(dash_client->stop() == ERROR_NONE); }
+
+  // open the segment and wait for the download done
+  OmafSegment::State openSegment(OmafSegment::Ptr seg, std::shared_ptr<OmafReader> reader) {
+    std::atomic_bool isState{false};
+    seg->RegisterStateChange([&isState](OmafSegment::Ptr, OmafSegment::State) { isState = true; });
+    EXPECT_TRUE(seg->Open(dash_client, reader) == ERROR_NONE);
+    for (int i = 0; i < 5000 && !isState; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(isState);
+    return seg->GetState();
+  }
+
+  std::vector<char> readAll(OmafSegment::Ptr seg) {
+    std::vector<char> data(seg->GetStreamSize());
+    seg->SeekAbsoluteOffset(0);
+    EXPECT_EQ(seg->ReadStream(data.data(), data.size()), static_cast<int64_t>(data.size()));
+    return data;
+  }
+
+  std::vector<char> segment;
+  size_t head_size = 0;
+  OmafDashSegmentHttpClient::Ptr dash_client;
+};
+
+TEST_F(SubSegmentTest, range_request) {
+  TestHttpServer server;
+  server.body(segment);
+  ASSERT_TRUE(server.start());
+
+  // [offset, offset + size), and the head of the resource
+  std::vector<std::pair<int64_t, int64_t>> ranges = {{100, 50}, {0, 10}};
+  for (size_t i = 0; i < ranges.size(); i++) {
+    DashSegmentSourceParams ds;
+    ds.dash_url_ = server.url(1);
+    ds.timeline_point_ = i;
+    ds.range_offset_ = ranges[i].first;
+    ds.range_size_ = ranges[i].second;
+
+    std::atomic_bool isState{false};
+    std::vector<char> received;
+    dash_client->open(
+        ds,
+        [&received](std::unique_ptr<VCD::OMAF::StreamBlock> sb) {
+          received.insert(received.end(), sb->cbuf(), sb->cbuf() + sb->size());
+        },
+        [&isState](OmafDashSegmentClient::State state) {
+          EXPECT_TRUE(state == OmafDashSegmentClient::State::SUCCESS);
+          isState = true;
+        });
+    while (!isState) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(received.size(), static_cast<size_t>(ranges[i].second));
+    EXPECT_TRUE(std::equal(received.begin(), received.end(), segment.begin() + ranges[i].first));
+  }
+
+  std::vector<std::string> served = server.ranges();
+  ASSERT_EQ(served.size(), 2u);
+  EXPECT_EQ(served[0], "100-149");
+  EXPECT_EQ(served[1], "0-9");
+  server.stop();
+}
+
+TEST_F(SubSegmentTest, segment_index) {
+  std::shared_ptr<StreamBlocks> head = std::make_shared<StreamBlocks>();
+  head->push_back(std::unique_ptr<StreamBlock>(new StreamBlock(segment.data(), head_size)));
+
+  OmafMP4VRReader reader;
+  std::vector<SegmentInformation> seg_index;
+  ASSERT_EQ(reader.parseSegmentIndex(head.get(), seg_index), ERROR_NONE);
+  ASSERT_EQ(seg_index.size(), static_cast<size_t>(SUBSEGMENT_COUNT));
+  for (uint32_t i = 0; i < SUBSEGMENT_COUNT; i++) {
+    EXPECT_EQ(seg_index[i].timescale, 1000u);
+    EXPECT_EQ(seg_index[i].earliestPTSinTS, 90000u + i * SUBSEGMENT_DURATION);
+    EXPECT_EQ(seg_index[i].startDataOffset, head_size + i * SUBSEGMENT_SIZE);
+    EXPECT_EQ(seg_index[i].dataSize, SUBSEGMENT_SIZE);
+    EXPECT_TRUE(seg_index[i].startsWithSAP);
+  }
+}
+
+TEST_F(SubSegmentTest, open_from_subsegment) {
+  TestHttpServer server;
+  server.body(segment);
+  ASSERT_TRUE(server.start());
+  std::shared_ptr<OmafReader> reader = std::make_shared<OmafMP4VRReader>();
+
+  DashSegmentSourceParams ds;
+  ds.dash_url_ = server.url(1);
+  ds.timeline_point_ = 1;
+  OmafSegment::Ptr seg = std::make_shared<OmafSegment>(ds, 1, false);
+  // the viewport changes at 1.2s of the segment, the subsegment at 1.5s is the next one
+  seg->SetSubSegmentStart(1200, INDEX_PROBE_SIZE);
+  EXPECT_TRUE(openSegment(seg, reader) == OmafSegment::State::OPEN_SUCCES);
+
+  std::vector<char> data = readAll(seg);
+  ASSERT_EQ(data.size(), head_size + SUBSEGMENT_SIZE);
+  EXPECT_TRUE(std::equal(data.begin(), data.begin() + head_size, segment.begin()));
+  EXPECT_EQ(data[head_size], 'd');
+  EXPECT_EQ(data.back(), 'd');
+
+  std::vector<std::string> served = server.ranges();
+  ASSERT_EQ(served.size(), 2u);
+  EXPECT_EQ(served[0], "0-" + std::to_string(INDEX_PROBE_SIZE - 1));
+  EXPECT_EQ(served[1], std::to_string(head_size + 3 * SUBSEGMENT_SIZE) + "-" + std::to_string(segment.size() - 1));
+
+  // nothing left after the last subsegment
+  ds.timeline_point_ = 2;
+  OmafSegment::Ptr late_seg = std::make_shared<OmafSegment>(ds, 2, false);
+  late_seg->SetSubSegmentStart(1800, INDEX_PROBE_SIZE);
+  EXPECT_TRUE(openSegment(late_seg, reader) == OmafSegment::State::OPEN_STOPPED);
+  server.stop();
+}
+
+TEST_F(SubSegmentTest, range_not_supported) {
+  TestHttpServer server;
+  server.body(segment);
+  server.rangeSupport(false);
+  ASSERT_TRUE(server.start());
+  std::shared_ptr<OmafReader> reader = std::make_shared<OmafMP4VRReader>();
+
+  DashSegmentSourceParams ds;
+  ds.dash_url_ = server.url(1);
+  ds.timeline_point_ = 1;
+  OmafSegment::Ptr seg = std::make_shared<OmafSegment>(ds, 1, false);
+  seg->SetSubSegmentStart(1200, INDEX_PROBE_SIZE);
+  EXPECT_TRUE(openSegment(seg, reader) == OmafSegment::State::OPEN_SUCCES);
+
+  // the whole segment comes in the head request
+  std::vector<char> data = readAll(seg);
+  EXPECT_TRUE(data == segment);
+  EXPECT_EQ(server.ranges().size(), 1u);
+  server.stop();
+}
+
+}  // namespace
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testTileTracksSelector.cpp
+ * Author: media
+ *
+ */
+
+#include "gtest/gtest.h"
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "../OmafTileTracksSelector.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+class TileTracksSelectorTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    predicted.angle.yaw = 0;
+    predicted.angle.pitch = 0;
+    predicted.angle.roll = 0;
+    predicted.yawStdDev = 0;
+    predicted.pitchStdDev = 0;
+    predicted.confidence = 1.0f;
+  }
+
+  virtual void TearDown() {}
+
+  static double totalWeight(const std::vector<std::pair<HeadPose, double>> &samples) {
+    double total = 0.0;
+    for (auto &sample : samples) total += sample.second;
+    return total;
+  }
+
+  PredictedViewport predicted;
+};
+
+TEST_F(TileTracksSelectorTest, CenterOnlyUnderMinSpread) {
+  predicted.angle.yaw = 30;
+  predicted.angle.pitch = -10;
+  predicted.yawStdDev = MIN_PREFETCH_SPREAD / 2;
+  predicted.pitchStdDev = MIN_PREFETCH_SPREAD / 2;
+
+  std::vector<std::pair<HeadPose, double>> samples = OmafTileTracksSelector::SamplePoseDistribution(predicted);
+  ASSERT_EQ(samples.size(), 1u);
+  EXPECT_FLOAT_EQ(samples[0].first.yaw, 30);
+  EXPECT_FLOAT_EQ(samples[0].first.pitch, -10);
+  EXPECT_DOUBLE_EQ(samples[0].second, 1.0);
+}
+
+TEST_F(TileTracksSelectorTest, RingsWeightedByDensity) {
+  predicted.yawStdDev = 10;
+  predicted.pitchStdDev = 5;
+
+  std::vector<std::pair<HeadPose, double>> samples = OmafTileTracksSelector::SamplePoseDistribution(predicted);
+  ASSERT_EQ(samples.size(), 17u);
+  EXPECT_NEAR(totalWeight(samples), 1.0, 1e-9);
+
+  // the center outweighs the first ring, which outweighs the second
+  EXPECT_GT(samples[0].second, samples[1].second);
+  EXPECT_GT(samples[1].second, samples[9].second);
+  EXPECT_NEAR(samples[1].second / samples[0].second, exp(-0.5), 1e-9);
+
+  // the first sample of each ring is along the yaw, the third along the pitch
+  EXPECT_FLOAT_EQ(samples[1].first.yaw, 10);
+  EXPECT_NEAR(samples[3].first.pitch, 5, 1e-4);
+  EXPECT_FLOAT_EQ(samples[9].first.yaw, 20);
+  EXPECT_NEAR(samples[11].first.pitch, 10, 1e-4);
+}
+
+TEST_F(TileTracksSelectorTest, SpreadLimitedAndWrapped) {
+  predicted.angle.yaw = 170;
+  predicted.angle.pitch = 80;
+  predicted.yawStdDev = 2 * MAX_PREFETCH_SPREAD;
+  predicted.pitchStdDev = 2 * MAX_PREFETCH_SPREAD;
+
+  std::vector<std::pair<HeadPose, double>> samples = OmafTileTracksSelector::SamplePoseDistribution(predicted);
+  ASSERT_EQ(samples.size(), 17u);
+  for (auto &sample : samples) {
+    EXPECT_GE(sample.first.yaw, -180.0f);
+    EXPECT_LT(sample.first.yaw, 180.0f);
+    EXPECT_GE(sample.first.pitch, -90.0f);
+    EXPECT_LE(sample.first.pitch, 90.0f);
+  }
+  // the yaw is wrapped across 180 with the spread limited to the max
+  EXPECT_FLOAT_EQ(samples[1].first.yaw, 170 + MAX_PREFETCH_SPREAD - 360);
+  EXPECT_FLOAT_EQ(samples[3].first.pitch, 90);
+}
+
+}  // namespace
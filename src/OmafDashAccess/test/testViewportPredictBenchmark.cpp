@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testViewportPredictBenchmark.cpp
+ * Author: media
+ *
+ */
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <list>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../OmafViewportPredict/ViewportPredictPlugin.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+// head trace sample, the angle is in degree and the pts in ms
+struct TraceSample {
+  uint64_t pts;
+  float yaw;
+  float pitch;
+};
+
+struct HeadTrace {
+  std::string name;
+  bool synthetic = false;
+  std::vector<TraceSample> truth;     // the real head motion
+  std::vector<TraceSample> captured;  // the poses reported by the sensor
+};
+
+struct PredictError {
+  std::vector<double> errors;
+  std::vector<double> confidences;
+  uint64_t total_us = 0;
+
+  double mean() const {
+    double sum = 0.0;
+    for (auto e : errors) sum += e;
+    return errors.empty() ? 0.0 : sum / errors.size();
+  }
+  double percentile(double p) const {
+    if (errors.empty()) return 0.0;
+    std::vector<double> sorted(errors);
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+  }
+};
+
+float wrapAngle(float angle) {
+  while (angle >= 180.0f) angle -= 360.0f;
+  while (angle < -180.0f) angle += 360.0f;
+  return angle;
+}
+
+// great circle distance between two poses, in degree
+double sphereDistance(float yaw1, float pitch1, float yaw2, float pitch2) {
+  double y1 = yaw1 * M_PI / 180, p1 = pitch1 * M_PI / 180;
+  double y2 = yaw2 * M_PI / 180, p2 = pitch2 * M_PI / 180;
+  double c = sin(p1) * sin(p2) + cos(p1) * cos(p2) * cos(y1 - y2);
+  return acos(std::max(-1.0, std::min(1.0, c))) * 180 / M_PI;
+}
+
+// the real pose at the time, linear between the samples of the trace
+TraceSample poseAt(const std::vector<TraceSample> &truth, uint64_t pts) {
+  auto it = std::lower_bound(truth.begin(), truth.end(), pts,
+                             [](const TraceSample &s, uint64_t t) { return s.pts < t; });
+  if (it == truth.begin()) return truth.front();
+  if (it == truth.end()) return truth.back();
+  const TraceSample &b = *it;
+  const TraceSample &a = *(it - 1);
+  float r = b.pts == a.pts ? 0.0f : static_cast<float>(pts - a.pts) / (b.pts - a.pts);
+  TraceSample s;
+  s.pts = pts;
+  s.yaw = wrapAngle(a.yaw + r * wrapAngle(b.yaw - a.yaw));
+  s.pitch = a.pitch + r * (b.pitch - a.pitch);
+  return s;
+}
+
+// head motion made of fixations and minimum jerk turns, as seen in recorded
+// traces, sampled at 1ms. the sensor reports the poses every interval with noise
+HeadTrace synthesizeTrace(std::string name, uint32_t seed, uint64_t duration_ms, uint32_t min_interval,
+                          uint32_t max_interval, double drop_rate) {
+  HeadTrace trace;
+  trace.name = name;
+  trace.synthetic = true;
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::normal_distribution<double> noise(0.0, 0.3);
+
+  double yaw = 0.0, pitch = 0.0;
+  uint64_t pts = 0;
+  while (pts < duration_ms) {
+    // fixation with slow drift
+    uint64_t fixation = 300 + static_cast<uint64_t>(uniform(rng) * 1500);
+    double drift = (uniform(rng) - 0.5) * 10.0;
+    for (uint64_t t = 0; t < fixation && pts < duration_ms; t++, pts++) {
+      yaw += drift / 1000.0;
+      trace.truth.push_back({pts, wrapAngle(static_cast<float>(yaw)), static_cast<float>(pitch)});
+    }
+    // turn
+    double dyaw = (uniform(rng) < 0.5 ? -1.0 : 1.0) * (20.0 + uniform(rng) * 100.0);
+    double target_pitch = std::max(-60.0, std::min(60.0, pitch + (uniform(rng) - 0.5) * 50.0));
+    double dpitch = target_pitch - pitch;
+    uint64_t turn = 300 + static_cast<uint64_t>(uniform(rng) * 700);
+    double yaw0 = yaw, pitch0 = pitch;
+    for (uint64_t t = 0; t < turn && pts < duration_ms; t++, pts++) {
+      double s = static_cast<double>(t) / turn;
+      double shape = 10 * pow(s, 3) - 15 * pow(s, 4) + 6 * pow(s, 5);
+      yaw = yaw0 + dyaw * shape;
+      pitch = pitch0 + dpitch * shape;
+      trace.truth.push_back({pts, wrapAngle(static_cast<float>(yaw)), static_cast<float>(pitch)});
+    }
+    yaw = yaw0 + dyaw;
+    pitch = pitch0 + dpitch;
+  }
+
+  uint64_t next = 0;
+  while (next < trace.truth.size()) {
+    if (uniform(rng) >= drop_rate) {
+      TraceSample s = trace.truth[next];
+      s.yaw = wrapAngle(s.yaw + static_cast<float>(noise(rng)));
+      s.pitch += static_cast<float>(noise(rng));
+      trace.captured.push_back(s);
+    }
+    next += min_interval + static_cast<uint32_t>(uniform(rng) * (max_interval - min_interval));
+  }
+  return trace;
+}
+
+// recorded trace in csv, each line is "pts_ms,yaw,pitch"
+bool loadTrace(const std::string &path, HeadTrace &trace) {
+  std::ifstream file(path);
+  if (!file.is_open()) return false;
+  trace.name = path;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream iss(line);
+    TraceSample s;
+    if (iss >> s.pts >> s.yaw >> s.pitch) trace.truth.push_back(s);
+  }
+  trace.captured = trace.truth;
+  return trace.truth.size() > 0;
+}
+
+class ViewportPredictBenchmark : public testing::Test {
+ public:
+  virtual void SetUp() {
+    libPath = "../../plugins/ViewportPredict_Plugin/";
+    traces.push_back(synthesizeTrace("regular_40ms", 1, 120000, 40, 41, 0.0));
+    traces.push_back(synthesizeTrace("irregular_15_90ms", 2, 120000, 15, 90, 0.1));
+    const char *recorded = getenv("OMAF_HEAD_TRACE");
+    if (recorded) {
+      HeadTrace trace;
+      if (loadTrace(recorded, trace)) traces.push_back(trace);
+    }
+  }
+
+  virtual void TearDown() {}
+
+  // replay the trace, predicting the pose after the horizon from each captured pose
+  PredictError replay(ViewportPredictPlugin *plugin, const HeadTrace &trace, uint64_t horizon, size_t history) {
+    PredictError result;
+    std::list<ViewportPose> poses;
+    for (size_t i = 0; i < trace.captured.size(); i++) {
+      ViewportPose pose;
+      pose.angle.yaw = trace.captured[i].yaw;
+      pose.angle.pitch = trace.captured[i].pitch;
+      pose.angle.roll = 0;
+      pose.pts = trace.captured[i].pts;
+      poses.push_back(pose);
+      if (poses.size() > history) poses.pop_front();
+      if (poses.size() < history || pose.pts + horizon > trace.truth.back().pts) continue;
+
+      PredictedViewport predicted;
+      if (plugin) {
+        auto start = std::chrono::steady_clock::now();
+        if (plugin->PredictTimed(poses, pose.pts + horizon, &predicted) != ERROR_NONE) continue;
+        result.total_us +=
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+      } else {
+        // no prediction, the viewport stays where it is
+        predicted.angle = pose.angle;
+        predicted.confidence = -1.0f;
+      }
+      TraceSample real = poseAt(trace.truth, pose.pts + horizon);
+      result.errors.push_back(sphereDistance(predicted.angle.yaw, predicted.angle.pitch, real.yaw, real.pitch));
+      result.confidences.push_back(predicted.confidence);
+    }
+    return result;
+  }
+
+  void report(const std::string &predictor, const HeadTrace &trace, uint64_t horizon, const PredictError &result) {
+    LOG(INFO) << "trace " << trace.name << ", horizon " << horizon << " ms, " << predictor << ": mean error "
+              << result.mean() << ", p50 " << result.percentile(0.5) << ", p95 " << result.percentile(0.95)
+              << " degree, " << (result.errors.empty() ? 0 : result.total_us / result.errors.size()) << " us/predict"
+              << std::endl;
+  }
+
+  std::string libPath;
+  std::vector<HeadTrace> traces;
+};
+
+TEST_F(ViewportPredictBenchmark, kalmanAgainstLinearRegression) {
+  ViewportPredictPlugin kalman;
+  ASSERT_EQ(kalman.LoadPlugin((libPath + "predict_Kalman/libViewportPredict_Kalman.so").c_str()), ERROR_NONE);
+  EXPECT_TRUE(kalman.GetCapabilities() & VIEWPORT_PREDICT_CAP_TIMED);
+  ASSERT_EQ(kalman.Intialize(POSE_INTERVAL, PREDICTION_POSE_COUNT, PREDICTION_INTERVAL), ERROR_NONE);
+
+  ViewportPredictPlugin lr;
+  ASSERT_EQ(lr.LoadPlugin((libPath + "predict_LR/libViewportPredict_LR.so").c_str()), ERROR_NONE);
+  EXPECT_FALSE(lr.GetCapabilities() & VIEWPORT_PREDICT_CAP_TIMED);
+  ASSERT_EQ(lr.Intialize(POSE_INTERVAL, PREDICTION_POSE_COUNT, PREDICTION_INTERVAL), ERROR_NONE);
+
+  const uint64_t horizons[] = {200, 500, PREDICTION_INTERVAL};
+  for (auto &trace : traces) {
+    for (auto horizon : horizons) {
+      // the linear regression takes exactly 10 poses
+      PredictError kalmanError = replay(&kalman, trace, horizon, PREDICTION_POSE_COUNT);
+      PredictError lrError = replay(&lr, trace, horizon, 10);
+      PredictError holdError = replay(nullptr, trace, horizon, PREDICTION_POSE_COUNT);
+      report("kalman", trace, horizon, kalmanError);
+      report("linear regression", trace, horizon, lrError);
+      report("no prediction", trace, horizon, holdError);
+
+      ASSERT_FALSE(kalmanError.errors.empty());
+      // recorded traces are only reported
+      if (trace.synthetic) {
+        EXPECT_LT(kalmanError.mean(), lrError.mean());
+        EXPECT_LT(kalmanError.mean(), holdError.mean());
+      }
+    }
+  }
+}
+
+TEST_F(ViewportPredictBenchmark, confidenceFollowsError) {
+  ViewportPredictPlugin kalman;
+  ASSERT_EQ(kalman.LoadPlugin((libPath + "predict_Kalman/libViewportPredict_Kalman.so").c_str()), ERROR_NONE);
+  ASSERT_EQ(kalman.Intialize(POSE_INTERVAL, PREDICTION_POSE_COUNT, PREDICTION_INTERVAL), ERROR_NONE);
+
+  // the far prediction is less confident
+  PredictError nearError = replay(&kalman, traces[1], 200, PREDICTION_POSE_COUNT);
+  PredictError farError = replay(&kalman, traces[1], PREDICTION_INTERVAL, PREDICTION_POSE_COUNT);
+  double nearConfidence = 0.0, farConfidence = 0.0;
+  for (auto c : nearError.confidences) nearConfidence += c;
+  for (auto c : farError.confidences) farConfidence += c;
+  nearConfidence /= nearError.confidences.size();
+  farConfidence /= farError.confidences.size();
+  EXPECT_GT(nearConfidence, farConfidence);
+  for (auto c : farError.confidences) {
+    EXPECT_GE(c, 0.0);
+    EXPECT_LE(c, 1.0);
+  }
+
+  // the confident predictions are the accurate ones
+  std::vector<std::pair<double, double>> samples;
+  for (size_t i = 0; i < farError.errors.size(); i++) {
+    samples.push_back(std::make_pair(farError.confidences[i], farError.errors[i]));
+  }
+  std::sort(samples.begin(), samples.end());
+  size_t half = samples.size() / 2;
+  double lowConfidenceError = 0.0, highConfidenceError = 0.0;
+  for (size_t i = 0; i < half; i++) lowConfidenceError += samples[i].second;
+  for (size_t i = half; i < samples.size(); i++) highConfidenceError += samples[i].second;
+  lowConfidenceError /= half;
+  highConfidenceError /= (samples.size() - half);
+  LOG(INFO) << "mean error " << highConfidenceError << " degree in confident half, " << lowConfidenceError
+            << " degree in the other" << std::endl;
+  EXPECT_LT(highConfidenceError, lowConfidenceError);
+
+  // irregular poses given without timestamps are taken as evenly spaced
+  std::list<ViewportAngle> angles;
+  for (size_t i = 0; i < 10; i++) {
+    ViewportAngle angle;
+    angle.yaw = traces[1].captured[i].yaw;
+    angle.pitch = traces[1].captured[i].pitch;
+    angle.roll = 0;
+    angles.push_back(angle);
+  }
+  ViewportAngle *angle = kalman.Predict(angles);
+  EXPECT_TRUE(angle != NULL);
+  SAFE_DELETE(angle);
+}
+
+}  // namespace
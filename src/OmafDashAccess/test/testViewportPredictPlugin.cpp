@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ *
+ */
+
+/*
+ * File:   testViewportPredictPlugin.cpp
+ * Author: media
+ *
+ */
+
+#include "gtest/gtest.h"
+#include <list>
+#include <string>
+
+#include "../OmafTracksSelector.h"
+#include "../OmafViewportPredict/ViewportPredictPlugin.h"
+
+using namespace VCD::OMAF;
+
+namespace {
+
+// selector only for plugin swap, no tracks are selected
+class PredictTracksSelector : public OmafTracksSelector {
+ public:
+  int SelectTracks(OmafMediaStream *pStream) { return ERROR_NONE; }
+  ViewportPredictPlugin *CurrentPlugin() { return GetPredictPlugin(); }
+};
+
+class ViewportPredictPluginTest : public testing::Test {
+ public:
+  virtual void SetUp() {
+    pluginName = "libViewportPredict_LR.so";
+    libPath = "../../plugins/ViewportPredict_Plugin/predict_LR/";
+
+    for (int i = 0; i < 10; i++) {
+      ViewportAngle angle;
+      angle.yaw = i * 2.0f;
+      angle.pitch = i * 1.0f;
+      angle.roll = 0;
+      poseHistory.push_back(angle);
+    }
+  }
+
+  virtual void TearDown() {}
+
+  std::string pluginName;
+  std::string libPath;
+  std::list<ViewportAngle> poseHistory;
+};
+
+TEST_F(ViewportPredictPluginTest, versionAndCapabilities) {
+  ViewportPredictPlugin plugin;
+  EXPECT_NE(plugin.LoadPlugin((libPath + "libNotExist.so").c_str()), ERROR_NONE);
+
+  ViewportPredictPlugin lrPlugin;
+  ASSERT_EQ(lrPlugin.LoadPlugin((libPath + pluginName).c_str()), ERROR_NONE);
+  EXPECT_EQ(lrPlugin.GetAPIVersion() >> 16, (uint32_t)VIEWPORT_PREDICT_API_VERSION_MAJOR);
+  EXPECT_TRUE(lrPlugin.GetCapabilities() & VIEWPORT_PREDICT_CAP_DESTROY);
+  EXPECT_EQ(lrPlugin.Intialize(POSE_INTERVAL, PREDICTION_POSE_COUNT, PREDICTION_INTERVAL), ERROR_NONE);
+
+  for (int i = 0; i < 5; i++) {
+    ViewportAngle *angle = lrPlugin.Predict(poseHistory);
+    EXPECT_TRUE(angle != NULL);
+    SAFE_DELETE(angle);
+  }
+
+  PluginTimingStats stats;
+  lrPlugin.GetTimingStats(&stats);
+  EXPECT_EQ(stats.calls, (uint64_t)5);
+  EXPECT_EQ(stats.failures, (uint64_t)0);
+  EXPECT_GE(stats.total_us, stats.max_us);
+}
+
+TEST_F(ViewportPredictPluginTest, swapAtSegmentBoundary) {
+  PredictTracksSelector selector;
+  PluginTimingStats stats;
+  EXPECT_NE(selector.SwapPredictPlugin(pluginName, libPath), ERROR_NONE);
+  EXPECT_NE(selector.GetPredictPluginStats(&stats), ERROR_NONE);
+
+  ASSERT_EQ(selector.EnablePosePrediction(pluginName, libPath), ERROR_NONE);
+  ViewportPredictPlugin *oldPlugin = selector.CurrentPlugin();
+  ASSERT_TRUE(oldPlugin != NULL);
+  ViewportAngle *angle = oldPlugin->Predict(poseHistory);
+  SAFE_DELETE(angle);
+  EXPECT_EQ(selector.GetPredictPluginStats(&stats), ERROR_NONE);
+  EXPECT_EQ(stats.calls, (uint64_t)1);
+
+  // failed swap keeps the plugin in use
+  EXPECT_NE(selector.SwapPredictPlugin("libNotExist.so", libPath), ERROR_NONE);
+  EXPECT_EQ(selector.CurrentPlugin(), oldPlugin);
+
+  // the new plugin takes effect at next selection, with its own counters
+  EXPECT_EQ(selector.SwapPredictPlugin(pluginName, libPath), ERROR_NONE);
+  EXPECT_EQ(selector.GetPredictPluginStats(&stats), ERROR_NONE);
+  EXPECT_EQ(stats.calls, (uint64_t)1);
+  ViewportPredictPlugin *newPlugin = selector.CurrentPlugin();
+  ASSERT_TRUE(newPlugin != NULL);
+  EXPECT_NE(newPlugin, oldPlugin);
+  EXPECT_EQ(selector.GetPredictPluginStats(&stats), ERROR_NONE);
+  EXPECT_EQ(stats.calls, (uint64_t)0);
+  EXPECT_EQ(selector.CurrentPlugin(), newPlugin);
+}
+
+}  // namespace
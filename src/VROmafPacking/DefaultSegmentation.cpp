@@ -648,6 +648,7 @@ int32_t DefaultSegmentation::WriteSegmentForEachVideo(MediaStream *stream, bool
         return OMAF_ERROR_NULL_PTR;
 
     VideoStream *vs = (VideoStream*)stream;
+    MetricTimer writeTimer(m_segWriteTime);
 
     std::map<MediaStream*, TrackSegmentCtx*>::iterator itStreamTrack;
     itStreamTrack = m_streamSegCtx.find(stream);
@@ -680,6 +681,13 @@ int32_t DefaultSegmentation::WriteSegmentForEachVideo(MediaStream *stream, bool
         trackSegCtxs[tileIdx].codedMeta.presTime.m_den = 1000;
 
         m_segNum = dashSegmenter->GetSegmentsNum();
+        if (m_segNum == (m_prevSegNum + 1))
+        {
+            if (m_segmentsNum)
+                m_segmentsNum->Add();
+            if (m_segmentsBytes)
+                m_segmentsBytes->Add(dashSegmenter->GetSegmentSize());
+        }
 
 #ifdef _USE_TRACE_
         //trace
@@ -727,6 +735,7 @@ int32_t DefaultSegmentation::WriteSegmentForEachExtractorTrack(
     if (!dashSegmenter)
        return OMAF_ERROR_NULL_PTR;
 
+    MetricTimer writeTimer(m_extractorWriteTime);
     int32_t ret = dashSegmenter->SegmentData(trackSegCtx);
     if (ret)
         return ret;
@@ -736,8 +745,16 @@ int32_t DefaultSegmentation::WriteSegmentForEachExtractorTrack(
     trackSegCtx->codedMeta.presTime.m_num += 1000 / (m_frameRate.num / m_frameRate.den);
     trackSegCtx->codedMeta.presTime.m_den = 1000;
 
-#ifdef _USE_TRACE_
     uint64_t currSegNum = dashSegmenter->GetSegmentsNum();
+    if (currSegNum == (m_prevSegNum + 1))
+    {
+        if (m_segmentsNum)
+            m_segmentsNum->Add();
+        if (m_segmentsBytes)
+            m_segmentsBytes->Add(dashSegmenter->GetSegmentSize());
+    }
+
+#ifdef _USE_TRACE_
     if (currSegNum == (m_prevSegNum + 1))
     {
         uint64_t segSize = dashSegmenter->GetSegmentSize();
@@ -1298,6 +1315,8 @@ int32_t DefaultSegmentation::VideoSegmentation()
             std::chrono::high_resolution_clock clock;
             uint64_t before = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
             LOG(INFO) << "Complete one seg in  " << (before - currentT) << " ms" << std::endl;
+            if (m_segCompleteTime && currentT)
+                m_segCompleteTime->Record((before - currentT) * 1000);
             currentT = before;
         }
 
@@ -32,6 +32,7 @@
 //!
 
 #include <set>
+#include <algorithm>
 
 #include "ExtractorTrackGenerator.h"
 #include "VideoStream.h"
@@ -112,6 +113,9 @@ int32_t ExtractorTrackGenerator::FillDstContentCoverage(
     uint8_t viewportIdx,
     ContentCoverage *dstCovi)
 {
+    if (m_projType == VCD::OMAF::ProjectionFormat::PF_CUBEMAP)
+        return FillCubeMapContentCoverage(viewportIdx, dstCovi);
+
     uint8_t tilesNumInViewRow = m_rwpkGen->GetTilesNumInViewportRow();
     uint8_t tileRowNumInView  = m_rwpkGen->GetTileRowNumInViewport();
 
@@ -194,6 +198,229 @@ int32_t ExtractorTrackGenerator::FillDstContentCoverage(
     return ERROR_NONE;
 }
 
+int32_t ExtractorTrackGenerator::FillCubeMapContentCoverage(
+    uint8_t viewportIdx,
+    ContentCoverage *dstCovi)
+{
+    std::map<uint16_t, std::pair<float, float>>::iterator it = m_viewportDirections.find(viewportIdx);
+    if (it == m_viewportDirections.end())
+        return OMAF_ERROR_VIEWPORT_NUM;
+
+    float yaw   = it->second.first;
+    float pitch = it->second.second;
+
+    //each face covers 90 degrees, the coverage is the tiles aligned viewport
+    float azimuthRange   = (float)m_finalViewportWidth * 90.f / m_viewInfo->faceWidth;
+    float elevationRange = (float)m_finalViewportHeight * 90.f / m_viewInfo->faceHeight;
+    if (azimuthRange > 360.f)
+        azimuthRange = 360.f;
+    if (elevationRange > 180.f)
+        elevationRange = 180.f;
+
+    dstCovi->coverageShapeType   = 0;
+    dstCovi->numRegions          = 1;
+    dstCovi->viewIdcPresenceFlag = false;
+    dstCovi->defaultViewIdc      = 0;
+
+    dstCovi->sphereRegions = new SphereRegion[dstCovi->numRegions];
+    if (!dstCovi->sphereRegions)
+        return OMAF_ERROR_NULL_PTR;
+
+    SphereRegion *sphereRegion    = &(dstCovi->sphereRegions[0]);
+    memset_s(sphereRegion, sizeof(SphereRegion), 0);
+    sphereRegion->viewIdc         = 0;
+    sphereRegion->centreAzimuth   = (int32_t)(yaw * 65536);
+    sphereRegion->centreElevation = (int32_t)(pitch * 65536);
+    sphereRegion->centreTilt      = 0;
+    sphereRegion->azimuthRange    = (uint32_t)(azimuthRange * 65536);
+    sphereRegion->elevationRange  = (uint32_t)(elevationRange * 65536);
+    sphereRegion->interpolate     = 0;
+
+    return ERROR_NONE;
+}
+
+int32_t ExtractorTrackGenerator::FillCubeMapFacesLayout()
+{
+    InputCubeMapInfo *cubeMapInfo = m_initInfo->cubeMapInfo;
+    if (!cubeMapInfo)
+    {
+        LOG(ERROR) << "There is no input CubeMap information in initial information !" << std::endl;
+        return OMAF_ERROR_BAD_PARAM;
+    }
+
+    if ((m_origTileInRow % 3) || (m_origTileInCol % 2))
+    {
+        LOG(ERROR) << "Each face in CubeMap should have the same tiles split !" << std::endl;
+        return OMAF_ERROR_BAD_PARAM;
+    }
+
+    CubeMapFaceInfo facesInfo[CUBEMAP_FACES_NUM] = {
+        cubeMapInfo->face0MapInfo, cubeMapInfo->face1MapInfo, cubeMapInfo->face2MapInfo,
+        cubeMapInfo->face3MapInfo, cubeMapInfo->face4MapInfo, cubeMapInfo->face5MapInfo };
+
+    //input Cube-3x2, tiles selection is done in each face
+    m_viewInfo->faceWidth  = (m_initInfo->viewportInfo)->inWidth / 3;
+    m_viewInfo->faceHeight = (m_initInfo->viewportInfo)->inHeight / 2;
+    m_viewInfo->tileNumRow = (m_initInfo->viewportInfo)->tileInCol / 2;
+    m_viewInfo->tileNumCol = (m_initInfo->viewportInfo)->tileInRow / 3;
+    m_viewInfo->paramVideoFP.rows = 2;
+    m_viewInfo->paramVideoFP.cols = 3;
+    for (uint8_t faceId = 0; faceId < CUBEMAP_FACES_NUM; faceId++)
+    {
+        Param_FaceProperty *face = &(m_viewInfo->paramVideoFP.faces[faceId / 3][faceId % 3]);
+        face->idFace     = facesInfo[faceId].mappedStandardFaceId;
+        face->rotFace    = facesInfo[faceId].transformType;
+        face->faceWidth  = m_viewInfo->faceWidth;
+        face->faceHeight = m_viewInfo->faceHeight;
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t ExtractorTrackGenerator::SelectCubeMapViewportTiles()
+{
+    if (!(m_rwpkGen->GetCapabilities() & OMAF_PACKING_CAP_VIEWPORT_TILES))
+    {
+        LOG(ERROR) << "The plugin can't pack tiles selected for CubeMap viewport !" << std::endl;
+        return OMAF_ERROR_UNDEFINED_OPERATION;
+    }
+
+    uint16_t viewportNum = CalculateViewportNum();
+    if (!viewportNum)
+        return OMAF_ERROR_VIEWPORT_NUM;
+
+    //360SCVP selects at most 1024 tiles for one viewport
+    std::vector<TileDef> tilesInViewport(1024);
+    std::vector<uint8_t> tilesIdx;
+
+    int32_t ret = ERROR_NONE;
+    for (uint16_t viewportIdx = 0; viewportIdx < viewportNum; viewportIdx++)
+    {
+        //viewports are sampled evenly in yaw and pitch, one for each tile as ERP does
+        float yaw   = 180.f - ((viewportIdx % m_origTileInRow) + 0.5f) * 360.f / m_origTileInRow;
+        float pitch = 90.f - ((viewportIdx / m_origTileInRow) + 0.5f) * 180.f / m_origTileInCol;
+        m_viewportDirections[viewportIdx] = std::make_pair(yaw, pitch);
+
+        if (I360SCVP_setViewPort(m_360scvpHandle, yaw, pitch))
+            return OMAF_ERROR_SCVP_SET_FAILED;
+
+        if (I360SCVP_process(m_360scvpParam, m_360scvpHandle))
+            return OMAF_ERROR_SCVP_PROCESS_FAILED;
+
+        for (uint32_t i = 0; i < tilesInViewport.size(); i++)
+        {
+            tilesInViewport[i].faceId = -1;
+        }
+        Param_ViewportOutput paramViewportOutput;
+        int32_t tilesNum = I360SCVP_getFixedNumTiles(
+                        tilesInViewport.data(),
+                        &paramViewportOutput,
+                        m_360scvpHandle);
+        if (tilesNum <= 0 || tilesNum > (int32_t)(tilesInViewport.size()))
+            return OMAF_ERROR_SCVP_INCORRECT_RESULT;
+
+        ret = MapCubeMapTiles(
+            tilesInViewport.data(), tilesNum,
+            m_origTileInRow, m_origTileInCol,
+            m_viewInfo->faceWidth, m_viewInfo->faceHeight,
+            m_tilesNumInViewport, viewportIdx, tilesIdx);
+        if (ret)
+            return ret;
+
+        ret = m_rwpkGen->SetViewportTiles((uint8_t)viewportIdx, (uint8_t)m_tilesNumInViewport, tilesIdx.data());
+        if (ret)
+            return ret;
+    }
+
+    //restore the initial viewport
+    if (I360SCVP_setViewPort(m_360scvpHandle, (m_initInfo->viewportInfo)->viewportYaw, (m_initInfo->viewportInfo)->viewportPitch))
+        return OMAF_ERROR_SCVP_SET_FAILED;
+    if (I360SCVP_process(m_360scvpParam, m_360scvpHandle))
+        return OMAF_ERROR_SCVP_PROCESS_FAILED;
+
+    return ERROR_NONE;
+}
+
+int32_t ExtractorTrackGenerator::MapCubeMapTiles(
+    const TileDef *tilesInFace,
+    int32_t tilesNum,
+    uint8_t tileInRow,
+    uint8_t tileInCol,
+    uint32_t faceWidth,
+    uint32_t faceHeight,
+    uint8_t tilesNumInViewport,
+    uint16_t firstTileIdx,
+    std::vector<uint8_t> &tilesIdx)
+{
+    if (!tilesInFace || tilesNum < 0)
+        return OMAF_ERROR_NULL_PTR;
+
+    uint16_t totalTilesNum = tileInRow * tileInCol;
+    if ((tileInRow % 3) || (tileInCol % 2) || !totalTilesNum || tilesNumInViewport > totalTilesNum)
+        return OMAF_ERROR_SCVP_INCORRECT_RESULT;
+
+    uint8_t  tileRowsInFace = tileInCol / 2;
+    uint8_t  tileColsInFace = tileInRow / 3;
+    uint32_t tileWidth      = faceWidth / tileColsInFace;
+    uint32_t tileHeight     = faceHeight / tileRowsInFace;
+    if (!tileWidth || !tileHeight)
+        return OMAF_ERROR_BAD_PARAM;
+
+    //tiles position is inside the face, map it into the input picture
+    std::set<uint8_t> selectedTiles;
+    for (int32_t i = 0; i < tilesNum && selectedTiles.size() < tilesNumInViewport; i++)
+    {
+        const TileDef *tile = &(tilesInFace[i]);
+        if (tile->faceId < 0 || tile->faceId >= CUBEMAP_FACES_NUM)
+            continue;
+
+        uint32_t tileRow = (tile->faceId / 3) * tileRowsInFace + tile->y / tileHeight;
+        uint32_t tileCol = (tile->faceId % 3) * tileColsInFace + tile->x / tileWidth;
+        if (tileRow < tileInCol && tileCol < tileInRow)
+        {
+            selectedTiles.insert((uint8_t)(tileRow * tileInRow + tileCol));
+        }
+    }
+
+    //merged picture needs the fixed tiles number, fill with the following tiles
+    uint16_t fillIdx = selectedTiles.empty() ? firstTileIdx : *(selectedTiles.begin());
+    while (selectedTiles.size() < tilesNumInViewport)
+    {
+        selectedTiles.insert((uint8_t)(fillIdx % totalTilesNum));
+        fillIdx++;
+    }
+
+    tilesIdx.assign(selectedTiles.begin(), selectedTiles.end());
+
+    return ERROR_NONE;
+}
+
+std::vector<uint32_t> ExtractorTrackGenerator::GetTilesSetKey(
+    TilesMergeDirectionInCol *tilesMergeDir)
+{
+    std::vector<uint32_t> key;
+    std::vector<uint32_t> tilesSet;
+    std::list<TilesInCol*>::iterator itCol;
+    for (itCol = tilesMergeDir->tilesArrangeInCol.begin();
+        itCol != tilesMergeDir->tilesArrangeInCol.end(); itCol++)
+    {
+        TilesInCol *tileCol = *itCol;
+        key.push_back((uint32_t)(tileCol->size()));
+
+        std::list<SingleTile*>::iterator itTile;
+        for (itTile = tileCol->begin(); itTile != tileCol->end(); itTile++)
+        {
+            SingleTile *tile = *itTile;
+            tilesSet.push_back(((uint32_t)(tile->streamIdxInMedia) << 8) | tile->origTileIdx);
+        }
+    }
+
+    std::sort(tilesSet.begin(), tilesSet.end());
+    key.insert(key.end(), tilesSet.begin(), tilesSet.end());
+
+    return key;
+}
+
 int32_t ExtractorTrackGenerator::CheckAndFillInitInfo()
 {
     if (!m_initInfo)
@@ -380,9 +607,15 @@ int32_t ExtractorTrackGenerator::Initialize()
         m_viewInfo->paramVideoFP.faces[0][0].faceWidth = m_viewInfo->faceWidth;
         m_viewInfo->paramVideoFP.faces[0][0].faceHeight = m_viewInfo->faceHeight;
     }
+    else if ((EGeometryType)((m_initInfo->viewportInfo)->inGeoType) == E_SVIDEO_CUBEMAP)
+    {
+        ret = FillCubeMapFacesLayout();
+        if (ret)
+            return ret;
+    }
     else
     {
-        LOG(ERROR) << "Now extractor track isn't supported for other projection format than ERP !" << std::endl;
+        LOG(ERROR) << "Now extractor track isn't supported for other projection format than ERP and CubeMap !" << std::endl;
         return OMAF_ERROR_INVALID_PROJECTIONTYPE;
     }
 
@@ -398,11 +631,12 @@ int32_t ExtractorTrackGenerator::Initialize()
     m_360scvpParam->paramViewPort.viewPortFOVV   = (m_initInfo->viewportInfo)->verticalFOVAngle;
     m_360scvpParam->paramViewPort.geoTypeOutput  = (EGeometryType)((m_initInfo->viewportInfo)->outGeoType);
     m_360scvpParam->paramViewPort.geoTypeInput   = (EGeometryType)((m_initInfo->viewportInfo)->inGeoType);
-    m_360scvpParam->paramViewPort.faceWidth      = (m_initInfo->viewportInfo)->inWidth;
-    m_360scvpParam->paramViewPort.faceHeight     = (m_initInfo->viewportInfo)->inHeight;
-    m_360scvpParam->paramViewPort.tileNumRow     = (m_initInfo->viewportInfo)->tileInCol;
-    m_360scvpParam->paramViewPort.tileNumCol     = (m_initInfo->viewportInfo)->tileInRow;
+    m_360scvpParam->paramViewPort.faceWidth      = m_viewInfo->faceWidth;
+    m_360scvpParam->paramViewPort.faceHeight     = m_viewInfo->faceHeight;
+    m_360scvpParam->paramViewPort.tileNumRow     = m_viewInfo->tileNumRow;
+    m_360scvpParam->paramViewPort.tileNumCol     = m_viewInfo->tileNumCol;
     m_360scvpParam->paramViewPort.usageType      = E_PARSER_ONENAL;
+    m_360scvpParam->paramViewPort.paramVideoFP   = m_viewInfo->paramVideoFP;
     ret = I360SCVP_process(m_360scvpParam, m_360scvpHandle);
     if (ret)
         return OMAF_ERROR_SCVP_PROCESS_FAILED;
@@ -437,6 +671,8 @@ int32_t ExtractorTrackGenerator::Initialize()
     if (!m_rwpkGen)
         return OMAF_ERROR_NULL_PTR;
 
+    m_rwpkGen->SetMetrics(m_metrics);
+
     ret = m_rwpkGen->Initialize(
          m_initInfo->pluginPath, m_initInfo->pluginName,
          m_streams, m_videoIdxInMedia,
@@ -445,6 +681,13 @@ int32_t ExtractorTrackGenerator::Initialize()
     if (ret)
         return ret;
 
+    if (m_projType == VCD::OMAF::ProjectionFormat::PF_CUBEMAP)
+    {
+        ret = SelectCubeMapViewportTiles();
+        if (ret)
+            return ret;
+    }
+
     return ERROR_NONE;
 }
 
@@ -459,6 +702,8 @@ int32_t ExtractorTrackGenerator::GenerateExtractorTracks(
     if (!m_viewportNum)
         return OMAF_ERROR_VIEWPORT_NUM;
 
+    m_viewportTrackMap.clear();
+    std::map<std::vector<uint32_t>, uint8_t> tilesSetTracks;
     for (uint8_t i = 0; i < m_viewportNum; i++)
     {
         ExtractorTrack *extractorTrack = new ExtractorTrack(i, streams, (m_initInfo->viewportInfo)->inGeoType);
@@ -492,15 +737,35 @@ int32_t ExtractorTrackGenerator::GenerateExtractorTracks(
             return retInit;
         }
 
-        FillDstRegionWisePacking(i, extractorTrack->GetRwpk());
-
         FillTilesMergeDirection(i, extractorTrack->GetTilesMergeDir());
 
+        //viewports selecting the same tiles share one extractor track,
+        //which already covers the same sphere region
+        std::vector<uint32_t> tilesSetKey = GetTilesSetKey(extractorTrack->GetTilesMergeDir());
+        std::map<std::vector<uint32_t>, uint8_t>::iterator itKey = tilesSetTracks.find(tilesSetKey);
+        if (itKey != tilesSetTracks.end())
+        {
+            LOG(INFO) << "Viewport " << (uint32_t)i << " shares extractor track " << (uint32_t)(itKey->second) << " !" << std::endl;
+            m_viewportTrackMap[i] = itKey->second;
+            DELETE_MEMORY(extractorTrack);
+            continue;
+        }
+
+        FillDstRegionWisePacking(i, extractorTrack->GetRwpk());
+
         FillDstContentCoverage(i, extractorTrack->GetCovi());
 
+        tilesSetTracks.insert(std::make_pair(tilesSetKey, i));
+        m_viewportTrackMap[i] = i;
         extractorTrackMap.insert(std::make_pair(i, std::move(extractorTrack)));
     }
 
+    LOG(INFO) << "Generated " << extractorTrackMap.size() << " extractor tracks for " << m_viewportNum << " viewports !" << std::endl;
+
+    const RWPKGeneratorTimingStats *timingStats = m_rwpkGen->GetTimingStats();
+    LOG(INFO) << "Packing plugin is called " << timingStats->calls << " times, failed " << timingStats->failures
+              << " times, spent " << timingStats->totalUs << " us in total and " << timingStats->maxUs << " us at most !" << std::endl;
+
     int32_t ret = GenerateNewSPS();
     if (ret)
         return ret;
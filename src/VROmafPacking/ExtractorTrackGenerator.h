@@ -86,6 +86,7 @@ public:
         m_origVPSNalu     = NULL;
         m_origSPSNalu     = NULL;
         m_origPPSNalu     = NULL;
+        m_metrics         = NULL;
     };
 
     //!
@@ -125,6 +126,7 @@ public:
         m_origVPSNalu     = NULL;
         m_origSPSNalu     = NULL;
         m_origPPSNalu     = NULL;
+        m_metrics         = NULL;
     };
 
     ExtractorTrackGenerator(const ExtractorTrackGenerator& src)
@@ -156,6 +158,9 @@ public:
         m_origVPSNalu     = std::move(src.m_origVPSNalu);
         m_origSPSNalu     = std::move(src.m_origSPSNalu);
         m_origPPSNalu     = std::move(src.m_origPPSNalu);
+        m_metrics         = src.m_metrics;
+        m_viewportTrackMap = std::move(src.m_viewportTrackMap);
+        m_viewportDirections = std::move(src.m_viewportDirections);
     };
 
     ExtractorTrackGenerator& operator=(ExtractorTrackGenerator&& other)
@@ -187,6 +192,9 @@ public:
         m_origVPSNalu     = NULL;
         m_origSPSNalu     = NULL;
         m_origPPSNalu     = NULL;
+        m_metrics         = other.m_metrics;
+        m_viewportTrackMap = std::move(other.m_viewportTrackMap);
+        m_viewportDirections = std::move(other.m_viewportDirections);
 
         return *this;
     };
@@ -237,6 +245,67 @@ public:
     //!
     Nalu* GetNewPPS() { return m_newPPSNalu; };
 
+    //!
+    //! \brief  Get the map from viewport index to the index of
+    //!         extractor track which is generated for the viewport,
+    //!         viewports with the same tiles share one extractor track
+    //!
+    //! \return std::map<uint16_t, uint8_t>*
+    //!         the pointer to the viewport to extractor track map
+    //!
+    std::map<uint16_t, uint8_t>* GetViewportTrackMap() { return &m_viewportTrackMap; };
+
+    //!
+    //! \brief  Set the metrics registry where the packing plugin
+    //!         calls are measured, it should be set before Initialize
+    //!
+    //! \param  [in] metrics
+    //!         pointer to the metrics registry owned by OmafPackage
+    //!
+    //! \return void
+    //!
+    void SetMetrics(MetricsRegistry *metrics) { m_metrics = metrics; };
+
+    //!
+    //! \brief  Map the tiles selected by 360SCVP library inside the
+    //!         faces of Cube-3x2 input into the tiles of the whole
+    //!         picture, then fill with the following tiles up to the
+    //!         fixed tiles number in viewport
+    //!
+    //! \param  [in]  tilesInFace
+    //!         pointer to the tiles selected in faces, the tiles
+    //!         without valid face are skipped
+    //! \param  [in]  tilesNum
+    //!         the number of tiles selected in faces
+    //! \param  [in]  tileInRow
+    //!         the number of tiles in one row of the whole picture
+    //! \param  [in]  tileInCol
+    //!         the number of tiles in one column of the whole picture
+    //! \param  [in]  faceWidth
+    //!         the width of one face
+    //! \param  [in]  faceHeight
+    //!         the height of one face
+    //! \param  [in]  tilesNumInViewport
+    //!         the fixed tiles number in viewport
+    //! \param  [in]  firstTileIdx
+    //!         the tile to fill from when no tile is selected
+    //! \param  [out] tilesIdx
+    //!         the sorted indexes of tiles in the whole picture
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    static int32_t MapCubeMapTiles(
+        const TileDef *tilesInFace,
+        int32_t tilesNum,
+        uint8_t tileInRow,
+        uint8_t tileInCol,
+        uint32_t faceWidth,
+        uint32_t faceHeight,
+        uint8_t tilesNumInViewport,
+        uint16_t firstTileIdx,
+        std::vector<uint8_t> &tilesIdx);
+
 private:
     //!
     //! \brief  Calculate the total viewport number
@@ -297,6 +366,57 @@ private:
     //!
     int32_t FillDstContentCoverage(uint8_t viewportIdx, ContentCoverage *dstCovi);
 
+    //!
+    //! \brief  Fill the content coverage information for the
+    //!         specified viewport of CubeMap input, centred at
+    //!         the direction the viewport is sampled at
+    //!
+    //! \param  [in] viewportIdx
+    //!         the index of the specified viewport
+    //! \param  [in] dstCovi
+    //!         pointer to the content coverage information for the
+    //!         specified viewport
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t FillCubeMapContentCoverage(uint8_t viewportIdx, ContentCoverage *dstCovi);
+
+    //!
+    //! \brief  Fill the faces layout of input Cube-3x2 into the
+    //!         viewport information for 360SCVP library
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t FillCubeMapFacesLayout();
+
+    //!
+    //! \brief  Select the high resolution tiles for each viewport
+    //!         of CubeMap input through 360SCVP library, tiles in
+    //!         one viewport may come from different faces, and set
+    //!         them into region wise packing generator
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t SelectCubeMapViewportTiles();
+
+    //!
+    //! \brief  Get the canonical key of the tiles merged into one
+    //!         extractor track, which consists of the tiles number
+    //!         in each column of merged picture and the sorted tiles
+    //!         set, viewports with the same key resolve to the same
+    //!         extractor track
+    //!
+    //! \param  [in] tilesMergeDir
+    //!         pointer to the tiles merging direction of the viewport
+    //!
+    //! \return std::vector<uint32_t>
+    //!         the canonical key
+    //!
+    std::vector<uint32_t> GetTilesSetKey(TilesMergeDirectionInCol *tilesMergeDir);
+
     //!
     //! \brief  Check the validation of initial information
     //!         input by library interface, meanwhile fill the lacked
@@ -352,6 +472,9 @@ private:
     Nalu                            *m_origVPSNalu;       //!< the pointer to original VPS nalu of high resolution video stream
     Nalu                            *m_origSPSNalu;       //!< the pointer to original SPS nalu of high resolution video stream
     Nalu                            *m_origPPSNalu;       //!< the pointer to original PPS nalu of high resolution video stream
+    std::map<uint16_t, uint8_t>     m_viewportTrackMap;   //!< map from viewport index to the index of extractor track covering it
+    std::map<uint16_t, std::pair<float, float>> m_viewportDirections; //!< map from viewport index to its yaw and pitch for CubeMap input
+    MetricsRegistry                 *m_metrics;           //!< the metrics registry where the packing plugin calls are measured
 };
 
 VCD_NS_END;
@@ -40,6 +40,7 @@ ExtractorTrackManager::ExtractorTrackManager()
     m_extractorTrackGen = NULL;
     m_initInfo = NULL;
     m_streams  = NULL;
+    m_metrics  = NULL;
 }
 
 ExtractorTrackManager::ExtractorTrackManager(InitialInfo *initInfo)
@@ -47,6 +48,7 @@ ExtractorTrackManager::ExtractorTrackManager(InitialInfo *initInfo)
     m_extractorTrackGen = NULL;
     m_initInfo = initInfo;
     m_streams  = NULL;
+    m_metrics  = NULL;
 }
 
 ExtractorTrackManager::ExtractorTrackManager(const ExtractorTrackManager& src)
@@ -54,6 +56,7 @@ ExtractorTrackManager::ExtractorTrackManager(const ExtractorTrackManager& src)
     m_extractorTrackGen = std::move(src.m_extractorTrackGen);
     m_initInfo = std::move(src.m_initInfo);
     m_streams  = std::move(src.m_streams);
+    m_metrics  = src.m_metrics;
 }
 
 ExtractorTrackManager& ExtractorTrackManager::operator=(ExtractorTrackManager&& other)
@@ -61,6 +64,7 @@ ExtractorTrackManager& ExtractorTrackManager::operator=(ExtractorTrackManager&&
     m_extractorTrackGen = std::move(other.m_extractorTrackGen);
     m_initInfo = std::move(other.m_initInfo);
     m_streams  = std::move(other.m_streams);
+    m_metrics  = other.m_metrics;
 
     return *this;
 }
@@ -98,7 +102,8 @@ int32_t ExtractorTrackManager::Initialize(std::map<uint8_t, MediaStream*> *media
     if (m_initInfo->pluginName)
     {
         LOG(INFO) << "Appoint plugin  " << (m_initInfo->pluginName) << " for extractor track generation !" << std::endl;
-        if (m_initInfo->projType == E_SVIDEO_EQUIRECT)
+        if (m_initInfo->projType == E_SVIDEO_EQUIRECT ||
+            m_initInfo->projType == E_SVIDEO_CUBEMAP)
         {
             m_extractorTrackGen = new ExtractorTrackGenerator(m_initInfo, m_streams);
             if (!m_extractorTrackGen)
@@ -107,6 +112,7 @@ int32_t ExtractorTrackManager::Initialize(std::map<uint8_t, MediaStream*> *media
                 return OMAF_ERROR_NULL_PTR;
             }
 
+            m_extractorTrackGen->SetMetrics(m_metrics);
             int32_t ret = m_extractorTrackGen->Initialize();
             if (ret)
                 return ret;
@@ -115,10 +121,6 @@ int32_t ExtractorTrackManager::Initialize(std::map<uint8_t, MediaStream*> *media
             if (ret)
                 return ret;
         }
-        else if (m_initInfo->projType == E_SVIDEO_CUBEMAP)
-        {
-            LOG(INFO) << "But at present, extractor track is not supported for CubeMap, so extractor track will not be generated as well !" << std::endl;
-        }
     }
     else
     {
@@ -95,6 +95,29 @@ public:
     {
         return &m_extractorTracks;
     }
+
+    //!
+    //! \brief  Get the map from viewport index to the index of
+    //!         extractor track covering the viewport
+    //!
+    //! \return std::map<uint16_t, uint8_t>*
+    //!         the pointer to the viewport to extractor track map
+    //!
+    std::map<uint16_t, uint8_t>* GetViewportTrackMap()
+    {
+        return m_extractorTrackGen ? m_extractorTrackGen->GetViewportTrackMap() : NULL;
+    }
+
+    //!
+    //! \brief  Set the metrics registry where the packing plugin
+    //!         calls are measured, it should be set before Initialize
+    //!
+    //! \param  [in] metrics
+    //!         pointer to the metrics registry owned by OmafPackage
+    //!
+    //! \return void
+    //!
+    void SetMetrics(MetricsRegistry *metrics) { m_metrics = metrics; };
 private:
     //!
     //! \brief  Add each extractor track into the map
@@ -108,6 +131,7 @@ private:
     std::map<uint8_t, ExtractorTrack*> m_extractorTracks;     //!< extractor tracks map
     ExtractorTrackGenerator            *m_extractorTrackGen;  //!< extractor track generator to generate all extractor tracks
     InitialInfo                        *m_initInfo;           //!< the initial information input by library interface
+    MetricsRegistry                    *m_metrics;            //!< the metrics registry where the packing plugin calls are measured
 };
 
 VCD_NS_END;
@@ -46,6 +46,9 @@ OmafPackage::OmafPackage()
     m_isSegmentationStarted = false;
     m_threadId = 0;
     m_videoStream = NULL;
+    m_framesNum = m_metrics.Counter("frames_total", "frames input for all streams");
+    m_framesBytes = m_metrics.Counter("frame_bytes_total", "bytes of frames input for all streams");
+    m_frameWriteTime = m_metrics.Histogram("write_frame_microseconds", "time spent in taking one frame");
 }
 
 OmafPackage::OmafPackage(const OmafPackage& src)
@@ -56,6 +59,9 @@ OmafPackage::OmafPackage(const OmafPackage& src)
     m_isSegmentationStarted = src.m_isSegmentationStarted;
     m_threadId = src.m_threadId;
     m_videoStream = NULL;
+    m_framesNum = m_metrics.Counter("frames_total", "frames input for all streams");
+    m_framesBytes = m_metrics.Counter("frame_bytes_total", "bytes of frames input for all streams");
+    m_frameWriteTime = m_metrics.Histogram("write_frame_microseconds", "time spent in taking one frame");
 }
 
 OmafPackage& OmafPackage::operator=(OmafPackage&& other)
@@ -66,6 +72,9 @@ OmafPackage& OmafPackage::operator=(OmafPackage&& other)
     m_isSegmentationStarted = other.m_isSegmentationStarted;
     m_threadId = other.m_threadId;
     m_videoStream = NULL;
+    m_framesNum = m_metrics.Counter("frames_total", "frames input for all streams");
+    m_framesBytes = m_metrics.Counter("frame_bytes_total", "bytes of frames input for all streams");
+    m_frameWriteTime = m_metrics.Histogram("write_frame_microseconds", "time spent in taking one frame");
 
     return *this;
 }
@@ -130,6 +139,7 @@ int32_t OmafPackage::CreateExtractorTrackManager()
     if (!m_extractorTrackMan)
         return OMAF_ERROR_NULL_PTR;
 
+    m_extractorTrackMan->SetMetrics(&m_metrics);
     int32_t ret = m_extractorTrackMan->Initialize(&m_streams);
     if (ret)
         return ret;
@@ -143,6 +153,8 @@ int32_t OmafPackage::CreateSegmentation()
     if (!m_segmentation)
         return OMAF_ERROR_NULL_PTR;
 
+    m_segmentation->SetMetrics(&m_metrics);
+
     return ERROR_NONE;
 }
 
@@ -214,9 +226,18 @@ void OmafPackage::SegmentAllStreams()
 
 int32_t OmafPackage::OmafPacketStream(uint8_t streamIdx, FrameBSInfo *frameInfo)
 {
+    MetricTimer writeTimer(m_frameWriteTime);
     int32_t ret = SetFrameInfo(streamIdx, frameInfo);
     if (ret)
+    {
+        writeTimer.Cancel();
         return ret;
+    }
+
+    if (m_framesNum)
+        m_framesNum->Add();
+    if (m_framesBytes && frameInfo->dataSize > 0)
+        m_framesBytes->Add((uint64_t)(frameInfo->dataSize));
     //printf("m_initInfo->segmentationInfo->needBufedFrames %d \n", m_initInfo->segmentationInfo->needBufedFrames);
     if (!m_isSegmentationStarted)
     {
@@ -247,6 +268,37 @@ int32_t OmafPackage::OmafPacketStream(uint8_t streamIdx, FrameBSInfo *frameInfo)
     return ERROR_NONE;
 }
 
+void OmafPackage::UpdateQueueMetrics()
+{
+    std::map<uint8_t, MediaStream*>::iterator itMS;
+    for (itMS = m_streams.begin(); itMS != m_streams.end(); itMS++)
+    {
+        MediaStream *stream = itMS->second;
+        if (stream && stream->GetMediaType() == VIDEOTYPE)
+        {
+            VideoStream *vs = (VideoStream*)stream;
+            MetricGauge *bufferedFrames = m_metrics.Gauge("buffered_frames",
+                "frames input and not segmented yet", "stream=\"" + std::to_string(itMS->first) + "\"");
+            if (bufferedFrames)
+                bufferedFrames->Set((int64_t)(vs->GetBufferedFrameNum()));
+        }
+    }
+}
+
+int32_t OmafPackage::GetMetrics(MetricValue *values, int32_t *count)
+{
+    UpdateQueueMetrics();
+
+    return m_metrics.Snapshot(values, count);
+}
+
+std::string OmafPackage::DumpMetrics(const std::string &prefix)
+{
+    UpdateQueueMetrics();
+
+    return m_metrics.DumpPrometheus(prefix);
+}
+
 int32_t OmafPackage::OmafEndStreams()
 {
     if (m_segmentation)
@@ -40,6 +40,7 @@
 #include "VROmafPacking_data.h"
 #include "Segmentation.h"
 #include "ExtractorTrackManager.h"
+#include "MetricsRegistry.h"
 
 #include <map>
 
@@ -99,6 +100,31 @@ public:
     //!
     int32_t OmafEndStreams();
 
+    //!
+    //! \brief  Get the snapshot of the metrics
+    //!
+    //! \param  [out] values
+    //!         the metrics, NULL to query the count only
+    //! \param  [in/out] count
+    //!         capacity of values as input, count of metrics
+    //!         written as output
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GetMetrics(MetricValue *values, int32_t *count);
+
+    //!
+    //! \brief  Dump the metrics in Prometheus text format
+    //!
+    //! \param  [in] prefix
+    //!         prefix of all metric names
+    //!
+    //! \return std::string
+    //!         the metrics text
+    //!
+    std::string DumpMetrics(const std::string &prefix);
+
 private:
 
     //!
@@ -161,6 +187,14 @@ private:
     //! \return void
     //!
     void SegmentAllStreams();
+
+    //!
+    //! \brief  Sample the queue depths of all video streams
+    //!         into gauges, done when the metrics are read
+    //!
+    //! \return void
+    //!
+    void UpdateQueueMetrics();
 private:
     InitialInfo                     *m_initInfo;               //!< the initial information input by library interface
     Segmentation                    *m_segmentation;           //!< the segmentation for data segment
@@ -169,6 +203,10 @@ private:
     bool                            m_isSegmentationStarted;   //!< whether the segmentation thread is started
     pthread_t                       m_threadId;                //!< thread index of segmentation thread
     VideoStream                     *m_videoStream;
+    MetricsRegistry                 m_metrics;                 //!< the metrics of packing and segmentation
+    MetricCounter                   *m_framesNum;              //!< number of frames input for all streams
+    MetricCounter                   *m_framesBytes;            //!< size of frames input for all streams
+    MetricHistogram                 *m_frameWriteTime;         //!< time spent in taking one frame
 };
 
 VCD_NS_END;
@@ -42,6 +42,11 @@ RegionWisePackingGenerator::RegionWisePackingGenerator()
 {
     m_pluginHdl = NULL;
     m_rwpkGen = NULL;
+    m_apiVersion = 0;
+    m_capabilities = 0;
+    memset_s(&m_timingStats, sizeof(RWPKGeneratorTimingStats), 0);
+    m_pluginCallTime = NULL;
+    m_pluginFailures = NULL;
 }
 
 RegionWisePackingGenerator::~RegionWisePackingGenerator()
@@ -123,7 +128,12 @@ int32_t RegionWisePackingGenerator::Initialize(
         return OMAF_ERROR_DLOPEN;
     }
 
+    ret = NegotiatePluginAPI();
+    if (ret)
+        return ret;
+
     CreateRWPKGenerator* createRWPKGen = NULL;
+    dlerror();
     createRWPKGen = (CreateRWPKGenerator*)dlsym(m_pluginHdl, "Create");
     const char* dlsymErr2 = dlerror();
     if (dlsymErr2)
@@ -195,6 +205,80 @@ int32_t RegionWisePackingGenerator::Initialize(
     return ret;
 }
 
+int32_t RegionWisePackingGenerator::NegotiatePluginAPI()
+{
+    if (!m_pluginHdl)
+        return OMAF_ERROR_NULL_PTR;
+
+    //plugins built before the versioned API don't export the version
+    m_apiVersion = (OMAF_PACKING_API_VERSION_MAJOR << 16);
+    m_capabilities = 0;
+
+    dlerror();
+    GetRWPKGeneratorAPIVersion* getVersion = (GetRWPKGeneratorAPIVersion*)dlsym(m_pluginHdl, "GetAPIVersion");
+    if (!dlerror() && getVersion)
+    {
+        m_apiVersion = getVersion();
+    }
+
+    if ((m_apiVersion >> 16) != OMAF_PACKING_API_VERSION_MAJOR)
+    {
+        LOG(ERROR) << "Plugin API version " << (m_apiVersion >> 16) << "." << (m_apiVersion & 0xFFFF)
+                   << " isn't compatible with " << OMAF_PACKING_API_VERSION_MAJOR << "."
+                   << OMAF_PACKING_API_VERSION_MINOR << " !" << std::endl;
+        return OMAF_INVALID_PLUGIN_PARAM;
+    }
+
+    dlerror();
+    GetRWPKGeneratorCapabilities* getCaps = (GetRWPKGeneratorCapabilities*)dlsym(m_pluginHdl, "GetCapabilities");
+    if (!dlerror() && getCaps)
+    {
+        m_capabilities = getCaps();
+    }
+
+    LOG(INFO) << "Plugin API version " << (m_apiVersion >> 16) << "." << (m_apiVersion & 0xFFFF)
+              << ", capabilities 0x" << std::hex << m_capabilities << std::dec << std::endl;
+
+    return ERROR_NONE;
+}
+
+void RegionWisePackingGenerator::UpdateTimingStats(
+    std::chrono::steady_clock::time_point startTime,
+    int32_t ret)
+{
+    uint64_t spentUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    m_timingStats.calls++;
+    m_timingStats.totalUs += spentUs;
+    if (spentUs > m_timingStats.maxUs)
+    {
+        m_timingStats.maxUs = spentUs;
+    }
+    if (ret)
+    {
+        m_timingStats.failures++;
+    }
+
+    if (m_pluginCallTime)
+    {
+        m_pluginCallTime->Record(spentUs);
+    }
+    if (ret && m_pluginFailures)
+    {
+        m_pluginFailures->Add();
+    }
+}
+
+void RegionWisePackingGenerator::SetMetrics(MetricsRegistry *metrics)
+{
+    if (!metrics)
+        return;
+
+    m_pluginCallTime = metrics->Histogram("packing_plugin_call_microseconds", "time spent in one call into the packing plugin");
+    m_pluginFailures = metrics->Counter("packing_plugin_failures_total", "failed calls into the packing plugin");
+}
+
 int32_t RegionWisePackingGenerator::GenerateDstRwpk(
     uint8_t viewportIdx,
     RegionWisePacking *dstRwpk)
@@ -202,7 +286,9 @@ int32_t RegionWisePackingGenerator::GenerateDstRwpk(
     int32_t ret = ERROR_NONE;
     if (m_rwpkGen)
     {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
         ret = m_rwpkGen->GenerateDstRwpk(viewportIdx, dstRwpk);
+        UpdateTimingStats(startTime, ret);
         if (ret)
         {
             LOG(ERROR) << "Failed to generate destinate RWPK !" << std::endl;
@@ -223,7 +309,9 @@ int32_t RegionWisePackingGenerator::GenerateTilesMergeDirection(
     int32_t ret = ERROR_NONE;
     if (m_rwpkGen)
     {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
         ret = m_rwpkGen->GenerateTilesMergeDirection(viewportIdx, tilesMergeDir);
+        UpdateTimingStats(startTime, ret);
         if (ret)
         {
             LOG(ERROR) << "Failed to generate tiles merge direction !" << std::endl;
@@ -312,4 +400,32 @@ TileArrangement* RegionWisePackingGenerator::GetMergedTilesArrange()
     return tilesArr;
 }
 
+int32_t RegionWisePackingGenerator::SetViewportTiles(
+    uint8_t viewportIdx,
+    uint8_t tilesNum,
+    uint8_t *tilesIdx)
+{
+    int32_t ret = ERROR_NONE;
+    if (m_rwpkGen)
+    {
+        if (!(m_capabilities & OMAF_PACKING_CAP_VIEWPORT_TILES))
+        {
+            LOG(ERROR) << "The plugin doesn't support setting tiles for viewport !" << std::endl;
+            return OMAF_ERROR_UNDEFINED_OPERATION;
+        }
+
+        ret = m_rwpkGen->SetViewportTiles(viewportIdx, tilesNum, tilesIdx);
+        if (ret)
+        {
+            LOG(ERROR) << "Failed to set tiles for viewport " << (uint32_t)viewportIdx << " !" << std::endl;
+        }
+    }
+    else
+    {
+        LOG(ERROR) << "There is no RWPK generator !" << std::endl;
+        ret = OMAF_ERROR_NULL_PTR;
+    }
+    return ret;
+}
+
 VCD_NS_END
@@ -37,15 +37,31 @@
 
 #include <list>
 #include <map>
+#include <chrono>
 
 #include "OmafPackingCommon.h"
 #include "VROmafPacking_data.h"
 #include "definitions.h"
 #include "MediaStream.h"
 #include "OMAFPackingPluginAPI.h"
+#include "MetricsRegistry.h"
 
 VCD_NS_BEGIN
 
+//!
+//! \struct: RWPKGeneratorTimingStats
+//! \brief:  define the timing counters of the plugin calls
+//!          generating region wise packing and tiles merging
+//!          direction
+//!
+typedef struct RWPKGeneratorTimingStats
+{
+    uint64_t calls;    //the number of calls into the plugin
+    uint64_t failures; //the number of failed calls
+    uint64_t totalUs;  //the total time spent in the plugin, in microsecond
+    uint64_t maxUs;    //the longest time spent in one call, in microsecond
+}RWPKGeneratorTimingStats;
+
 //!
 //! \class RegionWisePackingGenerator
 //! \brief Define the basic operation of region wise packing generator
@@ -172,9 +188,78 @@ public:
     //!
     TileArrangement* GetMergedTilesArrange();
 
+    //!
+    //! \brief  Set the high resolution tiles selected for specified
+    //!         viewport into the plugin
+    //!
+    //! \param  [in] viewportIdx
+    //!         the index of specified viewport
+    //! \param  [in] tilesNum
+    //!         the number of selected tiles
+    //! \param  [in] tilesIdx
+    //!         pointer to the indexes of selected tiles in original
+    //!         high resolution picture
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t SetViewportTiles(uint8_t viewportIdx, uint8_t tilesNum, uint8_t *tilesIdx);
+
+    //!
+    //! \brief  Get the capabilities reported by the plugin
+    //!
+    //! \return uint32_t
+    //!         bitmask of OMAF_PACKING_CAP_*
+    //!
+    uint32_t GetCapabilities() { return m_capabilities; };
+
+    //!
+    //! \brief  Get the timing counters of the plugin calls
+    //!
+    //! \return const RWPKGeneratorTimingStats*
+    //!         the pointer to the timing counters
+    //!
+    const RWPKGeneratorTimingStats* GetTimingStats() { return &m_timingStats; };
+
+    //!
+    //! \brief  Set the metrics registry where the plugin calls
+    //!         are measured besides the timing counters
+    //!
+    //! \param  [in] metrics
+    //!         pointer to the metrics registry owned by OmafPackage
+    //!
+    //! \return void
+    //!
+    void SetMetrics(MetricsRegistry *metrics);
+
+private:
+    //!
+    //! \brief  Check the API version of the opened plugin and
+    //!         get its capabilities
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t NegotiatePluginAPI();
+
+    //!
+    //! \brief  Update the timing counters with one plugin call
+    //!
+    //! \param  [in] startTime
+    //!         the time when the call starts
+    //! \param  [in] ret
+    //!         the result of the call
+    //!
+    void UpdateTimingStats(std::chrono::steady_clock::time_point startTime, int32_t ret);
+
 protected:
     void                                    *m_pluginHdl;          //!< pointer to OMAF packing plugin handle
     RegionWisePackingGeneratorBase          *m_rwpkGen;            //!< pointer to detailed RWPK generator class instance corresponding to selected plugin
+    uint32_t                                m_apiVersion;          //!< the API version of the plugin
+    uint32_t                                m_capabilities;        //!< the capabilities reported by the plugin
+    RWPKGeneratorTimingStats                m_timingStats;         //!< the timing counters of the plugin calls
+    MetricHistogram                         *m_pluginCallTime;     //!< time spent in one plugin call
+    MetricCounter                           *m_pluginFailures;     //!< number of failed plugin calls
 };
 
 VCD_NS_END;
@@ -44,6 +44,11 @@ Segmentation::Segmentation()
     m_trackIdStarter = 1;
     m_frameRate.num = 0;
     m_frameRate.den = 0;
+    m_segWriteTime = NULL;
+    m_extractorWriteTime = NULL;
+    m_segCompleteTime = NULL;
+    m_segmentsNum = NULL;
+    m_segmentsBytes = NULL;
 }
 
 Segmentation::Segmentation(
@@ -59,6 +64,11 @@ Segmentation::Segmentation(
     m_trackIdStarter = 1;
     m_frameRate.num = 0;
     m_frameRate.den = 0;
+    m_segWriteTime = NULL;
+    m_extractorWriteTime = NULL;
+    m_segCompleteTime = NULL;
+    m_segmentsNum = NULL;
+    m_segmentsBytes = NULL;
 }
 
 Segmentation::Segmentation(const Segmentation& src)
@@ -71,6 +81,11 @@ Segmentation::Segmentation(const Segmentation& src)
     m_trackIdStarter = src.m_trackIdStarter;
     m_frameRate.num = src.m_frameRate.num;
     m_frameRate.den = src.m_frameRate.den;
+    m_segWriteTime = src.m_segWriteTime;
+    m_extractorWriteTime = src.m_extractorWriteTime;
+    m_segCompleteTime = src.m_segCompleteTime;
+    m_segmentsNum = src.m_segmentsNum;
+    m_segmentsBytes = src.m_segmentsBytes;
 }
 
 Segmentation& Segmentation::operator=(Segmentation&& other)
@@ -83,6 +98,11 @@ Segmentation& Segmentation::operator=(Segmentation&& other)
     m_trackIdStarter = other.m_trackIdStarter;
     m_frameRate.num = other.m_frameRate.num;
     m_frameRate.den = other.m_frameRate.den;
+    m_segWriteTime = other.m_segWriteTime;
+    m_extractorWriteTime = other.m_extractorWriteTime;
+    m_segCompleteTime = other.m_segCompleteTime;
+    m_segmentsNum = other.m_segmentsNum;
+    m_segmentsBytes = other.m_segmentsBytes;
 
     return *this;
 }
@@ -92,4 +112,16 @@ Segmentation::~Segmentation()
     DELETE_MEMORY(m_mpdGen);
 }
 
+void Segmentation::SetMetrics(MetricsRegistry *metrics)
+{
+    if (!metrics)
+        return;
+
+    m_segWriteTime = metrics->Histogram("segment_write_microseconds", "time spent in writing one frame into tile tracks");
+    m_extractorWriteTime = metrics->Histogram("extractor_write_microseconds", "time spent in writing one frame into one extractor track");
+    m_segCompleteTime = metrics->Histogram("segment_complete_microseconds", "interval between completed segments");
+    m_segmentsNum = metrics->Counter("segments_total", "segments written for all tracks");
+    m_segmentsBytes = metrics->Counter("segment_bytes_total", "bytes of segments written for all tracks");
+}
+
 VCD_NS_END
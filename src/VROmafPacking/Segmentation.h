@@ -40,6 +40,7 @@
 #include "MediaStream.h"
 #include "ExtractorTrackManager.h"
 #include "MpdGenerator.h"
+#include "MetricsRegistry.h"
 
 VCD_NS_BEGIN
 
@@ -97,6 +98,17 @@ public:
     //!
     virtual int32_t VideoEndSegmentation() = 0;
 
+    //!
+    //! \brief  Set the metrics registry where the segment
+    //!         writing is measured
+    //!
+    //! \param  [in] metrics
+    //!         pointer to the metrics registry owned by OmafPackage
+    //!
+    //! \return void
+    //!
+    void SetMetrics(MetricsRegistry *metrics);
+
 private:
     //!
     //! \brief  Write povd box for segments,
@@ -115,6 +127,11 @@ protected:
     SegmentationInfo                *m_segInfo;             //!< pointer to the segmentation information
     uint64_t                        m_trackIdStarter;       //!< track index starter
     Rational                        m_frameRate;            //!< the frame rate of the video
+    MetricHistogram                 *m_segWriteTime;        //!< time spent in writing one frame into tile tracks
+    MetricHistogram                 *m_extractorWriteTime;  //!< time spent in writing one frame into extractor track
+    MetricHistogram                 *m_segCompleteTime;     //!< interval between completed segments
+    MetricCounter                   *m_segmentsNum;         //!< number of segments written for all tracks
+    MetricCounter                   *m_segmentsBytes;       //!< size of segments written for all tracks
 };
 
 VCD_NS_END;
@@ -35,6 +35,7 @@
 #define _VROMAFPACKINGAPI_H_
 
 #include "VROmafPacking_data.h"
+#include "MetricsData.h"
 #include "error.h"
 
 #ifdef __cplusplus
@@ -89,6 +90,43 @@ int32_t VROmafPackingWriteSegment(Handler hdl, uint8_t streamIdx, FrameBSInfo *f
 //!
 int32_t VROmafPackingEndStreams(Handler hdl);
 
+//!
+//! \brief  Get the snapshot of VR OMAF Packing library metrics,
+//!         including latency histograms of frame and segment
+//!         writing, counters of frames and segments, and gauges
+//!         of buffered frames of each stream
+//!
+//! \param  [in] hdl
+//!         VR OMAF Packing library handle
+//! \param  [out] values
+//!         the metrics, NULL to query the count of metrics
+//! \param  [in/out] count
+//!         capacity of values as input, count of metrics
+//!         written as output
+//!
+//! \return int32_t
+//!         ERROR_NONE if success, else failed reason
+//!
+int32_t VROmafPackingGetMetrics(Handler hdl, MetricValue *values, int32_t *count);
+
+//!
+//! \brief  Dump VR OMAF Packing library metrics in Prometheus
+//!         text format, names are prefixed with omaf_packing_
+//!
+//! \param  [in] hdl
+//!         VR OMAF Packing library handle
+//! \param  [out] buf
+//!         the text with the terminating '\0', NULL to query
+//!         the size needed
+//! \param  [in/out] size
+//!         size of buf as input, size needed as output
+//!
+//! \return int32_t
+//!         ERROR_NONE if success, OMAF_ERROR_INVALID_DATA if
+//!         buf is too small, else failed reason
+//!
+int32_t VROmafPackingDumpMetrics(Handler hdl, char *buf, uint32_t *size);
+
 //!
 //! \brief  Free VR OMAF Packing library resources
 //!
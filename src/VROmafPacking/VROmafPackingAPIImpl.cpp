@@ -81,6 +81,41 @@ int32_t VROmafPackingEndStreams(Handler hdl)
     return ERROR_NONE;
 }
 
+int32_t VROmafPackingGetMetrics(Handler hdl, MetricValue *values, int32_t *count)
+{
+    OmafPackage *omafPackage = (OmafPackage*)hdl;
+    if (!omafPackage || !count)
+        return OMAF_ERROR_NULL_PTR;
+
+    return omafPackage->GetMetrics(values, count);
+}
+
+int32_t VROmafPackingDumpMetrics(Handler hdl, char *buf, uint32_t *size)
+{
+    OmafPackage *omafPackage = (OmafPackage*)hdl;
+    if (!omafPackage || !size)
+        return OMAF_ERROR_NULL_PTR;
+
+    std::string text = omafPackage->DumpMetrics("omaf_packing_");
+    uint32_t needed = (uint32_t)(text.size() + 1);
+    if (!buf)
+    {
+        *size = needed;
+        return ERROR_NONE;
+    }
+
+    if (*size < needed)
+    {
+        *size = needed;
+        return OMAF_ERROR_INVALID_DATA;
+    }
+
+    memcpy_s(buf, *size, text.c_str(), needed);
+    *size = needed;
+
+    return ERROR_NONE;
+}
+
 int32_t VROmafPackingClose(Handler hdl)
 {
     OmafPackage *omafPackage = (OmafPackage*)hdl;
@@ -32,6 +32,8 @@
 //!
 
 #include "gtest/gtest.h"
+#include <set>
+#include <string>
 #include "../ExtractorTrackManager.h"
 
 VCD_USE_VRVIDEO;
@@ -887,4 +889,157 @@ TEST_F(ExtractorTrackTest, AllProcess)
     fclose(fpDataOffset);
     fpDataOffset = NULL;
 }
+
+TEST_F(ExtractorTrackTest, SharedTracks)
+{
+    std::map<uint8_t, ExtractorTrack*> *extractorTracks = m_extractorTrackMan->GetAllExtractorTracks();
+    EXPECT_TRUE(extractorTracks != NULL);
+    std::map<uint16_t, uint8_t> *viewportTrackMap = m_extractorTrackMan->GetViewportTrackMap();
+    EXPECT_TRUE(viewportTrackMap != NULL);
+    if (!extractorTracks || !viewportTrackMap)
+        return;
+
+    //4x2 high resolution tiles, 2x2 tiles in viewport, so viewport
+    //in bottom row selects the same tiles as the one above it
+    uint8_t tileInRow = (m_initInfo->viewportInfo)->tileInRow;
+    uint16_t viewportNum = tileInRow * (m_initInfo->viewportInfo)->tileInCol;
+    EXPECT_TRUE(viewportNum == 8);
+    EXPECT_TRUE(viewportTrackMap->size() == viewportNum);
+    EXPECT_TRUE(extractorTracks->size() == (size_t)(viewportNum / 2));
+
+    std::map<uint16_t, uint8_t>::iterator itViewport;
+    for (itViewport = viewportTrackMap->begin(); itViewport != viewportTrackMap->end(); itViewport++)
+    {
+        EXPECT_TRUE(itViewport->second == (itViewport->first % tileInRow));
+        EXPECT_TRUE(extractorTracks->find(itViewport->second) != extractorTracks->end());
+    }
+
+    //each extractor track merges a different set of tiles, which are
+    //the 2x2 high resolution tiles from the viewport and all low
+    //resolution tiles
+    std::set<std::set<uint32_t>> tilesSets;
+    std::map<uint8_t, ExtractorTrack*>::iterator it;
+    for (it = extractorTracks->begin(); it != extractorTracks->end(); it++)
+    {
+        std::set<uint32_t> tilesSet;
+        TilesMergeDirectionInCol *tilesMergeDir = it->second->GetTilesMergeDir();
+        std::list<TilesInCol*>::iterator itCol;
+        for (itCol = tilesMergeDir->tilesArrangeInCol.begin();
+            itCol != tilesMergeDir->tilesArrangeInCol.end(); itCol++)
+        {
+            std::list<SingleTile*>::iterator itTile;
+            for (itTile = (*itCol)->begin(); itTile != (*itCol)->end(); itTile++)
+            {
+                tilesSet.insert(((uint32_t)((*itTile)->streamIdxInMedia) << 8) | (*itTile)->origTileIdx);
+            }
+        }
+        EXPECT_TRUE(tilesSets.insert(tilesSet).second);
+
+        uint8_t trackIdx = it->first;
+        uint8_t nextIdx = (trackIdx + 1) % tileInRow;
+        std::set<uint32_t> expectedSet = {
+            (1u << 8) | trackIdx, (1u << 8) | nextIdx,
+            (1u << 8) | (uint32_t)(trackIdx + tileInRow), (1u << 8) | (uint32_t)(nextIdx + tileInRow),
+            0, 1 };
+        EXPECT_TRUE(tilesSet == expectedSet);
+    }
+}
+
+TEST_F(ExtractorTrackTest, PackingPluginMetrics)
+{
+    ASSERT_TRUE(m_extractorTrackMan != NULL);
+
+    MetricsRegistry metrics;
+    ExtractorTrackManager *extractorTrackMan = new ExtractorTrackManager(m_initInfo);
+    extractorTrackMan->SetMetrics(&metrics);
+    int32_t ret = extractorTrackMan->Initialize(&m_streams);
+    EXPECT_TRUE(ret == ERROR_NONE);
+
+    //tiles merging direction for each viewport, and region wise
+    //packing for each viewport with its own extractor track
+    size_t viewportNum = extractorTrackMan->GetViewportTrackMap()->size();
+    size_t tracksNum = extractorTrackMan->GetAllExtractorTracks()->size();
+    MetricHistogram *callTime = metrics.Histogram("packing_plugin_call_microseconds", "");
+    MetricCounter *failures = metrics.Counter("packing_plugin_failures_total", "");
+    ASSERT_TRUE(callTime != NULL);
+    ASSERT_TRUE(failures != NULL);
+    EXPECT_TRUE(callTime->Count() == viewportNum + tracksNum);
+    EXPECT_TRUE(failures->Value() == 0);
+
+    std::string dump = metrics.DumpPrometheus("vromafpacking_");
+    EXPECT_TRUE(dump.find("vromafpacking_packing_plugin_call_microseconds") != std::string::npos);
+
+    DELETE_MEMORY(extractorTrackMan);
+}
+
+//Cube-3x2 input of 6x4 tiles, 2x2 tiles in each 960x960 face
+class CubeMapTilesTest : public testing::Test
+{
+public:
+    void SetTile(uint32_t i, int32_t faceId, int32_t x, int32_t y)
+    {
+        memset_s(&(m_tiles[i]), sizeof(TileDef), 0);
+        m_tiles[i].faceId = faceId;
+        m_tiles[i].x      = x;
+        m_tiles[i].y      = y;
+    }
+
+    TileDef              m_tiles[8];
+    std::vector<uint8_t> m_tilesIdx;
+};
+
+TEST_F(CubeMapTilesTest, MapFaceTilesToPicture)
+{
+    //right column of face 0 and left column of face 1, with one
+    //tile repeated and one without valid face
+    SetTile(0, 0, 480, 0);
+    SetTile(1, 0, 480, 480);
+    SetTile(2, 1, 0, 0);
+    SetTile(3, 1, 0, 480);
+    SetTile(4, 1, 0, 480);
+    SetTile(5, -1, 0, 0);
+    int32_t ret = ExtractorTrackGenerator::MapCubeMapTiles(m_tiles, 6, 6, 4, 960, 960, 4, 0, m_tilesIdx);
+    EXPECT_TRUE(ret == ERROR_NONE);
+    std::vector<uint8_t> expected = { 1, 2, 7, 8 };
+    EXPECT_TRUE(m_tilesIdx == expected);
+
+    //face 3 is the first face in the second row of faces
+    SetTile(0, 3, 0, 480);
+    SetTile(1, 5, 480, 0);
+    ret = ExtractorTrackGenerator::MapCubeMapTiles(m_tiles, 2, 6, 4, 960, 960, 2, 0, m_tilesIdx);
+    EXPECT_TRUE(ret == ERROR_NONE);
+    expected = { 17, 18 };
+    EXPECT_TRUE(m_tilesIdx == expected);
+}
+
+TEST_F(CubeMapTilesTest, FillToTilesNumInViewport)
+{
+    //the following tiles are filled after the first selected tile
+    SetTile(0, 2, 480, 0);
+    int32_t ret = ExtractorTrackGenerator::MapCubeMapTiles(m_tiles, 1, 6, 4, 960, 960, 4, 0, m_tilesIdx);
+    EXPECT_TRUE(ret == ERROR_NONE);
+    std::vector<uint8_t> expected = { 5, 6, 7, 8 };
+    EXPECT_TRUE(m_tilesIdx == expected);
+
+    //without valid tile, filled from the given tile and wrapped
+    SetTile(0, -1, 0, 0);
+    ret = ExtractorTrackGenerator::MapCubeMapTiles(m_tiles, 1, 6, 4, 960, 960, 4, 22, m_tilesIdx);
+    EXPECT_TRUE(ret == ERROR_NONE);
+    expected = { 0, 1, 22, 23 };
+    EXPECT_TRUE(m_tilesIdx == expected);
+}
+
+TEST_F(CubeMapTilesTest, InvalidTilesSplit)
+{
+    SetTile(0, 0, 0, 0);
+    //faces don't have the same tiles split
+    int32_t ret = ExtractorTrackGenerator::MapCubeMapTiles(m_tiles, 1, 4, 4, 960, 960, 4, 0, m_tilesIdx);
+    EXPECT_TRUE(ret == OMAF_ERROR_SCVP_INCORRECT_RESULT);
+    //more tiles in viewport than in picture
+    ret = ExtractorTrackGenerator::MapCubeMapTiles(m_tiles, 1, 3, 2, 960, 960, 8, 0, m_tilesIdx);
+    EXPECT_TRUE(ret == OMAF_ERROR_SCVP_INCORRECT_RESULT);
+    ret = ExtractorTrackGenerator::MapCubeMapTiles(NULL, 1, 6, 4, 960, 960, 4, 0, m_tilesIdx);
+    EXPECT_TRUE(ret == OMAF_ERROR_NULL_PTR);
+}
+
 }
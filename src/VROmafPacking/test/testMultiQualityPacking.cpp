@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//!
+//! \file:   testMultiQualityPacking.cpp
+//! \brief:  Multiple quality layers packing plugin unit test, and
+//!          packed size and bitrate comparison against the plugin
+//!          for high resolution plus full low resolution packing
+//!
+
+#include "gtest/gtest.h"
+#include <dlfcn.h>
+#include <string.h>
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+#include "OMAFPackingPluginAPI.h"
+
+namespace {
+
+#define LAYER_NUM 3
+
+//8K in viewport, 4K around viewport, 2.5K for full sphere
+const uint32_t layerWidth[LAYER_NUM]   = { 7680, 3840, 2560 };
+const uint32_t layerHeight[LAYER_NUM]  = { 3840, 1920, 1280 };
+const uint8_t  layerTileCols[LAYER_NUM] = { 12, 6, 4 };
+const uint8_t  layerTileRows[LAYER_NUM] = { 6, 3, 2 };
+const uint64_t layerBitRate[LAYER_NUM] = { 40000000, 12000000, 5000000 };
+
+//packing statistics over all viewports
+typedef struct PackingStats
+{
+    uint32_t packedWidth;
+    uint32_t packedHeight;
+    double   avgBitRate;      //bitrate estimated from the packed area of each layer
+    double   avgNearCoverage; //ratio of the sphere covered by layers better than background
+    double   usPerViewport;   //time to generate RWPK and merging direction for one viewport
+}PackingStats;
+
+class MultiQualityPackingTest : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+        for (uint8_t layerIdx = 0; layerIdx < LAYER_NUM; layerIdx++)
+        {
+            RegionWisePacking *rwpk = new RegionWisePacking;
+            memset(rwpk, 0, sizeof(RegionWisePacking));
+            rwpk->numRegions    = layerTileCols[layerIdx] * layerTileRows[layerIdx];
+            rwpk->projPicWidth  = layerWidth[layerIdx];
+            rwpk->projPicHeight = layerHeight[layerIdx];
+            rwpk->packedPicWidth  = layerWidth[layerIdx];
+            rwpk->packedPicHeight = layerHeight[layerIdx];
+            rwpk->rectRegionPacking = new RectangularRegionWisePacking[rwpk->numRegions];
+
+            uint32_t tileWidth  = layerWidth[layerIdx] / layerTileCols[layerIdx];
+            uint32_t tileHeight = layerHeight[layerIdx] / layerTileRows[layerIdx];
+            for (uint8_t i = 0; i < rwpk->numRegions; i++)
+            {
+                RectangularRegionWisePacking *rect = &(rwpk->rectRegionPacking[i]);
+                memset(rect, 0, sizeof(RectangularRegionWisePacking));
+                rect->projRegWidth    = tileWidth;
+                rect->projRegHeight   = tileHeight;
+                rect->projRegTop      = (i / layerTileCols[layerIdx]) * tileHeight;
+                rect->projRegLeft     = (i % layerTileCols[layerIdx]) * tileWidth;
+                rect->packedRegWidth  = tileWidth;
+                rect->packedRegHeight = tileHeight;
+                rect->packedRegTop    = rect->projRegTop;
+                rect->packedRegLeft   = rect->projRegLeft;
+            }
+            m_rwpks[layerIdx] = rwpk;
+
+            VideoStreamInfo *vsInfo = new VideoStreamInfo;
+            vsInfo->tilesNumInRow = layerTileCols[layerIdx];
+            vsInfo->tilesNumInCol = layerTileRows[layerIdx];
+            vsInfo->srcRWPK       = rwpk;
+            m_infos[layerIdx]     = vsInfo;
+        }
+
+        //4x2 tiles of 8K video in viewport
+        m_tilesNumInViewport  = 8;
+        m_finalViewportWidth  = 2560;
+        m_finalViewportHeight = 1280;
+        m_tilesInViewport = new TileDef[m_tilesNumInViewport];
+        memset(m_tilesInViewport, 0, m_tilesNumInViewport * sizeof(TileDef));
+    }
+
+    virtual void TearDown()
+    {
+        for (uint8_t layerIdx = 0; layerIdx < LAYER_NUM; layerIdx++)
+        {
+            delete [] m_rwpks[layerIdx]->rectRegionPacking;
+            delete m_rwpks[layerIdx];
+            m_rwpks[layerIdx] = NULL;
+            delete m_infos[layerIdx];
+            m_infos[layerIdx] = NULL;
+        }
+        delete [] m_tilesInViewport;
+        m_tilesInViewport = NULL;
+    }
+
+    //create the generator from plugin, with the specified layers
+    RegionWisePackingGeneratorBase* CreateGenerator(
+        const char *pluginName,
+        std::vector<uint8_t> layers,
+        void **pluginHdl)
+    {
+        std::string libName = std::string("/usr/local/lib/lib") + pluginName + ".so";
+        *pluginHdl = dlopen(libName.c_str(), RTLD_LAZY);
+        if (!(*pluginHdl))
+            return NULL;
+
+        CreateRWPKGenerator *createRWPKGen = (CreateRWPKGenerator*)dlsym(*pluginHdl, "Create");
+        if (!createRWPKGen)
+            return NULL;
+
+        RegionWisePackingGeneratorBase *rwpkGen = createRWPKGen();
+        if (!rwpkGen)
+            return NULL;
+
+        std::map<uint8_t, VideoStreamInfo*> streams;
+        uint8_t videoIdxInMedia[LAYER_NUM];
+        for (uint8_t i = 0; i < layers.size(); i++)
+        {
+            streams.insert(std::make_pair(layers[i], m_infos[layers[i]]));
+            videoIdxInMedia[i] = layers[i];
+        }
+
+        int32_t ret = rwpkGen->Initialize(
+            &streams, videoIdxInMedia,
+            m_tilesNumInViewport, m_tilesInViewport,
+            m_finalViewportWidth, m_finalViewportHeight);
+        if (ret)
+        {
+            DestroyGenerator(rwpkGen, *pluginHdl);
+            return NULL;
+        }
+
+        return rwpkGen;
+    }
+
+    void DestroyGenerator(RegionWisePackingGeneratorBase *rwpkGen, void *pluginHdl)
+    {
+        DestroyRWPKGenerator *destroyRWPKGen = (DestroyRWPKGenerator*)dlsym(pluginHdl, "Destroy");
+        if (destroyRWPKGen)
+            destroyRWPKGen(rwpkGen);
+        dlclose(pluginHdl);
+    }
+
+    void ReleaseMergeDirection(TilesMergeDirectionInCol *tilesMergeDir)
+    {
+        std::list<TilesInCol*>::iterator itCol;
+        for (itCol = tilesMergeDir->tilesArrangeInCol.begin(); itCol != tilesMergeDir->tilesArrangeInCol.end(); itCol++)
+        {
+            TilesInCol *tileCol = *itCol;
+            std::list<SingleTile*>::iterator itTile;
+            for (itTile = tileCol->begin(); itTile != tileCol->end(); itTile++)
+            {
+                delete *itTile;
+            }
+            delete tileCol;
+        }
+        tilesMergeDir->tilesArrangeInCol.clear();
+    }
+
+    //run through all viewports and check the packing is valid
+    void RunAllViewports(RegionWisePackingGeneratorBase *rwpkGen, PackingStats *stats)
+    {
+        uint16_t viewportsNum = layerTileCols[0] * layerTileRows[0];
+        uint32_t topTileWidth  = layerWidth[0] / layerTileCols[0];
+        uint32_t topTileHeight = layerHeight[0] / layerTileRows[0];
+        double bitRateSum  = 0;
+        double coverageSum = 0;
+        double usSum       = 0;
+
+        for (uint16_t viewportIdx = 0; viewportIdx < viewportsNum; viewportIdx++)
+        {
+            RegionWisePacking dstRwpk;
+            memset(&dstRwpk, 0, sizeof(RegionWisePacking));
+            TilesMergeDirectionInCol tilesMergeDir;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            EXPECT_EQ(rwpkGen->GenerateDstRwpk(viewportIdx, &dstRwpk), 0);
+            EXPECT_EQ(rwpkGen->GenerateTilesMergeDirection(viewportIdx, &tilesMergeDir), 0);
+            usSum += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+            uint32_t packedWidth  = rwpkGen->GetPackedPicWidth();
+            uint32_t packedHeight = rwpkGen->GetPackedPicHeight();
+            EXPECT_EQ(dstRwpk.packedPicWidth, packedWidth);
+            EXPECT_EQ(dstRwpk.packedPicHeight, packedHeight);
+
+            uint32_t tilesNum = 0;
+            std::list<TilesInCol*>::iterator itCol;
+            for (itCol = tilesMergeDir.tilesArrangeInCol.begin(); itCol != tilesMergeDir.tilesArrangeInCol.end(); itCol++)
+            {
+                tilesNum += (*itCol)->size();
+            }
+            EXPECT_EQ(tilesNum, dstRwpk.numRegions);
+
+            std::vector<bool> packedCovered((packedWidth / 64) * (packedHeight / 64), false);
+            std::vector<bool> nearCovered(layerTileCols[0] * layerTileRows[0], false);
+            for (uint8_t i = 0; i < dstRwpk.numRegions; i++)
+            {
+                RectangularRegionWisePacking *rect = &(dstRwpk.rectRegionPacking[i]);
+                EXPECT_LE(rect->packedRegLeft + rect->packedRegWidth, packedWidth);
+                EXPECT_LE(rect->packedRegTop + rect->packedRegHeight, packedHeight);
+
+                //regions don't overlap in tiles merged picture
+                for (uint32_t y = rect->packedRegTop / 64; y < (uint32_t)(rect->packedRegTop + rect->packedRegHeight) / 64; y++)
+                {
+                    for (uint32_t x = rect->packedRegLeft / 64; x < (uint32_t)(rect->packedRegLeft + rect->packedRegWidth) / 64; x++)
+                    {
+                        EXPECT_FALSE(packedCovered[y * (packedWidth / 64) + x]);
+                        packedCovered[y * (packedWidth / 64) + x] = true;
+                    }
+                }
+
+                uint8_t layerIdx = 0;
+                while (layerIdx < LAYER_NUM - 1 &&
+                    (layerWidth[layerIdx] * rect->projRegWidth != layerWidth[0] * rect->packedRegWidth))
+                {
+                    layerIdx++;
+                }
+                bitRateSum += (double)(layerBitRate[layerIdx]) * rect->packedRegWidth * rect->packedRegHeight /
+                              ((double)(layerWidth[layerIdx]) * layerHeight[layerIdx]);
+
+                if (layerIdx < LAYER_NUM - 1)
+                {
+                    for (uint32_t y = rect->projRegTop / topTileHeight; y < (rect->projRegTop + rect->projRegHeight) / topTileHeight; y++)
+                    {
+                        for (uint32_t x = rect->projRegLeft / topTileWidth; x < (rect->projRegLeft + rect->projRegWidth) / topTileWidth; x++)
+                        {
+                            nearCovered[y * layerTileCols[0] + x] = true;
+                        }
+                    }
+                }
+            }
+
+            uint32_t nearTiles = 0;
+            for (uint32_t i = 0; i < nearCovered.size(); i++)
+            {
+                if (nearCovered[i])
+                    nearTiles++;
+            }
+            coverageSum += (double)nearTiles / nearCovered.size();
+
+            delete [] dstRwpk.rectRegionPacking;
+            ReleaseMergeDirection(&tilesMergeDir);
+        }
+
+        stats->packedWidth     = rwpkGen->GetPackedPicWidth();
+        stats->packedHeight    = rwpkGen->GetPackedPicHeight();
+        stats->avgBitRate      = bitRateSum / viewportsNum;
+        stats->avgNearCoverage = coverageSum / viewportsNum;
+        stats->usPerViewport   = usSum / viewportsNum;
+    }
+
+    RegionWisePacking *m_rwpks[LAYER_NUM];
+    VideoStreamInfo   *m_infos[LAYER_NUM];
+    uint8_t           m_tilesNumInViewport;
+    TileDef           *m_tilesInViewport;
+    int32_t           m_finalViewportWidth;
+    int32_t           m_finalViewportHeight;
+};
+
+TEST_F(MultiQualityPackingTest, ThreeLayersPacking)
+{
+    void *pluginHdl = NULL;
+    std::vector<uint8_t> layers = { 0, 1, 2 };
+    RegionWisePackingGeneratorBase *rwpkGen = CreateGenerator("MultiQualityLayersPacking", layers, &pluginHdl);
+    ASSERT_TRUE(rwpkGen != NULL);
+
+    //4 columns for viewport, 6 columns for 4x3 tiles around, 4 columns for background
+    EXPECT_EQ(rwpkGen->GetTilesNumInViewportRow(), 4);
+    EXPECT_EQ(rwpkGen->GetTileRowNumInViewport(), 2);
+    EXPECT_EQ(rwpkGen->GetPackedPicWidth(), (uint32_t)8960);
+    EXPECT_EQ(rwpkGen->GetPackedPicHeight(), (uint32_t)1280);
+
+    TileArrangement *tilesArr = rwpkGen->GetMergedTilesArrange();
+    ASSERT_TRUE(tilesArr != NULL);
+    EXPECT_EQ(tilesArr->tileRowsNum, 1);
+    EXPECT_EQ(tilesArr->tileColsNum, 14);
+
+    RegionWisePacking dstRwpk;
+    memset(&dstRwpk, 0, sizeof(RegionWisePacking));
+    EXPECT_EQ(rwpkGen->GenerateDstRwpk(0, &dstRwpk), 0);
+    EXPECT_EQ(dstRwpk.numRegions, 8 + 12 + 8);
+
+    //the middle layer covers the viewport
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        RectangularRegionWisePacking *highRect = &(dstRwpk.rectRegionPacking[i]);
+        bool covered = false;
+        for (uint8_t j = 8; j < 20; j++)
+        {
+            RectangularRegionWisePacking *midRect = &(dstRwpk.rectRegionPacking[j]);
+            if (highRect->projRegLeft >= midRect->projRegLeft &&
+                highRect->projRegLeft + highRect->projRegWidth <= midRect->projRegLeft + midRect->projRegWidth &&
+                highRect->projRegTop >= midRect->projRegTop &&
+                highRect->projRegTop + highRect->projRegHeight <= midRect->projRegTop + midRect->projRegHeight)
+            {
+                covered = true;
+                break;
+            }
+        }
+        EXPECT_TRUE(covered);
+    }
+    delete [] dstRwpk.rectRegionPacking;
+
+    PackingStats stats;
+    RunAllViewports(rwpkGen, &stats);
+
+    DestroyGenerator(rwpkGen, pluginHdl);
+}
+
+TEST_F(MultiQualityPackingTest, CompareWithTwoLayers)
+{
+    void *pluginHdl = NULL;
+    std::vector<uint8_t> twoLayers = { 0, 2 };
+    RegionWisePackingGeneratorBase *rwpkGen = CreateGenerator("HighResPlusFullLowResPacking", twoLayers, &pluginHdl);
+    ASSERT_TRUE(rwpkGen != NULL);
+
+    PackingStats twoLayersStats;
+    RunAllViewports(rwpkGen, &twoLayersStats);
+    DestroyGenerator(rwpkGen, pluginHdl);
+
+    std::vector<uint8_t> threeLayers = { 0, 1, 2 };
+    rwpkGen = CreateGenerator("MultiQualityLayersPacking", threeLayers, &pluginHdl);
+    ASSERT_TRUE(rwpkGen != NULL);
+
+    PackingStats threeLayersStats;
+    RunAllViewports(rwpkGen, &threeLayersStats);
+    DestroyGenerator(rwpkGen, pluginHdl);
+
+    printf("two layers   : packed %dx%d, bitrate %.2f Mbps, near view coverage %.1f%%, %.2f us per viewport\n",
+        twoLayersStats.packedWidth, twoLayersStats.packedHeight, twoLayersStats.avgBitRate / 1000000,
+        twoLayersStats.avgNearCoverage * 100, twoLayersStats.usPerViewport);
+    printf("three layers : packed %dx%d, bitrate %.2f Mbps, near view coverage %.1f%%, %.2f us per viewport\n",
+        threeLayersStats.packedWidth, threeLayersStats.packedHeight, threeLayersStats.avgBitRate / 1000000,
+        threeLayersStats.avgNearCoverage * 100, threeLayersStats.usPerViewport);
+
+    //the middle layer widens the covered area at a fraction of the highest quality bitrate
+    EXPECT_GT(threeLayersStats.avgNearCoverage, twoLayersStats.avgNearCoverage);
+    EXPECT_GT(threeLayersStats.avgBitRate, twoLayersStats.avgBitRate);
+    EXPECT_LT(threeLayersStats.avgBitRate - twoLayersStats.avgBitRate, (double)(layerBitRate[1]));
+}
+
+TEST_F(MultiQualityPackingTest, CubeMapViewportTiles)
+{
+    void *pluginHdl = NULL;
+    std::vector<uint8_t> twoLayers = { 0, 2 };
+    RegionWisePackingGeneratorBase *rwpkGen = CreateGenerator("HighResPlusFullLowResPacking", twoLayers, &pluginHdl);
+    ASSERT_TRUE(rwpkGen != NULL);
+    EXPECT_TRUE(rwpkGen->GetCapabilities() & OMAF_PACKING_CAP_VIEWPORT_TILES);
+
+    //taken as Cube-3x2 with 4x3 tiles in each face, the tiles cross
+    //the border of face 0 and face 1, and the one of face 0 and face 3
+    uint8_t tilesIdx[8] = { 3, 4, 15, 16, 24, 25, 36, 37 };
+    std::set<uint8_t> selectedTiles(tilesIdx, tilesIdx + 8);
+    EXPECT_EQ(rwpkGen->SetViewportTiles(0, 8, tilesIdx), 0);
+    EXPECT_EQ(rwpkGen->SetViewportTiles(1, 4, tilesIdx), OMAF_ERROR_INVALID_DATA);
+
+    TilesMergeDirectionInCol tilesMergeDir;
+    EXPECT_EQ(rwpkGen->GenerateTilesMergeDirection(0, &tilesMergeDir), 0);
+    std::set<uint8_t> mergedTiles;
+    std::list<TilesInCol*>::iterator itCol;
+    for (itCol = tilesMergeDir.tilesArrangeInCol.begin(); itCol != tilesMergeDir.tilesArrangeInCol.end(); itCol++)
+    {
+        std::list<SingleTile*>::iterator itTile;
+        for (itTile = (*itCol)->begin(); itTile != (*itCol)->end(); itTile++)
+        {
+            if ((*itTile)->streamIdxInMedia == 0)
+                mergedTiles.insert((*itTile)->origTileIdx);
+        }
+    }
+    EXPECT_EQ(mergedTiles, selectedTiles);
+    ReleaseMergeDirection(&tilesMergeDir);
+
+    RegionWisePacking dstRwpk;
+    memset(&dstRwpk, 0, sizeof(RegionWisePacking));
+    EXPECT_EQ(rwpkGen->GenerateDstRwpk(0, &dstRwpk), 0);
+    uint32_t tileWidth  = layerWidth[0] / layerTileCols[0];
+    uint32_t tileHeight = layerHeight[0] / layerTileRows[0];
+    std::set<uint8_t> packedTiles;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        RectangularRegionWisePacking *rect = &(dstRwpk.rectRegionPacking[i]);
+        EXPECT_EQ(rect->projRegWidth, tileWidth);
+        EXPECT_EQ(rect->projRegHeight, tileHeight);
+        packedTiles.insert((uint8_t)((rect->projRegTop / tileHeight) * layerTileCols[0] + rect->projRegLeft / tileWidth));
+    }
+    EXPECT_EQ(packedTiles, selectedTiles);
+    delete [] dstRwpk.rectRegionPacking;
+
+    DestroyGenerator(rwpkGen, pluginHdl);
+
+    //the plugin without the capability doesn't take the tiles
+    std::vector<uint8_t> threeLayers = { 0, 1, 2 };
+    rwpkGen = CreateGenerator("MultiQualityLayersPacking", threeLayers, &pluginHdl);
+    ASSERT_TRUE(rwpkGen != NULL);
+    EXPECT_FALSE(rwpkGen->GetCapabilities() & OMAF_PACKING_CAP_VIEWPORT_TILES);
+    EXPECT_EQ(rwpkGen->SetViewportTiles(0, 8, tilesIdx), OMAF_ERROR_UNDEFINED_OPERATION);
+    DestroyGenerator(rwpkGen, pluginHdl);
+}
+
+}
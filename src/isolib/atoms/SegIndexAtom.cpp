@@ -68,7 +68,9 @@ std::vector<SegmentIndexAtom::Reference> SegmentIndexAtom::GetReferences() const
 void SegmentIndexAtom::ToStream(Stream& str)
 {
     const uint32_t referenceSize = 3 * 4;
-    const uint32_t reserveBytes  = static_cast<uint32_t>((m_reserveTotal - m_references.size()) * referenceSize);
+    const uint32_t reserveBytes  = (m_reserveTotal > m_references.size())
+                                      ? static_cast<uint32_t>((m_reserveTotal - m_references.size()) * referenceSize)
+                                      : 0;
 
     WriteFullAtomHeader(str);
     str.Write32(m_referenceID);
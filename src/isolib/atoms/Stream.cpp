@@ -121,6 +121,11 @@ void Stream::Clear()
     m_storage.clear();
 }
 
+void Stream::Reserve(const std::uint64_t extraSize)
+{
+    m_storage.reserve(static_cast<std::size_t>(m_storage.size() + extraSize));
+}
+
 void Stream::SkipBytes(const std::uint64_t x)
 {
     m_byteOffset += x;
@@ -177,38 +182,35 @@ void Stream::Write8(const std::uint8_t bits)
 
 void Stream::Write16(const std::uint16_t bits)
 {
-    for (int i=8;i>=0;)
-    {
-        m_storage.push_back(static_cast<uint8_t>((bits >> i) & 0xff));
-        i -= 8;
-    }
+    const std::uint8_t bytes[2] = {static_cast<uint8_t>((bits >> 8) & 0xff), static_cast<uint8_t>(bits & 0xff)};
+    m_storage.insert(m_storage.end(), bytes, bytes + sizeof(bytes));
 }
 
 void Stream::Write24(const std::uint32_t bits)
 {
-    for (int i=16;i>=0;)
-    {
-        m_storage.push_back(static_cast<uint8_t>((bits >> i) & 0xff));
-        i -= 8;
-    }
+    const std::uint8_t bytes[3] = {static_cast<uint8_t>((bits >> 16) & 0xff),
+                                   static_cast<uint8_t>((bits >> 8) & 0xff),
+                                   static_cast<uint8_t>(bits & 0xff)};
+    m_storage.insert(m_storage.end(), bytes, bytes + sizeof(bytes));
 }
 
 void Stream::Write32(const std::uint32_t bits)
 {
-    for (int i=24;i>=0;)
-    {
-        m_storage.push_back(static_cast<uint8_t>((bits >> i) & 0xff));
-        i -= 8;
-    }
+    const std::uint8_t bytes[4] = {static_cast<uint8_t>((bits >> 24) & 0xff),
+                                   static_cast<uint8_t>((bits >> 16) & 0xff),
+                                   static_cast<uint8_t>((bits >> 8) & 0xff),
+                                   static_cast<uint8_t>(bits & 0xff)};
+    m_storage.insert(m_storage.end(), bytes, bytes + sizeof(bytes));
 }
 
 void Stream::Write64(const std::uint64_t bits)
 {
-    for (int i=56;i>=0;)
+    std::uint8_t bytes[8];
+    for (int i = 0; i < 8; i++)
     {
-        m_storage.push_back(static_cast<uint8_t>((bits >> i) & 0xff));
-        i -= 8;
+        bytes[i] = static_cast<uint8_t>((bits >> (56 - 8 * i)) & 0xff);
     }
+    m_storage.insert(m_storage.end(), bytes, bytes + sizeof(bytes));
 }
 
 void Stream::WriteArray(const std::vector<std::uint8_t>& bits,
@@ -263,18 +265,12 @@ void Stream::WriteString(const std::string& srcString)
         LOG(WARNING) << "Stream::WriteString called for zero-length string." << std::endl;
     }
 
-    for (const auto character : srcString)
-    {
-        m_storage.push_back(static_cast<unsigned char>(character));
-    }
+    m_storage.insert(m_storage.end(), srcString.begin(), srcString.end());
 }
 
 void Stream::WriteZeroEndString(const std::string& srcString)
 {
-    for (const auto character : srcString)
-    {
-        m_storage.push_back(static_cast<unsigned char>(character));
-    }
+    m_storage.insert(m_storage.end(), srcString.begin(), srcString.end());
     m_storage.push_back('\0');
 }
 
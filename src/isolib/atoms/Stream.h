@@ -112,6 +112,17 @@ public:
     //!
     void Clear();
 
+    //!
+    //! \brief    Reserve room for the bytes to be written, so the
+    //!           following writes don't reallocate the storage
+    //!
+    //! \param    [in] std::uint64_t
+    //!           extraSize
+    //!
+    //! \return   void
+    //!
+    void Reserve(std::uint64_t extraSize);
+
     //!
     //! \brief    Skip Bytes
     //!
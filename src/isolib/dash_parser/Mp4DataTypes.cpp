@@ -103,6 +103,7 @@ template struct VarLenArray<FourCC>;
 template struct VarLenArray<TStampID>;
 template struct VarLenArray<TypeToTrackIDs>;
 template struct VarLenArray<TrackSampInfo>;
+template struct VarLenArray<SampDescriptor>;
 template struct VarLenArray<TrackInformation>;
 template struct VarLenArray<SegInfo>;
 template struct VarLenArray<RWPKRegion>;
@@ -345,6 +345,18 @@ struct TrackSampInfo
     uint64_t earliestTStampTS;
 };
 
+struct SampDescriptor
+{
+    uint32_t sampleId;
+    uint32_t segmentId;
+    uint64_t dataOffset;
+    uint32_t dataLength;
+    uint64_t presentTimeTS;
+    bool isSyncSample;
+    uint32_t sampleDescriptionIndex;
+    FourCC codeType;
+};
+
 struct RatValue
 {
     uint64_t num;
@@ -686,6 +698,7 @@ struct TrackDecInfo
 {
     ItemId itemIdBase;
     SampleInfoVector samples;
+    vector<SampDescriptor> sampTable;  ///< flat copy of samples, built at the first access
 
     DecodePts::PresentTimeTS durationTS    = 0;
     DecodePts::PresentTimeTS earliestPTSTS = 0;
@@ -782,6 +795,17 @@ struct ExtSample
     vector<Extractor> extractors;
 };
 
+// one constructor of the extractor sample, the referenced track is resolved by the reader
+struct ExtConstruct
+{
+    bool isInline              = false;
+    uint8_t trackRefIndex      = 0;
+    InitSegmentTrackId refTrack;
+    uint32_t dataOffset        = 0;
+    uint32_t dataLength        = 0;
+    const char* inlineData     = NULL;  ///< points into the extractor sample
+};
+
 struct Hvc2ExtractorNal
 {
     ExtNalHdr extNalHdr = {};
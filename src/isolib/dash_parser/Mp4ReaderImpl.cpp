@@ -514,6 +514,8 @@ int32_t Mp4Reader::ParseInitSeg(StreamIO* strIO, uint32_t initSegId)
         }
 
         RefreshCompTimes(initSegmentId, segIndex);
+        GenSampTables(initSegmentId, segIndex);
+        RegRefTrack(initSegmentId);
 
         if ((!io.strIO->IsStreamGood()) && (!io.strIO->IsReachEOS()))
         {
@@ -542,6 +544,7 @@ int32_t Mp4Reader::DisableInitSeg(uint32_t initSegId)
             m_ctxInfoMap.erase(InitSegmentTrackId(initSegId, basicTrackInfo.first));
         }
         m_initSegProps.erase(initSegId);
+        UnregRefTracks(initSegId);
     }
     return (isInitSegment) ? ERROR_NONE : OMAF_INVALID_SEGMENT;
 }
@@ -709,6 +712,7 @@ int32_t Mp4Reader::ParseSeg(StreamIO* strIO,
         }
 
         RefreshCompTimes(initSegId, segIndex);
+        GenSampTables(initSegId, segIndex);
 
         if ((!io.strIO->IsStreamGood()) && (!io.strIO->IsReachEOS()))
         {
@@ -3258,170 +3262,504 @@ int32_t Mp4Reader::GetSegIndex(InitSegTrackIdPair id, SegmentId& segIndex) const
     return GetSegIndex(id.first, id.second, segIndex);
 }
 
-int32_t Mp4Reader::GetSampDataInfo(uint32_t ctxId,
-                                               uint32_t itemIndex,
-                                               const InitSegmentId& initSegId,
-                                               uint64_t& refSampLength,
-                                               uint64_t& refDataOffset)
+void Mp4Reader::GenSampTables(InitSegmentId initSegId, SegmentId segIndex)
 {
-    auto trackCtxId = ContextId(ctxId);
-    if (!(m_initSegProps[initSegId].trackProperties[trackCtxId].referenceTrackIds["scal"].empty()))
+    auto& segProps = m_initSegProps.at(initSegId).segPropMap.at(segIndex);
+    for (auto& decInfo : segProps.trackDecInfos)
     {
-        return OMAF_INVALID_PROPERTY_INDEX;
+        InitSegmentTrackId trackIdPair = make_pair(initSegId, decInfo.first);
+        TrackDecInfo& trackDecInfo     = decInfo.second;
+
+        trackDecInfo.sampTable.clear();
+        trackDecInfo.sampTable.reserve(trackDecInfo.samples.size());
+        for (const auto& sample : trackDecInfo.samples)
+        {
+            SampDescriptor sampDesc;
+            sampDesc.sampleId               = sample.sampleId;
+            sampDesc.segmentId              = segIndex.GetIndex();
+            sampDesc.dataOffset             = sample.dataOffset;
+            sampDesc.dataLength             = sample.dataLength;
+            sampDesc.presentTimeTS          = sample.compositionTimesTS.size() ? sample.compositionTimesTS.at(0) : 0;
+            sampDesc.isSyncSample           = (sample.sampleType == OUTPUT_REF_FRAME);
+            sampDesc.sampleDescriptionIndex = sample.sampleDescriptionIndex.GetIndex();
+
+            // same as GetDecoderCodeType, left empty if not resolved
+            const auto& decCodeType = trackDecInfo.decoderCodeTypeMap;
+            auto iter               = decCodeType.find(ItemId(sample.sampleId));
+            if (iter == decCodeType.end())
+            {
+                const auto parameterSetIdIt = segProps.itemToParameterSetMap.find(
+                    InitSegTrackIdPair(trackIdPair, ItemId(sample.sampleId) - trackDecInfo.itemIdBase));
+                if (parameterSetIdIt != segProps.itemToParameterSetMap.end())
+                {
+                    iter = decCodeType.find(ItemId(parameterSetIdIt->second.GetIndex()));
+                }
+            }
+            if (iter != decCodeType.end())
+            {
+                sampDesc.codeType = iter->second.GetUInt32();
+            }
+            trackDecInfo.sampTable.push_back(sampDesc);
+        }
     }
+}
 
-    InitSegmentTrackId neededInitSegTrackId = make_pair(initSegId, trackCtxId);
+int32_t Mp4Reader::GetSampDesc(InitSegmentTrackId initSegTrackId,
+                                 uint32_t itemIndex,
+                                 SampTableCursor& cursor,
+                                 const SampDescriptor*& sampDesc,
+                                 SegmentIO** io) const
+{
+    if (cursor.sampTable == NULL || cursor.trackId != initSegTrackId || itemIndex < cursor.itemIdBase ||
+        itemIndex - cursor.itemIdBase >= cursor.sampTable->size())
+    {
+        SegmentId segIndex;
+        int32_t result = GetSegIndex(initSegTrackId, itemIndex, segIndex);
+        if (result != ERROR_NONE)
+        {
+            return result;
+        }
 
-    SegmentId segIndex;
-    int32_t result = GetSegIndex(neededInitSegTrackId, itemIndex, segIndex);
-    if (result != ERROR_NONE)
+        auto& segProps           = m_initSegProps.at(initSegTrackId.first).segPropMap.at(segIndex);
+        const auto& trackDecInfo = segProps.trackDecInfos.at(initSegTrackId.second);
+        if (trackDecInfo.sampTable.size() != trackDecInfo.samples.size())
+        {
+            return OMAF_INVALID_ITEM_ID;
+        }
+
+        cursor.trackId    = initSegTrackId;
+        cursor.segmentId  = segIndex;
+        cursor.itemIdBase = trackDecInfo.itemIdBase.GetIndex();
+        cursor.sampTable  = &trackDecInfo.sampTable;
+        cursor.io         = const_cast<SegmentIO*>(&segProps.io);
+    }
+
+    sampDesc = &(*cursor.sampTable)[itemIndex - cursor.itemIdBase];
+    if (io)
     {
-        return result;
+        *io = cursor.io;
     }
-    SegmentTrackId segTrackId = make_pair(segIndex, neededInitSegTrackId.second);
-    ItemId itemId             = ItemId(itemIndex) - GetTrackDecInfo(initSegId, segTrackId).itemIdBase;
+    return ERROR_NONE;
+}
 
-    refDataOffset   = GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataOffset;
-    refSampLength = GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataLength;
+int32_t Mp4Reader::GetSegSampDescs(uint32_t trackId,
+                                       uint32_t segIndex,
+                                       VarLenArray<SampDescriptor>& sampDescs)
+{
+    if (IsInitErr())
+    {
+        return OMAF_MP4READER_NOT_INITIALIZED;
+    }
 
+    InitSegmentTrackId trackIdPair = MakeIdPair(trackId);
+    InitSegmentId initSegId        = trackIdPair.first;
+    if (!m_initSegProps.count(initSegId))
+    {
+        return OMAF_INVALID_SEGMENT;
+    }
+    const auto segPropsIt = m_initSegProps.at(initSegId).segPropMap.find(SegmentId(segIndex));
+    if (segPropsIt == m_initSegProps.at(initSegId).segPropMap.end())
+    {
+        return OMAF_INVALID_SEGMENT;
+    }
+    const auto decInfoIter = segPropsIt->second.trackDecInfos.find(trackIdPair.second);
+    if (decInfoIter == segPropsIt->second.trackDecInfos.end())
+    {
+        return OMAF_INVALID_MP4READER_CONTEXTID;
+    }
+
+    sampDescs = makeVarLenArray<SampDescriptor>(decInfoIter->second.sampTable);
     return ERROR_NONE;
 }
 
-int32_t Mp4Reader::GetDepedentSampInfo(uint32_t trackId,
-                                                  uint32_t itemIndex,
-                                                  const InitSegmentId& initSegId,
-                                                  uint8_t trackReference,
-                                                  uint64_t& refSampLength,
-                                                  uint64_t& refDataOffset)
+void Mp4Reader::RegRefTrack(InitSegmentId initSegId)
 {
-    auto trackCtxId = MakeIdPair(trackId).second;
-    if (m_initSegProps[initSegId].trackProperties[trackCtxId].referenceTrackIds["scal"].empty())
+    const auto& initSegProps = m_initSegProps.at(initSegId);
+    ContextId ctxId          = initSegProps.corresTrackId;
+    const auto trackPropsIt  = initSegProps.trackProperties.find(ctxId);
+    if (trackPropsIt == initSegProps.trackProperties.end())
     {
-        return OMAF_INVALID_PROPERTY_INDEX;
+        return;
     }
-    auto refTrackCtxId =
-        m_initSegProps[initSegId].trackProperties[trackCtxId].referenceTrackIds["scal"].at(
-            trackReference);
 
-    InitSegmentTrackId refInitSegTrackId = make_pair(initSegId, refTrackCtxId);
+    // extractor tracks can not be referenced by another extractor
+    const auto scalIt = trackPropsIt->second.referenceTrackIds.find(FourCCInt("scal"));
+    if (scalIt != trackPropsIt->second.referenceTrackIds.end() && !scalIt->second.empty())
+    {
+        return;
+    }
 
-    SegmentId refSegmentId;
-    int32_t result = GetSegIndex(refInitSegTrackId, itemIndex, refSegmentId);
-    if (result != ERROR_NONE)
+    // the first init segment carrying the track wins
+    auto refIt = m_refTrackInitSegs.find(ctxId);
+    if (refIt == m_refTrackInitSegs.end() || initSegId < refIt->second)
     {
-        return result;
+        m_refTrackInitSegs[ctxId] = initSegId;
     }
-    SegmentTrackId refSegTrackId = make_pair(refSegmentId, refInitSegTrackId.second);
-    ItemId refItemId             = ItemId(itemIndex) - GetTrackDecInfo(initSegId, refSegTrackId).itemIdBase;
+}
 
-    refDataOffset   = GetTrackDecInfo(initSegId, refSegTrackId).samples.at(refItemId.GetIndex()).dataOffset;
-    refSampLength = GetTrackDecInfo(initSegId, refSegTrackId).samples.at(refItemId.GetIndex()).dataLength;
+void Mp4Reader::UnregRefTracks(InitSegmentId initSegId)
+{
+    std::vector<ContextId> ctxIds;
+    for (auto refIt = m_refTrackInitSegs.begin(); refIt != m_refTrackInitSegs.end();)
+    {
+        if (refIt->second == initSegId)
+        {
+            ctxIds.push_back(refIt->first);
+            refIt = m_refTrackInitSegs.erase(refIt);
+        }
+        else
+        {
+            ++refIt;
+        }
+    }
 
-    return ERROR_NONE;
+    // other init segments may carry the same track
+    for (auto& ctxId : ctxIds)
+    {
+        for (auto& initSegProps : m_initSegProps)
+        {
+            if (initSegProps.second.corresTrackId == ctxId)
+            {
+                RegRefTrack(initSegProps.first);
+            }
+        }
+    }
 }
 
-bool ParseExtractorNal(const DataVector& NalData,
-                       ExtSample& extSamp,
-                       uint8_t lenSizeMinus1,
-                       uint64_t& extSize)
+static inline uint32_t ReadBigEndian(const char* data, uint32_t bytes)
 {
-    Stream nalus(NalData);
-    ExtNalHdr extNalHdr;
-    uint32_t extractors = 0;
-    uint64_t inlineSizes = 0;
-    size_t order_idx = 1;
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < bytes; i++)
+    {
+        value = (value << 8) | (uint8_t) data[i];
+    }
+    return value;
+}
 
-    while (nalus.BytesRemain() > 0)
+int32_t Mp4Reader::GenExtractorPlan(const char* sampData,
+                                      uint32_t sampSize,
+                                      uint8_t lenSizeMinus1,
+                                      std::vector<ExtConstruct>& plan,
+                                      uint64_t& extSize)
+{
+    if (lenSizeMinus1 != 0 && lenSizeMinus1 != 1 && lenSizeMinus1 != 3)
     {
-        size_t readCnt = 0;
-        if (lenSizeMinus1 == 0)
+        LOG(ERROR) << "Length field size is not correct !" << endl;
+        return OMAF_INVALID_SEGMENT;
+    }
+
+    const uint32_t lenSize = lenSizeMinus1 + 1;
+    uint64_t inlineSizes   = 0;
+    bool hasExtractor      = false;
+    uint32_t pos           = 0;
+
+    plan.clear();
+    extSize = 0;
+    while (pos < sampSize)
+    {
+        if (sampSize - pos < lenSize)
         {
-            readCnt = nalus.Read8();
+            return OMAF_INVALID_SEGMENT;
         }
-        else if (lenSizeMinus1 == 1)
+        uint32_t nalLength = ReadBigEndian(sampData + pos, lenSize);
+        pos += lenSize;
+        if (nalLength < 2 || nalLength > sampSize - pos)
         {
-            readCnt = nalus.Read16();
+            return OMAF_INVALID_SEGMENT;
         }
-        else if (lenSizeMinus1 == 3)
+        const uint32_t nalEnd = pos + nalLength;
+        const uint8_t nalType = ((uint8_t) sampData[pos] >> 1) & 0x3f;
+        pos += 2;
+
+        if (nalType != 49)
         {
-            readCnt = nalus.Read32();
+            pos = nalEnd;
+            continue;
+        }
+
+        hasExtractor = true;
+        while (pos < nalEnd)
+        {
+            uint8_t constType = (uint8_t) sampData[pos++];
+            if (constType == 0)
+            {
+                if (nalEnd - pos < 2 + 2 * lenSize)
+                {
+                    return OMAF_INVALID_SEGMENT;
+                }
+                ExtConstruct sampConst;
+                sampConst.trackRefIndex = (uint8_t)((uint8_t) sampData[pos] - 1);
+                pos += 2;  // sample_offset is not used
+                sampConst.dataOffset = ReadBigEndian(sampData + pos, lenSize);
+                pos += lenSize;
+                sampConst.dataLength = ReadBigEndian(sampData + pos, lenSize);
+                pos += lenSize;
+                if (sampConst.dataLength < UINT32_MAX)
+                {
+                    extSize += sampConst.dataLength;
+                }
+                plan.push_back(sampConst);
+            }
+            else if (constType == 2)
+            {
+                // the inline data starts with the length of the rewritten NAL unit
+                if (pos >= nalEnd || (uint8_t) sampData[pos] > nalEnd - pos - 1 ||
+                    (uint8_t) sampData[pos] < lenSize)
+                {
+                    return OMAF_INVALID_SEGMENT;
+                }
+                ExtConstruct inlinConst;
+                inlinConst.isInline   = true;
+                inlinConst.dataLength = (uint8_t) sampData[pos++];
+                inlinConst.inlineData = sampData + pos;
+                pos += inlinConst.dataLength;
+                inlineSizes += inlinConst.dataLength;
+                plan.push_back(inlinConst);
+            }
+            else
+            {
+                return OMAF_INVALID_SEGMENT;
+            }
+        }
+    }
+
+    if (!hasExtractor)
+    {
+        return OMAF_UNSUPPORTED_DASH_CODECS_TYPE;
+    }
+    if (extSize > 0)
+    {
+        extSize += inlineSizes;
+    }
+    return ERROR_NONE;
+}
+
+int32_t Mp4Reader::ResolveExtractorPlan(InitSegmentTrackId trackIdPair, bool refInOwnInitSeg)
+{
+    const ContextIdVector* scalTracks = NULL;
+    if (refInOwnInitSeg)
+    {
+        const auto& trackProps = m_initSegProps.at(trackIdPair.first).trackProperties;
+        const auto trackPropsIt = trackProps.find(trackIdPair.second);
+        if (trackPropsIt != trackProps.end())
+        {
+            const auto scalIt = trackPropsIt->second.referenceTrackIds.find("scal");
+            if (scalIt != trackPropsIt->second.referenceTrackIds.end())
+            {
+                scalTracks = &scalIt->second;
+            }
+        }
+        if (scalTracks == NULL || scalTracks->empty())
+        {
+            return OMAF_INVALID_PROPERTY_INDEX;
+        }
+    }
+
+    for (auto& construct : m_extPlan)
+    {
+        if (construct.isInline)
+        {
+            continue;
+        }
+        if (refInOwnInitSeg)
+        {
+            // the referenced tracks are in the same file, listed by the scal reference
+            if (construct.trackRefIndex >= scalTracks->size())
+            {
+                return OMAF_INVALID_PROPERTY_INDEX;
+            }
+            construct.refTrack = make_pair(trackIdPair.first, scalTracks->at(construct.trackRefIndex));
         }
         else
         {
-            LOG(ERROR) << "Length field size is not correct !" << endl;
-            throw exception();
+            // each referenced track comes with its own init segment
+            ContextId refCtxId = ContextId(construct.trackRefIndex + 1);
+            auto refIt         = m_refTrackInitSegs.find(refCtxId);
+            if (refIt == m_refTrackInitSegs.end())
+            {
+                return OMAF_INVALID_PROPERTY_INDEX;
+            }
+            construct.refTrack = make_pair(refIt->second, refCtxId);
+        }
+    }
+    return ERROR_NONE;
+}
+
+int32_t Mp4Reader::GatherExtractorSamp(InitSegmentTrackId trackIdPair,
+                                         uint32_t itemIndex,
+                                         const SampDescriptor* sampDesc,
+                                         bool refInOwnInitSeg,
+                                         char* buf,
+                                         uint32_t& bufSize,
+                                         uint32_t spaceAvailable,
+                                         bool strHrd)
+{
+    uint8_t nalLengthSizeMinus1 = 3;
+    SmpDesIndex index = SmpDesIndex(sampDesc->sampleDescriptionIndex);
+    if (GetTrackBasicInfo(trackIdPair).nalLengthSizeMinus1.count(index.GetIndex()) != 0)
+    {
+        nalLengthSizeMinus1 = GetTrackBasicInfo(trackIdPair).nalLengthSizeMinus1.at(index);
+        assert(nalLengthSizeMinus1 == 3);
+    }
+    const uint32_t lenSize = nalLengthSizeMinus1 + 1;
+
+    // the output overwrites the extractor sample, so keep it aside
+    m_extSampBuf.assign(buf, buf + bufSize);
+
+    uint64_t extSize   = 0;
+    uint64_t tolerance = 0;
+    int32_t result =
+        GenExtractorPlan(m_extSampBuf.data(), (uint32_t) m_extSampBuf.size(), nalLengthSizeMinus1, m_extPlan, extSize);
+    if (result != ERROR_NONE)
+    {
+        return result;
+    }
+    result = ResolveExtractorPlan(trackIdPair, refInOwnInitSeg);
+    if (result != ERROR_NONE)
+    {
+        return result;
+    }
+
+    if (extSize == 0)
+    {
+        SampTableCursor cursor;
+        for (auto& construct : m_extPlan)
+        {
+            if (construct.isInline)
+            {
+                continue;
+            }
+            const SampDescriptor* refSampDesc = NULL;
+            result = GetSampDesc(construct.refTrack, itemIndex, cursor, refSampDesc);
+            if (result != ERROR_NONE)
+            {
+                return result;
+            }
+            extSize += refSampDesc->dataLength;
         }
+        tolerance = (uint64_t)(extSize / 10);
+        extSize += tolerance;
+    }
+    if (extSize > (uint64_t) spaceAvailable)
+    {
+        bufSize = (uint32_t)(extSize + tolerance);
+        return OMAF_MEMORY_TOO_SMALL_BUFFER;
+    }
 
-        extNalHdr.forbidden_zero_bit    = (uint8_t) nalus.Read1(1);
-        extNalHdr.nal_unit_type         = (uint8_t) nalus.Read1(6);
-        extNalHdr.nuh_layer_id          = (uint8_t) nalus.Read1(6);
-        extNalHdr.nuh_temporal_id_plus1 = (uint8_t) nalus.Read1(3);
+    // gather the referenced bytes straight from the segments into the output
+    uint32_t extractedBytes          = 0;
+    char* buffer                     = buf;
+    char* inlineNalLengthPlaceHolder = NULL;
+    size_t inlineLength              = 0;
+    uint64_t refSampLength           = 0;
+    uint64_t refSampOffset           = 0;
+    uint8_t trackRefIndex            = UINT8_MAX;
+    SegmentIO* refIO                 = NULL;
+    SampTableCursor refCursor;
 
-        readCnt = readCnt - 2;
-        if (extNalHdr.nal_unit_type == 49)
+    for (auto& construct : m_extPlan)
+    {
+        if (construct.isInline)
         {
-            ExtSample::Extractor extractor;
-            for (; readCnt > 0; readCnt--)
+            if (extractedBytes + construct.dataLength > spaceAvailable)
             {
-                uint8_t constType = (uint8_t) nalus.Read1(8);
+                bufSize = extractedBytes + construct.dataLength;
+                return OMAF_MEMORY_TOO_SMALL_BUFFER;
+            }
+            inlineNalLengthPlaceHolder = buffer;
+            memcpy(buffer, construct.inlineData, construct.dataLength);
+            inlineLength = construct.dataLength - lenSize;  // exclude the length
+            buffer += construct.dataLength;
+            extractedBytes += construct.dataLength;
+            continue;
+        }
 
-                if (constType == 0)
+        if (construct.trackRefIndex != trackRefIndex || trackRefIndex == UINT8_MAX)
+        {
+            const SampDescriptor* refSampDesc = NULL;
+            result = GetSampDesc(construct.refTrack, itemIndex, refCursor, refSampDesc, &refIO);
+            if (result != ERROR_NONE)
+            {
+                return result;
+            }
+            refSampLength = refSampDesc->dataLength;
+            refSampOffset = refSampDesc->dataOffset;
+            trackRefIndex = construct.trackRefIndex;
+            LocateToOffset(*refIO, refSampOffset);
+        }
+        if (extractedBytes + lenSize > spaceAvailable)
+        {
+            bufSize = extractedBytes + lenSize;
+            return OMAF_MEMORY_TOO_SMALL_BUFFER;
+        }
+        refIO->strIO->ReadStream(buffer, lenSize);
+        uint64_t refNalLength = ParseNalLen(buffer);
+
+        uint64_t inputReadOffset = refSampOffset + construct.dataOffset;
+
+        uint64_t bytesToCopy = refNalLength;
+        if (construct.dataLength == 0)
+        {
+            bytesToCopy   = refNalLength;
+            refSampLength = 0;
+        }
+        else
+        {
+            if ((uint64_t) construct.dataOffset + (uint64_t) construct.dataLength > refSampLength)
+            {
+                if (construct.dataOffset > refSampLength)
                 {
-                    ExtSample::SampleConstruct sampConst;
-                    sampConst.order_idx        = (uint8_t) order_idx;
-                    sampConst.constructor_type = (uint8_t) constType;
-                    sampConst.track_ref_index  = (uint8_t) nalus.Read1(8);
-                    readCnt--;
-                    sampConst.track_ref_index = sampConst.track_ref_index - 1;
-                    sampConst.sample_offset   = (int8_t) nalus.Read1(8);
-                    readCnt--;
-                    sampConst.data_offset = nalus.Read1((lenSizeMinus1 + 1) * 8);
-                    readCnt -= (lenSizeMinus1 + 1);
-                    sampConst.data_length = nalus.Read1((lenSizeMinus1 + 1) * 8);
-                    readCnt -= (lenSizeMinus1 + 1);
-                    if (sampConst.data_length < UINT32_MAX)
-                    {
-                        extSize += sampConst.data_length;
-                    }
-                    extractor.sampleConstruct.push_back(sampConst);
-                    order_idx = order_idx + 1;
+                    return OMAF_INVALID_SEGMENT;
                 }
-                else if (constType == 2)
+                bytesToCopy = refSampLength - construct.dataOffset;
+            }
+            else
+            {
+                bytesToCopy = construct.dataLength;
+            }
+
+            if (inlineNalLengthPlaceHolder != NULL)
+            {
+                uint64_t actualNalLength = bytesToCopy + inlineLength;
+                WriteNalLen(actualNalLength, inlineNalLengthPlaceHolder);
+                inlineNalLengthPlaceHolder = NULL;
+            }
+            else
+            {
+                inputReadOffset += lenSize;
+                if (bytesToCopy == refSampLength - construct.dataOffset)
                 {
-                    ExtSample::InlineConstruct inlinConst;
-                    inlinConst.order_idx        = (uint8_t) order_idx;
-                    inlinConst.constructor_type = (uint8_t) constType;
-                    inlinConst.data_length      = (uint8_t) nalus.Read1(8);
-                    for (uint8_t i = 0; i < inlinConst.data_length; i++)
-                    {
-                        inlinConst.inline_data.push_back((uint8_t) nalus.Read1(8));
-                    }
-                    inlineSizes += inlinConst.data_length;
-                    extractor.inlineConstruct.push_back(inlinConst);
-                    readCnt   = readCnt - inlinConst.data_length - 1;
-                    order_idx = order_idx + 1;
+                    bytesToCopy -= lenSize;
                 }
+                buffer += lenSize;
+                extractedBytes += lenSize;
             }
-            extSamp.extractors.push_back(extractor);
-            extractors++;
         }
-        else
+
+        if (extractedBytes + (uint32_t) bytesToCopy > spaceAvailable)
         {
-            nalus.SkipBytes(readCnt);
+            bufSize = extractedBytes + (uint32_t) bytesToCopy;
+            return OMAF_MEMORY_TOO_SMALL_BUFFER;
         }
-    }
-    if (extractors)
-    {
-        if (extSize > 0)
+        if (inputReadOffset > 0)
         {
-            extSize += inlineSizes;
+            LocateToOffset(*refIO, (int64_t) inputReadOffset);
         }
-        return true;
+        refIO->strIO->ReadStream(buffer, bytesToCopy);
+        buffer += bytesToCopy;
+        extractedBytes += (uint32_t) bytesToCopy;
+        inlineNalLengthPlaceHolder = NULL;
+        inlineLength               = 0;
+
+        refSampLength -= (refNalLength + lenSize);
     }
-    else
+    bufSize = extractedBytes;
+    if (strHrd)
     {
-        return false;
+        return ParseHevcData(buf, bufSize);
     }
+
+    return ERROR_NONE;
 }
 
 int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
@@ -3437,17 +3775,16 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
     }
 
     InitSegmentTrackId trackIdPair = MakeIdPair(trackId);
-    InitSegmentId initSegId       = trackIdPair.first;
-    SegmentId segIndex;
-    int32_t result = GetSegIndex(trackIdPair, itemIndex, segIndex);
+    SampTableCursor cursor;
+    const SampDescriptor* sampDesc = NULL;
+    SegmentIO* sampIO              = NULL;
+    int32_t result = GetSampDesc(trackIdPair, itemIndex, cursor, sampDesc, &sampIO);
     if (result != ERROR_NONE)
     {
         return result;
     }
-    SegmentTrackId segTrackId = make_pair(segIndex, trackIdPair.second);
-    ItemId itemId             = ItemId(itemIndex) - GetTrackDecInfo(initSegId, segTrackId).itemIdBase;
 
-    SegmentIO& io = m_initSegProps.at(initSegId).segPropMap.at(segIndex).io;
+    SegmentIO& io = *sampIO;
     CtxType ctxType;
     int error = GetCtxTypeError(trackIdPair, ctxType);
     if (error)
@@ -3458,20 +3795,14 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
     {
     case CtxType::TRACK:
     {
-        if (itemId.GetIndex() >= GetTrackDecInfo(initSegId, segTrackId).samples.size())
-        {
-            return OMAF_INVALID_ITEM_ID;
-        }
-
-        const uint32_t sampLen = GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataLength;
+        const uint32_t sampLen = sampDesc->dataLength;
         if (bufSize < sampLen)
         {
             bufSize = sampLen;
             return OMAF_MEMORY_TOO_SMALL_BUFFER;
         }
 
-        int64_t neededDataOffset = (int64_t) GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataOffset;
-        LocateToOffset(io, neededDataOffset);
+        LocateToOffset(io, (int64_t) sampDesc->dataOffset);
         io.strIO->ReadStream(buf, sampLen);
         bufSize = sampLen;
 
@@ -3485,11 +3816,14 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
         return OMAF_INVALID_MP4READER_CONTEXTID;
     }
 
-    FourCC codeType;
-    error = GetDecoderCodeType(GenTrackId(trackIdPair), itemIndex, codeType);
-    if (error)
+    FourCC codeType = sampDesc->codeType;
+    if (codeType == FourCC())
     {
-        return error;
+        error = GetDecoderCodeType(GenTrackId(trackIdPair), itemIndex, codeType);
+        if (error)
+        {
+            return error;
+        }
     }
 
     if (codeType == "avc1" || codeType == "avc3")
@@ -3517,183 +3851,7 @@ int32_t Mp4Reader::GetExtractorTrackSampData(uint32_t trackId,
 
     else if (codeType == "hvc2")
     {
-        std::vector<uint8_t> extSampBuffer(buf, buf + bufSize);
-
-        uint8_t nalLengthSizeMinus1 = 3;
-        ItemId sampId;
-        auto& infoOfSamp             = GetSampInfos(initSegId, segTrackId, sampId);
-        SmpDesIndex index = infoOfSamp.at((ItemId(itemIndex) - sampId).GetIndex()).sampleDescriptionIndex;
-        if (GetTrackBasicInfo(trackIdPair).nalLengthSizeMinus1.count(index.GetIndex()) != 0)
-        {
-            nalLengthSizeMinus1 = GetTrackBasicInfo(trackIdPair).nalLengthSizeMinus1.at(index);
-            assert(nalLengthSizeMinus1 == 3);
-        }
-
-        ExtSample extSamp;
-        uint64_t extSize = 0;
-        uint64_t tolerance      = 0;
-
-        if (ParseExtractorNal(extSampBuffer, extSamp, nalLengthSizeMinus1, extSize))
-        {
-            if (extSize == 0)
-            {
-                extSize = 0;
-                for (auto& extractor : extSamp.extractors)
-                {
-                    for (auto& sampConstr : extractor.sampleConstruct)
-                    {
-                        uint64_t refSampLength = 0;
-                        uint64_t refDataOffset = 0;
-                        result =
-                            GetDepedentSampInfo(trackId, itemIndex, initSegId, sampConstr.track_ref_index,
-                                refSampLength, refDataOffset);
-                        if (result != ERROR_NONE)
-                        {
-                            return result;
-                        }
-                        extSize += refSampLength;
-                    }
-                }
-                tolerance = (uint64_t)(extSize / 10);
-                extSize += tolerance;
-            }
-            if (extSize > (uint64_t) spaceAvailable)
-            {
-                bufSize = (uint32_t)(extSize + tolerance);
-                return OMAF_MEMORY_TOO_SMALL_BUFFER;
-            }
-
-            uint32_t extractedBytes            = 0;
-            char* buffer                       = buf;
-            char* inlineNalLengthPlaceHolder = NULL;
-            size_t inlineLength                = 0;
-            vector<ExtSample::SampleConstruct>::iterator sampConst;
-            vector<ExtSample::InlineConstruct>::iterator inlinConst;
-            uint64_t refSampLength = 0;
-            uint64_t refSampOffset = 0;
-            uint8_t trackRefIndex = UINT8_MAX;
-
-            for (auto& extractor : extSamp.extractors)
-            {
-                for (sampConst = extractor.sampleConstruct.begin(),
-                    inlinConst = extractor.inlineConstruct.begin();
-                    sampConst != extractor.sampleConstruct.end() ||
-                    inlinConst != extractor.inlineConstruct.end();)
-                {
-                    if (inlinConst != extractor.inlineConstruct.end() &&
-                        (sampConst == extractor.sampleConstruct.end() ||
-                        (*inlinConst).order_idx < (*sampConst).order_idx))
-                    {
-                        inlineNalLengthPlaceHolder = buffer;
-
-                        memcpy(buffer, (*inlinConst).inline_data.data(), (*inlinConst).inline_data.size());
-                        inlineLength = (*inlinConst).inline_data.size() - (nalLengthSizeMinus1 + 1);   // exclude the length
-                        buffer += (*inlinConst).data_length;
-                        extractedBytes += (*inlinConst).data_length;
-                        ++inlinConst;
-                    }
-                    else if (sampConst != extractor.sampleConstruct.end())
-                    {
-                        auto referredTrack = ContextId((*sampConst).track_ref_index + 1);
-                        InitSegmentId ref_initSegmentId;
-                        for (const auto& loopInitSegment : m_initSegProps)
-                        {
-                            if (loopInitSegment.second.corresTrackId == referredTrack)
-                            {
-                                ref_initSegmentId = loopInitSegment.first;
-                                break;
-                            }
-                        }
-                        InitSegmentTrackId ref_trackIdPair = make_pair(ref_initSegmentId, referredTrack);
-                        SegmentId ref_segmentId;
-                        int32_t result = GetSegIndex(ref_trackIdPair, itemIndex, ref_segmentId);
-                        SegmentIO& ref_io = m_initSegProps.at(ref_initSegmentId).segPropMap.at(ref_segmentId).io;
-
-                        if ((*sampConst).track_ref_index != trackRefIndex || trackRefIndex == UINT8_MAX)
-                        {
-                            result =
-                                GetSampDataInfo(((*sampConst).track_ref_index + 1), itemIndex, ref_initSegmentId,
-                                    refSampLength, refSampOffset);
-                            if (result != ERROR_NONE)
-                            {
-                                return result;
-                            }
-                            trackRefIndex = (*sampConst).track_ref_index;
-                            LocateToOffset(ref_io, refSampOffset);
-                        }
-                        ref_io.strIO->ReadStream(buffer, (nalLengthSizeMinus1 + 1));
-                        uint64_t refNalLength = ParseNalLen(buffer);
-
-                        uint64_t inputReadOffset = refSampOffset + (*sampConst).data_offset;
-
-                        uint64_t bytesToCopy = refNalLength;
-                        if ((*sampConst).data_length == 0)
-                        {
-                            bytesToCopy = refNalLength;
-                            refSampLength = 0;
-                        }
-                        else
-                        {
-                            if ((uint64_t)((*sampConst).data_offset) + (uint64_t)((*sampConst).data_length) > refSampLength)
-                            {
-                                if ((*sampConst).data_offset > refSampLength)
-                                {
-                                    return OMAF_INVALID_SEGMENT;
-                                }
-                                bytesToCopy = refSampLength - (*sampConst).data_offset;
-                            }
-                            else
-                            {
-                                bytesToCopy = (*sampConst).data_length;
-                            }
-
-                            if (inlineNalLengthPlaceHolder != NULL)
-                            {
-                                uint64_t actualNalLength = bytesToCopy + inlineLength;
-                                WriteNalLen(actualNalLength, inlineNalLengthPlaceHolder);
-                                inlineNalLengthPlaceHolder = NULL;
-                            }
-                            else
-                            {
-                                inputReadOffset += (nalLengthSizeMinus1 + 1);
-                                if (bytesToCopy == refSampLength - (*sampConst).data_offset)
-                                {
-                                    bytesToCopy -= (nalLengthSizeMinus1 + 1);
-                                }
-                                buffer += (nalLengthSizeMinus1 + 1);
-                                extractedBytes += (nalLengthSizeMinus1 + 1);
-                            }
-                        }
-
-                        if (extractedBytes + (uint32_t)bytesToCopy > spaceAvailable)
-                        {
-                            bufSize = extractedBytes + (uint32_t)bytesToCopy;
-                            return OMAF_MEMORY_TOO_SMALL_BUFFER;
-                        }
-                        if (inputReadOffset > 0)
-                        {
-                            LocateToOffset(ref_io, (int64_t) inputReadOffset);
-                        }
-                        ref_io.strIO->ReadStream(buffer, bytesToCopy);
-                        buffer += bytesToCopy;
-                        extractedBytes += (uint32_t)bytesToCopy;
-                        ++sampConst;
-                        inlineNalLengthPlaceHolder = NULL;
-                        inlineLength = 0;
-
-                        refSampLength -= (refNalLength + (nalLengthSizeMinus1 + 1));
-                    }
-                }
-            }
-            bufSize = extractedBytes;
-            if (strHrd)
-            {
-                return ParseHevcData(buf, bufSize);
-            }
-
-            return ERROR_NONE;
-        }
-        return OMAF_UNSUPPORTED_DASH_CODECS_TYPE;  // hvc2 but unknown extractor?
+        return GatherExtractorSamp(trackIdPair, itemIndex, sampDesc, false, buf, bufSize, spaceAvailable, strHrd);
     }
     else if ((codeType == "mp4a") || (codeType == "invo") || (codeType == "urim") || (codeType == "mp4v"))
     {
@@ -3718,17 +3876,16 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
     }
 
     InitSegmentTrackId trackIdPair = MakeIdPair(trackId);
-    InitSegmentId initSegId       = trackIdPair.first;
-    SegmentId segIndex;
-    int32_t result = GetSegIndex(trackIdPair, itemIndex, segIndex);
+    SampTableCursor cursor;
+    const SampDescriptor* sampDesc = NULL;
+    SegmentIO* sampIO              = NULL;
+    int32_t result = GetSampDesc(trackIdPair, itemIndex, cursor, sampDesc, &sampIO);
     if (result != ERROR_NONE)
     {
         return result;
     }
-    SegmentTrackId segTrackId = make_pair(segIndex, trackIdPair.second);
-    ItemId itemId             = ItemId(itemIndex) - GetTrackDecInfo(initSegId, segTrackId).itemIdBase;
 
-    SegmentIO& io = m_initSegProps.at(initSegId).segPropMap.at(segIndex).io;
+    SegmentIO& io = *sampIO;
     CtxType ctxType;
     int error = GetCtxTypeError(trackIdPair, ctxType);
     if (error)
@@ -3739,19 +3896,14 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
     {
     case CtxType::TRACK:
     {
-        if (itemId.GetIndex() >= GetTrackDecInfo(initSegId, segTrackId).samples.size())
-        {
-            return OMAF_INVALID_ITEM_ID;
-        }
-
-        const uint32_t sampLen = GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataLength;
+        const uint32_t sampLen = sampDesc->dataLength;
         if (bufSize < sampLen)
         {
             bufSize = sampLen;
             return OMAF_MEMORY_TOO_SMALL_BUFFER;
         }
 
-        LocateToOffset(io, (int64_t) GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataOffset);
+        LocateToOffset(io, (int64_t) sampDesc->dataOffset);
         io.strIO->ReadStream(buf, sampLen);
         bufSize = sampLen;
 
@@ -3765,11 +3917,14 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
         return OMAF_INVALID_MP4READER_CONTEXTID;
     }
 
-    FourCC codeType;
-    error = GetDecoderCodeType(GenTrackId(trackIdPair), itemIndex, codeType);
-    if (error)
+    FourCC codeType = sampDesc->codeType;
+    if (codeType == FourCC())
     {
-        return error;
+        error = GetDecoderCodeType(GenTrackId(trackIdPair), itemIndex, codeType);
+        if (error)
+        {
+            return error;
+        }
     }
 
     if (codeType == "avc1" || codeType == "avc3")
@@ -3796,167 +3951,7 @@ int32_t Mp4Reader::GetSampData(uint32_t trackId,
     }
     else if (codeType == "hvc2")
     {
-        std::vector<uint8_t> extSampBuffer(buf, buf + bufSize);
-
-        uint8_t nalLengthSizeMinus1 = 3;
-        ItemId sampId;
-        auto& infoOfSamp             = GetSampInfos(initSegId, segTrackId, sampId);
-        SmpDesIndex index = infoOfSamp.at((ItemId(itemIndex) - sampId).GetIndex()).sampleDescriptionIndex;
-        if (GetTrackBasicInfo(trackIdPair).nalLengthSizeMinus1.count(index.GetIndex()) != 0)
-        {
-            nalLengthSizeMinus1 = GetTrackBasicInfo(trackIdPair).nalLengthSizeMinus1.at(index);
-            assert(nalLengthSizeMinus1 == 3);
-        }
-
-        ExtSample extSamp;
-        uint64_t extSize = 0;
-        uint64_t tolerance      = 0;
-
-        if (ParseExtractorNal(extSampBuffer, extSamp, nalLengthSizeMinus1, extSize))
-        {
-            if (extSize == 0)
-            {
-                extSize = 0;
-                for (auto& extractor : extSamp.extractors)
-                {
-                    for (auto& sampConstr : extractor.sampleConstruct)
-                    {
-                        uint64_t refSampLength = 0;
-                        uint64_t refDataOffset = 0;
-                        result =
-                            GetDepedentSampInfo(trackId, itemIndex, initSegId, sampConstr.track_ref_index,
-                                refSampLength, refDataOffset);
-                        if (result != ERROR_NONE)
-                        {
-                            return result;
-                        }
-                        extSize += refSampLength;
-                    }
-                }
-                tolerance = (uint64_t)(extSize / 10);
-                extSize += tolerance;
-            }
-            if (extSize > (uint64_t) spaceAvailable)
-            {
-                bufSize = (uint32_t)(extSize + tolerance);
-                return OMAF_MEMORY_TOO_SMALL_BUFFER;
-            }
-
-            uint32_t extractedBytes            = 0;
-            char* buffer                       = buf;
-            char* inlineNalLengthPlaceHolder = NULL;
-            size_t inlineLength                = 0;
-            vector<ExtSample::SampleConstruct>::iterator sampConst;
-            vector<ExtSample::InlineConstruct>::iterator inlinConst;
-            uint64_t refSampLength = 0;
-            uint64_t refSampOffset = 0;
-            uint8_t trackRefIndex = UINT8_MAX;
-
-            for (auto& extractor : extSamp.extractors)
-            {
-                for (sampConst = extractor.sampleConstruct.begin(),
-                    inlinConst = extractor.inlineConstruct.begin();
-                    sampConst != extractor.sampleConstruct.end() ||
-                    inlinConst != extractor.inlineConstruct.end();)
-                {
-                    if (inlinConst != extractor.inlineConstruct.end() &&
-                        (sampConst == extractor.sampleConstruct.end() ||
-                        (*inlinConst).order_idx < (*sampConst).order_idx))
-                    {
-                        inlineNalLengthPlaceHolder = buffer;
-                        memcpy(buffer, (*inlinConst).inline_data.data(), (*inlinConst).inline_data.size());
-                        inlineLength = (*inlinConst).inline_data.size() - (nalLengthSizeMinus1 + 1);
-                        buffer += (*inlinConst).data_length;
-                        extractedBytes += (*inlinConst).data_length;
-                        ++inlinConst;
-                    }
-                    else if (sampConst != extractor.sampleConstruct.end())
-                    {
-                        if ((*sampConst).track_ref_index != trackRefIndex || trackRefIndex == UINT8_MAX)
-                        {
-                            result =
-                                GetDepedentSampInfo(trackId, itemIndex, initSegId, (*sampConst).track_ref_index,
-                                    refSampLength, refSampOffset);
-                            if (result != ERROR_NONE)
-                            {
-                                return result;
-                            }
-                            trackRefIndex = (*sampConst).track_ref_index;
-                            LocateToOffset(io, refSampOffset);
-                        }
-                        io.strIO->ReadStream(buffer, (nalLengthSizeMinus1 + 1));
-                        uint64_t refNalLength = ParseNalLen(buffer);
-
-                        uint64_t inputReadOffset = refSampOffset + (*sampConst).data_offset;
-
-                        uint64_t bytesToCopy = refNalLength;
-                        if ((*sampConst).data_length == 0)
-                        {
-                            bytesToCopy = refNalLength;
-                            refSampLength = 0;
-                        }
-                        else
-                        {
-                            if ((uint64_t)((*sampConst).data_offset) + (uint64_t)((*sampConst).data_length) > refSampLength)
-                            {
-                                if ((*sampConst).data_offset > refSampLength)
-                                {
-                                    return OMAF_INVALID_SEGMENT;
-                                }
-                                bytesToCopy = refSampLength - (*sampConst).data_offset;
-                            }
-                            else
-                            {
-                                bytesToCopy = (*sampConst).data_length;
-                            }
-
-                            if (inlineNalLengthPlaceHolder != NULL)
-                            {
-                                uint64_t actualNalLength = bytesToCopy + inlineLength;
-                                WriteNalLen(actualNalLength, inlineNalLengthPlaceHolder);
-                                inlineNalLengthPlaceHolder = NULL;
-                            }
-                            else
-                            {
-                                inputReadOffset += (nalLengthSizeMinus1 + 1);
-                                if (bytesToCopy == refSampLength - (*sampConst).data_offset)
-                                {
-                                    bytesToCopy -= (nalLengthSizeMinus1 + 1);
-                                }
-                                buffer += (nalLengthSizeMinus1 + 1);
-                                extractedBytes += (nalLengthSizeMinus1 + 1);
-                            }
-                        }
-
-                        if (extractedBytes + (uint32_t)bytesToCopy > spaceAvailable)
-                        {
-                            bufSize = extractedBytes + (uint32_t)bytesToCopy;
-                            return OMAF_MEMORY_TOO_SMALL_BUFFER;
-                        }
-                        if (inputReadOffset > 0)
-                        {
-                            LocateToOffset(io, (int64_t) inputReadOffset);
-                        }
-                        io.strIO->ReadStream(buffer, bytesToCopy);
-                        buffer += bytesToCopy;
-                        extractedBytes += (uint32_t)bytesToCopy;
-                        ++sampConst;
-                        inlineNalLengthPlaceHolder = NULL;
-                        inlineLength = 0;
-
-                        refSampLength -= (refNalLength + (nalLengthSizeMinus1 + 1));
-                    }
-                }
-            }
-            bufSize = extractedBytes;
-            if (strHrd)
-            {
-                return ParseHevcData(buf, bufSize);
-            }
-
-            return ERROR_NONE;
-        }
-        return OMAF_UNSUPPORTED_DASH_CODECS_TYPE;  // hvc2 but unknown extractor?
+        return GatherExtractorSamp(trackIdPair, itemIndex, sampDesc, true, buf, bufSize, spaceAvailable, strHrd);
     }
     else if ((codeType == "mp4a") || (codeType == "invo") || (codeType == "urim") || (codeType == "mp4v"))
     {
@@ -3979,15 +3974,13 @@ int32_t Mp4Reader::GetSampOffset(uint32_t trackId,
     }
 
     InitSegmentTrackId trackIdPair = MakeIdPair(trackId);
-    InitSegmentId initSegId       = trackIdPair.first;
-    SegmentId segIndex;
-    int32_t result = GetSegIndex(trackIdPair, itemIndex, segIndex);
+    SampTableCursor cursor;
+    const SampDescriptor* sampDesc = NULL;
+    int32_t result = GetSampDesc(trackIdPair, itemIndex, cursor, sampDesc);
     if (result != ERROR_NONE)
     {
         return result;
     }
-    SegmentTrackId segTrackId = make_pair(segIndex, trackIdPair.second);
-    ItemId itemId             = ItemId(itemIndex) - GetTrackDecInfo(initSegId, segTrackId).itemIdBase;
 
     CtxType ctxType;
     int error = GetCtxTypeError(trackIdPair, ctxType);
@@ -3997,12 +3990,8 @@ int32_t Mp4Reader::GetSampOffset(uint32_t trackId,
     }
     if (ctxType == CtxType::TRACK)
     {
-        if (itemId.GetIndex() >= GetTrackDecInfo(initSegId, segTrackId).samples.size())
-        {
-            return OMAF_INVALID_ITEM_ID;
-        }
-        sampLen = GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataLength;
-        sampOffset = GetTrackDecInfo(initSegId, segTrackId).samples.at(itemId.GetIndex()).dataOffset;
+        sampLen    = sampDesc->dataLength;
+        sampOffset = sampDesc->dataOffset;
     }
     else
     {
@@ -4599,14 +4588,13 @@ uint32_t Mp4Reader::SearchInfoForTrack(uint32_t trackId,
     }
 
     InitSegmentTrackId trackIdPair = MakeIdPair(trackId);
-    InitSegmentId initSegId       = trackIdPair.first;
-    SegmentId segIndex;
-    int32_t result = GetSegIndex(trackIdPair, sampleId, segIndex);
+    SampTableCursor cursor;
+    const SampDescriptor* sampDesc = NULL;
+    int32_t result = GetSampDesc(trackIdPair, sampleId, cursor, sampDesc);
     if (result != ERROR_NONE)
     {
         return result;
     }
-    SegmentTrackId segTrackId = make_pair(segIndex, trackIdPair.second);
 
     CtxType ctxType;
     int error = GetCtxTypeError(trackIdPair, ctxType);
@@ -4617,9 +4605,7 @@ uint32_t Mp4Reader::SearchInfoForTrack(uint32_t trackId,
 
     if (ctxType == CtxType::TRACK)
     {
-        ItemId sampId;
-        auto& infoOfSamp = GetSampInfos(initSegId, segTrackId, sampId);
-        index            = infoOfSamp.at((ItemId(sampleId) - sampId).GetIndex()).sampleDescriptionIndex;
+        index            = SmpDesIndex(sampDesc->sampleDescriptionIndex);
         basicTrackInfo    = GetTrackBasicInfo(trackIdPair);
         return ERROR_NONE;
     }
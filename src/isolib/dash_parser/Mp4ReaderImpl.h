@@ -371,6 +371,36 @@ public:
                                uint32_t& bufSize,
                                bool strHrd = true);
 
+    //!
+    //! \brief  Parse the extractor NAL units of one hvc2 sample
+    //!         into its constructors in stream order, the other
+    //!         NAL units are skipped
+    //!
+    //! \param  [in]  sampData
+    //!         pointer to the extractor sample
+    //! \param  [in]  sampSize
+    //!         size of the extractor sample
+    //! \param  [in]  lenSizeMinus1
+    //!         size of the NAL unit length field minus 1
+    //! \param  [out] plan
+    //!         constructors of the sample, the inline data
+    //!         points into sampData
+    //! \param  [out] extSize
+    //!         size of the extracted sample, 0 if it can't be
+    //!         known before the referenced samples are read
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, OMAF_INVALID_SEGMENT for
+    //!         the malformed or truncated NAL units, and
+    //!         OMAF_UNSUPPORTED_DASH_CODECS_TYPE if there is
+    //!         no extractor
+    //!
+    static int32_t GenExtractorPlan(const char* sampData,
+                                    uint32_t sampSize,
+                                    uint8_t lenSizeMinus1,
+                                    std::vector<ExtConstruct>& plan,
+                                    uint64_t& extSize);
+
     //!
     //! \brief  Get track sample data offset and length for
     //!         the specified sample in specified track
@@ -392,6 +422,25 @@ public:
                                  uint64_t& sampOffset,
                                  uint32_t& sampLen);
 
+    //!
+    //! \brief  Get descriptors of all samples in the specified
+    //!         segment of specified track in one call, like
+    //!         offset, length, presentation time and sync flag
+    //!
+    //! \param  [in]  trackId
+    //!         index of specific track
+    //! \param  [in]  segIndex
+    //!         index of specified segment
+    //! \param  [out] sampDescs
+    //!         output sample descriptors in decoding order
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GetSegSampDescs(uint32_t trackId,
+                                 uint32_t segIndex,
+                                 VarLenArray<SampDescriptor>& sampDescs);
+
     //!
     //! \brief  Get media codec related specific information,
     //!         like SPS, PPS and so on, for specified sample in
@@ -833,6 +882,23 @@ private:
     };
     std::map<InitSegmentTrackId, CtxInfo> m_ctxInfoMap;
 
+    // the sample table of the segment found last, kept by the caller for the
+    // lookups of one call, the tables may be regenerated between calls
+    struct SampTableCursor
+    {
+        InitSegmentTrackId trackId;
+        SegmentId segmentId;
+        uint32_t itemIdBase                      = 0;
+        const vector<SampDescriptor>* sampTable = NULL;
+        SegmentIO* io                            = NULL;
+    };
+
+    std::vector<char> m_extSampBuf;          ///< extractor sample being resolved, reused between samples
+    std::vector<ExtConstruct> m_extPlan;     ///< constructors of the extractor sample in stream order
+
+    // the init segment of each track referenced by extractors, registered at init segment parse
+    std::map<ContextId, InitSegmentId> m_refTrackInitSegs;
+
     friend class DashSegGroup;
     friend class ConstDashSegGroup;
 
@@ -1027,19 +1093,29 @@ private:
                         ItemId itemId, SegmentId& segIndex) const;
     int32_t GetSegIndex(InitSegTrackIdPair id, SegmentId& segIndex) const;
 
+    void GenSampTables(InitSegmentId initSegId,
+                         SegmentId segIndex);
 
-    int32_t GetSampDataInfo(uint32_t trackId,
-                              uint32_t itemIndex,
-                              const InitSegmentId& initSegId,
-                              uint64_t& refSampLength,
-                              uint64_t& refDataOffset);
+    int32_t GetSampDesc(InitSegmentTrackId initSegTrackId,
+                          uint32_t itemIndex,
+                          SampTableCursor& cursor,
+                          const SampDescriptor*& sampDesc,
+                          SegmentIO** io = NULL) const;
 
-    int32_t GetDepedentSampInfo(uint32_t trackId,
-                                 uint32_t itemIndex,
-                                 const InitSegmentId& initSegId,
-                                 uint8_t trackReference,
-                                 uint64_t& refSampLength,
-                                 uint64_t& refDataOffset);
+    void RegRefTrack(InitSegmentId initSegId);
+
+    void UnregRefTracks(InitSegmentId initSegId);
+
+    int32_t ResolveExtractorPlan(InitSegmentTrackId trackIdPair, bool refInOwnInitSeg);
+
+    int32_t GatherExtractorSamp(InitSegmentTrackId trackIdPair,
+                                  uint32_t itemIndex,
+                                  const SampDescriptor* sampDesc,
+                                  bool refInOwnInitSeg,
+                                  char* buf,
+                                  uint32_t& bufSize,
+                                  uint32_t spaceAvailable,
+                                  bool strHrd);
 
     uint64_t ParseNalLen(char* buffer) const;
     void WriteNalLen(uint64_t length, char* buffer) const;
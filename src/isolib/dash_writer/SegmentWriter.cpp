@@ -78,7 +78,13 @@ struct Mp4MoofInfo
 
 typedef map<TrackId, Mp4MoofInfo> Mp4MoofInfos;
 
-void WriteMoof(ostream& outStr,
+// rough serialized sizes, to reserve the storage for moof and mdat header
+const uint64_t MOOF_RESERVED_SIZE = 24;   // moof + mfhd
+const uint64_t TRAF_RESERVED_SIZE = 72;   // traf + tfhd + tfdt + trun headers
+const uint64_t TRUN_SAMPLE_SIZE   = 16;   // duration, size, flags, cts offset
+const uint64_t MDAT_HEADER_SIZE   = 8;
+
+void WriteMoof(Stream& outStr,
                const TrackIds& trackIndex,
                const Segment& oneSeg,
                const Mp4MoofInfos& moofInfos,
@@ -154,15 +160,12 @@ void WriteMoof(ostream& outStr,
         moof.AddTrackFragmentAtom(move(traf));
     }
 
-    Stream bs;
-    moof.ToStream(bs);
-    auto data = bs.GetStorage();
-    outStr.write(reinterpret_cast<const char*>(&data[0]), streamsize(data.size()));
+    moof.ToStream(outStr);
 }
 
 void FlushStream(Stream& inBS, ostream& outStr)
 {
-    auto data = inBS.GetStorage();
+    const auto& data = inBS.GetStorage();
     outStr.write(reinterpret_cast<const char*>(&data[0]), streamsize(data.size()));
     inBS.Clear();
 }
@@ -284,10 +287,16 @@ void WriteSegmentHeader(ostream& outStr)
     FlushStream(tempBS, outStr);
 }
 
-void WriteSampleData(ostream& outStr, const Segment& oneSeg)
+// the moof size doesn't depend on the data offsets, so the first pass
+// with dummy offsets gives the layout of the whole segment, then the
+// moof and mdat header are serialized into the reserved storage, and the
+// size of the whole segment is returned
+static uint64_t LayoutSampleData(const Segment& oneSeg,
+                                 TrackIds& trackIds,
+                                 map<TrackId, Frames>& frameMap,
+                                 Stream& segStream)
 {
-    TrackIds trackIds = Keys(oneSeg.tracks);
-    map<TrackId, Frames> frameMap;
+    trackIds = Keys(oneSeg.tracks);
 
     map<TrackId, TrackOfSegment>::const_iterator iter = oneSeg.tracks.begin();
     for ( ; iter != oneSeg.tracks.end(); iter++)
@@ -295,61 +304,71 @@ void WriteSampleData(ostream& outStr, const Segment& oneSeg)
         frameMap.insert(make_pair(iter->first, iter->second.frames));
     }
 
-    auto moofOffset = outStr.tellp();
     Mp4MoofInfos segMoofInfos;
+    size_t frameNum = 0;
 
     vector<TrackId>::iterator iter1 = trackIds.begin();
     for ( ; iter1 != trackIds.end(); iter1++)
     {
+        if (frameMap.find(*iter1) == frameMap.end())
+        {
+            LOG(ERROR) << "Failed to find frame with designated track Id !" << std::endl;
+            throw exception();
+        }
         Mp4MoofInfo moofInfo = {oneSeg.tracks.find(*iter1)->second.trackInfo, 0};
         segMoofInfos.insert(make_pair(*iter1, move(moofInfo)));
+        frameNum += frameMap.find(*iter1)->second.size();
     }
 
-    WriteMoof(outStr, trackIds, oneSeg, segMoofInfos, frameMap);
-
-    vector<uint8_t> mdatHrd;
-    mdatHrd.push_back(0);
-    mdatHrd.push_back(0);
-    mdatHrd.push_back(0);
-    mdatHrd.push_back(0);
-    mdatHrd.push_back(uint8_t('m'));
-    mdatHrd.push_back(uint8_t('d'));
-    mdatHrd.push_back(uint8_t('a'));
-    mdatHrd.push_back(uint8_t('t'));
-    auto mdatOffset = outStr.tellp();
-    outStr.write(reinterpret_cast<const char*>(&mdatHrd[0]), streamsize(mdatHrd.size()));
-    uint64_t mdatSize = mdatHrd.size();
+    segStream.Reserve(MOOF_RESERVED_SIZE + trackIds.size() * TRAF_RESERVED_SIZE +
+                      frameNum * TRUN_SAMPLE_SIZE + MDAT_HEADER_SIZE);
+    WriteMoof(segStream, trackIds, oneSeg, segMoofInfos, frameMap);
+    const uint64_t moofSize = segStream.GetSize();
+
+    uint64_t mdatSize = MDAT_HEADER_SIZE;
     vector<TrackId>::iterator iter2 = trackIds.begin();
     for ( ; iter2 != trackIds.end(); iter2++)
     {
-        Mp4MoofInfo moofInfo  = {oneSeg.tracks.find(*iter2)->second.trackInfo,
-                                    int32_t(outStr.tellp() - streamoff(moofOffset))};
-        segMoofInfos[*iter2] = move(moofInfo);
-        if (frameMap.find(*iter2) == frameMap.end())
-        {
-            LOG(ERROR) << "Failed to find frame with designated track Id !" << std::endl;
-            throw exception();
-        }
+        segMoofInfos.find(*iter2)->second.moofToDataOffset = int32_t(moofSize + mdatSize);
         for (const auto& frame : frameMap.find(*iter2)->second)
         {
-            const auto& frameData = *frame;
-            const auto& data      = frameData.frameBuf;
-            outStr.write(reinterpret_cast<const char*>(&data[0]), streamsize(data.size()));
-            mdatSize += data.size();
+            mdatSize += frame->frameBuf.size();
         }
     }
-    streampos afterMdat = outStr.tellp();
 
-    mdatHrd[0] = uint8_t((mdatSize >> 24) & 0xff);
-    mdatHrd[1] = uint8_t((mdatSize >> 16) & 0xff);
-    mdatHrd[2] = uint8_t((mdatSize >> 8) & 0xff);
-    mdatHrd[3] = uint8_t((mdatSize >> 0) & 0xff);
-    outStr.seekp(mdatOffset);
-    outStr.write(reinterpret_cast<const char*>(&mdatHrd[0]), streamsize(4));
+    segStream.Clear();
+    WriteMoof(segStream, trackIds, oneSeg, segMoofInfos, frameMap);
+    segStream.Write32(uint32_t(mdatSize));
+    segStream.Write32(FourCCInt("mdat").GetUInt32());
+    return moofSize + mdatSize;
+}
+
+uint64_t GetSampleDataSize(const Segment& oneSeg)
+{
+    TrackIds trackIds;
+    map<TrackId, Frames> frameMap;
+    Stream segStream;
+    return LayoutSampleData(oneSeg, trackIds, frameMap, segStream);
+}
 
-    outStr.seekp(moofOffset);
-    WriteMoof(outStr, trackIds, oneSeg, segMoofInfos, frameMap);
-    outStr.seekp(afterMdat);
+void WriteSampleData(ostream& outStr, const Segment& oneSeg)
+{
+    TrackIds trackIds;
+    map<TrackId, Frames> frameMap;
+    Stream segStream;
+    LayoutSampleData(oneSeg, trackIds, frameMap, segStream);
+    FlushStream(segStream, outStr);
+
+    // sample data is written from the frame buffers as is
+    vector<TrackId>::iterator iter3 = trackIds.begin();
+    for ( ; iter3 != trackIds.end(); iter3++)
+    {
+        for (const auto& frame : frameMap.find(*iter3)->second)
+        {
+            const auto& data = frame->frameBuf;
+            outStr.write(reinterpret_cast<const char*>(&data[0]), streamsize(data.size()));
+        }
+    }
 }
 
 void WriteInitSegment(ostream& outStr, const InitialSegment& initSegment)
@@ -360,7 +379,7 @@ void WriteInitSegment(ostream& outStr, const InitialSegment& initSegment)
 
     initSegment.moov->movieBox->ToStream(stream);
 
-    auto data = stream.GetStorage();
+    const auto& data = stream.GetStorage();
     outStr.write(reinterpret_cast<const char*>(&data[0]), streamsize(data.size()));
 }
 
@@ -1334,29 +1353,104 @@ void SegmentWriter::WriteInitSegment(ostream& outStr, const InitialSegment& init
     WriteInitSegment(outStr, initSeg);
 }
 
+void SidxWriter::AddSubSeg(Segment subSegment)
+{
+    if (subSegment.tracks.empty())
+    {
+        return;
+    }
+
+    // the first track is the reference stream of the index
+    const auto& refTrack  = subSegment.tracks.begin()->second;
+    const auto& trackMeta = refTrack.trackInfo.trackMeta;
+    if (m_subSegs.empty())
+    {
+        m_referenceId = trackMeta.trackId.GetIndex();
+        m_timescale   = uint32_t(trackMeta.timescale.per1().asDouble());
+    }
+
+    SubSegInfo info;
+    info.earliestPTS = uint64_t((refTrack.trackInfo.tBegin.cast<FractU64>() / trackMeta.timescale).asDouble());
+    info.duration    = uint32_t((subSegment.duration / trackMeta.timescale).asDouble());
+    info.startsWithSAP = !refTrack.frames.empty() && refTrack.frames.front().GetFrameInfo().isIDR;
+    m_subSegs.push_back(info);
+}
+
+void SidxWriter::SetFirstSubSegOffset(streampos offset)
+{
+    m_firstOffset = uint64_t(streamoff(offset));
+}
+
+void SidxWriter::AddSubSegSize(streampos size)
+{
+    m_subSegSizes.push_back(uint32_t(streamoff(size)));
+}
+
+void SidxWriter::WriteSidx(ostream& outStr)
+{
+    if (m_subSegs.empty())
+    {
+        return;
+    }
+
+    SegmentIndexAtom sidx(1);
+    sidx.SetReferenceId(m_referenceId);
+    sidx.SetTimescale(m_timescale);
+    sidx.SetEarliestPresentationTime(m_subSegs.front().earliestPTS);
+    sidx.SetFirstOffset(m_firstOffset);
+    for (size_t i = 0; i < m_subSegs.size(); i++)
+    {
+        SegmentIndexAtom::Reference ref;
+        ref.referenceType      = false;
+        ref.referencedSize     = (i < m_subSegSizes.size()) ? m_subSegSizes[i] : 0;
+        ref.subsegmentDuration = m_subSegs[i].duration;
+        ref.startsWithSAP      = m_subSegs[i].startsWithSAP;
+        ref.sapType            = m_subSegs[i].startsWithSAP ? 1 : 0;
+        ref.sapDeltaTime       = 0;
+        sidx.AddReference(ref);
+    }
+
+    Stream bs;
+    sidx.ToStream(bs);
+    FlushStream(bs, outStr);
+
+    m_subSegs.clear();
+    m_subSegSizes.clear();
+    m_firstOffset = 0;
+}
+
+void SidxWriter::SetOutput(ostream* outStr)
+{
+    m_output = outStr;
+}
+
+bool SegmentWriter::NeedSidx() const
+{
+    const auto& subsegmentDuration = m_impl->m_config.subsegmentDuration;
+    return subsegmentDuration && *subsegmentDuration < m_impl->m_config.segmentDuration;
+}
+
 void SegmentWriter::WriteSubSegments(ostream& outStr, const list<Segment> subSegList)
 {
     if (m_needWriteSegmentHeader)
     {
         WriteSegmentHeader(outStr);
     }
-    for (auto& subsegment : subSegList)
+    // the sizes of the subsegments are laid out ahead, so the sidx is
+    // written once with the final sizes and the output is never seeked
+    if (NeedSidx())
     {
-        m_sidxWriter->AddSubSeg(subsegment);
+        for (auto& subsegment : subSegList)
+        {
+            m_sidxWriter->AddSubSeg(subsegment);
+            m_sidxWriter->AddSubSegSize(streamoff(GetSampleDataSize(subsegment)));
+        }
+        m_sidxWriter->WriteSidx(outStr);
     }
-    auto sidxInfo = m_sidxWriter->WriteSidx(outStr, {});
     for (auto& subsegment : subSegList)
     {
-        auto before = outStr.tellp();
         WriteSampleData(outStr, subsegment);
-        auto after = outStr.tellp();
-        m_sidxWriter->AddSubSegSize(after - before);
-    }
-    if (sidxInfo)
-    {
-        m_sidxWriter->WriteSidx(outStr, sidxInfo->position);
     }
-
 }
 
 void SegmentWriter::WriteSegment(ostream& outStr, const Segment oneSeg)
@@ -343,6 +343,7 @@ InitialSegment GenInitSegment(const TrackDescriptionsMap& inTrackDes,
 
 void WriteSegmentHeader(ostream& outStr);
 void WriteInitSegment(ostream& outStr, const InitialSegment& initSegment);
+uint64_t GetSampleDataSize(const Segment& oneSeg);
 void WriteSampleData(ostream& outStr, const Segment& oneSeg);
 
 struct SegmentWriterCfg
@@ -359,32 +360,42 @@ struct SidxInfo
     size_t size;
 };
 
+//!
+//! \class SidxWriter
+//! \brief Write the segment index for the subsegments of one segment,
+//!        the sizes of the subsegments are added before the sidx is
+//!        written ahead of them, so it is written once and in order
+//!
 class SidxWriter
 {
 public:
     SidxWriter() = default;
     ~SidxWriter() = default;
 
-    void AddSubSeg(Segment)
-    {
-    }
+    void AddSubSeg(Segment subSegment);
 
-    void SetFirstSubSegOffset(streampos)
-    {
-    }
+    void SetFirstSubSegOffset(streampos offset);
 
-    void AddSubSegSize(streampos)
-    {
-    }
+    void AddSubSegSize(streampos size);
 
-    DataItem<SidxInfo> WriteSidx(ostream&, DataItem<ostream::pos_type>)
-    {
-        return {};
-    }
+    void WriteSidx(ostream& outStr);
 
-    void SetOutput(ostream*)
+    void SetOutput(ostream* outStr);
+
+private:
+    struct SubSegInfo
     {
-    }
+        uint64_t earliestPTS;
+        uint32_t duration;
+        bool startsWithSAP;
+    };
+
+    vector<SubSegInfo> m_subSegs;
+    vector<uint32_t> m_subSegSizes;
+    uint32_t m_referenceId = 0;
+    uint32_t m_timescale   = 0;
+    uint64_t m_firstOffset = 0;
+    ostream* m_output      = nullptr;
 };
 
 class SegmentWriter
@@ -416,6 +427,9 @@ public:
     SegmentList ExtractSegments();
 
 private:
+    //! the sidx is only written when the segments are split into subsegments
+    bool NeedSidx() const;
+
     struct Impl;
 
     unique_ptr<Impl> m_impl;
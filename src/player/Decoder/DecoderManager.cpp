@@ -151,7 +151,7 @@ RenderStatus DecoderManager::SendVideoPackets( DashPacket* packets, uint32_t cnt
     for(int i=0; i<cnt; i++){
         packets[i].pts = currentPts;
         m_mapVideoDecoder[packets[i].videoID]->SendPacket(&(packets[i]));
-        LOG(INFO)<<"send packet to video "<<packets[i].videoID<<" and pts is : "<<currentPts<<endl;
+        LOG_TRACE<<"send packet to video "<<packets[i].videoID<<" and pts is : "<<currentPts<<endl;
     }
     currentPts++;
     return RENDER_STATUS_OK;
@@ -218,7 +218,7 @@ RenderStatus DecoderManager::UpdateVideoFrames( uint64_t pts )
             it++;
         }
     }
-    LOG(INFO)<<"Update one frame at:"<<pts<<endl;
+    LOG_TRACE<<"Update one frame at:"<<pts<<endl;
     return ret;
 }
 
@@ -43,7 +43,6 @@ VideoDecoder::VideoDecoder()
     mVideoId    = -1;
     mPkt        = NULL;
     mPktInfo    = NULL;
-    mRwpk       = NULL;
 }
 
 VideoDecoder::~VideoDecoder()
@@ -57,7 +56,6 @@ VideoDecoder::~VideoDecoder()
         mPkt = NULL;
     }
     mPktInfo = NULL;
-    mRwpk = NULL;
 }
 
 RenderStatus VideoDecoder::Initialize(int32_t id, Codec_Type codec, FrameHandler* handler)
@@ -160,13 +158,11 @@ RenderStatus VideoDecoder::SendPacket(DashPacket* packet)
     RenderStatus ret = RENDER_STATUS_OK;
 
     mPktInfo = new PacketInfo;
-    mRwpk = new RegionWisePacking;
     mPkt = av_packet_alloc();
-    if (mPktInfo == NULL || mRwpk == NULL || mPkt == NULL)
+    if (mPktInfo == NULL || mPkt == NULL)
     {
         LOG(ERROR)<<" alloc memory failed in send packet! " << endl;
         SAFE_DELETE(mPktInfo);
-        SAFE_DELETE(mRwpk);
         av_packet_free(&mPkt);
         return RENDER_ERROR;
     }
@@ -184,15 +180,27 @@ RenderStatus VideoDecoder::SendPacket(DashPacket* packet)
         {
             SAFE_DELETE(mPktInfo);
             av_packet_free(&mPkt);
-            SAFE_DELETE(mRwpk);
             return RENDER_ERROR;
         }
         memcpy_s(mPkt->data, size, packet->buf, size);
         mPkt->size = size;
-        *mRwpk = *(packet->rwpk);
+        // take the reference of the shared rwpk, the packets without reference own the rwpk
+        SharedRwpk::Ptr rwpk;
+        if (packet->rwpkRef)
+        {
+            rwpk = SharedRwpk::FromHandle(packet->rwpkRef);
+            SharedRwpk::ReleaseHandle(packet->rwpkRef);
+        }
+        else if (packet->rwpk)
+        {
+            rwpk = RWPKCACHE::GetInstance()->Share(*(packet->rwpk));
+            SAFE_DELETE_ARRAY(packet->rwpk->rectRegionPacking);
+            SAFE_DELETE(packet->rwpk);
+        }
+        packet->rwpkRef = NULL;
+        packet->rwpk = NULL;
 
         SAFE_FREE(packet->buf);
-        SAFE_DELETE(packet->rwpk);
 
         FrameData* data = new FrameData;
         mPktInfo->pkt = mPkt;
@@ -200,7 +208,7 @@ RenderStatus VideoDecoder::SendPacket(DashPacket* packet)
         mPktInfo->pts = packet->pts;
         mPktInfo->video_id = packet->videoID;
         mDecCtx->push_packet(mPktInfo);
-        data->rwpk = mRwpk;
+        data->rwpk = rwpk;
         // data->pts = mPkt->pts;
         data->pts = mPktInfo->pts;
         data->numQuality = packet->numQuality;
@@ -214,7 +222,7 @@ RenderStatus VideoDecoder::SendPacket(DashPacket* packet)
             data->qtyResolution[i].qualityRanking = packet->qtyResolution[i].qualityRanking;
         }
         mDecCtx->push_framedata(data);
-        LOG(INFO)<<"frame data fifo size is: "<<mDecCtx->get_size_of_framedata()<<endl;
+        LOG_TRACE<<"frame data fifo size is: "<<mDecCtx->get_size_of_framedata()<<endl;
         // SAFE_DELETE_ARRAY(packet->qtyResolution);
     }
 
@@ -248,7 +256,7 @@ RenderStatus VideoDecoder::DecodeFrame(AVPacket *pkt, uint32_t video_id)
     }
     if (av_frame->linesize[0] == 0)
     {
-        LOG(INFO)<<"av_frame is null! video_id is "<<video_id<<endl;
+        LOG_EVERY_MS(INFO, LOG_INTERVAL_MS)<<"av_frame is null! video_id is "<<video_id<<endl;
         av_frame_free(&av_frame);
         return RENDER_DECODER_INVALID_FRAME;
     }
@@ -267,12 +275,12 @@ RenderStatus VideoDecoder::DecodeFrame(AVPacket *pkt, uint32_t video_id)
     frame->qtyResolution = data->qtyResolution;
     frame->video_id = video_id;
     frame->bEOS = false;
-    LOG(INFO)<<"Push one frame at:"<<data->pts<<" video id is:"<<video_id<<endl;
+    LOG_TRACE<<"Push one frame at:"<<data->pts<<" video id is:"<<video_id<<endl;
     mDecCtx->push_frame(frame);
     //SAFE_DELETE(data->rwpk);
     SAFE_DELETE(data);
     uint64_t end = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    LOG(INFO)<<" decode one frame cost time "<<(end-start)<<" ms reso is " << mDecCtx->codec_ctx->width <<" x " <<mDecCtx->codec_ctx->height<<endl;
+    LOG_TRACE<<" decode one frame cost time "<<(end-start)<<" ms reso is " << mDecCtx->codec_ctx->width <<" x " <<mDecCtx->codec_ctx->height<<endl;
     return RENDER_STATUS_OK;
 }
 
@@ -336,7 +344,7 @@ RenderStatus VideoDecoder::FlushDecoder()
 bool VideoDecoder::MediaInfoChange(DashPacket* packet)
 {
     bool bChange = false;
-    LOG(INFO)<<"packet has width "<<packet->width << " and height "<<packet->height<<endl;
+    LOG_TRACE<<"packet has width "<<packet->width << " and height "<<packet->height<<endl;
     if(packet->height != mDecCtx->height && mDecCtx->height != 0){ // not the first time.
         LOG(INFO)<<"height has changed from "<<mDecCtx->height << " to "<<packet->height << endl;
         bChange = true;
@@ -406,7 +414,7 @@ void VideoDecoder::Run()
             continue;
         }
 
-        LOG(INFO)<<"Now packet pts is "<<pkt_info->pts<<endl;
+        LOG_TRACE<<"Now packet pts is "<<pkt_info->pts<<endl;
 
 	    // check eos status and do flush operation.
         if(pkt_info->bEOS)
@@ -428,7 +436,7 @@ void VideoDecoder::Run()
 
         ret = DecodeFrame(pkt_info->pkt, pkt_info->video_id);
         if(RENDER_STATUS_OK != ret){
-             LOG(INFO)<<"Video "<< mVideoId <<": failed to decoder one frame"<<std::endl;
+             LOG_EVERY_MS(INFO, LOG_INTERVAL_MS)<<"Video "<< mVideoId <<": failed to decoder one frame"<<std::endl;
         }
 
         av_packet_unref(pkt_info->pkt);
@@ -443,26 +451,23 @@ DecodedFrame* VideoDecoder::GetFrame(uint64_t pts)
     DecodedFrame* frame = NULL;
     while(mDecCtx->get_size_of_frame() > 0){
         frame = mDecCtx->get_front_of_frame();
-        LOG(INFO)<<"frame size is: " << mDecCtx->get_size_of_frame() << " and frame pts is: "<< frame->pts<<" and input pts is: "<<pts<<" video id is: "<<mVideoId<<endl;
+        LOG_TRACE<<"frame size is: " << mDecCtx->get_size_of_frame() << " and frame pts is: "<< frame->pts<<" and input pts is: "<<pts<<" video id is: "<<mVideoId<<endl;
         if(frame->pts == pts)
         {
             frame = mDecCtx->pop_frame();
-            LOG(INFO)<<"Pop one frame at:"<<pts<<" video id is:"<<mVideoId<<endl;
+            LOG_TRACE<<"Pop one frame at:"<<pts<<" video id is:"<<mVideoId<<endl;
             break;
         }
         else if (frame->pts > pts) // wait
         {
-            LOG(INFO)<<"Need to wait frame to match current pts!"<<endl;
+            LOG_TRACE<<"Need to wait frame to match current pts!"<<endl;
             frame = NULL;
             break;
         }
         // drop over time frame.
         frame = mDecCtx->pop_frame();
-        LOG(INFO)<<"Now will drop one frame since pts is over time! input pts is:" << pts <<" frame pts is:" << frame->pts<<"video id is:" << mVideoId<<endl;
+        LOG_EVERY_MS(INFO, LOG_INTERVAL_MS)<<"Now will drop one frame since pts is over time! input pts is:" << pts <<" frame pts is:" << frame->pts<<"video id is:" << mVideoId<<endl;
         av_frame_free(&frame->av_frame);
-        if (frame->rwpk)
-            SAFE_DELETE_ARRAY(frame->rwpk->rectRegionPacking);
-        SAFE_DELETE(frame->rwpk);
         SAFE_DELETE_ARRAY(frame->qtyResolution);
         SAFE_DELETE(frame);
     }
@@ -492,10 +497,10 @@ RenderStatus VideoDecoder::UpdateFrame(uint64_t pts)
     uint64_t start1 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
     DecodedFrame* frame = GetFrame(pts);
     uint64_t end1 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    LOG(INFO)<<"GetFrame time is:"<<(end1 - start1)<<endl;
+    LOG_TRACE<<"GetFrame time is:"<<(end1 - start1)<<endl;
     if(NULL==frame)
     {
-        LOG(INFO)<<"Frame is empty!"<<endl;
+        LOG_EVERY_MS(INFO, LOG_INTERVAL_MS)<<"Frame is empty!"<<endl;
         return RENDER_NO_FRAME;
     }
     if (frame->bEOS)
@@ -538,13 +543,13 @@ RenderStatus VideoDecoder::UpdateFrame(uint64_t pts)
     buf_info->regionInfo = new RegionData(frame->rwpk, frame->numQuality, frame->qtyResolution);
 
     uint64_t end2 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    LOG(INFO)<<"Transfer frame time is:"<<(end2 - start2)<<endl;
+    LOG_TRACE<<"Transfer frame time is:"<<(end2 - start2)<<endl;
     uint64_t start3 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
     if(NULL != this->mHandler){
         mHandler->process(buf_info);
     }
     uint64_t end3 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    LOG(INFO)<<"process time is:"<<(end3 - start3)<<endl;
+    LOG_TRACE<<"process time is:"<<(end3 - start3)<<endl;
     uint64_t start4 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
 
     // for (uint32_t i = 0; i < bufferNumber; i++){
@@ -556,12 +561,10 @@ RenderStatus VideoDecoder::UpdateFrame(uint64_t pts)
 
     av_frame_free(&frame->av_frame);
     // av_frame_unref(frame->av_frame);
-    SAFE_DELETE_ARRAY(frame->rwpk->rectRegionPacking);
-    SAFE_DELETE(frame->rwpk);
     SAFE_DELETE_ARRAY(frame->qtyResolution);
     SAFE_DELETE(frame);
     uint64_t end4 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    LOG(INFO)<<"delete frame time is:"<<(end4 - start4)<<endl;
+    LOG_TRACE<<"delete frame time is:"<<(end4 - start4)<<endl;
     return RENDER_STATUS_OK;
 }
 
@@ -572,7 +575,7 @@ RenderStatus VideoDecoder::SetRegionInfo(struct RegionInfo *regionInfo, int32_t
 
 bool VideoDecoder::IsReady()
 {
-    LOG(INFO)<<"At first, frame size is"<<mDecCtx->get_size_of_frame()<<" and packet eos is "<< mDecCtx->bPacketEOS << endl;
+    LOG_TRACE<<"At first, frame size is"<<mDecCtx->get_size_of_frame()<<" and packet eos is "<< mDecCtx->bPacketEOS << endl;
     if (mDecCtx->get_size_of_frame() > MIN_REMAIN_SIZE_IN_FRAME || mDecCtx->bPacketEOS ){
         return true;
     }else{
@@ -35,6 +35,7 @@
 
 #include "MediaDecoder.h"
 #include "../../utils/Threadable.h"
+#include "../../utils/RwpkCache.h"
 #include <list>
 
 #define MAX_FRAME_SIZE 60
@@ -51,7 +52,7 @@ typedef struct PacketInfo{
 
 typedef struct DecodedFrame{
      AVFrame            *av_frame;
-     RegionWisePacking  *rwpk;
+     SharedRwpk::Ptr    rwpk;
      uint64_t           pts;
      bool               bFmtChange;
      int32_t            numQuality;
@@ -62,7 +63,7 @@ typedef struct DecodedFrame{
 
 typedef struct FrameData{
      uint64_t           pts;
-     RegionWisePacking* rwpk;
+     SharedRwpk::Ptr    rwpk;
      int32_t            numQuality;
      SourceResolution*  qtyResolution;
      bool               bCodecChange;
@@ -90,8 +91,6 @@ public:
           while(get_size_of_frame()>0){
                DecodedFrame* frame = listFrame.front();
                listFrame.pop_front();
-               SAFE_DELETE_ARRAY(frame->rwpk->rectRegionPacking);
-               SAFE_DELETE(frame->rwpk);
                SAFE_DELETE_ARRAY(frame->qtyResolution);
                av_frame_free(&frame->av_frame);
                SAFE_DELETE(frame);
@@ -107,9 +106,7 @@ public:
           while(get_size_of_framedata()>0){
                FrameData* data = listFrameData.front();
                listFrameData.pop_front();
-               SAFE_DELETE_ARRAY(data->rwpk->rectRegionPacking);
                SAFE_DELETE_ARRAY(data->qtyResolution);
-               SAFE_DELETE(data->rwpk);
                SAFE_DELETE(data);
           }
      };
@@ -332,7 +329,6 @@ private:
      FrameHandler*                mHandler;
      AVPacket                    *mPkt;
      PacketInfo                  *mPktInfo;
-     RegionWisePacking           *mRwpk;
 };
 
 VCD_NS_END
@@ -36,6 +36,7 @@
 #include <sys/timeb.h>
 #include <time.h>
 #include "../../utils/tinyxml2.h"
+#include "../../utils/RwpkCache.h"
 #include "../RenderType.h"
 #include "OmafDashAccessApi.h"
 #ifdef _USE_TRACE_
@@ -96,6 +97,9 @@ RenderStatus DashMediaSource::Initialize(struct RenderConfig renderConfig, Rende
   pCtxDashStreaming->omaf_params.http_params.conn_timeout = -1;  // not set
   pCtxDashStreaming->omaf_params.http_params.retry_times = 3;
   pCtxDashStreaming->omaf_params.http_params.total_timeout = -1;  // not set
+  pCtxDashStreaming->omaf_params.http_params.http_version = 2;    // HTTP/2 when the server negotiates it
+  pCtxDashStreaming->omaf_params.http_params.disable_multiplex = 0;
+  pCtxDashStreaming->omaf_params.http_params.warmup_connections = 4;
 
   pCtxDashStreaming->omaf_params.max_parallel_transfers = 256;
   pCtxDashStreaming->omaf_params.segment_open_timeout_ms = 3000;           // ms
@@ -105,6 +109,20 @@ RenderStatus DashMediaSource::Initialize(struct RenderConfig renderConfig, Rende
   pCtxDashStreaming->omaf_params.synchronizer_params.enable = 0;               //  enable dash segment number syncer
   pCtxDashStreaming->omaf_params.synchronizer_params.segment_range_size = 20;  // 20
 
+  pCtxDashStreaming->omaf_params.abr_params.enable = 1;                  // limit viewport tiles by bandwidth
+  pCtxDashStreaming->omaf_params.abr_params.target_buffer_ms = 3000;     // ms
+  pCtxDashStreaming->omaf_params.abr_params.min_viewport_hq_tiles = 1;
+
+  pCtxDashStreaming->omaf_params.cache_params.enable = 1;                          // keep segments in memory
+  pCtxDashStreaming->omaf_params.cache_params.memory_budget = 64 * 1024 * 1024;    // bytes
+  pCtxDashStreaming->omaf_params.cache_params.enable_spill = 1;                    // spill evicted ones to cache path
+  pCtxDashStreaming->omaf_params.cache_params.spill_budget = 256 * 1024 * 1024;    // bytes
+  pCtxDashStreaming->omaf_params.cache_params.enable_init_cache = 1;               // reuse init segments on rejoin
+
+  pCtxDashStreaming->omaf_params.sub_segment_params.enable = 1;             // tiles into viewport start from next subsegment
+  pCtxDashStreaming->omaf_params.sub_segment_params.index_probe_size = 4096;  // bytes
+  pCtxDashStreaming->omaf_params.sub_segment_params.check_interval_ms = 200;  // ms
+
   m_handler = OmafAccess_Init(pCtxDashStreaming);
   if (NULL == m_handler) {
     LOG(ERROR) << "handler init failed!" << std::endl;
@@ -308,7 +326,7 @@ void DashMediaSource::ProcessVideoPacket() {
   if (dashPkt[0].bEOS) {
     m_status = STATUS_STOPPED;
   }
-  LOG(INFO) << "Get packet has done! and segment id is " << dashPkt[0].segID << std::endl;
+  LOG_TRACE << "Get packet has done! and segment id is " << dashPkt[0].segID << std::endl;
 #ifdef _USE_TRACE_
   // trace
   tracepoint(mthq_tp_provider, T7_get_packet, dashPkt[0].segID);
@@ -321,15 +339,17 @@ void DashMediaSource::ProcessVideoPacket() {
     RenderStatus ret = m_DecoderManager->SendVideoPackets(&(dashPkt[0]), dashPktNum);
     // needHeaders = false;
     if (RENDER_STATUS_OK != ret) {
-      LOG(INFO) << "m_DecoderManager::SendVideoPackets: stream_id:" << vi.streamID << " segment id" << dashPkt[0].segID
-                << std::endl;
+      LOG_EVERY_MS(INFO, LOG_INTERVAL_MS) << "m_DecoderManager::SendVideoPackets: stream_id:" << vi.streamID
+                                          << " segment id" << dashPkt[0].segID << std::endl;
     }
   }
 
   for (int i = 0; i < dashPktNum; i++) {
     SAFE_FREE(dashPkt[i].buf);
-    if (dashPkt[i].rwpk) SAFE_DELETE_ARRAY(dashPkt[i].rwpk->rectRegionPacking);
-    SAFE_DELETE(dashPkt[i].rwpk);
+    // the decoder takes the rwpk reference it needs, the rest is released here
+    VCD::VRVideo::SharedRwpk::ReleaseHandle(dashPkt[i].rwpkRef);
+    dashPkt[i].rwpkRef = NULL;
+    dashPkt[i].rwpk = NULL;
     SAFE_DELETE_ARRAY(dashPkt[i].qtyResolution);
   }
 }
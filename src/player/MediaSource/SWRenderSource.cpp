@@ -256,7 +256,7 @@ RenderStatus SWRenderSource::UpdateR2T(BufferInfo* bufInfo)
             renderBackend->TexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, sourceWH.width[i], sourceWH.height[i], GL_RED, GL_UNSIGNED_BYTE, bufInfo->buffer[i]); //use yuv data
     }
     uint64_t end1 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    LOG(INFO)<<"update process is:"<<(end1 - start1)<<endl;
+    LOG_TRACE<<"update process is:"<<(end1 - start1)<<endl;
     //2. bind source texture and r2tFBO
     uint64_t start2 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
     uint32_t fboR2THandle = GetFboR2THandle();
@@ -279,7 +279,7 @@ RenderStatus SWRenderSource::UpdateR2T(BufferInfo* bufInfo)
     renderBackend->Viewport(0, 0, sourceWH.width[0], sourceWH.height[0]);
     renderBackend->DrawArrays(GL_TRIANGLES, 0, 6);
     uint64_t end2 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    LOG(INFO)<<"bind process is:"<<(end2 - start2)<<endl;
+    LOG_TRACE<<"bind process is:"<<(end2 - start2)<<endl;
     return RENDER_STATUS_OK;
 }
 
@@ -319,17 +319,17 @@ RenderStatus SWRenderSource::process(BufferInfo* bufInfo)
         }
     }
     uint64_t end3 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    LOG(INFO)<<"init process is:"<<(end3 - start3)<<endl;
+    LOG_TRACE<<"init process is:"<<(end3 - start3)<<endl;
     // mCurRegionInfo = bufInfo->regionInfo;
     uint64_t start1 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    mCurRegionInfo = new RegionData(bufInfo->regionInfo->GetRegionWisePacking(), bufInfo->regionInfo->GetSourceInRegion(), bufInfo->regionInfo->GetSourceInfo());
+    mCurRegionInfo = new RegionData(bufInfo->regionInfo->GetSharedRwpk(), bufInfo->regionInfo->GetSourceInRegion(), bufInfo->regionInfo->GetSourceInfo());
     // LOG(INFO)<<"regionInfo ptr:"<<mCurRegionInfo->GetSourceInRegion()<<" rwpk:"<<mCurRegionInfo->GetRegionWisePacking()->rectRegionPacking<<" source:"<<mCurRegionInfo->GetSourceInfo()->width<<endl;
     uint64_t end1 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    LOG(INFO)<<"regioninfo process is:"<<(end1 - start1)<<endl;
+    LOG_TRACE<<"regioninfo process is:"<<(end1 - start1)<<endl;
     uint64_t start2 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
     ret = this->UpdateR2T(bufInfo);
     uint64_t end2 = std::chrono::duration_cast<std::chrono::milliseconds>(clock.now().time_since_epoch()).count();
-    LOG(INFO)<<"UpdateR2T process is:"<<(end2 - start2)<<endl;
+    LOG_TRACE<<"UpdateR2T process is:"<<(end2 - start2)<<endl;
     if(RENDER_STATUS_OK!=ret){
         LOG(ERROR)<<"Video "<< GetVideoID() <<": UpdateR2T failed"<<std::endl;
         return ret;
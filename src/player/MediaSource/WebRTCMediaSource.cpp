@@ -46,6 +46,7 @@
 #include "owt/conference/remotemixedstream.h"
 
 #include "../utils/tinyxml2.h"
+#include "../utils/RwpkCache.h"
 
 VCD_NS_BEGIN
 using namespace tinyxml2;
@@ -153,24 +154,6 @@ static void filter_RWPK_SEI(std::shared_ptr<SimpleBuffer> bitstream_buf,
   filterNALs(bitstream_buf, sei_types, sei_buf);
 }
 
-RegionWisePacking* alloc_RegionWisePacking() {
-  RegionWisePacking* rwpk = new RegionWisePacking();
-  assert(rwpk != NULL);
-  memset(rwpk, 0, sizeof(RegionWisePacking));
-
-  rwpk->rectRegionPacking =
-      new RectangularRegionWisePacking[DEFAULT_REGION_NUM];
-  assert(rwpk->rectRegionPacking != NULL);
-
-  return rwpk;
-}
-
-void free_RegionWisePacking(RegionWisePacking* rwpk) {
-  if (rwpk)
-    SAFE_DELETE_ARRAY(rwpk->rectRegionPacking);
-  SAFE_DELETE(rwpk);
-}
-
 WebRTCMediaSource* WebRTCMediaSource::s_CurObj;
 
 void WebRTCMediaSource::subscribe_on_success_callback(
@@ -458,18 +441,25 @@ bool WebRTCMediaSource::OnVideoPacket(
     return false;
   }
 
-  RegionWisePacking* rwpk = alloc_RegionWisePacking();
-  assert(rwpk != NULL);
-
-  I360SCVP_ParseRWPK(m_parserRWPKHandle, rwpk, sei_buf->data(),
-                     sei_buf->size());
-
-  // just workaround
-  int temp = rwpk->lowResPicHeight;
-  rwpk->lowResPicHeight = rwpk->lowResPicWidth;
-  rwpk->lowResPicWidth = temp;
+  // the packing is kept by the mixer, the frames with the same packing share it
+  void* parserHandle = m_parserRWPKHandle;
+  SharedRwpk::Ptr sharedRwpk = RWPKCACHE::GetInstance()->ParseSEI(
+      sei_buf->data(), sei_buf->size(), [parserHandle, &sei_buf](RegionWisePacking* parsed) {
+        int32_t parseRet = I360SCVP_ParseRWPK(parserHandle, parsed, sei_buf->data(), sei_buf->size());
+        // just workaround
+        int temp = parsed->lowResPicHeight;
+        parsed->lowResPicHeight = parsed->lowResPicWidth;
+        parsed->lowResPicWidth = temp;
+        return parseRet;
+      });
+  if (!sharedRwpk) {
+    LOG(ERROR) << "Failed to parse rwpk sei!" << std::endl;
+    return false;
+  }
+  const RegionWisePacking* rwpk = sharedRwpk->Get();
 
   DashPacket dashPkt;
+  memset(&dashPkt, 0, sizeof(DashPacket));
   dashPkt.videoID = 0;
   dashPkt.video_codec = VideoCodec_HEVC;
   dashPkt.segID = 0;
@@ -497,7 +487,9 @@ bool WebRTCMediaSource::OnVideoPacket(
   dashPkt.buf = buf;
   dashPkt.size = bitstream_buf->size();
   dashPkt.pts = frame->time_stamp;
-  dashPkt.rwpk = rwpk;
+  dashPkt.rwpk = const_cast<RegionWisePacking*>(rwpk);
+  dashPkt.rwpkRef = SharedRwpk::ToHandle(sharedRwpk);
+  dashPkt.rwpkVersion = sharedRwpk->Version();
   dashPkt.bEOS = false;
 
   RenderStatus ret = m_DecoderManager->SendVideoPackets(&dashPkt, 1);
@@ -507,7 +499,7 @@ bool WebRTCMediaSource::OnVideoPacket(
 
   SAFE_FREE(dashPkt.buf);
   SAFE_DELETE_ARRAY(dashPkt.qtyResolution);
-  free_RegionWisePacking(dashPkt.rwpk);
+  SharedRwpk::ReleaseHandle(dashPkt.rwpkRef);
   return true;
 }
 
@@ -40,14 +40,10 @@
 
 VCD_NS_BEGIN
 
-RegionData::RegionData(RegionWisePacking* rwpk, uint32_t sourceNumber, SourceResolution* qtyRes) {
+RegionData::RegionData(SharedRwpk::Ptr rwpk, uint32_t sourceNumber, SourceResolution* qtyRes) {
   m_sourceInRegion = sourceNumber;
 
-  m_regionWisePacking = new RegionWisePacking;
-  *m_regionWisePacking = *rwpk;
-  m_regionWisePacking->rectRegionPacking = new RectangularRegionWisePacking[rwpk->numRegions];
-  memcpy_s(m_regionWisePacking->rectRegionPacking, rwpk->numRegions * sizeof(RectangularRegionWisePacking),
-           rwpk->rectRegionPacking, rwpk->numRegions * sizeof(RectangularRegionWisePacking));
+  m_regionWisePacking = rwpk;
 
   m_sourceInfo = new SourceResolution[sourceNumber];
   for (uint32_t i = 0; i < sourceNumber; i++) {
@@ -61,14 +57,7 @@ RegionData::RegionData(RegionWisePacking* rwpk, uint32_t sourceNumber, SourceRes
 
 RegionData::~RegionData() {
   m_sourceInRegion = 0;
-  if (m_regionWisePacking != NULL) {
-    if (m_regionWisePacking->rectRegionPacking != NULL) {
-      delete[] m_regionWisePacking->rectRegionPacking;
-      m_regionWisePacking->rectRegionPacking = NULL;
-    }
-    delete m_regionWisePacking;
-    m_regionWisePacking = NULL;
-  }
+  m_regionWisePacking.reset();
   if (m_sourceInfo != NULL) {
     delete[] m_sourceInfo;
     m_sourceInfo = NULL;
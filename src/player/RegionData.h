@@ -41,6 +41,7 @@
 #include <stdint.h>
 #include <string>
 #include "data_type.h"
+#include "../utils/RwpkCache.h"
 
 VCD_NS_BEGIN
 
@@ -51,10 +52,12 @@ public:
     //!
     RegionData(){
         m_sourceInRegion = 0;
-        m_regionWisePacking = NULL;
         m_sourceInfo = NULL;
     };
-    RegionData(RegionWisePacking* rwpk, uint32_t sourceNumber, SourceResolution* qtyRes);
+    //!
+    //! \brief  construct with the shared rwpk, it is referenced instead of copied
+    //!
+    RegionData(SharedRwpk::Ptr rwpk, uint32_t sourceNumber, SourceResolution* qtyRes);
     //!
     //! \brief  de-construct
     //!
@@ -63,7 +66,14 @@ public:
     uint32_t GetSourceInRegion() { return m_sourceInRegion; };
     void SetSourceInRegion(uint32_t num){ m_sourceInRegion = num; };
 
-    RegionWisePacking* GetRegionWisePacking() { return m_regionWisePacking; };
+    const RegionWisePacking* GetRegionWisePacking() { return m_regionWisePacking ? m_regionWisePacking->Get() : NULL; };
+
+    SharedRwpk::Ptr GetSharedRwpk() { return m_regionWisePacking; };
+
+    //!
+    //! \brief  the regions with the same version share the same packing, 0 means no rwpk
+    //!
+    uint64_t GetRwpkVersion() { return m_regionWisePacking ? m_regionWisePacking->Version() : 0; };
 
     SourceResolution* GetSourceInfo() { return m_sourceInfo; }
 
@@ -74,7 +84,7 @@ private:
 private:
 
     uint32_t m_sourceInRegion;
-    RegionWisePacking *m_regionWisePacking;
+    SharedRwpk::Ptr    m_regionWisePacking;
     SourceResolution *m_sourceInfo;
 };
 
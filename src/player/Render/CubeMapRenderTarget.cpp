@@ -315,7 +315,9 @@ int32_t CubeMapRenderTarget::findQuality(RegionData *regionInfo, RectangularRegi
         || regionInfo->GetSourceInfo() == NULL || regionInfo->GetSourceInRegion() > 2 || regionInfo->GetSourceInRegion() <= 0){
             continue;
         }
-        uint16_t numRegion = regionInfo->GetRegionWisePacking()->numRegions;
+        // the tiles are transferred again only when the rwpk or sources change
+        RegionTilesCache &cache = m_regionTilesCache[video_id];
+        uint16_t numRegion = CheckRegionTilesCache(video_id, regionInfo) ? 0 : regionInfo->GetRegionWisePacking()->numRegions;
         for(int32_t idx=0; idx<numRegion; idx++){
             TileInformation tile_info;
             // 1. get basic information for tile_info
@@ -346,8 +348,8 @@ int32_t CubeMapRenderTarget::findQuality(RegionData *regionInfo, RectangularRegi
             // 3. correct proj left/top in face
             tile_info.projRegTop -= cube_map_face_height * rowIdx;
             tile_info.projRegLeft -= cube_map_face_width * colIdx;
-            // 4. push tile_info into map
-            mQualityRankingInfo.mapQualitySelection[quality].push_back(tile_info);
+            // 4. push tile_info into cache
+            cache.tiles.push_back(std::make_pair(quality, tile_info));
             if (m_transformType.find(tile_info.face_id) != m_transformType.end())
             {
                 if (m_transformType[tile_info.face_id] != tile_info.transformType) // exist and changed
@@ -363,6 +365,10 @@ int32_t CubeMapRenderTarget::findQuality(RegionData *regionInfo, RectangularRegi
                 m_transformType.insert(make_pair(tile_info.face_id, tile_info.transformType));
             }
         }
+        for (auto tile = cache.tiles.begin(); tile != cache.tiles.end(); tile++)
+        {
+            mQualityRankingInfo.mapQualitySelection[tile->first].push_back(tile->second);
+        }
         it->second->SafeDeleteRegionInfo();
         regionInfo = NULL;
     }
@@ -320,7 +320,9 @@ int32_t ERPRenderTarget::findQuality(RegionData *regionInfo, RectangularRegionWi
         || regionInfo->GetSourceInfo() == NULL || regionInfo->GetSourceInRegion() > 2 || regionInfo->GetSourceInRegion() <= 0){
             continue;
         }
-        uint16_t numRegion = regionInfo->GetRegionWisePacking()->numRegions;
+        // the tiles are transferred again only when the rwpk or sources change
+        RegionTilesCache &cache = m_regionTilesCache[video_id];
+        uint16_t numRegion = CheckRegionTilesCache(video_id, regionInfo) ? 0 : regionInfo->GetRegionWisePacking()->numRegions;
         for(int32_t idx=0; idx<numRegion; idx++){
             TileInformation tile_info;
             tile_info.projRegLeft     = regionInfo->GetRegionWisePacking()->rectRegionPacking[idx].projRegLeft;
@@ -340,7 +342,11 @@ int32_t ERPRenderTarget::findQuality(RegionData *regionInfo, RectangularRegionWi
             int32_t quality = findQuality(regionInfo, regionInfo->GetRegionWisePacking()->rectRegionPacking[idx], source_idx);
             tile_info.tile_id = (coord.first + 1) + m_rsFactory->GetHighTileCol() * coord.second;
 
-            mQualityRankingInfo.mapQualitySelection[quality].push_back(tile_info);
+            cache.tiles.push_back(std::make_pair(quality, tile_info));
+        }
+        for (auto tile = cache.tiles.begin(); tile != cache.tiles.end(); tile++)
+        {
+            mQualityRankingInfo.mapQualitySelection[tile->first].push_back(tile->second);
         }
         it->second->SafeDeleteRegionInfo();
         regionInfo = NULL;
@@ -38,6 +38,7 @@
 #include "RenderBackend.h"
 #include "../MediaSource/RenderSourceFactory.h"
 #include <map>
+#include <vector>
 
 VCD_NS_BEGIN
 
@@ -64,6 +65,14 @@ typedef struct QualityRankingInfo{
     std::map<int32_t, std::vector<TileInformation>> mapQualitySelection;
 }QualityRankingInfo;
 
+//! the tiles transferred from the rwpk of one video, they are reused until the rwpk or sources change
+typedef struct RegionTilesCache{
+    uint64_t rwpkVersion;
+    uint32_t highTileCol;
+    std::vector<SourceResolution> sources;
+    std::vector<std::pair<int32_t, TileInformation>> tiles;    //! quality ranking and tile
+}RegionTilesCache;
+
 class RenderTarget
 {
 public:
@@ -123,6 +132,39 @@ public:
     std::map<uint32_t, uint8_t> GetTransformType() { return m_transformType; };
 
 protected:
+    //! \brief Check whether the cached tiles of the video match the region info,
+    //!        or reset the cache for the region info
+    //!
+    //! \param  [in] uint32_t
+    //!         video id
+    //!         [in] RegionData*
+    //!         current region info of the video
+    //! \return bool
+    //!         true if the cached tiles can be used, else the tiles need to be transferred again
+    //!
+    bool CheckRegionTilesCache(uint32_t video_id, RegionData *regionInfo)
+    {
+        RegionTilesCache &cache = m_regionTilesCache[video_id];
+        uint32_t highTileCol = m_rsFactory->GetHighTileCol();
+        bool bMatched = regionInfo->GetRwpkVersion() != 0 && cache.rwpkVersion == regionInfo->GetRwpkVersion()
+                        && cache.highTileCol == highTileCol && cache.sources.size() == regionInfo->GetSourceInRegion();
+        for (uint32_t i = 0; bMatched && i < cache.sources.size(); i++)
+        {
+            SourceResolution &src = regionInfo->GetSourceInfo()[i];
+            bMatched = cache.sources[i].qualityRanking == src.qualityRanking && cache.sources[i].left == src.left
+                       && cache.sources[i].top == src.top && cache.sources[i].width == src.width
+                       && cache.sources[i].height == src.height;
+        }
+        if (!bMatched)
+        {
+            cache.rwpkVersion = regionInfo->GetRwpkVersion();
+            cache.highTileCol = highTileCol;
+            cache.sources.assign(regionInfo->GetSourceInfo(), regionInfo->GetSourceInfo() + regionInfo->GetSourceInRegion());
+            cache.tiles.clear();
+        }
+        return bMatched;
+    };
+
     RenderSourceFactory*   m_rsFactory;                 //!RenderSource Factory;
     std::map<uint32_t, uint8_t> m_transformType;       //!transformtype
     uint32_t               m_fboOnScreenHandle;         //!output
@@ -130,6 +172,7 @@ protected:
     float                  m_avgChangedTime;            //!average time to change from blur to clear
     bool                   m_isAllHighQualityInView;    //!isAllHighResoInView
     QualityRankingInfo     mQualityRankingInfo;
+    std::map<uint32_t, RegionTilesCache> m_regionTilesCache; //!transferred tiles of each video
 };
 
 VCD_NS_END
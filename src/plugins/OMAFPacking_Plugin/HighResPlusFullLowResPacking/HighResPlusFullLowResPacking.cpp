@@ -105,6 +105,8 @@ HighPlusFullLowRegionWisePackingGenerator::HighPlusFullLowRegionWisePackingGener
     m_highResTilesInView  = std::move(src.m_highResTilesInView);
 
     m_mergedTilesArrange  = std::move(src.m_mergedTilesArrange);
+
+    m_viewportTiles       = src.m_viewportTiles;
 }
 
 HighPlusFullLowRegionWisePackingGenerator::~HighPlusFullLowRegionWisePackingGenerator()
@@ -344,25 +346,11 @@ int32_t HighPlusFullLowRegionWisePackingGenerator::GenerateTilesMergeDirection(
     if (!highTilesIdx)
         return OMAF_ERROR_NULL_PTR;
 
-    highTilesIdx[0] = viewportIdx;
-    for (uint8_t i = 1; i < highTilesNum; i++)
+    int32_t ret = GetHighResTilesIdx(viewportIdx, highTilesIdx);
+    if (ret)
     {
-        if (i % m_tilesNumInViewRow)
-        {
-            highTilesIdx[i] = highTilesIdx[i-1] + 1;
-            if (highTilesIdx[i] >= (highTilesIdx[i-1] / m_origHRTilesInRow + 1) * m_origHRTilesInRow)
-            {
-                highTilesIdx[i] = highTilesIdx[i] - m_origHRTilesInRow;
-            }
-        }
-        else
-        {
-            highTilesIdx[i] = (i / m_tilesNumInViewRow) * m_origHRTilesInRow + highTilesIdx[0];
-            if (highTilesIdx[i] >= m_origHRTilesInRow * m_origHRTilesInCol)
-            {
-                highTilesIdx[i] = highTilesIdx[i] - m_origHRTilesInRow * m_origHRTilesInCol;
-            }
-        }
+        SAFE_DELETE_ARRAY(highTilesIdx);
+        return ret;
     }
 #define LCU_SIZE 64
 
@@ -463,25 +451,11 @@ int32_t HighPlusFullLowRegionWisePackingGenerator::GenerateDstRwpk(
     if (!highTilesIdx)
         return OMAF_ERROR_NULL_PTR;
 
-    highTilesIdx[0] = viewportIdx;
-    for (uint8_t i = 1; i < highTilesNum; i++)
+    int32_t ret = GetHighResTilesIdx(viewportIdx, highTilesIdx);
+    if (ret)
     {
-        if (i % m_tilesNumInViewRow)
-        {
-            highTilesIdx[i] = highTilesIdx[i-1] + 1;
-            if (highTilesIdx[i] >= (highTilesIdx[i-1] / m_origHRTilesInRow + 1) * m_origHRTilesInRow)
-            {
-                highTilesIdx[i] = highTilesIdx[i] - m_origHRTilesInRow;
-            }
-        }
-        else
-        {
-            highTilesIdx[i] = (i / m_tilesNumInViewRow) * m_origHRTilesInRow + highTilesIdx[0];
-            if (highTilesIdx[i] >= m_origHRTilesInRow * m_origHRTilesInCol)
-            {
-                highTilesIdx[i] = highTilesIdx[i] - m_origHRTilesInRow * m_origHRTilesInCol;
-            }
-        }
+        SAFE_DELETE_ARRAY(highTilesIdx);
+        return ret;
     }
 
     std::map<uint8_t, RegionWisePacking*>::iterator it;
@@ -509,6 +483,8 @@ int32_t HighPlusFullLowRegionWisePackingGenerator::GenerateDstRwpk(
         if (regionIdx < highTilesNum)
         {
             RectangularRegionWisePacking *rectRwpkHigh = &(rwpkHighRes->rectRegionPacking[highTilesIdx[(regionIdx % m_hrTilesInCol) * m_hrTilesInRow + regionIdx / m_hrTilesInCol]]);
+            //keep the face rotation of the tile in cube map projected picture
+            rwpk->transformType = rectRwpkHigh->transformType;
             rwpk->projRegWidth  = rectRwpkHigh->projRegWidth;
             rwpk->projRegHeight = rectRwpkHigh->projRegHeight;
             rwpk->projRegTop    = rectRwpkHigh->projRegTop;
@@ -561,6 +537,72 @@ int32_t HighPlusFullLowRegionWisePackingGenerator::GenerateDstRwpk(
     return ERROR_NONE;
 }
 
+int32_t HighPlusFullLowRegionWisePackingGenerator::SetTilesForViewport(
+    uint8_t viewportIdx,
+    uint8_t tilesNum,
+    uint8_t *tilesIdx)
+{
+    if (!tilesIdx)
+        return OMAF_ERROR_NULL_PTR;
+
+    if (tilesNum != m_tilesNumInViewRow * m_tileRowNumInView)
+        return OMAF_ERROR_INVALID_DATA;
+
+    for (uint8_t i = 0; i < tilesNum; i++)
+    {
+        if (tilesIdx[i] >= m_origHRTilesInRow * m_origHRTilesInCol)
+            return OMAF_ERROR_INVALID_DATA;
+    }
+
+    m_viewportTiles[viewportIdx] = std::vector<uint8_t>(tilesIdx, tilesIdx + tilesNum);
+
+    return ERROR_NONE;
+}
+
+int32_t HighPlusFullLowRegionWisePackingGenerator::GetHighResTilesIdx(
+    uint8_t viewportIdx,
+    uint8_t *highTilesIdx)
+{
+    if (!highTilesIdx)
+        return OMAF_ERROR_NULL_PTR;
+
+    uint8_t highTilesNum = m_tilesNumInViewRow * m_tileRowNumInView;
+
+    std::map<uint8_t, std::vector<uint8_t>>::iterator it = m_viewportTiles.find(viewportIdx);
+    if (it != m_viewportTiles.end())
+    {
+        std::vector<uint8_t> &tiles = it->second;
+        for (uint8_t i = 0; i < highTilesNum; i++)
+        {
+            highTilesIdx[i] = tiles[i];
+        }
+        return ERROR_NONE;
+    }
+
+    highTilesIdx[0] = viewportIdx;
+    for (uint8_t i = 1; i < highTilesNum; i++)
+    {
+        if (i % m_tilesNumInViewRow)
+        {
+            highTilesIdx[i] = highTilesIdx[i-1] + 1;
+            if (highTilesIdx[i] >= (highTilesIdx[i-1] / m_origHRTilesInRow + 1) * m_origHRTilesInRow)
+            {
+                highTilesIdx[i] = highTilesIdx[i] - m_origHRTilesInRow;
+            }
+        }
+        else
+        {
+            highTilesIdx[i] = (i / m_tilesNumInViewRow) * m_origHRTilesInRow + highTilesIdx[0];
+            if (highTilesIdx[i] >= m_origHRTilesInRow * m_origHRTilesInCol)
+            {
+                highTilesIdx[i] = highTilesIdx[i] - m_origHRTilesInRow * m_origHRTilesInCol;
+            }
+        }
+    }
+
+    return ERROR_NONE;
+}
+
 extern "C" RegionWisePackingGeneratorBase* Create()
 {
     HighPlusFullLowRegionWisePackingGenerator *rwpkGen = new HighPlusFullLowRegionWisePackingGenerator;
@@ -572,3 +614,13 @@ extern "C" void Destroy(RegionWisePackingGeneratorBase* rwpkGen)
     delete rwpkGen;
     rwpkGen = NULL;
 }
+
+extern "C" uint32_t GetAPIVersion()
+{
+    return OMAF_PACKING_API_VERSION;
+}
+
+extern "C" uint32_t GetCapabilities()
+{
+    return OMAF_PACKING_CAP_VIEWPORT_TILES;
+}
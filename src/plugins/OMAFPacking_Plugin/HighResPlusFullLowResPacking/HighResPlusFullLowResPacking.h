@@ -162,7 +162,48 @@ public:
     //!
     TileArrangement* GetMergedTilesArrange() { return m_mergedTilesArrange; };
 
+    //!
+    //! \brief  Get the capabilities of the plugin
+    //!
+    //! \return uint32_t
+    //!         OMAF_PACKING_CAP_VIEWPORT_TILES
+    //!
+    uint32_t GetCapabilities() { return OMAF_PACKING_CAP_VIEWPORT_TILES; };
+
+protected:
+    //!
+    //! \brief  Set the high resolution tiles selected for specified
+    //!         viewport
+    //!
+    //! \param  [in] viewportIdx
+    //!         the index of specified viewport
+    //! \param  [in] tilesNum
+    //!         the number of selected tiles
+    //! \param  [in] tilesIdx
+    //!         pointer to the indexes of selected tiles in original
+    //!         high resolution picture
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t SetTilesForViewport(uint8_t viewportIdx, uint8_t tilesNum, uint8_t *tilesIdx);
+
 private:
+    //!
+    //! \brief  Get the indexes of high resolution tiles for specified
+    //!         viewport, either set by SetTilesForViewport or the tiles
+    //!         block starting from the viewport index
+    //!
+    //! \param  [in]  viewportIdx
+    //!         the index of specified viewport
+    //! \param  [out] highTilesIdx
+    //!         pointer to the indexes of high resolution tiles
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GetHighResTilesIdx(uint8_t viewportIdx, uint8_t *highTilesIdx);
+
     //!
     //! \brief  Get the original high resolution tiles arrangement
     //!         in viewport
@@ -220,10 +261,15 @@ private:
     uint8_t                               m_hrTilesInCol;        //!< the number of high resolution tiles in one column in tiles merged picture
     uint8_t                               m_lrTilesInRow;        //!< the number of low resolution tiles in one row in tiles merged picture
     uint8_t                               m_lrTilesInCol;        //!< the number of low resolution tiles in one column in tiles merged picture
+    std::map<uint8_t, std::vector<uint8_t>> m_viewportTiles;     //!< map of viewport index and high resolution tiles set for it
 };
 
 extern "C" RegionWisePackingGeneratorBase* Create();
 
 extern "C" void Destroy(RegionWisePackingGeneratorBase* rwpkGen);
 
+extern "C" uint32_t GetAPIVersion();
+
+extern "C" uint32_t GetCapabilities();
+
 #endif /* _HIGHRESPLUSFULLLOWRESPACKING_H_ */
@@ -0,0 +1,566 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   MultiQualityLayersPacking.cpp
+//! \brief:  Region wise packing generator class implementation for packing of
+//!          multiple quality layers of video streams
+//!
+
+#include <math.h>
+#include <string.h>
+
+#include "../../../utils/error.h"
+#include "MultiQualityLayersPacking.h"
+
+#define LCU_SIZE 64
+#define NEAR_VIEW_MARGIN 1      //the number of tiles around the viewport in middle quality layers
+#define MAX_HEIGHT_MULTIPLE 8   //the max multiple of the minimum merged picture height to try
+
+MultiQualityRegionWisePackingGenerator::MultiQualityRegionWisePackingGenerator()
+{
+    m_totalTilesNum     = 0;
+    m_packedPicWidth    = 0;
+    m_packedPicHeight   = 0;
+    m_tilesNumInViewRow = 0;
+    m_tileRowNumInView  = 0;
+
+    m_mergedTilesArrange = new TileArrangement;
+    if (!m_mergedTilesArrange)
+        return;
+
+    memset(m_mergedTilesArrange, 0, sizeof(TileArrangement));
+}
+
+//the tiles arrangement owns the arrays of tile rows height and tile columns width
+static TileArrangement* CloneTilesArrange(const TileArrangement *src)
+{
+    if (!src)
+        return NULL;
+
+    TileArrangement *tilesArrange = new TileArrangement;
+    if (!tilesArrange)
+        return NULL;
+
+    memset(tilesArrange, 0, sizeof(TileArrangement));
+    tilesArrange->tileRowsNum = src->tileRowsNum;
+    tilesArrange->tileColsNum = src->tileColsNum;
+    if (src->tileRowHeight)
+    {
+        tilesArrange->tileRowHeight = new uint16_t[src->tileRowsNum];
+        memcpy(tilesArrange->tileRowHeight, src->tileRowHeight, src->tileRowsNum * sizeof(uint16_t));
+    }
+    if (src->tileColWidth)
+    {
+        tilesArrange->tileColWidth = new uint16_t[src->tileColsNum];
+        memcpy(tilesArrange->tileColWidth, src->tileColWidth, src->tileColsNum * sizeof(uint16_t));
+    }
+
+    return tilesArrange;
+}
+
+static void DeleteTilesArrange(TileArrangement *tilesArrange)
+{
+    if (!tilesArrange)
+        return;
+
+    SAFE_DELETE_ARRAY(tilesArrange->tileRowHeight);
+    SAFE_DELETE_ARRAY(tilesArrange->tileColWidth);
+    delete tilesArrange;
+}
+
+MultiQualityRegionWisePackingGenerator::MultiQualityRegionWisePackingGenerator(
+    const MultiQualityRegionWisePackingGenerator& src)
+{
+    m_layers            = src.m_layers;
+    m_totalTilesNum     = src.m_totalTilesNum;
+    m_packedPicWidth    = src.m_packedPicWidth;
+    m_packedPicHeight   = src.m_packedPicHeight;
+    m_tilesNumInViewRow = src.m_tilesNumInViewRow;
+    m_tileRowNumInView  = src.m_tileRowNumInView;
+
+    m_mergedTilesArrange = CloneTilesArrange(src.m_mergedTilesArrange);
+}
+
+MultiQualityRegionWisePackingGenerator& MultiQualityRegionWisePackingGenerator::operator=(
+    const MultiQualityRegionWisePackingGenerator& other)
+{
+    if (&other == this)
+        return *this;
+
+    m_layers            = other.m_layers;
+    m_totalTilesNum     = other.m_totalTilesNum;
+    m_packedPicWidth    = other.m_packedPicWidth;
+    m_packedPicHeight   = other.m_packedPicHeight;
+    m_tilesNumInViewRow = other.m_tilesNumInViewRow;
+    m_tileRowNumInView  = other.m_tileRowNumInView;
+
+    TileArrangement *tilesArrange = CloneTilesArrange(other.m_mergedTilesArrange);
+    DeleteTilesArrange(m_mergedTilesArrange);
+    m_mergedTilesArrange = tilesArrange;
+
+    return *this;
+}
+
+MultiQualityRegionWisePackingGenerator::~MultiQualityRegionWisePackingGenerator()
+{
+    m_layers.clear();
+
+    DeleteTilesArrange(m_mergedTilesArrange);
+    m_mergedTilesArrange = NULL;
+}
+
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+    for ( ; ; )
+    {
+        if (a == 0) return b;
+        b %= a;
+        if (b == 0) return a;
+        a %= b;
+    }
+}
+
+static uint32_t lcm(uint32_t a, uint32_t b)
+{
+    uint32_t temp = gcd(a, b);
+
+    return temp ? (a / temp * b) : 0;
+}
+
+int32_t MultiQualityRegionWisePackingGenerator::CalculateLayersSelection()
+{
+    QualityLayerInfo *topLayer = &(m_layers[0]);
+    topLayer->selTilesInRow = m_tilesNumInViewRow;
+    topLayer->selTileRows   = m_tileRowNumInView;
+
+    uint8_t layersNum = m_layers.size();
+    for (uint8_t layerIdx = 1; layerIdx < layersNum; layerIdx++)
+    {
+        QualityLayerInfo *layer = &(m_layers[layerIdx]);
+        if (layerIdx == (layersNum - 1))
+        {
+            //the lowest quality layer covers the full sphere
+            layer->selTilesInRow = layer->origTilesInRow;
+            layer->selTileRows   = layer->origTilesInCol;
+        }
+        else
+        {
+            //the middle quality layer covers the viewport plus the tiles around it
+            double viewWidth  = (double)(m_tilesNumInViewRow * topLayer->tileWidth) * layer->width / topLayer->width;
+            double viewHeight = (double)(m_tileRowNumInView * topLayer->tileHeight) * layer->height / topLayer->height;
+            uint32_t cols = (uint32_t)ceil(viewWidth / layer->tileWidth) + 2 * NEAR_VIEW_MARGIN;
+            uint32_t rows = (uint32_t)ceil(viewHeight / layer->tileHeight) + 2 * NEAR_VIEW_MARGIN;
+
+            layer->selTilesInRow = (cols < layer->origTilesInRow) ? cols : layer->origTilesInRow;
+            layer->selTileRows   = (rows < layer->origTilesInCol) ? rows : layer->origTilesInCol;
+        }
+
+        if (!(layer->selTilesInRow) || !(layer->selTileRows))
+            return OMAF_ERROR_INVALID_DATA;
+    }
+
+    m_totalTilesNum = 0;
+    for (uint8_t layerIdx = 0; layerIdx < layersNum; layerIdx++)
+    {
+        m_totalTilesNum += m_layers[layerIdx].selTilesInRow * m_layers[layerIdx].selTileRows;
+    }
+
+    //the number of regions in region wise packing is limited in 8 bits
+    if (m_totalTilesNum > 255)
+        return OMAF_ERROR_UNDEFINED_OPERATION;
+
+    return ERROR_NONE;
+}
+
+int32_t MultiQualityRegionWisePackingGenerator::GenerateMergedTilesArrange()
+{
+    QualityLayerInfo *topLayer = &(m_layers[0]);
+    uint16_t highResTilesNum = m_tilesNumInViewRow * m_tileRowNumInView;
+
+    uint32_t height = 0;
+    std::vector<QualityLayerInfo>::iterator it;
+    for (it = m_layers.begin(); it != m_layers.end(); it++)
+    {
+        height = height ? lcm(height, it->tileHeight) : it->tileHeight;
+    }
+
+    uint16_t sqrtH = (uint16_t)sqrt(highResTilesNum);
+    while(sqrtH && highResTilesNum%sqrtH) { sqrtH--; }
+
+    uint32_t tilesNumInHeight = lcm(height / topLayer->tileHeight, sqrtH);
+    height = tilesNumInHeight * topLayer->tileHeight;
+    if (height == 0)
+        return OMAF_ERROR_UNDEFINED_OPERATION;
+
+    //find the minimum height in which each layer can be arranged in whole columns
+    bool found = false;
+    uint32_t mergedHeight = 0;
+    for (uint8_t multiple = 1; multiple <= MAX_HEIGHT_MULTIPLE && !found; multiple++)
+    {
+        mergedHeight = height * multiple;
+        found = true;
+        for (it = m_layers.begin(); it != m_layers.end(); it++)
+        {
+            uint16_t tilesNum = it->selTilesInRow * it->selTileRows;
+            if ((mergedHeight % it->tileHeight) ||
+                (tilesNum % (mergedHeight / it->tileHeight)))
+            {
+                found = false;
+                break;
+            }
+        }
+    }
+
+    if (!found)
+        return OMAF_ERROR_UNDEFINED_OPERATION;
+
+    uint16_t tileColsNum = 0;
+    uint32_t mergedWidth = 0;
+    for (it = m_layers.begin(); it != m_layers.end(); it++)
+    {
+        it->mergedTilesInCol = mergedHeight / it->tileHeight;
+        it->mergedTilesInRow = (it->selTilesInRow * it->selTileRows) / it->mergedTilesInCol;
+        it->mergedLeft       = mergedWidth;
+
+        mergedWidth += it->mergedTilesInRow * it->tileWidth;
+        tileColsNum += it->mergedTilesInRow;
+    }
+
+    m_packedPicWidth  = mergedWidth;
+    m_packedPicHeight = mergedHeight;
+
+    m_mergedTilesArrange->tileRowsNum = 1;
+    m_mergedTilesArrange->tileColsNum = tileColsNum;
+    m_mergedTilesArrange->tileRowHeight = new uint16_t[m_mergedTilesArrange->tileRowsNum];
+    if (!(m_mergedTilesArrange->tileRowHeight))
+        return OMAF_ERROR_NULL_PTR;
+
+    m_mergedTilesArrange->tileRowHeight[0] = mergedHeight;
+
+    m_mergedTilesArrange->tileColWidth = new uint16_t[m_mergedTilesArrange->tileColsNum];
+    if (!(m_mergedTilesArrange->tileColWidth))
+        return OMAF_ERROR_NULL_PTR;
+
+    uint16_t colIdx = 0;
+    for (it = m_layers.begin(); it != m_layers.end(); it++)
+    {
+        for (uint8_t i = 0; i < it->mergedTilesInRow; i++)
+        {
+            m_mergedTilesArrange->tileColWidth[colIdx] = it->tileWidth / LCU_SIZE;
+            colIdx++;
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t MultiQualityRegionWisePackingGenerator::Initialize(
+    std::map<uint8_t, VideoStreamInfo*> *streams,
+    uint8_t *videoIdxInMedia,
+    uint8_t tilesNumInViewport,
+    TileDef *tilesInViewport,
+    int32_t finalViewportWidth,
+    int32_t finalViewportHeight)
+{
+    if (!streams || !videoIdxInMedia || !tilesInViewport)
+        return OMAF_ERROR_NULL_PTR;
+
+    if (!m_mergedTilesArrange)
+        return OMAF_ERROR_NULL_PTR;
+
+    //at least one layer for viewport and one layer for full sphere
+    uint8_t layersNum = streams->size();
+    if (layersNum < 2)
+        return OMAF_ERROR_VIDEO_NUM;
+
+    m_layers.clear();
+    for (uint8_t layerIdx = 0; layerIdx < layersNum; layerIdx++)
+    {
+        std::map<uint8_t, VideoStreamInfo*>::iterator it;
+        it = streams->find(videoIdxInMedia[layerIdx]);
+        if (it == streams->end())
+            return OMAF_ERROR_STREAM_NOT_FOUND;
+
+        VideoStreamInfo *vs = (VideoStreamInfo*)(it->second);
+        RegionWisePacking *rwpk = vs->srcRWPK;
+        if (!rwpk || !(rwpk->rectRegionPacking))
+            return OMAF_ERROR_NULL_PTR;
+
+        QualityLayerInfo layer;
+        memset(&layer, 0, sizeof(QualityLayerInfo));
+        layer.streamIdxInMedia = videoIdxInMedia[layerIdx];
+        layer.srcRwpk          = rwpk;
+        layer.width            = rwpk->projPicWidth;
+        layer.height           = rwpk->projPicHeight;
+        layer.tileWidth        = rwpk->rectRegionPacking[0].projRegWidth;
+        layer.tileHeight       = rwpk->rectRegionPacking[0].projRegHeight;
+        layer.origTilesInRow   = vs->tilesNumInRow;
+        layer.origTilesInCol   = vs->tilesNumInCol;
+        if (!layer.width || !layer.height || !layer.tileWidth || !layer.tileHeight)
+            return OMAF_ERROR_INVALID_DATA;
+
+        m_layers.push_back(layer);
+    }
+
+    if (!tilesNumInViewport || !finalViewportWidth || !finalViewportHeight)
+        return OMAF_ERROR_SCVP_INCORRECT_RESULT;
+
+    m_tileRowNumInView  = finalViewportHeight / m_layers[0].tileHeight;
+    m_tilesNumInViewRow = finalViewportWidth / m_layers[0].tileWidth;
+    if (!m_tileRowNumInView || !m_tilesNumInViewRow ||
+        (m_tileRowNumInView * m_tilesNumInViewRow != tilesNumInViewport))
+        return OMAF_ERROR_SCVP_INCORRECT_RESULT;
+
+    int32_t ret = CalculateLayersSelection();
+    if (ret)
+        return ret;
+
+    ret = GenerateMergedTilesArrange();
+    if (ret)
+        return ret;
+
+    return ERROR_NONE;
+}
+
+int32_t MultiQualityRegionWisePackingGenerator::GetLayerTilesIdx(
+    uint8_t layerIdx,
+    uint8_t viewportIdx,
+    uint8_t *tilesIdx)
+{
+    if (!tilesIdx)
+        return OMAF_ERROR_NULL_PTR;
+
+    if (layerIdx >= m_layers.size())
+        return OMAF_ERROR_INVALID_DATA;
+
+    QualityLayerInfo *topLayer = &(m_layers[0]);
+    QualityLayerInfo *layer = &(m_layers[layerIdx]);
+    uint16_t tilesNum = layer->selTilesInRow * layer->selTileRows;
+
+    if (layerIdx == 0)
+    {
+        //tiles block starting from the viewport index, wrapped around the picture
+        tilesIdx[0] = viewportIdx;
+        for (uint16_t i = 1; i < tilesNum; i++)
+        {
+            if (i % m_tilesNumInViewRow)
+            {
+                tilesIdx[i] = tilesIdx[i-1] + 1;
+                if (tilesIdx[i] >= (tilesIdx[i-1] / layer->origTilesInRow + 1) * layer->origTilesInRow)
+                {
+                    tilesIdx[i] = tilesIdx[i] - layer->origTilesInRow;
+                }
+            }
+            else
+            {
+                tilesIdx[i] = (i / m_tilesNumInViewRow) * layer->origTilesInRow + tilesIdx[0];
+                if (tilesIdx[i] >= layer->origTilesInRow * layer->origTilesInCol)
+                {
+                    tilesIdx[i] = tilesIdx[i] - layer->origTilesInRow * layer->origTilesInCol;
+                }
+            }
+        }
+        return ERROR_NONE;
+    }
+
+    if (layerIdx == (m_layers.size() - 1))
+    {
+        for (uint16_t i = 0; i < tilesNum; i++)
+        {
+            tilesIdx[i] = i;
+        }
+        return ERROR_NONE;
+    }
+
+    //centre of the viewport in the tiles of this layer
+    uint8_t viewRowIdx = viewportIdx / topLayer->origTilesInRow;
+    uint8_t viewColIdx = viewportIdx % topLayer->origTilesInRow;
+    double centreX = (viewColIdx + m_tilesNumInViewRow / 2.0) * topLayer->tileWidth;
+    double centreY = fmod((viewRowIdx + m_tileRowNumInView / 2.0) * topLayer->tileHeight, (double)(topLayer->height));
+    centreX = centreX * layer->width / topLayer->width / layer->tileWidth;
+    centreY = centreY * layer->height / topLayer->height / layer->tileHeight;
+
+    //wrapped around in horizontal, but clamped in vertical
+    int32_t startCol = (int32_t)floor(centreX - layer->selTilesInRow / 2.0);
+    int32_t startRow = (int32_t)floor(centreY - layer->selTileRows / 2.0);
+    if (startRow < 0)
+        startRow = 0;
+    if (startRow > (layer->origTilesInCol - layer->selTileRows))
+        startRow = layer->origTilesInCol - layer->selTileRows;
+
+    for (uint8_t i = 0; i < layer->selTileRows; i++)
+    {
+        for (uint8_t j = 0; j < layer->selTilesInRow; j++)
+        {
+            int32_t col = (startCol + j) % layer->origTilesInRow;
+            if (col < 0)
+                col += layer->origTilesInRow;
+
+            tilesIdx[i * layer->selTilesInRow + j] = (startRow + i) * layer->origTilesInRow + col;
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t MultiQualityRegionWisePackingGenerator::GenerateTilesMergeDirection(
+    uint8_t viewportIdx,
+    TilesMergeDirectionInCol *tilesMergeDir)
+{
+    if (!tilesMergeDir)
+        return OMAF_ERROR_NULL_PTR;
+
+    for (uint8_t layerIdx = 0; layerIdx < m_layers.size(); layerIdx++)
+    {
+        QualityLayerInfo *layer = &(m_layers[layerIdx]);
+        std::vector<uint8_t> tilesIdx(layer->selTilesInRow * layer->selTileRows);
+
+        int32_t ret = GetLayerTilesIdx(layerIdx, viewportIdx, tilesIdx.data());
+        if (ret)
+            return ret;
+
+        for (uint8_t i = 0; i < layer->mergedTilesInRow; i++)
+        {
+            TilesInCol *tileCol = new TilesInCol;
+            if (!tileCol)
+                return OMAF_ERROR_NULL_PTR;
+
+            for (uint8_t j = 0; j < layer->mergedTilesInCol; j++)
+            {
+                SingleTile *tile = new SingleTile;
+                if (!tile)
+                {
+                    SAFE_DELETE_MEMORY(tileCol);
+                    return OMAF_ERROR_NULL_PTR;
+                }
+
+                tile->streamIdxInMedia = layer->streamIdxInMedia;
+                tile->origTileIdx      = tilesIdx[j * layer->mergedTilesInRow + i];
+                tile->dstCTUIndex      = j * (layer->tileHeight / LCU_SIZE) * (m_packedPicWidth / LCU_SIZE) +
+                                         (layer->mergedLeft + i * layer->tileWidth) / LCU_SIZE;
+
+                tileCol->push_back(tile);
+            }
+            tilesMergeDir->tilesArrangeInCol.push_back(tileCol);
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+int32_t MultiQualityRegionWisePackingGenerator::GenerateDstRwpk(
+    uint8_t viewportIdx,
+    RegionWisePacking *dstRwpk)
+{
+    if (!dstRwpk)
+        return OMAF_ERROR_NULL_PTR;
+
+    QualityLayerInfo *topLayer = &(m_layers[0]);
+
+    dstRwpk->constituentPicMatching = 0;
+    dstRwpk->numRegions             = m_totalTilesNum;
+    dstRwpk->packedPicWidth         = m_packedPicWidth;
+    dstRwpk->packedPicHeight        = m_packedPicHeight;
+
+    dstRwpk->rectRegionPacking      = new RectangularRegionWisePacking[dstRwpk->numRegions];
+    if (!(dstRwpk->rectRegionPacking))
+        return OMAF_ERROR_NULL_PTR;
+
+    uint16_t regionIdx = 0;
+    for (uint8_t layerIdx = 0; layerIdx < m_layers.size(); layerIdx++)
+    {
+        QualityLayerInfo *layer = &(m_layers[layerIdx]);
+        uint16_t tilesNum = layer->selTilesInRow * layer->selTileRows;
+        std::vector<uint8_t> tilesIdx(tilesNum);
+
+        int32_t ret = GetLayerTilesIdx(layerIdx, viewportIdx, tilesIdx.data());
+        if (ret)
+            return ret;
+
+        //regions are ranked in the same order as tiles merging direction
+        for (uint16_t i = 0; i < tilesNum; i++)
+        {
+            uint8_t mergedCol = i / layer->mergedTilesInCol;
+            uint8_t mergedRow = i % layer->mergedTilesInCol;
+            uint8_t origTileIdx = tilesIdx[mergedRow * layer->mergedTilesInRow + mergedCol];
+
+            RectangularRegionWisePacking *srcRect = &(layer->srcRwpk->rectRegionPacking[origTileIdx]);
+            RectangularRegionWisePacking *rwpk = &(dstRwpk->rectRegionPacking[regionIdx]);
+            memset(rwpk, 0, sizeof(RectangularRegionWisePacking));
+
+            rwpk->transformType = srcRect->transformType;
+            rwpk->guardBandFlag = false;
+
+            //projected regions are all in the picture of the highest quality layer
+            rwpk->projRegWidth  = (srcRect->projRegWidth * topLayer->width) / layer->width;
+            rwpk->projRegHeight = (srcRect->projRegHeight * topLayer->height) / layer->height;
+            rwpk->projRegTop    = (srcRect->projRegTop * topLayer->height) / layer->height;
+            rwpk->projRegLeft   = (srcRect->projRegLeft * topLayer->width) / layer->width;
+
+            rwpk->packedRegWidth  = srcRect->projRegWidth;
+            rwpk->packedRegHeight = srcRect->projRegHeight;
+            rwpk->packedRegTop    = mergedRow * layer->tileHeight;
+            rwpk->packedRegLeft   = layer->mergedLeft + mergedCol * layer->tileWidth;
+
+            rwpk->leftGbWidth          = 0;
+            rwpk->rightGbWidth         = 0;
+            rwpk->topGbHeight          = 0;
+            rwpk->bottomGbHeight       = 0;
+            rwpk->gbNotUsedForPredFlag = true;
+            rwpk->gbType0              = 0;
+            rwpk->gbType1              = 0;
+            rwpk->gbType2              = 0;
+            rwpk->gbType3              = 0;
+
+            regionIdx++;
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+extern "C" RegionWisePackingGeneratorBase* Create()
+{
+    MultiQualityRegionWisePackingGenerator *rwpkGen = new MultiQualityRegionWisePackingGenerator;
+    return (RegionWisePackingGeneratorBase*)(rwpkGen);
+}
+
+extern "C" void Destroy(RegionWisePackingGeneratorBase* rwpkGen)
+{
+    delete rwpkGen;
+    rwpkGen = NULL;
+}
+
+extern "C" uint32_t GetAPIVersion()
+{
+    return OMAF_PACKING_API_VERSION;
+}
+
+extern "C" uint32_t GetCapabilities()
+{
+    return OMAF_PACKING_CAP_MULTI_LAYERS;
+}
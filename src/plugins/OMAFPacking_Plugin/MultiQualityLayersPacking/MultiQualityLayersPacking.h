@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//!
+//! \file:   MultiQualityLayersPacking.h
+//! \brief:  Region wise packing generator class definition for packing of
+//!          multiple quality layers of video streams
+//! \detail: Define the operation of region wise packing generator for packing of
+//!          multiple quality layers, the highest quality layer covers the viewport,
+//!          the middle quality layers cover the area around the viewport and the
+//!          lowest quality layer covers the full sphere
+//!
+
+#ifndef _MULTIQUALITYLAYERSPACKING_H_
+#define _MULTIQUALITYLAYERSPACKING_H_
+
+#include "OMAFPackingPluginAPI.h"
+
+//!
+//! \struct: QualityLayerInfo
+//! \brief:  define the information of one quality layer, including
+//!          its tiles split, the tiles selected for each viewport and
+//!          its position in tiles merged picture
+//!
+typedef struct QualityLayerInfo
+{
+    uint8_t           streamIdxInMedia; //the index of video stream in all media streams
+    RegionWisePacking *srcRwpk;         //the original region wise packing information of the video stream
+    uint32_t          width;            //the width of the video stream
+    uint32_t          height;           //the height of the video stream
+    uint16_t          tileWidth;        //the width of tile in the video stream
+    uint16_t          tileHeight;       //the height of tile in the video stream
+    uint8_t           origTilesInRow;   //the number of tiles in one row in the video stream
+    uint8_t           origTilesInCol;   //the number of tiles in one column in the video stream
+    uint8_t           selTilesInRow;    //the number of tiles in one row selected for one viewport
+    uint8_t           selTileRows;      //the number of tile rows selected for one viewport
+    uint8_t           mergedTilesInRow; //the number of tiles in one row in tiles merged picture
+    uint8_t           mergedTilesInCol; //the number of tiles in one column in tiles merged picture
+    uint32_t          mergedLeft;       //the left position of the layer in tiles merged picture
+}QualityLayerInfo;
+
+//!
+//! \class MultiQualityRegionWisePackingGenerator
+//! \brief Define the operation of region wise packing generator for packing of
+//!        multiple quality layers of video streams
+//!
+
+class MultiQualityRegionWisePackingGenerator : public RegionWisePackingGeneratorBase
+{
+public:
+    //!
+    //! \brief  Constructor
+    //!
+    MultiQualityRegionWisePackingGenerator();
+
+    //!
+    //! \brief  Copy constructor, the tiles arrangement is deep copied
+    //!
+    MultiQualityRegionWisePackingGenerator(const MultiQualityRegionWisePackingGenerator& src);
+
+    //!
+    //! \brief  Copy assignment, the tiles arrangement is deep copied
+    //!
+    MultiQualityRegionWisePackingGenerator& operator=(const MultiQualityRegionWisePackingGenerator& other);
+
+    //!
+    //! \brief  Destructor
+    //!
+    ~MultiQualityRegionWisePackingGenerator();
+
+    //!
+    //! \brief  Initialize the region wise packing generator
+    //!
+    //! \param  [in] streams
+    //!         pointer to the map of video stream index and info
+    //! \param  [in] videoIdxInMedia
+    //!         pointer to the index of each video in media streams,
+    //!         which is ranked from the highest quality to the lowest
+    //! \param  [in] tilesNumInViewport
+    //!         the number of tiles in viewport
+    //! \param  [in] tilesInViewport
+    //!         pointer to tile information of all tiles in viewport
+    //! \param  [in] finalViewportWidth
+    //!         the final viewport width calculated by 360SCVP library
+    //! \param  [in] finalViewportHeight
+    //!         the final viewport height calculated by 360SCVP library
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t Initialize(
+        std::map<uint8_t, VideoStreamInfo*> *streams,
+        uint8_t *videoIdxInMedia,
+        uint8_t tilesNumInViewport,
+        TileDef *tilesInViewport,
+        int32_t finalViewportWidth,
+        int32_t finalViewportHeight);
+
+    //!
+    //! \brief  Generate the region wise packing information for
+    //!         specified viewport
+    //!
+    //! \param  [in]  viewportIdx
+    //!         the index of specified viewport
+    //! \param  [out] dstRwpk
+    //!         pointer to the region wise packing information for
+    //!         the specified viewport
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GenerateDstRwpk(uint8_t viewportIdx, RegionWisePacking *dstRwpk);
+
+    //!
+    //! \brief  Generate the tiles merging direction information for
+    //!         specified viewport
+    //!
+    //! \param  [in]  viewportIdx
+    //!         the index of specified viewport
+    //! \param  [out] tilesMergeDir
+    //!         pointer to the tiles merging direction information for
+    //!         the specified viewport
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GenerateTilesMergeDirection(
+        uint8_t viewportIdx,
+        TilesMergeDirectionInCol *tilesMergeDir);
+
+    //!
+    //! \brief  Get the number of tiles in one row in viewport
+    //!
+    //! \return uint8_t
+    //!         the number of tiles in one row in viewport
+    //!
+    uint8_t GetTilesNumInViewportRow() { return m_tilesNumInViewRow; };
+
+    //!
+    //! \brief  Get the number of tile rows in viewport
+    //!
+    //! \return uint8_t
+    //!         the number of tile rows in viewport
+    //!
+    uint8_t GetTileRowNumInViewport() { return m_tileRowNumInView; };
+
+    //!
+    //! \brief  Get the width of tiles merged picture
+    //!
+    //! \return uint32_t
+    //!         the width of tiles merged picture
+    //!
+    uint32_t GetPackedPicWidth() { return m_packedPicWidth; };
+
+    //!
+    //! \brief  Get the height of tiles merged picture
+    //!
+    //! \return uint32_t
+    //!         the height of tiles merged picture
+    //!
+    uint32_t GetPackedPicHeight() { return m_packedPicHeight; };
+
+    //!
+    //! \brief  Get the tiles arrangement information in tiles
+    //!         merged picture
+    //!
+    //! \return TileArrangement*
+    //!         the pointer to the tiles arrangement information
+    //!
+    TileArrangement* GetMergedTilesArrange() { return m_mergedTilesArrange; };
+
+    //!
+    //! \brief  Get the capabilities of the plugin
+    //!
+    //! \return uint32_t
+    //!         OMAF_PACKING_CAP_MULTI_LAYERS
+    //!
+    uint32_t GetCapabilities() { return OMAF_PACKING_CAP_MULTI_LAYERS; };
+
+private:
+    //!
+    //! \brief  Calculate the tiles selected for one viewport in
+    //!         each quality layer
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t CalculateLayersSelection();
+
+    //!
+    //! \brief  Get the indexes of tiles selected in specified quality
+    //!         layer for specified viewport, they are ranked in tile
+    //!         row of the selected area
+    //!
+    //! \param  [in]  layerIdx
+    //!         the index of specified quality layer
+    //! \param  [in]  viewportIdx
+    //!         the index of specified viewport
+    //! \param  [out] tilesIdx
+    //!         pointer to the indexes of selected tiles
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GetLayerTilesIdx(uint8_t layerIdx, uint8_t viewportIdx, uint8_t *tilesIdx);
+
+    //!
+    //! \brief  Generate tiles arrangement in tiles merged picture
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    int32_t GenerateMergedTilesArrange();
+
+private:
+    std::vector<QualityLayerInfo>         m_layers;              //!< quality layers ranked from the highest quality to the lowest
+    uint16_t                              m_totalTilesNum;       //!< the number of tiles from all layers in tiles merged picture
+    uint32_t                              m_packedPicWidth;      //!< the width of tiles merged picture
+    uint32_t                              m_packedPicHeight;     //!< the height of tiles merged picture
+    TileArrangement                       *m_mergedTilesArrange; //!< pointer to the tiles arrangement information
+    uint8_t                               m_tilesNumInViewRow;   //!< the number of highest quality tiles in one row in viewport
+    uint8_t                               m_tileRowNumInView;    //!< the number of highest quality tile rows in viewport
+};
+
+extern "C" RegionWisePackingGeneratorBase* Create();
+
+extern "C" void Destroy(RegionWisePackingGeneratorBase* rwpkGen);
+
+extern "C" uint32_t GetAPIVersion();
+
+extern "C" uint32_t GetCapabilities();
+
+#endif /* _MULTIQUALITYLAYERSPACKING_H_ */
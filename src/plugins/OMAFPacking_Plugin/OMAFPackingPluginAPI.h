@@ -36,11 +36,27 @@
 
 #include <list>
 #include <map>
+#include <vector>
 #include <iostream>
 
 #include "360SCVPAPI.h"
 #include "error.h"
 
+//!
+//! the version of the plugin API, plugins with different major
+//! version are rejected. plugins without GetAPIVersion are taken
+//! as version 1.0
+//!
+#define OMAF_PACKING_API_VERSION_MAJOR 1
+#define OMAF_PACKING_API_VERSION_MINOR 1
+#define OMAF_PACKING_API_VERSION ((OMAF_PACKING_API_VERSION_MAJOR << 16) | OMAF_PACKING_API_VERSION_MINOR)
+
+//!
+//! capabilities reported by GetCapabilities
+//!
+#define OMAF_PACKING_CAP_VIEWPORT_TILES 0x1 //the tiles in viewport can be set by SetViewportTiles
+#define OMAF_PACKING_CAP_MULTI_LAYERS   0x2 //more than two video streams can be packed
+
 //!
 //! \struct: SingleTile
 //! \brief:  define tile information for tiles merging
@@ -207,11 +223,79 @@ public:
     //!
     virtual TileArrangement* GetMergedTilesArrange() = 0;
 
+    //!
+    //! \brief  Get the capabilities of the plugin, the same as the
+    //!         ones reported by exported GetCapabilities
+    //!
+    //! \return uint32_t
+    //!         the OMAF_PACKING_CAP_* flags of the plugin
+    //!
+    virtual uint32_t GetCapabilities() { return 0; };
+
+    //!
+    //! \brief  Set the high resolution tiles selected for specified
+    //!         viewport, which replace the tiles the plugin derives
+    //!         from the viewport index, used when the tiles are not
+    //!         adjacent in the original picture, like for cube map.
+    //!         Only plugins with OMAF_PACKING_CAP_VIEWPORT_TILES are
+    //!         called into, plugins of API 1.0 should be checked by
+    //!         exported GetCapabilities before, since they have no
+    //!         GetCapabilities in their virtual table
+    //!
+    //! \param  [in] viewportIdx
+    //!         the index of specified viewport
+    //! \param  [in] tilesNum
+    //!         the number of selected tiles, which should equal the
+    //!         tiles number in viewport passed in Initialize
+    //! \param  [in] tilesIdx
+    //!         pointer to the indexes of selected tiles in original
+    //!         high resolution picture
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, OMAF_ERROR_UNDEFINED_OPERATION
+    //!         if the plugin doesn't support it, else failed reason
+    //!
+    int32_t SetViewportTiles(
+        uint8_t viewportIdx,
+        uint8_t tilesNum,
+        uint8_t *tilesIdx)
+    {
+        if (!(GetCapabilities() & OMAF_PACKING_CAP_VIEWPORT_TILES))
+            return OMAF_ERROR_UNDEFINED_OPERATION;
+
+        return SetTilesForViewport(viewportIdx, tilesNum, tilesIdx);
+    };
+
 protected:
+    //!
+    //! \brief  Set the high resolution tiles selected for specified
+    //!         viewport, implemented by plugins which report
+    //!         OMAF_PACKING_CAP_VIEWPORT_TILES
+    //!
+    //! \param  [in] viewportIdx
+    //!         the index of specified viewport
+    //! \param  [in] tilesNum
+    //!         the number of selected tiles
+    //! \param  [in] tilesIdx
+    //!         pointer to the indexes of selected tiles in original
+    //!         high resolution picture
+    //!
+    //! \return int32_t
+    //!         ERROR_NONE if success, else failed reason
+    //!
+    virtual int32_t SetTilesForViewport(
+        uint8_t viewportIdx,
+        uint8_t tilesNum,
+        uint8_t *tilesIdx)
+    {
+        return OMAF_ERROR_UNDEFINED_OPERATION;
+    };
 };
 
 typedef RegionWisePackingGeneratorBase* CreateRWPKGenerator();
 typedef void DestroyRWPKGenerator(RegionWisePackingGeneratorBase*);
+typedef uint32_t GetRWPKGeneratorAPIVersion();
+typedef uint32_t GetRWPKGeneratorCapabilities();
 
 #define SAFE_DELETE_MEMORY(x) \
     if (x)               \
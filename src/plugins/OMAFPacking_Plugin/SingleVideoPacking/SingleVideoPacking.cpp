@@ -428,3 +428,13 @@ extern "C" void Destroy(RegionWisePackingGeneratorBase* rwpkGen)
     delete rwpkGen;
     rwpkGen = NULL;
 }
+
+extern "C" uint32_t GetAPIVersion()
+{
+    return OMAF_PACKING_API_VERSION;
+}
+
+extern "C" uint32_t GetCapabilities()
+{
+    return 0;
+}
@@ -212,4 +212,8 @@ extern "C" RegionWisePackingGeneratorBase* Create();
 
 extern "C" void Destroy(RegionWisePackingGeneratorBase* rwpkGen);
 
+extern "C" uint32_t GetAPIVersion();
+
+extern "C" uint32_t GetCapabilities();
+
 #endif /* _SINGLEVIDEOPACKING_H_ */
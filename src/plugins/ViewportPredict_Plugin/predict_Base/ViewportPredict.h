@@ -54,7 +54,7 @@ public:
     //!
     //! \brief  de-construct
     //!
-    ~ViewportPredict();
+    virtual ~ViewportPredict();
     //! \brief Initialze the viewport prediction algorithm
     //!
     //! \param  [in] std::string
@@ -76,7 +76,7 @@ public:
     //!
     virtual ViewportAngle* PredictPose(std::list<ViewportAngle> pose_history) = 0;
 
-private:
+protected:
     uint32_t    m_poseInterval;      //!< time interval between tow continous pose(ms)
     uint32_t    m_prePoseCount;      //!< size of pose history
     uint32_t    m_predictInterval;   //!< time interval of prediction(ms)
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ */
+
+//!
+
+//! \file:   ViewportPredict_Kalman.cpp
+//! \brief:  the class for viewport predict of kalman filter.
+//! \detail: it's class to predict viewport by tracking the angular velocity
+//!          and acceleration of yaw and pitch with kalman filter.
+//!
+//! Created on October 18, 2026, 10:20 AM
+//!
+
+#include "ViewportPredict_Kalman.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+VCD_OMAF_BEGIN
+
+#define MEASUREMENT_NOISE_VAR    0.25f     //!< variance of the sensor noise, in degree^2
+#define PROCESS_NOISE_DENSITY    1.0e7f    //!< spectral density of the angular jerk, in degree^2/s^5
+#define VELOCITY_TIME_CONST      0.15f     //!< time constant of the velocity decay, in second
+#define ACCELERATION_TIME_CONST  0.05f     //!< time constant of the acceleration decay, in second
+#define PROPAGATE_STEP           0.01f     //!< the longest step to propagate the state, in second
+#define INITIAL_VELOCITY_VAR     10000.0f  //!< variance of the unknown velocity at start, in (degree/s)^2
+#define INITIAL_ACCELERATION_VAR 250000.0f //!< variance of the unknown acceleration at start, in (degree/s^2)^2
+#define MAX_POSE_GAP             500       //!< the filter restarts after a longer gap between poses, in ms
+#define MAX_PREDICT_HORIZON      2000      //!< the longest time to predict for, in ms
+#define CONFIDENCE_SCALE         30.0f     //!< spread of the prediction where the confidence is 1/e, in degree
+#define DEFAULT_POSE_INTERVAL    40        //!< pose interval if not set, in ms
+
+static float WrapAngle(float angle)
+{
+    while (angle >= 180.0f)
+        angle -= 360.0f;
+    while (angle < -180.0f)
+        angle += 360.0f;
+    return angle;
+}
+
+AngleKalmanFilter::AngleKalmanFilter()
+{
+    Reset(0.0f);
+}
+
+AngleKalmanFilter::~AngleKalmanFilter() {}
+
+void AngleKalmanFilter::Reset(float angle)
+{
+    m_state[0] = angle;
+    m_state[1] = 0.0f;
+    m_state[2] = 0.0f;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            m_cov[i][j] = 0.0f;
+        }
+    }
+    m_cov[0][0] = MEASUREMENT_NOISE_VAR;
+    m_cov[1][1] = INITIAL_VELOCITY_VAR;
+    m_cov[2][2] = INITIAL_ACCELERATION_VAR;
+}
+
+void AngleKalmanFilter::Predict(float dt)
+{
+    // propagate in short steps, so the decays are followed on long horizons
+    while (dt > 0.0f)
+    {
+        float step = dt < PROPAGATE_STEP ? dt : PROPAGATE_STEP;
+        Propagate(step);
+        dt -= step;
+    }
+}
+
+void AngleKalmanFilter::Propagate(float dt)
+{
+    // velocity and acceleration both decay, the head stops after a turn:
+    // angle' = velocity, velocity' = -velocity / Tv + acceleration,
+    // acceleration' = -acceleration / Ta + jerk
+    float kv = dt / VELOCITY_TIME_CONST;
+    float ka = dt / ACCELERATION_TIME_CONST;
+    float F[3][3] = {{1.0f, dt * (1.0f - kv / 2.0f), dt * dt / 2.0f},
+                     {0.0f, 1.0f - kv + kv * kv / 2.0f, dt * (1.0f - (kv + ka) / 2.0f)},
+                     {0.0f, 0.0f, 1.0f - ka + ka * ka / 2.0f}};
+
+    float dt2 = dt * dt;
+    float dt3 = dt2 * dt;
+    float q = PROCESS_NOISE_DENSITY;
+    float Q[3][3] = {{q * dt3 * dt2 / 20.0f, q * dt3 * dt / 8.0f, q * dt3 / 6.0f},
+                     {q * dt3 * dt / 8.0f, q * dt3 / 3.0f, q * dt2 / 2.0f},
+                     {q * dt3 / 6.0f, q * dt2 / 2.0f, q * dt}};
+
+    float state[3];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        state[i] = F[i][0] * m_state[0] + F[i][1] * m_state[1] + F[i][2] * m_state[2];
+    }
+
+    // P = F * P * F' + Q
+    float FP[3][3];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            FP[i][j] = F[i][0] * m_cov[0][j] + F[i][1] * m_cov[1][j] + F[i][2] * m_cov[2][j];
+        }
+    }
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        m_state[i] = state[i];
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            m_cov[i][j] = FP[i][0] * F[j][0] + FP[i][1] * F[j][1] + FP[i][2] * F[j][2] + Q[i][j];
+        }
+    }
+}
+
+void AngleKalmanFilter::Update(float angle)
+{
+    // only the angle is measured, H = [1 0 0]
+    float innovation = angle - m_state[0];
+    float S = m_cov[0][0] + MEASUREMENT_NOISE_VAR;
+    float K[3] = {m_cov[0][0] / S, m_cov[1][0] / S, m_cov[2][0] / S};
+
+    float row[3] = {m_cov[0][0], m_cov[0][1], m_cov[0][2]};
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        m_state[i] += K[i] * innovation;
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            m_cov[i][j] -= K[i] * row[j];
+        }
+    }
+}
+
+ViewportPredict_Kalman::ViewportPredict_Kalman()
+{
+}
+
+ViewportPredict_Kalman::~ViewportPredict_Kalman() {}
+
+ViewportAngle* ViewportPredict_Kalman::PredictPose(std::list<ViewportAngle> pose_history)
+{
+    if (pose_history.empty())
+    {
+        return NULL;
+    }
+    uint64_t interval = m_poseInterval ? m_poseInterval : DEFAULT_POSE_INTERVAL;
+    std::vector<ViewportPose> timed_history;
+    uint64_t pts = 0;
+    for (auto it = pose_history.begin(); it != pose_history.end(); it++)
+    {
+        ViewportPose pose;
+        pose.angle = *it;
+        pose.pts = pts;
+        timed_history.push_back(pose);
+        pts += interval;
+    }
+
+    PredictedViewport predicted;
+    if (PredictPoseTimed(timed_history.data(), (uint32_t)timed_history.size(), timed_history.back().pts + m_predictInterval, &predicted) != 0)
+    {
+        return NULL;
+    }
+    ViewportAngle *predicted_angle = new ViewportAngle;
+    *predicted_angle = predicted.angle;
+    return predicted_angle;
+}
+
+int32_t ViewportPredict_Kalman::PredictPoseTimed(const ViewportPose *poses, uint32_t count, uint64_t predict_pts, PredictedViewport *predicted)
+{
+    if (NULL == poses || 0 == count || NULL == predicted)
+    {
+        return 1;
+    }
+
+    // only the latest poses are used if the history is longer than expected
+    const ViewportPose *it = poses;
+    const ViewportPose *end = poses + count;
+    if (m_prePoseCount > 0 && count > m_prePoseCount)
+    {
+        it += count - m_prePoseCount;
+    }
+
+    AngleKalmanFilter yawFilter;
+    AngleKalmanFilter pitchFilter;
+    yawFilter.Reset(it->angle.yaw);
+    pitchFilter.Reset(it->angle.pitch);
+    uint64_t lastPts = it->pts;
+    float roll = it->angle.roll;
+    for (it++; it != end; it++)
+    {
+        // poses out of order are dropped
+        if (it->pts < lastPts)
+        {
+            continue;
+        }
+        roll = it->angle.roll;
+        if (it->pts - lastPts > MAX_POSE_GAP)
+        {
+            yawFilter.Reset(it->angle.yaw);
+            pitchFilter.Reset(it->angle.pitch);
+            lastPts = it->pts;
+            continue;
+        }
+        float dt = (float)(it->pts - lastPts) / 1000.0f;
+        yawFilter.Predict(dt);
+        pitchFilter.Predict(dt);
+        // yaw is tracked unwrapped, take the measurement on the nearest turn
+        yawFilter.Update(yawFilter.GetAngle() + WrapAngle(it->angle.yaw - yawFilter.GetAngle()));
+        pitchFilter.Update(it->angle.pitch);
+        lastPts = it->pts;
+    }
+
+    uint64_t horizon = predict_pts > lastPts ? predict_pts - lastPts : 0;
+    if (horizon > MAX_PREDICT_HORIZON)
+    {
+        horizon = MAX_PREDICT_HORIZON;
+    }
+    yawFilter.Predict((float)horizon / 1000.0f);
+    pitchFilter.Predict((float)horizon / 1000.0f);
+
+    float pitch = pitchFilter.GetAngle();
+    if (pitch > 90.0f)
+        pitch = 90.0f;
+    if (pitch < -90.0f)
+        pitch = -90.0f;
+    predicted->angle.yaw = WrapAngle(yawFilter.GetAngle());
+    predicted->angle.pitch = pitch;
+    predicted->angle.roll = roll;
+    predicted->yawStdDev = std::min(sqrt(yawFilter.GetVariance()), 180.0f);
+    predicted->pitchStdDev = std::min(sqrt(pitchFilter.GetVariance()), 90.0f);
+
+    // yaw error shrinks on the sphere towards the poles
+    float cosPitch = cos(pitch * M_PI / 180);
+    float spread = sqrt(predicted->yawStdDev * predicted->yawStdDev * cosPitch * cosPitch +
+                        predicted->pitchStdDev * predicted->pitchStdDev);
+    predicted->confidence = exp(-spread / CONFIDENCE_SCALE);
+    return 0;
+}
+
+VCD_OMAF_END
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ */
+
+//!
+
+//! \file:   ViewportPredict_Kalman.h
+//! \brief:  the class for viewport predict of kalman filter.
+//! \detail: it's class to predict viewport by tracking the angular velocity
+//!          and acceleration of yaw and pitch with kalman filter.
+//!
+//! Created on October 18, 2026, 10:20 AM
+//!
+
+#ifndef VIEWPORTPREDICT_KALMAN_H_
+#define VIEWPORTPREDICT_KALMAN_H_
+
+#include "../predict_Base/ViewportPredict.h"
+#include <list>
+
+using namespace std;
+
+VCD_OMAF_BEGIN
+
+//!
+//! \brief  kalman filter of one angle, the state is angle, angular velocity
+//!         and angular acceleration. both velocity and acceleration decay as
+//!         first order markov processes, so the long term prediction slows
+//!         down as the head does at the end of a turn
+//!
+class AngleKalmanFilter
+{
+public:
+    AngleKalmanFilter();
+    ~AngleKalmanFilter();
+
+    //!
+    //! \brief  restart the filter from the measured angle, in degree
+    //!
+    void Reset(float angle);
+
+    //!
+    //! \brief  propagate the state by the time interval, in second
+    //!
+    void Predict(float dt);
+
+    //!
+    //! \brief  correct the state by the measured angle, in degree
+    //!
+    void Update(float angle);
+
+    float GetAngle() { return m_state[0]; };
+    float GetVelocity() { return m_state[1]; };
+    float GetVariance() { return m_cov[0][0]; };
+
+private:
+    void Propagate(float dt);
+
+    float m_state[3];       //!< angle(degree), velocity(degree/s) and acceleration(degree/s^2)
+    float m_cov[3][3];      //!< covariance of the state
+};
+
+class ViewportPredict_Kalman : public ViewportPredict
+{
+public:
+    //!
+    //! \brief  construct
+    //!
+    ViewportPredict_Kalman();
+    //!
+    //! \brief  de-construct
+    //!
+    ~ViewportPredict_Kalman();
+    //! \brief viewport prediction process, the poses are taken as
+    //!        captured every pose interval, and predicted for the
+    //!        predict interval after the latest one
+    //!
+    //! \param  [in] std::list<ViewportAngle>
+    //!              pose history, the oldest first
+    //! \return ViewportAngle*
+    //!              return predicted viewport pose
+    //!
+    virtual ViewportAngle* PredictPose(std::list<ViewportAngle> pose_history);
+    //! \brief viewport prediction process with the pose timestamps
+    //!
+    //! \param  [in] const ViewportPose*
+    //!              pose history, the oldest first
+    //!         [in] uint32_t
+    //!              count of the poses in the history
+    //!         [in] uint64_t
+    //!              the time to predict the pose for, in millisecond
+    //!         [out] PredictedViewport*
+    //!              the predicted pose and its uncertainty
+    //! \return int32_t
+    //!              0 if success, else failed
+    //!
+    int32_t PredictPoseTimed(const ViewportPose *poses, uint32_t count, uint64_t predict_pts, PredictedViewport *predicted);
+};
+
+VCD_OMAF_END;
+
+#endif /* VIEWPORTPREDICT_KALMAN_H_ */
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ */
+
+//!
+
+//! \file:   ViewportPredict_Kalman_Impl.cpp
+//! \brief:  the API implementation of kalman filter viewport predict
+//! \detail: it's API implementation of kalman filter viewport predict
+//!
+//! Created on October 18, 2026, 10:20 AM
+//!
+
+#include "../../../utils/ViewportPredict_API.h"
+#include "../predict_Base/ViewportPredict.h"
+#include "ViewportPredict_Kalman.h"
+#include <new>
+
+VCD_USE_VROMAF;
+
+Handler ViewportPredict_Init(uint32_t pose_interval, uint32_t pre_pose_count, uint32_t predict_interval)
+{
+    ViewportPredict *predictor = new (std::nothrow) ViewportPredict_Kalman();
+    if (predictor == NULL)
+        return NULL;
+    predictor->Initialize(pose_interval, pre_pose_count, predict_interval);
+    return static_cast<Handler>(predictor);
+}
+
+ViewportAngle* ViewportPredict_PredictPose(Handler hdl, std::list<ViewportAngle> pose_history)
+{
+    ViewportPredict *predictor = static_cast<ViewportPredict *>(hdl);
+    if (predictor == NULL)
+        return NULL;
+    ViewportAngle* angle = predictor->PredictPose(pose_history);
+    return angle;
+}
+
+int32_t ViewportPredict_PredictPoseTimed(Handler hdl, const ViewportPose *poses, uint32_t count, uint64_t predict_pts, PredictedViewport *predicted)
+{
+    //the handler is the base class pointer returned by ViewportPredict_Init
+    ViewportPredict *base = static_cast<ViewportPredict *>(hdl);
+    if (base == NULL || predicted == NULL)
+        return 1;
+    ViewportPredict_Kalman *predictor = static_cast<ViewportPredict_Kalman *>(base);
+    return predictor->PredictPoseTimed(poses, count, predict_pts, predicted);
+}
+
+uint32_t ViewportPredict_GetAPIVersion()
+{
+    return VIEWPORT_PREDICT_API_VERSION;
+}
+
+uint32_t ViewportPredict_GetCapabilities()
+{
+    return VIEWPORT_PREDICT_CAP_DESTROY | VIEWPORT_PREDICT_CAP_TIMED;
+}
+
+int32_t ViewportPredict_Destroy(Handler hdl)
+{
+    ViewportPredict *predictor = static_cast<ViewportPredict *>(hdl);
+    if (predictor == NULL)
+        return 1;
+    delete predictor;
+    return 0;
+}
@@ -54,3 +54,22 @@ ViewportAngle* ViewportPredict_PredictPose(Handler hdl, std::list<ViewportAngle>
     ViewportAngle* angle = predictor->PredictPose(pose_history);
     return angle;
 }
+
+uint32_t ViewportPredict_GetAPIVersion()
+{
+    return VIEWPORT_PREDICT_API_VERSION;
+}
+
+uint32_t ViewportPredict_GetCapabilities()
+{
+    return VIEWPORT_PREDICT_CAP_DESTROY;
+}
+
+int32_t ViewportPredict_Destroy(Handler hdl)
+{
+    ViewportPredict *predictor = (ViewportPredict *)hdl;
+    if (predictor == NULL)
+        return 1;
+    delete predictor;
+    return 0;
+}
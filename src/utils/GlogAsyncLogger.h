@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ * 
+ */
+//!
+//! \file:   GlogAsyncLogger.h
+//! \brief:  asynchronous glog file logger and per call site rate limit
+//! \detail: glog writes the log file while holding its global log mutex, so a
+//!          per frame LOG(INFO) on the decode or render thread waits for the disk
+//!          and for the other threads logging. the async logger only copies the
+//!          formatted message into a lock-free ring, and a background thread
+//!          writes the ring into the original file logger.
+//!
+
+#ifndef GLOGASYNCLOGGER_H
+#define GLOGASYNCLOGGER_H
+
+#include "glog/logging.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define ASYNC_LOG_SLOTS 2048          // must be power of 2
+#define ASYNC_LOG_MESSAGE_SIZE 504    // longer messages are written at once
+#define ASYNC_LOG_FLUSH_INTERVAL 50   // ms, how long the background writer sleeps when the ring is empty
+
+class GlogAsyncLogger : public google::base::Logger {
+ public:
+  //!
+  //! \brief  wrap the file logger, the wrapped logger is still owned by glog
+  //!
+  GlogAsyncLogger(google::base::Logger* wrapped, size_t slots = ASYNC_LOG_SLOTS)
+      : wrapped_(wrapped), slots_(roundUp(slots)), mask_(roundUp(slots) - 1) {
+    for (size_t i = 0; i < slots_.size(); i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    running_ = true;
+    writer_ = std::thread([this]() { this->run(); });
+  };
+
+  virtual ~GlogAsyncLogger() {
+    {
+      std::lock_guard<std::mutex> lock(wait_mutex_);
+      running_ = false;
+    }
+    wait_cv_.notify_one();
+    if (writer_.joinable()) writer_.join();
+    drain();
+    wrapped_->Flush();
+  };
+
+  //!
+  //! \brief  called by glog for each message, only the copy into the ring happens here
+  //!
+  virtual void Write(bool force_flush, time_t timestamp, const char* message, int message_len) {
+    if (message_len < 0) return;
+    if (isFatal(message, message_len)) {
+      // glog aborts once the message is written, the ring and the message are
+      // on disk before this returns
+      drain();
+      wrapped_->Write(true, timestamp, message, message_len);
+      wrapped_->Flush();
+      return;
+    }
+    if (static_cast<size_t>(message_len) > ASYNC_LOG_MESSAGE_SIZE) {
+      // keep the order with the queued ones
+      drain();
+      wrapped_->Write(force_flush, timestamp, message, message_len);
+      return;
+    }
+
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+      slot = &slots_[pos & mask_];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        // ring is full, never block the caller
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        wait_cv_.notify_one();
+        return;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->timestamp = timestamp;
+    slot->force_flush = force_flush;
+    slot->length = message_len;
+    memcpy(slot->message, message, message_len);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    if (force_flush || pos - dequeue_pos_.load(std::memory_order_relaxed) > mask_ / 2) {
+      wait_cv_.notify_one();
+    }
+  };
+
+  virtual void Flush() {
+    drain();
+    wrapped_->Flush();
+  };
+
+  virtual uint32_t LogSize() { return wrapped_->LogSize(); };
+
+  google::base::Logger* Wrapped() { return wrapped_; };
+
+  //!
+  //! \brief  messages dropped since the ring was full
+  //!
+  uint64_t Dropped() { return dropped_total_.load(std::memory_order_relaxed) + dropped_.load(std::memory_order_relaxed); };
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    time_t timestamp;
+    bool force_flush;
+    int length;
+    char message[ASYNC_LOG_MESSAGE_SIZE];
+  };
+
+  //!
+  //! \brief  glog prefixes each line with the severity letter, a FATAL one is
+  //!         also sent to the INFO and WARNING loggers before the abort
+  //!
+  static bool isFatal(const char* message, int message_len) {
+    return message_len > 0 && message[0] == 'F';
+  };
+
+  static size_t roundUp(size_t slots) {
+    size_t size = 2;
+    while (size < slots) size <<= 1;
+    return size;
+  };
+
+  void run() {
+    while (running_) {
+      if (drain() == 0) {
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        if (!running_) break;
+        wait_cv_.wait_for(lock, std::chrono::milliseconds(ASYNC_LOG_FLUSH_INTERVAL));
+      }
+    }
+  };
+
+  //!
+  //! \brief  write the queued messages into the wrapped logger, single consumer
+  //!
+  size_t drain() {
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    size_t written = 0;
+    bool flush = false;
+    time_t last_timestamp = 0;
+    for (;;) {
+      size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+      Slot& slot = slots_[pos & mask_];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0) break;
+
+      wrapped_->Write(false, slot.timestamp, slot.message, slot.length);
+      flush |= slot.force_flush;
+      last_timestamp = slot.timestamp;
+      slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+      dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+      written++;
+    }
+
+    uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+    if (dropped) {
+      dropped_total_.fetch_add(dropped, std::memory_order_relaxed);
+      std::string notice = "Async logger dropped " + std::to_string(dropped) + " messages, the ring was full\n";
+      wrapped_->Write(false, last_timestamp ? last_timestamp : time(nullptr), notice.c_str(),
+                      static_cast<int>(notice.size()));
+    }
+    if (flush) wrapped_->Flush();
+    return written;
+  };
+
+ private:
+  google::base::Logger* wrapped_;
+  std::vector<Slot> slots_;
+  size_t mask_;
+  std::atomic<size_t> enqueue_pos_{0};
+  std::atomic<size_t> dequeue_pos_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> dropped_total_{0};
+
+  std::mutex drain_mutex_;
+  std::mutex wait_mutex_;
+  std::condition_variable wait_cv_;
+  std::atomic_bool running_{false};
+  std::thread writer_;
+};
+
+//!
+//! \brief  state of one LOG_EVERY_MS call site
+//!
+class GlogRateLimit {
+ public:
+  //!
+  //! \brief  whether the site can log now, the calls skipped since its last log are put in suppressed
+  //!
+  bool Allow(int64_t interval_ms, uint64_t* suppressed) {
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count();
+    int64_t last = last_ms_.load(std::memory_order_relaxed);
+    if ((last != NEVER_LOGGED && now - last < interval_ms) ||
+        !last_ms_.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+      suppressed_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    *suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+    return true;
+  };
+
+ private:
+  static const int64_t NEVER_LOGGED = std::numeric_limits<int64_t>::min();
+  std::atomic<int64_t> last_ms_{NEVER_LOGGED};
+  std::atomic<uint64_t> suppressed_{0};
+};
+
+struct GlogSuppressed {
+  uint64_t count;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const GlogSuppressed& suppressed) {
+  if (suppressed.count) os << "[" << suppressed.count << " suppressed] ";
+  return os;
+}
+
+//!
+//! \brief  log at most once in the interval from this call site, e.g.
+//!         LOG_EVERY_MS(INFO, LOG_INTERVAL_MS) << "Frame is empty!" << endl;
+//!         the message is neither formatted nor queued when it is skipped
+//!
+#define LOG_EVERY_MS(severity, interval_ms)                                                                      \
+  for (uint64_t glog_suppressed_ = 0,                                                                           \
+                glog_once_ = []() -> GlogRateLimit& {                                                           \
+                  static GlogRateLimit site;                                                                    \
+                  return site;                                                                                  \
+                }().Allow(interval_ms, &glog_suppressed_);                                                      \
+       glog_once_; glog_once_ = 0)                                                                              \
+  LOG(severity) << GlogSuppressed{glog_suppressed_}
+
+//!
+//! \brief  per frame trace, compiled out unless _ENABLE_TRACE_LOG_ is defined
+//!         (cmake -DUSE_TRACE_LOG=ON, or a Debug build)
+//!
+#ifdef _ENABLE_TRACE_LOG_
+#define LOG_TRACE LOG(INFO)
+#else
+#define LOG_TRACE true ? (void)0 : google::LogMessageVoidify() & LOG(INFO)
+#endif
+
+#endif /* GLOGASYNCLOGGER_H */
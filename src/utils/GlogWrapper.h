@@ -37,16 +37,18 @@
 #define GLOGWRAPPER_H
 
 #include "glog/logging.h"
+#include "GlogAsyncLogger.h"
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
 #define VLOG_METHOD 10
 #define VLOG_TRACE 20
+#define LOG_INTERVAL_MS 1000  // default interval of LOG_EVERY_MS on per frame paths
 
 class GlogWrapper {
  public:
-  GlogWrapper(char* name, int32_t minLogLevel = google::INFO) {
+  GlogWrapper(char* name, int32_t minLogLevel = google::INFO, bool asyncLogging = true) {
     if (0 != access("./logfiles", 0)) {
       mkdir("./logfiles", 0755);
     }
@@ -77,10 +79,30 @@ class GlogWrapper {
     FLAGS_max_log_size = 100;                // set the max size of log file to 100MB
     FLAGS_stop_logging_if_full_disk = true;  // stop logging if disk full
     FLAGS_minloglevel = minLogLevel;
+
+    // INFO and WARNING files are written in background, ERROR and FATAL stay synchronous
+    // so they are on disk before a crash
+    if (asyncLogging) {
+      for (int32_t severity = google::INFO; severity <= google::WARNING; severity++) {
+        async_loggers_[severity] = new GlogAsyncLogger(google::base::GetLogger(severity));
+        google::base::SetLogger(severity, async_loggers_[severity]);
+      }
+    }
+  };
+  ~GlogWrapper() {
+    // glog deletes the loggers set by user at shutdown, give the file loggers back first
+    for (int32_t severity = google::INFO; severity <= google::WARNING; severity++) {
+      if (async_loggers_[severity]) {
+        google::base::SetLogger(severity, async_loggers_[severity]->Wrapped());
+        delete async_loggers_[severity];
+        async_loggers_[severity] = nullptr;
+      }
+    }
+    google::ShutdownGoogleLogging();
   };
-  ~GlogWrapper() { google::ShutdownGoogleLogging(); };
 
  private:
+  GlogAsyncLogger* async_loggers_[google::WARNING + 1] = {nullptr};
 };
 
 #endif /* GLOGWRAPPER_H */
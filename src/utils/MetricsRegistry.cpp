@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ * 
+ */
+//!
+//! \file:   MetricsRegistry.cpp
+//! \brief:  in-process metrics, counters, gauges and latency histograms
+//!
+
+#include "MetricsRegistry.h"
+#include "error.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+VCD_NS_BEGIN
+
+void MetricHistogram::Record(uint64_t value) {
+  buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t MetricHistogram::Percentile(double ratio) const {
+  uint64_t count = Count();
+  if (count == 0) return 0;
+
+  ratio = std::min(std::max(ratio, 0.0), 1.0);
+  uint64_t target = std::max(static_cast<uint64_t>(std::ceil(ratio * count)), static_cast<uint64_t>(1));
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < METRIC_HISTOGRAM_BUCKETS; i++) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= target) {
+      return std::min(BucketUpper(i), Max());
+    }
+  }
+  return Max();
+}
+
+void MetricHistogram::Reset() {
+  for (uint32_t i = 0; i < METRIC_HISTOGRAM_BUCKETS; i++) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+uint32_t MetricHistogram::BucketIndex(uint64_t value) {
+  if (value < METRIC_SUB_BUCKETS) return static_cast<uint32_t>(value);
+
+  // the leading METRIC_SUB_BUCKET_BITS bits after the highest one select the sub bucket
+  uint32_t exponent = 63 - __builtin_clzll(value);
+  uint32_t shift = exponent - METRIC_SUB_BUCKET_BITS;
+  uint32_t sub = static_cast<uint32_t>(value >> shift) & (METRIC_SUB_BUCKETS - 1);
+  return (shift + 1) * METRIC_SUB_BUCKETS + sub;
+}
+
+uint64_t MetricHistogram::BucketUpper(uint32_t index) {
+  if (index < METRIC_SUB_BUCKETS) return index;
+
+  uint32_t shift = index / METRIC_SUB_BUCKETS - 1;
+  uint64_t sub = index % METRIC_SUB_BUCKETS;
+  uint64_t lower = (METRIC_SUB_BUCKETS + sub) << shift;
+  return lower + ((static_cast<uint64_t>(1) << shift) - 1);
+}
+
+MetricsRegistry::Metric *MetricsRegistry::getMetric(const std::string &name, const std::string &help,
+                                                    const std::string &labels, MetricType type) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &it : metrics_) {
+    // one type for all labels of the name
+    if (it.first.first == name && it.second.type != type) return nullptr;
+  }
+
+  Metric &metric = metrics_[std::make_pair(name, labels)];
+  if (!metric.counter && !metric.gauge && !metric.histogram) {
+    metric.type = type;
+    metric.help = help;
+    if (type == METRIC_COUNTER) {
+      metric.counter.reset(new MetricCounter());
+    } else if (type == METRIC_GAUGE) {
+      metric.gauge.reset(new MetricGauge());
+    } else {
+      metric.histogram.reset(new MetricHistogram());
+    }
+  }
+  return &metric;
+}
+
+MetricCounter *MetricsRegistry::Counter(const std::string &name, const std::string &help, const std::string &labels) {
+  Metric *metric = getMetric(name, help, labels, METRIC_COUNTER);
+  return metric ? metric->counter.get() : nullptr;
+}
+
+MetricGauge *MetricsRegistry::Gauge(const std::string &name, const std::string &help, const std::string &labels) {
+  Metric *metric = getMetric(name, help, labels, METRIC_GAUGE);
+  return metric ? metric->gauge.get() : nullptr;
+}
+
+MetricHistogram *MetricsRegistry::Histogram(const std::string &name, const std::string &help,
+                                            const std::string &labels) {
+  Metric *metric = getMetric(name, help, labels, METRIC_HISTOGRAM);
+  return metric ? metric->histogram.get() : nullptr;
+}
+
+int32_t MetricsRegistry::Snapshot(MetricValue *values, int32_t *count) {
+  if (!count) return ERROR_NULL_PTR;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!values) {
+    *count = static_cast<int32_t>(metrics_.size());
+    return ERROR_NONE;
+  }
+
+  int32_t written = 0;
+  for (auto &it : metrics_) {
+    if (written >= *count) break;
+
+    MetricValue &value = values[written++];
+    memset(&value, 0, sizeof(MetricValue));
+    std::string name = it.first.first;
+    if (it.first.second.size()) name += "{" + it.first.second + "}";
+    strncpy(value.name, name.c_str(), METRIC_NAME_SIZE - 1);
+    value.type = it.second.type;
+    if (it.second.counter) {
+      value.value = static_cast<int64_t>(it.second.counter->Value());
+    } else if (it.second.gauge) {
+      value.value = it.second.gauge->Value();
+    } else if (it.second.histogram) {
+      MetricHistogram *histogram = it.second.histogram.get();
+      value.value = static_cast<int64_t>(histogram->Count());
+      value.sum = histogram->Sum();
+      value.max = histogram->Max();
+      value.p50 = histogram->Percentile(0.5);
+      value.p90 = histogram->Percentile(0.9);
+      value.p99 = histogram->Percentile(0.99);
+    }
+  }
+  *count = written;
+  return ERROR_NONE;
+}
+
+std::string MetricsRegistry::DumpPrometheus(const std::string &prefix) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ostringstream out;
+  std::string family;
+  for (auto &it : metrics_) {
+    std::string name = prefix + it.first.first;
+    const std::string &labels = it.first.second;
+    const Metric &metric = it.second;
+    // the map is sorted by name, so the labels of one name are together
+    if (name != family) {
+      family = name;
+      const char *type = metric.type == METRIC_COUNTER ? "counter" : (metric.type == METRIC_GAUGE ? "gauge" : "summary");
+      out << "# HELP " << name << " " << metric.help << "\n";
+      out << "# TYPE " << name << " " << type << "\n";
+    }
+
+    std::string braced = labels.size() ? "{" + labels + "}" : "";
+    if (metric.counter) {
+      out << name << braced << " " << metric.counter->Value() << "\n";
+    } else if (metric.gauge) {
+      out << name << braced << " " << metric.gauge->Value() << "\n";
+    } else if (metric.histogram) {
+      const double quantiles[] = {0.5, 0.9, 0.99};
+      for (double quantile : quantiles) {
+        out << name << "{" << (labels.size() ? labels + "," : "") << "quantile=\"" << quantile << "\"} "
+            << metric.histogram->Percentile(quantile) << "\n";
+      }
+      out << name << "_sum" << braced << " " << metric.histogram->Sum() << "\n";
+      out << name << "_count" << braced << " " << metric.histogram->Count() << "\n";
+    }
+  }
+  return out.str();
+}
+
+VCD_NS_END;
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ * 
+ */
+//!
+//! \file:   MetricsRegistry.h
+//! \brief:  in-process metrics, counters, gauges and latency histograms
+//! \detail: the metrics are registered once at initialization, the returned
+//!          pointers stay valid with the registry, so the hot paths only do
+//!          relaxed atomic operations. snapshots are exported through the
+//!          library APIs or dumped in Prometheus text format.
+//!
+
+#ifndef _METRICSREGISTRY_H_
+#define _METRICSREGISTRY_H_
+
+#include "ns_def.h"
+#include "MetricsData.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#define METRIC_SUB_BUCKET_BITS 3  // 8 buckets in each power of 2, the error is at most 1/8
+#define METRIC_SUB_BUCKETS (1 << METRIC_SUB_BUCKET_BITS)
+#define METRIC_HISTOGRAM_BUCKETS ((64 - METRIC_SUB_BUCKET_BITS + 1) * METRIC_SUB_BUCKETS)
+
+VCD_NS_BEGIN
+
+class MetricCounter {
+ public:
+  void Add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); };
+  uint64_t Value() const { return value_.load(std::memory_order_relaxed); };
+  void Reset() { value_.store(0, std::memory_order_relaxed); };
+
+ private:
+  std::atomic<uint64_t> value_{0};
+};
+
+class MetricGauge {
+ public:
+  void Set(int64_t value) { value_.store(value, std::memory_order_relaxed); };
+  void Add(int64_t delta) { value_.fetch_add(delta, std::memory_order_relaxed); };
+  int64_t Value() const { return value_.load(std::memory_order_relaxed); };
+
+ private:
+  std::atomic<int64_t> value_{0};
+};
+
+//!
+//! \brief  log-linear histogram like HDR histogram, buckets cover the whole
+//!         uint64_t range, so nothing needs to be configured
+//!
+class MetricHistogram {
+ public:
+  MetricHistogram() { Reset(); };
+
+  void Record(uint64_t value);
+
+  uint64_t Count() const { return count_.load(std::memory_order_relaxed); };
+  uint64_t Sum() const { return sum_.load(std::memory_order_relaxed); };
+  uint64_t Max() const { return max_.load(std::memory_order_relaxed); };
+
+  //!
+  //! \brief  the value below which the ratio of samples fall
+  //!
+  //! \param  [in] ratio
+  //!         in [0, 1], e.g. 0.99 for p99
+  //!
+  uint64_t Percentile(double ratio) const;
+
+  void Reset();
+
+  static uint32_t BucketIndex(uint64_t value);
+  static uint64_t BucketUpper(uint32_t index);
+
+ private:
+  std::atomic<uint64_t> buckets_[METRIC_HISTOGRAM_BUCKETS];
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+//!
+//! \brief  record the time in microsecond from construction to destruction
+//!
+class MetricTimer {
+ public:
+  MetricTimer(MetricHistogram *histogram) : histogram_(histogram), start_(std::chrono::steady_clock::now()){};
+  ~MetricTimer() {
+    if (histogram_) {
+      histogram_->Record(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count()));
+    }
+  };
+
+  //<! nothing worth recording is done
+  void Cancel() { histogram_ = nullptr; };
+
+ private:
+  MetricHistogram *histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+class MetricsRegistry {
+ public:
+  MetricsRegistry(){};
+  virtual ~MetricsRegistry(){};
+
+ public:
+  //!
+  //! \brief  get the metric of the name and labels, it is created at the first time
+  //!
+  //! \param  [in] name
+  //!         metric name, [a-zA-Z_][a-zA-Z0-9_]*
+  //! \param  [in] help
+  //!         description of the metric
+  //! \param  [in] labels
+  //!         labels in Prometheus format without braces, e.g. stream="0"
+  //!
+  //! \return the metric, valid as long as the registry, or NULL when the name
+  //!         is taken by another type
+  //!
+  MetricCounter *Counter(const std::string &name, const std::string &help, const std::string &labels = "");
+  MetricGauge *Gauge(const std::string &name, const std::string &help, const std::string &labels = "");
+  MetricHistogram *Histogram(const std::string &name, const std::string &help, const std::string &labels = "");
+
+  //!
+  //! \brief  take a snapshot of all metrics
+  //!
+  //! \param  [out] values
+  //!         the metrics, NULL to query the count only
+  //! \param  [in/out] count
+  //!         capacity of values as input, count of metrics written as output
+  //!
+  //! \return int32_t
+  //!         ERROR_NONE if success, else failed reason
+  //!
+  int32_t Snapshot(MetricValue *values, int32_t *count);
+
+  //!
+  //! \brief  dump all metrics in Prometheus text format, histograms are
+  //!         exported as summaries
+  //!
+  //! \param  [in] prefix
+  //!         prefix of all metric names, e.g. omaf_access_
+  //!
+  std::string DumpPrometheus(const std::string &prefix);
+
+ private:
+  struct Metric {
+    MetricType type;
+    std::string help;
+    std::unique_ptr<MetricCounter> counter;
+    std::unique_ptr<MetricGauge> gauge;
+    std::unique_ptr<MetricHistogram> histogram;
+  };
+
+  Metric *getMetric(const std::string &name, const std::string &help, const std::string &labels, MetricType type);
+
+ private:
+  std::mutex mutex_;
+  std::map<std::pair<std::string, std::string>, Metric> metrics_;  //<! keyed by name and labels
+};
+
+VCD_NS_END;
+
+#endif /* _METRICSREGISTRY_H_ */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ * 
+ */
+//!
+//! \file:   RwpkCache.cpp
+//! \brief:  immutable region wise packing shared by packets
+//!
+
+#include "RwpkCache.h"
+
+#include <atomic>
+#include <cstring>
+
+VCD_NS_BEGIN
+
+static std::atomic<uint64_t> g_rwpkVersion{0};
+
+SharedRwpk::SharedRwpk(const RegionWisePacking &rwpk, uint64_t version) : version_(version) {
+  rwpk_ = rwpk;
+  rwpk_.timeStamp = 0;
+  rwpk_.rectRegionPacking = nullptr;
+  if (rwpk.numRegions && rwpk.rectRegionPacking) {
+    rwpk_.rectRegionPacking = new RectangularRegionWisePacking[rwpk.numRegions];
+    memcpy(rwpk_.rectRegionPacking, rwpk.rectRegionPacking, rwpk.numRegions * sizeof(RectangularRegionWisePacking));
+  } else {
+    rwpk_.numRegions = 0;
+  }
+  hash_ = Hash(rwpk_);
+}
+
+SharedRwpk::~SharedRwpk() {
+  if (rwpk_.rectRegionPacking) {
+    delete[] rwpk_.rectRegionPacking;
+    rwpk_.rectRegionPacking = nullptr;
+  }
+}
+
+RegionWisePacking *SharedRwpk::Clone() const {
+  RegionWisePacking *rwpk = new RegionWisePacking;
+  *rwpk = rwpk_;
+  rwpk->rectRegionPacking = new RectangularRegionWisePacking[rwpk_.numRegions ? rwpk_.numRegions : 1];
+  if (rwpk_.numRegions) {
+    memcpy(rwpk->rectRegionPacking, rwpk_.rectRegionPacking, rwpk_.numRegions * sizeof(RectangularRegionWisePacking));
+  }
+  return rwpk;
+}
+
+bool SharedRwpk::Equal(const RegionWisePacking &a, const RegionWisePacking &b) {
+  if (a.constituentPicMatching != b.constituentPicMatching || a.numRegions != b.numRegions ||
+      a.projPicWidth != b.projPicWidth || a.projPicHeight != b.projPicHeight || a.packedPicWidth != b.packedPicWidth ||
+      a.packedPicHeight != b.packedPicHeight || a.numHiRegions != b.numHiRegions ||
+      a.lowResPicWidth != b.lowResPicWidth || a.lowResPicHeight != b.lowResPicHeight) {
+    return false;
+  }
+
+  // compared field by field, the padding bytes are undefined
+  for (uint32_t i = 0; i < a.numRegions; i++) {
+    const RectangularRegionWisePacking &ra = a.rectRegionPacking[i];
+    const RectangularRegionWisePacking &rb = b.rectRegionPacking[i];
+    if (ra.transformType != rb.transformType || ra.guardBandFlag != rb.guardBandFlag ||
+        ra.projRegWidth != rb.projRegWidth || ra.projRegHeight != rb.projRegHeight ||
+        ra.projRegTop != rb.projRegTop || ra.projRegLeft != rb.projRegLeft || ra.packedRegWidth != rb.packedRegWidth ||
+        ra.packedRegHeight != rb.packedRegHeight || ra.packedRegTop != rb.packedRegTop ||
+        ra.packedRegLeft != rb.packedRegLeft || ra.leftGbWidth != rb.leftGbWidth ||
+        ra.rightGbWidth != rb.rightGbWidth || ra.topGbHeight != rb.topGbHeight ||
+        ra.bottomGbHeight != rb.bottomGbHeight || ra.gbNotUsedForPredFlag != rb.gbNotUsedForPredFlag ||
+        ra.gbType0 != rb.gbType0 || ra.gbType1 != rb.gbType1 || ra.gbType2 != rb.gbType2 || ra.gbType3 != rb.gbType3) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t SharedRwpk::Hash(const RegionWisePacking &rwpk) {
+  // FNV-1a over the fields checked in Equal
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](uint64_t value) {
+    hash ^= value;
+    hash *= 1099511628211ull;
+  };
+  mix(rwpk.constituentPicMatching);
+  mix(rwpk.numRegions);
+  mix(rwpk.projPicWidth);
+  mix(rwpk.projPicHeight);
+  mix(rwpk.packedPicWidth);
+  mix(rwpk.packedPicHeight);
+  mix(rwpk.numHiRegions);
+  mix(rwpk.lowResPicWidth);
+  mix(rwpk.lowResPicHeight);
+  for (uint32_t i = 0; i < rwpk.numRegions; i++) {
+    const RectangularRegionWisePacking &reg = rwpk.rectRegionPacking[i];
+    mix((static_cast<uint64_t>(reg.transformType) << 8) | reg.guardBandFlag);
+    mix((static_cast<uint64_t>(reg.projRegWidth) << 32) | reg.projRegHeight);
+    mix((static_cast<uint64_t>(reg.projRegTop) << 32) | reg.projRegLeft);
+    mix((static_cast<uint64_t>(reg.packedRegWidth) << 48) | (static_cast<uint64_t>(reg.packedRegHeight) << 32) |
+        (static_cast<uint64_t>(reg.packedRegTop) << 16) | reg.packedRegLeft);
+    mix((static_cast<uint64_t>(reg.leftGbWidth) << 24) | (static_cast<uint64_t>(reg.rightGbWidth) << 16) |
+        (static_cast<uint64_t>(reg.topGbHeight) << 8) | reg.bottomGbHeight);
+    mix((static_cast<uint64_t>(reg.gbNotUsedForPredFlag) << 32) | (static_cast<uint64_t>(reg.gbType0) << 24) |
+        (static_cast<uint64_t>(reg.gbType1) << 16) | (static_cast<uint64_t>(reg.gbType2) << 8) | reg.gbType3);
+  }
+  return hash;
+}
+
+SharedRwpk::Ptr RwpkCache::Share(const RegionWisePacking &rwpk) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return share(rwpk);
+}
+
+SharedRwpk::Ptr RwpkCache::share(const RegionWisePacking &rwpk) {
+  if (rwpk.numRegions && !rwpk.rectRegionPacking) return nullptr;
+
+  uint64_t hash = SharedRwpk::Hash(rwpk);
+  for (auto it = entries_.begin(); it != entries_.end(); it++) {
+    if ((*it)->hash_ == hash && SharedRwpk::Equal(*(*it)->Get(), rwpk)) {
+      entries_.splice(entries_.begin(), entries_, it);
+      hits_++;
+      return entries_.front();
+    }
+  }
+
+  misses_++;
+  SharedRwpk::Ptr shared(new SharedRwpk(rwpk, ++g_rwpkVersion));
+  entries_.push_front(shared);
+  while (entries_.size() > capacity_) entries_.pop_back();
+  return shared;
+}
+
+SharedRwpk::Ptr RwpkCache::ParseSEI(const uint8_t *sei, uint32_t size,
+                                    std::function<int32_t(RegionWisePacking *)> parser) {
+  if (!sei || !size || !parser) return nullptr;
+
+  // the SEI carries a per frame time stamp, so the bytes are no key and every
+  // SEI is parsed. the packing is interned by content without the time stamp
+  RegionWisePacking rwpk;
+  memset(&rwpk, 0, sizeof(RegionWisePacking));
+  std::unique_ptr<RectangularRegionWisePacking[]> regions(new RectangularRegionWisePacking[UINT8_MAX]);
+  memset(regions.get(), 0, UINT8_MAX * sizeof(RectangularRegionWisePacking));
+  rwpk.rectRegionPacking = regions.get();
+  if (parser(&rwpk) != 0 || rwpk.rectRegionPacking != regions.get()) return nullptr;
+
+  return Share(rwpk);
+}
+
+VCD_NS_END;
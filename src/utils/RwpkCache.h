@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * * Redistributions of source code must retain the above copyright notice, this
+ *   list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+
+ * 
+ */
+//!
+//! \file:   RwpkCache.h
+//! \brief:  immutable region wise packing shared by packets
+//! \detail: region wise packing rarely changes, so one immutable copy is shared
+//!          from the reader to the renderer instead of deep copies at every hop.
+//!          each distinct packing gets a version, consumers only rebuild their
+//!          region mappings when the version changes.
+//!
+
+#ifndef _RWPKCACHE_H_
+#define _RWPKCACHE_H_
+
+#include "ns_def.h"
+#include "360SCVPAPI.h"
+#include "Singleton.h"
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+
+VCD_NS_BEGIN
+
+class SharedRwpk {
+ public:
+  using Ptr = std::shared_ptr<const SharedRwpk>;
+
+  ~SharedRwpk();
+
+  const RegionWisePacking *Get() const { return &rwpk_; };
+
+  //<! unique in the process for each distinct packing, never 0
+  uint64_t Version() const { return version_; };
+
+  //!
+  //! \brief  deep copy for the consumers owning a RegionWisePacking
+  //!
+  RegionWisePacking *Clone() const;
+
+  //!
+  //! \brief  carry the reference through C structures, e.g. DashPacket. each
+  //!         handle holds one reference until it is released
+  //!
+  static void *ToHandle(const Ptr &rwpk) { return rwpk ? new Ptr(rwpk) : nullptr; };
+  static Ptr FromHandle(void *handle) { return handle ? *static_cast<Ptr *>(handle) : Ptr(); };
+  static void ReleaseHandle(void *handle) { delete static_cast<Ptr *>(handle); };
+
+  //!
+  //! \brief  whether the two packings are the same, timeStamp is not compared
+  //!
+  static bool Equal(const RegionWisePacking &a, const RegionWisePacking &b);
+  static uint64_t Hash(const RegionWisePacking &rwpk);
+
+ private:
+  SharedRwpk(const RegionWisePacking &rwpk, uint64_t version);
+  SharedRwpk(const SharedRwpk &) = delete;
+  SharedRwpk &operator=(const SharedRwpk &) = delete;
+
+ private:
+  RegionWisePacking rwpk_;
+  uint64_t version_;
+  uint64_t hash_;
+
+  friend class RwpkCache;
+};
+
+class RwpkCache {
+ public:
+  RwpkCache(size_t capacity = 16) : capacity_(capacity){};
+  virtual ~RwpkCache(){};
+
+ public:
+  //!
+  //! \brief  share the packing, the same content gets the same object, so a
+  //!         copy is only made when the packing changes
+  //!
+  //! \param  [in] rwpk
+  //!         the packing, still owned by the caller
+  //!
+  SharedRwpk::Ptr Share(const RegionWisePacking &rwpk);
+
+  //!
+  //! \brief  parse the rwpk SEI and share the packing
+  //!
+  //! \param  [in] sei
+  //!         the SEI bytes
+  //! \param  [in] size
+  //!         size of the SEI bytes
+  //! \param  [in] parser
+  //!         parses the SEI into the packing, returns 0 if success. the
+  //!         regions buffer is allocated with new[] by the cache
+  //!
+  //! \return the shared packing, NULL if the parsing fails
+  //!
+  SharedRwpk::Ptr ParseSEI(const uint8_t *sei, uint32_t size, std::function<int32_t(RegionWisePacking *)> parser);
+
+  uint64_t Hits() const { return hits_; };
+  uint64_t Misses() const { return misses_; };
+
+ private:
+  SharedRwpk::Ptr share(const RegionWisePacking &rwpk);
+
+ private:
+  size_t capacity_;
+  std::mutex mutex_;
+  std::list<SharedRwpk::Ptr> entries_;  //<! most recent first
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+};
+
+typedef Singleton<RwpkCache> RWPKCACHE;  //<! shared by all sources in the process
+
+VCD_NS_END;
+
+#endif /* _RWPKCACHE_H_ */
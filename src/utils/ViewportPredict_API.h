@@ -48,6 +48,21 @@ extern "C" {
 
 typedef void* Handler;
 
+//!
+//! the version of the plugin API, plugins with different major
+//! version are rejected. plugins without ViewportPredict_GetAPIVersion
+//! are taken as version 1.0
+//!
+#define VIEWPORT_PREDICT_API_VERSION_MAJOR 1
+#define VIEWPORT_PREDICT_API_VERSION_MINOR 2
+#define VIEWPORT_PREDICT_API_VERSION ((VIEWPORT_PREDICT_API_VERSION_MAJOR << 16) | VIEWPORT_PREDICT_API_VERSION_MINOR)
+
+//!
+//! capabilities reported by ViewportPredict_GetCapabilities
+//!
+#define VIEWPORT_PREDICT_CAP_DESTROY 0x1   //!< the handler can be released by ViewportPredict_Destroy
+#define VIEWPORT_PREDICT_CAP_TIMED    0x2   //!< ViewportPredict_PredictPoseTimed is supported, since 1.2
+
 //! \brief Initialze the viewport prediction algorithm
 //!
 //! \param  [in] uint32_t
@@ -66,6 +81,42 @@ Handler ViewportPredict_Init(uint32_t pose_interval, uint32_t pre_pose_count, ui
 //!              return predicted viewport pose
 //!
 ViewportAngle* ViewportPredict_PredictPose(Handler hdl, std::list<ViewportAngle> pose_history);
+//! \brief viewport prediction process with the pose timestamps
+//!
+//! \param  [in] Handler
+//!              the handler created by ViewportPredict_Init
+//!         [in] const ViewportPose*
+//!              pose history, the oldest first, the intervals can be irregular
+//!         [in] uint32_t
+//!              count of the poses in the history
+//!         [in] uint64_t
+//!              the time to predict the pose for, in millisecond
+//!         [out] PredictedViewport*
+//!              the predicted pose and its uncertainty
+//! \return int32_t
+//!              0 if success, else failed
+//!
+int32_t ViewportPredict_PredictPoseTimed(Handler hdl, const ViewportPose *poses, uint32_t count, uint64_t predict_pts, PredictedViewport *predicted);
+//! \brief Get the version of the plugin API the plugin is built with
+//!
+//! \return uint32_t
+//!              the API version, major in high 16 bits and minor in low 16 bits
+//!
+uint32_t ViewportPredict_GetAPIVersion();
+//! \brief Get the capabilities supported by the plugin
+//!
+//! \return uint32_t
+//!              bitmask of VIEWPORT_PREDICT_CAP_*
+//!
+uint32_t ViewportPredict_GetCapabilities();
+//! \brief Release the handler created by ViewportPredict_Init
+//!
+//! \param  [in] Handler
+//!              the handler to be released
+//! \return int32_t
+//!              0 if success, else failed
+//!
+int32_t ViewportPredict_Destroy(Handler hdl);
 
 #ifdef __cplusplus
 }
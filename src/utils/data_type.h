@@ -17,6 +17,7 @@
 #include <stdint.h>
 #include "360SCVPAPI.h"
 #include "ns_def.h"
+#include "MetricsData.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -86,7 +87,8 @@ typedef struct SOURCERESOLUTION {
 
 /*
  * avg_bandwidth : average bandwidth since the begin of downloading
- * immediate_bandwidth: immediate bandwidth at the moment
+ * immediate_bandwidth: immediate bandwidth at the moment, the throughput measured on the
+ *                      latest transfers in bps, 0 when abr is not enabled
  */
 typedef struct DASHSTATISTICINFO {
   int32_t avg_bandwidth;
@@ -158,8 +160,37 @@ typedef struct DASHPACKET {
   uint32_t tileRowNum;              //! til row after aggregation
   uint32_t tileColNum;              //! til row after aggregation
   bool bEOS;
+  void* rwpkRef;                    //! shared reference of rwpk, rwpk is read only and released with it when set
+  uint64_t rwpkVersion;             //! packets with the same rwpk version carry the same region wise packing
 } DashPacket;
 
+/*
+ * calls : times the plugin is called
+ * failures : times the plugin fails
+ * total_us : total time spent in the plugin, in microsecond
+ * max_us : the longest time spent in one call, in microsecond
+ */
+typedef struct PLUGINTIMINGSTATS {
+  uint64_t calls;
+  uint64_t failures;
+  uint64_t total_us;
+  uint64_t max_us;
+} PluginTimingStats;
+
+/*
+ * per stage timing of the dash access, each one accumulates like PluginTimingStats
+ * download : segment transfers over http
+ * parse : segment parsing into packets
+ * select : tracks selection basing on viewport
+ * stitch : merging the selected tiles into one packet, only when packets come out
+ */
+typedef struct DASHSTAGETIMINGS {
+  PluginTimingStats download;
+  PluginTimingStats parse;
+  PluginTimingStats select;
+  PluginTimingStats stitch;
+} DashStageTimings;
+
 typedef struct VIEWPORTANGLE {
   // Euler angle
   float yaw;
@@ -167,6 +198,28 @@ typedef struct VIEWPORTANGLE {
   float roll;
 } ViewportAngle;
 
+/*
+ * angle : Euler angle of the pose, in degree
+ * pts : the time when the pose is captured, in millisecond
+ */
+typedef struct VIEWPORTPOSE {
+  ViewportAngle angle;
+  uint64_t pts;
+} ViewportPose;
+
+/*
+ * angle : the predicted Euler angle, in degree
+ * yawStdDev : standard deviation of the predicted yaw, in degree
+ * pitchStdDev : standard deviation of the predicted pitch, in degree
+ * confidence : confidence of the prediction in [0, 1], negative if not reported
+ */
+typedef struct PREDICTEDVIEWPORT {
+  ViewportAngle angle;
+  float yawStdDev;
+  float pitchStdDev;
+  float confidence;
+} PredictedViewport;
+
 #ifdef __cplusplus
 }
 #endif